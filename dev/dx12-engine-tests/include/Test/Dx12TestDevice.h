@@ -0,0 +1,11 @@
+#pragma once
+
+#include <d3d12.h>
+
+namespace dxe
+{
+	// The device of the tests and benchmarks that need one: WARP, the software adapter that comes with
+	// Windows, so results don't depend on the machine's GPU. Created on first use and shared, throws
+	// when it can't be created.
+	ID3D12Device* GetTestDevice();
+}
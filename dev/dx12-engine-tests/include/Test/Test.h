@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Core/Error.h"
+#include "Core/Utility.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dxe
+{
+	// Test and benchmark registry of dx12-engine-tests. TEST_CASE and BENCHMARK_CASE register a
+	// function when the program starts and main runs them (see main.cpp): tests by default,
+	// benchmarks with --bench. Checks throw a TestFailure, so a test stops at its first failed check.
+
+#define TEST_CASE(name)\
+	static void name();\
+	static const TestRegistrar name##Registrar{ #name, name, TestKind::TEST };\
+	static void name()
+
+#define BENCHMARK_CASE(name)\
+	static void name();\
+	static const TestRegistrar name##Registrar{ #name, name, TestKind::BENCHMARK };\
+	static void name()
+
+#define TEST_CHECK(condition)\
+	if (!(condition))\
+		throw TestFailure(THIS_FILE, THIS_LINE, #condition)
+
+#define TEST_CHECK_THROWS(expression, ExceptionType)\
+	do\
+	{\
+		bool thrown{ false };\
+		try { expression; }\
+		catch (const ExceptionType&) { thrown = true; }\
+		if (!thrown)\
+			throw TestFailure(THIS_FILE, THIS_LINE, #expression " doesn't throw " #ExceptionType);\
+	} while (false)
+
+	enum class TestKind
+	{
+		TEST,
+		BENCHMARK
+	};
+
+	struct TestCase
+	{
+		const char* name{ nullptr };
+		void (*function)() { nullptr };
+		TestKind kind{ TestKind::TEST };
+	};
+
+	std::vector<TestCase>& GetTestCases();
+
+	struct TestRegistrar
+	{
+		TestRegistrar(const char* name, void (*function)(), TestKind kind)
+		{
+			GetTestCases().push_back(TestCase{ name, function, kind });
+		}
+	};
+
+	class TestFailure : public Error
+	{
+	public:
+
+		TestFailure(const char* file, int line, const std::string& check)
+			: Error(std::string{ file } + "(" + std::to_string(line) + "): " + check) {}
+	};
+
+	// Prints "<label>: <value> <unit>" under the running benchmark.
+	void ReportMetric(const std::string& label, double value, const char* unit);
+
+	// Keeps the compiler from optimizing away a benchmark's result.
+	template<typename ValueType>
+	void KeepValue(const ValueType& value)
+	{
+		static volatile uint8_t sink{ 0 };
+		sink = sink + *reinterpret_cast<const volatile uint8_t*>(&value);
+	}
+
+	// Runs 'function', which processes 'itemCount' items per call, 'repetitions' times and returns the
+	// nanoseconds per item of the fastest run; the first run warms up caches and allocators.
+	template<typename Function>
+	double MeasureNanosecondsPerItem(uint64_t itemCount, Function&& function, uint32_t repetitions = 5)
+	{
+		function();
+
+		double best{ 0.0 };
+		for (uint32_t repetition = 0; repetition < repetitions; repetition++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			function();
+			std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+			double perItem = elapsed.count() / static_cast<double>(std::max<uint64_t>(itemCount, 1));
+			best = repetition == 0 ? perItem : std::min(best, perItem);
+		}
+		return best;
+	}
+}
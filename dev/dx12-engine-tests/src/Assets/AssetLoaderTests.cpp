@@ -0,0 +1,140 @@
+#include "Test/Test.h"
+
+#include "Assets/AssetLoader.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <thread>
+
+using namespace dxe;
+
+// Assets are read through the I/O scheduler's thread pool backend, so the test behaves the same
+// on every platform.
+
+namespace
+{
+	// Ticks the loader and the event registry like the main loop does, until 'done' holds or about
+	// ten seconds passed.
+	template <typename Condition>
+	void TickUntil(AssetLoader& assetLoader, EventRegistry& eventRegistry, Condition done)
+	{
+		for (uint32_t tick = 0; tick < 10000 && !done(); tick++)
+		{
+			assetLoader.Tick();
+			eventRegistry.Tick();
+			std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+		}
+	}
+
+	AssetRequest CreateRequest(const std::string& name, const std::filesystem::path& path, AssetLoadPriority priority)
+	{
+		AssetRequest request{};
+		request.name = name;
+		request.path = path;
+		request.priority = priority;
+		return request;
+	}
+}
+
+// The event fires once the last critical asset is finalized, with every critical success and
+// failure (read, decode or finalize) counted, and only once.
+TEST_CASE(AssetLoaderReportsCriticalAssetsOnce)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "dxe-asset-loader-test";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	std::filesystem::path filePath = directory / "asset.bin";
+	{
+		std::ofstream file(filePath, std::ofstream::binary);
+		file.write("asset data", 10);
+	}
+
+	IoSchedulerSettings ioSettings{};
+	ioSettings.forceThreadPoolBackend = true;
+	IoScheduler ioScheduler{ ioSettings };
+	ThreadPool threadPool{ 2 };
+	EventRegistry eventRegistry{};
+
+	uint32_t notificationCount{ 0 };
+	CriticalAssetsLoadedCallbackData lastNotification{};
+	eventRegistry.RegisterCallback<CriticalAssetsLoadedCallbackData>([&](const CriticalAssetsLoadedCallbackData& callbackData) {
+		notificationCount++;
+		lastNotification = callbackData;
+	});
+
+	// The last critical asset isn't decoded until the test lets it.
+	std::promise<void> gate;
+	std::shared_future<void> gateOpened = gate.get_future().share();
+
+	bool fileDataMatched{ false };
+	uint32_t finalizedCount{ 0 };
+	uint32_t requestCount{ 0 };
+	{
+		AssetLoader assetLoader{ &ioScheduler, &threadPool, &eventRegistry };
+
+		AssetRequest fileAsset = CreateRequest("file", filePath, AssetLoadPriority::CRITICAL);
+		fileAsset.decode = [&](std::vector<uint8_t>& fileData) {
+			fileDataMatched = std::string(fileData.begin(), fileData.end()) == "asset data";
+		};
+		fileAsset.finalize = [&]() { finalizedCount++; };
+		assetLoader.Load(std::move(fileAsset));
+
+		assetLoader.Load(CreateRequest("missing file", directory / "missing.bin", AssetLoadPriority::CRITICAL));
+
+		AssetRequest failedDecode = CreateRequest("failed decode", filePath, AssetLoadPriority::CRITICAL);
+		failedDecode.decode = [](std::vector<uint8_t>&) { throw Error{ "Decode failed!" }; };
+		assetLoader.Load(std::move(failedDecode));
+
+		AssetRequest failedFinalize = CreateRequest("failed finalize", {}, AssetLoadPriority::CRITICAL);
+		failedFinalize.finalize = []() { throw Error{ "Finalize failed!" }; };
+		assetLoader.Load(std::move(failedFinalize));
+
+		// Background assets are neither waited for nor counted.
+		assetLoader.Load(CreateRequest("background", filePath, AssetLoadPriority::BACKGROUND));
+
+		AssetRequest gatedAsset = CreateRequest("gated", {}, AssetLoadPriority::CRITICAL);
+		gatedAsset.decode = [gateOpened](std::vector<uint8_t>&) { gateOpened.wait(); };
+		assetLoader.Load(std::move(gatedAsset));
+
+		requestCount = assetLoader.GetStats().requestedCount;
+
+		// Everything but the gated asset.
+		TickUntil(assetLoader, eventRegistry, [&]() {
+			AssetLoaderStats stats = assetLoader.GetStats();
+			return stats.loadedCount + stats.failedCount == requestCount - 1;
+		});
+		AssetLoaderStats partialStats = assetLoader.GetStats();
+		bool pendingBeforeGate = assetLoader.CriticalAssetsPending();
+		uint32_t notificationsBeforeGate = notificationCount;
+
+		// Opened before checking anything, the loader waits for the decode when it's destroyed.
+		gate.set_value();
+
+		TEST_CHECK(partialStats.loadedCount == 2 && partialStats.failedCount == 3);
+		TEST_CHECK(pendingBeforeGate);
+		TEST_CHECK(notificationsBeforeGate == 0);
+
+		TickUntil(assetLoader, eventRegistry, [&]() { return notificationCount > 0; });
+		TEST_CHECK(!assetLoader.CriticalAssetsPending());
+
+		// Nothing left to report.
+		for (uint32_t tick = 0; tick < 10; tick++)
+		{
+			assetLoader.Tick();
+			eventRegistry.Tick();
+		}
+
+		AssetLoaderStats stats = assetLoader.GetStats();
+		TEST_CHECK(stats.requestedCount == 6 && stats.loadedCount == 3 && stats.failedCount == 3);
+	}
+
+	TEST_CHECK(notificationCount == 1);
+	TEST_CHECK(lastNotification.loadedAssetCount == 2 && lastNotification.failedAssetCount == 3);
+	TEST_CHECK(fileDataMatched && finalizedCount == 1);
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,184 @@
+#include "Test/Dx12TestDevice.h"
+#include "Test/Test.h"
+
+#include "GpuApi/Dx12/Dx12BindlessTable.h"
+#include "GpuApi/Dx12/Dx12DescriptorRing.h"
+#include "GpuApi/Dx12/Dx12Fence.h"
+#include "GpuApi/Dx12/Dx12RootSignature.h"
+
+#include <wrl/client.h>
+
+using namespace dxe;
+using namespace Microsoft::WRL;
+
+namespace
+{
+	// Source descriptors in a heap that isn't shader visible, null views of 2D textures.
+	class SourceDescriptors
+	{
+	public:
+
+		SourceDescriptors(ID3D12Device* device, uint32_t count)
+			: heap(count, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
+		{
+			heap.Initialize(device);
+
+			D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+			srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+			srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+			srvDesc.Texture2D.MipLevels = 1;
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				device->CreateShaderResourceView(nullptr, &srvDesc, heap.GetDescriptorHandle(i));
+				handles.push_back(heap.GetDescriptorHandle(i));
+			}
+		}
+
+		Dx12DescriptorHeap heap;
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> handles;
+	};
+}
+
+TEST_CASE(BindlessTableKeepsIndicesUntilTheGpuIsDone)
+{
+	ID3D12Device* device = GetTestDevice();
+
+	Dx12Fence fence{};
+	fence.Initialize(device);
+
+	Dx12DescriptorHeap heap{ 64, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE };
+	heap.Initialize(device);
+
+	SourceDescriptors sources{ device, 1 };
+	Dx12BindlessTable table{ device, &heap, &fence, 16, 8 };
+
+	TEST_CHECK(table.GetGpuHandle().ptr == heap.GetGpuDescriptorHandle(16).ptr);
+	TEST_CHECK(table.CopyDescriptor(sources.handles[0]) == 0);
+	TEST_CHECK(table.CopyDescriptor(sources.handles[0]) == 1);
+	TEST_CHECK(table.GetCpuHandle(1).ptr == heap.GetDescriptorHandle(17).ptr);
+
+	// Recorded work may still use it until the fence passes its next value.
+	table.Free(0);
+	TEST_CHECK(table.GetStatistics().pendingFreeCount == 1);
+	table.Retire();
+	TEST_CHECK(table.CopyDescriptor(sources.handles[0]) == 2);
+
+	fence.SignalOnCpu();
+	table.Retire();
+	TEST_CHECK(table.CopyDescriptor(sources.handles[0]) == 0);
+
+	// Full: indices freed in finished frames are taken back before it throws.
+	for (uint32_t i = 3; i < 8; i++)
+		TEST_CHECK(table.CopyDescriptor(sources.handles[0]) == i);
+	TEST_CHECK_THROWS(table.CopyDescriptor(sources.handles[0]), Error);
+
+	table.Free(5);
+	TEST_CHECK_THROWS(table.CopyDescriptor(sources.handles[0]), Error);
+	fence.SignalOnCpu();
+	TEST_CHECK(table.CopyDescriptor(sources.handles[0]) == 5);
+	TEST_CHECK(table.GetStatistics().peakUsedCount == 8);
+}
+
+// The CPU cost of binding a draw's resources: a table of 'resourceCount' descriptors copied into the
+// descriptor ring and bound per draw, against the bindless table bound once per command list with
+// only the draw's root constants set per draw. Draws are recorded into a command list that is never
+// executed.
+BENCHMARK_CASE(BindlessPerDrawBindingCost)
+{
+	constexpr uint32_t drawCount = 100000;
+	constexpr uint32_t drawsPerFrame = 1000;
+	constexpr uint32_t tableSize = 1024;
+	constexpr uint32_t ringSize = DX12_DEFAULT_DESCRIPTOR_RING_SIZE;
+
+	ID3D12Device* device = GetTestDevice();
+
+	Dx12Fence fence{};
+	fence.Initialize(device);
+
+	Dx12DescriptorHeap heap{ tableSize + ringSize, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE };
+	heap.Initialize(device);
+
+	SourceDescriptors sources{ device, 8 };
+	Dx12BindlessTable table{ device, &heap, &fence, 0, tableSize };
+	Dx12DescriptorRing ring{ device, &heap, &fence, tableSize, ringSize };
+
+	for (uint32_t i = 0; i < tableSize; i++)
+		table.CopyDescriptor(sources.handles[i % sources.handles.size()]);
+
+	Dx12RootSignature rootSignature{};
+	rootSignature.CreateBindlessRootSignature(device);
+
+	ComPtr<ID3D12CommandAllocator> commandAllocator;
+	DX12_THROW_IF_NOT_SUCCESS(
+		device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(commandAllocator.GetAddressOf())),
+		"Failed to create a Command Allocator!");
+
+	ComPtr<ID3D12GraphicsCommandList> commandList;
+	DX12_THROW_IF_NOT_SUCCESS(
+		device->CreateCommandList(
+			0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator.Get(), nullptr, IID_PPV_ARGS(commandList.GetAddressOf())),
+		"Failed to create a Graphics Command List!");
+
+	// A frame: a fresh recording that binds the heap and the root signature.
+	auto beginFrame = [&]() {
+		DX12_THROW_IF_NOT_SUCCESS(commandList->Close(), "Failed to close the Graphics Command List!");
+		DX12_THROW_IF_NOT_SUCCESS(commandAllocator->Reset(), "Failed to reset the Command Allocator!");
+		DX12_THROW_IF_NOT_SUCCESS(
+			commandList->Reset(commandAllocator.Get(), nullptr),
+			"Failed to reset the Graphics Command List!");
+
+		ID3D12DescriptorHeap* descriptorHeaps[] = { heap.GetDescriptorHeap() };
+		commandList->SetDescriptorHeaps(1, descriptorHeaps);
+		commandList->SetGraphicsRootSignature(rootSignature.GetRootSignature());
+	};
+	auto setDrawConstants = [&](uint32_t drawIndex) {
+		Dx12BindlessDrawConstants drawConstants{};
+		drawConstants.drawIndex = drawIndex;
+		drawConstants.resourceIndex = drawIndex % tableSize;
+
+		commandList->SetGraphicsRoot32BitConstants(
+			DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER, DX12_BINDLESS_ROOT_CONSTANT_COUNT, &drawConstants, 0);
+	};
+
+	for (uint32_t resourceCount : { 1u, 4u, 8u })
+	{
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> drawSources(
+			sources.handles.begin(), sources.handles.begin() + resourceCount);
+
+		double perDrawTable = MeasureNanosecondsPerItem(drawCount, [&]() {
+			for (uint32_t drawIndex = 0; drawIndex < drawCount; drawIndex++)
+			{
+				if (drawIndex % drawsPerFrame == 0)
+				{
+					ring.Submit(fence.SignalOnCpu());
+					ring.Retire();
+					beginFrame();
+				}
+
+				Dx12DescriptorAllocation drawTable = ring.AllocateTable(drawSources);
+				commandList->SetGraphicsRootDescriptorTable(DX12_BINDLESS_TABLE_PARAMETER, drawTable.gpuHandle);
+				setDrawConstants(drawIndex);
+			}
+		});
+
+		ReportMetric("per-draw table, " + std::to_string(resourceCount) + " resources", perDrawTable, "ns/draw");
+	}
+
+	double bindless = MeasureNanosecondsPerItem(drawCount, [&]() {
+		for (uint32_t drawIndex = 0; drawIndex < drawCount; drawIndex++)
+		{
+			if (drawIndex % drawsPerFrame == 0)
+			{
+				beginFrame();
+				commandList->SetGraphicsRootDescriptorTable(DX12_BINDLESS_TABLE_PARAMETER, table.GetGpuHandle());
+			}
+
+			setDrawConstants(drawIndex);
+		}
+	});
+
+	ReportMetric("bindless, any number of resources", bindless, "ns/draw");
+	ReportMetric("descriptor ring stalls", static_cast<double>(ring.GetStatistics().stallCount), "");
+}
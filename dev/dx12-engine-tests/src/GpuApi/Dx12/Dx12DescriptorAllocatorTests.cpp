@@ -0,0 +1,154 @@
+#include "Test/Dx12TestDevice.h"
+#include "Test/Test.h"
+
+#include "GpuApi/Dx12/Dx12DescriptorAllocator.h"
+
+#include <random>
+
+using namespace dxe;
+
+// Most tests only look at the index ranges, for which a heap that was never initialized is enough:
+// only the handles need a device.
+
+TEST_CASE(DescriptorAllocatorHandsOutRangesOfTheHeap)
+{
+	Dx12DescriptorHeap heap{ 300, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV };
+	Dx12DescriptorAllocator allocator{ &heap, 16, 256 };
+
+	Dx12DescriptorAllocation single = allocator.Allocate();
+	Dx12DescriptorAllocation table = allocator.Allocate(8);
+	TEST_CHECK(single.index == 16 && single.count == 1);
+	TEST_CHECK(table.index == 17 && table.count == 8);
+	TEST_CHECK(allocator.GetStatistics().usedSize == 9);
+
+	allocator.Free(single);
+	TEST_CHECK(!single.IsValid());
+	TEST_CHECK(allocator.Allocate().index == 16);
+
+	// Freeing an invalid allocation does nothing.
+	allocator.Free(single);
+	TEST_CHECK(allocator.GetStatistics().usedSize == 9);
+
+	TEST_CHECK_THROWS(allocator.Allocate(256), Error);
+	TEST_CHECK(allocator.Allocate(247).index == 25);
+	TEST_CHECK_THROWS(allocator.Allocate(), Error);
+}
+
+TEST_CASE(DescriptorAllocatorHandles)
+{
+	ID3D12Device* device = GetTestDevice();
+
+	Dx12DescriptorHeap heap{ 64, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV };
+	heap.Initialize(device);
+	Dx12DescriptorAllocator allocator{ &heap, 32, 32 };
+
+	Dx12DescriptorAllocation table = allocator.Allocate(8);
+	TEST_CHECK(table.descriptorSize == heap.GetDescriptorSize());
+	TEST_CHECK(table.GetCpuHandle(0).ptr == heap.GetDescriptorHandle(32).ptr);
+	TEST_CHECK(table.GetCpuHandle(3).ptr == heap.GetDescriptorHandle(35).ptr);
+	TEST_CHECK(table.gpuHandle.ptr == 0);
+
+	Dx12DescriptorHeap shaderVisibleHeap{ 64, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE };
+	shaderVisibleHeap.Initialize(device);
+	Dx12DescriptorAllocator shaderVisibleAllocator{ &shaderVisibleHeap, 0, 64 };
+
+	Dx12DescriptorAllocation shaderVisibleTable = shaderVisibleAllocator.Allocate(4);
+	TEST_CHECK(shaderVisibleTable.GetGpuHandle(2).ptr == shaderVisibleHeap.GetGpuDescriptorHandle(2).ptr);
+}
+
+// Mostly single descriptors and a few tables, allocated and freed at random: no descriptor may be in
+// two allocations, and everything coalesces back into one free range at the end.
+TEST_CASE(DescriptorAllocatorRandomAllocations)
+{
+	constexpr uint32_t descriptorCount = 4096;
+
+	Dx12DescriptorHeap heap{ descriptorCount, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV };
+	Dx12DescriptorAllocator allocator{ &heap, 0, descriptorCount };
+
+	std::mt19937 random{ 5 };
+	std::vector<bool> used(descriptorCount, false);
+	std::vector<Dx12DescriptorAllocation> allocations;
+
+	for (uint32_t i = 0; i < 200000; i++)
+	{
+		if (allocations.empty() || random() % 100 < 55)
+		{
+			// Allocate throws when the range is too fragmented for the table.
+			uint32_t count = random() % 10 == 0 ? 2 + random() % 14 : 1;
+			if (allocator.GetStatistics().largestFreeRange < count)
+				continue;
+
+			Dx12DescriptorAllocation allocation = allocator.Allocate(count);
+
+			TEST_CHECK(allocation.index + allocation.count <= descriptorCount);
+			for (uint32_t index = allocation.index; index < allocation.index + allocation.count; index++)
+			{
+				TEST_CHECK(!used[index]);
+				used[index] = true;
+			}
+			allocations.push_back(allocation);
+		}
+		else
+		{
+			size_t allocationIndex = random() % allocations.size();
+			Dx12DescriptorAllocation& allocation = allocations[allocationIndex];
+
+			for (uint32_t index = allocation.index; index < allocation.index + allocation.count; index++)
+				used[index] = false;
+			allocator.Free(allocation);
+
+			allocations[allocationIndex] = allocations.back();
+			allocations.pop_back();
+		}
+	}
+
+	for (Dx12DescriptorAllocation& allocation : allocations)
+		allocator.Free(allocation);
+
+	RangeStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.usedSize == 0 && statistics.freeRangeCount == 1);
+}
+
+// Steady state of the persistent descriptors: single views replaced at 75% occupancy, and tables of
+// 1 to 16 descriptors.
+BENCHMARK_CASE(DescriptorAllocatorFreeAllocate)
+{
+	constexpr uint32_t descriptorCount = 4096;
+	constexpr uint32_t operationCount = 1 << 21;
+
+	Dx12DescriptorHeap heap{ descriptorCount, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV };
+	std::mt19937 random{ 5 };
+
+	{
+		Dx12DescriptorAllocator allocator{ &heap, 0, descriptorCount };
+		std::vector<Dx12DescriptorAllocation> allocations;
+		for (uint32_t i = 0; i < descriptorCount * 3 / 4; i++)
+			allocations.push_back(allocator.Allocate());
+		std::shuffle(allocations.begin(), allocations.end(), random);
+
+		ReportMetric("single descriptors, 75% used", MeasureNanosecondsPerItem(operationCount, [&]() {
+			for (uint32_t i = 0; i < operationCount; i++)
+			{
+				Dx12DescriptorAllocation& allocation = allocations[i % allocations.size()];
+				allocator.Free(allocation);
+				allocation = allocator.Allocate();
+			}
+		}), "ns/op");
+	}
+
+	{
+		Dx12DescriptorAllocator allocator{ &heap, 0, descriptorCount };
+		std::vector<Dx12DescriptorAllocation> allocations;
+		for (uint32_t i = 0; i < 200; i++)
+			allocations.push_back(allocator.Allocate(1 + random() % 16));
+
+		ReportMetric("tables of 1-16 descriptors", MeasureNanosecondsPerItem(operationCount, [&]() {
+			for (uint32_t i = 0; i < operationCount; i++)
+			{
+				Dx12DescriptorAllocation& allocation = allocations[i % allocations.size()];
+				allocator.Free(allocation);
+				allocation = allocator.Allocate(1 + (i * 7) % 16);
+			}
+		}), "ns/op");
+	}
+}
@@ -0,0 +1,196 @@
+#include "Test/Dx12TestDevice.h"
+#include "Test/Test.h"
+
+#include "GpuApi/Dx12/Dx12DescriptorRing.h"
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+
+#include <wrl/client.h>
+
+using namespace dxe;
+using namespace Microsoft::WRL;
+
+// The fence is signaled on the CPU for the frames the GPU is pretended to have finished, so the tests
+// don't execute anything.
+
+namespace
+{
+	constexpr uint32_t RING_FIRST_DESCRIPTOR = 512;
+	constexpr uint32_t RING_DESCRIPTOR_COUNT = 512;
+
+	struct RingSetup
+	{
+		RingSetup()
+			: heap(RING_FIRST_DESCRIPTOR + RING_DESCRIPTOR_COUNT, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE),
+			sourceHeap(16, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
+		{
+			ID3D12Device* device = GetTestDevice();
+
+			fence.Initialize(device);
+			heap.Initialize(device);
+			sourceHeap.Initialize(device);
+
+			D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+			srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+			srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+			srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+			srvDesc.Texture2D.MipLevels = 1;
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				device->CreateShaderResourceView(nullptr, &srvDesc, sourceHeap.GetDescriptorHandle(i));
+				sources.push_back(sourceHeap.GetDescriptorHandle(i));
+			}
+
+			ring = std::make_unique<Dx12DescriptorRing>(device, &heap, &fence, RING_FIRST_DESCRIPTOR, RING_DESCRIPTOR_COUNT);
+		}
+
+		Dx12Fence fence;
+		Dx12DescriptorHeap heap;
+		Dx12DescriptorHeap sourceHeap;
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> sources;
+
+		std::unique_ptr<Dx12DescriptorRing> ring;
+	};
+}
+
+TEST_CASE(DescriptorRingAllocatesTablesInItsRange)
+{
+	RingSetup setup{};
+	Dx12DescriptorRing& ring = *setup.ring;
+
+	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> sources(setup.sources.begin(), setup.sources.begin() + 8);
+	Dx12DescriptorAllocation first = ring.AllocateTable(sources);
+	Dx12DescriptorAllocation second = ring.Allocate(4);
+
+	TEST_CHECK(first.index == RING_FIRST_DESCRIPTOR && first.count == 8);
+	TEST_CHECK(second.index == RING_FIRST_DESCRIPTOR + 8 && second.count == 4);
+	TEST_CHECK(first.GetCpuHandle(3).ptr == setup.heap.GetDescriptorHandle(RING_FIRST_DESCRIPTOR + 3).ptr);
+	TEST_CHECK(second.GetGpuHandle(1).ptr == setup.heap.GetGpuDescriptorHandle(RING_FIRST_DESCRIPTOR + 9).ptr);
+
+	RingStatistics statistics = ring.GetStatistics();
+	TEST_CHECK(statistics.usedSize == 12 && statistics.openBatchSize == 12 && statistics.allocationCount == 2);
+
+	TEST_CHECK_THROWS(ring.Allocate(RING_DESCRIPTOR_COUNT + 1), Error);
+}
+
+// Frames of random tables with the GPU three frames behind: a table must not be handed out again
+// while the frame that allocated it can still be in flight.
+TEST_CASE(DescriptorRingRecyclesFinishedFrames)
+{
+	constexpr uint64_t framesInFlight = 3;
+
+	RingSetup setup{};
+	Dx12DescriptorRing& ring = *setup.ring;
+	std::mt19937 random{ 5 };
+
+	// Fence value of the frame using each descriptor of the ring, 0 when it's free.
+	std::vector<uint64_t> usedBy(RING_DESCRIPTOR_COUNT, 0);
+
+	for (uint64_t frameFenceValue = 1; frameFenceValue <= 5000; frameFenceValue++)
+	{
+		uint64_t completedFenceValue = setup.fence.GetCompletedValue();
+
+		for (uint32_t tableIndex = random() % 10; tableIndex > 0; tableIndex--)
+		{
+			uint32_t count = 1 + random() % 8;
+			std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> sources(setup.sources.begin(), setup.sources.begin() + count);
+
+			Dx12DescriptorAllocation table = ring.AllocateTable(sources);
+			TEST_CHECK(table.index >= RING_FIRST_DESCRIPTOR && table.index + count <= RING_FIRST_DESCRIPTOR + RING_DESCRIPTOR_COUNT);
+
+			for (uint32_t index = table.index - RING_FIRST_DESCRIPTOR; index < table.index - RING_FIRST_DESCRIPTOR + count; index++)
+			{
+				TEST_CHECK(usedBy[index] <= completedFenceValue);
+				usedBy[index] = frameFenceValue;
+			}
+		}
+
+		ring.Submit(frameFenceValue);
+
+		if (frameFenceValue > framesInFlight)
+			TEST_CHECK(setup.fence.SignalOnCpu() == frameFenceValue - framesInFlight);
+		ring.Retire();
+	}
+
+	// At most 4 frames of 9 tables of 8 descriptors are in use, with room to spare.
+	TEST_CHECK(ring.GetStatistics().stallCount == 0);
+}
+
+// The GPU finishes the oldest frame a little later: the ring has to wait for it. The queue that
+// signals the frame's fence value first waits for a gate the CPU opens after a while.
+TEST_CASE(DescriptorRingWaitsWhenFull)
+{
+	RingSetup setup{};
+	Dx12DescriptorRing& ring = *setup.ring;
+	ID3D12Device* device = GetTestDevice();
+
+	D3D12_COMMAND_QUEUE_DESC queueDesc{};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+
+	ComPtr<ID3D12CommandQueue> queue;
+	DX12_THROW_IF_NOT_SUCCESS(
+		device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(queue.GetAddressOf())),
+		"Failed to create a Command Queue!");
+
+	Dx12Fence gate{};
+	gate.Initialize(device);
+	gate.WaitOnGpu(queue.Get(), gate.GetValue() + 1);
+
+	ring.Allocate(RING_DESCRIPTOR_COUNT);
+	ring.Submit(setup.fence.SignalOnGpu(queue.Get()));
+
+	std::thread gateOpener([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		gate.SignalOnCpu();
+	});
+
+	Dx12DescriptorAllocation table = ring.Allocate(4);
+	gateOpener.join();
+
+	TEST_CHECK(table.index == RING_FIRST_DESCRIPTOR);
+	TEST_CHECK(ring.GetStatistics().stallCount == 1);
+}
+
+// Per-frame tables of 1 to 8 descriptors, with and without copying the source descriptors.
+BENCHMARK_CASE(DescriptorRingTables)
+{
+	constexpr uint32_t tableCount = 1 << 20;
+	constexpr uint32_t tablesPerFrame = 32;
+
+	RingSetup setup{};
+	Dx12DescriptorRing& ring = *setup.ring;
+
+	auto endFrame = [&]() {
+		ring.Submit(setup.fence.SignalOnCpu());
+		ring.Retire();
+	};
+
+	ReportMetric("Allocate", MeasureNanosecondsPerItem(tableCount, [&]() {
+		for (uint32_t i = 0; i < tableCount; i++)
+		{
+			KeepValue(ring.Allocate(1 + i % 8).index);
+			if (i % tablesPerFrame == tablesPerFrame - 1)
+				endFrame();
+		}
+	}), "ns/table");
+
+	std::vector<std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>> sources;
+	for (uint32_t count = 1; count <= 8; count++)
+		sources.emplace_back(setup.sources.begin(), setup.sources.begin() + count);
+
+	ReportMetric("AllocateTable", MeasureNanosecondsPerItem(tableCount, [&]() {
+		for (uint32_t i = 0; i < tableCount; i++)
+		{
+			KeepValue(ring.AllocateTable(sources[i % 8]).index);
+			if (i % tablesPerFrame == tablesPerFrame - 1)
+				endFrame();
+		}
+	}), "ns/table");
+
+	ReportMetric("stalls", static_cast<double>(ring.GetStatistics().stallCount), "");
+}
@@ -0,0 +1,206 @@
+#include "Test/Dx12TestDevice.h"
+#include "Test/Test.h"
+
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <wrl/client.h>
+
+using namespace dxe;
+using namespace Microsoft::WRL;
+
+// Pending GPU values are made with queues that wait for a gate fence the test opens from the CPU, so
+// nothing has to be executed and the waits finish exactly when the test decides.
+
+namespace
+{
+	ComPtr<ID3D12CommandQueue> CreateQueue()
+	{
+		D3D12_COMMAND_QUEUE_DESC desc{};
+		desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+
+		ComPtr<ID3D12CommandQueue> queue;
+		DX12_THROW_IF_NOT_SUCCESS(
+			GetTestDevice()->CreateCommandQueue(&desc, IID_PPV_ARGS(queue.GetAddressOf())),
+			"Failed to create a test queue!");
+		return queue;
+	}
+
+	// A queue that doesn't get past its gate until Open, so values it signals stay pending until then.
+	class GatedQueue
+	{
+	public:
+
+		GatedQueue()
+			: queue(CreateQueue())
+		{
+			gate.Initialize(GetTestDevice());
+			gate.WaitOnGpu(queue.Get(), 1);
+		}
+		~GatedQueue()
+		{
+			// The queue must not be left waiting when a check failed.
+			if (!opened)
+				Open();
+			gate.WaitForValue(1);
+		}
+
+		CLASS_NO_COPY(GatedQueue);
+		CLASS_NO_MOVE(GatedQueue);
+
+		void Open()
+		{
+			gate.SignalOnCpu();
+			opened = true;
+		}
+		// Opens the gate from another thread after 'delay'.
+		std::thread OpenLater(std::chrono::milliseconds delay)
+		{
+			opened = true;
+			return std::thread([this, delay]() {
+				std::this_thread::sleep_for(delay);
+				gate.SignalOnCpu();
+			});
+		}
+
+		ID3D12CommandQueue* Get() const
+		{
+			return queue.Get();
+		}
+
+	private:
+
+		ComPtr<ID3D12CommandQueue> queue;
+		Dx12Fence gate;
+		bool opened{ false };
+	};
+}
+
+TEST_CASE(Dx12FenceSignalValues)
+{
+	Dx12Fence fence;
+	fence.Initialize(GetTestDevice());
+	TEST_CHECK(fence.GetValue() == 0 && fence.IsComplete(0));
+
+	TEST_CHECK(fence.SignalOnCpu() == 1 && fence.SignalOnCpu() == 2);
+	TEST_CHECK(fence.GetValue() == 2 && fence.GetCompletedValue() == 2);
+
+	ComPtr<ID3D12CommandQueue> queue = CreateQueue();
+	TEST_CHECK(fence.SignalOnGpu(queue.Get()) == 3);
+	fence.WaitForValue(3);
+	TEST_CHECK(fence.IsComplete(3));
+
+	TEST_CHECK(fence.SignalOnGpuAndWaitForFenceEvent(queue.Get()) == 4);
+	TEST_CHECK(fence.GetValue() == 4 && fence.GetCompletedValue() == 4);
+
+	// CPU and GPU signals share the values.
+	TEST_CHECK(fence.SignalOnCpu() == 5 && fence.SignalOnGpu(queue.Get()) == 6);
+	fence.WaitForFenceEvent();
+	TEST_CHECK(fence.IsComplete(6));
+}
+
+// The completed value is cached and only grows; the fence is read when the cache doesn't tell.
+TEST_CASE(Dx12FenceCachesCompletedValue)
+{
+	Dx12Fence fence;
+	fence.Initialize(GetTestDevice());
+	fence.SignalOnCpu();
+	fence.SignalOnCpu();
+	TEST_CHECK(fence.GetCompletedValue() == 2);
+
+	// Set lower behind the fence's back: the values known to be complete stay complete.
+	fence.GetFence()->Signal(1);
+	TEST_CHECK(fence.GetFence()->GetCompletedValue() == 1);
+	TEST_CHECK(fence.IsComplete(2) && fence.GetCompletedValue() == 2);
+
+	GatedQueue queue;
+	uint64_t value = fence.SignalOnGpu(queue.Get());
+	TEST_CHECK(value == 3 && !fence.IsComplete(value));
+
+	queue.Open();
+	fence.WaitForValue(value);
+	TEST_CHECK(fence.IsComplete(value) && fence.GetCompletedValue() == value);
+}
+
+TEST_CASE(Dx12FenceWaitForAll)
+{
+	Dx12Fence first;
+	Dx12Fence second;
+	first.Initialize(GetTestDevice());
+	second.Initialize(GetTestDevice());
+
+	// Nothing pending: returns right away.
+	Dx12Fence::WaitForAll({ { &first, 0 }, { &second, 0 } });
+
+	GatedQueue firstQueue;
+	GatedQueue secondQueue;
+	uint64_t firstValue = first.SignalOnGpu(firstQueue.Get());
+	uint64_t secondValue = second.SignalOnGpu(secondQueue.Get());
+	uint64_t laterValue = first.SignalOnGpu(firstQueue.Get());
+
+	std::thread firstOpener = firstQueue.OpenLater(std::chrono::milliseconds{ 10 });
+	std::thread secondOpener = secondQueue.OpenLater(std::chrono::milliseconds{ 30 });
+
+	// A fence listed twice waits for its larger value.
+	Dx12Fence::WaitForAll({ { &first, firstValue }, { &second, secondValue }, { &first, laterValue } });
+	TEST_CHECK(first.IsComplete(laterValue) && second.IsComplete(secondValue));
+
+	firstOpener.join();
+	secondOpener.join();
+}
+
+TEST_CASE(Dx12FenceWaitForAny)
+{
+	Dx12Fence first;
+	Dx12Fence second;
+	first.Initialize(GetTestDevice());
+	second.Initialize(GetTestDevice());
+
+	GatedQueue firstQueue;
+	GatedQueue secondQueue;
+	uint64_t firstValue = first.SignalOnGpu(firstQueue.Get());
+	uint64_t secondValue = second.SignalOnGpu(secondQueue.Get());
+
+	std::thread secondOpener = secondQueue.OpenLater(std::chrono::milliseconds{ 10 });
+
+	TEST_CHECK(Dx12Fence::WaitForAny({ { &first, firstValue }, { &second, secondValue } }) == 1);
+	TEST_CHECK(second.IsComplete(secondValue) && !first.IsComplete(firstValue));
+	secondOpener.join();
+
+	// A complete value is found without waiting.
+	TEST_CHECK(Dx12Fence::WaitForAny({ { &first, firstValue }, { &second, secondValue } }) == 1);
+
+	firstQueue.Open();
+	TEST_CHECK(Dx12Fence::WaitForAny({ { &first, firstValue } }) == 0);
+}
+
+// One event per pending fence, at most MAXIMUM_WAIT_OBJECTS of them.
+TEST_CASE(Dx12FenceTooManyWaits)
+{
+	GatedQueue queue;
+
+	std::vector<std::unique_ptr<Dx12Fence>> fences;
+	std::vector<Dx12FenceWait> waits;
+	for (uint32_t i = 0; i < MAXIMUM_WAIT_OBJECTS + 1; i++)
+	{
+		fences.push_back(std::make_unique<Dx12Fence>());
+		fences.back()->Initialize(GetTestDevice());
+		waits.push_back(Dx12FenceWait{ fences.back().get(), fences.back()->SignalOnGpu(queue.Get()) });
+	}
+
+	TEST_CHECK_THROWS(Dx12Fence::WaitForAll(waits), Error);
+	TEST_CHECK_THROWS(Dx12Fence::WaitForAny(waits), Error);
+
+	// The same fence listed many times is a single event.
+	std::vector<Dx12FenceWait> sameFenceWaits(MAXIMUM_WAIT_OBJECTS + 1, waits[0]);
+	std::thread opener = queue.OpenLater(std::chrono::milliseconds{ 10 });
+	Dx12Fence::WaitForAll(sameFenceWaits);
+	opener.join();
+
+	// Once the values are complete, nothing is left to wait for.
+	Dx12Fence::WaitForAll(waits);
+	TEST_CHECK(Dx12Fence::WaitForAny(waits) == 0);
+}
@@ -0,0 +1,383 @@
+#include "Test/Test.h"
+
+#include "GpuApi/Dx12/Dx12ResourceStateTracker.h"
+
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+
+using namespace dxe;
+
+namespace
+{
+	constexpr D3D12_RESOURCE_STATES PIXEL_SHADER_RESOURCE = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE;
+	constexpr D3D12_RESOURCE_STATES NON_PIXEL_SHADER_RESOURCE = D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+	constexpr D3D12_RESOURCE_STATES RENDER_TARGET = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	constexpr D3D12_RESOURCE_STATES UNORDERED_ACCESS = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	constexpr D3D12_RESOURCE_STATES COPY_DEST = D3D12_RESOURCE_STATE_COPY_DEST;
+	constexpr D3D12_RESOURCE_STATES COPY_SOURCE = D3D12_RESOURCE_STATE_COPY_SOURCE;
+	constexpr D3D12_RESOURCE_STATES PRESENT = D3D12_RESOURCE_STATE_PRESENT;
+	constexpr UINT ALL_SUBRESOURCES = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+	// Stands in for ID3D12GraphicsCommandList, keeps the barriers of every ResourceBarrier call.
+	struct RecordingCommandList
+	{
+		void ResourceBarrier(UINT barrierCount, const D3D12_RESOURCE_BARRIER* barriers)
+		{
+			calls.emplace_back(barriers, barriers + barrierCount);
+		}
+
+		std::vector<std::vector<D3D12_RESOURCE_BARRIER>> calls;
+	};
+
+	// The tracker only uses resources as keys, distinct addresses stand in for them.
+	class FakeResources
+	{
+	public:
+
+		explicit FakeResources(size_t count)
+			: storage(count) {}
+
+		ID3D12Resource* operator[](size_t index)
+		{
+			return reinterpret_cast<ID3D12Resource*>(&storage[index]);
+		}
+
+	private:
+
+		std::vector<uint64_t> storage;
+	};
+
+	bool IsReadState(D3D12_RESOURCE_STATES state)
+	{
+		const D3D12_RESOURCE_STATES readStates = D3D12_RESOURCE_STATE_GENERIC_READ |
+			PIXEL_SHADER_RESOURCE | NON_PIXEL_SHADER_RESOURCE;
+		return state != 0 && (state & ~readStates) == 0;
+	}
+
+	// Applies the barriers like the GPU would and checks each StateBefore against the actual state.
+	class GpuStates
+	{
+	public:
+
+		void TrackResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, uint32_t subresourceCount)
+		{
+			subresourceCounts[resource] = subresourceCount;
+			for (UINT subresource = 0; subresource < subresourceCount; subresource++)
+				states[{ resource, subresource }] = state;
+		}
+
+		void Execute(const RecordingCommandList& commandList)
+		{
+			for (const std::vector<D3D12_RESOURCE_BARRIER>& call : commandList.calls)
+			{
+				for (const D3D12_RESOURCE_BARRIER& barrier : call)
+				{
+					if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+						Execute(barrier);
+				}
+			}
+		}
+
+		D3D12_RESOURCE_STATES GetState(ID3D12Resource* resource, UINT subresource) const
+		{
+			return states.at({ resource, subresource });
+		}
+		bool IsSplitPending(ID3D12Resource* resource, UINT subresource) const
+		{
+			return splitStates.count({ resource, subresource }) > 0;
+		}
+
+	private:
+
+		using Subresource = std::pair<ID3D12Resource*, UINT>;
+
+		void Execute(const D3D12_RESOURCE_BARRIER& barrier)
+		{
+			const D3D12_RESOURCE_TRANSITION_BARRIER& transition = barrier.Transition;
+			TEST_CHECK(transition.StateBefore != transition.StateAfter);
+
+			bool allSubresources = transition.Subresource == ALL_SUBRESOURCES;
+			UINT firstSubresource = allSubresources ? 0 : transition.Subresource;
+			UINT endSubresource = allSubresources ? subresourceCounts.at(transition.pResource) : transition.Subresource + 1;
+
+			for (UINT subresource = firstSubresource; subresource < endSubresource; subresource++)
+			{
+				Subresource key{ transition.pResource, subresource };
+				TEST_CHECK(states.at(key) == transition.StateBefore);
+
+				if (barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY)
+				{
+					TEST_CHECK(splitStates.count(key) == 0);
+					splitStates[key] = transition.StateAfter;
+					continue;
+				}
+				if (barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY)
+				{
+					TEST_CHECK(splitStates.count(key) == 1 && splitStates[key] == transition.StateAfter);
+					splitStates.erase(key);
+				}
+				else
+				{
+					TEST_CHECK(splitStates.count(key) == 0);
+				}
+				states[key] = transition.StateAfter;
+			}
+		}
+
+		std::map<ID3D12Resource*, uint32_t> subresourceCounts;
+		std::map<Subresource, D3D12_RESOURCE_STATES> states;
+		std::map<Subresource, D3D12_RESOURCE_STATES> splitStates;
+	};
+}
+
+TEST_CASE(ResourceStateTrackerMergesTransitions)
+{
+	FakeResources resources{ 2 };
+	ID3D12Resource* a = resources[0];
+	ID3D12Resource* b = resources[1];
+
+	Dx12ResourceStateTracker tracker{};
+	RecordingCommandList commandList{};
+	tracker.TrackResource(a, PRESENT);
+	tracker.TrackResource(b, PIXEL_SHADER_RESOURCE);
+
+	tracker.Transition(a, RENDER_TARGET);
+	tracker.Transition(b, PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 1);
+
+	tracker.Transition(b, COPY_DEST);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 2);
+	TEST_CHECK(commandList.calls.size() == 1 && commandList.calls[0].size() == 2);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 0 && commandList.calls.size() == 1);
+
+	// A -> B -> C is A -> C, and two read states are combined.
+	tracker.Transition(a, COPY_SOURCE);
+	tracker.Transition(a, PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 1);
+	tracker.FlushBarriers(&commandList);
+
+	const D3D12_RESOURCE_TRANSITION_BARRIER& merged = commandList.calls[1][0].Transition;
+	TEST_CHECK(merged.StateBefore == RENDER_TARGET && merged.StateAfter == (COPY_SOURCE | PIXEL_SHADER_RESOURCE));
+	TEST_CHECK(tracker.GetState(a) == (COPY_SOURCE | PIXEL_SHADER_RESOURCE));
+
+	// Already included in the current read state.
+	tracker.Transition(a, COPY_SOURCE);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 0);
+
+	// A -> B -> A disappears.
+	tracker.Transition(a, RENDER_TARGET);
+	tracker.Transition(a, COPY_SOURCE | PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 0);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 0);
+
+	ResourceStateStatistics statistics = tracker.GetStatistics();
+	TEST_CHECK(statistics.transitionRequestCount == 8);
+	TEST_CHECK(statistics.transitionBarrierCount == 3);
+	TEST_CHECK(statistics.flushCount == 2);
+
+	tracker.Reset();
+	TEST_CHECK(!tracker.IsTracked(a) && !tracker.IsTracked(b) && tracker.GetPendingBarrierCount() == 0);
+}
+
+TEST_CASE(ResourceStateTrackerQueuesUavBarriers)
+{
+	FakeResources resources{ 1 };
+	ID3D12Resource* resource = resources[0];
+
+	Dx12ResourceStateTracker tracker{};
+	RecordingCommandList commandList{};
+	tracker.TrackResource(resource, UNORDERED_ACCESS);
+
+	// Nothing accessed the resource between the two.
+	tracker.UavBarrier(resource);
+	tracker.UavBarrier(resource);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 1);
+	tracker.FlushBarriers(&commandList);
+	TEST_CHECK(tracker.GetStatistics().uavBarrierCount == 1);
+	TEST_CHECK(commandList.calls[0][0].Type == D3D12_RESOURCE_BARRIER_TYPE_UAV);
+
+	// A transition isn't merged across a UAV barrier.
+	tracker.UavBarrier(resource);
+	tracker.Transition(resource, PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 2);
+}
+
+TEST_CASE(ResourceStateTrackerTracksSubresources)
+{
+	FakeResources resources{ 1 };
+	ID3D12Resource* texture = resources[0];
+
+	Dx12ResourceStateTracker tracker{};
+	RecordingCommandList commandList{};
+	tracker.TrackResource(texture, COPY_DEST, 4);
+
+	tracker.Transition(texture, PIXEL_SHADER_RESOURCE, 2);
+	TEST_CHECK(tracker.GetState(texture, 2) == PIXEL_SHADER_RESOURCE && tracker.GetState(texture, 1) == COPY_DEST);
+
+	// One barrier per subresource that isn't in the state yet.
+	tracker.Transition(texture, PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.GetPendingBarrierCount() == 4);
+	tracker.FlushBarriers(&commandList);
+	TEST_CHECK(tracker.GetState(texture) == PIXEL_SHADER_RESOURCE);
+
+	// Back to one state once every subresource is in it.
+	for (UINT subresource = 0; subresource < 4; subresource++)
+		tracker.Transition(texture, RENDER_TARGET, subresource);
+	TEST_CHECK(tracker.GetState(texture) == RENDER_TARGET);
+	tracker.FlushBarriers(&commandList);
+	TEST_CHECK(commandList.calls.back().size() == 4);
+}
+
+TEST_CASE(ResourceStateTrackerSplitsBarriers)
+{
+	FakeResources resources{ 1 };
+	ID3D12Resource* resource = resources[0];
+
+	Dx12ResourceStateTracker tracker{};
+	RecordingCommandList commandList{};
+	tracker.TrackResource(resource, RENDER_TARGET);
+
+	tracker.BeginTransition(resource, PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 1);
+	TEST_CHECK(commandList.calls[0][0].Flags == D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY);
+
+	tracker.Transition(resource, PIXEL_SHADER_RESOURCE);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 1);
+	TEST_CHECK(commandList.calls[1][0].Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+	TEST_CHECK(commandList.calls[1][0].Transition.StateBefore == RENDER_TARGET);
+
+	// Both halves in the same flush are a regular barrier, merged with the next transition.
+	tracker.BeginTransition(resource, RENDER_TARGET);
+	tracker.Transition(resource, COPY_DEST);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 1);
+	const D3D12_RESOURCE_BARRIER& merged = commandList.calls[2][0];
+	TEST_CHECK(merged.Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE);
+	TEST_CHECK(merged.Transition.StateBefore == PIXEL_SHADER_RESOURCE && merged.Transition.StateAfter == COPY_DEST);
+
+	// A different state after the BEGIN_ONLY half: the END_ONLY half, then another barrier.
+	tracker.BeginTransition(resource, RENDER_TARGET);
+	tracker.FlushBarriers(&commandList);
+	tracker.Transition(resource, UNORDERED_ACCESS);
+	TEST_CHECK(tracker.FlushBarriers(&commandList) == 2);
+	TEST_CHECK(commandList.calls.back()[0].Flags == D3D12_RESOURCE_BARRIER_FLAG_END_ONLY);
+	TEST_CHECK(commandList.calls.back()[1].Transition.StateBefore == RENDER_TARGET);
+
+	ResourceStateStatistics statistics = tracker.GetStatistics();
+	TEST_CHECK(statistics.transitionRequestCount == 6 && statistics.transitionBarrierCount == 6);
+}
+
+// Random transitions, split barriers and UAV barriers replayed on a GPU state model: every issued
+// barrier has to start from the state the (sub)resource is actually in, and after each flush every
+// (sub)resource has to be in the state last asked for, or a read state that includes it.
+TEST_CASE(ResourceStateTrackerRandomReplay)
+{
+	constexpr uint32_t resourceCount = 6;
+	constexpr uint32_t stepCount = 200000;
+	const D3D12_RESOURCE_STATES states[] = {
+		PIXEL_SHADER_RESOURCE, NON_PIXEL_SHADER_RESOURCE, RENDER_TARGET, UNORDERED_ACCESS,
+		COPY_DEST, COPY_SOURCE, PRESENT, PIXEL_SHADER_RESOURCE | NON_PIXEL_SHADER_RESOURCE };
+
+	std::mt19937 random{ 11 };
+	FakeResources resources{ resourceCount };
+	std::vector<uint32_t> subresourceCounts(resourceCount);
+
+	Dx12ResourceStateTracker tracker{};
+	RecordingCommandList commandList{};
+	GpuStates gpuStates{};
+	std::map<std::pair<uint32_t, UINT>, D3D12_RESOURCE_STATES> requestedStates;
+
+	for (uint32_t resourceIndex = 0; resourceIndex < resourceCount; resourceIndex++)
+	{
+		subresourceCounts[resourceIndex] = resourceIndex < 3 ? 1 : 1 + random() % 6;
+		D3D12_RESOURCE_STATES state = states[resourceIndex % 7];
+
+		tracker.TrackResource(resources[resourceIndex], state, subresourceCounts[resourceIndex]);
+		gpuStates.TrackResource(resources[resourceIndex], state, subresourceCounts[resourceIndex]);
+		for (UINT subresource = 0; subresource < subresourceCounts[resourceIndex]; subresource++)
+			requestedStates[{ resourceIndex, subresource }] = state;
+	}
+
+	for (uint32_t step = 0; step < stepCount; step++)
+	{
+		uint32_t operation = random() % 100;
+		uint32_t resourceIndex = random() % resourceCount;
+		uint32_t subresourceCount = subresourceCounts[resourceIndex];
+		UINT subresource = subresourceCount > 1 && random() % 3 == 0 ? random() % subresourceCount : ALL_SUBRESOURCES;
+		D3D12_RESOURCE_STATES state = states[random() % std::size(states)];
+		ID3D12Resource* resource = resources[resourceIndex];
+
+		if (operation < 80)
+		{
+			if (operation < 70)
+				tracker.Transition(resource, state, subresource);
+			else
+				tracker.BeginTransition(resource, state, subresource);
+
+			UINT firstSubresource = subresource == ALL_SUBRESOURCES ? 0 : subresource;
+			UINT endSubresource = subresource == ALL_SUBRESOURCES ? subresourceCount : subresource + 1;
+			for (UINT requested = firstSubresource; requested < endSubresource; requested++)
+				requestedStates[{ resourceIndex, requested }] = state;
+		}
+		else if (operation < 85)
+		{
+			tracker.UavBarrier(resource);
+		}
+		else
+		{
+			tracker.FlushBarriers(&commandList);
+			gpuStates.Execute(commandList);
+			commandList.calls.clear();
+
+			for (const auto& [key, requestedState] : requestedStates)
+			{
+				ID3D12Resource* requestedResource = resources[key.first];
+				if (gpuStates.IsSplitPending(requestedResource, key.second))
+					continue;
+
+				D3D12_RESOURCE_STATES gpuState = gpuStates.GetState(requestedResource, key.second);
+				TEST_CHECK(gpuState == requestedState ||
+					(IsReadState(gpuState) && IsReadState(requestedState) && (gpuState & requestedState) == requestedState));
+			}
+		}
+	}
+
+	ResourceStateStatistics statistics = tracker.GetStatistics();
+	TEST_CHECK(statistics.transitionBarrierCount < statistics.transitionRequestCount);
+}
+
+// Transitions of 256 resources between two states, flushed every 64 requests.
+BENCHMARK_CASE(ResourceStateTrackerTransitions)
+{
+	struct NullCommandList
+	{
+		void ResourceBarrier(UINT barrierCount, const D3D12_RESOURCE_BARRIER* barriers)
+		{
+			KeepValue(barriers[barrierCount - 1].Type);
+		}
+	};
+
+	constexpr uint32_t resourceCount = 256;
+	constexpr uint32_t requestCount = 1 << 22;
+
+	FakeResources resources{ resourceCount };
+	Dx12ResourceStateTracker tracker{};
+	NullCommandList commandList{};
+
+	for (uint32_t resourceIndex = 0; resourceIndex < resourceCount; resourceIndex++)
+		tracker.TrackResource(resources[resourceIndex], PIXEL_SHADER_RESOURCE);
+
+	ReportMetric("Transition + FlushBarriers", MeasureNanosecondsPerItem(requestCount, [&]() {
+		for (uint32_t i = 0; i < requestCount; i++)
+		{
+			tracker.Transition(resources[i % resourceCount], (i / resourceCount) % 2 ? RENDER_TARGET : PIXEL_SHADER_RESOURCE);
+			if (i % 64 == 63)
+				tracker.FlushBarriers(&commandList);
+		}
+	}), "ns/request");
+
+	ResourceStateStatistics statistics = tracker.GetStatistics();
+	ReportMetric("barriers per ResourceBarrier call",
+		static_cast<double>(statistics.transitionBarrierCount) / statistics.flushCount, "barriers");
+}
@@ -0,0 +1,166 @@
+#include "Test/Test.h"
+
+#include "GpuApi/FenceTimeline.h"
+
+using namespace dxe;
+
+// The fence is a CPU fake: the test decides how far the "GPU" is and counts how often the value is
+// read, so the bookkeeping Dx12Fence relies on is checked without a device.
+
+namespace
+{
+	class FakeFence
+	{
+	public:
+
+		uint64_t Signal()
+		{
+			return timeline.Advance();
+		}
+		bool IsComplete(uint64_t value)
+		{
+			return timeline.IsComplete(value, [this]() { readCount++; return reachedValue; });
+		}
+
+		FenceTimeline timeline;
+		// The value the "GPU" has reached.
+		uint64_t reachedValue{ 0 };
+		uint32_t readCount{ 0 };
+	};
+
+	struct FakeFenceWait
+	{
+		FakeFence* fence{ nullptr };
+		uint64_t value{ 0 };
+	};
+
+	std::vector<FakeFenceWait> MergePending(const std::vector<FakeFenceWait>& waits, bool waitAll)
+	{
+		return MergePendingFenceWaits(waits, waitAll,
+			[](const FakeFenceWait& wait) { return wait.fence->IsComplete(wait.value); });
+	}
+}
+
+TEST_CASE(FenceTimelineSignalValues)
+{
+	FakeFence fence;
+	TEST_CHECK(fence.timeline.GetValue() == 0 && fence.timeline.GetCompletedValue() == 0);
+	// Nothing signaled yet: 0 is complete without reading the fence.
+	TEST_CHECK(fence.IsComplete(0) && fence.readCount == 0);
+
+	TEST_CHECK(fence.Signal() == 1 && fence.Signal() == 2 && fence.Signal() == 3);
+	TEST_CHECK(fence.timeline.GetValue() == 3 && fence.timeline.GetCompletedValue() == 0);
+
+	fence.timeline.Reset();
+	TEST_CHECK(fence.timeline.GetValue() == 0 && fence.Signal() == 1);
+}
+
+// The fence is only read when the cached completed value doesn't tell.
+TEST_CASE(FenceTimelineCachesCompletedValue)
+{
+	FakeFence fence;
+	for (uint32_t i = 0; i < 4; i++)
+		fence.Signal();
+
+	TEST_CHECK(!fence.IsComplete(1) && fence.readCount == 1);
+
+	fence.reachedValue = 2;
+	TEST_CHECK(fence.IsComplete(2) && fence.readCount == 2);
+	TEST_CHECK(fence.timeline.GetCompletedValue() == 2);
+
+	// Values up to 2 are answered from the cache.
+	TEST_CHECK(fence.IsComplete(1) && fence.IsComplete(2) && fence.readCount == 2);
+
+	TEST_CHECK(!fence.IsComplete(4) && fence.readCount == 3);
+	fence.reachedValue = 4;
+	TEST_CHECK(fence.IsComplete(3) && fence.readCount == 4);
+	TEST_CHECK(fence.IsComplete(4) && fence.readCount == 4);
+}
+
+// The completed value only grows, a fence set back lower doesn't make values pending again.
+TEST_CASE(FenceTimelineCompletedValueOnlyGrows)
+{
+	FakeFence fence;
+	fence.Signal();
+	fence.Signal();
+	fence.Signal();
+
+	fence.reachedValue = 2;
+	TEST_CHECK(fence.IsComplete(2));
+
+	fence.reachedValue = 1;
+	TEST_CHECK(fence.timeline.UpdateCompletedValue(fence.reachedValue) == 2);
+	TEST_CHECK(fence.IsComplete(2) && !fence.IsComplete(3));
+	TEST_CHECK(fence.timeline.GetCompletedValue() == 2);
+}
+
+TEST_CASE(FenceTimelineMergesWaitsForAll)
+{
+	FakeFence first;
+	FakeFence second;
+	for (uint32_t i = 0; i < 5; i++)
+	{
+		first.Signal();
+		second.Signal();
+	}
+	first.reachedValue = 1;
+
+	// A fence listed twice waits for its larger value, complete waits are dropped.
+	std::vector<FakeFenceWait> pending = MergePending(
+		{ { &first, 2 }, { &second, 3 }, { &first, 4 }, { &first, 1 }, { &second, 0 } }, true);
+	TEST_CHECK(pending.size() == 2);
+	TEST_CHECK(pending[0].fence == &first && pending[0].value == 4);
+	TEST_CHECK(pending[1].fence == &second && pending[1].value == 3);
+
+	second.reachedValue = 5;
+	pending = MergePending({ { &first, 2 }, { &second, 3 }, { &first, 4 } }, true);
+	TEST_CHECK(pending.size() == 1 && pending[0].fence == &first && pending[0].value == 4);
+
+	// Nothing pending once every value completes.
+	first.reachedValue = 5;
+	TEST_CHECK(MergePending({ { &first, 2 }, { &second, 3 }, { &first, 4 } }, true).empty());
+	TEST_CHECK(MergePending({}, true).empty());
+}
+
+TEST_CASE(FenceTimelineMergesWaitsForAny)
+{
+	FakeFence first;
+	FakeFence second;
+	for (uint32_t i = 0; i < 5; i++)
+	{
+		first.Signal();
+		second.Signal();
+	}
+
+	// A fence listed twice waits for its smaller value.
+	std::vector<FakeFenceWait> pending = MergePending(
+		{ { &second, 5 }, { &first, 4 }, { &second, 2 }, { &first, 3 } }, false);
+	TEST_CHECK(pending.size() == 2);
+	TEST_CHECK(pending[0].fence == &second && pending[0].value == 2);
+	TEST_CHECK(pending[1].fence == &first && pending[1].value == 3);
+
+	// Only the pending values of a fence are merged: second's 2 is complete, its 5 is left.
+	second.reachedValue = 2;
+	pending = MergePending({ { &second, 5 }, { &first, 4 }, { &second, 2 } }, false);
+	TEST_CHECK(pending.size() == 2);
+	TEST_CHECK(pending[0].fence == &second && pending[0].value == 5);
+	TEST_CHECK(pending[1].fence == &first && pending[1].value == 4);
+}
+
+// Many waits on one fence cost a single read once the value is cached as complete.
+TEST_CASE(FenceTimelineMergeReadsCachedValues)
+{
+	FakeFence fence;
+	for (uint32_t i = 0; i < 8; i++)
+		fence.Signal();
+	fence.reachedValue = 8;
+
+	std::vector<FakeFenceWait> waits;
+	for (uint64_t value = 1; value <= 8; value++)
+		waits.push_back(FakeFenceWait{ &fence, value });
+
+	TEST_CHECK(MergePending(waits, true).empty());
+	TEST_CHECK(fence.readCount == 1);
+	TEST_CHECK(MergePending(waits, false).empty());
+	TEST_CHECK(fence.readCount == 1);
+}
@@ -0,0 +1,241 @@
+#include "Test/Test.h"
+
+#include "IO/IoScheduler.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace dxe;
+
+namespace
+{
+	// Files with random contents in a fresh directory under the temp path, removed with the object.
+	class TemporaryFiles
+	{
+	public:
+
+		explicit TemporaryFiles(const char* directoryName)
+			: directory(std::filesystem::temp_directory_path() / directoryName)
+		{
+			std::filesystem::remove_all(directory);
+			std::filesystem::create_directories(directory);
+		}
+		~TemporaryFiles()
+		{
+			std::error_code error;
+			std::filesystem::remove_all(directory, error);
+		}
+
+		CLASS_NO_COPY(TemporaryFiles);
+		CLASS_NO_MOVE(TemporaryFiles);
+
+		const std::filesystem::path& Add(uint64_t size)
+		{
+			std::vector<uint8_t> data(size);
+			for (uint8_t& byte : data)
+				byte = static_cast<uint8_t>(random());
+
+			paths.push_back(directory / ("file" + std::to_string(paths.size())));
+			contents.push_back(data);
+
+			std::ofstream file(paths.back(), std::ofstream::binary);
+			file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+			return paths.back();
+		}
+
+		std::filesystem::path directory;
+		std::vector<std::filesystem::path> paths;
+		std::vector<std::vector<uint8_t>> contents;
+
+	private:
+
+		std::mt19937 random{ 5 };
+	};
+
+	IoSchedulerSettings CreateSettings(bool forceThreadPoolBackend, uint32_t queueDepth = 64)
+	{
+		IoSchedulerSettings settings{};
+		settings.queueDepth = queueDepth;
+		settings.forceThreadPoolBackend = forceThreadPoolBackend;
+		return settings;
+	}
+
+	// Reads every file through the scheduler and returns the bytes read, checks the contents when asked.
+	uint64_t ReadAll(IoScheduler& scheduler, const TemporaryFiles& files, bool checkContents)
+	{
+		std::atomic<uint64_t> bytesRead{ 0 };
+		std::atomic<uint32_t> mismatchCount{ 0 };
+
+		std::vector<IoReadRequest> requests;
+		requests.reserve(files.paths.size());
+
+		for (size_t fileIndex = 0; fileIndex < files.paths.size(); fileIndex++)
+		{
+			IoReadRequest request{};
+			request.path = files.paths[fileIndex];
+			request.onComplete = [&, fileIndex](IoReadResult& result) {
+				bytesRead += result.data.size();
+				if (!result.succeeded || (checkContents && result.data != files.contents[fileIndex]))
+					mismatchCount++;
+			};
+			requests.push_back(std::move(request));
+		}
+
+		scheduler.Read(requests);
+		scheduler.WaitIdle();
+
+		TEST_CHECK(mismatchCount == 0);
+		return bytesRead;
+	}
+}
+
+TEST_CASE(IoSchedulerReadsFiles)
+{
+	TemporaryFiles files{ "dxe-io-tests" };
+	for (uint32_t i = 0; i < 300; i++)
+		files.Add(i * 97);
+	files.Add(3 << 20);
+
+	for (bool forceThreadPoolBackend : { false, true })
+	{
+		IoScheduler scheduler{ CreateSettings(forceThreadPoolBackend, 16) };
+		ReadAll(scheduler, files, true);
+
+		TEST_CHECK(scheduler.GetStats().requestsCompleted == files.paths.size());
+	}
+}
+
+TEST_CASE(IoSchedulerReadsRanges)
+{
+	TemporaryFiles files{ "dxe-io-tests" };
+	const std::filesystem::path& path = files.Add(10000);
+	const std::vector<uint8_t>& contents = files.contents.back();
+
+	for (bool forceThreadPoolBackend : { false, true })
+	{
+		IoScheduler scheduler{ CreateSettings(forceThreadPoolBackend) };
+
+		auto read = [&](uint64_t offset, uint64_t size) {
+			IoReadRequest request{};
+			request.path = path;
+			request.offset = offset;
+			request.size = size;
+			return scheduler.ReadAsync(std::move(request)).get();
+		};
+
+		IoReadResult range = read(1000, 500);
+		TEST_CHECK(range.succeeded && range.offset == 1000);
+		TEST_CHECK(std::equal(range.data.begin(), range.data.end(), contents.begin() + 1000) && range.data.size() == 500);
+
+		IoReadResult tail = read(9000, 0);
+		TEST_CHECK(tail.succeeded && tail.data.size() == 1000);
+
+		IoReadResult end = read(10000, 0);
+		TEST_CHECK(end.succeeded && end.data.empty());
+
+		TEST_CHECK(!read(9000, 1001).succeeded);
+		TEST_CHECK(!read(10001, 0).succeeded);
+
+		IoReadRequest missing{};
+		missing.path = files.directory / "missing";
+		IoReadResult missingResult = scheduler.ReadAsync(std::move(missing)).get();
+		TEST_CHECK(!missingResult.succeeded && !missingResult.errorMessage.empty() && missingResult.data.empty());
+	}
+}
+
+// Requests trickle in from several threads while reads are in flight, so the dispatcher has to pick
+// them up between completions.
+TEST_CASE(IoSchedulerServesConcurrentRequests)
+{
+	TemporaryFiles files{ "dxe-io-tests" };
+	for (uint32_t i = 0; i < 64; i++)
+		files.Add(4096 + i);
+
+	for (bool forceThreadPoolBackend : { false, true })
+	{
+		IoScheduler scheduler{ CreateSettings(forceThreadPoolBackend, 8) };
+
+		std::atomic<uint32_t> completedCount{ 0 };
+		std::atomic<uint32_t> mismatchCount{ 0 };
+
+		std::vector<std::thread> threads;
+		for (uint32_t threadIndex = 0; threadIndex < 4; threadIndex++)
+		{
+			threads.emplace_back([&, threadIndex]() {
+				for (uint32_t i = 0; i < 200; i++)
+				{
+					size_t fileIndex = (threadIndex * 200 + i) % files.paths.size();
+
+					IoReadRequest request{};
+					request.path = files.paths[fileIndex];
+					request.priority = static_cast<IoPriority>(i % 4);
+					request.onComplete = [&, fileIndex](IoReadResult& result) {
+						if (result.data != files.contents[fileIndex])
+							mismatchCount++;
+						completedCount++;
+					};
+					scheduler.Read(std::move(request));
+
+					if (i % 16 == 0)
+						std::this_thread::yield();
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		scheduler.WaitIdle();
+		TEST_CHECK(completedCount == 800 && mismatchCount == 0);
+	}
+}
+
+// Thousands of small files and a few large ones, read with each backend and with blocking reads
+// one after the other. The files were just written, so they come from the page cache: this measures
+// the per-request overhead rather than the drive.
+BENCHMARK_CASE(IoSchedulerThroughput)
+{
+	struct FileSet
+	{
+		const char* name{ nullptr };
+		uint32_t fileCount{ 0 };
+		uint64_t fileSize{ 0 };
+	};
+
+	for (const FileSet& fileSet : { FileSet{ "4 KiB", 4000, 4096 }, FileSet{ "8 MiB", 32, 8 << 20 } })
+	{
+		TemporaryFiles files{ "dxe-io-bench" };
+		for (uint32_t i = 0; i < fileSet.fileCount; i++)
+			files.Add(fileSet.fileSize);
+
+		const uint64_t totalSize = fileSet.fileCount * fileSet.fileSize;
+		auto report = [&](const char* reader, double nanosecondsPerFile) {
+			double seconds = nanosecondsPerFile * fileSet.fileCount / 1e9;
+			ReportMetric(std::string{ fileSet.name } + " files, " + reader, nanosecondsPerFile / 1000.0, "us/file");
+			ReportMetric(std::string{ fileSet.name } + " files, " + reader, totalSize / seconds / (1 << 20), "MiB/s");
+		};
+
+		report("blocking reads", MeasureNanosecondsPerItem(fileSet.fileCount, [&]() {
+			for (const std::filesystem::path& path : files.paths)
+			{
+				IoReadRequest request{};
+				request.path = path;
+				KeepValue(ReadFileBlocking(request).data.size());
+			}
+		}, 3));
+
+		for (bool forceThreadPoolBackend : { false, true })
+		{
+			IoScheduler scheduler{ CreateSettings(forceThreadPoolBackend, 128) };
+			const char* reader = scheduler.GetBackendType() == IoBackendType::IO_URING ?
+				"scheduler, io_uring" : "scheduler, thread pool";
+
+			report(reader, MeasureNanosecondsPerItem(fileSet.fileCount, [&]() {
+				KeepValue(ReadAll(scheduler, files, false));
+			}, 3));
+		}
+	}
+}
@@ -0,0 +1,246 @@
+#include "Test/Test.h"
+
+#include "Memory/DeferredReleaseQueue.h"
+
+#include <memory>
+#include <random>
+#include <utility>
+
+using namespace dxe;
+
+// Completed values are simulated: each timeline stands for a queue whose fence the test advances.
+
+namespace
+{
+	struct Timelines
+	{
+		uint64_t completedValues[3]{};
+
+		uint32_t destroyedCount{ 0 };
+		// Objects destroyed before their value completed.
+		uint32_t earlyCount{ 0 };
+	};
+
+	// Checks on destruction that its timeline reached its value; moved-from instances don't count.
+	class TrackedObject
+	{
+	public:
+
+		TrackedObject(Timelines* timelines, uint32_t timeline, uint64_t fenceValue)
+			: timelines(timelines), timeline(timeline), fenceValue(fenceValue) {}
+		TrackedObject(TrackedObject&& other) noexcept
+			: timelines(std::exchange(other.timelines, nullptr)), timeline(other.timeline), fenceValue(other.fenceValue) {}
+		~TrackedObject()
+		{
+			if (!timelines)
+				return;
+
+			timelines->destroyedCount++;
+			if (timelines->completedValues[timeline] < fenceValue)
+				timelines->earlyCount++;
+		}
+
+		CLASS_NO_COPY(TrackedObject);
+		TrackedObject& operator=(TrackedObject&&) = delete;
+
+	private:
+
+		Timelines* timelines{ nullptr };
+		uint32_t timeline{ 0 };
+		uint64_t fenceValue{ 0 };
+	};
+
+	// Defers another object from its destructor, like a mesh releasing its buffers.
+	class ReentrantObject
+	{
+	public:
+
+		ReentrantObject(DeferredReleaseQueue* queue, std::shared_ptr<int> child, uint32_t timeline, uint64_t fenceValue)
+			: queue(queue), child(std::move(child)), timeline(timeline), fenceValue(fenceValue) {}
+		ReentrantObject(ReentrantObject&& other) noexcept
+			: queue(std::exchange(other.queue, nullptr)), child(std::move(other.child)), timeline(other.timeline), fenceValue(other.fenceValue) {}
+		~ReentrantObject()
+		{
+			if (queue)
+				queue->Release(std::move(child), timeline, fenceValue);
+		}
+
+		CLASS_NO_COPY(ReentrantObject);
+		ReentrantObject& operator=(ReentrantObject&&) = delete;
+
+	private:
+
+		DeferredReleaseQueue* queue{ nullptr };
+		std::shared_ptr<int> child;
+		uint32_t timeline{ 0 };
+		uint64_t fenceValue{ 0 };
+	};
+}
+
+TEST_CASE(DeferredReleaseQueueWaitsForValues)
+{
+	DeferredReleaseQueue queue{ 2 };
+
+	auto mesh = std::make_shared<int>(1);
+	std::weak_ptr<int> meshReference = mesh;
+	queue.Release(std::move(mesh), 0, 5);
+
+	// Copies keep the caller's reference, the queue holds its own.
+	auto texture = std::make_shared<int>(2);
+	std::weak_ptr<int> textureReference = texture;
+	queue.Release(texture, 1, 3);
+	texture.reset();
+
+	TEST_CHECK(queue.Retire(0, 4) == 0 && !meshReference.expired());
+	TEST_CHECK(queue.Retire(0, 3) == 0);
+
+	// Timelines are independent.
+	TEST_CHECK(queue.Retire(1, 3) == 1 && textureReference.expired());
+	TEST_CHECK(!meshReference.expired());
+
+	TEST_CHECK(queue.Retire(0, 5) == 1 && meshReference.expired());
+	TEST_CHECK(queue.GetPendingCount() == 0);
+
+	DeferredReleaseStatistics statistics = queue.GetStatistics();
+	TEST_CHECK(statistics.deferredCount == 2 && statistics.releasedCount == 2 && statistics.pendingCount == 0);
+
+	TEST_CHECK_THROWS(DeferredReleaseQueue{ 0 }, Error);
+}
+
+// A smaller value after a larger one waits for the larger one, so each timeline stays a FIFO.
+TEST_CASE(DeferredReleaseQueueRaisesLowerValues)
+{
+	Timelines timelines{};
+	DeferredReleaseQueue queue{ 1 };
+
+	queue.Release(TrackedObject{ &timelines, 0, 10 }, 0, 10);
+	queue.Release(TrackedObject{ &timelines, 0, 10 }, 0, 4);
+	queue.Release(TrackedObject{ &timelines, 0, 12 }, 0, 12);
+
+	timelines.completedValues[0] = 9;
+	TEST_CHECK(queue.Retire(0, 9) == 0);
+
+	timelines.completedValues[0] = 11;
+	TEST_CHECK(queue.Retire(0, 11) == 2 && queue.GetPendingCount() == 1);
+
+	timelines.completedValues[0] = 12;
+	TEST_CHECK(queue.Retire(0, 12) == 1);
+	TEST_CHECK(timelines.destroyedCount == 3 && timelines.earlyCount == 0);
+}
+
+TEST_CASE(DeferredReleaseQueueReentrantRelease)
+{
+	DeferredReleaseQueue queue{ 2 };
+
+	// A child deferred on the same timeline with a completed value goes in the same Retire, one with
+	// a later value waits for it.
+	auto child = std::make_shared<int>(1);
+	std::weak_ptr<int> childReference = child;
+	queue.Release(ReentrantObject{ &queue, std::move(child), 0, 2 }, 0, 1);
+	TEST_CHECK(queue.Retire(0, 2) == 2 && childReference.expired());
+
+	child = std::make_shared<int>(2);
+	childReference = child;
+	queue.Release(ReentrantObject{ &queue, std::move(child), 0, 7 }, 0, 1);
+	TEST_CHECK(queue.Retire(0, 2) == 1 && !childReference.expired());
+	TEST_CHECK(queue.Retire(0, 7) == 1 && childReference.expired());
+
+	// ReleaseAll drains what destructors defer, on any timeline, including the destructor.
+	child = std::make_shared<int>(3);
+	childReference = child;
+	queue.Release(ReentrantObject{ &queue, std::move(child), 0, 100 }, 1, 50);
+	TEST_CHECK(queue.ReleaseAll() == 2 && childReference.expired());
+	TEST_CHECK(queue.GetPendingCount() == 0);
+
+	child = std::make_shared<int>(4);
+	childReference = child;
+	{
+		DeferredReleaseQueue scopedQueue{ 1 };
+		scopedQueue.Release(ReentrantObject{ &scopedQueue, std::move(child), 0, 9 }, 0, 8);
+	}
+	TEST_CHECK(childReference.expired());
+}
+
+// Random values on three timelines whose fences complete late and unevenly: nothing is destroyed
+// before its value, everything once it completed.
+TEST_CASE(DeferredReleaseQueueRandomTimelines)
+{
+	Timelines timelines{};
+	DeferredReleaseQueue queue{ 3 };
+	std::mt19937 random{ 1 };
+
+	uint64_t signaledValues[3]{};
+	uint64_t lastValues[3]{};
+	uint32_t deferredCount{ 0 };
+
+	for (uint32_t frame = 0; frame < 20000; frame++)
+	{
+		for (uint32_t i = random() % 6; i > 0; i--)
+		{
+			// The next value of the timeline, sometimes an older one.
+			uint32_t timeline = random() % 3;
+			uint64_t fenceValue = signaledValues[timeline] + 1;
+			if (random() % 4 == 0 && fenceValue > 3)
+				fenceValue -= 2;
+
+			// What the object actually waits for.
+			lastValues[timeline] = std::max(lastValues[timeline], fenceValue);
+			queue.Release(TrackedObject{ &timelines, timeline, lastValues[timeline] }, timeline, fenceValue);
+			deferredCount++;
+		}
+
+		for (uint32_t timeline = 0; timeline < 3; timeline++)
+		{
+			if (random() % 2 == 0)
+				signaledValues[timeline]++;
+
+			uint64_t& completedValue = timelines.completedValues[timeline];
+			if (completedValue < signaledValues[timeline] && random() % 3 == 0)
+				completedValue += 1 + random() % (signaledValues[timeline] - completedValue);
+
+			queue.Retire(timeline, completedValue);
+		}
+	}
+
+	TEST_CHECK(timelines.earlyCount == 0);
+
+	for (uint32_t timeline = 0; timeline < 3; timeline++)
+	{
+		timelines.completedValues[timeline] = lastValues[timeline];
+		queue.Retire(timeline, lastValues[timeline]);
+	}
+
+	TEST_CHECK(timelines.earlyCount == 0 && timelines.destroyedCount == deferredCount);
+	TEST_CHECK(queue.GetStatistics().deferredCount == deferredCount && queue.GetStatistics().releasedCount == deferredCount);
+}
+
+// A frame with nothing to free stops at the first pending object, however many there are.
+BENCHMARK_CASE(DeferredReleaseQueueRetire)
+{
+	for (uint32_t pendingCount : { 1000u, 1000000u })
+	{
+		DeferredReleaseQueue queue{ 1 };
+		for (uint32_t i = 0; i < pendingCount; i++)
+			queue.Release(std::make_unique<uint32_t>(i), 0, 1000 + i);
+
+		const uint32_t retireCount = 1000000;
+		double nanoseconds = MeasureNanosecondsPerItem(retireCount, [&]() {
+			size_t releasedCount{ 0 };
+			for (uint32_t i = 0; i < retireCount; i++)
+				releasedCount += queue.Retire(0, 999);
+			KeepValue(releasedCount);
+		});
+
+		ReportMetric("Empty Retire, " + std::to_string(pendingCount) + " pending", nanoseconds, "ns");
+	}
+
+	const uint32_t objectCount = 1000000;
+	DeferredReleaseQueue queue{ 1 };
+	double nanoseconds = MeasureNanosecondsPerItem(objectCount, [&]() {
+		for (uint32_t i = 0; i < objectCount; i++)
+			queue.Release(std::make_unique<uint32_t>(i), 0, i);
+		KeepValue(queue.Retire(0, UINT64_MAX));
+	});
+
+	ReportMetric("Release and bulk Retire", nanoseconds, "ns/object");
+}
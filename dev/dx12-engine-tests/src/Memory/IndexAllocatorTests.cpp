@@ -0,0 +1,146 @@
+#include "Test/Test.h"
+
+#include "Memory/IndexAllocator.h"
+
+#include <random>
+#include <set>
+
+using namespace dxe;
+
+TEST_CASE(IndexAllocatorHandsOutEveryIndex)
+{
+	IndexAllocator allocator{ 8 };
+
+	std::set<uint32_t> indices;
+	for (uint32_t i = 0; i < 8; i++)
+		indices.insert(allocator.Allocate());
+
+	TEST_CHECK(indices.size() == 8 && *indices.begin() == 0 && *indices.rbegin() == 7);
+	TEST_CHECK(allocator.Allocate() == INDEX_INVALID);
+	TEST_CHECK(allocator.IsAllocated(7) && !allocator.IsAllocated(8));
+
+	allocator.Reset();
+	TEST_CHECK(allocator.GetUsedCount() == 0 && !allocator.IsAllocated(0));
+	TEST_CHECK(allocator.Allocate() == 0 && allocator.GetUsedCount() == 1);
+}
+
+TEST_CASE(IndexAllocatorRejectsInvalidCapacity)
+{
+	TEST_CHECK_THROWS(IndexAllocator{ 0 }, Error);
+	TEST_CHECK_THROWS(IndexAllocator{ INDEX_INVALID }, Error);
+}
+
+TEST_CASE(IndexAllocatorReusesIndicesAfterTheirFence)
+{
+	IndexAllocator allocator{ 8 };
+	for (uint32_t i = 0; i < 8; i++)
+		allocator.Allocate();
+
+	allocator.Free(3, 10);
+	allocator.Free(5, 5);
+	TEST_CHECK(!allocator.IsAllocated(3) && !allocator.IsAllocated(5));
+
+	// Still used until their fence values complete.
+	TEST_CHECK(allocator.GetUsedCount() == 8 && allocator.GetStatistics().pendingFreeCount == 2);
+	TEST_CHECK(allocator.Allocate() == INDEX_INVALID);
+
+	// 5 was freed after 3, so its fence value was raised to 10.
+	allocator.Retire(9);
+	TEST_CHECK(allocator.Allocate() == INDEX_INVALID);
+
+	allocator.Retire(10);
+	TEST_CHECK(allocator.GetUsedCount() == 6);
+
+	std::set<uint32_t> reused{ allocator.Allocate(), allocator.Allocate() };
+	TEST_CHECK(reused == std::set<uint32_t>({ 3, 5 }));
+
+	IndexStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.usedCount == 8 && statistics.peakUsedCount == 8);
+	TEST_CHECK(statistics.allocationCount == 10 && statistics.pendingFreeCount == 0);
+}
+
+// Frames that allocate and free random indices, with the GPU a few frames behind: an index must never
+// come back while a frame that could still use it is in flight, and none may be handed out twice.
+TEST_CASE(IndexAllocatorRandomFrames)
+{
+	constexpr uint32_t capacity = 4096;
+	constexpr uint64_t framesInFlight = 3;
+
+	IndexAllocator allocator{ capacity };
+	std::mt19937 random{ 3 };
+
+	// Fence value up to which an index may still be used, UINT64_MAX while it's allocated.
+	std::vector<uint64_t> usedUntil(capacity, 0);
+	std::vector<uint32_t> liveIndices;
+	uint64_t fenceValue{ 0 };
+	uint64_t completedFenceValue{ 0 };
+
+	for (uint32_t i = 0; i < 300000; i++)
+	{
+		if (i % 50 == 0)
+		{
+			fenceValue++;
+			if (fenceValue > framesInFlight)
+				completedFenceValue = fenceValue - framesInFlight;
+			allocator.Retire(completedFenceValue);
+		}
+
+		if (liveIndices.empty() || random() % 2 == 0)
+		{
+			uint32_t index = allocator.Allocate();
+			if (index == INDEX_INVALID)
+				continue;
+
+			TEST_CHECK(usedUntil[index] <= completedFenceValue);
+			usedUntil[index] = UINT64_MAX;
+			liveIndices.push_back(index);
+		}
+		else
+		{
+			size_t liveIndex = random() % liveIndices.size();
+			uint32_t index = liveIndices[liveIndex];
+
+			allocator.Free(index, fenceValue + 1);
+			usedUntil[index] = fenceValue + 1;
+
+			liveIndices[liveIndex] = liveIndices.back();
+			liveIndices.pop_back();
+		}
+	}
+
+	TEST_CHECK(allocator.GetStatistics().pendingFreeCount + liveIndices.size() == allocator.GetUsedCount());
+}
+
+// Steady state of a bindless table: every index is freed and replaced, retired two frames later.
+BENCHMARK_CASE(IndexAllocatorFreeAllocate)
+{
+	constexpr uint32_t liveCount = 32768;
+	constexpr uint32_t operationCount = 1 << 22;
+
+	IndexAllocator allocator{ 65536 };
+	std::vector<uint32_t> indices(liveCount);
+	for (uint32_t& index : indices)
+		index = allocator.Allocate();
+
+	uint64_t fenceValue{ 0 };
+	ReportMetric("Free + Allocate", MeasureNanosecondsPerItem(operationCount, [&]() {
+		for (uint32_t i = 0; i < operationCount; i++)
+		{
+			uint32_t& index = indices[i % liveCount];
+			allocator.Free(index, fenceValue + 1);
+
+			if (i % 1024 == 1023)
+			{
+				fenceValue++;
+				allocator.Retire(fenceValue > 2 ? fenceValue - 2 : 0);
+			}
+
+			index = allocator.Allocate();
+			if (index == INDEX_INVALID)
+			{
+				allocator.Retire(fenceValue + 1);
+				index = allocator.Allocate();
+			}
+		}
+	}), "ns/op");
+}
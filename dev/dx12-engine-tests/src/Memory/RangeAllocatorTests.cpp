@@ -0,0 +1,369 @@
+#include "Test/Test.h"
+
+#include "Memory/RangeAllocator.h"
+
+#include <cmath>
+#include <random>
+
+using namespace dxe;
+
+namespace
+{
+	struct LiveRange
+	{
+		uint32_t handle{ RANGE_INVALID_HANDLE };
+		uint64_t size{ 0 };
+		// Written to every element of the range in 'memory', to follow it through moves.
+		uint32_t tag{ 0 };
+	};
+
+	// Allocations must not overlap, hold their tags and add up to the used size.
+	void CheckRanges(const RangeAllocator& allocator, const std::vector<LiveRange>& liveRanges, const std::vector<uint32_t>& memory)
+	{
+		std::vector<std::pair<uint64_t, uint64_t>> ranges;
+		uint64_t usedSize{ 0 };
+
+		for (const LiveRange& liveRange : liveRanges)
+		{
+			uint64_t offset = allocator.GetOffset(liveRange.handle);
+			TEST_CHECK(allocator.GetSize(liveRange.handle) == liveRange.size);
+
+			for (uint64_t i = 0; i < liveRange.size; i++)
+				TEST_CHECK(memory[offset + i] == liveRange.tag);
+
+			ranges.emplace_back(offset, liveRange.size);
+			usedSize += liveRange.size;
+		}
+
+		std::sort(ranges.begin(), ranges.end());
+		for (size_t i = 1; i < ranges.size(); i++)
+			TEST_CHECK(ranges[i - 1].first + ranges[i - 1].second <= ranges[i].first);
+
+		RangeStatistics statistics = allocator.GetStatistics();
+		TEST_CHECK(statistics.usedSize == usedSize);
+		TEST_CHECK(statistics.usedSize + statistics.freeSize == statistics.capacity);
+		TEST_CHECK(statistics.allocationCount == liveRanges.size());
+	}
+
+	void FillRange(const RangeAllocator& allocator, const LiveRange& liveRange, std::vector<uint32_t>& memory)
+	{
+		uint64_t offset = allocator.GetOffset(liveRange.handle);
+		std::fill(memory.begin() + offset, memory.begin() + offset + liveRange.size, liveRange.tag);
+	}
+
+	// Random allocations and frees up to about 80% of the capacity.
+	void Churn(RangeAllocator& allocator, std::vector<LiveRange>& liveRanges, std::mt19937& random, uint32_t operationCount)
+	{
+		const uint64_t capacity = allocator.GetCapacity();
+
+		for (uint32_t i = 0; i < operationCount; i++)
+		{
+			bool allocate = liveRanges.empty() || (allocator.GetUsedSize() < capacity * 4 / 5 && random() % 2 == 0);
+			if (allocate)
+			{
+				uint64_t size = 1 + random() % 2000;
+				uint32_t handle = allocator.Allocate(size);
+				if (handle != RANGE_INVALID_HANDLE)
+					liveRanges.push_back(LiveRange{ handle, size, 0 });
+			}
+			else
+			{
+				size_t index = random() % liveRanges.size();
+				allocator.Free(liveRanges[index].handle);
+				liveRanges[index] = liveRanges.back();
+				liveRanges.pop_back();
+			}
+		}
+	}
+}
+
+TEST_CASE(RangeAllocatorBestFit)
+{
+	RangeAllocator allocator{ 100 };
+
+	uint32_t a = allocator.Allocate(10);
+	uint32_t b = allocator.Allocate(30);
+	uint32_t c = allocator.Allocate(5);
+	uint32_t d = allocator.Allocate(20);
+	TEST_CHECK(allocator.GetOffset(a) == 0 && allocator.GetOffset(b) == 10);
+	TEST_CHECK(allocator.GetOffset(c) == 40 && allocator.GetOffset(d) == 45);
+
+	// Free ranges of 10 at 0, 5 at 40 and 35 at 65: the smallest one that fits wins.
+	allocator.Free(a);
+	allocator.Free(c);
+
+	uint32_t e = allocator.Allocate(4);
+	TEST_CHECK(allocator.GetOffset(e) == 40);
+	uint32_t f = allocator.Allocate(8);
+	TEST_CHECK(allocator.GetOffset(f) == 0);
+	uint32_t g = allocator.Allocate(12);
+	TEST_CHECK(allocator.GetOffset(g) == 65);
+
+	TEST_CHECK(allocator.Allocate(24) == RANGE_INVALID_HANDLE);
+	TEST_CHECK(allocator.Allocate(23) != RANGE_INVALID_HANDLE);
+}
+
+TEST_CASE(RangeAllocatorMergesFreeRanges)
+{
+	RangeAllocator allocator{ 64 };
+
+	uint32_t handles[4]{};
+	for (uint32_t& handle : handles)
+		handle = allocator.Allocate(16);
+
+	TEST_CHECK(allocator.Allocate(1) == RANGE_INVALID_HANDLE);
+	TEST_CHECK(allocator.GetStatistics().freeRangeCount == 0);
+
+	// Neighbours on the right, on the left, then on both sides.
+	allocator.Free(handles[1]);
+	allocator.Free(handles[0]);
+	TEST_CHECK(allocator.GetStatistics().freeRangeCount == 1);
+	TEST_CHECK(allocator.GetStatistics().largestFreeRange == 32);
+
+	allocator.Free(handles[3]);
+	TEST_CHECK(allocator.GetStatistics().freeRangeCount == 2);
+	// 1 - 32 / 48
+	TEST_CHECK(std::abs(allocator.GetStatistics().fragmentation - 1.0f / 3.0f) < 1e-6f);
+
+	allocator.Free(handles[2]);
+	RangeStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.freeRangeCount == 1 && statistics.largestFreeRange == 64);
+	TEST_CHECK(statistics.usedSize == 0 && statistics.allocationCount == 0);
+	TEST_CHECK(statistics.fragmentation == 0.0f);
+}
+
+// Progressive meshes grow their ranges when a LOD is appended and split off the tail when it's evicted.
+TEST_CASE(RangeAllocatorGrowsAndSplits)
+{
+	RangeAllocator allocator{ 64 };
+
+	uint32_t first = allocator.Allocate(16);
+	uint32_t second = allocator.Allocate(16);
+
+	// Only the free range right after an allocation can be taken.
+	TEST_CHECK(!allocator.Grow(first, 1));
+	TEST_CHECK(allocator.Grow(second, 24));
+	TEST_CHECK(allocator.GetOffset(second) == 16 && allocator.GetSize(second) == 40);
+	TEST_CHECK(!allocator.Grow(second, 9));
+	TEST_CHECK(allocator.Grow(second, 8));
+	TEST_CHECK(allocator.GetStatistics().usedSize == 64 && allocator.GetStatistics().freeRangeCount == 0);
+
+	// The tail stays allocated until it's freed.
+	uint32_t tail = allocator.Split(second, 10);
+	TEST_CHECK(allocator.GetSize(second) == 10);
+	TEST_CHECK(allocator.GetOffset(tail) == 26 && allocator.GetSize(tail) == 38);
+	RangeStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.usedSize == 64 && statistics.allocationCount == 3);
+
+	allocator.Free(tail);
+	statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.usedSize == 26 && statistics.allocationCount == 2);
+	TEST_CHECK(statistics.largestFreeRange == 38);
+
+	// Freed tails merge with the free range after them.
+	allocator.Free(allocator.Split(first, 4));
+	TEST_CHECK(allocator.GetStatistics().freeRangeCount == 2);
+	TEST_CHECK(allocator.Grow(first, 12));
+	TEST_CHECK(allocator.GetStatistics().freeRangeCount == 1);
+}
+
+TEST_CASE(RangeAllocatorRejectsEmptyCapacity)
+{
+	TEST_CHECK_THROWS(RangeAllocator{ 0 }, Error);
+}
+
+TEST_CASE(RangeAllocatorPlansMovesIntoFreeRanges)
+{
+	RangeAllocator allocator{ 100 };
+
+	uint32_t a = allocator.Allocate(10);
+	uint32_t b = allocator.Allocate(20);
+	uint32_t c = allocator.Allocate(5);
+	uint32_t d = allocator.Allocate(8);
+	allocator.Free(a);
+
+	// The last allocation moves first, to the lowest free range it fits in. The 2 elements left at
+	// the start are too small for c and allocations never move to higher offsets.
+	std::vector<RangeMove> moves = allocator.PlanDefragmentation();
+	TEST_CHECK(moves.size() == 1);
+	TEST_CHECK(moves[0].handle == d && moves[0].sourceOffset == 35 && moves[0].destinationOffset == 0 && moves[0].size == 8);
+
+	// Planning doesn't change anything.
+	TEST_CHECK(allocator.GetOffset(d) == 35);
+
+	allocator.ApplyMoves(moves);
+	TEST_CHECK(allocator.GetOffset(d) == 0 && allocator.GetOffset(b) == 10 && allocator.GetOffset(c) == 30);
+	TEST_CHECK(allocator.GetStatistics().usedSize == 33);
+	TEST_CHECK(allocator.GetStatistics().largestFreeRange == 65);
+
+	TEST_CHECK(allocator.PlanDefragmentation().empty());
+}
+
+TEST_CASE(RangeAllocatorPlanRespectsMoveBudget)
+{
+	RangeAllocator allocator{ 1000 };
+
+	std::vector<uint32_t> handles;
+	for (uint32_t i = 0; i < 10; i++)
+		handles.push_back(allocator.Allocate(50));
+	for (uint32_t i = 0; i < 10; i += 2)
+		allocator.Free(handles[i]);
+
+	std::vector<RangeMove> moves = allocator.PlanDefragmentation(120);
+	uint64_t movedSize{ 0 };
+	for (const RangeMove& move : moves)
+		movedSize += move.size;
+
+	TEST_CHECK(moves.size() == 2 && movedSize == 100);
+	TEST_CHECK(allocator.PlanDefragmentation(49).empty());
+}
+
+TEST_CASE(RangeAllocatorDefragmentationKeepsData)
+{
+	const uint64_t capacity = 1 << 20;
+
+	RangeAllocator allocator{ capacity };
+	std::vector<uint32_t> memory(capacity, 0);
+	std::vector<LiveRange> liveRanges;
+	std::mt19937 random{ 7 };
+
+	Churn(allocator, liveRanges, random, 50000);
+
+	uint32_t tag{ 1 };
+	for (LiveRange& liveRange : liveRanges)
+	{
+		liveRange.tag = tag++;
+		FillRange(allocator, liveRange, memory);
+	}
+	CheckRanges(allocator, liveRanges, memory);
+
+	// Free about half, then defragment in passes with a budget until the plan is empty.
+	for (size_t i = 0; i < liveRanges.size();)
+	{
+		if (random() % 2 == 0)
+		{
+			allocator.Free(liveRanges[i].handle);
+			liveRanges[i] = liveRanges.back();
+			liveRanges.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	float fragmentationBefore = allocator.GetStatistics().fragmentation;
+
+	uint32_t passCount{ 0 };
+	for (;; passCount++)
+	{
+		TEST_CHECK(passCount < 100);
+
+		std::vector<RangeMove> moves = allocator.PlanDefragmentation(capacity / 8);
+		if (moves.empty())
+			break;
+
+		// Destinations overlap neither each other nor any allocation, so the copies can run in any order.
+		std::vector<std::pair<uint64_t, uint64_t>> ranges;
+		for (const LiveRange& liveRange : liveRanges)
+			ranges.emplace_back(allocator.GetOffset(liveRange.handle), liveRange.size);
+		for (const RangeMove& move : moves)
+		{
+			TEST_CHECK(move.destinationOffset < move.sourceOffset);
+			ranges.emplace_back(move.destinationOffset, move.size);
+		}
+
+		std::sort(ranges.begin(), ranges.end());
+		for (size_t i = 1; i < ranges.size(); i++)
+			TEST_CHECK(ranges[i - 1].first + ranges[i - 1].second <= ranges[i].first);
+
+		for (const RangeMove& move : moves)
+		{
+			std::copy(
+				memory.begin() + move.sourceOffset, memory.begin() + move.sourceOffset + move.size,
+				memory.begin() + move.destinationOffset);
+		}
+
+		allocator.ApplyMoves(moves);
+		CheckRanges(allocator, liveRanges, memory);
+	}
+
+	TEST_CHECK(passCount > 0);
+	TEST_CHECK(allocator.GetStatistics().fragmentation < fragmentationBefore);
+
+	for (const LiveRange& liveRange : liveRanges)
+		allocator.Free(liveRange.handle);
+
+	RangeStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.freeRangeCount == 1 && statistics.largestFreeRange == capacity);
+}
+
+TEST_CASE(RangeAllocatorKeepsMoveSources)
+{
+	RangeAllocator allocator{ 100 };
+
+	uint32_t a = allocator.Allocate(10);
+	uint32_t b = allocator.Allocate(10);
+	allocator.Free(a);
+
+	std::vector<RangeMove> moves = allocator.PlanDefragmentation();
+	TEST_CHECK(moves.size() == 1 && moves[0].handle == b);
+
+	// The source stays allocated until it's freed and is never moved in the meantime.
+	std::vector<uint32_t> sourceHandles;
+	allocator.ApplyMoves(moves, &sourceHandles);
+
+	TEST_CHECK(sourceHandles.size() == 1);
+	TEST_CHECK(allocator.GetOffset(b) == 0);
+	TEST_CHECK(allocator.GetOffset(sourceHandles[0]) == 10 && allocator.GetSize(sourceHandles[0]) == 10);
+	TEST_CHECK(allocator.GetUsedSize() == 20 && allocator.GetAllocationCount() == 2);
+	TEST_CHECK(allocator.PlanDefragmentation().empty());
+
+	allocator.Free(sourceHandles[0]);
+	TEST_CHECK(allocator.GetUsedSize() == 10);
+	TEST_CHECK(allocator.GetStatistics().freeRangeCount == 1);
+	TEST_CHECK(allocator.GetStatistics().largestFreeRange == 90);
+}
+
+BENCHMARK_CASE(RangeAllocatorChurn)
+{
+	const uint32_t operationCount = 200000;
+
+	for (uint64_t capacity : { 1ull << 16, 1ull << 22 })
+	{
+		double nanoseconds = MeasureNanosecondsPerItem(operationCount, [&]() {
+			RangeAllocator allocator{ capacity };
+			std::vector<LiveRange> liveRanges;
+			std::mt19937 random{ 11 };
+
+			Churn(allocator, liveRanges, random, operationCount);
+			KeepValue(allocator.GetUsedSize());
+		});
+
+		ReportMetric("Allocate/Free, capacity " + std::to_string(capacity), nanoseconds, "ns/op");
+	}
+}
+
+BENCHMARK_CASE(RangeAllocatorDefragmentationPlanning)
+{
+	const uint64_t capacity = 1 << 22;
+
+	RangeAllocator allocator{ capacity };
+	std::vector<LiveRange> liveRanges;
+	std::mt19937 random{ 13 };
+
+	Churn(allocator, liveRanges, random, 400000);
+
+	// Every other allocation freed: lots of small holes to plan moves into.
+	for (size_t i = 0; i < liveRanges.size(); i += 2)
+		allocator.Free(liveRanges[i].handle);
+
+	size_t moveCount = allocator.PlanDefragmentation().size();
+	double nanoseconds = MeasureNanosecondsPerItem(1, [&]() {
+		KeepValue(allocator.PlanDefragmentation().size());
+	});
+
+	ReportMetric("Planned moves", static_cast<double>(moveCount), "");
+	ReportMetric("Full plan", nanoseconds / 1000.0, "us");
+	ReportMetric("Allocations", static_cast<double>(allocator.GetAllocationCount()), "");
+}
@@ -0,0 +1,239 @@
+#include "Test/Test.h"
+
+#include "Memory/RingAllocator.h"
+
+#include <random>
+
+using namespace dxe;
+
+// The GPU is simulated by fence values: batches are submitted with increasing values and retired with
+// the "completed" values a fence would report.
+
+namespace
+{
+	struct LiveSpan
+	{
+		uint64_t offset{ 0 };
+		uint64_t size{ 0 };
+		// 0 while the span's batch is still open.
+		uint64_t fenceValue{ 0 };
+	};
+
+	// A new span must not overlap any span whose fence value hasn't been retired yet.
+	void CheckSpan(const std::vector<LiveSpan>& liveSpans, uint64_t offset, uint64_t size, uint64_t capacity)
+	{
+		TEST_CHECK(offset + size <= capacity);
+
+		for (const LiveSpan& liveSpan : liveSpans)
+			TEST_CHECK(offset + size <= liveSpan.offset || liveSpan.offset + liveSpan.size <= offset);
+	}
+}
+
+TEST_CASE(RingAllocatorWrapsAround)
+{
+	RingAllocator allocator{ 1000 };
+
+	TEST_CHECK(allocator.Allocate(400) == 0);
+	allocator.Submit(1);
+	TEST_CHECK(allocator.Allocate(400) == 400);
+	allocator.Submit(2);
+	allocator.Retire(1);
+
+	// 200 bytes left before the end of the ring, not enough: the allocation starts over at 0 and the
+	// tail is skipped.
+	TEST_CHECK(allocator.Allocate(300) == 0);
+	RingStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.wastedSize == 200);
+	TEST_CHECK(statistics.usedSize == 900 && statistics.openBatchSize == 500);
+	allocator.Submit(3);
+
+	// Only the 100 bytes up to the second batch are free until it's retired.
+	TEST_CHECK(allocator.Allocate(100) == 300);
+	TEST_CHECK(!allocator.CanAllocate(1));
+	allocator.Submit(4);
+
+	// The skipped tail goes with the batch it was skipped for.
+	allocator.Retire(2);
+	TEST_CHECK(allocator.GetUsedSize() == 600);
+	TEST_CHECK(allocator.Allocate(600) == RING_INVALID_OFFSET);
+	TEST_CHECK(allocator.Allocate(400) == 400);
+	allocator.Submit(5);
+
+	allocator.Retire(5);
+	TEST_CHECK(allocator.GetUsedSize() == 0 && !allocator.HasPendingBatches());
+
+	// An empty ring starts over at 0.
+	TEST_CHECK(allocator.Allocate(1000) == 0);
+}
+
+TEST_CASE(RingAllocatorAlignment)
+{
+	RingAllocator allocator{ 4096 };
+
+	TEST_CHECK(allocator.Allocate(3) == 0);
+	TEST_CHECK(allocator.Allocate(8, 256) == 256);
+	TEST_CHECK(allocator.Allocate(1, 512) == 512);
+	TEST_CHECK(allocator.GetStatistics().wastedSize == 253 + 248);
+
+	// Aligned past the end of the ring: starts over at 0, once 0 is free.
+	TEST_CHECK(allocator.Allocate(3000) == 513);
+	TEST_CHECK(allocator.Allocate(16, 1024) == RING_INVALID_OFFSET);
+	allocator.Submit(1);
+	allocator.Retire(1);
+	TEST_CHECK(allocator.Allocate(16, 1024) == 0);
+
+	// Every span of a random run is aligned.
+	std::mt19937 random{ 3 };
+	for (uint32_t i = 0; i < 10000; i++)
+	{
+		uint64_t alignment = 1ull << (random() % 10);
+		uint64_t offset = allocator.Allocate(1 + random() % 300, alignment);
+		if (offset == RING_INVALID_OFFSET)
+		{
+			allocator.Submit(i + 2);
+			allocator.Retire(i + 2);
+			continue;
+		}
+		TEST_CHECK(offset % alignment == 0);
+	}
+}
+
+// Completed values may arrive late, lower than before, or cover only some of the batches.
+TEST_CASE(RingAllocatorRetire)
+{
+	RingAllocator allocator{ 100 };
+
+	allocator.Allocate(10);
+	allocator.Submit(1);
+	allocator.Allocate(20);
+	allocator.Submit(3);
+	allocator.Allocate(30);
+	allocator.Submit(3);
+	allocator.Allocate(5);
+	allocator.Submit(7);
+
+	// Nothing allocated, nothing submitted.
+	allocator.Submit(8);
+	TEST_CHECK(allocator.GetStatistics().pendingBatchCount == 4);
+
+	allocator.Retire(0);
+	TEST_CHECK(allocator.GetUsedSize() == 65);
+
+	// Batches sharing a value go together.
+	allocator.Retire(5);
+	TEST_CHECK(allocator.GetUsedSize() == 5 && allocator.GetOldestPendingFenceValue() == 7);
+
+	allocator.Retire(2);
+	allocator.Retire(6);
+	TEST_CHECK(allocator.GetUsedSize() == 5 && allocator.GetStatistics().pendingBatchCount == 1);
+
+	allocator.Retire(100);
+	TEST_CHECK(allocator.GetUsedSize() == 0 && !allocator.HasPendingBatches());
+
+	// The open batch isn't freed by any value.
+	allocator.Allocate(40);
+	allocator.Retire(1000);
+	TEST_CHECK(allocator.GetUsedSize() == 40 && allocator.GetStatistics().openBatchSize == 40);
+}
+
+TEST_CASE(RingAllocatorFull)
+{
+	RingAllocator allocator{ 256 };
+
+	TEST_CHECK(allocator.Allocate(128) == 0);
+	TEST_CHECK(allocator.Allocate(128) == 128);
+
+	// Full with an open batch: there is nothing to wait for until it's submitted.
+	TEST_CHECK(!allocator.CanAllocate(1) && !allocator.HasPendingBatches());
+	TEST_CHECK(allocator.GetStatistics().stallCount == 0);
+
+	TEST_CHECK(allocator.Allocate(1) == RING_INVALID_OFFSET);
+	TEST_CHECK(allocator.GetStatistics().stallCount == 1);
+
+	allocator.Submit(10);
+	TEST_CHECK(allocator.HasPendingBatches() && allocator.GetOldestPendingFenceValue() == 10);
+	TEST_CHECK(!allocator.CanAllocate(1));
+
+	allocator.Retire(9);
+	TEST_CHECK(!allocator.CanAllocate(1));
+	allocator.Retire(10);
+	TEST_CHECK(allocator.CanAllocate(256) && !allocator.CanAllocate(257));
+	TEST_CHECK(allocator.Allocate(257) == RING_INVALID_OFFSET);
+
+	allocator.Allocate(8);
+	allocator.Reset();
+	TEST_CHECK(allocator.GetUsedSize() == 0 && allocator.CanAllocate(256));
+
+	TEST_CHECK_THROWS(RingAllocator{ 0 }, Error);
+}
+
+// Frames of random uploads on a simulated GPU that completes fence values late and unevenly: no span
+// may be handed out again before the value of its batch completed.
+TEST_CASE(RingAllocatorRandomReplay)
+{
+	const uint64_t capacity = 64 * 1024;
+
+	RingAllocator allocator{ capacity };
+	std::vector<LiveSpan> liveSpans;
+	std::mt19937 random{ 9 };
+
+	uint64_t submittedValue{ 0 };
+	uint64_t completedValue{ 0 };
+	uint32_t stallCount{ 0 };
+
+	for (uint32_t frame = 0; frame < 20000; frame++)
+	{
+		uint32_t allocationCount = random() % 8;
+		for (uint32_t i = 0; i < allocationCount; i++)
+		{
+			uint64_t maxSize = random() % 4 == 0 ? 16384 : 1024;
+			uint64_t size = 1 + random() % maxSize;
+			uint64_t alignment = 1ull << (random() % 10);
+
+			bool canAllocate = allocator.CanAllocate(size, alignment);
+			uint64_t offset = allocator.Allocate(size, alignment);
+			TEST_CHECK(canAllocate == (offset != RING_INVALID_OFFSET));
+			if (offset == RING_INVALID_OFFSET)
+			{
+				stallCount++;
+				break;
+			}
+
+			TEST_CHECK(offset % alignment == 0);
+			CheckSpan(liveSpans, offset, size, capacity);
+			liveSpans.push_back(LiveSpan{ offset, size, 0 });
+		}
+
+		// Some frames submit twice with the same value.
+		if (random() % 4 != 0)
+			submittedValue++;
+		allocator.Submit(submittedValue);
+		for (LiveSpan& liveSpan : liveSpans)
+		{
+			if (liveSpan.fenceValue == 0)
+				liveSpan.fenceValue = submittedValue;
+		}
+
+		// The GPU runs up to a few frames behind and its completed value is sometimes read stale.
+		if (completedValue < submittedValue && random() % 3 != 0)
+			completedValue += 1 + random() % (submittedValue - completedValue);
+		uint64_t reportedValue = random() % 5 == 0 ? completedValue - std::min<uint64_t>(completedValue, random() % 4) : completedValue;
+
+		allocator.Retire(reportedValue);
+		liveSpans.erase(
+			std::remove_if(liveSpans.begin(), liveSpans.end(), [&](const LiveSpan& liveSpan) {
+				return liveSpan.fenceValue <= reportedValue;
+			}),
+			liveSpans.end());
+
+		RingStatistics statistics = allocator.GetStatistics();
+		TEST_CHECK(statistics.usedSize <= capacity && statistics.openBatchSize == 0);
+		TEST_CHECK(allocator.HasPendingBatches() == !liveSpans.empty());
+	}
+
+	TEST_CHECK(stallCount > 0);
+	TEST_CHECK(allocator.GetStatistics().stallCount == stallCount);
+
+	allocator.Retire(submittedValue);
+	TEST_CHECK(allocator.GetUsedSize() == 0 && !allocator.HasPendingBatches());
+}
@@ -0,0 +1,319 @@
+#include "Test/Test.h"
+
+#include "Memory/TlsfAllocator.h"
+
+#include <cmath>
+#include <map>
+#include <random>
+
+using namespace dxe;
+
+namespace
+{
+	constexpr uint64_t KB = 1024;
+	constexpr uint64_t MB = 1024 * KB;
+
+	// Placed resource alignments of D3D12: 64 KB by default, 4 KB for small resources.
+	constexpr uint64_t DEFAULT_ALIGNMENT = 64 * KB;
+	constexpr uint64_t SMALL_ALIGNMENT = 4 * KB;
+
+	// The allocations by offset; the allocator merges free neighbours right away, so its free blocks
+	// are exactly the gaps between them.
+	class ReferenceModel
+	{
+	public:
+
+		explicit ReferenceModel(uint64_t capacity)
+			: capacity(capacity) {}
+
+		void Add(const TlsfAllocation& allocation)
+		{
+			auto next = allocations.lower_bound(allocation.offset);
+			TEST_CHECK(next == allocations.end() || allocation.offset + allocation.size <= next->first);
+			if (next != allocations.begin())
+			{
+				auto previous = std::prev(next);
+				TEST_CHECK(previous->first + previous->second <= allocation.offset);
+			}
+			TEST_CHECK(allocation.offset + allocation.size <= capacity);
+
+			allocations[allocation.offset] = allocation.size;
+		}
+		void Remove(const TlsfAllocation& allocation)
+		{
+			TEST_CHECK(allocations.erase(allocation.offset) == 1);
+		}
+
+		void Check(const TlsfAllocator& allocator) const
+		{
+			uint64_t usedBytes{ 0 };
+			uint64_t largestGap{ 0 };
+			uint32_t gapCount{ 0 };
+			uint64_t end{ 0 };
+
+			auto addGap = [&](uint64_t gap) {
+				if (gap == 0)
+					return;
+				gapCount++;
+				largestGap = std::max(largestGap, gap);
+			};
+
+			for (const auto& [offset, size] : allocations)
+			{
+				addGap(offset - end);
+				usedBytes += size;
+				end = offset + size;
+			}
+			addGap(capacity - end);
+
+			TlsfStatistics statistics = allocator.GetStatistics();
+			TEST_CHECK(statistics.usedBytes == usedBytes && statistics.freeBytes == capacity - usedBytes);
+			TEST_CHECK(statistics.allocationCount == allocations.size());
+			TEST_CHECK(statistics.freeBlockCount == gapCount);
+			TEST_CHECK(statistics.largestFreeBlock == largestGap);
+
+			float fragmentation = usedBytes < capacity ? 1.0f - static_cast<float>(static_cast<double>(largestGap) / (capacity - usedBytes)) : 0.0f;
+			TEST_CHECK(std::abs(statistics.fragmentation - fragmentation) < 1e-6f);
+		}
+
+	private:
+
+		uint64_t capacity{ 0 };
+		std::map<uint64_t, uint64_t> allocations;
+	};
+
+	// Good fit searches the first size class whose blocks all fit the request; there are 32 classes per
+	// power of two.
+	uint64_t RoundUpToSizeClass(uint64_t size)
+	{
+		uint64_t classSize{ 1 };
+		while (classSize * 64 <= size)
+			classSize *= 2;
+		return (size + classSize - 1) / classSize * classSize;
+	}
+
+	// Mostly small resources, some buffers and textures of a few MB, rarely a large render target.
+	void GetRandomRequest(std::mt19937& random, uint64_t& size, uint64_t& alignment)
+	{
+		uint32_t kind = random() % 10;
+		if (kind < 5)
+			size = 1 + random() % (64 * KB);
+		else if (kind < 9)
+			size = 1 + random() % (4 * MB);
+		else
+			size = 1 + random() % (32 * MB);
+
+		alignment = size <= 64 * KB && random() % 2 == 0 ? SMALL_ALIGNMENT : DEFAULT_ALIGNMENT;
+		if (random() % 8 == 0)
+			alignment = 1ull << (random() % 9);
+	}
+}
+
+TEST_CASE(TlsfAllocatorPlacedResourceAlignment)
+{
+	TlsfAllocator allocator{ 4 * MB };
+
+	TlsfAllocation constants = allocator.Allocate(256, 256);
+	TlsfAllocation texture = allocator.Allocate(100 * KB, DEFAULT_ALIGNMENT);
+	TEST_CHECK(constants.offset == 0 && constants.size == 256);
+	TEST_CHECK(texture.offset == DEFAULT_ALIGNMENT && texture.size == 100 * KB);
+
+	// Small resources fill the padding left in front of the texture.
+	std::vector<TlsfAllocation> smallTextures;
+	for (uint32_t i = 0; i < 15; i++)
+	{
+		TlsfAllocation smallTexture = allocator.Allocate(4 * KB, SMALL_ALIGNMENT);
+		TEST_CHECK(smallTexture.offset == (i + 1) * SMALL_ALIGNMENT);
+		smallTextures.push_back(smallTexture);
+	}
+
+	TlsfAllocation next = allocator.Allocate(64 * KB, DEFAULT_ALIGNMENT);
+	TEST_CHECK(next.offset == 3 * DEFAULT_ALIGNMENT);
+
+	// Any power of two, on top of an odd offset.
+	TlsfAllocator oddAllocator{ 1 * MB };
+	oddAllocator.Allocate(3);
+	for (uint64_t alignment = 1; alignment <= DEFAULT_ALIGNMENT; alignment *= 2)
+	{
+		TlsfAllocation allocation = oddAllocator.Allocate(7, alignment);
+		TEST_CHECK(allocation.IsValid() && allocation.offset % alignment == 0 && allocation.size == 7);
+	}
+}
+
+TEST_CASE(TlsfAllocatorMergesOnFree)
+{
+	TlsfAllocator allocator{ 64 * KB };
+	ReferenceModel model{ 64 * KB };
+
+	TlsfAllocation allocations[4]{};
+	for (TlsfAllocation& allocation : allocations)
+	{
+		allocation = allocator.Allocate(16 * KB);
+		model.Add(allocation);
+	}
+	TEST_CHECK(allocator.GetStatistics().freeBlockCount == 0);
+
+	// Neighbours on the right, on the left, then on both sides.
+	allocator.Free(allocations[1]);
+	allocator.Free(allocations[0]);
+	TEST_CHECK(allocator.GetStatistics().freeBlockCount == 1);
+	TEST_CHECK(allocator.GetStatistics().largestFreeBlock == 32 * KB);
+
+	allocator.Free(allocations[3]);
+	TEST_CHECK(allocator.GetStatistics().freeBlockCount == 2);
+	// 1 - 32 / 48
+	TEST_CHECK(std::abs(allocator.GetStatistics().fragmentation - 1.0f / 3.0f) < 1e-6f);
+
+	allocator.Free(allocations[2]);
+	TlsfStatistics statistics = allocator.GetStatistics();
+	TEST_CHECK(statistics.freeBlockCount == 1 && statistics.largestFreeBlock == 64 * KB);
+	TEST_CHECK(statistics.fragmentation == 0.0f && allocator.IsEmpty());
+
+	// The merged block serves the whole capacity again.
+	TlsfAllocation whole = allocator.Allocate(64 * KB, DEFAULT_ALIGNMENT);
+	TEST_CHECK(whole.offset == 0 && whole.size == 64 * KB);
+}
+
+TEST_CASE(TlsfAllocatorExhaustion)
+{
+	TlsfAllocator allocator{ 64 * MB };
+
+	std::vector<TlsfAllocation> allocations;
+	for (;;)
+	{
+		TlsfAllocation allocation = allocator.Allocate(64 * KB, DEFAULT_ALIGNMENT);
+		if (!allocation.IsValid())
+			break;
+		allocations.push_back(allocation);
+	}
+	TEST_CHECK(allocations.size() == 1024);
+	TEST_CHECK(allocator.GetUsedBytes() == 64 * MB && !allocator.Allocate(1).IsValid());
+
+	// A hole of 64 KB fits 64 KB, but not once it has to be aligned to 128 KB.
+	allocator.Free(allocations[1]);
+	TEST_CHECK(!allocator.Allocate(64 * KB, 128 * KB).IsValid());
+	TEST_CHECK(!allocator.Allocate(64 * KB + 1).IsValid());
+	TEST_CHECK(allocator.Allocate(64 * KB, DEFAULT_ALIGNMENT).offset == 64 * KB);
+
+	TEST_CHECK(!allocator.Allocate(128 * MB).IsValid());
+
+	allocator.Reset();
+	TEST_CHECK(allocator.IsEmpty() && allocator.GetStatistics().largestFreeBlock == 64 * MB);
+
+	TEST_CHECK_THROWS(TlsfAllocator{ 0 }, Error);
+}
+
+// Random allocations and frees against the reference model; the statistics, fragmentation included,
+// have to match it all along.
+TEST_CASE(TlsfAllocatorRandomReplay)
+{
+	const uint64_t capacity = 256 * MB;
+
+	TlsfAllocator allocator{ capacity };
+	ReferenceModel model{ capacity };
+	std::vector<TlsfAllocation> allocations;
+	std::mt19937 random{ 5 };
+
+	uint32_t failedCount{ 0 };
+	float peakFragmentation{ 0.0f };
+
+	for (uint32_t operation = 0; operation < 100000; operation++)
+	{
+		if (allocations.empty() || random() % 100 < 55)
+		{
+			uint64_t size{ 0 };
+			uint64_t alignment{ 0 };
+			GetRandomRequest(random, size, alignment);
+
+			TlsfAllocation allocation = allocator.Allocate(size, alignment);
+			if (!allocation.IsValid())
+			{
+				// Out of memory only when no free block is large enough to search for.
+				TEST_CHECK(allocator.GetStatistics().largestFreeBlock < RoundUpToSizeClass(size + alignment - 1));
+				failedCount++;
+				continue;
+			}
+
+			TEST_CHECK(allocation.offset % alignment == 0 && allocation.size == size);
+			model.Add(allocation);
+			allocations.push_back(allocation);
+		}
+		else
+		{
+			size_t index = random() % allocations.size();
+			allocator.Free(allocations[index]);
+			model.Remove(allocations[index]);
+
+			allocations[index] = allocations.back();
+			allocations.pop_back();
+		}
+
+		if (operation % 97 == 0)
+		{
+			model.Check(allocator);
+			peakFragmentation = std::max(peakFragmentation, allocator.GetStatistics().fragmentation);
+		}
+	}
+
+	TEST_CHECK(failedCount > 0 && peakFragmentation > 0.0f);
+
+	for (const TlsfAllocation& allocation : allocations)
+	{
+		allocator.Free(allocation);
+		model.Remove(allocation);
+	}
+	model.Check(allocator);
+	TEST_CHECK(allocator.GetStatistics().freeBlockCount == 1 && allocator.GetStatistics().fragmentation == 0.0f);
+}
+
+BENCHMARK_CASE(TlsfAllocatorAllocateFree)
+{
+	const uint32_t operationCount = 200000;
+	const uint64_t capacity = 1024 * MB;
+
+	float fragmentation{ 0.0f };
+	double nanoseconds = MeasureNanosecondsPerItem(operationCount, [&]() {
+		TlsfAllocator allocator{ capacity };
+		std::vector<TlsfAllocation> allocations;
+		std::mt19937 random{ 11 };
+
+		for (uint32_t operation = 0; operation < operationCount; operation++)
+		{
+			if (allocations.empty() || (allocator.GetUsedBytes() < capacity * 4 / 5 && random() % 2 == 0))
+			{
+				uint64_t size{ 0 };
+				uint64_t alignment{ 0 };
+				GetRandomRequest(random, size, alignment);
+
+				TlsfAllocation allocation = allocator.Allocate(size, alignment);
+				if (allocation.IsValid())
+					allocations.push_back(allocation);
+			}
+			else
+			{
+				size_t index = random() % allocations.size();
+				allocator.Free(allocations[index]);
+				allocations[index] = allocations.back();
+				allocations.pop_back();
+			}
+		}
+
+		fragmentation = allocator.GetStatistics().fragmentation;
+		KeepValue(allocator.GetUsedBytes());
+	});
+
+	ReportMetric("Allocate/Free, capacity 1 GB", nanoseconds, "ns/op");
+	ReportMetric("Fragmentation after the churn", fragmentation, "");
+
+	// The same pool of 64 KB aligned blocks freed and allocated again: the steady state of a heap.
+	TlsfAllocator allocator{ capacity };
+	std::vector<TlsfAllocation> allocations(4096);
+	double steadyNanoseconds = MeasureNanosecondsPerItem(2 * allocations.size(), [&]() {
+		for (size_t i = 0; i < allocations.size(); i++)
+			allocations[i] = allocator.Allocate((1 + i % 4) * DEFAULT_ALIGNMENT, DEFAULT_ALIGNMENT);
+		for (const TlsfAllocation& allocation : allocations)
+			allocator.Free(allocation);
+	});
+
+	ReportMetric("Allocate/Free, 64 KB aligned", steadyNanoseconds, "ns/op");
+}
@@ -0,0 +1,362 @@
+#include "Test/Test.h"
+
+#include "Renderer/Color.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace dxe;
+
+// The lookup tables and batch kernels are checked against the exact curve computed with pow(), and
+// the SSE body of every batch against its scalar tail by converting the same values both ways.
+
+namespace
+{
+	// Enough values to cover the 8-value half float body, its 4-value sRGB counterpart and any tail.
+	constexpr size_t MAX_TAIL_VALUE_COUNT = 19;
+
+	float ToFloat(uint32_t bits)
+	{
+		float value{ 0.0f };
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// The piecewise curve in double, as a reference for the float one.
+	double GetExactLinear(double srgb)
+	{
+		return srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4);
+	}
+
+	bool IsHalfNan(uint16_t half)
+	{
+		return (half & 0x7c00u) == 0x7c00u && (half & 0x03ffu) != 0;
+	}
+
+	std::vector<float> CreateRandomValues(size_t count, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+		std::uniform_real_distribution<float> distribution{ 0.0f, 1.0f };
+
+		std::vector<float> values(count);
+		for (float& value : values)
+			value = distribution(random);
+		return values;
+	}
+
+	// Converts 'values' once as a whole, so the SSE body runs, and once value by value, so every
+	// value goes through the scalar tail. Channel count 1 keeps every value a color value.
+	template <typename DstType, typename Convert>
+	void ConvertBodyAndTail(const std::vector<float>& values, std::vector<DstType>& body, std::vector<DstType>& tail, Convert&& convert)
+	{
+		body.assign(values.size(), DstType{});
+		tail.assign(values.size(), DstType{});
+
+		convert(values.data(), body.data(), values.size());
+		for (size_t value = 0; value < values.size(); value++)
+			convert(values.data() + value, tail.data() + value, 1);
+	}
+}
+
+TEST_CASE(ColorLookupTablesMatchExactCurve)
+{
+	for (uint32_t value = 0; value < 256; value++)
+	{
+		float exact = SrgbToLinear(static_cast<float>(value) / 255.0f);
+		TEST_CHECK(SrgbUnorm8ToLinear(static_cast<uint8_t>(value)) == exact);
+		TEST_CHECK(std::fabs(exact - GetExactLinear(static_cast<double>(value) / 255.0)) < 1e-6);
+
+		// Encoding a decoded value gives it back.
+		TEST_CHECK(LinearToSrgbUnorm8(exact) == value);
+	}
+
+	// The rounding thresholds pick the same 8-bit value as rounding the exact curve, except right on
+	// a threshold where the float curve itself can't tell.
+	const uint32_t steps = 1 << 16;
+	for (uint32_t step = 0; step <= steps; step++)
+	{
+		float linear = static_cast<float>(step) / static_cast<float>(steps);
+		float srgb = LinearToSrgb(linear) * 255.0f;
+		float rounded = std::floor(srgb + 0.5f);
+
+		if (std::fabs(srgb + 0.5f - rounded) < 1e-3f)
+			continue;
+		TEST_CHECK(LinearToSrgbUnorm8(linear) == static_cast<uint8_t>(rounded));
+	}
+
+	// Out of range values saturate.
+	TEST_CHECK(LinearToSrgbUnorm8(-1.0f) == 0 && LinearToSrgbUnorm8(2.0f) == 255);
+}
+
+TEST_CASE(ColorBatchesMatchExactCurve)
+{
+	std::vector<float> values = CreateRandomValues(4096, 1);
+	values[0] = 0.0f;
+	values[1] = 1.0f;
+	values[2] = 0.04045f;
+	values[3] = 0.0031308f;
+
+	std::vector<float> linear(values.size());
+	std::vector<float> srgb(values.size());
+	ConvertSrgbToLinear(values.data(), linear.data(), values.size(), 1);
+	ConvertLinearToSrgb(values.data(), srgb.data(), values.size(), 1);
+
+	for (size_t value = 0; value < values.size(); value++)
+	{
+		TEST_CHECK(std::fabs(linear[value] - SrgbToLinear(values[value])) < 3e-6f);
+		TEST_CHECK(std::fabs(srgb[value] - LinearToSrgb(values[value])) < 3e-6f);
+	}
+
+	// 8-bit results only move off the lookup tables for inputs right on a rounding boundary.
+	std::vector<uint8_t> srgbUnorm8(values.size());
+	ConvertLinearToSrgbUnorm8(values.data(), srgbUnorm8.data(), values.size(), 1);
+	uint32_t boundaryMismatches{ 0 };
+	for (size_t value = 0; value < values.size(); value++)
+	{
+		int32_t difference = static_cast<int32_t>(srgbUnorm8[value]) - LinearToSrgbUnorm8(values[value]);
+		TEST_CHECK(difference >= -1 && difference <= 1);
+		if (difference != 0)
+			boundaryMismatches++;
+	}
+	TEST_CHECK(boundaryMismatches <= 2);
+
+	std::vector<uint8_t> unorm8(256);
+	std::vector<float> decoded(256);
+	for (uint32_t value = 0; value < 256; value++)
+		unorm8[value] = static_cast<uint8_t>(value);
+	ConvertSrgbUnorm8ToLinear(unorm8.data(), decoded.data(), 256, 1);
+	for (uint32_t value = 0; value < 256; value++)
+		TEST_CHECK(decoded[value] == SrgbUnorm8ToLinear(static_cast<uint8_t>(value)));
+}
+
+// Counts that aren't multiples of the SIMD width leave a tail; it has to give the body's results.
+TEST_CASE(ColorBatchTailsMatchBody)
+{
+	for (size_t count = 1; count <= MAX_TAIL_VALUE_COUNT; count++)
+	{
+		std::vector<float> values = CreateRandomValues(count, static_cast<uint32_t>(count));
+		if (count > 2)
+			values[count - 2] = 0.002f;
+
+		std::vector<float> body;
+		std::vector<float> tail;
+		ConvertBodyAndTail(values, body, tail, [](const float* source, float* destination, size_t valueCount) {
+			ConvertSrgbToLinear(source, destination, valueCount, 1);
+		});
+		TEST_CHECK(body == tail);
+
+		ConvertBodyAndTail(values, body, tail, [](const float* source, float* destination, size_t valueCount) {
+			ConvertLinearToSrgb(source, destination, valueCount, 1);
+		});
+		TEST_CHECK(body == tail);
+
+		std::vector<uint8_t> bodyUnorm8;
+		std::vector<uint8_t> tailUnorm8;
+		ConvertBodyAndTail(values, bodyUnorm8, tailUnorm8, [](const float* source, uint8_t* destination, size_t valueCount) {
+			ConvertLinearToSrgbUnorm8(source, destination, valueCount, 1);
+		});
+		TEST_CHECK(bodyUnorm8 == tailUnorm8);
+
+		ConvertBodyAndTail(values, bodyUnorm8, tailUnorm8, ConvertFloatToUnorm8);
+		TEST_CHECK(bodyUnorm8 == tailUnorm8);
+
+		std::vector<uint16_t> bodyHalf;
+		std::vector<uint16_t> tailHalf;
+		ConvertBodyAndTail(values, bodyHalf, tailHalf, ConvertFloatToHalf);
+		TEST_CHECK(bodyHalf == tailHalf);
+	}
+
+	// Three channel pixels (i.e. vertex colors) straddle the 4-value body.
+	for (size_t pixelCount = 1; pixelCount <= 7; pixelCount++)
+	{
+		std::vector<float> values = CreateRandomValues(pixelCount * 3, 100 + static_cast<uint32_t>(pixelCount));
+		std::vector<float> whole(values.size());
+		std::vector<float> perPixel(values.size());
+
+		ConvertSrgbToLinear(values.data(), whole.data(), pixelCount, 3);
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+			ConvertSrgbToLinear(values.data() + pixel * 3, perPixel.data() + pixel * 3, 1, 3);
+		TEST_CHECK(whole == perPixel);
+	}
+}
+
+TEST_CASE(ColorBatchesLeaveAlphaUnconverted)
+{
+	for (size_t pixelCount = 1; pixelCount <= 5; pixelCount++)
+	{
+		size_t valueCount = pixelCount * 4;
+		std::vector<float> values = CreateRandomValues(valueCount, 200 + static_cast<uint32_t>(pixelCount));
+
+		std::vector<float> linear(valueCount);
+		std::vector<float> srgb(valueCount);
+		std::vector<uint8_t> srgbUnorm8(valueCount);
+		ConvertSrgbToLinear(values.data(), linear.data(), pixelCount, 4);
+		ConvertLinearToSrgb(values.data(), srgb.data(), pixelCount, 4);
+		ConvertLinearToSrgbUnorm8(values.data(), srgbUnorm8.data(), pixelCount, 4);
+
+		std::vector<uint8_t> unorm8(valueCount);
+		for (size_t value = 0; value < valueCount; value++)
+			unorm8[value] = static_cast<uint8_t>(value * 37);
+		std::vector<float> decoded(valueCount);
+		ConvertSrgbUnorm8ToLinear(unorm8.data(), decoded.data(), pixelCount, 4);
+
+		for (size_t value = 0; value < valueCount; value++)
+		{
+			if ((value & 3) == 3)
+			{
+				TEST_CHECK(linear[value] == values[value] && srgb[value] == values[value]);
+				TEST_CHECK(srgbUnorm8[value] == FloatToUnorm8(values[value]));
+				TEST_CHECK(decoded[value] == Unorm8ToFloat(unorm8[value]));
+			}
+			else
+			{
+				TEST_CHECK(std::fabs(linear[value] - SrgbToLinear(values[value])) < 3e-6f);
+				TEST_CHECK(std::fabs(srgb[value] - LinearToSrgb(values[value])) < 3e-6f);
+				TEST_CHECK(decoded[value] == SrgbUnorm8ToLinear(unorm8[value]));
+			}
+		}
+	}
+
+	// Vertex colors have no alpha, all three channels are converted.
+	DirectX::XMFLOAT3 colors[5]{ { 0.5f, 0.25f, 1.0f }, { 0.0f, 0.75f, 0.1f }, { 1.0f, 1.0f, 1.0f }, { 0.2f, 0.3f, 0.4f }, { 0.9f, 0.6f, 0.04f } };
+	DirectX::XMFLOAT3 authored[5];
+	std::memcpy(authored, colors, sizeof(colors));
+
+	ConvertVertexColorsToLinear(colors, 5);
+	for (uint32_t color = 0; color < 5; color++)
+	{
+		TEST_CHECK(std::fabs(colors[color].x - SrgbToLinear(authored[color].x)) < 3e-6f);
+		TEST_CHECK(std::fabs(colors[color].y - SrgbToLinear(authored[color].y)) < 3e-6f);
+		TEST_CHECK(std::fabs(colors[color].z - SrgbToLinear(authored[color].z)) < 3e-6f);
+	}
+}
+
+TEST_CASE(ColorHalfFloatSpecialValues)
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+
+	// Half denormals: 2^-24 is the smallest, 2^-25 rounds to even (zero), 3 * 2^-25 up to 2 * 2^-24.
+	TEST_CHECK(FloatToHalf(std::ldexp(1.0f, -24)) == 0x0001);
+	TEST_CHECK(FloatToHalf(std::ldexp(1.0f, -25)) == 0x0000);
+	TEST_CHECK(FloatToHalf(std::ldexp(3.0f, -25)) == 0x0002);
+	TEST_CHECK(FloatToHalf(std::ldexp(1023.0f, -24)) == 0x03ff);
+	TEST_CHECK(FloatToHalf(-std::ldexp(1.0f, -24)) == 0x8001);
+	TEST_CHECK(HalfToFloat(0x0001) == std::ldexp(1.0f, -24));
+	TEST_CHECK(HalfToFloat(0x03ff) == std::ldexp(1023.0f, -24));
+	TEST_CHECK(HalfToFloat(0x8200) == -std::ldexp(512.0f, -24));
+
+	// Float denormals are far below the smallest half.
+	TEST_CHECK(FloatToHalf(ToFloat(0x00000001u)) == 0x0000);
+	TEST_CHECK(FloatToHalf(-ToFloat(0x007fffffu)) == 0x8000);
+
+	// 65504 is the largest half, from halfway to the next step on it's infinity.
+	TEST_CHECK(FloatToHalf(65504.0f) == 0x7bff);
+	TEST_CHECK(FloatToHalf(65519.0f) == 0x7bff);
+	TEST_CHECK(FloatToHalf(65520.0f) == 0x7c00);
+	TEST_CHECK(FloatToHalf(1e10f) == 0x7c00);
+	TEST_CHECK(FloatToHalf(infinity) == 0x7c00);
+	TEST_CHECK(FloatToHalf(-infinity) == 0xfc00);
+	TEST_CHECK(HalfToFloat(0x7c00) == infinity);
+	TEST_CHECK(HalfToFloat(0xfc00) == -infinity);
+
+	TEST_CHECK(IsHalfNan(FloatToHalf(nan)));
+	TEST_CHECK(IsHalfNan(FloatToHalf(-nan)));
+	TEST_CHECK(IsHalfNan(FloatToHalf(ToFloat(0x7f800001u))));
+	TEST_CHECK(std::isnan(HalfToFloat(0x7e00)) && std::isnan(HalfToFloat(0x7c01)) && std::isnan(HalfToFloat(0xfe00)));
+
+	// Every half that isn't NaN survives the round trip.
+	for (uint32_t half = 0; half <= 0xffffu; half++)
+	{
+		if (IsHalfNan(static_cast<uint16_t>(half)))
+		{
+			TEST_CHECK(std::isnan(HalfToFloat(static_cast<uint16_t>(half))));
+			continue;
+		}
+		TEST_CHECK(FloatToHalf(HalfToFloat(static_cast<uint16_t>(half))) == half);
+	}
+
+	// The SSE body handles the same special values as the scalar conversion.
+	std::vector<float> values{
+		std::ldexp(1.0f, -24), std::ldexp(1.0f, -25), std::ldexp(3.0f, -25), ToFloat(0x00000001u),
+		65504.0f, 65520.0f, infinity, -infinity,
+		nan, -nan, 0.0f, -0.0f,
+		1.0f, -2.5f, std::ldexp(1.0f, -14), 0.1f };
+
+	std::vector<uint16_t> halves(values.size());
+	ConvertFloatToHalf(values.data(), halves.data(), values.size());
+	for (size_t value = 0; value < values.size(); value++)
+	{
+		if (std::isnan(values[value]))
+		{
+			TEST_CHECK(IsHalfNan(halves[value]));
+			continue;
+		}
+		TEST_CHECK(halves[value] == FloatToHalf(values[value]));
+	}
+
+	std::vector<float> floats(halves.size());
+	ConvertHalfToFloat(halves.data(), floats.data(), halves.size());
+	for (size_t value = 0; value < values.size(); value++)
+	{
+		if (std::isnan(values[value]))
+		{
+			TEST_CHECK(std::isnan(floats[value]));
+			continue;
+		}
+		TEST_CHECK(floats[value] == HalfToFloat(halves[value]));
+	}
+}
+
+BENCHMARK_CASE(ColorConversionThroughput)
+{
+	// 16 MB of RGBA floats, well past the caches.
+	const size_t pixelCount = 1024 * 1024;
+	const size_t valueCount = pixelCount * 4;
+	const double byteCount = static_cast<double>(valueCount * sizeof(float));
+
+	std::vector<float> source = CreateRandomValues(valueCount, 7);
+	std::vector<float> destination(valueCount);
+
+	auto reportGigabytesPerSecond = [byteCount](const std::string& label, double nanoseconds) {
+		ReportMetric(label, byteCount / nanoseconds, "GB/s");
+	};
+
+	// The loop a texture importer would write without the batch kernels.
+	reportGigabytesPerSecond("sRGB -> linear, pow() loop", MeasureNanosecondsPerItem(1, [&]() {
+		for (size_t value = 0; value < valueCount; value++)
+		{
+			float srgb = source[value];
+			destination[value] = (value & 3) == 3 ? srgb :
+				(srgb <= 0.04045f ? srgb / 12.92f : std::pow((srgb + 0.055f) / 1.055f, 2.4f));
+		}
+		KeepValue(destination.back());
+	}));
+	reportGigabytesPerSecond("sRGB -> linear, batch", MeasureNanosecondsPerItem(1, [&]() {
+		ConvertSrgbToLinear(source.data(), destination.data(), pixelCount);
+		KeepValue(destination.back());
+	}));
+
+	reportGigabytesPerSecond("linear -> sRGB, pow() loop", MeasureNanosecondsPerItem(1, [&]() {
+		for (size_t value = 0; value < valueCount; value++)
+		{
+			float linear = source[value];
+			destination[value] = (value & 3) == 3 ? linear :
+				(linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow(linear, 1.0f / 2.4f) - 0.055f);
+		}
+		KeepValue(destination.back());
+	}));
+	reportGigabytesPerSecond("linear -> sRGB, batch", MeasureNanosecondsPerItem(1, [&]() {
+		ConvertLinearToSrgb(source.data(), destination.data(), pixelCount);
+		KeepValue(destination.back());
+	}));
+
+	std::vector<uint8_t> unorm8(valueCount);
+	reportGigabytesPerSecond("linear -> sRGB 8-bit, batch", MeasureNanosecondsPerItem(1, [&]() {
+		ConvertLinearToSrgbUnorm8(source.data(), unorm8.data(), pixelCount);
+		KeepValue(unorm8.back());
+	}));
+}
@@ -0,0 +1,210 @@
+#include "Test/Test.h"
+
+#include "Renderer/FramePacer.h"
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+using namespace dxe;
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// A queue on its own thread: runs the submitted frames in order, each for its synthetic GPU time,
+	// then signals the frame's fence value.
+	class SimulatedGpu
+	{
+	public:
+
+		SimulatedGpu()
+		{
+			thread = std::thread(&SimulatedGpu::Run, this);
+		}
+		~SimulatedGpu()
+		{
+			{
+				std::lock_guard lock{ mutex };
+				quit = true;
+			}
+			condition.notify_all();
+			thread.join();
+		}
+
+		CLASS_NO_COPY(SimulatedGpu);
+		CLASS_NO_MOVE(SimulatedGpu);
+
+		void Submit(uint64_t fenceValue, std::chrono::microseconds duration)
+		{
+			{
+				std::lock_guard lock{ mutex };
+				frames.push_back(Frame{ fenceValue, duration });
+			}
+			condition.notify_all();
+		}
+
+		uint64_t GetCompletedValue()
+		{
+			std::lock_guard lock{ mutex };
+			return completedValue;
+		}
+		void WaitForValue(uint64_t fenceValue)
+		{
+			std::unique_lock lock{ mutex };
+			condition.wait(lock, [&]() { return completedValue >= fenceValue; });
+		}
+
+	private:
+
+		struct Frame
+		{
+			uint64_t fenceValue{ 0 };
+			std::chrono::microseconds duration{ 0 };
+		};
+
+		void Run()
+		{
+			while (true)
+			{
+				Frame frame{};
+				{
+					std::unique_lock lock{ mutex };
+					condition.wait(lock, [&]() { return quit || !frames.empty(); });
+					if (frames.empty())
+						return;
+
+					frame = frames.front();
+				}
+
+				std::this_thread::sleep_for(frame.duration);
+
+				{
+					std::lock_guard lock{ mutex };
+					frames.pop_front();
+					completedValue = frame.fenceValue;
+				}
+				condition.notify_all();
+			}
+		}
+
+		std::mutex mutex;
+		std::condition_variable condition;
+		std::deque<Frame> frames;
+		uint64_t completedValue{ 0 };
+		bool quit{ false };
+
+		std::thread thread;
+	};
+
+	struct SimulationResult
+	{
+		double millisecondsPerFrame{ 0.0 };
+		FramePacerStatistics statistics{};
+	};
+
+	// Frames recorded for 'cpuTime' and executed for 'gpuTime' the way the renderer paces them. Checks
+	// that no slot is reused before its frame completes and that at most 'frameLatency - 1' frames are
+	// in flight when the recording of one starts.
+	SimulationResult SimulateFrames(
+		uint32_t frameLatency,
+		std::chrono::microseconds cpuTime,
+		std::chrono::microseconds gpuTime,
+		uint32_t frameCount)
+	{
+		SimulatedGpu gpu{};
+		FramePacer pacer{ frameLatency };
+
+		uint64_t fenceValue{ 0 };
+		std::array<uint64_t, MAX_FRAME_LATENCY> slotFenceValues{};
+
+		Clock::time_point start = Clock::now();
+
+		for (uint32_t frame = 0; frame < frameCount; frame++)
+		{
+			uint64_t waitFenceValue = pacer.BeginFrame(gpu.GetCompletedValue());
+			if (waitFenceValue > 0)
+				gpu.WaitForValue(waitFenceValue);
+
+			uint64_t completedValue = gpu.GetCompletedValue();
+			TEST_CHECK(slotFenceValues[pacer.GetFrameSlot()] <= completedValue);
+			TEST_CHECK(fenceValue - completedValue <= frameLatency - 1);
+
+			// Recording.
+			std::this_thread::sleep_for(cpuTime);
+
+			gpu.Submit(++fenceValue, gpuTime);
+			slotFenceValues[pacer.GetFrameSlot()] = fenceValue;
+			pacer.EndFrame(fenceValue);
+		}
+
+		gpu.WaitForValue(pacer.GetLastFenceValue());
+
+		SimulationResult result{};
+		result.millisecondsPerFrame =
+			std::chrono::duration<double, std::milli>(Clock::now() - start).count() / frameCount;
+		result.statistics = pacer.GetStatistics();
+		return result;
+	}
+}
+
+TEST_CASE(FramePacerRejectsInvalidLatency)
+{
+	TEST_CHECK_THROWS(FramePacer{ MIN_FRAME_LATENCY - 1 }, Error);
+	TEST_CHECK_THROWS(FramePacer{ MAX_FRAME_LATENCY + 1 }, Error);
+}
+
+TEST_CASE(FramePacerReusesSlotsInTurn)
+{
+	FramePacer pacer{ 2 };
+
+	// Fresh slots never wait.
+	TEST_CHECK(pacer.BeginFrame(0) == 0 && pacer.GetFrameSlot() == 0);
+	pacer.EndFrame(1);
+	TEST_CHECK(pacer.BeginFrame(0) == 0 && pacer.GetFrameSlot() == 1);
+	pacer.EndFrame(2);
+
+	// Back to slot 0, whose frame signals 1.
+	TEST_CHECK(pacer.BeginFrame(0) == 1 && pacer.GetFrameSlot() == 0);
+	pacer.EndFrame(3);
+	TEST_CHECK(pacer.BeginFrame(2) == 0 && pacer.GetFrameSlot() == 1);
+	pacer.EndFrame(4);
+
+	TEST_CHECK(pacer.GetFrameCount() == 4 && pacer.GetLastFenceValue() == 4);
+	TEST_CHECK(pacer.GetStatistics().waitCount == 1);
+}
+
+// With the CPU and the GPU taking as long per frame, one frame in flight runs them one after the other
+// and two overlap them: close to half the frame time.
+TEST_CASE(FramePacerOverlapsCpuAndGpu)
+{
+	constexpr std::chrono::microseconds frameTime{ 5000 };
+
+	SimulationResult serial = SimulateFrames(1, frameTime, frameTime, 30);
+	SimulationResult pipelined = SimulateFrames(2, frameTime, frameTime, 30);
+
+	TEST_CHECK(serial.statistics.waitCount == 29);
+	TEST_CHECK(pipelined.millisecondsPerFrame < serial.millisecondsPerFrame * 0.75);
+}
+
+// Frame times of each latency, with the GPU as fast as the CPU and twice as slow.
+BENCHMARK_CASE(FramePacerFrameTimes)
+{
+	constexpr std::chrono::microseconds cpuTime{ 4000 };
+
+	for (std::chrono::microseconds gpuTime : { std::chrono::microseconds{ 4000 }, std::chrono::microseconds{ 8000 } })
+	{
+		for (uint32_t frameLatency = MIN_FRAME_LATENCY; frameLatency <= MAX_FRAME_LATENCY; frameLatency++)
+		{
+			SimulationResult result = SimulateFrames(frameLatency, cpuTime, gpuTime, 60);
+
+			std::string label = "CPU 4 ms, GPU " + std::to_string(gpuTime.count() / 1000) + " ms, latency " +
+				std::to_string(frameLatency);
+			ReportMetric(label, result.millisecondsPerFrame, "ms/frame");
+			ReportMetric(label + " waits", static_cast<double>(result.statistics.waitCount), "frames");
+		}
+	}
+}
@@ -0,0 +1,205 @@
+#include "Test/Test.h"
+
+#include "Core/MathUtility.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/ProceduralGeometry.h"
+
+#include <cmath>
+#include <functional>
+#include <string>
+
+using namespace dxe;
+using namespace DirectX;
+
+// Every shape is generated into VertexPNTCU and checked for its topology, its normals and its index
+// order; the pooled output has to be the serial output byte for byte.
+
+namespace
+{
+	// Post-transform vertex cache the index order is measured against.
+	constexpr uint32_t FIFO_CACHE_SIZE = 32;
+
+	struct NamedShape
+	{
+		std::string name;
+		std::function<ProceduralMesh(ThreadPool* threadPool)> generate;
+		// Convex and centered on the origin, so every face points away from it.
+		bool convex{ true };
+	};
+
+	// Big enough for every shape to take the parallel path.
+	std::vector<NamedShape> GetShapes()
+	{
+		ProceduralVertexFormat vertexFormat = GetProceduralVertexFormat<VertexPNTCU>();
+
+		std::vector<NamedShape> shapes;
+		shapes.push_back({ "grid", [=](ThreadPool* threadPool) {
+			return GenerateGrid(vertexFormat, GridSettings{ 4.0f, 2.0f, 200, 150 }, threadPool); }, false });
+		shapes.push_back({ "box", [=](ThreadPool* threadPool) {
+			return GenerateBox(vertexFormat, BoxSettings{ XMFLOAT3{ 1.0f, 2.0f, 3.0f }, 64 }, threadPool); } });
+		shapes.push_back({ "UV sphere", [=](ThreadPool* threadPool) {
+			return GenerateUvSphere(vertexFormat, UvSphereSettings{ 0.5f, 256, 128 }, threadPool); } });
+		shapes.push_back({ "icosphere", [=](ThreadPool* threadPool) {
+			return GenerateIcosphere(vertexFormat, IcosphereSettings{ 0.5f, 5 }, threadPool); } });
+		shapes.push_back({ "cylinder", [=](ThreadPool* threadPool) {
+			return GenerateCylinder(vertexFormat, CylinderSettings{ 0.5f, 1.0f, 256, 32, true, 16 }, threadPool); } });
+		shapes.push_back({ "capsule", [=](ThreadPool* threadPool) {
+			return GenerateCapsule(vertexFormat, CapsuleSettings{ 0.5f, 1.0f, 256, 32, 8 }, threadPool); } });
+		shapes.push_back({ "torus", [=](ThreadPool* threadPool) {
+			return GenerateTorus(vertexFormat, TorusSettings{ 0.5f, 0.2f, 256, 128 }, threadPool); }, false });
+		return shapes;
+	}
+
+	// Misses per triangle of a FIFO cache of 'cacheSize' vertices.
+	double CalculateAcmr(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+	{
+		// A vertex is in the cache while fewer than 'cacheSize' misses happened since it was loaded.
+		std::vector<uint64_t> loadTimes(vertexCount, UINT64_MAX);
+		uint64_t missCount{ 0 };
+
+		for (uint32_t index : indices)
+		{
+			if (loadTimes[index] != UINT64_MAX && missCount - loadTimes[index] < cacheSize)
+				continue;
+
+			loadTimes[index] = missCount;
+			missCount++;
+		}
+
+		return static_cast<double>(missCount) / (indices.size() / 3);
+	}
+}
+
+TEST_CASE(ProceduralGeometryTopology)
+{
+	for (const NamedShape& shape : GetShapes())
+	{
+		ProceduralMesh mesh = shape.generate(nullptr);
+		std::vector<VertexPNTCU> vertices = mesh.GetVertices<VertexPNTCU>();
+
+		TEST_CHECK(mesh.vertexBufferInfo.vertexStride == VertexPNTCU::stride);
+		TEST_CHECK(mesh.vertexData.size() == static_cast<size_t>(mesh.vertexBufferInfo.vertexCount) * VertexPNTCU::stride);
+		TEST_CHECK(!mesh.indices.empty() && mesh.indices.size() % 3 == 0);
+
+		for (const VertexPNTCU& vertex : vertices)
+			TEST_CHECK(std::abs(Dot(vertex.vertexNormal, vertex.vertexNormal) - 1.0f) < 1e-4f);
+
+		for (size_t triangle = 0; triangle < mesh.indices.size(); triangle += 3)
+		{
+			uint32_t a = mesh.indices[triangle];
+			uint32_t b = mesh.indices[triangle + 1];
+			uint32_t c = mesh.indices[triangle + 2];
+			TEST_CHECK(a < vertices.size() && b < vertices.size() && c < vertices.size());
+
+			const VertexPNTCU& vertexA = vertices[a];
+			const VertexPNTCU& vertexB = vertices[b];
+			const VertexPNTCU& vertexC = vertices[c];
+
+			// Neither repeated indices nor triangles collapsed to a line or a point.
+			TEST_CHECK(a != b && b != c && a != c);
+			XMFLOAT3 faceNormal = Cross(
+				Subtract(vertexB.vertexPosition, vertexA.vertexPosition),
+				Subtract(vertexC.vertexPosition, vertexA.vertexPosition));
+			TEST_CHECK(Dot(faceNormal, faceNormal) > 1e-16f);
+
+			// Counter-clockwise front faces: the edges' cross product points along the normals.
+			XMFLOAT3 vertexNormal{
+				vertexA.vertexNormal.x + vertexB.vertexNormal.x + vertexC.vertexNormal.x,
+				vertexA.vertexNormal.y + vertexB.vertexNormal.y + vertexC.vertexNormal.y,
+				vertexA.vertexNormal.z + vertexB.vertexNormal.z + vertexC.vertexNormal.z };
+			TEST_CHECK(Dot(faceNormal, vertexNormal) > 0.0f);
+
+			if (shape.convex)
+			{
+				XMFLOAT3 centroid{
+					vertexA.vertexPosition.x + vertexB.vertexPosition.x + vertexC.vertexPosition.x,
+					vertexA.vertexPosition.y + vertexB.vertexPosition.y + vertexC.vertexPosition.y,
+					vertexA.vertexPosition.z + vertexB.vertexPosition.z + vertexC.vertexPosition.z };
+				TEST_CHECK(Dot(faceNormal, centroid) > 0.0f);
+			}
+		}
+	}
+}
+
+TEST_CASE(ProceduralGeometryDoesNotDependOnThreads)
+{
+	ThreadPool threadPool{ 4 };
+
+	for (const NamedShape& shape : GetShapes())
+	{
+		ProceduralMesh serial = shape.generate(nullptr);
+		ProceduralMesh pooled = shape.generate(&threadPool);
+
+		TEST_CHECK(serial.vertexBufferInfo.vertexCount == pooled.vertexBufferInfo.vertexCount);
+		TEST_CHECK(serial.vertexData == pooled.vertexData);
+		TEST_CHECK(serial.indices == pooled.indices);
+	}
+}
+
+// The generators' index order against a 32 entry FIFO cache: an optimal regular grid sits around
+// 0.5-0.6 misses per triangle, submitting vertices in row order alone gives about 1.
+TEST_CASE(ProceduralGeometryVertexCacheOrder)
+{
+	for (const NamedShape& shape : GetShapes())
+	{
+		ProceduralMesh mesh = shape.generate(nullptr);
+		double acmr = CalculateAcmr(mesh.indices, mesh.vertexBufferInfo.vertexCount, FIFO_CACHE_SIZE);
+		TEST_CHECK(acmr < 0.75);
+	}
+}
+
+TEST_CASE(ProceduralGeometryRejectsInvalidSettings)
+{
+	ProceduralVertexFormat vertexFormat = GetProceduralVertexFormat<VertexPNTCU>();
+
+	TEST_CHECK_THROWS(GenerateGrid(vertexFormat, GridSettings{ 1.0f, 1.0f, 0, 1 }), Error);
+	TEST_CHECK_THROWS(GenerateGrid(vertexFormat, GridSettings{ 1.0f, 1.0f, 1, 0 }), Error);
+	TEST_CHECK_THROWS(GenerateBox(vertexFormat, BoxSettings{ XMFLOAT3{ 1.0f, 1.0f, 1.0f }, 0 }), Error);
+
+	TEST_CHECK_THROWS(GenerateUvSphere(vertexFormat, UvSphereSettings{ 0.5f, 0, 16 }), Error);
+	TEST_CHECK_THROWS(GenerateUvSphere(vertexFormat, UvSphereSettings{ 0.5f, 32, 0 }), Error);
+	// Both poles collapse, a single ring has nothing left.
+	TEST_CHECK_THROWS(GenerateUvSphere(vertexFormat, UvSphereSettings{ 0.5f, 32, 1 }), Error);
+	TEST_CHECK_THROWS(GenerateIcosphere(vertexFormat, IcosphereSettings{ 0.5f, 11 }), Error);
+
+	TEST_CHECK_THROWS(GenerateCylinder(vertexFormat, CylinderSettings{ 0.5f, 1.0f, 0, 1, true, 1 }), Error);
+	TEST_CHECK_THROWS(GenerateCylinder(vertexFormat, CylinderSettings{ 0.5f, 1.0f, 32, 0, true, 1 }), Error);
+	TEST_CHECK_THROWS(GenerateCylinder(vertexFormat, CylinderSettings{ 0.5f, 1.0f, 32, 1, true, 0 }), Error);
+
+	TEST_CHECK_THROWS(GenerateCapsule(vertexFormat, CapsuleSettings{ 0.5f, 1.0f, 0, 8, 1 }), Error);
+	TEST_CHECK_THROWS(GenerateCapsule(vertexFormat, CapsuleSettings{ 0.5f, 1.0f, 32, 0, 1 }), Error);
+	TEST_CHECK_THROWS(GenerateCapsule(vertexFormat, CapsuleSettings{ 0.5f, 1.0f, 32, 8, 0 }), Error);
+
+	TEST_CHECK_THROWS(GenerateTorus(vertexFormat, TorusSettings{ 0.5f, 0.2f, 0, 24 }), Error);
+	TEST_CHECK_THROWS(GenerateTorus(vertexFormat, TorusSettings{ 0.5f, 0.2f, 48, 0 }), Error);
+
+	// The smallest valid settings work.
+	TEST_CHECK(GenerateGrid(vertexFormat, GridSettings{ 1.0f, 1.0f, 1, 1 }).indices.size() == 6);
+	TEST_CHECK(GenerateUvSphere(vertexFormat, UvSphereSettings{ 0.5f, 3, 2 }).indices.size() == 3 * 2 * 3);
+
+	// Layouts that don't fit their stride.
+	ProceduralVertexFormat brokenFormat = vertexFormat;
+	brokenFormat.vertexStride = 8;
+	TEST_CHECK_THROWS(GenerateGrid(brokenFormat, GridSettings{}), Error);
+}
+
+// A 2048 x 2048 grid (4.2M vertices) in VertexPNTCU, on one thread and on the pool.
+BENCHMARK_CASE(ProceduralGeometryLargeGrid)
+{
+	ThreadPool threadPool{};
+	ProceduralVertexFormat vertexFormat = GetProceduralVertexFormat<VertexPNTCU>();
+	GridSettings settings{ 100.0f, 100.0f, 2048, 2048 };
+
+	const uint64_t vertexCount = 2049ull * 2049ull;
+	ProceduralMesh mesh;
+
+	for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		ReportMetric(pool ? "grid, thread pool" : "grid, 1 thread", MeasureNanosecondsPerItem(vertexCount, [&]() {
+			mesh = GenerateGrid(vertexFormat, settings, pool);
+			KeepValue(mesh.indices.back());
+		}, 3), "ns/vertex");
+	}
+
+	ReportMetric("grid ACMR, FIFO 32", CalculateAcmr(mesh.indices, mesh.vertexBufferInfo.vertexCount, FIFO_CACHE_SIZE), "");
+}
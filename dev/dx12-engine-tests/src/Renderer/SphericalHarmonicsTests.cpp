@@ -0,0 +1,512 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Renderer/SphericalHarmonics.h"
+#include "Texture/EnvironmentBaker.h"
+
+#include <cmath>
+#include <functional>
+#include <random>
+
+using namespace dxe;
+using namespace DirectX;
+
+// The batch kernels are compared against references built only from the scalar EvaluateShBasis and
+// summed in double, and the convolution against the cosine lobe integrated over the sphere.
+
+namespace
+{
+	constexpr double PI = 3.14159265358979323846;
+
+	XMFLOAT3 GetRandomDirection(std::mt19937& random)
+	{
+		std::normal_distribution<float> distribution{};
+		float x = distribution(random);
+		float y = distribution(random);
+		float z = distribution(random);
+
+		float length = std::sqrt(x * x + y * y + z * z);
+		return XMFLOAT3{ x / length, y / length, z / length };
+	}
+
+	template <uint32_t CoefficientCount>
+	SphericalHarmonics<CoefficientCount> CreateRandomSh(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> distribution{ -1.0f, 1.0f };
+
+		SphericalHarmonics<CoefficientCount> sh{};
+		for (XMFLOAT4& coefficient : sh.coefficients)
+		{
+			coefficient.x = distribution(random);
+			coefficient.y = distribution(random);
+			coefficient.z = distribution(random);
+			coefficient.w = distribution(random);
+		}
+		return sh;
+	}
+
+	template <uint32_t CoefficientCount>
+	XMFLOAT4 EvaluateReference(const SphericalHarmonics<CoefficientCount>& sh, const XMFLOAT3& direction)
+	{
+		std::array<float, CoefficientCount> basis{};
+		EvaluateShBasis(direction, basis);
+
+		double sum[4]{};
+		for (uint32_t index = 0; index < CoefficientCount; index++)
+		{
+			const XMFLOAT4& coefficient = sh.coefficients[index];
+			sum[0] += static_cast<double>(coefficient.x) * basis[index];
+			sum[1] += static_cast<double>(coefficient.y) * basis[index];
+			sum[2] += static_cast<double>(coefficient.z) * basis[index];
+			sum[3] += static_cast<double>(coefficient.w) * basis[index];
+		}
+		return XMFLOAT4{ static_cast<float>(sum[0]), static_cast<float>(sum[1]), static_cast<float>(sum[2]), static_cast<float>(sum[3]) };
+	}
+
+	float GetDifference(const XMFLOAT4& a, const XMFLOAT4& b)
+	{
+		return std::max({ std::fabs(a.x - b.x), std::fabs(a.y - b.y), std::fabs(a.z - b.z), std::fabs(a.w - b.w) });
+	}
+
+	// Integral of 'function' times every L2 basis function over the sphere, on a latitude-longitude grid.
+	std::array<double, SH_L2_COEFFICIENT_COUNT> ProjectReference(const std::function<double(const XMFLOAT3& direction)>& function)
+	{
+		constexpr uint32_t steps = 400;
+		constexpr double step = PI / steps;
+
+		std::array<double, SH_L2_COEFFICIENT_COUNT> sums{};
+		for (uint32_t latitude = 0; latitude < steps; latitude++)
+		{
+			double theta = (latitude + 0.5) * step;
+			for (uint32_t longitude = 0; longitude < 2 * steps; longitude++)
+			{
+				double phi = (longitude + 0.5) * step;
+				XMFLOAT3 direction{
+					static_cast<float>(std::sin(theta) * std::cos(phi)),
+					static_cast<float>(std::cos(theta)),
+					static_cast<float>(std::sin(theta) * std::sin(phi)) };
+
+				std::array<float, SH_L2_COEFFICIENT_COUNT> basis{};
+				EvaluateShBasis(direction, basis);
+
+				double weight = function(direction) * std::sin(theta) * step * step;
+				for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+					sums[index] += weight * basis[index];
+			}
+		}
+		return sums;
+	}
+
+	// Row-vector rotation by 'angle' around the unit 'axis'.
+	XMFLOAT4X4 CreateRotation(const XMFLOAT3& axis, float angle)
+	{
+		float c = std::cos(angle);
+		float s = std::sin(angle);
+		float t = 1.0f - c;
+
+		XMFLOAT4X4 rotation{};
+		rotation.m[0][0] = c + axis.x * axis.x * t;
+		rotation.m[0][1] = axis.x * axis.y * t + axis.z * s;
+		rotation.m[0][2] = axis.x * axis.z * t - axis.y * s;
+		rotation.m[1][0] = axis.y * axis.x * t - axis.z * s;
+		rotation.m[1][1] = c + axis.y * axis.y * t;
+		rotation.m[1][2] = axis.y * axis.z * t + axis.x * s;
+		rotation.m[2][0] = axis.z * axis.x * t + axis.y * s;
+		rotation.m[2][1] = axis.z * axis.y * t - axis.x * s;
+		rotation.m[2][2] = c + axis.z * axis.z * t;
+		rotation.m[3][3] = 1.0f;
+		return rotation;
+	}
+
+	XMFLOAT3 TransformDirection(const XMFLOAT3& direction, const XMFLOAT4X4& rotation)
+	{
+		return XMFLOAT3{
+			direction.x * rotation.m[0][0] + direction.y * rotation.m[1][0] + direction.z * rotation.m[2][0],
+			direction.x * rotation.m[0][1] + direction.y * rotation.m[1][1] + direction.z * rotation.m[2][1],
+			direction.x * rotation.m[0][2] + direction.y * rotation.m[1][2] + direction.z * rotation.m[2][2] };
+	}
+
+	template <uint32_t CoefficientCount>
+	void CheckBatchEvaluation(std::mt19937& random, ThreadPool& threadPool)
+	{
+		// Tails of 1 to 3 directions after the groups of four, and counts spanning several jobs.
+		for (size_t count : { 0, 1, 3, 4, 7, 256, 1001 })
+		{
+			std::vector<SphericalHarmonics<CoefficientCount>> probes;
+			std::vector<uint32_t> probeIndices;
+			std::vector<XMFLOAT3> directions;
+			for (size_t i = 0; i < count; i++)
+			{
+				probes.push_back(CreateRandomSh<CoefficientCount>(random));
+				probeIndices.push_back(static_cast<uint32_t>(random() % count));
+				directions.push_back(GetRandomDirection(random));
+			}
+
+			for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+			{
+				std::vector<XMFLOAT4> results(count);
+				EvaluateSh(probes.data(), nullptr, directions.data(), results.data(), count, pool);
+				for (size_t i = 0; i < count; i++)
+					TEST_CHECK(GetDifference(results[i], EvaluateReference(probes[i], directions[i])) < 1.0e-5f);
+
+				std::vector<XMFLOAT4> indexedResults(count);
+				EvaluateSh(probes.data(), probeIndices.data(), directions.data(), indexedResults.data(), count, pool);
+				for (size_t i = 0; i < count; i++)
+					TEST_CHECK(GetDifference(indexedResults[i], EvaluateReference(probes[probeIndices[i]], directions[i])) < 1.0e-5f);
+			}
+		}
+	}
+
+	template <uint32_t CoefficientCount>
+	void CheckRotation(std::mt19937& random)
+	{
+		std::vector<SphericalHarmonics<CoefficientCount>> sources;
+		for (uint32_t i = 0; i < 16; i++)
+			sources.push_back(CreateRandomSh<CoefficientCount>(random));
+
+		for (uint32_t i = 0; i < 20; i++)
+		{
+			XMFLOAT4X4 rotation = CreateRotation(GetRandomDirection(random), 0.37f * (i + 1));
+			ShRotation shRotation = CreateShRotation(rotation);
+
+			std::vector<SphericalHarmonics<CoefficientCount>> destinations(sources.size());
+			RotateSh(shRotation, sources.data(), destinations.data(), sources.size());
+
+			// In place gives the same result.
+			std::vector<SphericalHarmonics<CoefficientCount>> rotatedInPlace = sources;
+			RotateSh(shRotation, rotatedInPlace.data(), rotatedInPlace.data(), rotatedInPlace.size());
+
+			for (size_t probe = 0; probe < sources.size(); probe++)
+			{
+				XMFLOAT3 direction = GetRandomDirection(random);
+				XMFLOAT3 rotatedDirection = TransformDirection(direction, rotation);
+
+				XMFLOAT4 expected = EvaluateReference(sources[probe], direction);
+				TEST_CHECK(GetDifference(EvaluateReference(destinations[probe], rotatedDirection), expected) < 1.0e-4f);
+				TEST_CHECK(GetDifference(EvaluateReference(rotatedInPlace[probe], rotatedDirection), expected) < 1.0e-4f);
+			}
+		}
+	}
+}
+
+// The normalization constants: the basis integrates to the identity over the sphere.
+TEST_CASE(SphericalHarmonicsBasisIsOrthonormal)
+{
+	for (uint32_t function = 0; function < SH_L2_COEFFICIENT_COUNT; function++)
+	{
+		std::array<double, SH_L2_COEFFICIENT_COUNT> products = ProjectReference([function](const XMFLOAT3& direction) {
+			std::array<float, SH_L2_COEFFICIENT_COUNT> basis{};
+			EvaluateShBasis(direction, basis);
+			return static_cast<double>(basis[function]);
+		});
+
+		for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+			TEST_CHECK(std::fabs(products[index] - (index == function ? 1.0 : 0.0)) < 1.0e-4);
+	}
+
+	// L1 is the first four functions of L2.
+	std::mt19937 random{ 1 };
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		XMFLOAT3 direction = GetRandomDirection(random);
+		std::array<float, SH_L1_COEFFICIENT_COUNT> l1Basis{};
+		std::array<float, SH_L2_COEFFICIENT_COUNT> l2Basis{};
+		EvaluateShBasis(direction, l1Basis);
+		EvaluateShBasis(direction, l2Basis);
+		TEST_CHECK(std::equal(l1Basis.begin(), l1Basis.end(), l2Basis.begin()));
+	}
+}
+
+TEST_CASE(SphericalHarmonicsDirectionalLightMatchesBasis)
+{
+	std::mt19937 random{ 2 };
+	ShL2 sh = CreateRandomSh<SH_L2_COEFFICIENT_COUNT>(random);
+	ShL1 l1Sh = ConvertShL2ToL1(sh);
+
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		XMFLOAT3 direction = GetRandomDirection(random);
+		XMFLOAT4 color{ 0.5f + i * 0.01f, 1.0f, 2.0f - i * 0.01f, 0.25f };
+
+		ShL2 expected = sh;
+		std::array<float, SH_L2_COEFFICIENT_COUNT> basis{};
+		EvaluateShBasis(direction, basis);
+		for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+		{
+			XMFLOAT4& coefficient = expected.coefficients[index];
+			coefficient.x += color.x * basis[index];
+			coefficient.y += color.y * basis[index];
+			coefficient.z += color.z * basis[index];
+			coefficient.w += color.w * basis[index];
+		}
+
+		AddShDirectionalLight(sh, direction, color);
+		AddShDirectionalLight(l1Sh, direction, color);
+		for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+			TEST_CHECK(GetDifference(sh.coefficients[index], expected.coefficients[index]) < 1.0e-5f);
+		for (uint32_t index = 0; index < SH_L1_COEFFICIENT_COUNT; index++)
+			TEST_CHECK(GetDifference(l1Sh.coefficients[index], sh.coefficients[index]) < 1.0e-5f);
+
+		// The scalar single-direction evaluation agrees with the reference too.
+		XMFLOAT3 view = GetRandomDirection(random);
+		TEST_CHECK(GetDifference(EvaluateSh(sh, view), EvaluateReference(sh, view)) < 1.0e-5f);
+		TEST_CHECK(GetDifference(EvaluateSh(l1Sh, view), EvaluateReference(l1Sh, view)) < 1.0e-5f);
+	}
+}
+
+TEST_CASE(SphericalHarmonicsBatchEvaluationMatchesScalar)
+{
+	ThreadPool threadPool{ 4 };
+	std::mt19937 random{ 3 };
+
+	CheckBatchEvaluation<SH_L1_COEFFICIENT_COUNT>(random, threadPool);
+	CheckBatchEvaluation<SH_L2_COEFFICIENT_COUNT>(random, threadPool);
+}
+
+TEST_CASE(SphericalHarmonicsBlendMatchesScalar)
+{
+	ThreadPool threadPool{ 4 };
+	std::mt19937 random{ 4 };
+
+	const uint32_t probeCount = 64;
+	const uint32_t cornerCount = 8;
+	const size_t count = 1001;
+
+	std::vector<ShL2> probes;
+	for (uint32_t i = 0; i < probeCount; i++)
+		probes.push_back(CreateRandomSh<SH_L2_COEFFICIENT_COUNT>(random));
+
+	// Some corners have a weight of 0, as outside the grid.
+	std::vector<uint32_t> probeIndices(count * cornerCount);
+	std::vector<float> weights(count * cornerCount);
+	for (size_t entry = 0; entry < weights.size(); entry++)
+	{
+		probeIndices[entry] = random() % probeCount;
+		weights[entry] = random() % 5 == 0 ? 0.0f : static_cast<float>(random() % 1000) / 1000.0f;
+	}
+
+	for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		std::vector<ShL2> results(count, CreateRandomSh<SH_L2_COEFFICIENT_COUNT>(random));
+		BlendSh(probes.data(), probeIndices.data(), weights.data(), cornerCount, results.data(), count, pool);
+
+		for (size_t result = 0; result < count; result++)
+		{
+			// Blending then evaluating is evaluating every corner with the scalar basis and blending.
+			XMFLOAT3 direction = GetRandomDirection(random);
+
+			double expected[4]{};
+			for (uint32_t corner = 0; corner < cornerCount; corner++)
+			{
+				size_t entry = result * cornerCount + corner;
+				XMFLOAT4 value = EvaluateReference(probes[probeIndices[entry]], direction);
+				expected[0] += static_cast<double>(weights[entry]) * value.x;
+				expected[1] += static_cast<double>(weights[entry]) * value.y;
+				expected[2] += static_cast<double>(weights[entry]) * value.z;
+				expected[3] += static_cast<double>(weights[entry]) * value.w;
+			}
+
+			XMFLOAT4 expectedValue{
+				static_cast<float>(expected[0]), static_cast<float>(expected[1]), static_cast<float>(expected[2]), static_cast<float>(expected[3]) };
+			TEST_CHECK(GetDifference(EvaluateReference(results[result], direction), expectedValue) < 1.0e-4f);
+		}
+	}
+}
+
+// The rotated function seen along 'direction * rotation' is the source seen along 'direction'.
+TEST_CASE(SphericalHarmonicsRotation)
+{
+	std::mt19937 random{ 5 };
+	CheckRotation<SH_L1_COEFFICIENT_COUNT>(random);
+	CheckRotation<SH_L2_COEFFICIENT_COUNT>(random);
+
+	// The identity keeps every coefficient.
+	XMFLOAT4X4 identity{};
+	identity.m[0][0] = identity.m[1][1] = identity.m[2][2] = identity.m[3][3] = 1.0f;
+
+	ShL2 source = CreateRandomSh<SH_L2_COEFFICIENT_COUNT>(random);
+	ShL2 destination{};
+	RotateSh(CreateShRotation(identity), &source, &destination, 1);
+	for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+		TEST_CHECK(GetDifference(destination.coefficients[index], source.coefficients[index]) < 1.0e-5f);
+}
+
+// A directional light convolved is the clamped cosine lobe max(0, n.l) / pi around it, projected onto
+// the basis. Its evaluation along the light is the analytic (1/4 + 1/2 + 5/16) / pi.
+TEST_CASE(SphericalHarmonicsIrradianceMatchesCosineLobe)
+{
+	std::mt19937 random{ 6 };
+	std::vector<XMFLOAT3> lights = { XMFLOAT3{ 0.0f, 1.0f, 0.0f }, XMFLOAT3{ 1.0f, 0.0f, 0.0f }, XMFLOAT3{ 0.0f, 0.0f, -1.0f } };
+	for (uint32_t i = 0; i < 3; i++)
+		lights.push_back(GetRandomDirection(random));
+
+	const XMFLOAT4 color{ 1.0f, 0.5f, 2.0f, 1.0f };
+
+	for (const XMFLOAT3& light : lights)
+	{
+		ShL2 sh{};
+		AddShDirectionalLight(sh, light, color);
+		ShL1 l1Sh = ConvertShL2ToL1(sh);
+		ConvolveShIrradiance(sh);
+		ConvolveShIrradiance(l1Sh);
+
+		std::array<double, SH_L2_COEFFICIENT_COUNT> lobe = ProjectReference([&light](const XMFLOAT3& direction) {
+			double cosine = static_cast<double>(direction.x) * light.x + static_cast<double>(direction.y) * light.y +
+				static_cast<double>(direction.z) * light.z;
+			return std::max(0.0, cosine) / PI;
+		});
+
+		for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+		{
+			XMFLOAT4 expected{
+				static_cast<float>(lobe[index] * color.x), static_cast<float>(lobe[index] * color.y),
+				static_cast<float>(lobe[index] * color.z), static_cast<float>(lobe[index] * color.w) };
+			TEST_CHECK(GetDifference(sh.coefficients[index], expected) < 1.0e-4f);
+		}
+		for (uint32_t index = 0; index < SH_L1_COEFFICIENT_COUNT; index++)
+			TEST_CHECK(GetDifference(l1Sh.coefficients[index], sh.coefficients[index]) < 1.0e-6f);
+
+		TEST_CHECK(std::fabs(EvaluateSh(sh, light).x - 1.0625 / PI) < 1.0e-5);
+		TEST_CHECK(std::fabs(EvaluateSh(l1Sh, light).x - 0.75 / PI) < 1.0e-5);
+	}
+}
+
+// A cube map of a function in the span of the basis projects back to exactly that function.
+TEST_CASE(SphericalHarmonicsProjectionRoundTrip)
+{
+	ThreadPool threadPool{ 4 };
+	std::mt19937 random{ 7 };
+	ShL2 sh = CreateRandomSh<SH_L2_COEFFICIENT_COUNT>(random);
+
+	const uint32_t size = 32;
+	FloatCubemap cubemap = CreateFloatCubemap(size);
+	for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+	{
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+			{
+				XMFLOAT4 value = EvaluateReference(sh, GetCubemapDirection(face, (x + 0.5f) / size, (y + 0.5f) / size));
+
+				float* texel = cubemap.GetSurface(0, face) + (static_cast<size_t>(y) * size + x) * 4;
+				texel[0] = value.x;
+				texel[1] = value.y;
+				texel[2] = value.z;
+				texel[3] = value.w;
+			}
+		}
+	}
+
+	ShCubemapProjector projector{ size };
+	ShL2 projected = projector.Project(cubemap);
+	for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+		TEST_CHECK(GetDifference(projected.coefficients[index], sh.coefficients[index]) < 5.0e-3f);
+
+	std::vector<const FloatCubemap*> cubemaps(9, &cubemap);
+	std::vector<ShL2> results(cubemaps.size());
+	projector.Project(cubemaps.data(), results.data(), results.size(), &threadPool);
+	for (const ShL2& result : results)
+	{
+		for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+			TEST_CHECK(GetDifference(result.coefficients[index], projected.coefficients[index]) == 0.0f);
+	}
+
+	TEST_CHECK_THROWS(ShCubemapProjector{ 0 }, Error);
+	TEST_CHECK_THROWS(ShCubemapProjector{ 16 }.Project(CreateFloatCubemap(8)), Error);
+}
+
+// Per-probe costs of a grid of 10k probes: projecting their 8x8 captures, rotating them with the level
+// and evaluating one direction each, batched against one EvaluateSh call per direction.
+BENCHMARK_CASE(SphericalHarmonicsProbeGrid)
+{
+	ThreadPool threadPool{};
+	std::mt19937 random{ 8 };
+
+	const size_t probeCount = 10000;
+	const uint32_t captureSize = 8;
+
+	// A few distinct captures, so the projection doesn't run out of one cache-resident cube map.
+	std::vector<FloatCubemap> captures;
+	for (uint32_t i = 0; i < 64; i++)
+	{
+		captures.push_back(CreateFloatCubemap(captureSize));
+		for (std::vector<float>& surface : captures.back().surfaces)
+		{
+			for (float& value : surface)
+				value = static_cast<float>(random() % 1000) / 100.0f;
+		}
+	}
+
+	std::vector<const FloatCubemap*> cubemaps(probeCount);
+	for (size_t i = 0; i < probeCount; i++)
+		cubemaps[i] = &captures[i % captures.size()];
+
+	ShCubemapProjector projector{ captureSize };
+	std::vector<ShL2> probes(probeCount);
+	for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		std::string suffix = pool ? ", thread pool" : ", 1 thread";
+		ReportMetric("project 8x8 captures" + suffix, MeasureNanosecondsPerItem(probeCount, [&]() {
+			projector.Project(cubemaps.data(), probes.data(), probeCount, pool);
+			KeepValue(probes.back().coefficients[0].x);
+		}), "ns/probe");
+	}
+
+	ShRotation rotation = CreateShRotation(CreateRotation(XMFLOAT3{ 0.0f, 1.0f, 0.0f }, 0.5f));
+	std::vector<ShL2> rotated(probeCount);
+	ReportMetric("rotate L2", MeasureNanosecondsPerItem(probeCount, [&]() {
+		RotateSh(rotation, probes.data(), rotated.data(), probeCount);
+		KeepValue(rotated.back().coefficients[8].x);
+	}), "ns/probe");
+
+	std::vector<ShL1> l1Probes(probeCount);
+	std::vector<ShL1> l1Rotated(probeCount);
+	for (size_t i = 0; i < probeCount; i++)
+		l1Probes[i] = ConvertShL2ToL1(probes[i]);
+	ReportMetric("rotate L1", MeasureNanosecondsPerItem(probeCount, [&]() {
+		RotateSh(rotation, l1Probes.data(), l1Rotated.data(), probeCount);
+		KeepValue(l1Rotated.back().coefficients[3].x);
+	}), "ns/probe");
+
+	std::vector<uint32_t> probeIndices(probeCount);
+	std::vector<XMFLOAT3> directions(probeCount);
+	for (size_t i = 0; i < probeCount; i++)
+	{
+		probeIndices[i] = static_cast<uint32_t>(random() % probeCount);
+		directions[i] = GetRandomDirection(random);
+	}
+
+	std::vector<XMFLOAT4> results(probeCount);
+	ReportMetric("evaluate L2, one call per direction", MeasureNanosecondsPerItem(probeCount, [&]() {
+		for (size_t i = 0; i < probeCount; i++)
+			results[i] = EvaluateSh(probes[probeIndices[i]], directions[i]);
+		KeepValue(results.back().x);
+	}), "ns/direction");
+
+	for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		std::string suffix = pool ? ", thread pool" : ", 1 thread";
+		ReportMetric("evaluate L2, batched" + suffix, MeasureNanosecondsPerItem(probeCount, [&]() {
+			EvaluateSh(probes.data(), probeIndices.data(), directions.data(), results.data(), probeCount, pool);
+			KeepValue(results.back().x);
+		}), "ns/direction");
+	}
+
+	ReportMetric("evaluate L1, batched, 1 thread", MeasureNanosecondsPerItem(probeCount, [&]() {
+		EvaluateSh(l1Probes.data(), probeIndices.data(), directions.data(), results.data(), probeCount);
+		KeepValue(results.back().x);
+	}), "ns/direction");
+
+	// Eight corners per instance, as the renderer blends a grid cell.
+	const uint32_t cornerCount = 8;
+	std::vector<uint32_t> cornerIndices(probeCount * cornerCount);
+	std::vector<float> weights(probeCount * cornerCount, 1.0f / cornerCount);
+	for (uint32_t& index : cornerIndices)
+		index = static_cast<uint32_t>(random() % probeCount);
+
+	std::vector<ShL2> blended(probeCount);
+	ReportMetric("blend 8 corners, 1 thread", MeasureNanosecondsPerItem(probeCount, [&]() {
+		BlendSh(probes.data(), cornerIndices.data(), weights.data(), cornerCount, blended.data(), probeCount);
+		KeepValue(blended.back().coefficients[0].x);
+	}), "ns/instance");
+}
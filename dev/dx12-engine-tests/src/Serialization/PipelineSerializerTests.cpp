@@ -0,0 +1,210 @@
+#include "Test/Test.h"
+
+#include "Serialization/PipelineSerializer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+using namespace dxe;
+
+// Pipeline libraries are written the way WriteDx12GraphicsPipelineState lays them out, without the
+// D3D12 desc, so the format and its validation are tested on their own.
+
+namespace
+{
+	// Shader bytecode is aligned like the D3D12 writer aligns it.
+	constexpr size_t TEST_BYTECODE_ALIGNMENT = 16;
+
+	struct TestInputElement
+	{
+		std::string semanticName;
+		uint32_t semanticIndex{ 0 };
+		uint32_t format{ 0 };
+		uint32_t alignedByteOffset{ 0 };
+	};
+
+	struct TestPipeline
+	{
+		std::string name;
+		std::vector<uint8_t> vertexShader;
+		std::vector<uint8_t> pixelShader;
+		std::vector<TestInputElement> inputLayout;
+		uint32_t renderTargetCount{ 1 };
+	};
+
+	// Two pipelines with different layouts, the second one without a pixel shader (i.e. depth only).
+	std::vector<TestPipeline> CreatePipelines()
+	{
+		std::vector<TestPipeline> pipelines(2);
+
+		pipelines[0].name = "lit";
+		pipelines[0].vertexShader.resize(301);
+		pipelines[0].pixelShader.resize(517);
+		for (size_t byte = 0; byte < pipelines[0].vertexShader.size(); byte++)
+			pipelines[0].vertexShader[byte] = static_cast<uint8_t>(byte * 3);
+		for (size_t byte = 0; byte < pipelines[0].pixelShader.size(); byte++)
+			pipelines[0].pixelShader[byte] = static_cast<uint8_t>(byte * 5 + 1);
+		pipelines[0].inputLayout = {
+			{ "POSITION", 0, 6, 0 },
+			{ "NORMAL", 0, 6, 12 },
+			{ "TEXCOORD", 0, 16, 24 },
+			{ "TEXCOORD", 1, 16, 32 },
+		};
+		pipelines[0].renderTargetCount = 2;
+
+		pipelines[1].name = "depth prepass";
+		pipelines[1].vertexShader.assign(96, 0xab);
+		pipelines[1].inputLayout = { { "POSITION", 0, 6, 0 } };
+		pipelines[1].renderTargetCount = 0;
+
+		return pipelines;
+	}
+
+	std::vector<uint8_t> WritePipelineLibrary(const std::vector<TestPipeline>& pipelines)
+	{
+		BinaryWriter writer{ SerializedPipelineLibrary::SCHEMA_ID, SerializedPipelineLibrary::SCHEMA_VERSION };
+		uint32_t root = writer.Append<SerializedPipelineLibrary>();
+
+		uint32_t pipelinesPosition = writer.WriteArray<SerializedGraphicsPipelineState>(
+			root + offsetof(SerializedPipelineLibrary, graphicsPipelines), nullptr, static_cast<uint32_t>(pipelines.size()));
+
+		for (size_t pipeline = 0; pipeline < pipelines.size(); pipeline++)
+		{
+			const TestPipeline& testPipeline = pipelines[pipeline];
+			uint32_t position = pipelinesPosition + static_cast<uint32_t>(pipeline * sizeof(SerializedGraphicsPipelineState));
+
+			writer.WriteString(position + offsetof(SerializedGraphicsPipelineState, name), testPipeline.name);
+			writer.WriteArray(position + offsetof(SerializedGraphicsPipelineState, vertexShader),
+				testPipeline.vertexShader.data(), static_cast<uint32_t>(testPipeline.vertexShader.size()), TEST_BYTECODE_ALIGNMENT);
+			writer.WriteArray(position + offsetof(SerializedGraphicsPipelineState, pixelShader),
+				testPipeline.pixelShader.data(), static_cast<uint32_t>(testPipeline.pixelShader.size()), TEST_BYTECODE_ALIGNMENT);
+
+			uint32_t inputElementCount = static_cast<uint32_t>(testPipeline.inputLayout.size());
+			uint32_t inputElementsPosition = writer.WriteArray<SerializedInputElement>(
+				position + offsetof(SerializedGraphicsPipelineState, inputLayout), nullptr, inputElementCount);
+
+			for (uint32_t element = 0; element < inputElementCount; element++)
+			{
+				const TestInputElement& testElement = testPipeline.inputLayout[element];
+				uint32_t elementPosition = inputElementsPosition + element * sizeof(SerializedInputElement);
+
+				writer.WriteString(elementPosition + offsetof(SerializedInputElement, semanticName), testElement.semanticName);
+
+				SerializedInputElement& inputElement = writer.Get<SerializedInputElement>(elementPosition);
+				inputElement.semanticIndex = testElement.semanticIndex;
+				inputElement.format = testElement.format;
+				inputElement.alignedByteOffset = testElement.alignedByteOffset;
+			}
+
+			SerializedGraphicsPipelineState& pipelineState = writer.Get<SerializedGraphicsPipelineState>(position);
+			pipelineState.renderTargetCount = testPipeline.renderTargetCount;
+			pipelineState.sampleCount = 1;
+		}
+
+		return writer.Finish(root);
+	}
+
+	// The field of 'corrupted' (a copy of 'data') at the position 'field' has in 'data'.
+	template <typename T>
+	T& GetCopiedField(std::vector<uint8_t>& corrupted, const std::vector<uint8_t>& data, const T& field)
+	{
+		size_t position = reinterpret_cast<const uint8_t*>(&field) - data.data();
+		return *reinterpret_cast<T*>(corrupted.data() + position);
+	}
+}
+
+TEST_CASE(PipelineSerializerRoundTrip)
+{
+	std::vector<TestPipeline> pipelines = CreatePipelines();
+	std::vector<uint8_t> data = WritePipelineLibrary(pipelines);
+
+	const SerializedPipelineLibrary* library = OpenBinary<SerializedPipelineLibrary>(data.data(), data.size());
+	TEST_CHECK(library->graphicsPipelines.Size() == pipelines.size());
+
+	for (uint32_t pipeline = 0; pipeline < library->graphicsPipelines.Size(); pipeline++)
+	{
+		const TestPipeline& testPipeline = pipelines[pipeline];
+		const SerializedGraphicsPipelineState& pipelineState = library->graphicsPipelines[pipeline];
+
+		TEST_CHECK(pipelineState.name.View() == testPipeline.name);
+		TEST_CHECK(pipelineState.renderTargetCount == testPipeline.renderTargetCount && pipelineState.sampleCount == 1);
+
+		// Bytecode is handed to D3D12 in place.
+		TEST_CHECK(std::equal(testPipeline.vertexShader.begin(), testPipeline.vertexShader.end(),
+			pipelineState.vertexShader.begin(), pipelineState.vertexShader.end()));
+		TEST_CHECK(std::equal(testPipeline.pixelShader.begin(), testPipeline.pixelShader.end(),
+			pipelineState.pixelShader.begin(), pipelineState.pixelShader.end()));
+		TEST_CHECK(reinterpret_cast<uintptr_t>(pipelineState.vertexShader.Data()) % TEST_BYTECODE_ALIGNMENT == 0);
+		if (!pipelineState.pixelShader.Empty())
+			TEST_CHECK(reinterpret_cast<uintptr_t>(pipelineState.pixelShader.Data()) % TEST_BYTECODE_ALIGNMENT == 0);
+
+		TEST_CHECK(pipelineState.inputLayout.Size() == testPipeline.inputLayout.size());
+		for (uint32_t element = 0; element < pipelineState.inputLayout.Size(); element++)
+		{
+			const SerializedInputElement& inputElement = pipelineState.inputLayout[element];
+			const TestInputElement& testElement = testPipeline.inputLayout[element];
+
+			TEST_CHECK(inputElement.semanticName.View() == testElement.semanticName);
+			TEST_CHECK(inputElement.semanticName.CStr()[testElement.semanticName.size()] == '\0');
+			TEST_CHECK(inputElement.semanticIndex == testElement.semanticIndex);
+			TEST_CHECK(inputElement.format == testElement.format && inputElement.alignedByteOffset == testElement.alignedByteOffset);
+		}
+	}
+}
+
+// Truncations, offsets pointing out of the file or off alignment, missing terminators and render
+// target counts past the desc's arrays are all rejected when the library is opened.
+TEST_CASE(PipelineSerializerRejectsCorruptFiles)
+{
+	std::vector<uint8_t> data = WritePipelineLibrary(CreatePipelines());
+
+	for (size_t size = 0; size < data.size(); size++)
+		TEST_CHECK_THROWS(OpenBinary<SerializedPipelineLibrary>(data.data(), size), Error);
+
+	std::vector<uint8_t> otherSchema = data;
+	reinterpret_cast<BinaryFileHeader*>(otherSchema.data())->schemaId = MakeBinarySchemaId('S', 'C', 'N', 'E');
+	TEST_CHECK_THROWS(OpenBinary<SerializedPipelineLibrary>(otherSchema.data(), otherSchema.size()), Error);
+
+	const SerializedPipelineLibrary* library = OpenBinary<SerializedPipelineLibrary>(data.data(), data.size());
+	const SerializedGraphicsPipelineState& pipelineState = library->graphicsPipelines[0];
+	const SerializedInputElement& inputElement = pipelineState.inputLayout[1];
+
+	auto checkRejected = [&](const std::vector<uint8_t>& corrupted) {
+		TEST_CHECK_THROWS(OpenBinary<SerializedPipelineLibrary>(corrupted.data(), corrupted.size()), Error);
+	};
+
+	std::vector<uint8_t> corrupted = data;
+	GetCopiedField(corrupted, data, library->graphicsPipelines).count++;
+	checkRejected(corrupted);
+
+	corrupted = data;
+	GetCopiedField(corrupted, data, pipelineState.vertexShader).offset = static_cast<uint32_t>(data.size());
+	checkRejected(corrupted);
+
+	corrupted = data;
+	GetCopiedField(corrupted, data, pipelineState.pixelShader).count = UINT32_MAX;
+	checkRejected(corrupted);
+
+	corrupted = data;
+	GetCopiedField(corrupted, data, pipelineState.inputLayout).offset += 1;
+	checkRejected(corrupted);
+
+	corrupted = data;
+	GetCopiedField(corrupted, data, pipelineState.name).offset = UINT32_MAX;
+	checkRejected(corrupted);
+
+	// Semantic names are passed to D3D12 as C strings.
+	corrupted = data;
+	GetCopiedField(corrupted, data, inputElement.semanticName).length--;
+	checkRejected(corrupted);
+
+	corrupted = data;
+	GetCopiedField(corrupted, data, inputElement.semanticName).offset = static_cast<uint32_t>(data.size());
+	checkRejected(corrupted);
+
+	corrupted = data;
+	GetCopiedField(corrupted, data, pipelineState.renderTargetCount) = SERIALIZED_RENDER_TARGET_COUNT + 1;
+	checkRejected(corrupted);
+}
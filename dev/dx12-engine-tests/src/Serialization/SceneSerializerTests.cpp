@@ -0,0 +1,311 @@
+#include "Test/Test.h"
+
+#include "Serialization/SceneSerializer.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace dxe;
+
+namespace
+{
+	// Meshes with a position, normal and UV layout and random vertex data, nodes parented to
+	// earlier nodes.
+	Scene CreateScene(uint32_t meshCount, uint32_t nodeCount, uint32_t vertexCount)
+	{
+		std::mt19937 random{ 1 };
+		Scene scene{};
+
+		for (uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+		{
+			SceneMesh& mesh = scene.meshes.emplace_back();
+			mesh.name = "mesh_" + std::to_string(meshIndex);
+
+			mesh.vertexBufferInfo.vertexAttribLayout = {
+				{ 3, 0, VertexAttribType::POSITION, VertexAttribFormat::FLOAT32 },
+				{ 3, 12, VertexAttribType::NORMAL, VertexAttribFormat::FLOAT32 },
+				{ 2, 24, VertexAttribType::UV, VertexAttribFormat::FLOAT32 },
+			};
+			mesh.vertexBufferInfo.vertexStride = 32;
+			mesh.vertexBufferInfo.vertexCount = vertexCount + meshIndex % 7;
+			mesh.vertexData.resize(static_cast<size_t>(mesh.vertexBufferInfo.vertexCount) * 32);
+			for (uint8_t& byte : mesh.vertexData)
+				byte = static_cast<uint8_t>(random());
+
+			bool shortIndices = meshIndex % 2 == 1;
+			mesh.indexBufferInfo.indexCount = vertexCount * 3;
+			mesh.indexBufferInfo.indexFormat = shortIndices ? IndexFormat::UINT16 : IndexFormat::UINT32;
+			mesh.indexData.resize(static_cast<size_t>(mesh.indexBufferInfo.indexCount) * (shortIndices ? 2 : 4), 7);
+		}
+
+		for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; nodeIndex++)
+		{
+			SceneNode& node = scene.nodes.emplace_back();
+			node.transform.m[0][0] = static_cast<float>(nodeIndex);
+			node.meshIndex = nodeIndex % meshCount;
+			node.parentIndex = nodeIndex == 0 ? SCENE_NODE_NO_PARENT : static_cast<uint32_t>(random() % nodeIndex);
+		}
+
+		return scene;
+	}
+
+	// The usual stream serializer the binary format replaces: every field written and read on its
+	// own through a stream, and the scene rebuilt in memory on load.
+
+	template <typename T>
+	void WriteValue(std::ostream& stream, const T& value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+	template <typename T>
+	void ReadValue(std::istream& stream, T& value)
+	{
+		stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+	}
+
+	void WriteBytes(std::ostream& stream, const std::vector<uint8_t>& bytes)
+	{
+		WriteValue(stream, static_cast<uint64_t>(bytes.size()));
+		stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	}
+	void ReadBytes(std::istream& stream, std::vector<uint8_t>& bytes)
+	{
+		uint64_t size{ 0 };
+		ReadValue(stream, size);
+		bytes.resize(size);
+		stream.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(size));
+	}
+
+	void WriteSceneToStream(std::ostream& stream, const Scene& scene)
+	{
+		WriteValue(stream, static_cast<uint32_t>(scene.meshes.size()));
+		for (const SceneMesh& mesh : scene.meshes)
+		{
+			WriteValue(stream, static_cast<uint32_t>(mesh.name.size()));
+			stream.write(mesh.name.data(), static_cast<std::streamsize>(mesh.name.size()));
+
+			WriteValue(stream, static_cast<uint32_t>(mesh.vertexBufferInfo.vertexAttribLayout.size()));
+			for (const VertexAttribDescriptor& attrib : mesh.vertexBufferInfo.vertexAttribLayout)
+			{
+				WriteValue(stream, attrib.dimension);
+				WriteValue(stream, attrib.offset);
+				WriteValue(stream, attrib.type);
+				WriteValue(stream, attrib.format);
+			}
+			WriteValue(stream, mesh.vertexBufferInfo.vertexCount);
+			WriteValue(stream, mesh.vertexBufferInfo.vertexStride);
+			WriteValue(stream, mesh.indexBufferInfo.indexCount);
+			WriteValue(stream, mesh.indexBufferInfo.indexFormat);
+
+			WriteBytes(stream, mesh.vertexData);
+			WriteBytes(stream, mesh.indexData);
+		}
+
+		WriteValue(stream, static_cast<uint32_t>(scene.nodes.size()));
+		for (const SceneNode& node : scene.nodes)
+		{
+			WriteValue(stream, node.transform);
+			WriteValue(stream, node.meshIndex);
+			WriteValue(stream, node.pipelineIndex);
+			WriteValue(stream, node.parentIndex);
+		}
+	}
+
+	Scene ReadSceneFromStream(std::istream& stream)
+	{
+		Scene scene{};
+
+		uint32_t count{ 0 };
+		ReadValue(stream, count);
+		scene.meshes.resize(count);
+		for (SceneMesh& mesh : scene.meshes)
+		{
+			ReadValue(stream, count);
+			mesh.name.resize(count);
+			stream.read(mesh.name.data(), count);
+
+			ReadValue(stream, count);
+			mesh.vertexBufferInfo.vertexAttribLayout.resize(count);
+			for (VertexAttribDescriptor& attrib : mesh.vertexBufferInfo.vertexAttribLayout)
+			{
+				ReadValue(stream, attrib.dimension);
+				ReadValue(stream, attrib.offset);
+				ReadValue(stream, attrib.type);
+				ReadValue(stream, attrib.format);
+			}
+			ReadValue(stream, mesh.vertexBufferInfo.vertexCount);
+			ReadValue(stream, mesh.vertexBufferInfo.vertexStride);
+			ReadValue(stream, mesh.indexBufferInfo.indexCount);
+			ReadValue(stream, mesh.indexBufferInfo.indexFormat);
+
+			ReadBytes(stream, mesh.vertexData);
+			ReadBytes(stream, mesh.indexData);
+		}
+
+		ReadValue(stream, count);
+		scene.nodes.resize(count);
+		for (SceneNode& node : scene.nodes)
+		{
+			ReadValue(stream, node.transform);
+			ReadValue(stream, node.meshIndex);
+			ReadValue(stream, node.pipelineIndex);
+			ReadValue(stream, node.parentIndex);
+		}
+
+		if (!stream)
+			throw Error{ "Scene stream is truncated!" };
+		return scene;
+	}
+
+	// What a loader does with a scene: looks at every mesh name, buffer info and node.
+	uint64_t VisitScene(const SerializedScene& scene)
+	{
+		uint64_t sum{ 0 };
+		for (const SerializedMesh& mesh : scene.meshes)
+			sum += mesh.name.View().size() + mesh.vertexBufferInfo.vertexCount + mesh.indexData.Size() + mesh.vertexData[5];
+		for (const SerializedSceneNode& node : scene.nodes)
+			sum += node.meshIndex;
+		return sum;
+	}
+	uint64_t VisitScene(const Scene& scene)
+	{
+		uint64_t sum{ 0 };
+		for (const SceneMesh& mesh : scene.meshes)
+			sum += mesh.name.size() + mesh.vertexBufferInfo.vertexCount + mesh.indexData.size() + mesh.vertexData[5];
+		for (const SceneNode& node : scene.nodes)
+			sum += node.meshIndex;
+		return sum;
+	}
+
+	void WriteFile(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+	{
+		std::ofstream file(path, std::ofstream::binary);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+}
+
+TEST_CASE(SceneSerializerRoundTrip)
+{
+	Scene scene = CreateScene(20, 50, 100);
+	std::vector<uint8_t> data = SerializeScene(scene);
+
+	const SerializedScene* serializedScene = OpenBinary<SerializedScene>(data.data(), data.size());
+	TEST_CHECK(serializedScene->meshes.Size() == 20 && serializedScene->nodes.Size() == 50);
+
+	for (uint32_t meshIndex = 0; meshIndex < 20; meshIndex++)
+	{
+		const SceneMesh& mesh = scene.meshes[meshIndex];
+		const SerializedMesh& serializedMesh = serializedScene->meshes[meshIndex];
+
+		TEST_CHECK(serializedMesh.name.View() == mesh.name);
+		TEST_CHECK(reinterpret_cast<uintptr_t>(serializedMesh.vertexData.Data()) % 16 == 0);
+		TEST_CHECK(std::equal(mesh.vertexData.begin(), mesh.vertexData.end(), serializedMesh.vertexData.begin(), serializedMesh.vertexData.end()));
+		TEST_CHECK(std::equal(mesh.indexData.begin(), mesh.indexData.end(), serializedMesh.indexData.begin(), serializedMesh.indexData.end()));
+
+		VertexBufferInfo vertexBufferInfo = ToVertexBufferInfo(serializedMesh.vertexBufferInfo);
+		TEST_CHECK(vertexBufferInfo.vertexCount == mesh.vertexBufferInfo.vertexCount && vertexBufferInfo.vertexStride == 32);
+		TEST_CHECK(vertexBufferInfo.vertexAttribLayout.size() == 3);
+		TEST_CHECK(vertexBufferInfo.vertexAttribLayout[2].offset == 24 && vertexBufferInfo.vertexAttribLayout[2].type == VertexAttribType::UV);
+		TEST_CHECK(ToIndexBufferInfo(serializedMesh.indexBufferInfo).indexFormat == mesh.indexBufferInfo.indexFormat);
+	}
+
+	for (uint32_t nodeIndex = 0; nodeIndex < 50; nodeIndex++)
+	{
+		const SerializedSceneNode& node = serializedScene->nodes[nodeIndex];
+		TEST_CHECK(node.transform.m[0][0] == scene.nodes[nodeIndex].transform.m[0][0]);
+		TEST_CHECK(node.meshIndex == scene.nodes[nodeIndex].meshIndex && node.parentIndex == scene.nodes[nodeIndex].parentIndex);
+	}
+
+	// The stream baseline of the benchmark reads back the same scene.
+	std::stringstream stream;
+	WriteSceneToStream(stream, scene);
+	TEST_CHECK(VisitScene(ReadSceneFromStream(stream)) == VisitScene(*serializedScene));
+}
+
+// Any truncation, another version and indices out of range are rejected when the file is opened,
+// so nothing has to be checked while reading it.
+TEST_CASE(SceneSerializerRejectsCorruptFiles)
+{
+	Scene scene = CreateScene(3, 3, 2);
+	std::vector<uint8_t> data = SerializeScene(scene);
+
+	for (size_t size = 0; size < data.size(); size++)
+		TEST_CHECK_THROWS(OpenBinary<SerializedScene>(data.data(), size), Error);
+
+	std::vector<uint8_t> newerVersion = data;
+	reinterpret_cast<BinaryFileHeader*>(newerVersion.data())->schemaVersion = SerializedScene::SCHEMA_VERSION + 1;
+	TEST_CHECK_THROWS(OpenBinary<SerializedScene>(newerVersion.data(), newerVersion.size()), Error);
+
+	std::vector<uint8_t> otherSchema = data;
+	reinterpret_cast<BinaryFileHeader*>(otherSchema.data())->schemaId = MakeBinarySchemaId('P', 'S', 'O', 'L');
+	TEST_CHECK_THROWS(OpenBinary<SerializedScene>(otherSchema.data(), otherSchema.size()), Error);
+
+	scene.nodes[2].meshIndex = 3;
+	std::vector<uint8_t> badMeshIndex = SerializeScene(scene);
+	TEST_CHECK_THROWS(OpenBinary<SerializedScene>(badMeshIndex.data(), badMeshIndex.size()), Error);
+
+	scene.nodes[2].meshIndex = 0;
+	scene.nodes[1].parentIndex = 2;
+	std::vector<uint8_t> childBeforeParent = SerializeScene(scene);
+	TEST_CHECK_THROWS(OpenBinary<SerializedScene>(childBeforeParent.data(), childBeforeParent.size()), Error);
+}
+
+// A scene of 1000 meshes and 5000 nodes (about 42 MB), saved and loaded with the binary format and
+// with a stream serializer that writes and reads field by field. Loading ends once every mesh and
+// node has been looked at: the binary file is mapped and validated, the stream is parsed into a
+// Scene. The files were just written, so they come from the page cache.
+BENCHMARK_CASE(SceneSerializerAgainstStreams)
+{
+	Scene scene = CreateScene(1000, 5000, 1000);
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "dxe-serialization-bench";
+	std::filesystem::create_directories(directory);
+	std::filesystem::path binaryPath = directory / "scene.bin";
+	std::filesystem::path streamPath = directory / "scene.stream";
+
+	std::vector<uint8_t> data = SerializeScene(scene);
+	double megabytes = data.size() / 1.0e6;
+	ReportMetric("file size", megabytes, "MB");
+
+	auto reportMilliseconds = [&](const std::string& label, double nanoseconds) {
+		ReportMetric(label, nanoseconds * 1.0e-6, "ms");
+	};
+
+	reportMilliseconds("save, binary", MeasureNanosecondsPerItem(1, [&]() {
+		WriteFile(binaryPath, SerializeScene(scene));
+	}, 3));
+	reportMilliseconds("save, stream", MeasureNanosecondsPerItem(1, [&]() {
+		std::ofstream file(streamPath, std::ofstream::binary);
+		WriteSceneToStream(file, scene);
+	}, 3));
+
+	reportMilliseconds("load file, binary (map + validate)", MeasureNanosecondsPerItem(1, [&]() {
+		MappedBinaryFile<SerializedScene> file{};
+		file.Open(binaryPath);
+		KeepValue(VisitScene(file.GetRoot()));
+	}, 3));
+	reportMilliseconds("load file, stream", MeasureNanosecondsPerItem(1, [&]() {
+		std::ifstream file(streamPath, std::ifstream::binary);
+		KeepValue(VisitScene(ReadSceneFromStream(file)));
+	}, 3));
+
+	// From memory, without the file system: validation against parsing. The stream starts with a copy
+	// of the data, as it would after reading the file.
+	std::stringstream stream;
+	WriteSceneToStream(stream, scene);
+	std::string streamData = stream.str();
+
+	reportMilliseconds("load memory, binary (validate)", MeasureNanosecondsPerItem(1, [&]() {
+		KeepValue(VisitScene(*OpenBinary<SerializedScene>(data.data(), data.size())));
+	}));
+	reportMilliseconds("load memory, stream", MeasureNanosecondsPerItem(1, [&]() {
+		std::istringstream memoryStream(streamData);
+		KeepValue(VisitScene(ReadSceneFromStream(memoryStream)));
+	}, 3));
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace dxe
+{
+	// The "loader threads" of the streamer tests' recording loaders: loads finish 'loadFrames'
+	// frames after they begin and every 'failEvery'-th one fails (0 for none). 'Load' is whatever
+	// the loader needs to report a load to its streamer.
+	template <typename Load>
+	class DelayedLoadQueue
+	{
+	public:
+
+		bool HasPendingLoads() const
+		{
+			return !pendingLoads.empty();
+		}
+
+		uint32_t loadFrames{ 3 };
+		uint32_t failEvery{ 0 };
+
+		uint32_t failureCount{ 0 };
+
+	protected:
+
+		void PushLoad(const Load& load)
+		{
+			pendingLoads.push_back(PendingLoad{ load, frame + loadFrames });
+		}
+
+		// Calls 'complete(load, succeeded)' for the loads due this frame, then starts the next frame.
+		template <typename CompleteFunction>
+		void CompleteDueLoads(CompleteFunction complete)
+		{
+			while (!pendingLoads.empty() && pendingLoads.front().completionFrame <= frame)
+			{
+				Load load = pendingLoads.front().load;
+				pendingLoads.pop_front();
+
+				bool succeeded = failEvery == 0 || ++completionCount % failEvery != 0;
+				if (!succeeded)
+					failureCount++;
+
+				complete(load, succeeded);
+			}
+			frame++;
+		}
+
+	private:
+
+		struct PendingLoad
+		{
+			Load load{};
+			uint64_t completionFrame{ 0 };
+		};
+
+		std::deque<PendingLoad> pendingLoads;
+		uint64_t frame{ 0 };
+		uint32_t completionCount{ 0 };
+	};
+}
@@ -0,0 +1,173 @@
+#include "Test/Dx12TestDevice.h"
+#include "Test/Test.h"
+
+#include "GpuApi/Dx12/Dx12Fence.h"
+#include "GpuApi/Dx12/Dx12GeometryBuffer.h"
+#include "GpuApi/Dx12/Dx12HeapAllocator.h"
+#include "GpuApi/Dx12/Dx12Queue.h"
+#include "GpuApi/Dx12/Dx12UploadQueue.h"
+#include "GpuApi/Dx12/Dx12UploadRing.h"
+
+#include "Core/ThreadPool.h"
+#include "Streaming/Dx12/Dx12MeshLodLoader.h"
+#include "Streaming/MeshLodStreamer.h"
+
+#include <chrono>
+#include <thread>
+
+using namespace dxe;
+
+// Progressive meshes streamed into a geometry buffer on the WARP device. The "drawing" queue is a
+// fence the test signals from the CPU, so freed ranges are reused exactly when the test decides.
+
+namespace
+{
+	constexpr uint32_t TEST_VERTEX_STRIDE = 16;
+	constexpr uint32_t TEST_LOD_COUNT = 3;
+
+	// LOD 'lodIndex' appends 8 << lodIndex vertices and twice as many triangles, indexing every
+	// vertex of the LODs up to it.
+	Dx12MeshLodData CreateLodData(uint32_t lodIndex)
+	{
+		uint32_t firstVertex = (8u << lodIndex) - 8;
+		uint32_t vertexCount = 8u << lodIndex;
+
+		Dx12MeshLodData lodData{};
+		lodData.vertices.assign(vertexCount * TEST_VERTEX_STRIDE, static_cast<uint8_t>(lodIndex + 1));
+		for (uint32_t i = 0; i < 6 * vertexCount; i++)
+			lodData.indices.push_back((i * 7) % (firstVertex + vertexCount));
+		return lodData;
+	}
+
+	uint64_t GetLodGpuBytes(uint32_t lodIndex)
+	{
+		Dx12MeshLodData lodData = CreateLodData(lodIndex);
+		return lodData.vertices.size() + lodData.indices.size() * sizeof(uint32_t);
+	}
+
+	// Vertex and index counts of the LODs up to 'lodIndex'.
+	uint64_t GetVertexCount(uint32_t lodIndex)
+	{
+		return (8ull << (lodIndex + 1)) - 8;
+	}
+	uint64_t GetIndexCount(uint32_t lodIndex)
+	{
+		return 6 * GetVertexCount(lodIndex);
+	}
+}
+
+TEST_CASE(Dx12MeshLodLoaderAppendsAndEvictsLods)
+{
+	ID3D12Device* device = GetTestDevice();
+
+	Dx12CopyQueue copyQueue;
+	copyQueue.InitializeCommandQueue(device);
+
+	Dx12HeapAllocator uploadHeapAllocator{ device, D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, 4ull * 1024 * 1024 };
+	Dx12HeapAllocator defaultHeapAllocator{ device, D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, 4ull * 1024 * 1024 };
+
+	Dx12UploadRing uploadRing{ device, &uploadHeapAllocator, copyQueue.GetQueueFence(), 1024 * 1024 };
+	UploadBatcherDesc batcherDesc{};
+	batcherDesc.maxBatchSize = 256 * 1024;
+	batcherDesc.maxCopySize = 256 * 1024;
+	Dx12UploadQueue uploadQueue{ device, &copyQueue, &uploadRing, batcherDesc };
+
+	Dx12Fence drawFence;
+	drawFence.Initialize(device);
+
+	Dx12GeometryBuffer geometryBuffer{ device, &defaultHeapAllocator, &uploadQueue, &drawFence, 4096 };
+	geometryBuffer.CreateVertexBuffer(TEST_VERTEX_STRIDE, 1024);
+
+	ThreadPool threadPool{ 2 };
+	Dx12MeshLodLoader lodLoader{ &geometryBuffer, &threadPool };
+	MeshLodStreamer lodStreamer{ MeshLodStreamerSettings{}, &lodLoader };
+	lodLoader.SetStreamer(&lodStreamer);
+
+	std::vector<StreamingMeshLod> lods(TEST_LOD_COUNT);
+	for (uint32_t lodIndex = 0; lodIndex < TEST_LOD_COUNT; lodIndex++)
+	{
+		lods[lodIndex].gpuBytes = GetLodGpuBytes(lodIndex);
+		lods[lodIndex].geometricError = static_cast<float>(TEST_LOD_COUNT - 1 - lodIndex);
+	}
+
+	auto source = [](uint32_t lodIndex, Dx12MeshLodData& lodData) {
+		lodData = CreateLodData(lodIndex);
+		return true;
+	};
+
+	const DirectX::XMFLOAT3 cameraPosition{ 0.0f, 0.0f, 0.0f };
+	MeshLodStreamer::MeshId first = lodStreamer.AddMesh(DirectX::XMFLOAT3{ 0.0f, 0.0f, 5.0f }, 1.0f, lods);
+	MeshLodStreamer::MeshId second = lodStreamer.AddMesh(DirectX::XMFLOAT3{ 0.0f, 0.0f, 6.0f }, 1.0f, lods);
+	lodLoader.AddMesh(first, TEST_VERTEX_STRIDE, source);
+	lodLoader.AddMesh(second, TEST_VERTEX_STRIDE, source);
+
+	TEST_CHECK(lodStreamer.GetDrawLod(first) == UINT32_MAX);
+	TEST_CHECK(lodLoader.GetGeometryId(first) == DX12_INVALID_GEOMETRY_ID);
+
+	// Loads finish on the pool, uploads happen in the following Updates.
+	for (uint32_t frame = 0; frame < 10000; frame++)
+	{
+		lodStreamer.Update(cameraPosition);
+		if (lodStreamer.GetMesh(first).residentLodCount == TEST_LOD_COUNT &&
+			lodStreamer.GetMesh(second).residentLodCount == TEST_LOD_COUNT)
+			break;
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+	}
+
+	for (MeshLodStreamer::MeshId meshId : { first, second })
+	{
+		TEST_CHECK(lodStreamer.GetMesh(meshId).residentLodCount == TEST_LOD_COUNT);
+		TEST_CHECK(lodStreamer.GetDrawLod(meshId) == TEST_LOD_COUNT - 1);
+
+		// Every LOD draws the front of the mesh's ranges.
+		Dx12GeometryRange meshRange = geometryBuffer.GetRange(lodLoader.GetGeometryId(meshId));
+		for (uint32_t lodIndex = 0; lodIndex < TEST_LOD_COUNT; lodIndex++)
+		{
+			Dx12GeometryRange lodRange = lodLoader.GetLodRange(meshId, lodIndex);
+			TEST_CHECK(lodRange.vertexStride == TEST_VERTEX_STRIDE);
+			TEST_CHECK(lodRange.baseVertex == meshRange.baseVertex && lodRange.firstIndex == meshRange.firstIndex);
+			TEST_CHECK(lodRange.vertexCount == GetVertexCount(lodIndex) && lodRange.indexCount == GetIndexCount(lodIndex));
+		}
+		TEST_CHECK(meshRange.vertexCount == GetVertexCount(TEST_LOD_COUNT - 1));
+		TEST_CHECK(meshRange.indexCount == GetIndexCount(TEST_LOD_COUNT - 1));
+	}
+
+	// The meshes' ranges don't overlap.
+	Dx12GeometryRange firstRange = geometryBuffer.GetRange(lodLoader.GetGeometryId(first));
+	Dx12GeometryRange secondRange = geometryBuffer.GetRange(lodLoader.GetGeometryId(second));
+	TEST_CHECK(firstRange.baseVertex + firstRange.vertexCount <= static_cast<uint32_t>(secondRange.baseVertex) ||
+		secondRange.baseVertex + secondRange.vertexCount <= static_cast<uint32_t>(firstRange.baseVertex));
+	TEST_CHECK(firstRange.firstIndex + firstRange.indexCount <= secondRange.firstIndex ||
+		secondRange.firstIndex + secondRange.indexCount <= firstRange.firstIndex);
+
+	// Room for LODs 0 and 1 only: the finest LODs go.
+	lodStreamer.SetGpuBudgetBytes(2 * (GetLodGpuBytes(0) + GetLodGpuBytes(1)));
+	lodStreamer.Update(cameraPosition);
+	TEST_CHECK(lodStreamer.GetFrameStats().evictions == 2);
+
+	for (MeshLodStreamer::MeshId meshId : { first, second })
+	{
+		TEST_CHECK(lodStreamer.GetDrawLod(meshId) == 1);
+		Dx12GeometryRange lodRange = lodLoader.GetLodRange(meshId, 1);
+		TEST_CHECK(lodRange.vertexCount == GetVertexCount(1) && lodRange.indexCount == GetIndexCount(1));
+
+		Dx12GeometryRange meshRange = geometryBuffer.GetRange(lodLoader.GetGeometryId(meshId));
+		TEST_CHECK(meshRange.vertexCount == GetVertexCount(1) && meshRange.indexCount == GetIndexCount(1));
+	}
+
+	// The evicted tails (and ranges left behind by meshes that moved to grow) stay allocated until
+	// the frames that may draw them are done.
+	const uint64_t residentVertexCount = 2 * GetVertexCount(1);
+	const uint64_t residentIndexCount = 2 * GetIndexCount(1);
+	geometryBuffer.Retire();
+	TEST_CHECK(geometryBuffer.GetVertexStatistics(TEST_VERTEX_STRIDE).usedSize > residentVertexCount);
+	TEST_CHECK(geometryBuffer.GetIndexStatistics().usedSize > residentIndexCount);
+
+	drawFence.SignalOnCpu();
+	geometryBuffer.Retire();
+	TEST_CHECK(geometryBuffer.GetVertexStatistics(TEST_VERTEX_STRIDE).usedSize == residentVertexCount);
+	TEST_CHECK(geometryBuffer.GetIndexStatistics().usedSize == residentIndexCount);
+
+	// The copies have to be done before the buffers go.
+	copyQueue.GetQueueFence()->WaitForValue(uploadQueue.Flush());
+}
@@ -0,0 +1,433 @@
+#include "Test/Test.h"
+
+#include "DelayedLoadQueue.h"
+
+#include "Streaming/CameraPath.h"
+#include "Streaming/MeshLodStreamer.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace dxe;
+
+namespace
+{
+	struct LodLoad
+	{
+		MeshLodStreamer::MeshId meshId{ 0 };
+		uint32_t lodIndex{ 0 };
+	};
+
+	// Checks that the streamer only appends and drops LODs on top of the ones the mesh holds.
+	class RecordingLodLoader : public MeshLodLoader, public DelayedLoadQueue<LodLoad>
+	{
+	public:
+
+		void BeginLoad(const StreamingMesh& mesh, uint32_t lodIndex) override
+		{
+			MeshData& data = GetMeshData(mesh.id);
+			TEST_CHECK(data.state == StreamingLodState::UNLOADED && lodIndex == data.residentLodCount);
+
+			// No finer LOD while a mesh still waits for its LOD 0.
+			if (lodIndex > 0 && streamer)
+			{
+				for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer->GetMeshCount(); meshId++)
+				{
+					const StreamingMesh& other = streamer->GetMesh(meshId);
+					TEST_CHECK(other.residentLodCount > 0 || other.pendingLodState != StreamingLodState::UNLOADED);
+				}
+			}
+
+			data.state = StreamingLodState::LOADING;
+			PushLoad(LodLoad{ mesh.id, lodIndex });
+			beginLoadCount++;
+		}
+		void Upload(const StreamingMesh& mesh, uint32_t lodIndex) override
+		{
+			MeshData& data = GetMeshData(mesh.id);
+			TEST_CHECK(data.state == StreamingLodState::LOADED && lodIndex == data.residentLodCount);
+			data.state = StreamingLodState::UNLOADED;
+			data.residentLodCount++;
+			uploadCount++;
+		}
+		void Evict(const StreamingMesh& mesh, uint32_t lodIndex) override
+		{
+			MeshData& data = GetMeshData(mesh.id);
+			TEST_CHECK(data.state == StreamingLodState::UNLOADED && lodIndex > 0 && lodIndex + 1 == data.residentLodCount);
+			data.residentLodCount--;
+			evictCount++;
+		}
+
+		// Reports the loads due this frame.
+		void CompleteLoads(MeshLodStreamer& lodStreamer)
+		{
+			CompleteDueLoads([&](const LodLoad& load, bool succeeded) {
+				GetMeshData(load.meshId).state = succeeded ? StreamingLodState::LOADED : StreamingLodState::UNLOADED;
+				lodStreamer.OnLodLoaded(load.meshId, load.lodIndex, succeeded);
+			});
+		}
+
+		uint32_t GetResidentLodCount(MeshLodStreamer::MeshId meshId)
+		{
+			return GetMeshData(meshId).residentLodCount;
+		}
+
+		// Set to check the LOD 0 first rule.
+		const MeshLodStreamer* streamer{ nullptr };
+
+		uint32_t beginLoadCount{ 0 };
+		uint32_t uploadCount{ 0 };
+		uint32_t evictCount{ 0 };
+
+	private:
+
+		struct MeshData
+		{
+			uint32_t residentLodCount{ 0 };
+			StreamingLodState state{ StreamingLodState::UNLOADED };
+		};
+
+		MeshData& GetMeshData(MeshLodStreamer::MeshId meshId)
+		{
+			if (meshId >= meshData.size())
+				meshData.resize(meshId + 1);
+			return meshData[meshId];
+		}
+
+		std::vector<MeshData> meshData;
+	};
+
+	// Every LOD has 4 times the bytes and half the error of the one before.
+	std::vector<StreamingMeshLod> CreateLods(uint32_t lodCount, uint64_t lod0Bytes, float lod0Error)
+	{
+		std::vector<StreamingMeshLod> lods;
+		for (uint32_t lodIndex = 0; lodIndex < lodCount; lodIndex++)
+			lods.push_back(StreamingMeshLod{ lod0Bytes << (2 * lodIndex), lod0Error / static_cast<float>(1u << lodIndex) });
+		return lods;
+	}
+
+	uint64_t GetLodBytes(const StreamingMesh& mesh, uint32_t lodCount)
+	{
+		uint64_t bytes{ 0 };
+		for (uint32_t lodIndex = 0; lodIndex < lodCount; lodIndex++)
+			bytes += mesh.lods[lodIndex].gpuBytes;
+		return bytes;
+	}
+
+	// Committed bytes are those of the resident LODs and the one in flight, of every mesh.
+	void CheckCommittedBytes(const MeshLodStreamer& streamer, RecordingLodLoader& loader)
+	{
+		uint64_t gpuBytes{ 0 };
+
+		for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		{
+			const StreamingMesh& mesh = streamer.GetMesh(meshId);
+			TEST_CHECK(mesh.residentLodCount == loader.GetResidentLodCount(meshId));
+
+			uint32_t lodCount = mesh.residentLodCount;
+			if (mesh.pendingLodState != StreamingLodState::UNLOADED)
+				lodCount++;
+			gpuBytes += GetLodBytes(mesh, lodCount);
+		}
+
+		TEST_CHECK(streamer.GetGpuCommittedBytes() == gpuBytes);
+	}
+
+	// LOD 0 of every mesh and all LODs of meshes with a load in flight can't be evicted; the rest has
+	// to fit into the budget.
+	void CheckBudget(const MeshLodStreamer& streamer, uint64_t gpuBudgetBytes)
+	{
+		uint64_t pinnedBytes{ 0 };
+
+		for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		{
+			const StreamingMesh& mesh = streamer.GetMesh(meshId);
+			if (mesh.pendingLodState != StreamingLodState::UNLOADED)
+				pinnedBytes += GetLodBytes(mesh, mesh.residentLodCount + 1);
+			else
+				pinnedBytes += GetLodBytes(mesh, std::min(mesh.residentLodCount, 1u));
+		}
+
+		TEST_CHECK(streamer.GetGpuCommittedBytes() <= std::max(gpuBudgetBytes, pinnedBytes));
+	}
+
+	// The coarsest LOD count whose projected error is within the threshold, see 'MeshLodStreamerSettings'.
+	uint32_t GetExpectedLodCount(
+		const MeshLodStreamerSettings& settings, const StreamingMesh& mesh, const DirectX::XMFLOAT3& cameraPosition)
+	{
+		float dx = mesh.boundsCenter.x - cameraPosition.x;
+		float dy = mesh.boundsCenter.y - cameraPosition.y;
+		float dz = mesh.boundsCenter.z - cameraPosition.z;
+		float distance = std::max(std::sqrt(dx * dx + dy * dy + dz * dz) - mesh.boundsRadius, settings.nearDistance);
+		float projectionScale = settings.viewportHeight / (2.0f * std::tan(settings.verticalFieldOfView * 0.5f));
+
+		uint32_t lodCount = static_cast<uint32_t>(mesh.lods.size());
+		for (uint32_t count = 1; count < lodCount; count++)
+		{
+			if (mesh.lods[count - 1].geometricError * projectionScale / distance <= settings.maxScreenSpaceError)
+				return count;
+		}
+		return lodCount;
+	}
+}
+
+
+// Close meshes want every LOD, but with few loads in flight and some of them failing, all LOD 0s go
+// first; the loader checks that on every finer load.
+TEST_CASE(MeshLodStreamerLodZeroFirst)
+{
+	MeshLodStreamerSettings settings{};
+	settings.maxLoadsInFlight = 3;
+
+	RecordingLodLoader loader;
+	loader.loadFrames = 2;
+	loader.failEvery = 5;
+
+	MeshLodStreamer streamer{ settings, &loader };
+	loader.streamer = &streamer;
+
+	for (uint32_t i = 0; i < 40; i++)
+	{
+		float angle = i * DirectX::XM_2PI / 40.0f;
+		streamer.AddMesh({ 102.0f * std::cos(angle), 0.0f, 102.0f * std::sin(angle) }, 2.0f, CreateLods(5, 16 * 1024, 1.0f));
+	}
+
+	const DirectX::XMFLOAT3 cameraPosition{ 0.0f, 0.0f, 0.0f };
+	streamer.Update(cameraPosition);
+	TEST_CHECK(streamer.GetFrameStats().loadsIssued == 3 && streamer.GetFrameStats().undrawableMeshes == 40);
+	for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		TEST_CHECK(streamer.GetDrawLod(meshId) == UINT32_MAX && streamer.GetMesh(meshId).desiredLodCount == 5);
+
+	for (uint32_t frame = 0; frame < 600; frame++)
+	{
+		loader.CompleteLoads(streamer);
+		streamer.Update(cameraPosition);
+		CheckCommittedBytes(streamer, loader);
+	}
+
+	TEST_CHECK(loader.failureCount > 0 && !loader.HasPendingLoads());
+	TEST_CHECK(loader.beginLoadCount == loader.uploadCount + loader.failureCount);
+	TEST_CHECK(streamer.GetFrameStats().undrawableMeshes == 0 && streamer.GetFrameStats().meshesAboveErrorThreshold == 0);
+	for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		TEST_CHECK(streamer.GetMesh(meshId).residentLodCount == 5 && streamer.GetDrawLod(meshId) == 4);
+}
+
+// The camera flies at a row of meshes: the LODs each one asks for follow its projected error, and
+// nothing finer than that is loaded.
+TEST_CASE(MeshLodStreamerApproach)
+{
+	MeshLodStreamerSettings settings{};
+
+	RecordingLodLoader loader;
+	MeshLodStreamer streamer{ settings, &loader };
+	for (float z : { 0.0f, 1000.0f, 2000.0f })
+		streamer.AddMesh({ 0.0f, 0.0f, z }, 5.0f, CreateLods(5, 64 * 1024, 4.0f));
+
+	CameraPath path{ { { 0.0f, 0.0f, -8000.0f }, { 0.0f, 0.0f, -10.0f } }, 100.0f };
+
+	std::vector<uint32_t> desiredLodCounts(streamer.GetMeshCount(), 0);
+	uint32_t frameCount = static_cast<uint32_t>(path.GetDuration() * 60.0f) + 60;
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		DirectX::XMFLOAT3 cameraPosition = path.Sample(frame / 60.0f);
+		loader.CompleteLoads(streamer);
+		streamer.Update(cameraPosition);
+		CheckCommittedBytes(streamer, loader);
+
+		for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		{
+			const StreamingMesh& mesh = streamer.GetMesh(meshId);
+			TEST_CHECK(mesh.desiredLodCount == GetExpectedLodCount(settings, mesh, cameraPosition));
+
+			// Getting closer only ever asks for more, and what was asked for before is still wanted.
+			TEST_CHECK(mesh.desiredLodCount >= desiredLodCounts[meshId]);
+			desiredLodCounts[meshId] = mesh.desiredLodCount;
+
+			uint32_t requestedLodCount = mesh.residentLodCount;
+			if (mesh.pendingLodState != StreamingLodState::UNLOADED)
+				requestedLodCount++;
+			TEST_CHECK(requestedLodCount <= std::max(mesh.desiredLodCount, 1u));
+
+			if (mesh.residentLodCount > 0)
+				TEST_CHECK(streamer.GetDrawLod(meshId) == std::min(mesh.desiredLodCount, mesh.residentLodCount) - 1);
+
+			// Closer meshes need at least as much detail.
+			if (meshId > 0)
+				TEST_CHECK(mesh.desiredLodCount <= streamer.GetMesh(meshId - 1).desiredLodCount);
+		}
+
+		// Far away, LOD 0 is all there is to see.
+		if (frame < 60)
+			TEST_CHECK(streamer.GetMesh(0).desiredLodCount == 1);
+	}
+
+	TEST_CHECK(streamer.GetMesh(0).residentLodCount == 5 && streamer.GetDrawLod(0) == 4);
+	TEST_CHECK(streamer.GetMesh(2).residentLodCount == 3 && streamer.GetDrawLod(2) == 2);
+	TEST_CHECK(streamer.GetStats().totalEvictedBytes == 0);
+}
+
+// A lower budget is evicted down to on the very next Update, least useful LODs first, and no further
+// than LOD 0.
+TEST_CASE(MeshLodStreamerBudget)
+{
+	const uint64_t MB = 1024 * 1024;
+
+	MeshLodStreamerSettings settings{};
+	settings.gpuBudgetBytes = 256 * MB;
+
+	RecordingLodLoader loader;
+	loader.loadFrames = 1;
+
+	MeshLodStreamer streamer{ settings, &loader };
+	for (uint32_t i = 0; i < 20; i++)
+		streamer.AddMesh({ 0.0f, 0.0f, 10.0f + 10.0f * i }, 2.0f, CreateLods(5, 16 * 1024, 4.0f));
+
+	const DirectX::XMFLOAT3 cameraPosition{ 0.0f, 0.0f, 0.0f };
+	auto runFrames = [&](uint32_t frameCount, uint64_t gpuBudgetBytes) {
+		for (uint32_t frame = 0; frame < frameCount; frame++)
+		{
+			loader.CompleteLoads(streamer);
+			streamer.Update(cameraPosition);
+			CheckCommittedBytes(streamer, loader);
+			CheckBudget(streamer, gpuBudgetBytes);
+		}
+	};
+
+	runFrames(200, settings.gpuBudgetBytes);
+	TEST_CHECK(!loader.HasPendingLoads() && streamer.GetGpuCommittedBytes() > 100 * MB);
+	for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		TEST_CHECK(streamer.GetMesh(meshId).residentLodCount == 5);
+
+	streamer.SetGpuBudgetBytes(40 * MB);
+	streamer.Update(cameraPosition);
+	CheckCommittedBytes(streamer, loader);
+	TEST_CHECK(streamer.GetGpuCommittedBytes() <= 40 * MB && !streamer.GetFrameStats().gpuBudgetExceeded);
+	TEST_CHECK(streamer.GetFrameStats().evictions > 0);
+
+	// The farthest meshes lose most, the closest keep their finest LODs.
+	TEST_CHECK(streamer.GetMesh(0).residentLodCount == 5 && streamer.GetMesh(19).residentLodCount < 5);
+	for (MeshLodStreamer::MeshId meshId = 1; meshId < streamer.GetMeshCount(); meshId++)
+		TEST_CHECK(streamer.GetMesh(meshId).residentLodCount <= streamer.GetMesh(meshId - 1).residentLodCount);
+
+	// What doesn't fit stays out.
+	runFrames(60, 40 * MB);
+
+	// Below the LOD 0s, only they are left.
+	streamer.SetGpuBudgetBytes(100 * 1024);
+	streamer.Update(cameraPosition);
+	CheckCommittedBytes(streamer, loader);
+	TEST_CHECK(streamer.GetGpuCommittedBytes() == 20 * 16 * 1024 && streamer.GetFrameStats().gpuBudgetExceeded);
+	for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		TEST_CHECK(streamer.GetMesh(meshId).residentLodCount == 1 && streamer.GetDrawLod(meshId) == 0);
+
+	streamer.SetGpuBudgetBytes(settings.gpuBudgetBytes);
+	runFrames(200, settings.gpuBudgetBytes);
+	for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		TEST_CHECK(streamer.GetMesh(meshId).residentLodCount == 5);
+}
+
+// A failed load gives its bytes back; once the camera left, it isn't asked for again.
+TEST_CASE(MeshLodStreamerFailedLoads)
+{
+	MeshLodStreamerSettings settings{};
+
+	RecordingLodLoader loader;
+	loader.loadFrames = 0;
+
+	MeshLodStreamer streamer{ settings, &loader };
+	MeshLodStreamer::MeshId meshId = streamer.AddMesh({ 0.0f, 0.0f, 0.0f }, 5.0f, CreateLods(3, 1024, 4.0f));
+	const StreamingMesh& mesh = streamer.GetMesh(meshId);
+
+	const DirectX::XMFLOAT3 close{ 0.0f, 0.0f, -10.0f };
+	const DirectX::XMFLOAT3 farAway{ 0.0f, 0.0f, -100000.0f };
+
+	// LOD 0 is uploaded in the frame it completes, LOD 1 begins on the next one.
+	streamer.Update(close);
+	loader.CompleteLoads(streamer);
+	streamer.Update(close);
+	TEST_CHECK(mesh.residentLodCount == 1 && streamer.GetGpuCommittedBytes() == 1024);
+	streamer.Update(close);
+	TEST_CHECK(mesh.residentLodCount == 1 && mesh.pendingLodState == StreamingLodState::LOADING);
+	TEST_CHECK(streamer.GetGpuCommittedBytes() == 1024 + 4096);
+
+	loader.failEvery = 1;
+	loader.CompleteLoads(streamer);
+	streamer.Update(farAway);
+	CheckCommittedBytes(streamer, loader);
+	TEST_CHECK(loader.failureCount == 1 && streamer.GetFrameStats().loadsIssued == 0);
+	TEST_CHECK(mesh.residentLodCount == 1 && mesh.pendingLodState == StreamingLodState::UNLOADED);
+	TEST_CHECK(streamer.GetGpuCommittedBytes() == 1024);
+
+	// Failing LOD 0 leaves nothing, and it's asked for again in the same Update.
+	MeshLodStreamer::MeshId otherId = streamer.AddMesh({ 0.0f, 0.0f, 0.0f }, 5.0f, CreateLods(3, 2048, 4.0f));
+	streamer.Update(farAway);
+	TEST_CHECK(streamer.GetGpuCommittedBytes() == 1024 + 2048);
+
+	loader.CompleteLoads(streamer);
+	streamer.Update(farAway);
+	CheckCommittedBytes(streamer, loader);
+	TEST_CHECK(loader.failureCount == 2 && loader.uploadCount == 1);
+	TEST_CHECK(streamer.GetMesh(otherId).pendingLodState == StreamingLodState::LOADING);
+	TEST_CHECK(streamer.GetGpuCommittedBytes() == 1024 + 2048);
+
+	loader.failEvery = 0;
+	loader.CompleteLoads(streamer);
+	streamer.Update(farAway);
+	TEST_CHECK(streamer.GetDrawLod(otherId) == 0 && streamer.GetGpuCommittedBytes() == 1024 + 2048);
+}
+
+// Meshes scattered over a map, a scripted camera flying over them, slow and failing loads and the
+// budget lowered halfway: the accounting holds and the budget is kept every frame.
+TEST_CASE(MeshLodStreamerCameraPath)
+{
+	const uint64_t MB = 1024 * 1024;
+
+	MeshLodStreamerSettings settings{};
+	settings.gpuBudgetBytes = 24 * MB;
+	settings.uploadBudgetBytesPerFrame = 2 * MB;
+
+	RecordingLodLoader loader;
+	loader.loadFrames = 4;
+	loader.failEvery = 9;
+
+	MeshLodStreamer streamer{ settings, &loader };
+	loader.streamer = &streamer;
+
+	std::mt19937 random{ 7 };
+	for (uint32_t i = 0; i < 300; i++)
+	{
+		float x = static_cast<float>(random() % 2000) - 1000.0f;
+		float z = static_cast<float>(random() % 2000) - 1000.0f;
+		uint32_t lodCount = 1 + random() % 5;
+		streamer.AddMesh({ x, 0.0f, z }, 5.0f, CreateLods(lodCount, 4 * 1024, 2.0f));
+	}
+
+	CameraPath path{ { { -1000.0f, 10.0f, -1000.0f }, { 1000.0f, 10.0f, 1000.0f }, { 1000.0f, 10.0f, -1000.0f }, { -1000.0f, 10.0f, 1000.0f } }, 50.0f };
+
+	uint64_t gpuBudgetBytes = settings.gpuBudgetBytes;
+	uint32_t frameCount = static_cast<uint32_t>(path.GetDuration() * 60.0f);
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		if (frame == frameCount / 2)
+		{
+			gpuBudgetBytes = 12 * MB;
+			streamer.SetGpuBudgetBytes(gpuBudgetBytes);
+		}
+
+		loader.CompleteLoads(streamer);
+		streamer.Update(path.Sample(frame / 60.0f));
+		CheckCommittedBytes(streamer, loader);
+		CheckBudget(streamer, gpuBudgetBytes);
+	}
+
+	// Everything uploaded and not evicted is resident.
+	uint64_t residentBytes{ 0 };
+	for (MeshLodStreamer::MeshId meshId = 0; meshId < streamer.GetMeshCount(); meshId++)
+		residentBytes += GetLodBytes(streamer.GetMesh(meshId), streamer.GetMesh(meshId).residentLodCount);
+
+	const MeshLodStreamerStats& stats = streamer.GetStats();
+	TEST_CHECK(stats.totalUploadedBytes - stats.totalEvictedBytes == residentBytes);
+	TEST_CHECK(stats.peakUploadBytesPerFrame <= settings.uploadBudgetBytesPerFrame);
+	TEST_CHECK(loader.failureCount > 0 && loader.evictCount > 0 && stats.errorFrameCount > 0);
+}
@@ -0,0 +1,289 @@
+#include "Test/Test.h"
+
+#include "Streaming/UploadBatcher.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+using namespace dxe;
+
+namespace
+{
+	using Buffer = std::vector<uint8_t>;
+
+	// Hands out staging memory from a ring, records the copies and "executes" them on submit, so the
+	// destination buffers hold what the GPU would have copied.
+	class RecordingBackend : public UploadBackend
+	{
+	public:
+
+		explicit RecordingBackend(uint64_t stagingCapacity)
+			: staging(stagingCapacity) {}
+
+		UploadStaging AllocateStaging(uint64_t size) override
+		{
+			TEST_CHECK(size <= staging.size());
+
+			if (stagingOffset + skipSize + size > staging.size())
+				stagingOffset = 0;
+			stagingOffset += skipSize;
+			skipSize = 0;
+
+			UploadStaging allocation{ staging.data() + stagingOffset, stagingOffset };
+			stagingOffset += size;
+			openBatchStagingSize += size;
+			return allocation;
+		}
+		void RecordCopy(const UploadCopy& copy) override
+		{
+			TEST_CHECK(copy.size > 0 && copy.stagingOffset + copy.size <= staging.size());
+			openBatch.push_back(copy);
+		}
+		uint64_t SubmitCopies() override
+		{
+			TEST_CHECK(!openBatch.empty());
+
+			for (const UploadCopy& copy : openBatch)
+			{
+				Buffer& destination = *static_cast<Buffer*>(copy.destination);
+				TEST_CHECK(copy.destinationOffset + copy.size <= destination.size());
+				memcpy(destination.data() + copy.destinationOffset, staging.data() + copy.stagingOffset, copy.size);
+			}
+
+			batches.push_back(openBatch);
+			batchStagingSizes.push_back(openBatchStagingSize);
+			openBatch.clear();
+			openBatchStagingSize = 0;
+
+			// Some other work was signaled on the queue in between.
+			fenceValue += 2;
+			return fenceValue;
+		}
+
+		// The next staging allocation isn't contiguous with the previous one.
+		void SkipStaging(uint64_t size)
+		{
+			skipSize = size;
+		}
+
+		std::vector<std::vector<UploadCopy>> batches;
+		std::vector<uint64_t> batchStagingSizes;
+		std::vector<UploadCopy> openBatch;
+		uint64_t fenceValue{ 100 };
+
+	private:
+
+		Buffer staging;
+		uint64_t stagingOffset{ 0 };
+		uint64_t skipSize{ 0 };
+		uint64_t openBatchStagingSize{ 0 };
+	};
+
+	Buffer CreateData(uint64_t size, uint32_t seed)
+	{
+		Buffer data(size);
+		for (uint64_t i = 0; i < size; i++)
+			data[i] = static_cast<uint8_t>(i * 7 + seed);
+		return data;
+	}
+
+	bool IsCopy(const UploadCopy& copy, const Buffer& destination, uint64_t destinationOffset, uint64_t size)
+	{
+		return copy.destination == &destination && copy.destinationOffset == destinationOffset && copy.size == size;
+	}
+}
+
+TEST_CASE(UploadBatcherMergesAdjacentCopies)
+{
+	RecordingBackend backend{ 1 << 20 };
+	UploadBatcher batcher{ &backend };
+
+	Buffer vertices(4096);
+	Buffer indices(4096);
+	Buffer data = CreateData(4096, 1);
+
+	// Contiguous in the destination and in staging memory.
+	batcher.Upload(&vertices, 0, data.data(), 100);
+	batcher.Upload(&vertices, 100, data.data() + 100, 200);
+	batcher.Upload(&vertices, 300, data.data() + 300, 50);
+	// A gap in the destination, another destination, a gap in staging memory.
+	batcher.Upload(&vertices, 400, data.data() + 400, 100);
+	batcher.Upload(&indices, 500, data.data() + 500, 100);
+	backend.SkipStaging(16);
+	batcher.Upload(&indices, 600, data.data() + 600, 100);
+
+	TEST_CHECK(batcher.HasOpenBatch());
+	batcher.Flush();
+
+	TEST_CHECK(backend.batches.size() == 1);
+	const std::vector<UploadCopy>& copies = backend.batches[0];
+	TEST_CHECK(copies.size() == 4);
+	TEST_CHECK(IsCopy(copies[0], vertices, 0, 350));
+	TEST_CHECK(IsCopy(copies[1], vertices, 400, 100));
+	TEST_CHECK(IsCopy(copies[2], indices, 500, 100));
+	TEST_CHECK(IsCopy(copies[3], indices, 600, 100));
+
+	UploadStatistics statistics = batcher.GetStatistics();
+	TEST_CHECK(statistics.uploadCount == 6 && statistics.uploadedBytes == 650);
+	TEST_CHECK(statistics.copyCount == 4 && statistics.mergedCopyCount == 2 && statistics.batchCount == 1);
+
+	TEST_CHECK(std::equal(vertices.begin(), vertices.begin() + 350, data.begin()));
+	TEST_CHECK(std::equal(indices.begin() + 500, indices.begin() + 700, data.begin() + 500));
+}
+
+// An upload larger than a copy is split; one larger than a batch spans batches.
+TEST_CASE(UploadBatcherSplitsLargeUploads)
+{
+	const uint64_t MB = 1024 * 1024;
+
+	UploadBatcherDesc desc{};
+	desc.maxBatchSize = 8 * MB;
+	desc.maxCopySize = 3 * MB;
+
+	RecordingBackend backend{ 16 * MB };
+	UploadBatcher batcher{ &backend, desc };
+
+	Buffer texture(20 * MB);
+	Buffer data = CreateData(19 * MB, 2);
+	batcher.Upload(&texture, MB, data.data(), data.size());
+	batcher.Flush();
+
+	// Copies of 3 MB; a third one would take a batch past 8 MB, so batches close at 6 MB. The last
+	// 1 MB still fits.
+	TEST_CHECK(backend.batches.size() == 3);
+	TEST_CHECK(backend.batches[0].size() == 2 && IsCopy(backend.batches[0][0], texture, MB, 3 * MB) && IsCopy(backend.batches[0][1], texture, 4 * MB, 3 * MB));
+	TEST_CHECK(backend.batches[1].size() == 2 && IsCopy(backend.batches[1][0], texture, 7 * MB, 3 * MB));
+	TEST_CHECK(backend.batches[2].size() == 3 && IsCopy(backend.batches[2][1], texture, 16 * MB, 3 * MB));
+	TEST_CHECK(IsCopy(backend.batches[2][2], texture, 19 * MB, MB));
+
+	for (const std::vector<UploadCopy>& copies : backend.batches)
+	{
+		for (const UploadCopy& copy : copies)
+			TEST_CHECK(copy.size <= desc.maxCopySize);
+	}
+
+	TEST_CHECK(batcher.GetStatistics().mergedCopyCount == 0 && batcher.GetStatistics().copyCount == 7);
+	TEST_CHECK(std::equal(texture.begin() + MB, texture.end(), data.begin()));
+}
+
+TEST_CASE(UploadBatcherBatchBoundaries)
+{
+	UploadBatcherDesc desc{};
+	desc.maxBatchSize = 1000;
+	desc.maxBatchCopies = 3;
+
+	RecordingBackend backend{ 4000 };
+	UploadBatcher batcher{ &backend, desc };
+
+	Buffer buffer(10000);
+	Buffer data = CreateData(10000, 3);
+
+	// Every other 100 bytes: a copy each, 3 per batch.
+	for (uint64_t offset = 0; offset < 1400; offset += 200)
+		batcher.Upload(&buffer, offset, data.data() + offset, 100);
+	TEST_CHECK(backend.batches.size() == 2 && batcher.HasOpenBatch());
+
+	// 400 contiguous bytes merge into the open batch's copy, then the size limit closes it.
+	batcher.Flush();
+	batcher.Upload(&buffer, 2000, data.data() + 2000, 400);
+	batcher.Upload(&buffer, 2400, data.data() + 2400, 400);
+	batcher.Upload(&buffer, 2800, data.data() + 2800, 400);
+	TEST_CHECK(backend.batches.size() == 4);
+	TEST_CHECK(backend.batches[3].size() == 1 && IsCopy(backend.batches[3][0], buffer, 2000, 800));
+
+	batcher.Flush();
+	TEST_CHECK(backend.batches.size() == 5 && IsCopy(backend.batches[4][0], buffer, 2800, 400));
+
+	for (size_t batch = 0; batch < backend.batches.size(); batch++)
+	{
+		TEST_CHECK(backend.batches[batch].size() <= desc.maxBatchCopies);
+		TEST_CHECK(backend.batchStagingSizes[batch] <= desc.maxBatchSize);
+	}
+	TEST_CHECK(batcher.GetStatistics().batchCount == 5);
+
+	TEST_CHECK_THROWS(UploadBatcher(&backend, UploadBatcherDesc{ 0, 1, 1 }), Error);
+}
+
+// Flush returns the value the direct queue waits for: the one of the last batch, which covers every
+// upload before it, also those in batches submitted on the way.
+TEST_CASE(UploadBatcherFenceValues)
+{
+	UploadBatcherDesc desc{};
+	desc.maxBatchSize = 256;
+
+	RecordingBackend backend{ 1024 };
+	UploadBatcher batcher{ &backend, desc };
+
+	TEST_CHECK(batcher.Flush() == 0 && batcher.GetLastSubmittedValue() == 0);
+
+	Buffer buffer(1024);
+	Buffer data = CreateData(1024, 4);
+
+	batcher.Upload(&buffer, 0, data.data(), 600);
+	TEST_CHECK(backend.batches.size() == 2 && batcher.GetLastSubmittedValue() == 104);
+
+	TEST_CHECK(batcher.Flush() == 106 && batcher.GetLastSubmittedValue() == 106);
+	TEST_CHECK(!batcher.HasOpenBatch());
+
+	// Nothing new to submit.
+	TEST_CHECK(batcher.Flush() == 106 && backend.batches.size() == 3);
+
+	batcher.Upload(&buffer, 600, data.data() + 600, 10);
+	TEST_CHECK(batcher.GetLastSubmittedValue() == 106);
+	TEST_CHECK(batcher.Flush() == 108);
+}
+
+// Random uploads into a few buffers: the copies "executed" by the backend give back the data, within
+// the limits of every batch.
+TEST_CASE(UploadBatcherRandomUploads)
+{
+	UploadBatcherDesc desc{};
+	desc.maxBatchSize = 64 * 1024;
+	desc.maxBatchCopies = 16;
+	desc.maxCopySize = 16 * 1024;
+
+	RecordingBackend backend{ 128 * 1024 };
+	UploadBatcher batcher{ &backend, desc };
+	std::mt19937 random{ 6 };
+
+	std::vector<Buffer> buffers(4, Buffer(256 * 1024));
+	std::vector<Buffer> expected = buffers;
+
+	size_t bufferIndex{ 0 };
+	uint64_t offset{ 0 };
+
+	for (uint32_t i = 0; i < 5000; i++)
+	{
+		uint64_t maxSize = random() % 8 == 0 ? 100000 : 2000;
+		uint64_t size = 1 + random() % maxSize;
+
+		// Often right after the previous upload, like the parts of a mesh.
+		bool contiguous = random() % 2 == 0 && offset + size <= buffers[bufferIndex].size();
+		if (!contiguous)
+		{
+			bufferIndex = random() % buffers.size();
+			offset = random() % (buffers[bufferIndex].size() - size);
+		}
+
+		Buffer data = CreateData(size, random());
+		batcher.Upload(&buffers[bufferIndex], offset, data.data(), size);
+		std::copy(data.begin(), data.end(), expected[bufferIndex].begin() + offset);
+		offset += size;
+
+		if (random() % 50 == 0)
+			batcher.Flush();
+	}
+	batcher.Flush();
+
+	TEST_CHECK(buffers == expected);
+	TEST_CHECK(batcher.GetStatistics().mergedCopyCount > 0);
+
+	for (size_t batch = 0; batch < backend.batches.size(); batch++)
+	{
+		TEST_CHECK(backend.batches[batch].size() <= desc.maxBatchCopies);
+		TEST_CHECK(backend.batchStagingSizes[batch] <= desc.maxBatchSize);
+		for (const UploadCopy& copy : backend.batches[batch])
+			TEST_CHECK(copy.size <= desc.maxCopySize);
+	}
+}
@@ -0,0 +1,231 @@
+#include "Test/Test.h"
+
+#include "DelayedLoadQueue.h"
+
+#include "Streaming/CameraPath.h"
+#include "Streaming/WorldStreamer.h"
+
+#include <vector>
+
+using namespace dxe;
+
+namespace
+{
+	// Checks that the streamer only uploads and unloads cells it holds data for.
+	class RecordingCellLoader : public StreamingCellLoader, public DelayedLoadQueue<StreamingCell::CellId>
+	{
+	public:
+
+		void BeginLoad(const StreamingCell& cell) override
+		{
+			TEST_CHECK(GetCellData(cell.id) == CellData::NONE);
+			cellData[cell.id] = CellData::LOADING;
+			PushLoad(cell.id);
+			beginLoadCount++;
+		}
+		void Upload(const StreamingCell& cell) override
+		{
+			TEST_CHECK(GetCellData(cell.id) == CellData::LOADED);
+			cellData[cell.id] = CellData::UPLOADED;
+			uploadCount++;
+		}
+		void Unload(const StreamingCell& cell) override
+		{
+			CellData data = GetCellData(cell.id);
+			TEST_CHECK(data == CellData::LOADED || data == CellData::UPLOADED);
+			cellData[cell.id] = CellData::NONE;
+			unloadCount++;
+		}
+
+		// Reports the loads due this frame.
+		void CompleteLoads(WorldStreamer& streamer)
+		{
+			CompleteDueLoads([&](StreamingCell::CellId cellId, bool succeeded) {
+				cellData[cellId] = succeeded ? CellData::LOADED : CellData::NONE;
+				streamer.OnCellLoaded(cellId, succeeded);
+			});
+		}
+
+		uint32_t beginLoadCount{ 0 };
+		uint32_t uploadCount{ 0 };
+		uint32_t unloadCount{ 0 };
+
+	private:
+
+		enum class CellData
+		{
+			NONE,
+			LOADING,
+			LOADED,
+			UPLOADED
+		};
+
+		CellData GetCellData(StreamingCell::CellId cellId)
+		{
+			if (cellId >= cellData.size())
+				cellData.resize(cellId + 1, CellData::NONE);
+			return cellData[cellId];
+		}
+
+		std::vector<CellData> cellData;
+	};
+
+	// Committed bytes are those of every cell that isn't UNLOADED.
+	void CheckCommittedBytes(const WorldStreamer& streamer)
+	{
+		uint64_t cpuBytes{ 0 };
+		uint64_t gpuBytes{ 0 };
+
+		for (StreamingCell::CellId cellId = 0; cellId < streamer.GetCellCount(); cellId++)
+		{
+			const StreamingCell& cell = streamer.GetCell(cellId);
+			if (cell.state == StreamingCellState::UNLOADED)
+				continue;
+
+			cpuBytes += cell.cpuBytes;
+			gpuBytes += cell.gpuBytes;
+		}
+
+		TEST_CHECK(streamer.GetCpuCommittedBytes() == cpuBytes);
+		TEST_CHECK(streamer.GetGpuCommittedBytes() == gpuBytes);
+	}
+
+	uint64_t GetRequiredGpuBytes(const WorldStreamer& streamer, const WorldStreamerSettings& settings)
+	{
+		uint64_t gpuBytes{ 0 };
+
+		for (StreamingCell::CellId cellId = 0; cellId < streamer.GetCellCount(); cellId++)
+		{
+			const StreamingCell& cell = streamer.GetCell(cellId);
+			if (cell.state != StreamingCellState::UNLOADED && cell.cameraDistance <= settings.requiredRadius)
+				gpuBytes += cell.gpuBytes;
+		}
+		return gpuBytes;
+	}
+
+	void AddGrid(WorldStreamer& streamer, int32_t halfSize, uint64_t cpuBytes, uint64_t gpuBytes)
+	{
+		for (int32_t z = -halfSize; z < halfSize; z++)
+		{
+			for (int32_t x = -halfSize; x < halfSize; x++)
+				streamer.AddCell(StreamingCellCoord{ x, z }, cpuBytes, gpuBytes, static_cast<uint32_t>(x + z) & 1);
+		}
+	}
+}
+
+// A load that completes after the camera left is applied and released once, not again as a distant
+// cell in the same frame.
+TEST_CASE(WorldStreamerCompletionAfterLeaving)
+{
+	RecordingCellLoader loader;
+	loader.loadFrames = 0;
+
+	WorldStreamer streamer{ WorldStreamerSettings{}, &loader };
+	StreamingCell::CellId cellId = streamer.AddCell(StreamingCellCoord{ 0, 0 }, 100, 200);
+
+	const DirectX::XMFLOAT3 origin{ 0.0f, 0.0f, 0.0f };
+	const DirectX::XMFLOAT3 farAway{ 10000.0f, 0.0f, 0.0f };
+
+	streamer.Update(origin);
+	TEST_CHECK(streamer.GetCell(cellId).state == StreamingCellState::LOADING);
+
+	streamer.Update(farAway);
+	TEST_CHECK(streamer.GetCell(cellId).unloadRequested);
+
+	loader.CompleteLoads(streamer);
+	streamer.Update(farAway);
+
+	TEST_CHECK(loader.unloadCount == 1);
+	TEST_CHECK(streamer.GetFrameStats().unloads == 1);
+	TEST_CHECK(streamer.GetCell(cellId).state == StreamingCellState::UNLOADED);
+	TEST_CHECK(streamer.GetCpuCommittedBytes() == 0 && streamer.GetGpuCommittedBytes() == 0);
+
+	// Same for a failed load, which has nothing to unload.
+	streamer.Update(origin);
+	streamer.Update(farAway);
+	loader.failEvery = 1;
+	loader.CompleteLoads(streamer);
+	streamer.Update(farAway);
+
+	TEST_CHECK(loader.unloadCount == 1 && loader.failureCount == 1);
+	TEST_CHECK(streamer.GetCpuCommittedBytes() == 0 && streamer.GetGpuCommittedBytes() == 0);
+}
+
+// A scripted camera crosses the grid faster than loads finish, some loads fail, and it ends far
+// outside the world: the accounting holds every frame and returns to 0.
+TEST_CASE(WorldStreamerCameraPath)
+{
+	RecordingCellLoader loader;
+	loader.loadFrames = 20;
+	loader.failEvery = 7;
+
+	WorldStreamerSettings settings{};
+	settings.cpuBudgetBytes = 40ull << 20;
+	settings.gpuBudgetBytes = 80ull << 20;
+	settings.uploadBudgetBytesPerFrame = 4ull << 20;
+
+	WorldStreamer streamer{ settings, &loader };
+	AddGrid(streamer, 24, 1ull << 20, 2ull << 20);
+
+	CameraPath path{ { { 0.0f, 0.0f, 0.0f }, { 1400.0f, 0.0f, 0.0f }, { 1400.0f, 0.0f, 1400.0f }, { -1400.0f, 0.0f, -1400.0f }, { -9000.0f, 0.0f, -9000.0f } }, 300.0f };
+
+	uint32_t frameCount = static_cast<uint32_t>(path.GetDuration() * 60.0f) + 60;
+	for (uint32_t frame = 0; frame < frameCount; frame++)
+	{
+		loader.CompleteLoads(streamer);
+		streamer.Update(path.Sample(frame / 60.0f));
+		CheckCommittedBytes(streamer);
+
+		// Only required cells are loaded over the budget.
+		TEST_CHECK(streamer.GetGpuCommittedBytes() <= settings.gpuBudgetBytes + GetRequiredGpuBytes(streamer, settings));
+	}
+
+	while (loader.HasPendingLoads())
+	{
+		loader.CompleteLoads(streamer);
+		streamer.Update(path.Sample(path.GetDuration()));
+		CheckCommittedBytes(streamer);
+	}
+	streamer.Update(path.Sample(path.GetDuration()));
+
+	TEST_CHECK(loader.failureCount > 0 && loader.uploadCount > 0);
+	TEST_CHECK(loader.beginLoadCount == loader.unloadCount + loader.failureCount);
+	TEST_CHECK(streamer.GetCpuCommittedBytes() == 0 && streamer.GetGpuCommittedBytes() == 0);
+
+	for (StreamingCell::CellId cellId = 0; cellId < streamer.GetCellCount(); cellId++)
+		TEST_CHECK(streamer.GetCell(cellId).state == StreamingCellState::UNLOADED);
+}
+
+// Standing still with instant loads, everything around the camera ends up resident within budget.
+TEST_CASE(WorldStreamerSettles)
+{
+	RecordingCellLoader loader;
+	loader.loadFrames = 0;
+
+	WorldStreamerSettings settings{};
+	settings.gpuBudgetBytes = 1ull << 30;
+
+	WorldStreamer streamer{ settings, &loader };
+	AddGrid(streamer, 8, 1ull << 20, 2ull << 20);
+
+	const DirectX::XMFLOAT3 position{ 32.0f, 0.0f, 32.0f };
+	for (uint32_t frame = 0; frame < 120; frame++)
+	{
+		loader.CompleteLoads(streamer);
+		streamer.Update(position);
+	}
+
+	TEST_CHECK(streamer.GetFrameStats().stalledCells == 0);
+	TEST_CHECK(streamer.GetFrameStats().loadsIssued == 0 && streamer.GetFrameStats().uploads == 0);
+
+	for (StreamingCell::CellId cellId = 0; cellId < streamer.GetCellCount(); cellId++)
+	{
+		// Cell centers within the load radius, the closest points of their cells are too.
+		const StreamingCell& cell = streamer.GetCell(cellId);
+		float dx = (cell.coord.x + 0.5f) * settings.cellSize - position.x;
+		float dz = (cell.coord.z + 0.5f) * settings.cellSize - position.z;
+		if (dx * dx + dz * dz <= settings.loadRadius * settings.loadRadius)
+			TEST_CHECK(cell.state == StreamingCellState::RESIDENT);
+	}
+	CheckCommittedBytes(streamer);
+}
@@ -0,0 +1,475 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Terrain/Terrain.h"
+
+#include <cfloat>
+#include <cmath>
+#include <random>
+
+using namespace dxe;
+
+namespace
+{
+	// Rolling hills, 'amplitude' high.
+	std::vector<float> CreateHeights(uint32_t sampleCount, float amplitude)
+	{
+		std::vector<float> heights(static_cast<size_t>(sampleCount) * sampleCount);
+		for (uint32_t z = 0; z < sampleCount; z++)
+		{
+			for (uint32_t x = 0; x < sampleCount; x++)
+			{
+				float height = std::sin(x * 0.02f) * std::cos(z * 0.03f) + 0.2f * std::sin(x * 0.07f + z * 0.05f);
+				heights[static_cast<size_t>(z) * sampleCount + x] = amplitude * height;
+			}
+		}
+		return heights;
+	}
+
+	// 8 x 8 roots of 128 quads, LOD 0 chunks of 16 quads. Enough roots for the selection to go parallel.
+	TerrainSettings GetTestSettings()
+	{
+		TerrainSettings settings{};
+		settings.chunkResolution = 16;
+		settings.lodCount = 4;
+		settings.finestLodDistance = 48.0f;
+		return settings;
+	}
+	constexpr uint32_t TEST_SAMPLE_COUNT = 1025;
+
+	// Same test as the terrain's: squared distance to the box within the squared range.
+	bool IsInRange(const DirectX::XMFLOAT3& position, float minX, float minZ, float size, float minHeight, float maxHeight,
+		float range)
+	{
+		auto getAxisDistance = [](float value, float min, float max) {
+			return std::max(std::max(min - value, value - max), 0.0f);
+		};
+
+		float dx = getAxisDistance(position.x, minX, minX + size);
+		float dy = getAxisDistance(position.y, minHeight, maxHeight);
+		float dz = getAxisDistance(position.z, minZ, minZ + size);
+		return dx * dx + dy * dy + dz * dz <= range * range;
+	}
+
+	// Checks a selection against the documented rules, independently of the quadtree: the draw chunks
+	// tile the terrain, each one is drawn at the LOD its distance asks for, and neighbors are at most
+	// one LOD apart.
+	void CheckSelection(const Terrain& terrain, const std::vector<float>& heights, uint32_t sampleCount,
+		const TerrainView& view, const TerrainSelection& selection)
+	{
+		const TerrainSettings& settings = terrain.GetSettings();
+
+		// Heights over the samples beneath a square, at full resolution.
+		auto getHeightRange = [&](float originX, float originZ, float size, float& minHeight, float& maxHeight) {
+			uint32_t firstX = static_cast<uint32_t>(originX / settings.sampleSpacing);
+			uint32_t firstZ = static_cast<uint32_t>(originZ / settings.sampleSpacing);
+			uint32_t quadCount = static_cast<uint32_t>(size / settings.sampleSpacing);
+
+			minHeight = FLT_MAX;
+			maxHeight = -FLT_MAX;
+			for (uint32_t z = firstZ; z <= firstZ + quadCount; z++)
+			{
+				for (uint32_t x = firstX; x <= firstX + quadCount; x++)
+				{
+					minHeight = std::min(minHeight, heights[static_cast<size_t>(z) * sampleCount + x]);
+					maxHeight = std::max(maxHeight, heights[static_cast<size_t>(z) * sampleCount + x]);
+				}
+			}
+		};
+
+		// Cells of half a LOD 0 chunk, the smallest draw chunk, and the draw chunk covering each.
+		float cellSize = settings.chunkResolution * settings.sampleSpacing * 0.5f;
+		uint32_t cellCount = static_cast<uint32_t>(terrain.GetSizeX() / cellSize);
+		std::vector<uint32_t> owners(static_cast<size_t>(cellCount) * cellCount, UINT32_MAX);
+
+		uint64_t vertexCount{ 0 };
+		for (uint32_t drawIndex = 0; drawIndex < selection.drawChunks.size(); drawIndex++)
+		{
+			const TerrainDrawChunk& drawChunk = selection.drawChunks[drawIndex];
+			const TerrainChunk& chunk = terrain.GetChunk(drawChunk.chunkIndex);
+			uint32_t lod = drawChunk.lod;
+
+			TEST_CHECK(lod == chunk.lod);
+			TEST_CHECK(drawChunk.morphStart == terrain.GetMorphStart(lod) && drawChunk.morphEnd == terrain.GetLodRange(lod));
+
+			bool quadrant = drawChunk.quadrant != TERRAIN_FULL_CHUNK;
+			TEST_CHECK((drawChunk.gridMesh == TerrainGridMesh::QUARTER) == quadrant);
+			TEST_CHECK(drawChunk.size == (quadrant ? chunk.size * 0.5f : chunk.size));
+
+			uint32_t gridResolution = quadrant ? settings.chunkResolution / 2 : settings.chunkResolution;
+			vertexCount += (gridResolution + 1) * (gridResolution + 1);
+
+			// Nothing drawn at LOD 'lod' is within the range of the finer LOD, and whole chunks are
+			// within their own; a chunk drawn as quadrants was within the finer range itself.
+			float minHeight{ 0.0f };
+			float maxHeight{ 0.0f };
+			getHeightRange(drawChunk.origin.x, drawChunk.origin.y, drawChunk.size, minHeight, maxHeight);
+			if (lod > 0)
+				TEST_CHECK(!IsInRange(view.cameraPosition, drawChunk.origin.x, drawChunk.origin.y, drawChunk.size, minHeight, maxHeight, terrain.GetLodRange(lod - 1)));
+
+			float range = quadrant ? terrain.GetLodRange(lod - 1) : terrain.GetLodRange(lod);
+			TEST_CHECK(IsInRange(view.cameraPosition, chunk.origin.x, chunk.origin.y, chunk.size, chunk.minHeight, chunk.maxHeight, range));
+
+			uint32_t firstX = static_cast<uint32_t>(drawChunk.origin.x / cellSize);
+			uint32_t firstZ = static_cast<uint32_t>(drawChunk.origin.y / cellSize);
+			uint32_t size = static_cast<uint32_t>(drawChunk.size / cellSize);
+			for (uint32_t z = firstZ; z < firstZ + size; z++)
+			{
+				for (uint32_t x = firstX; x < firstX + size; x++)
+				{
+					TEST_CHECK(owners[z * cellCount + x] == UINT32_MAX);
+					owners[z * cellCount + x] = drawIndex;
+				}
+			}
+		}
+
+		TEST_CHECK(selection.vertexCount == vertexCount);
+
+		for (uint32_t z = 0; z < cellCount; z++)
+		{
+			for (uint32_t x = 0; x < cellCount; x++)
+			{
+				uint32_t owner = owners[z * cellCount + x];
+				TEST_CHECK(owner != UINT32_MAX);
+				if (owner == UINT32_MAX)
+					return;
+
+				uint32_t lod = selection.drawChunks[owner].lod;
+				if (x + 1 < cellCount)
+					TEST_CHECK(std::abs(static_cast<int32_t>(lod) - static_cast<int32_t>(selection.drawChunks[owners[z * cellCount + x + 1]].lod)) <= 1);
+				if (z + 1 < cellCount)
+					TEST_CHECK(std::abs(static_cast<int32_t>(lod) - static_cast<int32_t>(selection.drawChunks[owners[(z + 1) * cellCount + x]].lod)) <= 1);
+			}
+		}
+	}
+
+	bool IsSameSelection(const TerrainSelection& selection1, const TerrainSelection& selection2)
+	{
+		if (selection1.drawChunks.size() != selection2.drawChunks.size())
+			return false;
+
+		for (size_t i = 0; i < selection1.drawChunks.size(); i++)
+		{
+			const TerrainDrawChunk& drawChunk1 = selection1.drawChunks[i];
+			const TerrainDrawChunk& drawChunk2 = selection2.drawChunks[i];
+			if (drawChunk1.chunkIndex != drawChunk2.chunkIndex || drawChunk1.quadrant != drawChunk2.quadrant)
+				return false;
+		}
+
+		return selection1.vertexCount == selection2.vertexCount && selection1.triangleCount == selection2.triangleCount &&
+			selection1.visitedChunkCount == selection2.visitedChunkCount && selection1.culledChunkCount == selection2.culledChunkCount;
+	}
+
+	// A side of a draw chunk, as the grid vertices along it.
+	struct TerrainEdge
+	{
+		// Along X for the -Z and +Z sides, along Z for the others.
+		float begin{ 0.0f };
+		float end{ 0.0f };
+
+		std::vector<uint32_t> gridX;
+		std::vector<uint32_t> gridZ;
+	};
+
+	// 'side' is 0 for -X, 1 for +X, 2 for -Z and 3 for +Z.
+	TerrainEdge GetEdge(const Terrain& terrain, const TerrainDrawChunk& drawChunk, uint32_t side)
+	{
+		uint32_t gridResolution = terrain.GetSettings().chunkResolution;
+		if (drawChunk.gridMesh == TerrainGridMesh::QUARTER)
+			gridResolution /= 2;
+
+		TerrainEdge edge{};
+		bool alongZ = side < 2;
+		edge.begin = alongZ ? drawChunk.origin.y : drawChunk.origin.x;
+		edge.end = edge.begin + drawChunk.size;
+
+		uint32_t fixedGrid = (side & 1) ? gridResolution : 0;
+		for (uint32_t grid = 0; grid <= gridResolution; grid++)
+		{
+			edge.gridX.push_back(alongZ ? fixedGrid : grid);
+			edge.gridZ.push_back(alongZ ? grid : fixedGrid);
+		}
+		return edge;
+	}
+
+	// Every vertex of 'edge' within [begin, end], after morphing, sits on a vertex of 'otherEdge'.
+	bool IsEdgeCovered(const Terrain& terrain, const TerrainDrawChunk& drawChunk, const TerrainEdge& edge,
+		const TerrainDrawChunk& otherDrawChunk, const TerrainEdge& otherEdge, float begin, float end,
+		const DirectX::XMFLOAT3& cameraPosition)
+	{
+		std::vector<DirectX::XMFLOAT3> otherPositions;
+		for (size_t vertex = 0; vertex < otherEdge.gridX.size(); vertex++)
+		{
+			otherPositions.push_back(terrain.GetMorphedVertexPosition(
+				otherDrawChunk, otherEdge.gridX[vertex], otherEdge.gridZ[vertex], cameraPosition));
+		}
+
+		float spacing = drawChunk.size / (edge.gridX.size() - 1);
+		for (size_t vertex = 0; vertex < edge.gridX.size(); vertex++)
+		{
+			float position = edge.begin + vertex * spacing;
+			if (position < begin || position > end)
+				continue;
+
+			DirectX::XMFLOAT3 morphed = terrain.GetMorphedVertexPosition(drawChunk, edge.gridX[vertex], edge.gridZ[vertex], cameraPosition);
+			bool covered{ false };
+			for (const DirectX::XMFLOAT3& otherPosition : otherPositions)
+			{
+				if (std::abs(morphed.x - otherPosition.x) < 1e-3f && std::abs(morphed.y - otherPosition.y) < 1e-3f &&
+					std::abs(morphed.z - otherPosition.z) < 1e-3f)
+				{
+					covered = true;
+					break;
+				}
+			}
+			if (!covered)
+				return false;
+		}
+		return true;
+	}
+
+	// Row-vector view-projection of a camera at 'position' looking along +X, see 'ExtractFrustumPlanes'.
+	DirectX::XMFLOAT4X4 CreateViewProjectionAlongX(const DirectX::XMFLOAT3& position, float verticalFieldOfView,
+		float nearZ, float farZ)
+	{
+		// View space: right is -Z, up is +Y, forward is +X.
+		float scale = 1.0f / std::tan(verticalFieldOfView * 0.5f);
+		float depthScale = farZ / (farZ - nearZ);
+
+		DirectX::XMFLOAT4X4 viewProjection{};
+		viewProjection.m[2][0] = -scale;
+		viewProjection.m[3][0] = scale * position.z;
+		viewProjection.m[1][1] = scale;
+		viewProjection.m[3][1] = -scale * position.y;
+		viewProjection.m[0][2] = depthScale;
+		viewProjection.m[3][2] = -depthScale * (position.x + nearZ);
+		viewProjection.m[0][3] = 1.0f;
+		viewProjection.m[3][3] = -position.x;
+		return viewProjection;
+	}
+}
+
+TEST_CASE(TerrainLodRanges)
+{
+	TerrainSettings settings = GetTestSettings();
+	std::vector<float> heights = CreateHeights(TEST_SAMPLE_COUNT, 10.0f);
+	Terrain terrain{ settings, heights, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT };
+
+	// Every LOD reaches twice as far as the finer one and morphs over the last 30% of its range.
+	const float ranges[] = { 48.0f, 96.0f, 192.0f };
+	const float morphStarts[] = { 33.6f, 81.6f, 163.2f };
+	for (uint32_t lod = 0; lod < 3; lod++)
+	{
+		TEST_CHECK(std::abs(terrain.GetLodRange(lod) - ranges[lod]) < 1e-4f);
+		TEST_CHECK(std::abs(terrain.GetMorphStart(lod) - morphStarts[lod]) < 1e-4f);
+	}
+	TEST_CHECK(terrain.GetLodRange(3) == FLT_MAX && terrain.GetMorphStart(3) == FLT_MAX);
+
+	// Cameras over and around the terrain, low and high; the pool gives the same selection.
+	ThreadPool threadPool{ 4 };
+	std::mt19937 random{ 8 };
+
+	TerrainSelection selection;
+	TerrainSelection pooledSelection;
+	for (uint32_t i = 0; i < 100; i++)
+	{
+		TerrainView view{};
+		view.cameraPosition.x = static_cast<float>(random() % 1300) - 150.0f;
+		view.cameraPosition.z = static_cast<float>(random() % 1300) - 150.0f;
+		view.cameraPosition.y = terrain.SampleHeight(view.cameraPosition.x, view.cameraPosition.z) + static_cast<float>(random() % 300);
+
+		terrain.SelectChunks(view, selection);
+		terrain.SelectChunks(view, pooledSelection, &threadPool);
+
+		CheckSelection(terrain, heights, TEST_SAMPLE_COUNT, view, selection);
+		TEST_CHECK(IsSameSelection(selection, pooledSelection));
+	}
+
+	// Right above a corner: LOD 0 there, the coarsest LOD at the far side.
+	TerrainView view{};
+	view.cameraPosition = DirectX::XMFLOAT3{ 1.0f, 20.0f, 1.0f };
+	terrain.SelectChunks(view, selection);
+
+	uint32_t minLod{ UINT32_MAX };
+	uint32_t maxLod{ 0 };
+	for (const TerrainDrawChunk& drawChunk : selection.drawChunks)
+	{
+		minLod = std::min(minLod, drawChunk.lod);
+		maxLod = std::max(maxLod, drawChunk.lod);
+	}
+	TEST_CHECK(minLod == 0 && maxLod == 3);
+}
+
+// A chunk has to be fully morphed before its coarser neighbor starts to: the constructor rejects LOD
+// distances too short for the chunk diagonal, heights included.
+TEST_CASE(TerrainLodDistanceTooShort)
+{
+	TerrainSettings settings = GetTestSettings();
+	std::vector<float> flat(TEST_SAMPLE_COUNT * TEST_SAMPLE_COUNT, 5.0f);
+
+	// Flat, the LOD 0 diagonal is 16 * sqrt(2) = 22.6 and has to fit into 70% of the finest distance.
+	settings.finestLodDistance = 32.0f;
+	TEST_CHECK_THROWS(Terrain(settings, flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT), Error);
+	settings.finestLodDistance = 33.0f;
+	Terrain flatTerrain{ settings, flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT };
+	TEST_CHECK(flatTerrain.GetLodRange(0) == 33.0f);
+
+	// A slope of 4 makes the LOD 0 diagonal sqrt(16^2 + 16^2 + 64^2) = 67.9.
+	std::vector<float> slope(TEST_SAMPLE_COUNT * TEST_SAMPLE_COUNT);
+	for (size_t i = 0; i < slope.size(); i++)
+		slope[i] = 4.0f * (i % TEST_SAMPLE_COUNT);
+	TEST_CHECK_THROWS(Terrain(settings, slope, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT), Error);
+	settings.finestLodDistance = 96.0f;
+	TEST_CHECK_THROWS(Terrain(settings, slope, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT), Error);
+	settings.finestLodDistance = 98.0f;
+	Terrain slopeTerrain{ settings, slope, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT };
+
+	// A wider ratio leaves more room between the ranges.
+	settings.finestLodDistance = 32.0f;
+	settings.lodDistanceRatio = 3.0f;
+	Terrain wideTerrain{ settings, flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT };
+	TEST_CHECK(wideTerrain.GetLodRange(1) == 96.0f);
+
+	// The other settings and the sample counts.
+	settings = GetTestSettings();
+	settings.chunkResolution = 12;
+	TEST_CHECK_THROWS(Terrain(settings, flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT), Error);
+	settings = GetTestSettings();
+	settings.morphRegion = 0.0f;
+	TEST_CHECK_THROWS(Terrain(settings, flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT), Error);
+	settings = GetTestSettings();
+	settings.lodDistanceRatio = 1.0f;
+	TEST_CHECK_THROWS(Terrain(settings, flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT), Error);
+	TEST_CHECK_THROWS(Terrain(GetTestSettings(), std::vector<float>(500 * 500), 500, 500), Error);
+	TEST_CHECK_THROWS(Terrain(GetTestSettings(), flat, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT - 1), Error);
+}
+
+// Wherever two draw chunks meet, the morphed vertices of both sides coincide: the finer side is fully
+// morphed onto the coarser grid and the coarser side doesn't morph yet. Same LOD neighbors (i.e. a
+// quadrant next to a whole chunk) coincide too, which checks quadrants read heights past their +X
+// and +Z edges from the right samples.
+TEST_CASE(TerrainSeamsCoincide)
+{
+	TerrainSettings settings = GetTestSettings();
+	std::vector<float> heights = CreateHeights(TEST_SAMPLE_COUNT, 10.0f);
+	Terrain terrain{ settings, heights, TEST_SAMPLE_COUNT, TEST_SAMPLE_COUNT };
+
+	std::mt19937 random{ 3 };
+	TerrainSelection selection;
+
+	uint32_t lodSeamCount{ 0 };
+	uint32_t quadrantSeamCount{ 0 };
+	for (uint32_t i = 0; i < 20; i++)
+	{
+		TerrainView view{};
+		view.cameraPosition.x = static_cast<float>(random() % 1024);
+		view.cameraPosition.z = static_cast<float>(random() % 1024);
+		view.cameraPosition.y = terrain.SampleHeight(view.cameraPosition.x, view.cameraPosition.z) + static_cast<float>(random() % 100);
+		terrain.SelectChunks(view, selection);
+
+		for (const TerrainDrawChunk& drawChunk : selection.drawChunks)
+		{
+			for (const TerrainDrawChunk& neighbor : selection.drawChunks)
+			{
+				// 'neighbor' along +X or +Z of 'drawChunk'.
+				for (uint32_t axis = 0; axis < 2; axis++)
+				{
+					bool alongX = axis == 0;
+					float drawChunkEnd = (alongX ? drawChunk.origin.x : drawChunk.origin.y) + drawChunk.size;
+					float neighborBegin = alongX ? neighbor.origin.x : neighbor.origin.y;
+					if (drawChunkEnd != neighborBegin)
+						continue;
+
+					TerrainEdge edge = GetEdge(terrain, drawChunk, alongX ? 1 : 3);
+					TerrainEdge neighborEdge = GetEdge(terrain, neighbor, alongX ? 0 : 2);
+					float begin = std::max(edge.begin, neighborEdge.begin);
+					float end = std::min(edge.end, neighborEdge.end);
+					if (begin >= end)
+						continue;
+
+					if (drawChunk.lod != neighbor.lod)
+					{
+						lodSeamCount++;
+
+						// The finer side's seam vertices are past its LOD's range, the coarser side's
+						// before its morph region.
+						const TerrainDrawChunk& finer = drawChunk.lod < neighbor.lod ? drawChunk : neighbor;
+						const TerrainDrawChunk& coarser = drawChunk.lod < neighbor.lod ? neighbor : drawChunk;
+						for (float position = begin; position <= end; position += settings.sampleSpacing)
+						{
+							DirectX::XMFLOAT3 seamPosition = alongX ?
+								DirectX::XMFLOAT3{ neighborBegin, 0.0f, position } : DirectX::XMFLOAT3{ position, 0.0f, neighborBegin };
+							seamPosition.y = terrain.SampleHeight(seamPosition.x, seamPosition.z);
+
+							TEST_CHECK(terrain.CalculateMorphFactor(finer, seamPosition, view.cameraPosition) == 1.0f);
+							TEST_CHECK(terrain.CalculateMorphFactor(coarser, seamPosition, view.cameraPosition) == 0.0f);
+						}
+					}
+					else if (drawChunk.gridMesh != neighbor.gridMesh)
+					{
+						quadrantSeamCount++;
+					}
+
+					TEST_CHECK(IsEdgeCovered(terrain, drawChunk, edge, neighbor, neighborEdge, begin, end, view.cameraPosition));
+					TEST_CHECK(IsEdgeCovered(terrain, neighbor, neighborEdge, drawChunk, edge, begin, end, view.cameraPosition));
+				}
+			}
+		}
+	}
+
+	TEST_CHECK(lodSeamCount > 0 && quadrantSeamCount > 0);
+}
+
+// Selection of a 4 km terrain at 1 m, default settings, on one thread and on the pool, with the
+// vertices and draws of each view.
+BENCHMARK_CASE(TerrainSelectChunks)
+{
+	const uint32_t sampleCount = 4097;
+
+	ThreadPool threadPool{};
+	std::vector<float> heights = CreateHeights(sampleCount, 40.0f);
+	Terrain terrain{ TerrainSettings{}, heights, sampleCount, sampleCount, &threadPool };
+
+	struct BenchmarkView
+	{
+		const char* name{ nullptr };
+		TerrainView view{};
+	};
+
+	std::vector<BenchmarkView> views(4);
+	views[0].name = "ground, center";
+	views[0].view.cameraPosition = DirectX::XMFLOAT3{ 2048.0f, terrain.SampleHeight(2048.0f, 2048.0f) + 2.0f, 2048.0f };
+	views[1].name = "ground, corner";
+	views[1].view.cameraPosition = DirectX::XMFLOAT3{ 10.0f, terrain.SampleHeight(10.0f, 10.0f) + 2.0f, 10.0f };
+	views[2].name = "500 m up";
+	views[2].view.cameraPosition = DirectX::XMFLOAT3{ 2048.0f, 500.0f, 2048.0f };
+	views[3].name = "ground, culled, looking along +X";
+	views[3].view = views[0].view;
+	views[3].view.frustumCulling = true;
+	views[3].view.frustumPlanes = ExtractFrustumPlanes(
+		CreateViewProjectionAlongX(views[3].view.cameraPosition, DirectX::XM_PIDIV4, 0.1f, 10000.0f));
+
+	const uint32_t selectionCount = 200;
+	TerrainSelection selection;
+
+	for (const BenchmarkView& benchmarkView : views)
+	{
+		std::string name = benchmarkView.name;
+
+		for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+		{
+			double nanoseconds = MeasureNanosecondsPerItem(selectionCount, [&]() {
+				for (uint32_t i = 0; i < selectionCount; i++)
+					terrain.SelectChunks(benchmarkView.view, selection, pool);
+				KeepValue(selection.vertexCount);
+			});
+			ReportMetric(name + (pool ? ", thread pool" : ", 1 thread"), nanoseconds * 1.0e-3, "us");
+		}
+
+		ReportMetric(name + ", draws", static_cast<double>(selection.drawChunks.size()), "");
+		ReportMetric(name + ", vertices", static_cast<double>(selection.vertexCount), "");
+		ReportMetric(name + ", visited chunks", static_cast<double>(selection.visitedChunkCount), "");
+	}
+
+	ReportMetric("full resolution vertices", static_cast<double>(sampleCount) * sampleCount, "");
+}
@@ -0,0 +1,35 @@
+#include "Test/Dx12TestDevice.h"
+
+#include "Core/Error.h"
+
+#include <dxgi1_6.h>
+
+#include <wrl/client.h>
+
+using namespace Microsoft::WRL;
+
+namespace dxe
+{
+	ID3D12Device* GetTestDevice()
+	{
+		static ComPtr<ID3D12Device> device;
+		if (device)
+			return device.Get();
+
+		ComPtr<IDXGIFactory4> factory;
+		DX12_THROW_IF_NOT_SUCCESS(
+			CreateDXGIFactory2(0, IID_PPV_ARGS(factory.GetAddressOf())),
+			"Failed to initialize the DXGI Factory!");
+
+		ComPtr<IDXGIAdapter> adapter;
+		DX12_THROW_IF_NOT_SUCCESS(
+			factory->EnumWarpAdapter(IID_PPV_ARGS(adapter.GetAddressOf())),
+			"Failed to retrieve the WARP adapter!");
+
+		DX12_THROW_IF_NOT_SUCCESS(
+			D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_11_0, IID_PPV_ARGS(device.GetAddressOf())),
+			"Failed to create a WARP device!");
+
+		return device.Get();
+	}
+}
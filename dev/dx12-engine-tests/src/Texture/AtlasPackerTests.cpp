@@ -0,0 +1,327 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Texture/AtlasPacker.h"
+
+#include <cmath>
+#include <random>
+
+using namespace dxe;
+
+namespace
+{
+	constexpr AtlasPackHeuristic HEURISTICS[] = { AtlasPackHeuristic::SKYLINE, AtlasPackHeuristic::MAX_RECTS };
+
+	const char* GetHeuristicName(AtlasPackHeuristic heuristic)
+	{
+		return heuristic == AtlasPackHeuristic::SKYLINE ? "SKYLINE" : "MAX_RECTS";
+	}
+
+	// Mostly glyph and icon sized entries, some larger decals, a few wide strips.
+	std::vector<Dimensions2D> CreateMixedSizes(uint32_t count, uint32_t seed)
+	{
+		std::mt19937 random{ seed };
+
+		std::vector<Dimensions2D> sizes(count);
+		for (Dimensions2D& size : sizes)
+		{
+			uint32_t kind = random() % 10;
+			uint32_t maxSide = kind < 7 ? 24 : 64;
+			size.width = 1 + random() % maxSide;
+			size.height = 1 + random() % maxSide;
+
+			if (kind == 9)
+				size.height = 1 + random() % 8;
+		}
+		return sizes;
+	}
+
+	uint32_t AlignUp(uint32_t value, uint32_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// What the settings promise: every entry keeps its size, its gutter, padding and alignment lie
+	// inside the atlas, and no two of those rectangles overlap.
+	void CheckLayout(const AtlasLayout& layout, const std::vector<Dimensions2D>& sizes, const AtlasPackSettings& settings)
+	{
+		uint32_t mipScale = 1u << (settings.mipLevels - 1);
+		uint32_t gutter = settings.gutter * mipScale;
+		uint32_t alignment = std::max(settings.alignment, mipScale);
+
+		TEST_CHECK(layout.entries.size() == sizes.size());
+		TEST_CHECK(layout.width <= settings.maxWidth && layout.height <= settings.maxHeight);
+		if (settings.powerOfTwo)
+			TEST_CHECK((layout.width & (layout.width - 1)) == 0 && (layout.height & (layout.height - 1)) == 0);
+
+		std::vector<uint8_t> covered(static_cast<size_t>(layout.width) * layout.height, 0);
+		uint64_t imageArea{ 0 };
+		uint64_t packedArea{ 0 };
+		bool overlaps{ false };
+
+		for (size_t index = 0; index < sizes.size(); index++)
+		{
+			const AtlasEntry& entry = layout.entries[index];
+			TEST_CHECK(entry.width == sizes[index].width && entry.height == sizes[index].height);
+			TEST_CHECK(entry.x >= gutter && entry.y >= gutter);
+			TEST_CHECK((entry.x - gutter) % alignment == 0 && (entry.y - gutter) % alignment == 0);
+
+			uint32_t packedX = entry.x - gutter;
+			uint32_t packedY = entry.y - gutter;
+			uint32_t packedWidth = AlignUp(entry.width + 2 * gutter + settings.padding, alignment);
+			uint32_t packedHeight = AlignUp(entry.height + 2 * gutter + settings.padding, alignment);
+			TEST_CHECK(packedX + packedWidth <= layout.width && packedY + packedHeight <= layout.height);
+			if (packedX + packedWidth > layout.width || packedY + packedHeight > layout.height)
+				continue;
+
+			for (uint32_t y = packedY; y < packedY + packedHeight; y++)
+			{
+				for (uint32_t x = packedX; x < packedX + packedWidth; x++)
+					overlaps |= covered[static_cast<size_t>(y) * layout.width + x]++ != 0;
+			}
+
+			imageArea += static_cast<uint64_t>(entry.width) * entry.height;
+			packedArea += static_cast<uint64_t>(packedWidth) * packedHeight;
+		}
+
+		TEST_CHECK(!overlaps);
+
+		double atlasArea = static_cast<double>(layout.width) * layout.height;
+		TEST_CHECK(std::abs(layout.occupancy - imageArea / atlasArea) < 1e-6);
+		TEST_CHECK(std::abs(layout.packedOccupancy - packedArea / atlasArea) < 1e-6);
+	}
+
+	// Every texel holds its index and position, so copies can be traced back.
+	Image CreateIndexedImage(uint32_t width, uint32_t height, uint32_t index)
+	{
+		Image image = CreateImage(width, height);
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				uint8_t* pixel = image.GetPixel(x, y);
+				pixel[0] = static_cast<uint8_t>(index + 1);
+				pixel[1] = static_cast<uint8_t>(x);
+				pixel[2] = static_cast<uint8_t>(y);
+				pixel[3] = 255;
+			}
+		}
+		return image;
+	}
+}
+
+// Random batches and settings: the layouts keep every promise of the settings, for both heuristics.
+TEST_CASE(AtlasPackerNoOverlaps)
+{
+	std::mt19937 random{ 4 };
+
+	for (uint32_t batch = 0; batch < 24; batch++)
+	{
+		std::vector<Dimensions2D> sizes = CreateMixedSizes(50 + random() % 400, batch);
+
+		AtlasPackSettings settings{};
+		settings.gutter = random() % 3;
+		settings.mipLevels = 1 + random() % 3;
+		settings.padding = random() % 3;
+		settings.alignment = 1u << (random() % 3);
+		settings.powerOfTwo = batch % 4 == 0;
+
+		for (AtlasPackHeuristic heuristic : HEURISTICS)
+		{
+			settings.heuristic = heuristic;
+			AtlasLayout layout = PackAtlasRects(sizes, settings);
+			CheckLayout(layout, sizes, settings);
+			TEST_CHECK(layout.packedOccupancy > 0.5f);
+		}
+	}
+
+	// Equal squares tile a square exactly.
+	std::vector<Dimensions2D> squares(64, Dimensions2D{ 16, 16 });
+	AtlasPackSettings settings{};
+	settings.gutter = 0;
+	for (AtlasPackHeuristic heuristic : HEURISTICS)
+	{
+		settings.heuristic = heuristic;
+		AtlasLayout layout = PackAtlasRects(squares, settings);
+		CheckLayout(layout, squares, settings);
+		TEST_CHECK(layout.width == 128 && layout.height == 128 && layout.occupancy == 1.0f);
+	}
+}
+
+// Gutters scale with the mip count and entries are aligned to it, so in the smallest mip every entry
+// still has 'gutter' texels of its own; the atlas image replicates edge texels into them and leaves
+// the padding empty.
+TEST_CASE(AtlasPackerAlignmentAndGutters)
+{
+	AtlasPackSettings settings{};
+	settings.gutter = 1;
+	settings.mipLevels = 3;
+	settings.padding = 2;
+	settings.alignment = 4;
+
+	AtlasLayout layout = PackAtlasRects({ { 5, 3 }, { 1, 1 }, { 17, 9 } }, settings);
+	CheckLayout(layout, { { 5, 3 }, { 1, 1 }, { 17, 9 } }, settings);
+	for (const AtlasEntry& entry : layout.entries)
+		TEST_CHECK(entry.x % 4 == 0 && entry.y % 4 == 0 && entry.x >= 4 && entry.y >= 4);
+
+	// A larger alignment wins over the mip scale.
+	settings.alignment = 16;
+	layout = PackAtlasRects({ { 5, 3 }, { 1, 1 }, { 17, 9 } }, settings);
+	for (const AtlasEntry& entry : layout.entries)
+		TEST_CHECK((entry.x - 4) % 16 == 0 && (entry.y - 4) % 16 == 0);
+
+	std::vector<Image> images;
+	for (uint32_t index = 0; index < 40; index++)
+		images.push_back(CreateIndexedImage(1 + index % 9, 1 + index % 6, index));
+
+	std::vector<const Image*> imagePointers;
+	for (const Image& image : images)
+		imagePointers.push_back(&image);
+
+	settings.alignment = 1;
+	settings.mipLevels = 2;
+	ThreadPool threadPool{ 4 };
+	TextureAtlas atlas = BuildTextureAtlas(imagePointers, settings, &threadPool);
+
+	uint32_t gutter = 2;
+	std::vector<bool> written(static_cast<size_t>(atlas.image.width) * atlas.image.height, false);
+	for (uint32_t index = 0; index < images.size(); index++)
+	{
+		const AtlasEntry& entry = atlas.layout.entries[index];
+		const Image& image = images[index];
+
+		for (int32_t y = -static_cast<int32_t>(gutter); y < static_cast<int32_t>(entry.height + gutter); y++)
+		{
+			for (int32_t x = -static_cast<int32_t>(gutter); x < static_cast<int32_t>(entry.width + gutter); x++)
+			{
+				uint32_t sourceX = static_cast<uint32_t>(std::clamp(x, 0, static_cast<int32_t>(image.width) - 1));
+				uint32_t sourceY = static_cast<uint32_t>(std::clamp(y, 0, static_cast<int32_t>(image.height) - 1));
+				uint32_t atlasX = entry.x + x;
+				uint32_t atlasY = entry.y + y;
+
+				TEST_CHECK(std::equal(image.GetPixel(sourceX, sourceY), image.GetPixel(sourceX, sourceY) + IMAGE_BYTES_PER_PIXEL,
+					atlas.image.GetPixel(atlasX, atlasY)));
+				written[static_cast<size_t>(atlasY) * atlas.image.width + atlasX] = true;
+			}
+		}
+	}
+
+	// Padding and unused space stay transparent black.
+	for (uint32_t y = 0; y < atlas.image.height; y++)
+	{
+		for (uint32_t x = 0; x < atlas.image.width; x++)
+		{
+			if (written[static_cast<size_t>(y) * atlas.image.width + x])
+				continue;
+
+			const uint8_t* pixel = atlas.image.GetPixel(x, y);
+			TEST_CHECK(pixel[0] == 0 && pixel[1] == 0 && pixel[2] == 0 && pixel[3] == 0);
+		}
+	}
+
+	// The pool doesn't change a texel.
+	TextureAtlas serialAtlas = BuildTextureAtlas(imagePointers, settings);
+	TEST_CHECK(serialAtlas.image.pixels == atlas.image.pixels);
+}
+
+// The corners and center of a texture's UV square land on its entry's texels, through every overload.
+TEST_CASE(AtlasPackerRemapUvs)
+{
+	AtlasPackSettings settings{};
+	settings.gutter = 2;
+	AtlasLayout layout = PackAtlasRects({ { 30, 10 }, { 7, 50 }, { 64, 64 }, { 3, 3 } }, settings);
+
+	for (const AtlasEntry& entry : layout.entries)
+	{
+		float width = static_cast<float>(layout.width);
+		float height = static_cast<float>(layout.height);
+
+		DirectX::XMFLOAT2 uvs[] = { { 0.0f, 0.0f }, { 1.0f, 1.0f }, { 0.5f, 0.5f }, { 1.0f, 0.0f } };
+		const DirectX::XMFLOAT2 expected[] = {
+			{ entry.x / width, entry.y / height },
+			{ (entry.x + entry.width) / width, (entry.y + entry.height) / height },
+			{ (entry.x + entry.width * 0.5f) / width, (entry.y + entry.height * 0.5f) / height },
+			{ (entry.x + entry.width) / width, entry.y / height },
+		};
+
+		VertexPU verticesPU[4]{};
+		VertexPNU verticesPNU[4]{};
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			verticesPU[i].vertexPosition = DirectX::XMFLOAT3{ 1.0f, 2.0f, 3.0f };
+			verticesPU[i].vertexUv = uvs[i];
+			verticesPNU[i].vertexNormal = DirectX::XMFLOAT3{ 0.0f, 1.0f, 0.0f };
+			verticesPNU[i].vertexUv = uvs[i];
+		}
+
+		RemapAtlasUvs(uvs, 4, entry.uvTransform);
+		RemapAtlasUvs(verticesPU, 4, entry.uvTransform);
+		RemapAtlasUvs(verticesPNU, 4, entry.uvTransform);
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			TEST_CHECK(std::abs(uvs[i].x - expected[i].x) < 1e-6f && std::abs(uvs[i].y - expected[i].y) < 1e-6f);
+			TEST_CHECK(verticesPU[i].vertexUv.x == uvs[i].x && verticesPU[i].vertexUv.y == uvs[i].y);
+			TEST_CHECK(verticesPNU[i].vertexUv.x == uvs[i].x && verticesPNU[i].vertexUv.y == uvs[i].y);
+			TEST_CHECK(verticesPU[i].vertexPosition.y == 2.0f && verticesPNU[i].vertexNormal.y == 1.0f);
+		}
+	}
+}
+
+TEST_CASE(AtlasPackerDoesNotFit)
+{
+	AtlasPackSettings settings{};
+	settings.maxWidth = 64;
+	settings.maxHeight = 64;
+	settings.gutter = 0;
+
+	// 16 squares fill the maximum size exactly, one more doesn't fit.
+	for (AtlasPackHeuristic heuristic : HEURISTICS)
+	{
+		settings.heuristic = heuristic;
+		AtlasLayout layout = PackAtlasRects(std::vector<Dimensions2D>(16, Dimensions2D{ 16, 16 }), settings);
+		TEST_CHECK(layout.width == 64 && layout.height == 64);
+		TEST_CHECK_THROWS(PackAtlasRects(std::vector<Dimensions2D>(17, Dimensions2D{ 16, 16 }), settings), Error);
+	}
+
+	// A single entry larger than the maximum, once its gutters are added.
+	TEST_CHECK_THROWS(PackAtlasRects({ { 65, 1 } }, settings), Error);
+	settings.gutter = 1;
+	TEST_CHECK_THROWS(PackAtlasRects({ { 63, 1 } }, settings), Error);
+
+	settings = AtlasPackSettings{};
+	TEST_CHECK_THROWS(PackAtlasRects({ { 0, 4 } }, settings), Error);
+	settings.alignment = 3;
+	TEST_CHECK_THROWS(PackAtlasRects({ { 4, 4 } }, settings), Error);
+	settings = AtlasPackSettings{};
+	settings.mipLevels = 0;
+	TEST_CHECK_THROWS(PackAtlasRects({ { 4, 4 } }, settings), Error);
+
+	TEST_CHECK_THROWS(BuildTextureAtlas({}, AtlasPackSettings{}), Error);
+}
+
+// 10k mixed rects with a one texel gutter, against the targets of 'AtlasPackHeuristic': SKYLINE builds
+// atlases at runtime, MAX_RECTS offline.
+BENCHMARK_CASE(AtlasPackerPackRects)
+{
+	std::vector<Dimensions2D> sizes = CreateMixedSizes(10000, 1);
+
+	for (AtlasPackHeuristic heuristic : HEURISTICS)
+	{
+		double targetMilliseconds = heuristic == AtlasPackHeuristic::SKYLINE ? 5.0 : 300.0;
+
+		AtlasPackSettings settings{};
+		settings.heuristic = heuristic;
+
+		AtlasLayout layout;
+		double nanoseconds = MeasureNanosecondsPerItem(1, [&]() {
+			layout = PackAtlasRects(sizes, settings);
+		}, heuristic == AtlasPackHeuristic::SKYLINE ? 10 : 3);
+
+		std::string name = GetHeuristicName(heuristic);
+		ReportMetric(name + ", 10k mixed rects", nanoseconds * 1.0e-6, "ms");
+		ReportMetric(name + ", target", targetMilliseconds, "ms");
+		ReportMetric(name + ", occupancy", layout.occupancy, "");
+		ReportMetric(name + ", packed occupancy", layout.packedOccupancy, "");
+	}
+}
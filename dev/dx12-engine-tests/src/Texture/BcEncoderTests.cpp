@@ -0,0 +1,490 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Texture/BcEncoder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+using namespace dxe;
+
+// The encoder is checked by decoding its blocks with a small reference decoder written from the
+// format specification, independent of the encoder's own tables, and measuring the PSNR.
+
+namespace
+{
+	constexpr uint32_t BLOCK_BYTES = 4 * 4 * IMAGE_BYTES_PER_PIXEL;
+
+	// Reference decoder
+
+	void DecodeRgb565(uint16_t color, int rgb[3])
+	{
+		int red = (color >> 11) & 31;
+		int green = (color >> 5) & 63;
+		int blue = color & 31;
+
+		rgb[0] = (red << 3) | (red >> 2);
+		rgb[1] = (green << 2) | (green >> 4);
+		rgb[2] = (blue << 3) | (blue >> 2);
+	}
+
+	// BC3 color blocks always use the four color mode.
+	void DecodeBc1Block(const uint8_t* block, uint8_t* pixels, bool alwaysFourColors)
+	{
+		uint16_t color0 = static_cast<uint16_t>(block[0] | (block[1] << 8));
+		uint16_t color1 = static_cast<uint16_t>(block[2] | (block[3] << 8));
+
+		int palette[4][4]{};
+		DecodeRgb565(color0, palette[0]);
+		DecodeRgb565(color1, palette[1]);
+
+		for (int channel = 0; channel < 3; channel++)
+		{
+			if (color0 > color1 || alwaysFourColors)
+			{
+				palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+				palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+			}
+			else
+			{
+				palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+				palette[3][channel] = 0;
+			}
+		}
+		palette[0][3] = palette[1][3] = palette[2][3] = 255;
+		palette[3][3] = color0 > color1 || alwaysFourColors ? 255 : 0;
+
+		uint32_t indices;
+		std::memcpy(&indices, block + 4, sizeof(indices));
+
+		for (uint32_t pixel = 0; pixel < 16; pixel++)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+				pixels[pixel * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (2 * pixel)) & 3][channel]);
+		}
+	}
+
+	void DecodeBc4Block(const uint8_t* block, uint8_t* pixels, uint32_t channel)
+	{
+		int palette[8]{ block[0], block[1] };
+		if (palette[0] > palette[1])
+		{
+			for (int entry = 2; entry < 8; entry++)
+				palette[entry] = ((8 - entry) * palette[0] + (entry - 1) * palette[1]) / 7;
+		}
+		else
+		{
+			for (int entry = 2; entry < 6; entry++)
+				palette[entry] = ((6 - entry) * palette[0] + (entry - 1) * palette[1]) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		uint64_t indices{ 0 };
+		for (uint32_t byte = 0; byte < 6; byte++)
+			indices |= static_cast<uint64_t>(block[2 + byte]) << (8 * byte);
+
+		for (uint32_t pixel = 0; pixel < 16; pixel++)
+			pixels[pixel * 4 + channel] = static_cast<uint8_t>(palette[(indices >> (3 * pixel)) & 7]);
+	}
+
+	// Two subset partitions of BC7 (one bit per pixel, set for subset 1) and the anchor index of subset 1.
+	constexpr uint16_t BC7_PARTITIONS[64] = {
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+	};
+	constexpr uint8_t BC7_ANCHORS[64] = {
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+		15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+		6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+	};
+	constexpr int BC7_WEIGHTS3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	constexpr int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	class BitReader
+	{
+	public:
+
+		explicit BitReader(const uint8_t* data)
+			: data(data)
+		{
+		}
+
+		int Read(uint32_t bitCount)
+		{
+			int value{ 0 };
+			for (uint32_t bit = 0; bit < bitCount; bit++, position++)
+				value |= ((data[position >> 3] >> (position & 7)) & 1) << bit;
+			return value;
+		}
+
+	private:
+
+		const uint8_t* data{ nullptr };
+		uint32_t position{ 0 };
+	};
+
+	int InterpolateBc7(int endpoint0, int endpoint1, int weight)
+	{
+		return ((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6;
+	}
+
+	// Only modes 1 and 6, the ones the encoder writes. Returns false for any other mode.
+	bool DecodeBc7Block(const uint8_t* block, uint8_t* pixels)
+	{
+		BitReader reader{ block };
+
+		uint32_t mode{ 0 };
+		while (mode < 8 && reader.Read(1) == 0)
+			mode++;
+
+		if (mode == 6)
+		{
+			int endpoints[2][4];
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				endpoints[0][channel] = reader.Read(7);
+				endpoints[1][channel] = reader.Read(7);
+			}
+			for (uint32_t endpoint = 0; endpoint < 2; endpoint++)
+			{
+				int pBit = reader.Read(1);
+				for (int& value : endpoints[endpoint])
+					value = (value << 1) | pBit;
+			}
+
+			for (uint32_t pixel = 0; pixel < 16; pixel++)
+			{
+				int weight = BC7_WEIGHTS4[reader.Read(pixel == 0 ? 3 : 4)];
+				for (uint32_t channel = 0; channel < 4; channel++)
+					pixels[pixel * 4 + channel] = static_cast<uint8_t>(InterpolateBc7(endpoints[0][channel], endpoints[1][channel], weight));
+			}
+			return true;
+		}
+
+		if (mode == 1)
+		{
+			int partition = reader.Read(6);
+
+			int endpoints[4][3];
+			for (uint32_t channel = 0; channel < 3; channel++)
+			{
+				for (uint32_t endpoint = 0; endpoint < 4; endpoint++)
+					endpoints[endpoint][channel] = reader.Read(6);
+			}
+			int pBits[2] = { reader.Read(1), reader.Read(1) };
+			for (uint32_t endpoint = 0; endpoint < 4; endpoint++)
+			{
+				for (int& value : endpoints[endpoint])
+				{
+					value = (value << 1) | pBits[endpoint / 2];
+					value = (value << 1) | (value >> 6);
+				}
+			}
+
+			for (uint32_t pixel = 0; pixel < 16; pixel++)
+			{
+				int subset = (BC7_PARTITIONS[partition] >> pixel) & 1;
+				bool anchor = pixel == 0 || pixel == BC7_ANCHORS[partition];
+				int weight = BC7_WEIGHTS3[reader.Read(anchor ? 2 : 3)];
+
+				for (uint32_t channel = 0; channel < 3; channel++)
+					pixels[pixel * 4 + channel] = static_cast<uint8_t>(InterpolateBc7(endpoints[2 * subset][channel], endpoints[2 * subset + 1][channel], weight));
+				pixels[pixel * 4 + 3] = 255;
+			}
+			return true;
+		}
+
+		return false;
+	}
+
+	bool DecodeBlock(TextureFormat format, const uint8_t* block, uint8_t* pixels)
+	{
+		switch (GetLinearTextureFormat(format))
+		{
+		case TextureFormat::BC1_UNORM:
+			DecodeBc1Block(block, pixels, false);
+			return true;
+		case TextureFormat::BC3_UNORM:
+			DecodeBc1Block(block + 8, pixels, true);
+			DecodeBc4Block(block, pixels, 3);
+			return true;
+		case TextureFormat::BC4_UNORM:
+			DecodeBc4Block(block, pixels, 0);
+			return true;
+		case TextureFormat::BC5_UNORM:
+			DecodeBc4Block(block, pixels, 0);
+			DecodeBc4Block(block + 8, pixels, 1);
+			return true;
+		case TextureFormat::BC7_UNORM:
+			return DecodeBc7Block(block, pixels);
+		default:
+			return false;
+		}
+	}
+
+	// Channels each format stores: BC1 is opaque, BC4 keeps red and BC5 red and green.
+	uint32_t GetEncodedChannelCount(TextureFormat format)
+	{
+		switch (GetLinearTextureFormat(format))
+		{
+		case TextureFormat::BC1_UNORM: return 3;
+		case TextureFormat::BC4_UNORM: return 1;
+		case TextureFormat::BC5_UNORM: return 2;
+		default:                       return 4;
+		}
+	}
+
+	// Decodes 'data' and compares it against the encoded channels of 'image'. Returns 0 if a block
+	// doesn't decode.
+	double CalculatePsnr(const Image& image, const std::vector<uint8_t>& data, TextureFormat format)
+	{
+		uint32_t bytesPerBlock = GetTextureFormatInfo(format).bytesPerBlock;
+		uint32_t channelCount = GetEncodedChannelCount(format);
+		uint32_t blocksWide = (image.width + 3) / 4;
+		uint32_t blocksHigh = (image.height + 3) / 4;
+
+		if (data.size() != static_cast<size_t>(blocksWide) * blocksHigh * bytesPerBlock)
+			return 0.0;
+
+		double squaredError{ 0.0 };
+		for (uint32_t blockY = 0; blockY < blocksHigh; blockY++)
+		{
+			for (uint32_t blockX = 0; blockX < blocksWide; blockX++)
+			{
+				uint8_t pixels[BLOCK_BYTES]{};
+				if (!DecodeBlock(format, &data[(static_cast<size_t>(blockY) * blocksWide + blockX) * bytesPerBlock], pixels))
+					return 0.0;
+
+				for (uint32_t y = 0; y < 4 && blockY * 4 + y < image.height; y++)
+				{
+					for (uint32_t x = 0; x < 4 && blockX * 4 + x < image.width; x++)
+					{
+						const uint8_t* source = image.GetPixel(blockX * 4 + x, blockY * 4 + y);
+						for (uint32_t channel = 0; channel < channelCount; channel++)
+						{
+							double error = static_cast<double>(source[channel]) - pixels[(y * 4 + x) * 4 + channel];
+							squaredError += error * error;
+						}
+					}
+				}
+			}
+		}
+
+		double meanSquaredError = squaredError / (static_cast<double>(image.width) * image.height * channelCount);
+		return meanSquaredError == 0.0 ? INFINITY : 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+	}
+
+	// Smooth shading in red, a gradient in green, the hard edges of a checkerboard in blue and an
+	// alpha gradient, with a little noise on top.
+	Image CreateTestImage(uint32_t width, uint32_t height)
+	{
+		Image image = CreateImage(width, height);
+
+		uint32_t state{ 1 };
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				state = state * 1664525u + 1013904223u;
+				int noise = static_cast<int>((state >> 24) % 9) - 4;
+
+				uint8_t* pixel = image.GetPixel(x, y);
+				pixel[0] = static_cast<uint8_t>(std::clamp(static_cast<int>(128.0 + 100.0 * std::sin(x * 0.05) * std::cos(y * 0.03)) + noise, 0, 255));
+				pixel[1] = static_cast<uint8_t>(std::clamp(static_cast<int>(x * 255 / width) + noise, 0, 255));
+				pixel[2] = ((x / 16 + y / 16) & 1) ? 200 : 40;
+				pixel[3] = static_cast<uint8_t>(y * 255 / height);
+			}
+		}
+		return image;
+	}
+
+	struct FormatCase
+	{
+		const char* name;
+		TextureFormat format;
+	};
+
+	constexpr FormatCase FORMAT_CASES[] = {
+		{ "BC1", TextureFormat::BC1_UNORM },
+		{ "BC3", TextureFormat::BC3_UNORM },
+		{ "BC4", TextureFormat::BC4_UNORM },
+		{ "BC5", TextureFormat::BC5_UNORM },
+		{ "BC7", TextureFormat::BC7_UNORM },
+	};
+}
+
+// A block of one color comes back exactly when the format can store it: 565 colors in BC1 and any
+// value in BC4. BC7 mode 6 shares the P-bit between the channels of an endpoint, so channels of
+// different parity may come back off by one.
+TEST_CASE(BcEncoderSolidBlocks)
+{
+	for (BcEncodeQuality quality : { BcEncodeQuality::FAST, BcEncodeQuality::HIGH })
+	{
+		uint8_t pixels[BLOCK_BYTES];
+		for (uint32_t pixel = 0; pixel < 16; pixel++)
+		{
+			pixels[pixel * 4 + 0] = 255;
+			pixels[pixel * 4 + 1] = 130;
+			pixels[pixel * 4 + 2] = 66;
+			pixels[pixel * 4 + 3] = 77;
+		}
+
+		uint8_t block[16];
+		uint8_t decoded[BLOCK_BYTES];
+
+		EncodeBc1Block(pixels, block, quality);
+		DecodeBc1Block(block, decoded, false);
+		for (uint32_t pixel = 0; pixel < 16; pixel++)
+			TEST_CHECK(std::memcmp(&decoded[pixel * 4], pixels, 3) == 0 && decoded[pixel * 4 + 3] == 255);
+
+		EncodeBc4Block(pixels, block, quality);
+		DecodeBc4Block(block, decoded, 0);
+		for (uint32_t pixel = 0; pixel < 16; pixel++)
+			TEST_CHECK(decoded[pixel * 4] == 255);
+
+		EncodeBc3Block(pixels, block, quality);
+		DecodeBlock(TextureFormat::BC3_UNORM, block, decoded);
+		for (uint32_t pixel = 0; pixel < 16; pixel++)
+			TEST_CHECK(std::memcmp(&decoded[pixel * 4], pixels, 4) == 0);
+
+		EncodeBc7Block(pixels, block, quality);
+		TEST_CHECK(DecodeBc7Block(block, decoded));
+		for (uint32_t i = 0; i < BLOCK_BYTES; i++)
+			TEST_CHECK(std::abs(decoded[i] - pixels[i]) <= 1);
+	}
+}
+
+// Quality floors on the test image, a little below what the encoder reaches today. High quality is
+// never worse than fast.
+TEST_CASE(BcEncoderPsnr)
+{
+	struct PsnrFloor
+	{
+		TextureFormat format;
+		double fast;
+		double high;
+	};
+	const PsnrFloor floors[] = {
+		{ TextureFormat::BC1_UNORM, 41.5, 42.0 },
+		{ TextureFormat::BC3_UNORM, 43.0, 43.5 },
+		{ TextureFormat::BC4_UNORM, 51.0, 51.5 },
+		{ TextureFormat::BC5_UNORM, 53.0, 53.5 },
+		{ TextureFormat::BC7_UNORM, 46.0, 47.0 },
+	};
+
+	Image image = CreateTestImage(256, 256);
+
+	for (const PsnrFloor& floor : floors)
+	{
+		double fast = CalculatePsnr(image, EncodeBcImage(image, { floor.format, BcEncodeQuality::FAST }), floor.format);
+		double high = CalculatePsnr(image, EncodeBcImage(image, { floor.format, BcEncodeQuality::HIGH }), floor.format);
+
+		TEST_CHECK(fast >= floor.fast);
+		TEST_CHECK(high >= floor.high);
+		TEST_CHECK(high >= fast);
+	}
+}
+
+// Opaque blocks let high quality BC7 use the two subset mode 1.
+TEST_CASE(BcEncoderBc7OpaquePartitions)
+{
+	Image image = CreateTestImage(128, 128);
+	for (size_t alpha = 3; alpha < image.pixels.size(); alpha += 4)
+		image.pixels[alpha] = 255;
+
+	std::vector<uint8_t> fast = EncodeBcImage(image, { TextureFormat::BC7_UNORM, BcEncodeQuality::FAST });
+	std::vector<uint8_t> high = EncodeBcImage(image, { TextureFormat::BC7_UNORM, BcEncodeQuality::HIGH });
+
+	uint32_t mode1Blocks{ 0 };
+	for (size_t block = 0; block < high.size(); block += 16)
+	{
+		if (high[block] == 0x02)
+			mode1Blocks++;
+	}
+	TEST_CHECK(mode1Blocks > 0);
+
+	double fastPsnr = CalculatePsnr(image, fast, TextureFormat::BC7_UNORM);
+	double highPsnr = CalculatePsnr(image, high, TextureFormat::BC7_UNORM);
+	TEST_CHECK(fastPsnr >= 45.0 && highPsnr >= fastPsnr + 2.0);
+}
+
+// Sizes that aren't a multiple of 4 round up to whole blocks, the edge blocks repeating the last
+// row and column, which the PSNR over the real pixels sees.
+TEST_CASE(BcEncoderOddSizes)
+{
+	Image image = CreateTestImage(13, 7);
+
+	std::vector<uint8_t> data = EncodeBcImage(image, { TextureFormat::BC1_UNORM, BcEncodeQuality::HIGH });
+	TEST_CHECK(data.size() == 4 * 2 * 8);
+	TEST_CHECK(CalculatePsnr(image, data, TextureFormat::BC1_UNORM) >= 38.0);
+
+	std::vector<Image> mips{ CreateTestImage(64, 64), CreateTestImage(32, 32), CreateTestImage(2, 2), CreateTestImage(1, 1) };
+	TEST_CHECK(EncodeBcMipChain(mips, { TextureFormat::BC7_UNORM, BcEncodeQuality::FAST }).size() == (256 + 64 + 1 + 1) * 16);
+}
+
+TEST_CASE(BcEncoderRejectsInvalidInput)
+{
+	TEST_CHECK(IsBcEncodeFormatSupported(TextureFormat::BC7_UNORM_SRGB));
+	TEST_CHECK(!IsBcEncodeFormatSupported(TextureFormat::BC6H_UF16));
+
+	TEST_CHECK_THROWS(EncodeBcImage(CreateImage(4, 4), { TextureFormat::BC2_UNORM, BcEncodeQuality::FAST }), Error);
+	TEST_CHECK_THROWS(EncodeBcImage(Image{}, BcEncodeSettings{}), Error);
+}
+
+// Block rows are encoded independently, so the pool must not change a byte. sRGB formats encode
+// the same data as their linear counterparts.
+TEST_CASE(BcEncoderOutputDoesNotDependOnThreads)
+{
+	ThreadPool threadPool{ 4 };
+	Image image = CreateTestImage(100, 60);
+
+	for (const FormatCase& formatCase : FORMAT_CASES)
+	{
+		for (BcEncodeQuality quality : { BcEncodeQuality::FAST, BcEncodeQuality::HIGH })
+		{
+			std::vector<uint8_t> serial = EncodeBcImage(image, { formatCase.format, quality });
+			TEST_CHECK(serial == EncodeBcImage(image, { formatCase.format, quality }, &threadPool));
+		}
+	}
+
+	TEST_CHECK(EncodeBcImage(image, { TextureFormat::BC7_UNORM_SRGB, BcEncodeQuality::FAST }) ==
+		EncodeBcImage(image, { TextureFormat::BC7_UNORM, BcEncodeQuality::FAST }));
+}
+
+// Encoding speed of a 1024x1024 image per format and quality, on one thread and on the pool, with
+// the PSNR each reaches next to it.
+BENCHMARK_CASE(BcEncoderThroughput)
+{
+	constexpr uint32_t size = 1024;
+	constexpr double megapixels = size * size / 1.0e6;
+
+	Image image = CreateTestImage(size, size);
+	ThreadPool threadPool{};
+
+	for (const FormatCase& formatCase : FORMAT_CASES)
+	{
+		for (BcEncodeQuality quality : { BcEncodeQuality::FAST, BcEncodeQuality::HIGH })
+		{
+			std::string label = std::string(formatCase.name) + (quality == BcEncodeQuality::FAST ? " fast" : " high");
+			BcEncodeSettings settings{ formatCase.format, quality };
+
+			std::vector<uint8_t> data;
+			double serial = MeasureNanosecondsPerItem(1, [&]() {
+				data = EncodeBcImage(image, settings);
+			}, 1);
+			double threaded = MeasureNanosecondsPerItem(1, [&]() {
+				KeepValue(EncodeBcImage(image, settings, &threadPool).size());
+			}, 3);
+
+			ReportMetric(label + ", 1 thread", megapixels / (serial * 1.0e-9), "MPixel/s");
+			ReportMetric(label + ", thread pool", megapixels / (threaded * 1.0e-9), "MPixel/s");
+			ReportMetric(label + ", PSNR", CalculatePsnr(image, data, formatCase.format), "dB");
+		}
+	}
+}
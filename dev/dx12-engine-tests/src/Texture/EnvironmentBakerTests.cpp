@@ -0,0 +1,384 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Renderer/Color.h"
+#include "Texture/EnvironmentBaker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+using namespace dxe;
+using namespace DirectX;
+
+// The bakers are compared against brute-force references: numerical integrals over the sphere and
+// sums over every texel of the source, written for clarity rather than speed.
+
+namespace
+{
+	constexpr double PI = 3.14159265358979323846;
+
+	using Radiance = std::function<XMFLOAT4(const XMFLOAT3& direction)>;
+
+	FloatCubemap CreateCubemap(uint32_t size, const Radiance& radiance)
+	{
+		FloatCubemap cubemap = CreateFloatCubemap(size);
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			float* surface = cubemap.GetSurface(0, face);
+			for (uint32_t y = 0; y < size; y++)
+			{
+				for (uint32_t x = 0; x < size; x++)
+				{
+					XMFLOAT4 value = radiance(GetCubemapDirection(face, (x + 0.5f) / size, (y + 0.5f) / size));
+
+					float* texel = surface + (static_cast<size_t>(y) * size + x) * 4;
+					texel[0] = value.x;
+					texel[1] = value.y;
+					texel[2] = value.z;
+					texel[3] = value.w;
+				}
+			}
+		}
+		return cubemap;
+	}
+
+	XMFLOAT3 GetTexelDirection(const FloatCubemap& cubemap, uint32_t mip, uint32_t face, uint32_t x, uint32_t y)
+	{
+		uint32_t size = cubemap.GetMipSize(mip);
+		return GetCubemapDirection(face, (x + 0.5f) / size, (y + 0.5f) / size);
+	}
+
+	const float* GetTexel(const FloatCubemap& cubemap, uint32_t mip, uint32_t face, uint32_t x, uint32_t y)
+	{
+		return cubemap.GetSurface(mip, face) + (static_cast<size_t>(y) * cubemap.GetMipSize(mip) + x) * 4;
+	}
+
+	double Dot(const XMFLOAT3& a, const XMFLOAT3& b)
+	{
+		return static_cast<double>(a.x) * b.x + static_cast<double>(a.y) * b.y + static_cast<double>(a.z) * b.z;
+	}
+
+	// Solid angle of the texel (x, y) of a face of 'size' texels.
+	double CalculateTexelSolidAngle(uint32_t size, uint32_t x, uint32_t y)
+	{
+		auto areaElement = [](double s, double t) { return std::atan2(s * t, std::sqrt(s * s + t * t + 1.0)); };
+
+		double s0 = 2.0 * x / size - 1.0;
+		double t0 = 2.0 * y / size - 1.0;
+		double s1 = 2.0 * (x + 1) / size - 1.0;
+		double t1 = 2.0 * (y + 1) / size - 1.0;
+		return areaElement(s0, t0) - areaElement(s0, t1) - areaElement(s1, t0) + areaElement(s1, t1);
+	}
+
+	// Cosine-weighted integral of the red channel of 'radiance' around 'normal', divided by pi, on a
+	// latitude-longitude grid.
+	double IntegrateIrradiance(const Radiance& radiance, const XMFLOAT3& normal)
+	{
+		constexpr uint32_t steps = 400;
+		constexpr double step = PI / steps;
+
+		double sum{ 0.0 };
+		for (uint32_t latitude = 0; latitude < steps; latitude++)
+		{
+			double theta = (latitude + 0.5) * step;
+			for (uint32_t longitude = 0; longitude < 2 * steps; longitude++)
+			{
+				double phi = (longitude + 0.5) * step;
+				XMFLOAT3 direction{
+					static_cast<float>(std::sin(theta) * std::cos(phi)),
+					static_cast<float>(std::cos(theta)),
+					static_cast<float>(std::sin(theta) * std::sin(phi)) };
+
+				double cosine = std::max(0.0, Dot(normal, direction));
+				sum += radiance(direction).x * cosine * std::sin(theta) * step * step;
+			}
+		}
+		return sum / PI;
+	}
+
+	// What importance sampling converges to: every source texel weighted by D(h) * N.L / 4 and its
+	// solid angle, with N = V = R.
+	XMFLOAT3 IntegrateGgx(const FloatCubemap& source, const XMFLOAT3& normal, float roughness)
+	{
+		double alpha = static_cast<double>(roughness) * roughness;
+		double alphaSquared = alpha * alpha;
+		uint32_t size = source.size;
+
+		double sum[3]{};
+		double weightSum{ 0.0 };
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			for (uint32_t y = 0; y < size; y++)
+			{
+				for (uint32_t x = 0; x < size; x++)
+				{
+					XMFLOAT3 light = GetTexelDirection(source, 0, face, x, y);
+					double normalDotLight = Dot(normal, light);
+					if (normalDotLight <= 0.0)
+						continue;
+
+					XMFLOAT3 half{ normal.x + light.x, normal.y + light.y, normal.z + light.z };
+					double normalDotHalf = Dot(normal, half) / std::sqrt(Dot(half, half));
+					double denominator = normalDotHalf * normalDotHalf * (alphaSquared - 1.0) + 1.0;
+					double distribution = alphaSquared / (PI * denominator * denominator);
+
+					double weight = distribution * 0.25 * normalDotLight * CalculateTexelSolidAngle(size, x, y);
+					const float* texel = GetTexel(source, 0, face, x, y);
+					for (uint32_t channel = 0; channel < 3; channel++)
+						sum[channel] += weight * texel[channel];
+					weightSum += weight;
+				}
+			}
+		}
+
+		return XMFLOAT3{
+			static_cast<float>(sum[0] / weightSum), static_cast<float>(sum[1] / weightSum), static_cast<float>(sum[2] / weightSum) };
+	}
+
+	XMFLOAT4 ConstantRadiance(const XMFLOAT3&)
+	{
+		return XMFLOAT4{ 0.5f, 1.0f, 2.0f, 1.0f };
+	}
+
+	// Largest difference of any channel of any texel of any mip to 'value'.
+	float CalculateMaximumDeviation(const FloatCubemap& cubemap, const XMFLOAT4& value)
+	{
+		const float values[4] = { value.x, value.y, value.z, value.w };
+
+		float deviation{ 0.0f };
+		for (const std::vector<float>& surface : cubemap.surfaces)
+		{
+			for (size_t i = 0; i < surface.size(); i++)
+				deviation = std::max(deviation, std::fabs(surface[i] - values[i % 4]));
+		}
+		return deviation;
+	}
+}
+
+TEST_CASE(EnvironmentBakerDirectionRoundTrip)
+{
+	for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+	{
+		for (uint32_t i = 0; i < 64; i++)
+		{
+			float u = (i % 8 + 0.5f) / 8.0f;
+			float v = (i / 8 + 0.5f) / 8.0f;
+
+			XMFLOAT3 direction = GetCubemapDirection(face, u, v);
+			TEST_CHECK(std::fabs(Dot(direction, direction) - 1.0) < 1.0e-5);
+
+			uint32_t roundTripFace;
+			float roundTripU, roundTripV;
+			GetCubemapFaceUv(direction, roundTripFace, roundTripU, roundTripV);
+			TEST_CHECK(roundTripFace == face && std::fabs(roundTripU - u) < 1.0e-5f && std::fabs(roundTripV - v) < 1.0e-5f);
+		}
+	}
+
+	// D3D orientation: the centers of the faces.
+	TEST_CHECK(GetCubemapDirection(0, 0.5f, 0.5f).x == 1.0f);
+	TEST_CHECK(GetCubemapDirection(3, 0.5f, 0.5f).y == -1.0f);
+	TEST_CHECK(GetCubemapDirection(4, 0.5f, 0.5f).z == 1.0f);
+}
+
+// Texels cover the sphere once, corners less than the face center.
+TEST_CASE(EnvironmentBakerTexelSolidAngles)
+{
+	for (uint32_t size : { 1u, 7u, 256u })
+	{
+		double sum{ 0.0 };
+		for (uint32_t y = 0; y < size; y++)
+		{
+			for (uint32_t x = 0; x < size; x++)
+				sum += CalculateCubemapTexelSolidAngle(x, y, size);
+		}
+		TEST_CHECK(std::fabs(CUBEMAP_FACE_COUNT * sum - 4.0 * PI) < 1.0e-4);
+	}
+
+	TEST_CHECK(CalculateCubemapTexelSolidAngle(0, 0, 8) < CalculateCubemapTexelSolidAngle(3, 3, 8));
+	TEST_CHECK(CalculateCubemapTexelSolidAngle(0, 2, 8) == CalculateCubemapTexelSolidAngle(2, 7, 8));
+}
+
+// A constant environment stays constant through every bake: the weights are normalized.
+TEST_CASE(EnvironmentBakerKeepsConstantEnvironments)
+{
+	ThreadPool threadPool{ 4 };
+	FloatCubemap source = CreateCubemap(64, ConstantRadiance);
+	XMFLOAT4 value = ConstantRadiance(XMFLOAT3{});
+
+	SpecularPrefilterSettings specularSettings{};
+	specularSettings.size = 32;
+	specularSettings.mipLevels = 5;
+	specularSettings.sampleCount = 64;
+	FloatCubemap specular = PrefilterSpecular(source, specularSettings, &threadPool);
+	TEST_CHECK(specular.size == 32 && specular.mipLevels == 5);
+	TEST_CHECK(CalculateMaximumDeviation(specular, value) < 1.0e-4f);
+
+	IrradianceSettings irradianceSettings{};
+	irradianceSettings.size = 16;
+	irradianceSettings.sourceSize = 32;
+	TEST_CHECK(CalculateMaximumDeviation(ConvolveIrradiance(source, irradianceSettings, &threadPool), value) < 2.0e-3f);
+
+	FloatCubemap mips = source;
+	GenerateCubemapMips(mips, 0, &threadPool);
+	TEST_CHECK(mips.mipLevels == 7);
+	TEST_CHECK(CalculateMaximumDeviation(mips, value) < 1.0e-6f);
+}
+
+// Sky light max(0, y) against the integral of the cosine lobe over the sphere.
+TEST_CASE(EnvironmentBakerIrradianceMatchesReference)
+{
+	Radiance sky = [](const XMFLOAT3& direction) {
+		float value = std::max(0.0f, direction.y);
+		return XMFLOAT4{ value, value, value, 1.0f };
+	};
+
+	IrradianceSettings settings{};
+	settings.size = 16;
+	settings.sourceSize = 64;
+	FloatCubemap irradiance = ConvolveIrradiance(CreateCubemap(64, sky), settings);
+
+	double maximumError{ 0.0 };
+	for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+	{
+		for (uint32_t texel = 2; texel < 16; texel += 4)
+		{
+			XMFLOAT3 normal = GetTexelDirection(irradiance, 0, face, texel, texel);
+			double reference = IntegrateIrradiance(sky, normal);
+			maximumError = std::max(maximumError, std::fabs(GetTexel(irradiance, 0, face, texel, texel)[0] - reference));
+		}
+	}
+	TEST_CHECK(maximumError < 5.0e-3);
+}
+
+// The rough mips of a small environment with smooth and hard features against the GGX lobe summed
+// over every source texel.
+TEST_CASE(EnvironmentBakerSpecularMatchesReference)
+{
+	Radiance environment = [](const XMFLOAT3& direction) {
+		return XMFLOAT4{ std::exp(4.0f * (direction.x - 1.0f)), 0.5f + 0.5f * direction.y, direction.z > 0.5f ? 1.0f : 0.0f, 1.0f };
+	};
+	FloatCubemap source = CreateCubemap(16, environment);
+
+	SpecularPrefilterSettings settings{};
+	settings.size = 8;
+	settings.mipLevels = 3;
+	settings.sampleCount = 1024;
+	FloatCubemap specular = PrefilterSpecular(source, settings);
+
+	double errorSum{ 0.0 };
+	uint32_t valueCount{ 0 };
+	for (uint32_t mip = 1; mip < settings.mipLevels; mip++)
+	{
+		float roughness = GetPrefilteredRoughness(mip, settings.mipLevels);
+		uint32_t size = specular.GetMipSize(mip);
+
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			for (uint32_t y = 0; y < size; y++)
+			{
+				for (uint32_t x = 0; x < size; x++)
+				{
+					XMFLOAT3 reference = IntegrateGgx(source, GetTexelDirection(specular, mip, face, x, y), roughness);
+					const float* texel = GetTexel(specular, mip, face, x, y);
+
+					errorSum += std::fabs(texel[0] - reference.x) + std::fabs(texel[1] - reference.y) + std::fabs(texel[2] - reference.z);
+					valueCount += 3;
+				}
+			}
+		}
+	}
+	TEST_CHECK(errorSum / valueCount < 0.01);
+
+	// Mip 0 is the mirror reflection.
+	TEST_CHECK(GetPrefilteredRoughness(0, settings.mipLevels) == 0.0f);
+	TEST_CHECK(std::fabs(GetTexel(specular, 0, 4, 4, 4)[2] - 1.0f) < 1.0e-3f);
+}
+
+// Upper half white, lower half black: +Y is white and -Y black.
+TEST_CASE(EnvironmentBakerConvertsEquirectangular)
+{
+	constexpr uint32_t width = 256;
+	constexpr uint32_t height = 128;
+
+	std::vector<float> pixels(width * height * 4);
+	for (uint32_t y = 0; y < height; y++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			float* pixel = &pixels[(y * width + x) * 4];
+			pixel[0] = pixel[1] = pixel[2] = y < height / 2 ? 1.0f : 0.0f;
+			pixel[3] = 1.0f;
+		}
+	}
+
+	ThreadPool threadPool{ 4 };
+	FloatCubemap cubemap = ConvertEquirectangularToCubemap(pixels.data(), width, height, 32, &threadPool);
+
+	TEST_CHECK(cubemap.size == 32 && cubemap.mipLevels == 1);
+	TEST_CHECK(GetTexel(cubemap, 0, 2, 16, 16)[0] == 1.0f);
+	TEST_CHECK(GetTexel(cubemap, 0, 3, 16, 16)[0] == 0.0f);
+}
+
+TEST_CASE(EnvironmentBakerUploadData)
+{
+	FloatCubemap cubemap = CreateCubemap(32, ConstantRadiance);
+	GenerateCubemapMips(cubemap, 5);
+
+	CubemapUploadData upload = CreateCubemapUploadData(cubemap);
+	TEST_CHECK(upload.layout.footprints.size() == CUBEMAP_FACE_COUNT * 5);
+	TEST_CHECK(upload.data.size() == upload.layout.totalBytes);
+
+	// Blue of the first texel of mip 0 of +Y, as a half.
+	const TextureSubresourceFootprint& footprint = upload.layout.footprints[CalculateSubresourceIndex(0, 2, 5)];
+	uint16_t blue;
+	std::memcpy(&blue, upload.data.data() + footprint.offset + 2 * sizeof(uint16_t), sizeof(blue));
+	TEST_CHECK(HalfToFloat(blue) == 2.0f);
+
+	TEST_CHECK_THROWS(CreateCubemapUploadData(cubemap, TextureFormat::R8G8B8A8_UNORM), Error);
+}
+
+// Milliseconds of each bake at the sizes the renderer uses, on one thread and on the pool.
+BENCHMARK_CASE(EnvironmentBakerTimings)
+{
+	ThreadPool threadPool{};
+
+	std::vector<float> equirectangular(2048 * 1024 * 4);
+	for (size_t i = 0; i < equirectangular.size(); i++)
+		equirectangular[i] = static_cast<float>(i % 13) * 0.1f;
+
+	FloatCubemap base = ConvertEquirectangularToCubemap(equirectangular.data(), 2048, 1024, 512, &threadPool);
+	FloatCubemap source = base;
+	GenerateCubemapMips(source, 0, &threadPool);
+
+	auto measureMilliseconds = [](const std::function<void()>& bake) {
+		return MeasureNanosecondsPerItem(1, bake, 1) * 1.0e-6;
+	};
+
+	for (ThreadPool* pool : { static_cast<ThreadPool*>(nullptr), &threadPool })
+	{
+		std::string suffix = pool ? ", thread pool" : ", 1 thread";
+
+		ReportMetric("equirectangular 2048x1024 to 512 cube" + suffix, measureMilliseconds([&]() {
+			KeepValue(ConvertEquirectangularToCubemap(equirectangular.data(), 2048, 1024, 512, pool).size);
+		}), "ms");
+
+		// Includes copying mip 0.
+		ReportMetric("mips of a 512 cube" + suffix, measureMilliseconds([&]() {
+			FloatCubemap mips = base;
+			GenerateCubemapMips(mips, 0, pool);
+			KeepValue(mips.mipLevels);
+		}), "ms");
+
+		SpecularPrefilterSettings specularSettings{};
+		specularSettings.size = 128;
+		ReportMetric("specular 128 cube, 6 mips, 256 samples" + suffix, measureMilliseconds([&]() {
+			KeepValue(PrefilterSpecular(source, specularSettings, pool).size);
+		}), "ms");
+
+		ReportMetric("irradiance 32 cube from 64" + suffix, measureMilliseconds([&]() {
+			KeepValue(ConvolveIrradiance(source, IrradianceSettings{}, pool).size);
+		}), "ms");
+	}
+}
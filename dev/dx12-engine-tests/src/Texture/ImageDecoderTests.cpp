@@ -0,0 +1,404 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Texture/ImageDecoder.h"
+#include "Texture/PixelConversion.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+
+using namespace dxe;
+
+// Files are written by small encoders in this file, from an image the decoders must give back.
+
+namespace
+{
+	// Noisy gradients in the upper half like a photo, flat areas in the lower half like UI art, which
+	// is where the run-length and QOI run/index paths get used.
+	Image CreateTestImage(uint32_t width, uint32_t height)
+	{
+		Image image = CreateImage(width, height, TextureFormat::R8G8B8A8_UNORM_SRGB);
+		std::mt19937 random{ 3 };
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			for (uint32_t x = 0; x < width; x++)
+			{
+				uint8_t* pixel = image.GetPixel(x, y);
+				if (y < height / 2)
+				{
+					uint32_t noise = random() % 6;
+					pixel[0] = static_cast<uint8_t>(x * 255 / width + noise);
+					pixel[1] = static_cast<uint8_t>(y * 255 / height + noise);
+					pixel[2] = static_cast<uint8_t>((x + y) / 3 + noise);
+					pixel[3] = static_cast<uint8_t>(255 - x % 64);
+				}
+				else
+				{
+					uint8_t tile = static_cast<uint8_t>((x / 37 + y / 23) % 4 * 60);
+					pixel[0] = tile;
+					pixel[1] = 200;
+					pixel[2] = static_cast<uint8_t>(255 - tile);
+					pixel[3] = 255;
+				}
+			}
+		}
+		return image;
+	}
+
+	void AppendUint16LittleEndian(std::vector<uint8_t>& data, uint32_t value)
+	{
+		data.push_back(static_cast<uint8_t>(value));
+		data.push_back(static_cast<uint8_t>(value >> 8));
+	}
+	void AppendUint32BigEndian(std::vector<uint8_t>& data, uint32_t value)
+	{
+		for (int shift = 24; shift >= 0; shift -= 8)
+			data.push_back(static_cast<uint8_t>(value >> shift));
+	}
+
+	// 1 (gray, from red), 3 or 4 bytes per pixel, bottom-up rows like most TGA writers.
+	std::vector<uint8_t> EncodeTga(const Image& image, uint32_t bytesPerPixel, bool runLength)
+	{
+		std::vector<uint8_t> data{ 0, 0, static_cast<uint8_t>((bytesPerPixel == 1 ? 3 : 2) + (runLength ? 8 : 0)), 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+		AppendUint16LittleEndian(data, image.width);
+		AppendUint16LittleEndian(data, image.height);
+		data.push_back(static_cast<uint8_t>(bytesPerPixel * 8));
+		data.push_back(bytesPerPixel == 4 ? 8 : 0);
+
+		std::vector<uint32_t> pixels;
+		for (uint32_t y = image.height; y-- > 0;)
+		{
+			for (uint32_t x = 0; x < image.width; x++)
+			{
+				const uint8_t* pixel = image.GetPixel(x, y);
+				uint32_t value = bytesPerPixel == 1 ? pixel[0] :
+					pixel[2] | (pixel[1] << 8) | (pixel[0] << 16) | (bytesPerPixel == 4 ? pixel[3] << 24 : 0);
+				pixels.push_back(value);
+			}
+		}
+
+		auto appendPixel = [&](uint32_t value) {
+			for (uint32_t byte = 0; byte < bytesPerPixel; byte++)
+				data.push_back(static_cast<uint8_t>(value >> (8 * byte)));
+		};
+
+		if (!runLength)
+		{
+			for (uint32_t value : pixels)
+				appendPixel(value);
+			return data;
+		}
+
+		// Runs of 2 or more equal pixels, raw packets in between, 128 pixels at most per packet.
+		size_t position{ 0 };
+		while (position < pixels.size())
+		{
+			size_t run{ 1 };
+			while (position + run < pixels.size() && run < 128 && pixels[position + run] == pixels[position])
+				run++;
+
+			if (run >= 2)
+			{
+				data.push_back(static_cast<uint8_t>(0x80 | (run - 1)));
+				appendPixel(pixels[position]);
+				position += run;
+				continue;
+			}
+
+			size_t rawCount{ 1 };
+			while (position + rawCount < pixels.size() && rawCount < 128 &&
+				!(position + rawCount + 1 < pixels.size() && pixels[position + rawCount] == pixels[position + rawCount + 1]))
+			{
+				rawCount++;
+			}
+
+			data.push_back(static_cast<uint8_t>(rawCount - 1));
+			for (size_t i = 0; i < rawCount; i++)
+				appendPixel(pixels[position + i]);
+			position += rawCount;
+		}
+		return data;
+	}
+
+	std::vector<uint8_t> EncodePpm(const Image& image)
+	{
+		std::string header = "P6\n" + std::to_string(image.width) + " " + std::to_string(image.height) + "\n255\n";
+		std::vector<uint8_t> data(header.begin(), header.end());
+
+		for (size_t i = 0; i < image.pixels.size(); i += 4)
+			data.insert(data.end(), image.pixels.begin() + i, image.pixels.begin() + i + 3);
+		return data;
+	}
+
+	// The reference QOI encoder, written from the specification.
+	std::vector<uint8_t> EncodeQoi(const Image& image, uint8_t channels)
+	{
+		std::vector<uint8_t> data{ 'q', 'o', 'i', 'f' };
+		AppendUint32BigEndian(data, image.width);
+		AppendUint32BigEndian(data, image.height);
+		data.push_back(channels);
+		data.push_back(image.format == TextureFormat::R8G8B8A8_UNORM_SRGB ? 0 : 1);
+
+		uint8_t index[64][4]{};
+		uint8_t previous[4]{ 0, 0, 0, 255 };
+		uint32_t run{ 0 };
+
+		size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+		for (size_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		{
+			uint8_t pixel[4];
+			std::memcpy(pixel, &image.pixels[pixelIndex * 4], 4);
+			if (channels == 3)
+				pixel[3] = previous[3];
+
+			if (std::memcmp(pixel, previous, 4) == 0)
+			{
+				run++;
+				if (run == 62 || pixelIndex == pixelCount - 1)
+				{
+					data.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+					run = 0;
+				}
+				continue;
+			}
+
+			if (run > 0)
+			{
+				data.push_back(static_cast<uint8_t>(0xC0 | (run - 1)));
+				run = 0;
+			}
+
+			uint32_t hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+			if (std::memcmp(index[hash], pixel, 4) == 0)
+			{
+				data.push_back(static_cast<uint8_t>(hash));
+			}
+			else
+			{
+				std::memcpy(index[hash], pixel, 4);
+
+				int redDifference = static_cast<int8_t>(pixel[0] - previous[0]);
+				int greenDifference = static_cast<int8_t>(pixel[1] - previous[1]);
+				int blueDifference = static_cast<int8_t>(pixel[2] - previous[2]);
+				int redGreen = redDifference - greenDifference;
+				int blueGreen = blueDifference - greenDifference;
+
+				if (pixel[3] != previous[3])
+				{
+					data.insert(data.end(), { 0xFF, pixel[0], pixel[1], pixel[2], pixel[3] });
+				}
+				else if (redDifference >= -2 && redDifference <= 1 && greenDifference >= -2 && greenDifference <= 1 &&
+					blueDifference >= -2 && blueDifference <= 1)
+				{
+					data.push_back(static_cast<uint8_t>(0x40 | ((redDifference + 2) << 4) | ((greenDifference + 2) << 2) | (blueDifference + 2)));
+				}
+				else if (greenDifference >= -32 && greenDifference <= 31 && redGreen >= -8 && redGreen <= 7 && blueGreen >= -8 && blueGreen <= 7)
+				{
+					data.push_back(static_cast<uint8_t>(0x80 | (greenDifference + 32)));
+					data.push_back(static_cast<uint8_t>(((redGreen + 8) << 4) | (blueGreen + 8)));
+				}
+				else
+				{
+					data.insert(data.end(), { 0xFE, pixel[0], pixel[1], pixel[2] });
+				}
+			}
+
+			std::memcpy(previous, pixel, 4);
+		}
+
+		data.insert(data.end(), { 0, 0, 0, 0, 0, 0, 0, 1 });
+		return data;
+	}
+
+	// What a file with only some of the channels decodes to.
+	Image GetExpectedImage(const Image& image, bool keepAlpha, bool gray)
+	{
+		Image expected = image;
+		for (size_t i = 0; i < expected.pixels.size(); i += 4)
+		{
+			if (gray)
+				expected.pixels[i + 1] = expected.pixels[i + 2] = expected.pixels[i];
+			if (!keepAlpha)
+				expected.pixels[i + 3] = 255;
+		}
+		return expected;
+	}
+
+	struct EncodedFile
+	{
+		const char* name;
+		ImageFileFormat format;
+		std::vector<uint8_t> data;
+		Image expected;
+	};
+
+	std::vector<EncodedFile> EncodeFiles(const Image& image)
+	{
+		std::vector<EncodedFile> files;
+		files.push_back({ "TGA 24-bit", ImageFileFormat::TGA, EncodeTga(image, 3, false), GetExpectedImage(image, false, false) });
+		files.push_back({ "TGA 32-bit", ImageFileFormat::TGA, EncodeTga(image, 4, false), GetExpectedImage(image, true, false) });
+		files.push_back({ "TGA 32-bit RLE", ImageFileFormat::TGA, EncodeTga(image, 4, true), GetExpectedImage(image, true, false) });
+		files.push_back({ "TGA 8-bit gray", ImageFileFormat::TGA, EncodeTga(image, 1, false), GetExpectedImage(image, false, true) });
+		files.push_back({ "PPM", ImageFileFormat::PPM, EncodePpm(image), GetExpectedImage(image, false, false) });
+		files.push_back({ "QOI RGB", ImageFileFormat::QOI, EncodeQoi(image, 3), GetExpectedImage(image, false, false) });
+		files.push_back({ "QOI RGBA", ImageFileFormat::QOI, EncodeQoi(image, 4), GetExpectedImage(image, true, false) });
+		return files;
+	}
+}
+
+TEST_CASE(ImageDecoderRoundTrip)
+{
+	Image image = CreateTestImage(93, 61);
+
+	for (const EncodedFile& file : EncodeFiles(image))
+	{
+		TEST_CHECK(DetectImageFileFormat(file.data.data(), file.data.size()) == file.format);
+
+		Image decoded = DecodeImage(file.data.data(), file.data.size());
+		TEST_CHECK(decoded.width == image.width && decoded.height == image.height);
+		TEST_CHECK(decoded.format == TextureFormat::R8G8B8A8_UNORM_SRGB);
+		TEST_CHECK(decoded.pixels == file.expected.pixels);
+	}
+
+	// QOI carries its color space.
+	Image linear = image;
+	linear.format = TextureFormat::R8G8B8A8_UNORM;
+	std::vector<uint8_t> linearQoi = EncodeQoi(linear, 4);
+	TEST_CHECK(DecodeQoi(linearQoi.data(), linearQoi.size()).format == TextureFormat::R8G8B8A8_UNORM);
+}
+
+// Every truncated file throws instead of reading past its end.
+TEST_CASE(ImageDecoderRejectsTruncatedFiles)
+{
+	Image image = CreateTestImage(17, 9);
+
+	for (const EncodedFile& file : EncodeFiles(image))
+	{
+		for (size_t size = 0; size < file.data.size() - (file.format == ImageFileFormat::QOI ? 8 : 0); size++)
+		{
+			std::vector<uint8_t> truncated(file.data.begin(), file.data.begin() + size);
+			TEST_CHECK_THROWS(DecodeImage(truncated.data(), truncated.size()), Error);
+		}
+	}
+}
+
+// The vectorized conversions against the obvious loop, at every count around the vector widths.
+TEST_CASE(ImageDecoderPixelConversions)
+{
+	for (size_t pixelCount = 0; pixelCount < 70; pixelCount++)
+	{
+		std::vector<uint8_t> source(pixelCount * 4);
+		for (size_t i = 0; i < source.size(); i++)
+			source[i] = static_cast<uint8_t>(i * 37 + pixelCount);
+
+		// One guard pixel past the end must stay untouched.
+		std::vector<uint8_t> destination((pixelCount + 1) * 4, 0xEE);
+
+		SwizzleRedBlue(source.data(), destination.data(), pixelCount);
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			const uint8_t* in = &source[pixel * 4];
+			const uint8_t* out = &destination[pixel * 4];
+			TEST_CHECK(out[0] == in[2] && out[1] == in[1] && out[2] == in[0] && out[3] == in[3]);
+		}
+
+		ExpandBgrToRgba(source.data(), destination.data(), pixelCount, 7);
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			const uint8_t* in = &source[pixel * 3];
+			const uint8_t* out = &destination[pixel * 4];
+			TEST_CHECK(out[0] == in[2] && out[1] == in[1] && out[2] == in[0] && out[3] == 7);
+		}
+
+		ExpandRgbToRgba(source.data(), destination.data(), pixelCount);
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			const uint8_t* in = &source[pixel * 3];
+			const uint8_t* out = &destination[pixel * 4];
+			TEST_CHECK(out[0] == in[0] && out[1] == in[1] && out[2] == in[2] && out[3] == 255);
+		}
+
+		ExpandGrayToRgba(source.data(), destination.data(), pixelCount, 9);
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			const uint8_t* out = &destination[pixel * 4];
+			TEST_CHECK(out[0] == source[pixel] && out[1] == source[pixel] && out[2] == source[pixel] && out[3] == 9);
+		}
+
+		TEST_CHECK(destination[pixelCount * 4] == 0xEE);
+
+		// In place, twice, is the identity.
+		std::vector<uint8_t> inPlace = source;
+		SwizzleRedBlue(inPlace.data(), inPlace.data(), pixelCount);
+		SwizzleRedBlue(inPlace.data(), inPlace.data(), pixelCount);
+		TEST_CHECK(inPlace == source);
+	}
+}
+
+// A broken file fails its own result, the others still load, in order.
+TEST_CASE(ImageDecoderLoadsFileBatches)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "dxe-image-decoder";
+	std::filesystem::create_directories(directory);
+
+	Image image = CreateTestImage(40, 30);
+	std::vector<uint8_t> qoi = EncodeQoi(image, 4);
+	std::vector<uint8_t> broken(qoi.begin(), qoi.begin() + qoi.size() / 2);
+
+	std::vector<std::filesystem::path> paths = { directory / "a.qoi", directory / "broken.qoi", directory / "missing.qoi", directory / "b.qoi" };
+	for (size_t i : { 0, 1, 3 })
+	{
+		const std::vector<uint8_t>& data = i == 1 ? broken : qoi;
+		std::ofstream file(paths[i], std::ofstream::binary);
+		file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	}
+
+	ThreadPool threadPool{ 2 };
+	std::vector<ImageLoadResult> results = LoadImageFiles(paths, &threadPool);
+
+	TEST_CHECK(results.size() == 4);
+	TEST_CHECK(results[0].succeeded && results[0].image.pixels == image.pixels);
+	TEST_CHECK(!results[1].succeeded && results[1].errorMessage.find("broken.qoi") != std::string::npos);
+	TEST_CHECK(!results[2].succeeded);
+	TEST_CHECK(results[3].succeeded && results[3].path == paths[3]);
+
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
+
+// Decoding a 2048x2048 image from memory in each file flavor, and the conversion kernels on their own.
+BENCHMARK_CASE(ImageDecoderThroughput)
+{
+	constexpr uint32_t size = 2048;
+	constexpr uint64_t pixelCount = static_cast<uint64_t>(size) * size;
+
+	auto reportMegapixels = [&](const std::string& label, double nanosecondsPerPixel) {
+		ReportMetric(label, 1.0e3 / nanosecondsPerPixel, "MPixel/s");
+	};
+
+	Image image = CreateTestImage(size, size);
+	for (const EncodedFile& file : EncodeFiles(image))
+	{
+		reportMegapixels(std::string("decode ") + file.name, MeasureNanosecondsPerItem(pixelCount, [&]() {
+			KeepValue(DecodeImage(file.data.data(), file.data.size()).pixels.data());
+		}, 3));
+	}
+
+	std::vector<uint8_t> destination(pixelCount * 4);
+	reportMegapixels("SwizzleRedBlue", MeasureNanosecondsPerItem(pixelCount, [&]() {
+		SwizzleRedBlue(image.pixels.data(), destination.data(), pixelCount);
+		KeepValue(destination[0]);
+	}));
+	reportMegapixels("ExpandBgrToRgba", MeasureNanosecondsPerItem(pixelCount, [&]() {
+		ExpandBgrToRgba(image.pixels.data(), destination.data(), pixelCount);
+		KeepValue(destination[0]);
+	}));
+	reportMegapixels("ExpandGrayToRgba", MeasureNanosecondsPerItem(pixelCount, [&]() {
+		ExpandGrayToRgba(image.pixels.data(), destination.data(), pixelCount);
+		KeepValue(destination[0]);
+	}));
+}
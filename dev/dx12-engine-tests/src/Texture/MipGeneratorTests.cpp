@@ -0,0 +1,256 @@
+#include "Test/Test.h"
+
+#include "Core/ThreadPool.h"
+#include "Texture/MipGenerator.h"
+
+#include <cmath>
+
+using namespace dxe;
+
+namespace
+{
+	// Deterministic noise in every channel, alpha included.
+	Image CreatePatternImage(uint32_t width, uint32_t height, TextureFormat format)
+	{
+		Image image = CreateImage(width, height, format);
+
+		uint32_t state{ 7 };
+		for (uint8_t& value : image.pixels)
+		{
+			state = state * 1664525u + 1013904223u;
+			value = static_cast<uint8_t>(state >> 24);
+		}
+		return image;
+	}
+
+	// FNV-1a over the pixels of every mip.
+	uint64_t HashMipChain(const std::vector<Image>& mips)
+	{
+		uint64_t hash{ 14695981039346656037ull };
+		for (const Image& mip : mips)
+		{
+			for (uint8_t value : mip.pixels)
+			{
+				hash ^= value;
+				hash *= 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	float CalculateCoverage(const Image& image, float reference)
+	{
+		uint32_t coveredPixels{ 0 };
+		for (size_t alpha = 3; alpha < image.pixels.size(); alpha += 4)
+		{
+			if (static_cast<float>(image.pixels[alpha]) / 255.0f > reference)
+				coveredPixels++;
+		}
+		return static_cast<float>(coveredPixels) / static_cast<float>(image.width * image.height);
+	}
+
+	MipGenerationSettings CreateSettings(MipFilter filter)
+	{
+		MipGenerationSettings settings{};
+		settings.filter = filter;
+		return settings;
+	}
+
+	constexpr MipFilter MIP_FILTERS[] = { MipFilter::BOX, MipFilter::KAISER, MipFilter::LANCZOS };
+}
+
+// Box averages worked out by hand: each mip is built from the float previous mip, so mip 2 is the
+// average of all 8 pixels and not of the rounded mip 1.
+TEST_CASE(MipGeneratorBoxAverages)
+{
+	Image image = CreateImage(4, 2);
+	const uint8_t red[] = { 10, 20, 30, 40, 50, 60, 70, 80 };
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		image.pixels[i * 4] = red[i];
+		image.pixels[i * 4 + 3] = 255;
+	}
+
+	std::vector<Image> mips = GenerateMipChain(image, MipGenerationSettings{});
+
+	TEST_CHECK(mips.size() == 3);
+	TEST_CHECK(mips[0].pixels == image.pixels);
+	TEST_CHECK(mips[1].width == 2 && mips[1].height == 1);
+	TEST_CHECK(mips[1].pixels[0] == 35 && mips[1].pixels[4] == 55);
+	TEST_CHECK(mips[1].pixels[3] == 255 && mips[1].pixels[7] == 255);
+	TEST_CHECK(mips[2].width == 1 && mips[2].height == 1 && mips[2].pixels[0] == 45);
+}
+
+// 3 pixels down to 1: the middle one counts as much as both edges together.
+TEST_CASE(MipGeneratorOddSizes)
+{
+	Image image = CreateImage(3, 1);
+	image.pixels[0] = 30;
+	image.pixels[4] = 60;
+	image.pixels[8] = 90;
+
+	std::vector<Image> mips = GenerateMipChain(image, MipGenerationSettings{});
+
+	TEST_CHECK(mips.size() == 2);
+	TEST_CHECK(mips[1].width == 1 && mips[1].height == 1 && mips[1].pixels[0] == 60);
+}
+
+// Black and white average to half the linear intensity, which is 188 in sRGB, not 128.
+TEST_CASE(MipGeneratorFiltersSrgbInLinearSpace)
+{
+	Image image = CreateImage(2, 1, TextureFormat::R8G8B8A8_UNORM_SRGB);
+	for (uint32_t channel = 0; channel < 4; channel++)
+		image.pixels[4 + channel] = 255;
+
+	std::vector<Image> mips = GenerateMipChain(image, MipGenerationSettings{});
+
+	TEST_CHECK(mips[1].format == TextureFormat::R8G8B8A8_UNORM_SRGB);
+	TEST_CHECK(mips[1].pixels[0] == 188 && mips[1].pixels[1] == 188 && mips[1].pixels[2] == 188);
+	TEST_CHECK(mips[1].pixels[3] == 128);
+}
+
+// The weights of every filter sum to one, so a flat image stays exactly flat, edges included.
+TEST_CASE(MipGeneratorKeepsConstantImages)
+{
+	for (TextureFormat format : { TextureFormat::R8G8B8A8_UNORM, TextureFormat::R8G8B8A8_UNORM_SRGB })
+	{
+		Image image = CreateImage(45, 17, format);
+		for (size_t i = 0; i < image.pixels.size(); i++)
+			image.pixels[i] = static_cast<uint8_t>(40 + 50 * (i % 4));
+
+		for (MipFilter filter : MIP_FILTERS)
+		{
+			std::vector<Image> mips = GenerateMipChain(image, CreateSettings(filter));
+			TEST_CHECK(mips.size() == 6);
+
+			for (const Image& mip : mips)
+			{
+				for (size_t i = 0; i < mip.pixels.size(); i++)
+					TEST_CHECK(mip.pixels[i] == image.pixels[i % 4]);
+			}
+		}
+	}
+}
+
+TEST_CASE(MipGeneratorLimitsMipLevels)
+{
+	MipGenerationSettings settings{};
+	settings.mipLevels = 3;
+	TEST_CHECK(GenerateMipChain(CreateImage(64, 64), settings).size() == 3);
+
+	settings.mipLevels = 100;
+	TEST_CHECK(GenerateMipChain(CreateImage(64, 64), settings).size() == 7);
+
+	TEST_CHECK_THROWS(GenerateMipChain(Image{}, settings), Error);
+}
+
+// Rows are split between the threads, which must not change a single byte.
+TEST_CASE(MipGeneratorOutputDoesNotDependOnThreads)
+{
+	ThreadPool threadPool{ 4 };
+
+	for (TextureFormat format : { TextureFormat::R8G8B8A8_UNORM, TextureFormat::R8G8B8A8_UNORM_SRGB })
+	{
+		Image image = CreatePatternImage(301, 157, format);
+
+		for (MipFilter filter : MIP_FILTERS)
+		{
+			std::vector<Image> serial = GenerateMipChain(image, CreateSettings(filter));
+			std::vector<Image> threaded = GenerateMipChain(image, CreateSettings(filter), &threadPool);
+
+			TEST_CHECK(serial.size() == threaded.size());
+			for (size_t mip = 0; mip < serial.size() && mip < threaded.size(); mip++)
+				TEST_CHECK(serial[mip].pixels == threaded[mip].pixels);
+		}
+	}
+}
+
+// Checksums of every mip of a 37x23 noise image, captured from the current implementation. Any change
+// to the weights, the edge handling, the rounding or the sRGB conversion shows up here; update them
+// only for an intended change of the output. Kaiser and Lanczos weights go through std::sin and
+// BesselI0, so those two could in principle differ by a bit between math libraries.
+TEST_CASE(MipGeneratorGoldenChecksums)
+{
+	struct Golden
+	{
+		TextureFormat format;
+		MipFilter filter;
+		uint64_t checksum;
+	};
+	const Golden goldens[] = {
+		{ TextureFormat::R8G8B8A8_UNORM, MipFilter::BOX, 0xa2ab58eabf215489ull },
+		{ TextureFormat::R8G8B8A8_UNORM, MipFilter::KAISER, 0x8dc93ef860095ea6ull },
+		{ TextureFormat::R8G8B8A8_UNORM, MipFilter::LANCZOS, 0xee674dce112b6c5cull },
+		{ TextureFormat::R8G8B8A8_UNORM_SRGB, MipFilter::BOX, 0x848c6a57b31ce0d6ull },
+		{ TextureFormat::R8G8B8A8_UNORM_SRGB, MipFilter::KAISER, 0x1dc2e3a1e1d12281ull },
+		{ TextureFormat::R8G8B8A8_UNORM_SRGB, MipFilter::LANCZOS, 0x72d53b280376ee45ull },
+	};
+
+	for (const Golden& golden : goldens)
+	{
+		std::vector<Image> mips = GenerateMipChain(CreatePatternImage(37, 23, golden.format), CreateSettings(golden.filter));
+
+		TEST_CHECK(mips.size() == 6);
+		TEST_CHECK(HashMipChain(mips) == golden.checksum);
+	}
+}
+
+// Foliage-like alpha: a quarter of mip 0 is opaque, at random. Plain filtering averages alpha down to
+// about a quarter, below the reference, and the leaves disappear in the distance; with the coverage
+// preserved every mip keeps close to a quarter of its pixels, as close as the few alpha values of
+// the small mips allow.
+TEST_CASE(MipGeneratorPreservesAlphaCoverage)
+{
+	constexpr float reference = 0.5f;
+
+	Image image = CreatePatternImage(256, 256, TextureFormat::R8G8B8A8_UNORM);
+	for (size_t alpha = 3; alpha < image.pixels.size(); alpha += 4)
+		image.pixels[alpha] = image.pixels[alpha] < 64 ? 255 : 0;
+	float coverage = CalculateCoverage(image, reference);
+	TEST_CHECK(std::fabs(coverage - 0.25f) <= 0.01f);
+
+	MipGenerationSettings settings{};
+	settings.mipLevels = 5;
+
+	std::vector<Image> plain = GenerateMipChain(image, settings);
+	TEST_CHECK(CalculateCoverage(plain[3], reference) < 0.05f);
+
+	settings.preserveAlphaCoverage = true;
+	settings.alphaCoverageReference = reference;
+
+	std::vector<Image> preserved = GenerateMipChain(image, settings);
+	for (size_t mip = 1; mip < preserved.size(); mip++)
+	{
+		float plainError = std::fabs(CalculateCoverage(plain[mip], reference) - coverage);
+		float preservedError = std::fabs(CalculateCoverage(preserved[mip], reference) - coverage);
+		TEST_CHECK(preservedError <= plainError && preservedError <= 0.08f);
+	}
+}
+
+// Full chains of a 2048x1536 sRGB texture, counted in pixels of mip 0 per second.
+BENCHMARK_CASE(MipGeneratorThroughput)
+{
+	constexpr uint32_t width = 2048;
+	constexpr uint32_t height = 1536;
+	constexpr double megapixels = width * height / 1.0e6;
+
+	Image image = CreatePatternImage(width, height, TextureFormat::R8G8B8A8_UNORM_SRGB);
+	ThreadPool threadPool{};
+
+	const char* filterNames[] = { "box", "kaiser", "lanczos" };
+	for (MipFilter filter : MIP_FILTERS)
+	{
+		const char* filterName = filterNames[static_cast<uint32_t>(filter)];
+		MipGenerationSettings settings = CreateSettings(filter);
+
+		double serial = MeasureNanosecondsPerItem(1, [&]() {
+			KeepValue(GenerateMipChain(image, settings).size());
+		}, 3);
+		double threaded = MeasureNanosecondsPerItem(1, [&]() {
+			KeepValue(GenerateMipChain(image, settings, &threadPool).size());
+		}, 3);
+
+		ReportMetric(std::string(filterName) + ", 1 thread", megapixels / (serial * 1.0e-9), "MPixel/s");
+		ReportMetric(std::string(filterName) + ", thread pool", megapixels / (threaded * 1.0e-9), "MPixel/s");
+	}
+}
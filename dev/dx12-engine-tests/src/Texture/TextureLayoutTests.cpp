@@ -0,0 +1,167 @@
+#include "Test/Test.h"
+
+#include "Texture/TextureLayout.h"
+
+using namespace dxe;
+
+// Expected footprints are worked out by hand from the rules of ID3D12Device::GetCopyableFootprints:
+// rows padded to 256 bytes, subresources placed at 512 byte boundaries, block-compressed sizes in
+// whole blocks, and a total that doesn't pad the last row.
+
+namespace
+{
+	struct ExpectedFootprint
+	{
+		uint64_t offset;
+		uint32_t width;
+		uint32_t height;
+		uint32_t depth;
+		uint32_t rowPitch;
+		uint32_t rowCount;
+		uint64_t rowSizeInBytes;
+	};
+
+	void CheckFootprints(const TextureUploadLayout& layout, const std::vector<ExpectedFootprint>& expected)
+	{
+		TEST_CHECK(layout.footprints.size() == expected.size());
+
+		for (size_t i = 0; i < expected.size() && i < layout.footprints.size(); i++)
+		{
+			const TextureSubresourceFootprint& footprint = layout.footprints[i];
+			TEST_CHECK(footprint.offset == expected[i].offset);
+			TEST_CHECK(footprint.width == expected[i].width && footprint.height == expected[i].height && footprint.depth == expected[i].depth);
+			TEST_CHECK(footprint.rowPitch == expected[i].rowPitch && footprint.rowCount == expected[i].rowCount);
+			TEST_CHECK(footprint.rowSizeInBytes == expected[i].rowSizeInBytes);
+		}
+	}
+
+	TextureDesc CreateDesc(TextureDimension dimension, TextureFormat format, uint32_t width, uint32_t height, uint32_t depth, uint32_t arraySize, uint32_t mipLevels)
+	{
+		TextureDesc desc{};
+		desc.dimension = dimension;
+		desc.format = format;
+		desc.width = width;
+		desc.height = height;
+		desc.depth = depth;
+		desc.arraySize = arraySize;
+		desc.mipLevels = mipLevels;
+		return desc;
+	}
+}
+
+TEST_CASE(TextureLayoutMipChainLength)
+{
+	TEST_CHECK(CalculateFullMipChainLength(1, 1) == 1);
+	TEST_CHECK(CalculateFullMipChainLength(256, 256) == 9);
+	TEST_CHECK(CalculateFullMipChainLength(255, 1) == 8);
+	TEST_CHECK(CalculateFullMipChainLength(13, 7) == 4);
+	TEST_CHECK(CalculateFullMipChainLength(1, 1, 300) == 9);
+
+	TextureDesc desc = CreateDesc(TextureDimension::TEXTURE_2D, TextureFormat::R8G8B8A8_UNORM, 13, 7, 1, 1, 4);
+	TEST_CHECK(desc.GetMipWidth(2) == 3 && desc.GetMipHeight(2) == 1);
+	TEST_CHECK(desc.GetMipWidth(3) == 1 && desc.GetMipHeight(3) == 1 && desc.GetMipDepth(3) == 1);
+}
+
+// Cubes count 6 faces per element, 3D textures keep their slices inside each mip.
+TEST_CASE(TextureLayoutSubresourceCounts)
+{
+	TextureDesc cubeArray = CreateDesc(TextureDimension::TEXTURE_CUBE, TextureFormat::R16G16B16A16_FLOAT, 16, 16, 1, 2, 3);
+	TEST_CHECK(cubeArray.GetArraySliceCount() == 12 && cubeArray.GetSubresourceCount() == 36);
+	TEST_CHECK(CalculateSubresourceIndex(2, 7, 3) == 23);
+
+	TextureDesc volume = CreateDesc(TextureDimension::TEXTURE_3D, TextureFormat::R8_UNORM, 32, 16, 8, 1, 4);
+	TEST_CHECK(volume.GetSubresourceCount() == 4);
+	TEST_CHECK(volume.GetMipDepth(1) == 4 && volume.GetMipDepth(3) == 1);
+}
+
+// A full chain of 256x256 RGBA8: the mips from 32x32 down have rows shorter than the pitch, and the
+// last one ends 4 bytes after its offset.
+TEST_CASE(TextureLayoutRgba8MipChain)
+{
+	TextureDesc desc = CreateDesc(TextureDimension::TEXTURE_2D, TextureFormat::R8G8B8A8_UNORM, 256, 256, 1, 1, 9);
+	TextureUploadLayout layout = CalculateTextureUploadLayout(desc);
+
+	CheckFootprints(layout, {
+		{ 0,      256, 256, 1, 1024, 256, 1024 },
+		{ 262144, 128, 128, 1, 512,  128, 512 },
+		{ 327680, 64,  64,  1, 256,  64,  256 },
+		{ 344064, 32,  32,  1, 256,  32,  128 },
+		{ 352256, 16,  16,  1, 256,  16,  64 },
+		{ 356352, 8,   8,   1, 256,  8,   32 },
+		{ 358400, 4,   4,   1, 256,  4,   16 },
+		{ 359424, 2,   2,   1, 256,  2,   8 },
+		{ 359936, 1,   1,   1, 256,  1,   4 },
+	});
+	TEST_CHECK(layout.totalBytes == 359940);
+}
+
+// BC1 13x7 has 4x2 blocks; the tail mips are still one whole 4x4 block each.
+TEST_CASE(TextureLayoutBlockCompressed)
+{
+	TextureDesc desc = CreateDesc(TextureDimension::TEXTURE_2D, TextureFormat::BC1_UNORM, 13, 7, 1, 1, 4);
+	TextureUploadLayout layout = CalculateTextureUploadLayout(desc);
+
+	CheckFootprints(layout, {
+		{ 0,    16, 8, 1, 256, 2, 32 },
+		{ 512,  8,  4, 1, 256, 1, 16 },
+		{ 1024, 4,  4, 1, 256, 1, 8 },
+		{ 1536, 4,  4, 1, 256, 1, 8 },
+	});
+	TEST_CHECK(layout.totalBytes == 1544);
+
+	// DDS and KTX2 store whole blocks without padding.
+	TEST_CHECK(CalculatePackedSubresourceSize(desc, 0) == 64);
+	TEST_CHECK(CalculatePackedSubresourceSize(desc, 3) == 8);
+	TEST_CHECK(CalculatePackedRowSize(TextureFormat::BC7_UNORM, 13) == 64);
+	TEST_CHECK(CalculateRowCount(TextureFormat::BC7_UNORM, 13) == 4);
+	TEST_CHECK(CalculatePackedRowSize(TextureFormat::R8G8B8A8_UNORM, 13) == 52);
+}
+
+// Subresources of a cube go face by face, all mips of a face together.
+TEST_CASE(TextureLayoutCube)
+{
+	TextureDesc desc = CreateDesc(TextureDimension::TEXTURE_CUBE, TextureFormat::R16G16B16A16_FLOAT, 16, 16, 1, 1, 2);
+	TextureUploadLayout layout = CalculateTextureUploadLayout(desc);
+
+	std::vector<ExpectedFootprint> expected;
+	for (uint64_t face = 0; face < 6; face++)
+	{
+		expected.push_back({ face * 6144, 16, 16, 1, 256, 16, 128 });
+		expected.push_back({ face * 6144 + 4096, 8, 8, 1, 256, 8, 64 });
+	}
+	CheckFootprints(layout, expected);
+	TEST_CHECK(layout.totalBytes == 36672);
+}
+
+// Every depth slice of a 3D mip has its rows padded, only the very last row isn't.
+TEST_CASE(TextureLayoutVolume)
+{
+	TextureDesc desc = CreateDesc(TextureDimension::TEXTURE_3D, TextureFormat::R8_UNORM, 32, 16, 8, 1, 2);
+	TextureUploadLayout layout = CalculateTextureUploadLayout(desc);
+
+	CheckFootprints(layout, {
+		{ 0,     32, 16, 8, 256, 16, 32 },
+		{ 32768, 16, 8,  4, 256, 8,  16 },
+	});
+	TEST_CHECK(layout.totalBytes == 40720);
+	TEST_CHECK(CalculatePackedSubresourceSize(desc, 0) == 32 * 16 * 8);
+}
+
+// Offsets include the base offset, rounded up to the placement alignment; the total counts from the
+// base offset.
+TEST_CASE(TextureLayoutBaseOffset)
+{
+	TextureDesc desc = CreateDesc(TextureDimension::TEXTURE_2D, TextureFormat::R8G8B8A8_UNORM, 64, 64, 1, 1, 2);
+
+	TextureUploadLayout aligned = CalculateTextureUploadLayout(desc, 1024);
+	CheckFootprints(aligned, {
+		{ 1024,  64, 64, 1, 256, 64, 256 },
+		{ 17408, 32, 32, 1, 256, 32, 128 },
+	});
+	TEST_CHECK(aligned.totalBytes == CalculateTextureUploadLayout(desc).totalBytes);
+	TEST_CHECK(aligned.totalBytes == 16384 + 31 * 256 + 128);
+
+	TextureUploadLayout unaligned = CalculateTextureUploadLayout(desc, 100);
+	TEST_CHECK(unaligned.footprints[0].offset == 512 && unaligned.footprints[1].offset == 16896);
+	TEST_CHECK(unaligned.totalBytes == 412 + aligned.totalBytes);
+}
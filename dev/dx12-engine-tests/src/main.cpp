@@ -0,0 +1,64 @@
+#include "Test/Test.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+
+using namespace dxe;
+
+namespace dxe
+{
+	std::vector<TestCase>& GetTestCases()
+	{
+		static std::vector<TestCase> testCases;
+		return testCases;
+	}
+
+	void ReportMetric(const std::string& label, double value, const char* unit)
+	{
+		std::printf("    %-48s %12.2f %s\n", label.c_str(), value, unit);
+	}
+}
+
+// dx12-engine-tests [--bench] [name filter]
+// Runs the tests, or with --bench the benchmarks (built in Release for meaningful numbers), whose
+// names contain the filter.
+int main(int argc, char** argv)
+{
+	TestKind kind{ TestKind::TEST };
+	const char* filter{ nullptr };
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--bench") == 0)
+			kind = TestKind::BENCHMARK;
+		else
+			filter = argv[i];
+	}
+
+	uint32_t runCount{ 0 };
+	uint32_t failureCount{ 0 };
+
+	for (const TestCase& testCase : GetTestCases())
+	{
+		if (testCase.kind != kind || (filter && !std::strstr(testCase.name, filter)))
+			continue;
+
+		std::printf("%s\n", testCase.name);
+		runCount++;
+
+		try
+		{
+			testCase.function();
+		}
+		catch (const std::exception& e)
+		{
+			std::printf("    FAILED: %s\n", e.what());
+			failureCount++;
+		}
+	}
+
+	std::printf("%u run, %u failed\n", runCount, failureCount);
+	return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "IO/IoScheduler.h"
+
+#include "Core/ThreadPool.h"
+#include "Core/Utility.h"
+
+#include "Events/EventRegistry.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dxe
+{
+	enum class AssetLoadPriority
+	{
+		// The app can't render its first frame without these.
+		CRITICAL,
+		// Streamed in after the critical set, in the background.
+		BACKGROUND,
+	};
+
+	struct AssetRequest
+	{
+		using DecodeCallback = std::function<void(std::vector<uint8_t>& fileData)>;
+		using FinalizeCallback = std::function<void()>;
+
+		std::string name;
+
+		// Leave empty for procedural assets, 'decode' then gets an empty buffer.
+		std::filesystem::path path;
+
+		AssetLoadPriority priority{ AssetLoadPriority::BACKGROUND };
+
+		// Runs on a worker thread. Turns the raw file into whatever the asset needs
+		// (parsing, decompression, shader compilation and so on). May throw to fail the asset.
+		DecodeCallback decode;
+
+		// Runs on the main thread inside 'AssetLoader::Tick'. Creates GPU objects. Optional.
+		FinalizeCallback finalize;
+	};
+
+	struct AssetLoaderStats
+	{
+		uint32_t requestedCount{ 0 };
+		uint32_t loadedCount{ 0 };
+		uint32_t failedCount{ 0 };
+	};
+
+	// File reads go through the I/O scheduler, decoding runs on the thread pool
+	// and finalization happens on the main thread. Once every critical request issued so far
+	// is resident, 'CriticalAssetsLoadedCallbackData' is posted through the event registry.
+	//
+	// 'Load' and 'Tick' must be called from the main thread.
+
+	class AssetLoader
+	{
+	public:
+
+		AssetLoader(IoScheduler* ioScheduler, ThreadPool* threadPool, EventRegistry* eventRegistry);
+		~AssetLoader();
+
+		CLASS_NO_COPY(AssetLoader);
+		CLASS_NO_MOVE(AssetLoader);
+
+		void Load(AssetRequest request);
+
+		void Tick();
+
+		// Blocks until nothing is being read or decoded anymore. Doesn't finalize anything.
+		void WaitIdle();
+
+		bool CriticalAssetsPending() const;
+
+		AssetLoaderStats GetStats() const;
+
+	private:
+
+		struct DecodedAsset
+		{
+			AssetRequest request;
+			std::string errorMessage;
+			bool succeeded{ false };
+		};
+
+		void Decode(AssetRequest& request, std::vector<uint8_t>& fileData);
+		void FailDecode(AssetRequest& request, const std::string& errorMessage);
+
+		void PushDecodedAsset(DecodedAsset decodedAsset);
+
+		void FinalizeAsset(DecodedAsset& decodedAsset);
+
+		IoScheduler* ioScheduler{ nullptr };
+		ThreadPool* threadPool{ nullptr };
+		EventRegistry* eventRegistry{ nullptr };
+
+		std::vector<DecodedAsset> decodedAssets;
+		mutable std::mutex decodedAssetsMutex;
+		std::condition_variable decodedAssetsCondition;
+
+		// Read/decode jobs that haven't produced a 'DecodedAsset' yet.
+		uint32_t inFlightCount{ 0 };
+
+		uint32_t criticalPendingCount{ 0 };
+		uint32_t criticalLoadedCount{ 0 };
+		uint32_t criticalFailedCount{ 0 };
+
+		AssetLoaderStats stats{};
+	};
+}
\ No newline at end of file
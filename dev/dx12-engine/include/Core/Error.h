@@ -29,7 +29,7 @@ namespace dxe
 		Error(const std::string& message)
 			: errorMessage(message) {}
 
-		NODISCARD char const* what() const override
+		NODISCARD char const* what() const NOEXCEPT override
 		{
 			return errorMessage.c_str();
 		}
@@ -3,7 +3,9 @@
 #include <string>
 #include <string_view>
 
+#if defined(_WIN32)
 #define SPDLOG_WCHAR_TO_UTF8_SUPPORT
+#endif
 #include <spdlog/spdlog.h>
 #include <spdlog/fmt/bundled/color.h>
 
@@ -31,10 +33,12 @@ namespace dxe
 		{
 			spdlog::error(msg.data());
 		}
+#if defined(_WIN32)
 		static void Error(std::wstring_view msg)
 		{
 			spdlog::error(msg.data());
 		}
+#endif
 
 		template <typename ...Args>
 		static void Warn(std::string_view format, Args&& ...args)
@@ -45,10 +49,12 @@ namespace dxe
 		{
 			spdlog::warn(msg.data());
 		}
+#if defined(_WIN32)
 		static void Warn(std::wstring_view msg)
 		{
 			spdlog::warn(msg.data());
 		}
+#endif
 
 		template <typename ...Args>
 		static void Info(std::string_view format, Args&& ...args)
@@ -59,10 +65,12 @@ namespace dxe
 		{
 			spdlog::info(msg.data());
 		}
+#if defined(_WIN32)
 		static void Info(std::wstring_view msg)
 		{
 			spdlog::info(msg.data());
 		}
+#endif
 
 	private:
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace dxe
+{
+	// Read-only memory mapping of a whole file.
+
+	class MappedFile
+	{
+	public:
+
+		MappedFile() = default;
+		~MappedFile();
+
+		CLASS_NO_COPY(MappedFile);
+
+		MappedFile(MappedFile&& move) NOEXCEPT;
+		MappedFile& operator=(MappedFile&& move) NOEXCEPT;
+
+		void Open(const std::filesystem::path& filePath);
+		void Close();
+
+		bool IsOpen() const;
+
+		const uint8_t* GetData() const;
+		size_t GetSize() const;
+
+	private:
+
+		void Swap(MappedFile& other) NOEXCEPT;
+
+		const uint8_t* data{ nullptr };
+		size_t size{ 0 };
+
+#if defined(_WIN32)
+		void* fileHandle{ nullptr };
+		void* mappingHandle{ nullptr };
+#else
+		int fileDescriptor{ -1 };
+#endif
+	};
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <DirectXMath.h>
+
+#include <cmath>
 #include <cstdint>
 
 namespace dxe
@@ -103,4 +106,31 @@ namespace dxe
 		return ((coordinate.x >= 0) && (coordinate.x <= width)) &&
 			((coordinate.y >= 0) && (coordinate.y <= height));
 	}
+
+	// XMFLOAT3 helpers for CPU-side geometry, where loading into XMVECTORs isn't worth it.
+
+	inline DirectX::XMFLOAT3 Add(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+	{
+		return DirectX::XMFLOAT3{ a.x + b.x, a.y + b.y, a.z + b.z };
+	}
+	inline DirectX::XMFLOAT3 Subtract(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+	{
+		return DirectX::XMFLOAT3{ a.x - b.x, a.y - b.y, a.z - b.z };
+	}
+	inline DirectX::XMFLOAT3 Scale(const DirectX::XMFLOAT3& a, float scale)
+	{
+		return DirectX::XMFLOAT3{ a.x * scale, a.y * scale, a.z * scale };
+	}
+	inline float Dot(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+	inline DirectX::XMFLOAT3 Cross(const DirectX::XMFLOAT3& a, const DirectX::XMFLOAT3& b)
+	{
+		return DirectX::XMFLOAT3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+	inline DirectX::XMFLOAT3 Normalize(const DirectX::XMFLOAT3& a)
+	{
+		return Scale(a, 1.0f / std::sqrt(Dot(a, a)));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+// SSE2 is part of x86-64, so every 64-bit x86 build gets it without extra compiler flags.
+// Kernels guarded by SIMD_SSE2 always keep a scalar path for other targets (i.e. ARM).
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__)
+#define SIMD_SSE2 1
+#else
+#define SIMD_SSE2 0
+#endif
+
+#if SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+
+namespace dxe
+{
+	// RGBA color math, one SSE register per color.
+
+#if SIMD_SSE2
+	using Color4 = __m128;
+
+	inline Color4 LoadColor(const float* color) { return _mm_loadu_ps(color); }
+	inline Color4 LoadColor(const DirectX::XMFLOAT4& color) { return _mm_loadu_ps(&color.x); }
+	inline void StoreColor(float* color, Color4 value) { _mm_storeu_ps(color, value); }
+	inline void StoreColor(DirectX::XMFLOAT4& color, Color4 value) { _mm_storeu_ps(&color.x, value); }
+	inline Color4 ZeroColor() { return _mm_setzero_ps(); }
+	inline Color4 AddColors(Color4 a, Color4 b) { return _mm_add_ps(a, b); }
+	inline Color4 ScaleColor(Color4 color, float scale) { return _mm_mul_ps(color, _mm_set1_ps(scale)); }
+	// 'sum' + 'color' * 'scale'.
+	inline Color4 MultiplyAdd(Color4 sum, Color4 color, float scale) { return _mm_add_ps(sum, _mm_mul_ps(color, _mm_set1_ps(scale))); }
+	inline Color4 LerpColors(Color4 a, Color4 b, float t) { return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t))); }
+#else
+	struct Color4
+	{
+		float values[4]{};
+	};
+
+	inline Color4 LoadColor(const float* color) { return Color4{ { color[0], color[1], color[2], color[3] } }; }
+	inline Color4 LoadColor(const DirectX::XMFLOAT4& color) { return LoadColor(&color.x); }
+	inline void StoreColor(float* color, const Color4& value)
+	{
+		for (uint32_t channel = 0; channel < 4; channel++)
+			color[channel] = value.values[channel];
+	}
+	inline void StoreColor(DirectX::XMFLOAT4& color, const Color4& value) { StoreColor(&color.x, value); }
+	inline Color4 ZeroColor() { return Color4{}; }
+	inline Color4 AddColors(const Color4& a, const Color4& b)
+	{
+		Color4 result{};
+		for (uint32_t channel = 0; channel < 4; channel++)
+			result.values[channel] = a.values[channel] + b.values[channel];
+		return result;
+	}
+	inline Color4 ScaleColor(const Color4& color, float scale)
+	{
+		Color4 result{};
+		for (uint32_t channel = 0; channel < 4; channel++)
+			result.values[channel] = color.values[channel] * scale;
+		return result;
+	}
+	inline Color4 MultiplyAdd(const Color4& sum, const Color4& color, float scale)
+	{
+		Color4 result{};
+		for (uint32_t channel = 0; channel < 4; channel++)
+			result.values[channel] = sum.values[channel] + color.values[channel] * scale;
+		return result;
+	}
+	inline Color4 LerpColors(const Color4& a, const Color4& b, float t)
+	{
+		Color4 result{};
+		for (uint32_t channel = 0; channel < 4; channel++)
+			result.values[channel] = a.values[channel] + (b.values[channel] - a.values[channel]) * t;
+		return result;
+	}
+#endif
+}
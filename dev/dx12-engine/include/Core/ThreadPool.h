@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool
+	{
+	public:
+
+		using Task = std::function<void()>;
+		using RangeBody = std::function<void(uint32_t begin, uint32_t end)>;
+
+		// A thread count of 0 picks "hardware threads - 1" (at least 1),
+		// leaving one core for the thread that owns the pool.
+		explicit ThreadPool(uint32_t threadCount = 0);
+		~ThreadPool();
+
+		CLASS_NO_COPY(ThreadPool);
+		CLASS_NO_MOVE(ThreadPool);
+
+		void Execute(Task task);
+
+		template <typename Callable>
+		std::future<std::invoke_result_t<Callable>> Submit(Callable&& callable)
+		{
+			using ResultType = std::invoke_result_t<Callable>;
+
+			auto packagedTask = std::make_shared<std::packaged_task<ResultType()>>(
+				std::forward<Callable>(callable));
+
+			std::future<ResultType> future = packagedTask->get_future();
+			Execute([packagedTask]() { (*packagedTask)(); });
+			return future;
+		}
+
+		// Splits [begin, end) into chunks of 'grainSize' and runs 'body' on them.
+		// The calling thread takes part in the work, so it is safe to call
+		// ParallelFor from inside a task that already runs on this pool.
+		void ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeBody& body);
+		// ParallelFor on 'threadPool', or 'body' over the whole range on the calling thread when
+		// there is no pool. For code that takes an optional pool.
+		static void ParallelForOrInline(ThreadPool* threadPool, uint32_t begin, uint32_t end, uint32_t grainSize, const RangeBody& body);
+
+		uint32_t GetThreadCount() const;
+
+	private:
+
+		void WorkerLoop();
+
+		std::vector<std::thread> workers;
+		std::queue<Task> tasks;
+
+		std::mutex tasksMutex;
+		std::condition_variable tasksCondition;
+
+		bool stopRequested{ false };
+	};
+}
\ No newline at end of file
@@ -152,6 +152,9 @@ namespace dxe
 
 		CriticalAssetsLoadedCallbackData()
 			: CallbackData(CallbackType::CRITICAL_ASSETS_LOADED) {}
+
+		uint32_t loadedAssetCount{ 0 };
+		uint32_t failedAssetCount{ 0 };
 	};
 
 	// Callback
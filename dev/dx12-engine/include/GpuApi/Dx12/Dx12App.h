@@ -1,9 +1,17 @@
 #pragma once
 
+#include "Assets/AssetLoader.h"
 #include "Core/Application.h"
+#include "Core/ThreadPool.h"
 #include "Events/EventRegistry.h"
+#include "IO/IoScheduler.h"
+#include "Renderer/Dx12/Dx12Shader.h"
+#include "Streaming/Dx12/Dx12MeshLodLoader.h"
+#include "Streaming/MeshLodStreamer.h"
 #include "Window/WindowWin32.h"
 
+#include <DirectXMath.h>
+
 #include <cstdint>
 #include <memory>
 
@@ -20,20 +28,39 @@ namespace dxe
 	private:
 
 		void InitializeWindow();
+		void InitializeAssetLoading();
+		void InitializeMeshStreaming();
 
 		void LoadAssets();
+		void CreatePipelineState();
 
 		void Render();
 
 		void OnWindowClose(const WindowCloseCallbackData& callbackData);
+		void OnCriticalAssetsLoaded(const CriticalAssetsLoadedCallbackData& callbackData);
 
 		std::shared_ptr<EventRegistry> eventRegistry;
 		std::shared_ptr<WindowWin32> window;
 
-		uint32_t meshId{ 0 };
+		std::shared_ptr<ThreadPool> threadPool;
+		std::shared_ptr<IoScheduler> ioScheduler;
+		std::shared_ptr<AssetLoader> assetLoader;
+
+		// Progressive meshes, their LODs are loaded on the thread pool.
+		std::unique_ptr<Dx12MeshLodLoader> lodLoader;
+		std::unique_ptr<MeshLodStreamer> lodStreamer;
+		// The view doesn't move, LODs are picked for this position.
+		DirectX::XMFLOAT3 cameraPosition{ 0.0f, 0.0f, -2.0f };
+
+		// Compiled on worker threads by the Asset Loader.
+		Dx12ShaderData vertexShader;
+		Dx12ShaderData pixelShader;
+
+		uint32_t streamingMeshId{ 0 };
 		uint32_t rootSignatureId{ 0 };
 		uint32_t graphicsPSOId{ 0 };
 
 		bool appIsRunning{ false };
+		bool criticalAssetsLoaded{ false };
 	};
 }
\ No newline at end of file
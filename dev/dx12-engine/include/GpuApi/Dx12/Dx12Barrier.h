@@ -15,6 +15,8 @@ namespace dxe
 			UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
 			D3D12_RESOURCE_BARRIER_FLAGS flags = D3D12_RESOURCE_BARRIER_FLAG_NONE);
 
+		static D3D12_RESOURCE_BARRIER CreateUavBarrier(ID3D12Resource* pResource);
+
 		static D3D12_RESOURCE_BARRIER CreateRenderTargetToPresentTransitionBarrier(
 			ID3D12Resource* pResource,
 			UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
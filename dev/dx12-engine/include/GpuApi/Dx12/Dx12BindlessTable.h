@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12DescriptorHeap.h"
+
+#include "Core/Utility.h"
+#include "Memory/IndexAllocator.h"
+
+#include <d3d12.h>
+
+#include <cstdint>
+
+namespace dxe
+{
+	class Dx12Fence;
+
+	// Shader resource views in a range of the shader visible CBV/SRV/UAV heap, bound once per command
+	// list as the unbounded ranges of the bindless root signature (see Dx12RootSignature). Every view
+	// gets a stable index when it's created; shaders index the table with it, passed per draw in root
+	// constants, so drawing doesn't need any other root or table updates. Indices are recycled with
+	// an IndexAllocator once the GPU is done with the frame that freed them.
+
+	constexpr uint32_t DX12_DEFAULT_BINDLESS_TABLE_SIZE = 65536;
+
+	class Dx12BindlessTable
+	{
+	public:
+
+		// Holds [firstDescriptor, firstDescriptor + descriptorCount) of 'heap', indices are relative
+		// to 'firstDescriptor'. 'fence' is the one of the queue that draws with the table; both have
+		// to outlive the table.
+		Dx12BindlessTable(
+			ID3D12Device* device,
+			Dx12DescriptorHeap* heap,
+			Dx12Fence* fence,
+			uint32_t firstDescriptor,
+			uint32_t descriptorCount);
+		~Dx12BindlessTable() = default;
+
+		CLASS_NO_COPY(Dx12BindlessTable);
+		CLASS_NO_MOVE(Dx12BindlessTable);
+
+		// Both throw when the table is full.
+		uint32_t CreateShaderResourceView(ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* srvDesc);
+		// A copy of a descriptor from a heap that isn't shader visible (see Dx12DescriptorAllocator).
+		uint32_t CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE sourceDescriptor);
+
+		// 'index' may still be used by the work recorded so far, it's reused once the fence passes
+		// the next value it will signal.
+		void Free(uint32_t index);
+		void Retire();
+
+		// What SetGraphicsRootDescriptorTable binds, index 0 of the table.
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle() const;
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t index) const;
+
+		IndexStatistics GetStatistics() const;
+
+		Dx12DescriptorHeap* GetHeap() const;
+
+	private:
+
+		uint32_t AllocateIndex();
+
+		ID3D12Device* device{ nullptr };
+		Dx12DescriptorHeap* heap{ nullptr };
+		Dx12Fence* fence{ nullptr };
+		uint32_t firstDescriptor{ 0 };
+
+		IndexAllocator indices;
+	};
+}
@@ -8,6 +8,8 @@
 
 namespace dxe
 {
+	class Dx12UploadQueue;
+
 	class Dx12Buffer
 	{
 	public:
@@ -24,6 +26,12 @@ namespace dxe
 		size_t      bufferSize  { 0 };
 	};
 
+	// Row-major buffer of 'bufferSize' bytes, as placed and committed buffers are described.
+	D3D12_RESOURCE_DESC CreateBufferResourceDesc(uint64_t bufferSize);
+
+	// Buffers in UPLOAD heaps are written through Map. With an upload queue, which DEFAULT heaps need,
+	// they're created in the COMMON state and the data is copied on the copy queue instead.
+
 	class Dx12VertexBuffer
 	{
 	public:
@@ -31,7 +39,8 @@ namespace dxe
 		void CreateVertexBuffer(
 			ID3D12Device* device,
 			ID3D12Heap* heap,
-			Dx12BufferDataDesc& dataDesc);
+			Dx12BufferDataDesc& dataDesc,
+			Dx12UploadQueue* uploadQueue = nullptr);
 
 		size_t GetVertexCount() const;
 
@@ -53,7 +62,8 @@ namespace dxe
 		void CreateIndexBuffer(
 			ID3D12Device* device,
 			ID3D12Heap* heap,
-			Dx12BufferDataDesc& dataDesc);
+			Dx12BufferDataDesc& dataDesc,
+			Dx12UploadQueue* uploadQueue = nullptr);
 
 		size_t GetIndexCount() const;
 
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "GpuApi/Dx12/Dx12Queue.h"
+#include "GpuApi/Dx12/Dx12ResourceStateTracker.h"
 
 #include "Core/Utility.h"
+#include "Renderer/FramePacer.h"
 
 #include <d3d12.h>
 
@@ -19,6 +21,8 @@ namespace dxe
 	{
 		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> graphicsCommandList;
+		// States of the resources the command list uses, reset by BeginFrame.
+		std::unique_ptr<Dx12ResourceStateTracker> stateTracker;
 	};
 
 	class Dx12CommandManager
@@ -34,9 +38,20 @@ namespace dxe
 		void CreateCommandQueues(ID3D12Device* device);
 		void DestroyCommandQueues();
 
-		void CreateCommandContexts(ID3D12Device* device, uint32_t commandContextSlotCount);
+		// One graphics command context per frame in flight.
+		void CreateCommandContexts(ID3D12Device* device, uint32_t frameLatency);
 		void DestroyCommandContexts();
 
+		// Waits until the GPU is done with the context of the frame 'frameLatency' frames back, if it
+		// isn't yet, and resets its allocator. The command list is left for the caller to reset.
+		const Dx12GraphicsCommandContext* BeginFrame();
+		// Signals the direct queue fence once the work executed during the frame is done.
+		void EndFrame();
+		// Blocks until every frame ended so far is done on the GPU.
+		void WaitForFrames();
+
+		const FramePacer& GetFramePacer() const;
+
 		Dx12DirectQueue* GetDirectQueue() const;
 		Dx12ComputeQueue* GetComputeQueue() const;
 		Dx12CopyQueue* GetCopyQueue() const;
@@ -61,6 +76,7 @@ namespace dxe
 			D3D12_COMMAND_LIST_TYPE cmdListType, ID3D12CommandAllocator* commandAllocator) const;
 
 		uint32_t commandContextSlotCount{};
+		FramePacer framePacer{};
 
 		std::vector<Dx12GraphicsCommandContext> graphicsCommandContexts;
 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12DescriptorHeap.h"
+
+#include "Core/Utility.h"
+#include "Memory/RangeAllocator.h"
+
+#include <d3d12.h>
+
+#include <cstdint>
+
+namespace dxe
+{
+	// Contiguous descriptors of a heap, i.e. a descriptor table.
+	struct Dx12DescriptorAllocation
+	{
+		// Index of the first descriptor in the heap.
+		uint32_t index{ 0 };
+		uint32_t count{ 0 };
+		// RangeAllocator handle of persistent allocations.
+		uint32_t handle{ RANGE_INVALID_HANDLE };
+
+		D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle{};
+		// Only in shader visible heaps.
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle{};
+		uint32_t descriptorSize{ 0 };
+
+		bool IsValid() const { return count > 0; }
+
+		D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(uint32_t offset = 0) const
+		{
+			return D3D12_CPU_DESCRIPTOR_HANDLE{ cpuHandle.ptr + static_cast<SIZE_T>(offset) * descriptorSize };
+		}
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(uint32_t offset = 0) const
+		{
+			return D3D12_GPU_DESCRIPTOR_HANDLE{ gpuHandle.ptr + static_cast<UINT64>(offset) * descriptorSize };
+		}
+	};
+
+	// Long-lived descriptors (views of resources) in a range of a descriptor heap, allocated and freed
+	// with a RangeAllocator so tables of any size come out contiguous. Descriptors of a heap that isn't
+	// shader visible can be freed as soon as they've been copied to a shader visible one; those the GPU
+	// reads directly have to be freed once it's done (see Dx12ResourceManager::ReleaseDeferred).
+
+	class Dx12DescriptorAllocator
+	{
+	public:
+
+		// Hands out [firstDescriptor, firstDescriptor + descriptorCount) of 'heap', which has to outlive
+		// the allocator.
+		Dx12DescriptorAllocator(Dx12DescriptorHeap* heap, uint32_t firstDescriptor, uint32_t descriptorCount);
+		~Dx12DescriptorAllocator() = default;
+
+		CLASS_NO_COPY(Dx12DescriptorAllocator);
+		CLASS_NO_MOVE(Dx12DescriptorAllocator);
+
+		// Throws when the range has no 'count' contiguous free descriptors.
+		Dx12DescriptorAllocation Allocate(uint32_t count = 1);
+		void Free(Dx12DescriptorAllocation& allocation);
+
+		RangeStatistics GetStatistics() const;
+
+		Dx12DescriptorHeap* GetHeap() const;
+
+	private:
+
+		Dx12DescriptorHeap* heap{ nullptr };
+		uint32_t firstDescriptor{ 0 };
+
+		RangeAllocator ranges;
+	};
+}
@@ -18,12 +18,21 @@ namespace dxe
 		void Initialize(ID3D12Device* device);
 
 		D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandle(size_t descriptorIndex);
+		// Only for shader visible heaps.
+		D3D12_GPU_DESCRIPTOR_HANDLE GetGpuDescriptorHandle(size_t descriptorIndex);
+
+		ID3D12DescriptorHeap* GetDescriptorHeap() const;
+		size_t GetDescriptorCount() const;
+		size_t GetDescriptorSize() const;
+		D3D12_DESCRIPTOR_HEAP_TYPE GetDescriptorHeapType() const;
+		bool IsShaderVisible() const;
 
 	private:
 
 		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap;
 
 		D3D12_CPU_DESCRIPTOR_HANDLE heapStartHandle{};
+		D3D12_GPU_DESCRIPTOR_HANDLE gpuHeapStartHandle{};
 
 		size_t descriptorCount{ 0 };
 		size_t descriptorSize{ 0 };
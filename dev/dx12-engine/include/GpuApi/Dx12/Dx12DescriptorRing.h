@@ -0,0 +1,67 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12DescriptorAllocator.h"
+#include "GpuApi/Dx12/Dx12DescriptorHeap.h"
+
+#include "Core/Utility.h"
+#include "Memory/RingAllocator.h"
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class Dx12Fence;
+
+	// Transient shader visible descriptors, i.e. the tables a frame binds: a RingAllocator over a
+	// range of a shader visible heap, used like Dx12UploadRing. Tables are contiguous, filled by
+	// copying descriptors from heaps that aren't shader visible, submitted once per frame with the
+	// value of the fence that frame signals and reused once the GPU has reached it.
+
+	constexpr uint32_t DX12_DEFAULT_DESCRIPTOR_RING_SIZE = 16384;
+
+	class Dx12DescriptorRing
+	{
+	public:
+
+		// Hands out [firstDescriptor, firstDescriptor + descriptorCount) of 'heap'. 'fence' is the one
+		// whose values are passed to Submit; both have to outlive the ring.
+		Dx12DescriptorRing(
+			ID3D12Device* device,
+			Dx12DescriptorHeap* heap,
+			Dx12Fence* fence,
+			uint32_t firstDescriptor,
+			uint32_t descriptorCount);
+		~Dx12DescriptorRing() = default;
+
+		CLASS_NO_COPY(Dx12DescriptorRing);
+		CLASS_NO_MOVE(Dx12DescriptorRing);
+
+		// Waits for the GPU when the ring is full, throws when 'count' can never fit.
+		Dx12DescriptorAllocation Allocate(uint32_t count);
+		// A table holding copies of 'sourceDescriptors', in order.
+		Dx12DescriptorAllocation AllocateTable(const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& sourceDescriptors);
+
+		// Closes the batch of tables allocated since the last Submit, the GPU signals 'fenceValue'
+		// once it's done with them.
+		void Submit(uint64_t fenceValue);
+		void Retire();
+
+		// 'stallCount' counts the waits for the GPU.
+		RingStatistics GetStatistics() const;
+
+		Dx12DescriptorHeap* GetHeap() const;
+
+	private:
+
+		ID3D12Device* device{ nullptr };
+		Dx12DescriptorHeap* heap{ nullptr };
+		Dx12Fence* fence{ nullptr };
+		uint32_t firstDescriptor{ 0 };
+
+		RingAllocator ring;
+		uint64_t stallCount{ 0 };
+	};
+}
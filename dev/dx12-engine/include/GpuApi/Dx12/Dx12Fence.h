@@ -1,33 +1,79 @@
 #pragma once
 
+#include "Core/Utility.h"
+
+#include "GpuApi/FenceTimeline.h"
+
 #include <d3d12.h>
 
 #include <wrl/client.h>
 
 #include <cstdint>
+#include <vector>
 
 namespace dxe
 {
+	// Timeline of a queue's progress: every signal returns a new, larger value and work is tracked by
+	// the value signaled after it. Values can be polled without blocking, waited for on the CPU
+	// (several fences at once as well) or waited for by another queue on the GPU. The value
+	// bookkeeping is a FenceTimeline, this class adds the ID3D12Fence and its event.
+
+	class Dx12Fence;
+
+	struct Dx12FenceWait
+	{
+		Dx12Fence* fence{ nullptr };
+		uint64_t value{ 0 };
+	};
+
 	class Dx12Fence
 	{
 	public:
 
 		Dx12Fence() = default;
-		~Dx12Fence() = default;
+		~Dx12Fence();
+
+		CLASS_NO_COPY(Dx12Fence);
+		CLASS_NO_MOVE(Dx12Fence);
 
 		void Initialize(ID3D12Device* device);
 
-		void SignalOnGpu(ID3D12CommandQueue* commandQueue);
-		void SignalOnCpu();
+		// Both return the value signaled.
+		uint64_t SignalOnGpu(ID3D12CommandQueue* commandQueue);
+		uint64_t SignalOnCpu();
+
+		// Whether the GPU has reached 'value', without blocking. Only queries the fence when the last
+		// known completed value doesn't tell.
+		bool IsComplete(uint64_t value);
 
 		void WaitForFenceEvent();
+		// Blocks until the GPU has reached 'value'.
+		void WaitForValue(uint64_t value);
+		// Work executed on 'commandQueue' afterwards starts once the fence has reached 'value', the
+		// CPU doesn't wait.
+		void WaitOnGpu(ID3D12CommandQueue* commandQueue, uint64_t value) const;
+
+		// Blocks until every fence has reached its value.
+		static void WaitForAll(const std::vector<Dx12FenceWait>& waits);
+		// Blocks until one of the fences has reached its value and returns the index of one that has.
+		static size_t WaitForAny(const std::vector<Dx12FenceWait>& waits);
 
-		void SignalOnGpuAndWaitForFenceEvent(ID3D12CommandQueue* commandQueue);
+		uint64_t SignalOnGpuAndWaitForFenceEvent(ID3D12CommandQueue* commandQueue);
+
+		// The last value signaled and the last one the GPU has reached.
+		uint64_t GetValue() const;
+		uint64_t GetCompletedValue();
+
+		ID3D12Fence* GetFence() const;
 
 	private:
 
+		// Blocks on the events of the fences that haven't reached their values yet, returns false when
+		// there are none. Events can be left set by earlier waits, so callers check the values again.
+		static bool WaitForEvents(const std::vector<Dx12FenceWait>& waits, bool waitAll);
+
 		Microsoft::WRL::ComPtr<ID3D12Fence> fence;
 		HANDLE fenceEvent{ NULL };
-		uint64_t fenceValue{ 0 };
+		FenceTimeline timeline;
 	};
-}
\ No newline at end of file
+}
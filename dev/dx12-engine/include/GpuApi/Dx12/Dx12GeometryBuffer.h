@@ -0,0 +1,173 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12HeapAllocator.h"
+#include "GpuApi/Dx12/Dx12UploadQueue.h"
+
+#include "Core/Utility.h"
+#include "Memory/RangeAllocator.h"
+
+#include <d3d12.h>
+
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace dxe
+{
+	// Megabuffer mode for meshes: one large vertex buffer per vertex stride and one shared 32 bit
+	// index buffer, with every mesh a (base vertex, first index, count) range in them. The buffers
+	// are bound once and meshes are drawn with DrawIndexedInstanced offsets. Layouts with the same
+	// stride share a vertex buffer, which is fine since indices are relative to the base vertex.
+	// Buffers are placed in memory from a DEFAULT heap allocator and filled through the upload queue,
+	// on the copy queue; both have to outlive this. Before drawing, the direct queue has to wait for
+	// the copies (see Dx12UploadQueue::SynchronizeQueue). Their capacity is fixed at creation.
+	// Ranges of removed (or moved) meshes are only reused once the fence of the queue that draws them
+	// passes the next value it will signal, so frames in flight keep reading the right data.
+
+	constexpr uint32_t DX12_INVALID_GEOMETRY_ID = UINT32_MAX;
+
+	constexpr uint64_t DX12_DEFAULT_GEOMETRY_VERTEX_CAPACITY = 1ull << 20;
+	constexpr uint64_t DX12_DEFAULT_GEOMETRY_INDEX_CAPACITY = 1ull << 22;
+
+	struct Dx12GeometryRange
+	{
+		// Selects the vertex buffer.
+		uint32_t vertexStride{ 0 };
+
+		int32_t baseVertex{ 0 };
+		uint32_t vertexCount{ 0 };
+		uint32_t firstIndex{ 0 };
+		uint32_t indexCount{ 0 };
+	};
+
+	class Dx12Fence;
+
+	class Dx12GeometryBuffer
+	{
+	public:
+
+		// 'fence' is the one of the queue that draws from the buffers.
+		Dx12GeometryBuffer(
+			ID3D12Device* device,
+			Dx12HeapAllocator* heapAllocator,
+			Dx12UploadQueue* uploadQueue,
+			Dx12Fence* fence,
+			uint64_t indexCapacity = DX12_DEFAULT_GEOMETRY_INDEX_CAPACITY);
+		~Dx12GeometryBuffer();
+
+		CLASS_NO_COPY(Dx12GeometryBuffer);
+		CLASS_NO_MOVE(Dx12GeometryBuffer);
+
+		// Vertex buffers are otherwise created with the default capacity when a stride is first used.
+		void CreateVertexBuffer(uint32_t vertexStride, uint64_t vertexCapacity);
+
+		// Throws when the buffers are full. Returns the geometry ID.
+		template<typename VertexType>
+		uint32_t AddMesh(const std::vector<VertexType>& vertices, const std::vector<uint32_t>& indices)
+		{
+			return AddMesh(VertexType::stride, vertices.data(), vertices.size(), indices.data(), indices.size());
+		}
+		uint32_t AddMesh(
+			uint32_t vertexStride,
+			const void* vertices, uint64_t vertexCount,
+			const uint32_t* indices, uint64_t indexCount);
+		// Draws of the mesh may still be in flight, its ranges are reused once the fence passes the
+		// next value it will signal.
+		void RemoveMesh(uint32_t geometryId);
+
+		// Progressive meshes (see MeshLodStreamer)
+
+		// Appends vertices and indices to a mesh, indices are relative to its first vertex like those
+		// of AddMesh. The ranges grow in place when the space after them is free, otherwise the mesh
+		// moves to new ranges (its data copied on the copy queue) and the old ones are freed like the
+		// ranges of removed meshes. Throws when the buffers are full, the mesh is left as it was.
+		void AppendToMesh(
+			uint32_t geometryId,
+			const void* vertices, uint64_t vertexCount,
+			const uint32_t* indices, uint64_t indexCount);
+		// Cuts a mesh down to its first vertices and indices, the rest is freed like the ranges of
+		// removed meshes.
+		void TruncateMesh(uint32_t geometryId, uint64_t vertexCount, uint64_t indexCount);
+
+		// Frees the ranges the GPU is done with, once per frame.
+		void Retire();
+
+		// Ranges change when the buffer is defragmented, so they are looked up when recording draws.
+		Dx12GeometryRange GetRange(uint32_t geometryId) const;
+
+		D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView(uint32_t vertexStride) const;
+		D3D12_INDEX_BUFFER_VIEW GetIndexBufferView() const;
+
+		// Moves up to 'maxMoveBytes' of every buffer towards its start, returns the bytes moved. The
+		// copies run on the copy queue and data only moves into free ranges, so draws already recorded
+		// read the old copies, which are freed like the ranges of removed meshes.
+		uint64_t Defragment(uint64_t maxMoveBytes = UINT64_MAX);
+
+		RangeStatistics GetVertexStatistics(uint32_t vertexStride) const;
+		RangeStatistics GetIndexStatistics() const;
+
+	private:
+
+		struct BufferPool
+		{
+			uint32_t elementSize{ 0 };
+
+			Dx12HeapAllocation allocation{};
+			Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+
+			std::unique_ptr<RangeAllocator> ranges;
+		};
+
+		// Freed once the fence completes 'fenceValue'.
+		struct PendingRange
+		{
+			uint64_t fenceValue{ 0 };
+			BufferPool* pool{ nullptr };
+			uint32_t handle{ RANGE_INVALID_HANDLE };
+		};
+
+		struct Geometry
+		{
+			uint32_t vertexStride{ 0 };
+			uint32_t vertexHandle{ RANGE_INVALID_HANDLE };
+			uint32_t indexHandle{ RANGE_INVALID_HANDLE };
+		};
+
+		std::unique_ptr<BufferPool> CreateBufferPool(uint32_t elementSize, uint64_t capacity);
+		void ReleaseBufferPool(BufferPool& pool);
+
+		// nullptr if there's no vertex buffer of that stride.
+		BufferPool* FindVertexPool(uint32_t vertexStride) const;
+
+		// Reuses the ranges the GPU is done with before giving up.
+		uint32_t AllocateHandle(BufferPool& pool, uint64_t count);
+		// Uploads 'data' into the range.
+		uint32_t AllocateRange(BufferPool& pool, const void* data, uint64_t count);
+		// Uploads 'data' after the range, which may move. Returns false when the pool is full.
+		bool GrowRange(BufferPool& pool, uint32_t& handle, const void* data, uint64_t count);
+		// Frees the elements after the first 'count' of the range.
+		void ShrinkRange(BufferPool& pool, uint32_t handle, uint64_t count);
+		void FreeRange(BufferPool& pool, uint32_t handle);
+		uint64_t DefragmentPool(BufferPool& pool, uint64_t maxMoveBytes);
+
+		void AssertIfInvalidId(uint32_t geometryId) const;
+
+		ID3D12Device* device{ nullptr };
+		Dx12HeapAllocator* heapAllocator{ nullptr };
+		Dx12UploadQueue* uploadQueue{ nullptr };
+		Dx12Fence* fence{ nullptr };
+
+		std::vector<std::unique_ptr<BufferPool>> vertexPools;
+		std::unique_ptr<BufferPool> indexPool;
+
+		// In fence value order.
+		std::deque<PendingRange> pendingRanges;
+
+		// Indexed by geometry ID, removed entries have no vertex handle.
+		std::vector<Geometry> geometries;
+		SeqIdGenerator<uint32_t> geometryIds{};
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Renderer/FramePacer.h"
+
 #include <cstdint>
 
 namespace dxe
@@ -21,7 +23,8 @@ namespace dxe
 
 	Dx12GpuData* GetDx12GpuData();
 
-	void InitializeDx12();
+	// Up to 'frameLatency' frames are in flight, between MIN_FRAME_LATENCY and MAX_FRAME_LATENCY.
+	void InitializeDx12(uint32_t frameLatency = DEFAULT_FRAME_LATENCY);
 	void TerminateDx12();
 
 	// [TODO]
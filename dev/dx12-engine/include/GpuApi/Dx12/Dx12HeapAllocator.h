@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Memory/TlsfAllocator.h"
+
+#include "Core/Utility.h"
+
+#include <d3d12.h>
+
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dxe
+{
+	// Placed resource memory from a few large ID3D12Heaps, sub-allocated with TLSF. Resources that
+	// don't fit a regular heap get a dedicated one. Every heap allocator has one heap type and one
+	// set of heap flags, so resource heap tier 1 hardware gets separate allocators for buffers,
+	// textures and render targets. Heaps are 4 MB aligned (for MSAA textures) only when the flags
+	// allow render targets.
+
+	constexpr uint64_t DX12_DEFAULT_HEAP_BLOCK_SIZE = 64ull * 1024 * 1024;
+
+	struct Dx12HeapAllocation
+	{
+		ID3D12Heap* heap{ nullptr };
+		uint64_t offset{ 0 };
+		uint64_t size{ 0 };
+
+		uint32_t heapIndex{ UINT32_MAX };
+		TlsfAllocation allocation{};
+
+		bool IsValid() const { return heap != nullptr; }
+	};
+
+	struct Dx12HeapStatistics
+	{
+		uint32_t heapCount{ 0 };
+		uint64_t heapBytes{ 0 };
+		uint64_t usedBytes{ 0 };
+		uint32_t allocationCount{ 0 };
+
+		uint64_t largestFreeBlock{ 0 };
+		// Over all heaps: 1 - largestFreeBlock / free bytes.
+		float fragmentation{ 0.0f };
+	};
+
+	class Dx12HeapAllocator
+	{
+	public:
+
+		Dx12HeapAllocator(
+			ID3D12Device* device,
+			D3D12_HEAP_TYPE heapType,
+			D3D12_HEAP_FLAGS heapFlags,
+			uint64_t heapBlockSize = DX12_DEFAULT_HEAP_BLOCK_SIZE);
+		~Dx12HeapAllocator() = default;
+
+		CLASS_NO_COPY(Dx12HeapAllocator);
+		CLASS_NO_MOVE(Dx12HeapAllocator);
+
+		// Size and alignment as given by ID3D12Device::GetResourceAllocationInfo, so 64 KB for
+		// buffers and most textures, 4 KB for small textures and 4 MB for MSAA ones.
+		Dx12HeapAllocation Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo);
+		Dx12HeapAllocation Allocate(const D3D12_RESOURCE_DESC& resourceDesc);
+		// The resource placed in it has to be released (and no longer used by the GPU) already.
+		void Free(Dx12HeapAllocation& allocation);
+
+		// Releases heaps that have no allocations left. The first one is always kept.
+		void ReleaseEmptyHeaps();
+
+		Dx12HeapStatistics GetStatistics() const;
+
+		D3D12_HEAP_TYPE GetHeapType() const;
+		D3D12_HEAP_FLAGS GetHeapFlags() const;
+
+	private:
+
+		struct HeapBlock
+		{
+			Microsoft::WRL::ComPtr<ID3D12Heap> heap;
+			TlsfAllocator allocator;
+		};
+
+		uint32_t CreateHeapBlock(uint64_t size);
+
+		ID3D12Device* device{ nullptr };
+
+		D3D12_HEAP_TYPE heapType{};
+		D3D12_HEAP_FLAGS heapFlags{};
+		uint64_t heapAlignment{ 0 };
+		uint64_t heapBlockSize{ 0 };
+
+		// Released heaps leave empty entries behind, so heap indices stay valid.
+		std::vector<std::unique_ptr<HeapBlock>> heapBlocks;
+
+		mutable std::mutex mutex;
+	};
+}
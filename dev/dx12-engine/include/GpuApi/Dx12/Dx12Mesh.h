@@ -1,7 +1,9 @@
 #pragma once
 
 #include "GpuApi/Dx12/Dx12Buffer.h"
+#include "GpuApi/Dx12/Dx12HeapAllocator.h"
 
+#include "Core/Utility.h"
 #include "Renderer/Vertex.h"
 
 #include <d3d12.h>
@@ -13,15 +15,28 @@
 
 namespace dxe
 {
+	class Dx12UploadQueue;
+
+	// Vertex and index buffers placed in memory from a shared heap allocator, which has to outlive the mesh.
+	// Meshes in DEFAULT heaps are filled through an upload queue, the data is ready once the queue drawing
+	// them has been synchronized with it.
 	class Dx12Mesh
 	{
 	public:
 
+		Dx12Mesh() = default;
+		~Dx12Mesh();
+
+		CLASS_NO_COPY(Dx12Mesh);
+		CLASS_NO_MOVE(Dx12Mesh);
+
 		template<typename VertexType, typename IndexType>
 		void CreateMesh(
 			ID3D12Device* device,
+			Dx12HeapAllocator* heapAllocator,
 			const std::vector<VertexType>& vertices,
-			const std::vector<IndexType>& indices)
+			const std::vector<IndexType>& indices,
+			Dx12UploadQueue* uploadQueue = nullptr)
 		{
 			size_t vertexSize = VertexType::stride;
 			size_t vertexBufferSize = vertexSize * vertices.size();
@@ -29,23 +44,25 @@ namespace dxe
 			size_t indexSize = sizeof(IndexType);
 			size_t indexBufferSize = indexSize * indices.size();
 
-			InitializeHeap(device, vertexSize, indexSize);
+			AllocateHeapMemory(heapAllocator, uploadQueue, vertexBufferSize, indexBufferSize);
 
-			CreateVertexBuffer(device, vertices.data(), vertexSize, vertexBufferSize);
-			CreateIndexBuffer(device, indices.data(), indexSize, indexBufferSize);
+			CreateVertexBuffer(device, uploadQueue, vertices.data(), vertexSize, vertexBufferSize);
+			CreateIndexBuffer(device, uploadQueue, indices.data(), indexSize, indexBufferSize);
 		}
 
 		template<typename VertexType>
 		void CreateMesh(
 			ID3D12Device* device,
-			const std::vector<VertexType>& vertices)
+			Dx12HeapAllocator* heapAllocator,
+			const std::vector<VertexType>& vertices,
+			Dx12UploadQueue* uploadQueue = nullptr)
 		{
 			size_t vertexSize = VertexType::stride;
 			size_t vertexBufferSize = vertexSize * vertices.size();
 
-			InitializeHeap(device, vertexSize, 0);
+			AllocateHeapMemory(heapAllocator, uploadQueue, vertexBufferSize, 0);
 
-			CreateVertexBuffer(device, vertices.data(), vertexSize, vertexBufferSize);
+			CreateVertexBuffer(device, uploadQueue, vertices.data(), vertexSize, vertexBufferSize);
 		}
 
 		Dx12VertexBuffer* GetVertexBuffer() const;
@@ -53,22 +70,23 @@ namespace dxe
 
 	private:
 
-		void InitializeHeap(
-			ID3D12Device* device,
-			size_t requestedVbSize,
-			size_t requestedIbSize);
+		// Frees the memory of a previous CreateMesh first.
+		void AllocateHeapMemory(
+			Dx12HeapAllocator* allocator,
+			Dx12UploadQueue* uploadQueue,
+			size_t vertexBufferSize,
+			size_t indexBufferSize);
+		void ReleaseHeapMemory();
 
-		void CreateVertexBuffer(ID3D12Device* device, const void* vertSrcData, size_t vertexSize, size_t vertexBufferSize);
-		void CreateIndexBuffer(ID3D12Device* device, const void* indexSrcData, size_t indexSize, size_t indexDataSize);
+		void CreateVertexBuffer(ID3D12Device* device, Dx12UploadQueue* uploadQueue, const void* vertSrcData, size_t vertexSize, size_t vertexBufferSize);
+		void CreateIndexBuffer(ID3D12Device* device, Dx12UploadQueue* uploadQueue, const void* indexSrcData, size_t indexSize, size_t indexDataSize);
 
 		std::unique_ptr<Dx12VertexBuffer> vertexBuffer;
 		std::unique_ptr<Dx12IndexBuffer> indexBuffer;
 
-		Microsoft::WRL::ComPtr<ID3D12Heap> heap;
-
-		size_t heapSize{ 0 };
+		Dx12HeapAllocator* heapAllocator{ nullptr };
 
-		size_t vbOffset{ 0 };
-		size_t ibOffset{ 0 };
+		Dx12HeapAllocation vertexAllocation{};
+		Dx12HeapAllocation indexAllocation{};
 	};
 }
\ No newline at end of file
@@ -68,6 +68,9 @@ namespace dxe
 
 		void CreateGraphicsPSO(ID3D12Device* device);
 
+		// Shader bytecode and input layout pointers stay valid for the lifetime of the PSO.
+		const D3D12_GRAPHICS_PIPELINE_STATE_DESC& GetDesc() const;
+
 	private:
 
 		D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{};
@@ -14,10 +14,15 @@ namespace dxe
 
 		virtual void InitializeCommandQueue(ID3D12Device* device) = 0;
 
-		void SignalFence(Dx12Fence* fence);
+		// Returns the value signaled.
+		uint64_t SignalFence(Dx12Fence* fence);
+		// Work executed on this queue afterwards starts once 'fence' has reached 'value', the CPU doesn't wait.
+		void WaitForFence(Dx12Fence* fence, uint64_t value);
 		void FlushQueue();
 
 		ID3D12CommandQueue* GetCommandQueue() const;
+		// Signaled by FlushQueue.
+		Dx12Fence* GetQueueFence() const;
 
 	protected:
 
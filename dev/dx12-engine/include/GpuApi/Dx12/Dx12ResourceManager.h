@@ -1,10 +1,19 @@
 #pragma once
 
+#include "GpuApi/Dx12/Dx12BindlessTable.h"
+#include "GpuApi/Dx12/Dx12DescriptorAllocator.h"
+#include "GpuApi/Dx12/Dx12DescriptorHeap.h"
+#include "GpuApi/Dx12/Dx12DescriptorRing.h"
+#include "GpuApi/Dx12/Dx12GeometryBuffer.h"
+#include "GpuApi/Dx12/Dx12HeapAllocator.h"
 #include "GpuApi/Dx12/Dx12Mesh.h"
 #include "GpuApi/Dx12/Dx12RootSignature.h"
 #include "GpuApi/Dx12/Dx12PSO.h"
+#include "GpuApi/Dx12/Dx12UploadQueue.h"
+#include "GpuApi/Dx12/Dx12UploadRing.h"
 
 #include "Core/Utility.h"
+#include "Memory/DeferredReleaseQueue.h"
 
 #include <cassert>
 #include <cstdint>
@@ -45,10 +54,13 @@ namespace dxe
 
 			return resourceId;
 		}
-		void RemoveResource(IdType resourceId)
+		// Frees the ID and hands the resource back, the GPU may still use it (see
+		// Dx12ResourceManager::RemoveResource).
+		std::shared_ptr<ResourceType> RemoveResource(IdType resourceId)
 		{
 			AssertIfInvalidId(resourceId);
-			resources[resourceId].reset();
+			resourceIds.FreeUniqueId(resourceId);
+			return std::move(resources[resourceId]);
 		}
 		std::shared_ptr<ResourceType> GetResource(IdType resourceId)
 		{
@@ -74,15 +86,99 @@ namespace dxe
 		// TODO: add thread safety mechanisms such as std::mutex? 
 	};
 
+	class Dx12CommandManager;
+	class Dx12Queue;
+
 	class Dx12ResourceManager
 	{
 	public:
 
-		void Initialize();
+		void Initialize(ID3D12Device* device, Dx12CommandManager* commandManager);
 		void Terminate();
 
+		// Keeps 'object' (a ComPtr, a shared_ptr of a mesh, ...) alive until 'queue' is done with the
+		// work submitted so far and the work recorded before its next fence signal, which covers the
+		// current frame on the direct queue.
+		template<typename ObjectType>
+		void ReleaseDeferred(ObjectType&& object, Dx12Queue* queue)
+		{
+			deferredReleases->Release(
+				std::forward<ObjectType>(object), GetTimeline(queue), GetNextFenceValue(queue));
+		}
+		// For resources used on the direct queue.
+		template<typename ObjectType>
+		void ReleaseDeferred(ObjectType&& object)
+		{
+			ReleaseDeferred(std::forward<ObjectType>(object), GetDirectQueue());
+		}
+
+		// Removes a resource from its container right away, it's released once the GPU is done with it:
+		// the direct queue may still draw with it, and the copy queue may still fill it if it's a mesh in
+		// a DEFAULT heap, so both queues hold a reference.
+		template<typename ResourceType, uint32_t ResourceContainerSize>
+		void RemoveResource(Dx12ResourceContainer<ResourceType, ResourceContainerSize>& container, uint32_t resourceId)
+		{
+			std::shared_ptr<ResourceType> resource = container.RemoveResource(resourceId);
+
+			// Flushing submits the copies still batched, so the fence value it returns is one the copy
+			// queue reaches without further uploads.
+			uint64_t copyFenceValue = uploadQueue->Flush();
+			if (copyFenceValue > 0)
+				deferredReleases->Release(std::shared_ptr<ResourceType>{ resource }, GetTimeline(GetCopyQueue()), copyFenceValue);
+
+			ReleaseDeferred(std::move(resource));
+		}
+
+		// Destroys what the queues are done with, once per frame.
+		void RetireDeferredReleases();
+
+		// CBV/SRV/UAV descriptors of resources, in a heap that isn't shader visible.
+		Dx12DescriptorAllocator* GetDescriptorAllocator() const;
+		// Views with stable indices at the start of the shader visible CBV/SRV/UAV heap, indices are
+		// recycled with the direct queue's fence.
+		Dx12BindlessTable* GetBindlessTable() const;
+		// Per-frame descriptor tables in the rest of the shader visible CBV/SRV/UAV heap, retired with
+		// the direct queue's fence.
+		Dx12DescriptorRing* GetDescriptorRing() const;
+		Dx12DescriptorHeap* GetShaderVisibleDescriptorHeap() const;
+
+		// Mesh buffers the CPU writes through Map, in UPLOAD heaps.
+		Dx12HeapAllocator* GetMeshHeapAllocator() const;
+		// Static mesh buffers in DEFAULT heaps, filled through the upload queue.
+		Dx12HeapAllocator* GetStaticMeshHeapAllocator() const;
+		// Megabuffer for meshes drawn by geometry ID, in memory from the static mesh heap allocator and
+		// filled through the upload queue.
+		Dx12GeometryBuffer* GetGeometryBuffer() const;
+		// Staging memory for copies on the copy queue, retired with the copy queue's fence.
+		Dx12UploadRing* GetUploadRing() const;
+		// Copies into DEFAULT heap buffers, staged in the upload ring.
+		Dx12UploadQueue* GetUploadQueue() const;
+
 		Dx12ResourceContainer< Dx12Mesh,          64 > meshes;
 		Dx12ResourceContainer< Dx12RootSignature, 16 > rootSignatures;
 		Dx12ResourceContainer< Dx12GraphicsPSO,   16 > graphicsPSOs;
+
+	private:
+
+		// Deferred release timeline of each queue.
+		uint32_t GetTimeline(Dx12Queue* queue) const;
+		uint64_t GetNextFenceValue(Dx12Queue* queue) const;
+		Dx12Queue* GetDirectQueue() const;
+		Dx12Queue* GetCopyQueue() const;
+
+		Dx12CommandManager* commandManager{ nullptr };
+		std::unique_ptr<DeferredReleaseQueue> deferredReleases;
+
+		std::unique_ptr<Dx12DescriptorHeap> descriptorHeap;
+		std::unique_ptr<Dx12DescriptorAllocator> descriptorAllocator;
+		std::unique_ptr<Dx12DescriptorHeap> shaderVisibleDescriptorHeap;
+		std::unique_ptr<Dx12BindlessTable> bindlessTable;
+		std::unique_ptr<Dx12DescriptorRing> descriptorRing;
+
+		std::unique_ptr<Dx12HeapAllocator> meshHeapAllocator;
+		std::unique_ptr<Dx12HeapAllocator> staticMeshHeapAllocator;
+		std::unique_ptr<Dx12GeometryBuffer> geometryBuffer;
+		std::unique_ptr<Dx12UploadRing> uploadRing;
+		std::unique_ptr<Dx12UploadQueue> uploadQueue;
 	};
 }
\ No newline at end of file
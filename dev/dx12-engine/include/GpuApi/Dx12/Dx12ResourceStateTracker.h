@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <d3d12.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace dxe
+{
+	// States of the resources a command list uses, as of the commands recorded so far. Transition
+	// only queues the barriers that are needed and FlushBarriers issues them with a single
+	// ResourceBarrier call; flush before recording the work that depends on them. Until then a
+	// queued barrier is merged with the next transition of the same (sub)resource: A -> B -> C becomes
+	// A -> C, A -> B -> A disappears and two read states are combined. Resources are tracked per
+	// subresource once one is transitioned on its own.
+	//
+	// Split barriers are optional: BeginTransition queues the BEGIN_ONLY half, the next Transition of
+	// the resource the END_ONLY half, so the GPU can start the transition early. When both halves
+	// would end up in the same flush it's a regular barrier.
+	//
+	// Only does the bookkeeping, nothing but FlushBarriers touches the command list.
+
+	struct ResourceStateStatistics
+	{
+		// Transition and BeginTransition calls.
+		uint64_t transitionRequestCount{ 0 };
+		// Issued transition barriers, split halves count once each.
+		uint64_t transitionBarrierCount{ 0 };
+		// Requests for a state the (sub)resource was already in.
+		uint64_t skippedTransitionCount{ 0 };
+		// Requests folded into a queued barrier, some of them removed it altogether.
+		uint64_t mergedTransitionCount{ 0 };
+		uint64_t uavBarrierCount{ 0 };
+
+		// ResourceBarrier calls, 'transitionBarrierCount' + 'uavBarrierCount' barriers in total.
+		uint64_t flushCount{ 0 };
+	};
+
+	class Dx12ResourceStateTracker
+	{
+	public:
+
+		Dx12ResourceStateTracker() = default;
+		~Dx12ResourceStateTracker() = default;
+
+		CLASS_NO_COPY(Dx12ResourceStateTracker);
+		CLASS_DEFAULT_MOVE(Dx12ResourceStateTracker);
+
+		// 'state' is the one of every subresource when the command list starts using 'resource'.
+		void TrackResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, uint32_t subresourceCount = 1);
+		// Forgets every resource and drops the queued barriers, for the next recording.
+		void Reset();
+
+		void Transition(
+			ID3D12Resource* resource,
+			D3D12_RESOURCE_STATES stateAfter,
+			UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+		// The first half of a split barrier, the resource can't be used until it's transitioned again.
+		// Falls back to Transition when the subresources of 'resource' are in different states.
+		void BeginTransition(
+			ID3D12Resource* resource,
+			D3D12_RESOURCE_STATES stateAfter,
+			UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+		// Between UAV accesses of 'resource'.
+		void UavBarrier(ID3D12Resource* resource);
+
+		// Issues the queued barriers with one ResourceBarrier call and returns how many there were.
+		// Takes any command list type with ID3D12GraphicsCommandList's ResourceBarrier.
+		template<typename CommandListType>
+		uint32_t FlushBarriers(CommandListType* commandList)
+		{
+			uint32_t barrierCount = CollectBarriers();
+			if (barrierCount > 0)
+				commandList->ResourceBarrier(barrierCount, barrierBatch.data());
+
+			return barrierCount;
+		}
+		size_t GetPendingBarrierCount() const;
+
+		// As of the last Transition. ALL_SUBRESOURCES only works while they're in the same state.
+		D3D12_RESOURCE_STATES GetState(
+			ID3D12Resource* resource,
+			UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES) const;
+		bool IsTracked(ID3D12Resource* resource) const;
+
+		ResourceStateStatistics GetStatistics() const;
+
+	private:
+
+		static constexpr size_t NO_BARRIER = SIZE_MAX;
+
+		struct PendingBarrier
+		{
+			D3D12_RESOURCE_BARRIER barrier{};
+			// Merged away, skipped by FlushBarriers.
+			bool removed{ false };
+		};
+
+		struct TrackedResource
+		{
+			// Of every subresource while 'subresourceStates' is empty.
+			D3D12_RESOURCE_STATES state{ D3D12_RESOURCE_STATE_COMMON };
+			std::vector<D3D12_RESOURCE_STATES> subresourceStates;
+			uint32_t subresourceCount{ 1 };
+
+			// The last barrier queued for the resource, only a transition there can be merged with.
+			size_t lastBarrier{ NO_BARRIER };
+			// BEGIN_ONLY half waiting for its END_ONLY half, NO_BARRIER after the flush that issued it.
+			bool splitPending{ false };
+			size_t splitBeginBarrier{ NO_BARRIER };
+			D3D12_RESOURCE_STATES splitStateBefore{ D3D12_RESOURCE_STATE_COMMON };
+			UINT splitSubresource{ D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES };
+		};
+
+		TrackedResource& GetTrackedResource(ID3D12Resource* resource);
+		void EndSplitTransition(ID3D12Resource* resource, TrackedResource& trackedResource);
+		void TransitionResource(
+			ID3D12Resource* resource,
+			TrackedResource& trackedResource,
+			D3D12_RESOURCE_STATES stateAfter,
+			UINT subresource);
+		// Merges with the resource's last queued barrier when possible. Returns the state the
+		// subresource ends up in, which includes 'stateBefore' when two read states are combined.
+		D3D12_RESOURCE_STATES QueueTransition(
+			ID3D12Resource* resource,
+			TrackedResource& trackedResource,
+			UINT subresource,
+			D3D12_RESOURCE_STATES stateBefore,
+			D3D12_RESOURCE_STATES stateAfter);
+		size_t QueueBarrier(const D3D12_RESOURCE_BARRIER& barrier);
+		// Moves the queued barriers into 'barrierBatch' for FlushBarriers and returns their count.
+		uint32_t CollectBarriers();
+
+		static D3D12_RESOURCE_STATES GetSubresourceState(const TrackedResource& trackedResource, UINT subresource);
+		static void SetSubresourceState(TrackedResource& trackedResource, UINT subresource, D3D12_RESOURCE_STATES state);
+		static bool IsReadState(D3D12_RESOURCE_STATES state);
+		static bool IsTransitionNeeded(D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter);
+
+		std::unordered_map<ID3D12Resource*, TrackedResource> trackedResources;
+
+		std::vector<PendingBarrier> pendingBarriers;
+		// Reused by CollectBarriers.
+		std::vector<D3D12_RESOURCE_BARRIER> barrierBatch;
+
+		ResourceStateStatistics statistics{};
+	};
+}
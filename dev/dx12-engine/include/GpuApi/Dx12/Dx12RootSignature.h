@@ -2,20 +2,44 @@
 
 #include <d3d12.h>
 
+#include <cstdint>
+
 #include <wrl/client.h>
 
 namespace dxe
 {
+	// Root constants of a draw with the bindless root signature, 'cbuffer : register(b0, space0)'.
+	struct Dx12BindlessDrawConstants
+	{
+		uint32_t drawIndex{ 0 };
+		// Index of the draw's resource in the bindless table (see Dx12BindlessTable).
+		uint32_t resourceIndex{ 0 };
+	};
+
+	// Root parameters of the bindless root signature
+	constexpr UINT DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER = 0;
+	constexpr UINT DX12_BINDLESS_TABLE_PARAMETER = 1;
+	constexpr UINT DX12_BINDLESS_ROOT_CONSTANT_COUNT = sizeof(Dx12BindlessDrawConstants) / sizeof(uint32_t);
+
 	class Dx12RootSignature
 	{
 	public:
 
+		// No parameters.
 		void CreateRootSignature(ID3D12Device* device);
+		// The draw constants and one descriptor table of unbounded SRV ranges, all starting at the
+		// table's first descriptor: 'Texture2D[] : register(t0, space1)' and
+		// 'ByteAddressBuffer[] : register(t0, space2)'. Throws on devices below resource binding tier 2.
+		void CreateBindlessRootSignature(ID3D12Device* device);
 
 		ID3D12RootSignature* GetRootSignature() const;
+		bool IsBindless() const;
 
 	private:
 
+		void SerializeRootSignature(ID3D12Device* device, const D3D12_ROOT_SIGNATURE_DESC& rootSignatureDesc);
+
 		Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;
+		bool bindless{ false };
 	};
 }
\ No newline at end of file
@@ -20,9 +20,11 @@ namespace dxe
 	{
 	public:
 
+		// Flip model buffers can't have an sRGB format, so 'bufferFormat' is UNORM and the back
+		// buffers are rendered to through sRGB views of it (see GetRtvFormat).
 		Dx12SwapChain(
 			uint32_t frameBufferCount,
-			DXGI_FORMAT rtvFormat = DXGI_FORMAT_R8G8B8A8_UNORM,
+			DXGI_FORMAT bufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM,
 			DXGI_SWAP_EFFECT swapChainMode = DXGI_SWAP_EFFECT_FLIP_DISCARD);
 
 		~Dx12SwapChain();
@@ -42,6 +44,9 @@ namespace dxe
 
 		ID3D12Resource* GetCurrentBackBufferResource() const;
 		D3D12_CPU_DESCRIPTOR_HANDLE GetCurrentBackBufferRTV() const;
+		// What pipelines rendering to the back buffers declare: linear colors written through it
+		// are encoded to sRGB.
+		DXGI_FORMAT GetRtvFormat() const;
 
 	private:
 
@@ -60,6 +65,7 @@ namespace dxe
 
 		Microsoft::WRL::ComPtr<IDXGISwapChain4> swapChain;
 
+		DXGI_FORMAT bufferFormat{};
 		DXGI_FORMAT rtvFormat{};
 		DXGI_SWAP_EFFECT swapChainEffect{};
 
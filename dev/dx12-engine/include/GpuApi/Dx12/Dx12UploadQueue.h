@@ -0,0 +1,99 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12Queue.h"
+#include "GpuApi/Dx12/Dx12UploadRing.h"
+
+#include "Core/Utility.h"
+#include "Streaming/UploadBatcher.h"
+
+#include <d3d12.h>
+
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dxe
+{
+	// Streams data into buffers in DEFAULT heaps: uploads are staged in the upload ring and copied on
+	// the copy queue, in batches formed by an UploadBatcher. Destination buffers are created in the
+	// COMMON state, buffers are promoted to COPY_DEST by the copy and decay back to COMMON once it's
+	// done, so no barriers are recorded on either queue. Before a queue uses uploaded data,
+	// SynchronizeQueue makes it wait for the copies on the GPU.
+
+	// Copy of 'size' bytes between two regions of a buffer.
+	struct Dx12BufferRegionCopy
+	{
+		uint64_t sourceOffset{ 0 };
+		uint64_t destinationOffset{ 0 };
+		uint64_t size{ 0 };
+	};
+
+	class Dx12UploadQueue : private UploadBackend
+	{
+	public:
+
+		// 'uploadRing' has to be retired with the fence of 'copyQueue'; both have to outlive the
+		// upload queue.
+		Dx12UploadQueue(
+			ID3D12Device* device,
+			Dx12CopyQueue* copyQueue,
+			Dx12UploadRing* uploadRing,
+			const UploadBatcherDesc& desc = UploadBatcherDesc{});
+		~Dx12UploadQueue();
+
+		CLASS_NO_COPY(Dx12UploadQueue);
+		CLASS_NO_MOVE(Dx12UploadQueue);
+
+		// 'destination' has to be a buffer in the COMMON state that no queue uses until it has been
+		// synchronized. 'data' can be released as soon as this returns.
+		void UploadBuffer(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+		// Copies regions of 'buffer' (COMMON, like upload destinations) on the copy queue, after the
+		// uploads so far. The regions must not overlap each other, and no queue may use the
+		// destinations until it has been synchronized. Returns the copy queue fence value covering them.
+		uint64_t CopyBufferRegions(ID3D12Resource* buffer, const std::vector<Dx12BufferRegionCopy>& copies);
+
+		// Submits the open batch and returns the copy queue fence value covering every upload and
+		// buffer copy so far.
+		uint64_t Flush();
+		// Flushes and makes 'queue' wait for the uploads before the work it executes next, the CPU
+		// doesn't wait. Call before executing work that reads uploaded data.
+		void SynchronizeQueue(Dx12Queue* queue);
+
+		UploadStatistics GetStatistics() const;
+
+	private:
+
+		struct CopyContext
+		{
+			Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
+			Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList7> commandList;
+			// The allocator can be reset once the copy queue fence reaches it.
+			uint64_t fenceValue{ 0 };
+		};
+
+		// UploadBackend
+		UploadStaging AllocateStaging(uint64_t size) override;
+		void RecordCopy(const UploadCopy& copy) override;
+		uint64_t SubmitCopies() override;
+
+		// Resets a context the GPU is done with, or creates one.
+		CopyContext* OpenCopyContext();
+
+		ID3D12Device* device{ nullptr };
+		Dx12CopyQueue* copyQueue{ nullptr };
+		Dx12UploadRing* uploadRing{ nullptr };
+
+		UploadBatcher batcher;
+
+		std::vector<CopyContext> copyContexts;
+		// Index into copyContexts of the context recording the open batch, if any.
+		size_t openContextIndex{ SIZE_MAX };
+		// Of the last CopyBufferRegions, which submits on its own rather than through the batcher.
+		uint64_t regionCopyFenceValue{ 0 };
+
+		// Copy fence values the queues wait for already.
+		std::vector<std::pair<Dx12Queue*, uint64_t>> synchronizedValues;
+	};
+}
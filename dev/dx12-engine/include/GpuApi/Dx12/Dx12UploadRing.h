@@ -0,0 +1,83 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12HeapAllocator.h"
+
+#include "Core/Utility.h"
+#include "Memory/RingAllocator.h"
+
+#include <d3d12.h>
+
+#include <wrl/client.h>
+
+#include <cstdint>
+
+namespace dxe
+{
+	class Dx12Fence;
+
+	// Reusable staging memory: one UPLOAD buffer, mapped once, handing out transient spans. Spans are
+	// grouped per frame or per copy batch by Submit, tagged with a value of the fence that the queue
+	// reading them signals, and reused once the GPU has reached that value. When the ring is full,
+	// Allocate retires what has completed and otherwise waits for the oldest batch, which is logged
+	// as a stall.
+
+	constexpr uint64_t DX12_DEFAULT_UPLOAD_RING_SIZE = 32ull * 1024 * 1024;
+
+	struct Dx12UploadAllocation
+	{
+		ID3D12Resource* resource{ nullptr };
+		uint64_t offset{ 0 };
+		uint64_t size{ 0 };
+
+		uint8_t* cpuAddress{ nullptr };
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress{ 0 };
+
+		bool IsValid() const { return resource != nullptr; }
+	};
+
+	class Dx12UploadRing
+	{
+	public:
+
+		// 'fence' is the one whose values are passed to Submit, it has to outlive the ring.
+		Dx12UploadRing(
+			ID3D12Device* device,
+			Dx12HeapAllocator* heapAllocator,
+			Dx12Fence* fence,
+			uint64_t ringSize = DX12_DEFAULT_UPLOAD_RING_SIZE);
+		~Dx12UploadRing();
+
+		CLASS_NO_COPY(Dx12UploadRing);
+		CLASS_NO_MOVE(Dx12UploadRing);
+
+		// Constant buffers need 256 byte alignment, texture data 512. Throws when 'size' can never
+		// fit, i.e. larger than the ring or than what the open batch leaves.
+		Dx12UploadAllocation Allocate(uint64_t size, uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+		// Closes the batch of spans allocated since the last Submit; the GPU work reading them
+		// signals 'fenceValue' once it's done.
+		void Submit(uint64_t fenceValue);
+		// Reuses the space of completed batches, i.e. once per frame. Allocate does this as well
+		// when the ring is full.
+		void Retire();
+
+		// 'stallCount' counts the waits for the GPU.
+		RingStatistics GetStatistics() const;
+
+		ID3D12Resource* GetResource() const;
+
+	private:
+
+		ID3D12Device* device{ nullptr };
+		Dx12HeapAllocator* heapAllocator{ nullptr };
+		Dx12Fence* fence{ nullptr };
+
+		RingAllocator ring;
+		uint64_t stallCount{ 0 };
+
+		Dx12HeapAllocation allocation{};
+		Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+		uint8_t* mappedData{ nullptr };
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress{ 0 };
+	};
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	// Value bookkeeping of a fence, independent of the GPU API: the last value signaled and the last
+	// one the fence is known to have reached. Like RingAllocator it doesn't touch the fence itself,
+	// the caller signals the values it hands out and reads the fence when asked to.
+
+	class FenceTimeline
+	{
+	public:
+
+		// Hands out the next value to signal, which becomes the last signaled value.
+		uint64_t Advance();
+
+		// Whether the fence has reached 'value'. 'readCompletedValue' returns the value the fence has
+		// reached and is only called when the cached one doesn't tell.
+		template<typename ReadFunction>
+		bool IsComplete(uint64_t value, ReadFunction&& readCompletedValue)
+		{
+			assert(value <= signaledValue && "Fence value hasn't been signaled yet!");
+
+			if (value <= completedValue)
+				return true;
+
+			return value <= UpdateCompletedValue(readCompletedValue());
+		}
+
+		// Records a value read from the fence and returns the completed value. Values read lower than
+		// the cached one (i.e. after the fence was set back) don't make completed values pending again.
+		uint64_t UpdateCompletedValue(uint64_t readValue);
+
+		// Starts over at 0, for a new fence.
+		void Reset();
+
+		uint64_t GetValue() const;
+		// The cached completed value, doesn't read the fence.
+		uint64_t GetCompletedValue() const;
+
+	private:
+
+		uint64_t signaledValue{ 0 };
+		uint64_t completedValue{ 0 };
+	};
+
+	// Leaves one wait per fence that 'isComplete' (called with a wait) reports pending, in the order
+	// the fences are first listed. A fence listed twice waits for its larger value when waiting for
+	// all, for its smaller one when waiting for any. 'WaitType' has a 'fence' pointer and a 'value'.
+	template<typename WaitType, typename IsCompleteFunction>
+	std::vector<WaitType> MergePendingFenceWaits(
+		const std::vector<WaitType>& waits, bool waitAll, IsCompleteFunction&& isComplete)
+	{
+		std::vector<WaitType> pendingWaits;
+		for (const WaitType& wait : waits)
+		{
+			assert(wait.fence && "Invalid fence to wait for!");
+			if (isComplete(wait))
+				continue;
+
+			auto pendingWait = std::find_if(pendingWaits.begin(), pendingWaits.end(),
+				[&wait](const WaitType& pending) { return pending.fence == wait.fence; });
+
+			if (pendingWait == pendingWaits.end())
+				pendingWaits.push_back(wait);
+			else if (waitAll)
+				pendingWait->value = std::max(pendingWait->value, wait.value);
+			else
+				pendingWait->value = std::min(pendingWait->value, wait.value);
+		}
+		return pendingWaits;
+	}
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "IO/IoRequest.h"
+
+#include "Core/ThreadPool.h"
+#include "Core/Utility.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dxe
+{
+	enum class IoBackendType
+	{
+		THREAD_POOL,
+		IO_URING,
+	};
+
+	class IoBackend
+	{
+	public:
+
+		virtual ~IoBackend() = default;
+
+		virtual IoBackendType GetBackendType() const = 0;
+
+		// Maximum number of reads the backend keeps in flight at once.
+		virtual uint32_t GetQueueDepth() const = 0;
+		virtual uint32_t GetInFlightCount() const = 0;
+
+		// Starts every request of the batch without waiting for any of them.
+		// The batch never holds more than 'GetQueueDepth() - GetInFlightCount()' requests.
+		virtual void Submit(std::vector<IoReadRequest>& batch) = 0;
+
+		// Runs the completion callbacks of finished reads and returns their count.
+		// With 'wait' set, blocks until at least one read has finished or Wake is called, it may
+		// also return early with none (returns immediately if nothing is in flight).
+		virtual uint32_t Reap(bool wait) = 0;
+		// Makes a waiting Reap return, from any thread. Without one waiting, the next Reap doesn't block.
+		virtual void Wake() = 0;
+	};
+
+	// Portable fallback: every read is a blocking read on a pool thread.
+
+	class IoThreadPoolBackend : public IoBackend
+	{
+	public:
+
+		IoThreadPoolBackend(uint32_t threadCount, uint32_t queueDepth);
+
+		CLASS_NO_COPY(IoThreadPoolBackend);
+		CLASS_NO_MOVE(IoThreadPoolBackend);
+
+		IoBackendType GetBackendType() const override;
+
+		uint32_t GetQueueDepth() const override;
+		uint32_t GetInFlightCount() const override;
+
+		void Submit(std::vector<IoReadRequest>& batch) override;
+		uint32_t Reap(bool wait) override;
+		void Wake() override;
+
+	private:
+
+		void ExecuteRead(IoReadRequest& request);
+
+		std::unique_ptr<ThreadPool> threadPool;
+
+		mutable std::mutex completionMutex;
+		std::condition_variable completionCondition;
+
+		uint32_t queueDepth{ 0 };
+		uint32_t inFlightCount{ 0 };
+		uint32_t unreapedCount{ 0 };
+		bool wakeRequested{ false };
+	};
+
+	// Performs a whole blocking read. Also used by the synchronous code paths.
+	IoReadResult ReadFileBlocking(const IoReadRequest& request);
+
+	// Picks io_uring where it is available and falls back to the thread pool otherwise.
+	std::unique_ptr<IoBackend> CreateIoBackend(uint32_t queueDepth, uint32_t fallbackThreadCount = 0);
+}
\ No newline at end of file
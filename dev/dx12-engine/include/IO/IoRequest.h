@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace dxe
+{
+	// Lower values are served first.
+	enum class IoPriority : uint8_t
+	{
+		CRITICAL = 0,
+		HIGH = 1,
+		NORMAL = 2,
+		LOW = 3,
+	};
+
+	struct IoReadResult
+	{
+		std::filesystem::path path;
+
+		uint64_t offset{ 0 };
+		std::vector<uint8_t> data;
+
+		bool succeeded{ false };
+		std::string errorMessage;
+	};
+
+	struct IoReadRequest
+	{
+		using CompletionCallback = std::function<void(IoReadResult&)>;
+
+		std::filesystem::path path;
+
+		uint64_t offset{ 0 };
+		// 0 reads everything from 'offset' to the end of the file.
+		uint64_t size{ 0 };
+
+		IoPriority priority{ IoPriority::NORMAL };
+
+		// Invoked on an I/O thread, never on the thread that issued the request.
+		CompletionCallback onComplete;
+	};
+
+	// Priority first, then file and offset so that reads of the same file
+	// are submitted in ascending order.
+	inline bool IoReadRequestOrder(const IoReadRequest& r1, const IoReadRequest& r2)
+	{
+		if (r1.priority != r2.priority)
+			return r1.priority < r2.priority;
+		if (r1.path != r2.path)
+			return r1.path < r2.path;
+		return r1.offset < r2.offset;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "IO/IoBackend.h"
+#include "IO/IoRequest.h"
+
+#include "Core/Utility.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dxe
+{
+	struct IoSchedulerSettings
+	{
+		// Upper bound on reads in flight. Deep queues are what keeps NVMe drives busy.
+		uint32_t queueDepth{ 128 };
+		// Only used by the thread pool backend; 0 picks a default.
+		uint32_t fallbackThreadCount{ 0 };
+		bool forceThreadPoolBackend{ false };
+	};
+
+	struct IoSchedulerStats
+	{
+		uint64_t requestsCompleted{ 0 };
+		uint64_t bytesRead{ 0 };
+		uint64_t batchesSubmitted{ 0 };
+	};
+
+	// Collects read requests from any thread and feeds them to the backend
+	// from a dedicated dispatcher thread. Pending requests are re-sorted
+	// by priority, file and offset every time the backend has free slots,
+	// which are refilled as soon as reads finish or new requests arrive.
+
+	class IoScheduler
+	{
+	public:
+
+		explicit IoScheduler(const IoSchedulerSettings& settings = IoSchedulerSettings{});
+		~IoScheduler();
+
+		CLASS_NO_COPY(IoScheduler);
+		CLASS_NO_MOVE(IoScheduler);
+
+		// The result is delivered through 'request.onComplete'.
+		void Read(IoReadRequest request);
+		void Read(std::vector<IoReadRequest>& requests);
+
+		// The result is delivered through the returned future. 'request.onComplete' runs first if set.
+		std::future<IoReadResult> ReadAsync(IoReadRequest request);
+
+		// Blocks until every request issued so far has completed.
+		void WaitIdle();
+
+		IoBackendType GetBackendType() const;
+		IoSchedulerStats GetStats() const;
+
+	private:
+
+		void DispatchLoop();
+
+		void TakeBatch(std::vector<IoReadRequest>& batch, uint32_t maxBatchSize);
+
+		std::unique_ptr<IoBackend> backend;
+
+		std::vector<IoReadRequest> pendingRequests;
+		bool pendingSorted{ true };
+
+		mutable std::mutex schedulerMutex;
+		std::condition_variable pendingCondition;
+		std::condition_variable idleCondition;
+
+		IoSchedulerStats stats{};
+		uint64_t outstandingCount{ 0 };
+
+		// The dispatcher waits for completions with free slots, new requests wake the backend.
+		bool wakeOnRead{ false };
+
+		bool stopRequested{ false };
+
+		std::thread dispatcherThread;
+	};
+}
\ No newline at end of file
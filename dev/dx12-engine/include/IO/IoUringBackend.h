@@ -0,0 +1,126 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include "IO/IoBackend.h"
+
+#include "Core/Utility.h"
+
+#include <linux/stat.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace dxe
+{
+	// Talks to the kernel through the raw io_uring syscalls, so no liburing dependency is needed.
+	// Files are opened and sized with IORING_OP_OPENAT and IORING_OP_STATX next to the reads, so
+	// nothing blocks the submitting thread. Completions signal an eventfd registered with the ring,
+	// which Wake signals as well. All methods but Wake are expected to be called from a single
+	// (dispatcher) thread.
+
+	class IoUringBackend : public IoBackend
+	{
+	public:
+
+		explicit IoUringBackend(uint32_t queueDepth);
+		~IoUringBackend() override;
+
+		CLASS_NO_COPY(IoUringBackend);
+		CLASS_NO_MOVE(IoUringBackend);
+
+		// The ring has to be available and support every operation the backend uses (Linux 5.6+).
+		static bool IsSupported();
+
+		IoBackendType GetBackendType() const override;
+
+		uint32_t GetQueueDepth() const override;
+		uint32_t GetInFlightCount() const override;
+
+		void Submit(std::vector<IoReadRequest>& batch) override;
+		uint32_t Reap(bool wait) override;
+		void Wake() override;
+
+	private:
+
+		// Kept in io_uring_sqe::user_data next to the slot.
+		enum class Operation : uint32_t
+		{
+			OPEN,
+			STATX,
+			READ,
+		};
+
+		struct InFlightRead
+		{
+			IoReadRequest request;
+			IoReadResult result;
+
+			int fileDescriptor{ -1 };
+			struct statx fileStatx{};
+			// OPEN and STATX run side by side, the read starts once both are done.
+			uint32_t pendingSetupCount{ 0 };
+
+			uint64_t bytesRead{ 0 };
+		};
+
+		void SetupRing();
+		void DestroyRing();
+
+		// Returns the SQEs pushed.
+		uint32_t FinishSetupOperation(uint32_t slot);
+		bool StartRead(InFlightRead& read);
+
+		io_uring_sqe& PushSqe(uint32_t slot, Operation operation);
+		void PushOpenSqe(uint32_t slot);
+		void PushStatxSqe(uint32_t slot);
+		void PushReadSqe(uint32_t slot);
+		void SubmitSqes(uint32_t sqeCount);
+
+		void CompleteRead(uint32_t slot);
+		void FailRead(uint32_t slot, const std::string& errorMessage);
+
+		int ringFd{ -1 };
+		// Signaled by completions and Wake.
+		int eventFd{ -1 };
+
+		// Submission queue ring
+
+		void* sqRingPtr{ nullptr };
+		size_t sqRingSize{ 0 };
+
+		uint32_t* sqHead{ nullptr };
+		uint32_t* sqTail{ nullptr };
+		uint32_t* sqRingMask{ nullptr };
+		uint32_t* sqArray{ nullptr };
+
+		io_uring_sqe* sqes{ nullptr };
+		size_t sqesSize{ 0 };
+
+		// Completion queue ring
+
+		void* cqRingPtr{ nullptr };
+		size_t cqRingSize{ 0 };
+
+		uint32_t* cqHead{ nullptr };
+		uint32_t* cqTail{ nullptr };
+		uint32_t* cqRingMask{ nullptr };
+
+		io_uring_cqe* cqes{ nullptr };
+
+		std::vector<InFlightRead> slots;
+		std::vector<uint32_t> freeSlots;
+
+		uint32_t queueDepth{ 0 };
+		uint32_t inFlightCount{ 0 };
+
+		// Includes requests that finished without reaching the kernel (open failures, empty reads).
+		uint32_t completedSinceReap{ 0 };
+	};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace dxe
+{
+	// Keeps objects the GPU may still use alive until it's done with them. Each object is tagged with
+	// the timeline (i.e. a queue's fence) and the value that covers its last use, and destroyed by
+	// Retire once that value completes. Any movable object can be deferred: ComPtrs, shared_ptrs of
+	// meshes and the like. Like RingAllocator it only does the bookkeeping, the completed values come
+	// from the caller.
+	//
+	// Values of a timeline only grow, so each timeline is a FIFO: an object deferred with a smaller
+	// value than the one before it waits for the larger value as well, which is later but still
+	// safe. Retire stops at the first pending object, so a frame without anything to free costs O(1).
+
+	struct DeferredReleaseStatistics
+	{
+		uint64_t deferredCount{ 0 };
+		uint64_t releasedCount{ 0 };
+		size_t pendingCount{ 0 };
+	};
+
+	class DeferredReleaseQueue
+	{
+	public:
+
+		explicit DeferredReleaseQueue(uint32_t timelineCount);
+		// Releases whatever is still pending, the GPU has to be done with it.
+		~DeferredReleaseQueue();
+
+		CLASS_NO_COPY(DeferredReleaseQueue);
+		CLASS_NO_MOVE(DeferredReleaseQueue);
+
+		// 'object' is destroyed once 'timeline' has completed 'fenceValue'.
+		template<typename ObjectType>
+		void Release(ObjectType&& object, uint32_t timeline, uint64_t fenceValue)
+		{
+			assert(timeline < timelines.size() && "Invalid timeline!");
+
+			std::deque<PendingObject>& pendingObjects = timelines[timeline];
+			if (!pendingObjects.empty() && pendingObjects.back().fenceValue > fenceValue)
+				fenceValue = pendingObjects.back().fenceValue;
+
+			pendingObjects.push_back(PendingObject{
+				fenceValue,
+				std::make_unique<DeferredObject<std::decay_t<ObjectType>>>(std::forward<ObjectType>(object)) });
+
+			statistics.deferredCount++;
+		}
+
+		// Destroys the objects of 'timeline' with values up to 'completedFenceValue', in the order
+		// they were deferred. Returns how many.
+		size_t Retire(uint32_t timeline, uint64_t completedFenceValue);
+		// Destroys everything, i.e. after waiting for the GPU to go idle.
+		size_t ReleaseAll();
+
+		size_t GetPendingCount() const;
+		uint32_t GetTimelineCount() const;
+
+		DeferredReleaseStatistics GetStatistics() const;
+
+	private:
+
+		struct DeferredObjectBase
+		{
+			virtual ~DeferredObjectBase() = default;
+		};
+
+		template<typename ObjectType>
+		struct DeferredObject : DeferredObjectBase
+		{
+			explicit DeferredObject(ObjectType&& object)
+				: object(std::move(object)) {}
+			explicit DeferredObject(const ObjectType& object)
+				: object(object) {}
+
+			ObjectType object;
+		};
+
+		struct PendingObject
+		{
+			uint64_t fenceValue{ 0 };
+			std::unique_ptr<DeferredObjectBase> object;
+		};
+
+		std::vector<std::deque<PendingObject>> timelines;
+
+		DeferredReleaseStatistics statistics{};
+	};
+}
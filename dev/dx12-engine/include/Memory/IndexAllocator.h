@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace dxe
+{
+	// Stable indices in [0, capacity), i.e. slots of a bindless descriptor table. An index keeps its
+	// meaning until it's freed, and a freed index is only handed out again once the fence value it was
+	// freed with completes, so work already recorded with it never sees another resource. Recently
+	// retired indices are reused first, Allocate and Free are O(1). Like RingAllocator it only does
+	// the bookkeeping.
+
+	constexpr uint32_t INDEX_INVALID = UINT32_MAX;
+
+	struct IndexStatistics
+	{
+		uint32_t capacity{ 0 };
+		// Allocated indices, including freed ones waiting for their fence value.
+		uint32_t usedCount{ 0 };
+		uint32_t pendingFreeCount{ 0 };
+		uint32_t peakUsedCount{ 0 };
+
+		uint64_t allocationCount{ 0 };
+	};
+
+	class IndexAllocator
+	{
+	public:
+
+		explicit IndexAllocator(uint32_t capacity);
+		~IndexAllocator() = default;
+
+		CLASS_NO_COPY(IndexAllocator);
+		CLASS_DEFAULT_MOVE(IndexAllocator);
+
+		// Returns INDEX_INVALID when every index is in use or waiting to be retired.
+		uint32_t Allocate();
+		// 'index' is reused once 'fenceValue' completes. Values lower than those of earlier frees are
+		// raised to the latest one, so the pending indices stay in fence value order.
+		void Free(uint32_t index, uint64_t fenceValue);
+		// Makes the indices freed with fence values up to 'completedFenceValue' available again.
+		void Retire(uint64_t completedFenceValue);
+
+		// Frees everything at once, the GPU must be done with all of it.
+		void Reset();
+
+		bool IsAllocated(uint32_t index) const;
+
+		IndexStatistics GetStatistics() const;
+
+		uint32_t GetCapacity() const;
+		uint32_t GetUsedCount() const;
+
+	private:
+
+		struct PendingIndex
+		{
+			uint64_t fenceValue{ 0 };
+			uint32_t index{ INDEX_INVALID };
+		};
+
+		uint32_t capacity{ 0 };
+		// Indices at and above it have never been allocated.
+		uint32_t nextIndex{ 0 };
+		uint32_t usedCount{ 0 };
+		uint32_t peakUsedCount{ 0 };
+		uint64_t allocationCount{ 0 };
+
+		std::vector<uint32_t> freeIndices;
+		std::deque<PendingIndex> pendingIndices;
+		std::vector<bool> allocated;
+	};
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace dxe
+{
+	// Best-fit allocator over a range of 'capacity' elements (i.e. vertices or indices of a shared
+	// buffer) that can also compact itself. Allocations are referred to by handles that stay valid
+	// when defragmentation moves them, so their offsets should be looked up again after ApplyMoves.
+	// Free ranges are kept by offset (for merging) and by size (for best fit), so Allocate and Free
+	// are O(log n).
+
+	constexpr uint32_t RANGE_INVALID_HANDLE = UINT32_MAX;
+
+	// Copy 'size' elements from 'sourceOffset' to 'destinationOffset'.
+	struct RangeMove
+	{
+		uint32_t handle{ RANGE_INVALID_HANDLE };
+		uint64_t sourceOffset{ 0 };
+		uint64_t destinationOffset{ 0 };
+		uint64_t size{ 0 };
+	};
+
+	struct RangeStatistics
+	{
+		uint64_t capacity{ 0 };
+		uint64_t usedSize{ 0 };
+		uint64_t freeSize{ 0 };
+		uint64_t largestFreeRange{ 0 };
+
+		uint32_t allocationCount{ 0 };
+		uint32_t freeRangeCount{ 0 };
+
+		// 1 - largestFreeRange / freeSize, like TlsfStatistics.
+		float fragmentation{ 0.0f };
+	};
+
+	class RangeAllocator
+	{
+	public:
+
+		explicit RangeAllocator(uint64_t capacity);
+		~RangeAllocator() = default;
+
+		CLASS_NO_COPY(RangeAllocator);
+		CLASS_DEFAULT_MOVE(RangeAllocator);
+
+		// Returns RANGE_INVALID_HANDLE when no free range is large enough.
+		uint32_t Allocate(uint64_t size);
+		void Free(uint32_t handle);
+
+		// Extends the allocation by 'extraSize' elements in place, returns false (and leaves it as it
+		// is) when the range right after it isn't free or too small.
+		bool Grow(uint32_t handle, uint64_t extraSize);
+		// Cuts the allocation down to its first 'size' elements and returns a handle to the rest, which
+		// stays allocated until freed (i.e. once the GPU is done reading it).
+		uint32_t Split(uint32_t handle, uint64_t size);
+
+		uint64_t GetOffset(uint32_t handle) const;
+		uint64_t GetSize(uint32_t handle) const;
+
+		// Defragmentation
+
+		// One pass of moves, at most 'maxMoveSize' elements in total. Going from the end of the range,
+		// allocations move to the lowest free range they fit in. Destinations are only ever free
+		// ranges, so the copies of a pass neither overlap each other nor any allocation and can run
+		// in any order (i.e. without barriers in between). Nothing changes until ApplyMoves; repeated
+		// passes converge, an empty plan means there is nothing left to move.
+		std::vector<RangeMove> PlanDefragmentation(uint64_t maxMoveSize = UINT64_MAX) const;
+		// Once the data has been copied. The allocator must not have changed since planning. With
+		// 'sourceHandles' the sources aren't freed but stay allocated under new handles appended to it,
+		// which defragmentation never moves, until readers of the old copies are done and they're
+		// freed like any other allocation.
+		void ApplyMoves(const std::vector<RangeMove>& moves, std::vector<uint32_t>* sourceHandles = nullptr);
+
+		RangeStatistics GetStatistics() const;
+
+		uint64_t GetCapacity() const;
+		uint64_t GetUsedSize() const;
+		uint32_t GetAllocationCount() const;
+
+	private:
+
+		struct Range
+		{
+			uint64_t offset{ 0 };
+			uint64_t size{ 0 };
+			// Sources kept by ApplyMoves stay in place.
+			bool movable{ true };
+		};
+
+		void InsertFreeRange(uint64_t offset, uint64_t size);
+		void RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator freeRange);
+		void MoveFreeRange(std::map<uint64_t, uint64_t>::iterator freeRange, uint64_t offset, uint64_t size);
+		// Takes [offset, offset + size) out of the free range containing it.
+		void ReserveRange(uint64_t offset, uint64_t size);
+		uint32_t AddAllocation(const Range& range);
+		void AssertIfInvalidHandle(uint32_t handle) const;
+
+		uint64_t capacity{ 0 };
+		uint64_t usedSize{ 0 };
+		uint32_t allocationCount{ 0 };
+
+		// Free ranges, offset to size and (size, offset) for best fit with the lowest offset first.
+		std::map<uint64_t, uint64_t> freeRangesByOffset;
+		std::set<std::pair<uint64_t, uint64_t>> freeRangesBySize;
+
+		// Indexed by handle, freed entries have a size of 0.
+		std::vector<Range> allocations;
+		SeqIdGenerator<uint32_t> handles{};
+	};
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cstdint>
+#include <deque>
+
+namespace dxe
+{
+	// Ring of 'capacity' bytes for transient data, i.e. upload staging memory. Allocations are grouped
+	// into batches by Submit, each tagged with the fence value of the GPU work that reads them; Retire
+	// frees whole batches once their values complete, oldest first. Like TlsfAllocator it only does
+	// the offset bookkeeping. An allocation that doesn't fit before the end of the ring starts over at
+	// offset 0, the skipped tail is retired with its batch.
+
+	constexpr uint64_t RING_INVALID_OFFSET = UINT64_MAX;
+
+	struct RingStatistics
+	{
+		uint64_t capacity{ 0 };
+		uint64_t usedSize{ 0 };
+		// Of 'usedSize', allocated since the last Submit.
+		uint64_t openBatchSize{ 0 };
+		uint32_t pendingBatchCount{ 0 };
+
+		uint64_t allocationCount{ 0 };
+		// Allocations that didn't fit because the ring was full.
+		uint64_t stallCount{ 0 };
+		// Padding and ring tails skipped on wrap-around.
+		uint64_t wastedSize{ 0 };
+	};
+
+	class RingAllocator
+	{
+	public:
+
+		explicit RingAllocator(uint64_t capacity);
+		~RingAllocator() = default;
+
+		CLASS_NO_COPY(RingAllocator);
+		CLASS_DEFAULT_MOVE(RingAllocator);
+
+		// 'alignment' has to be a power of two. Returns RING_INVALID_OFFSET when the ring is full,
+		// which counts as a stall: retire (or wait for) the oldest batch and try again.
+		uint64_t Allocate(uint64_t size, uint64_t alignment = 1);
+		// Whether Allocate would succeed, without counting a stall.
+		bool CanAllocate(uint64_t size, uint64_t alignment = 1) const;
+
+		// Everything allocated since the last Submit is freed when 'fenceValue' completes. Values
+		// must not decrease. Does nothing when nothing was allocated.
+		void Submit(uint64_t fenceValue);
+		// Frees the batches with fence values up to 'completedFenceValue'.
+		void Retire(uint64_t completedFenceValue);
+
+		bool HasPendingBatches() const;
+		// The value to wait for to free the oldest batch.
+		uint64_t GetOldestPendingFenceValue() const;
+
+		// Frees everything at once, the GPU must be done with all of it.
+		void Reset();
+
+		RingStatistics GetStatistics() const;
+
+		uint64_t GetCapacity() const;
+		uint64_t GetUsedSize() const;
+
+	private:
+
+		struct Batch
+		{
+			uint64_t fenceValue{ 0 };
+			// Where the ring's head moves once the batch is retired.
+			uint64_t end{ 0 };
+			uint64_t size{ 0 };
+		};
+
+		// Where an allocation would go, RING_INVALID_OFFSET if it doesn't fit.
+		uint64_t FindOffset(uint64_t size, uint64_t alignment) const;
+
+		uint64_t capacity{ 0 };
+
+		// Oldest byte in use and the next free byte. Equal when the ring is empty or full.
+		uint64_t head{ 0 };
+		uint64_t tail{ 0 };
+		uint64_t usedSize{ 0 };
+		uint64_t openBatchSize{ 0 };
+
+		std::deque<Batch> batches;
+
+		uint64_t allocationCount{ 0 };
+		uint64_t stallCount{ 0 };
+		uint64_t wastedSize{ 0 };
+	};
+}
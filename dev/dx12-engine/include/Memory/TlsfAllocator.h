@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	// Two-level segregated fit allocator over an abstract range of 'capacity' bytes. It only does the
+	// offset bookkeeping (i.e. for placed resources in a GPU heap), so it never touches the memory.
+	// Allocate and Free are O(1): free blocks are kept in size class lists found through two bitmaps,
+	// and freed blocks merge with their free neighbours right away.
+
+	constexpr uint64_t TLSF_INVALID_OFFSET = UINT64_MAX;
+	constexpr uint32_t TLSF_INVALID_BLOCK = UINT32_MAX;
+
+	struct TlsfAllocation
+	{
+		uint64_t offset{ TLSF_INVALID_OFFSET };
+		uint64_t size{ 0 };
+
+		// Identifies the allocation for Free.
+		uint32_t block{ TLSF_INVALID_BLOCK };
+
+		bool IsValid() const { return block != TLSF_INVALID_BLOCK; }
+	};
+
+	struct TlsfStatistics
+	{
+		uint64_t capacity{ 0 };
+		uint64_t usedBytes{ 0 };
+		uint64_t freeBytes{ 0 };
+		uint64_t largestFreeBlock{ 0 };
+
+		uint32_t allocationCount{ 0 };
+		uint32_t freeBlockCount{ 0 };
+
+		// 0 when the free space is one block, close to 1 when it's scattered in small pieces:
+		// 1 - largestFreeBlock / freeBytes.
+		float fragmentation{ 0.0f };
+	};
+
+	class TlsfAllocator
+	{
+	public:
+
+		explicit TlsfAllocator(uint64_t capacity);
+		~TlsfAllocator() = default;
+
+		CLASS_NO_COPY(TlsfAllocator);
+		CLASS_DEFAULT_MOVE(TlsfAllocator);
+
+		// 'alignment' has to be a power of two. Returns an invalid allocation when nothing fits.
+		TlsfAllocation Allocate(uint64_t size, uint64_t alignment = 1);
+		void Free(const TlsfAllocation& allocation);
+
+		// Frees everything at once.
+		void Reset();
+
+		TlsfStatistics GetStatistics() const;
+
+		uint64_t GetCapacity() const;
+		uint64_t GetUsedBytes() const;
+		uint32_t GetAllocationCount() const;
+		bool IsEmpty() const;
+
+	private:
+
+		static constexpr uint32_t SECOND_LEVEL_LOG2 = 5;
+		static constexpr uint32_t SECOND_LEVEL_COUNT = 1u << SECOND_LEVEL_LOG2;
+		static constexpr uint32_t FIRST_LEVEL_COUNT = 64 - SECOND_LEVEL_LOG2 + 1;
+
+		struct Block
+		{
+			uint64_t offset{ 0 };
+			uint64_t size{ 0 };
+
+			// Neighbours in address order.
+			uint32_t previousPhysical{ TLSF_INVALID_BLOCK };
+			uint32_t nextPhysical{ TLSF_INVALID_BLOCK };
+
+			// Neighbours in the block's size class list, while free.
+			uint32_t previousFree{ TLSF_INVALID_BLOCK };
+			uint32_t nextFree{ TLSF_INVALID_BLOCK };
+
+			bool free{ false };
+		};
+
+		static void MapSize(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+
+		uint32_t CreateBlock(uint64_t offset, uint64_t size);
+		void DestroyBlock(uint32_t blockIndex);
+
+		void InsertFreeBlock(uint32_t blockIndex);
+		void RemoveFreeBlock(uint32_t blockIndex);
+		// A free block of at least 'size' bytes, or TLSF_INVALID_BLOCK.
+		uint32_t FindFreeBlock(uint64_t size) const;
+
+		// Shrinks 'blockIndex' to 'size' bytes, the rest becomes a new block that is returned.
+		uint32_t SplitBlock(uint32_t blockIndex, uint64_t size);
+		// Merges 'blockIndex' into its physical predecessor, returns the merged block.
+		uint32_t MergeWithPrevious(uint32_t blockIndex);
+
+		uint64_t capacity{ 0 };
+		uint64_t usedBytes{ 0 };
+		uint32_t allocationCount{ 0 };
+
+		// Unused entries have a size of 0 and are listed in 'unusedBlocks'.
+		std::vector<Block> blocks;
+		std::vector<uint32_t> unusedBlocks;
+
+		uint64_t firstLevelBitmap{ 0 };
+		uint32_t secondLevelBitmaps[FIRST_LEVEL_COUNT]{};
+		uint32_t freeLists[FIRST_LEVEL_COUNT][SECOND_LEVEL_COUNT];
+	};
+}
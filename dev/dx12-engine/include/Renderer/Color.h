@@ -0,0 +1,62 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dxe
+{
+	// Single values
+
+	// Exact piecewise sRGB curve, values in [0, 1].
+	float SrgbToLinear(float value);
+	float LinearToSrgb(float value);
+
+	// Lookup table based, rounding matches the exact curve.
+	float SrgbUnorm8ToLinear(uint8_t value);
+	uint8_t LinearToSrgbUnorm8(float value);
+
+	uint8_t FloatToUnorm8(float value);
+	float Unorm8ToFloat(uint8_t value);
+	uint16_t FloatToUnorm16(float value);
+	float Unorm16ToFloat(uint16_t value);
+
+	// IEEE half floats, rounded to nearest even. Out of range values become infinity, NaNs stay NaN.
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	// R in the lowest byte, same memory order as R8G8B8A8_UNORM.
+	uint32_t PackUnorm8x4(const DirectX::XMFLOAT4& color);
+	DirectX::XMFLOAT4 UnpackUnorm8x4(uint32_t packed);
+
+	// Batches
+	//
+	// Counts are in pixels. Pixels have 'channelCount' interleaved channels: with 4 the last one
+	// is alpha and is only rescaled, never gamma converted; with 3 (i.e. vertex colors) every
+	// channel is converted. The float <-> sRGB kernels use an SSE2 polynomial pow that stays
+	// within 3e-6 of the exact curve; 8-bit results only differ from the lookup tables for
+	// inputs sitting right on a rounding boundary.
+
+	void ConvertSrgbUnorm8ToLinear(const uint8_t* source, float* destination, size_t pixelCount, uint32_t channelCount = 4);
+	void ConvertLinearToSrgbUnorm8(const float* source, uint8_t* destination, size_t pixelCount, uint32_t channelCount = 4);
+
+	void ConvertSrgbToLinear(const float* source, float* destination, size_t pixelCount, uint32_t channelCount = 4);
+	void ConvertLinearToSrgb(const float* source, float* destination, size_t pixelCount, uint32_t channelCount = 4);
+
+	// Plain format conversions, every value is treated the same.
+	void ConvertUnorm8ToFloat(const uint8_t* source, float* destination, size_t valueCount);
+	void ConvertFloatToUnorm8(const float* source, uint8_t* destination, size_t valueCount);
+	void ConvertUnorm16ToFloat(const uint16_t* source, float* destination, size_t valueCount);
+	void ConvertFloatToUnorm16(const float* source, uint16_t* destination, size_t valueCount);
+	void ConvertFloatToHalf(const float* source, uint16_t* destination, size_t valueCount);
+	void ConvertHalfToFloat(const uint16_t* source, float* destination, size_t valueCount);
+
+	// RGBA only. The 8-bit sRGB variant premultiplies in linear space and re-encodes.
+	void PremultiplyAlpha(float* pixels, size_t pixelCount);
+	void UnpremultiplyAlpha(float* pixels, size_t pixelCount);
+	void PremultiplyAlpha(uint8_t* pixels, size_t pixelCount, bool srgb);
+
+	// Vertex colors (i.e. VertexPC::vertexColor) authored in sRGB, converted in place.
+	void ConvertVertexColorsToLinear(DirectX::XMFLOAT3* colors, size_t count);
+}
@@ -8,13 +8,28 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include <wrl/client.h>
 
 namespace dxe
 {
+	class Dx12MeshLodLoader;
+	class MeshLodStreamer;
+
 	struct RenderData
 	{
+		// Meshes of the geometry buffer, drawn with one buffer binding. 'meshId' is drawn when empty.
+		std::vector<uint32_t> geometryIds;
+		// Progressive meshes of the streamer, drawn after 'geometryIds' with the LOD the streamer picks
+		// for this frame. Meshes without a resident LOD are skipped.
+		std::vector<uint32_t> streamingMeshIds;
+		const MeshLodStreamer* lodStreamer{ nullptr };
+		const Dx12MeshLodLoader* lodLoader{ nullptr };
+		// With a bindless root signature: the bindless index of each draw's resource, passed to it in
+		// the draw constants (0 when missing).
+		std::vector<uint32_t> resourceIndices;
+
 		uint32_t meshId{ 0 };
 		uint32_t rootSignatureId{ 0 };
 		uint32_t graphicsPSOId{ 0 };
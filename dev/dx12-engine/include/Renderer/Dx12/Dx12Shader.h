@@ -6,6 +6,7 @@
 
 #include <wrl/client.h>
 
+#include <cstdint>
 #include <filesystem>
 #include <string>
 #include <vector>
@@ -31,10 +32,21 @@ namespace dxe
 		static void CreateVertexShader(Dx12ShaderData& shader);
 		static void CreatePixelShader(Dx12ShaderData& shader);
 
+		// Compile from source that was already read into memory (e.g. by the Asset Loader).
+		// 'shader.shaderPath' is only used to name the source in error messages.
+		// Safe to call from worker threads.
+		static void CreateVertexShader(Dx12ShaderData& shader, const std::vector<uint8_t>& shaderSource);
+		static void CreatePixelShader(Dx12ShaderData& shader, const std::vector<uint8_t>& shaderSource);
+
 		static void DestroyShader(Dx12ShaderData& shader);
 
 	private:
 
+		static void CompileShaderSource(
+			Dx12ShaderData& shader,
+			const std::vector<uint8_t>& shaderSource,
+			const char* shaderTarget);
+
 		static std::vector<char> ReadShaderFile(const std::filesystem::path& shaderFilePath);
 
 		// TODO?
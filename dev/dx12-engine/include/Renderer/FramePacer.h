@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <array>
+#include <cstdint>
+
+namespace dxe
+{
+	// Frames in flight: the CPU records frame N while the GPU still works on up to 'frameLatency - 1'
+	// earlier frames. Each frame uses one of 'frameLatency' slots of per-frame resources (command
+	// allocators, transient memory) in turn, tagged with the fence value the GPU signals once the
+	// frame is done. The CPU only waits when it gets back to a slot whose frame hasn't completed.
+
+	constexpr uint32_t MIN_FRAME_LATENCY = 1;
+	constexpr uint32_t MAX_FRAME_LATENCY = 3;
+	constexpr uint32_t DEFAULT_FRAME_LATENCY = 2;
+
+	struct FramePacerStatistics
+	{
+		uint64_t frameCount{ 0 };
+		// Frames that had to wait for the GPU to free their slot.
+		uint64_t waitCount{ 0 };
+	};
+
+	class FramePacer
+	{
+	public:
+
+		// Throws when 'frameLatency' is outside of [MIN_FRAME_LATENCY, MAX_FRAME_LATENCY].
+		explicit FramePacer(uint32_t frameLatency = DEFAULT_FRAME_LATENCY);
+		~FramePacer() = default;
+
+		CLASS_NO_COPY(FramePacer);
+		CLASS_DEFAULT_MOVE(FramePacer);
+
+		// Starts the next frame in the slot of the frame 'frameLatency' frames back. Returns the fence
+		// value to wait for before the slot's resources can be reused, 0 when 'completedFenceValue'
+		// shows that its frame is done already.
+		uint64_t BeginFrame(uint64_t completedFenceValue);
+		// The GPU signals 'fenceValue' once the work of the frame is done. Values must not decrease.
+		void EndFrame(uint64_t fenceValue);
+
+		uint32_t GetFrameLatency() const;
+		// Slot of the current frame.
+		uint32_t GetFrameSlot() const;
+		// Frames begun so far.
+		uint64_t GetFrameCount() const;
+
+		// Covers every frame ended so far: wait for it before destroying what the frames use.
+		uint64_t GetLastFenceValue() const;
+
+		FramePacerStatistics GetStatistics() const;
+
+	private:
+
+		uint32_t frameLatency{ DEFAULT_FRAME_LATENCY };
+		uint32_t frameSlot{ 0 };
+		bool frameOpen{ false };
+
+		// 0 for slots that haven't been used yet.
+		std::array<uint64_t, MAX_FRAME_LATENCY> slotFenceValues{};
+		uint64_t lastFenceValue{ 0 };
+
+		FramePacerStatistics statistics{};
+	};
+}
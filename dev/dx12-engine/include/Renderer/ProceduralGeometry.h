@@ -0,0 +1,142 @@
+#pragma once
+
+#include "Renderer/Vertex.h"
+
+#include <DirectXMath.h>
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	// Procedural shapes written straight into any vertex layout. Attributes are found through their
+	// VertexAttribType and written at their descriptor's offset; types a shape doesn't know stay zero.
+	// Integer formats get the values cast, like everywhere else in the engine.
+	// Shapes are centered on the origin, Y up, with outward normals and counter-clockwise front faces.
+	// Indices come out in vertex cache friendly order, and the output doesn't depend on the thread count.
+
+	struct ProceduralVertexFormat
+	{
+		std::vector<VertexAttribDescriptor> vertexAttribLayout;
+		uint32_t vertexStride{ 0 };
+
+		// Written to COLOR attributes, the shapes have no colors of their own.
+		DirectX::XMFLOAT3 color{ 1.0f, 1.0f, 1.0f };
+	};
+
+	template <typename VertexType>
+	ProceduralVertexFormat GetProceduralVertexFormat(const DirectX::XMFLOAT3& color = { 1.0f, 1.0f, 1.0f })
+	{
+		return ProceduralVertexFormat{ VertexType::attributes, VertexType::stride, color };
+	}
+
+	struct ProceduralMesh
+	{
+		VertexBufferInfo vertexBufferInfo{};
+		std::vector<uint8_t> vertexData;
+
+		// Triangle list.
+		std::vector<uint32_t> indices;
+
+		// For Dx12Mesh::CreateMesh, which takes typed vertices.
+		template <typename VertexType>
+		std::vector<VertexType> GetVertices() const
+		{
+			assert(vertexBufferInfo.vertexStride == sizeof(VertexType) && "Vertex type doesn't match the generated layout!");
+
+			std::vector<VertexType> vertices(vertexBufferInfo.vertexCount);
+			std::memcpy(vertices.data(), vertexData.data(), vertexData.size());
+			return vertices;
+		}
+	};
+
+	// XZ plane facing +Y, UV (0, 0) at the -X -Z corner. One segment each way is a plain quad.
+	struct GridSettings
+	{
+		float width{ 1.0f };
+		float depth{ 1.0f };
+
+		uint32_t widthSegments{ 1 };
+		uint32_t depthSegments{ 1 };
+	};
+
+	// Every face has its own vertices (hard edges) and the full UV range.
+	struct BoxSettings
+	{
+		DirectX::XMFLOAT3 size{ 1.0f, 1.0f, 1.0f };
+		uint32_t segments{ 1 };
+	};
+
+	struct UvSphereSettings
+	{
+		float radius{ 0.5f };
+
+		uint32_t segments{ 32 };
+		uint32_t rings{ 16 };
+	};
+
+	// Evenly spread triangles, 20 * 4^subdivisions of them. The UV seam and the poles get
+	// split vertices so textures wrap cleanly.
+	struct IcosphereSettings
+	{
+		float radius{ 0.5f };
+		uint32_t subdivisions{ 3 };
+	};
+
+	struct CylinderSettings
+	{
+		float radius{ 0.5f };
+		float height{ 1.0f };
+
+		uint32_t segments{ 32 };
+		uint32_t heightSegments{ 1 };
+
+		bool caps{ true };
+		uint32_t capRings{ 1 };
+	};
+
+	// 'height' is the cylindrical part only, the capsule is 'height' + 2 * 'radius' tall.
+	struct CapsuleSettings
+	{
+		float radius{ 0.5f };
+		float height{ 1.0f };
+
+		uint32_t segments{ 32 };
+		uint32_t hemisphereRings{ 8 };
+		uint32_t heightSegments{ 1 };
+	};
+
+	// Lies in the XZ plane.
+	struct TorusSettings
+	{
+		float majorRadius{ 0.5f };
+		float minorRadius{ 0.2f };
+
+		uint32_t majorSegments{ 48 };
+		uint32_t minorSegments{ 24 };
+	};
+
+	// Large shapes generate their vertices and indices in parallel chunks when a thread pool is given.
+	ProceduralMesh GenerateGrid(
+		const ProceduralVertexFormat& vertexFormat, const GridSettings& settings, ThreadPool* threadPool = nullptr);
+	ProceduralMesh GenerateBox(
+		const ProceduralVertexFormat& vertexFormat, const BoxSettings& settings, ThreadPool* threadPool = nullptr);
+	ProceduralMesh GenerateUvSphere(
+		const ProceduralVertexFormat& vertexFormat, const UvSphereSettings& settings, ThreadPool* threadPool = nullptr);
+	ProceduralMesh GenerateIcosphere(
+		const ProceduralVertexFormat& vertexFormat, const IcosphereSettings& settings, ThreadPool* threadPool = nullptr);
+	ProceduralMesh GenerateCylinder(
+		const ProceduralVertexFormat& vertexFormat, const CylinderSettings& settings, ThreadPool* threadPool = nullptr);
+	ProceduralMesh GenerateCapsule(
+		const ProceduralVertexFormat& vertexFormat, const CapsuleSettings& settings, ThreadPool* threadPool = nullptr);
+	ProceduralMesh GenerateTorus(
+		const ProceduralVertexFormat& vertexFormat, const TorusSettings& settings, ThreadPool* threadPool = nullptr);
+
+	// Reorders the triangles for the post-transform vertex cache (Forsyth's linear-speed
+	// optimizer), for meshes that don't come out of the generators above in a good order.
+	void OptimizeVertexCacheOrder(std::vector<uint32_t>& indices, uint32_t vertexCount);
+}
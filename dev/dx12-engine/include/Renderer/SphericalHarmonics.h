@@ -0,0 +1,115 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+	struct FloatCubemap;
+
+	// Real spherical harmonics for light probes, in the usual order (Y00, Y1-1, Y10, Y11, Y2-2, ... Y22)
+	// with Y1-1, Y10, Y11 along y, z and x. Every coefficient is RGBA and the math treats all four
+	// channels the same, so alpha can carry a fourth quantity (i.e. sky visibility).
+	// Projection, rotation and evaluation are all "basis value times RGBA" multiply-adds, one SSE
+	// register per coefficient.
+
+	constexpr uint32_t SH_L1_COEFFICIENT_COUNT = 4;
+	constexpr uint32_t SH_L2_COEFFICIENT_COUNT = 9;
+
+	template <uint32_t CoefficientCount>
+	struct SphericalHarmonics
+	{
+		std::array<DirectX::XMFLOAT4, CoefficientCount> coefficients{};
+	};
+
+	using ShL1 = SphericalHarmonics<SH_L1_COEFFICIENT_COUNT>;
+	using ShL2 = SphericalHarmonics<SH_L2_COEFFICIENT_COUNT>;
+
+	// Basis functions at a unit direction.
+	void EvaluateShBasis(const DirectX::XMFLOAT3& direction, std::array<float, SH_L1_COEFFICIENT_COUNT>& basis);
+	void EvaluateShBasis(const DirectX::XMFLOAT3& direction, std::array<float, SH_L2_COEFFICIENT_COUNT>& basis);
+
+	// Arithmetic
+
+	ShL1 ConvertShL2ToL1(const ShL2& sh);
+
+	void AddSh(ShL1& sh, const ShL1& other, float scale = 1.0f);
+	void AddSh(ShL2& sh, const ShL2& other, float scale = 1.0f);
+	void ScaleSh(ShL1& sh, float scale);
+	void ScaleSh(ShL2& sh, float scale);
+
+	// Adds a light from a single (unit) direction, i.e. a directional light or a sun.
+	void AddShDirectionalLight(ShL1& sh, const DirectX::XMFLOAT3& direction, const DirectX::XMFLOAT4& color);
+	void AddShDirectionalLight(ShL2& sh, const DirectX::XMFLOAT3& direction, const DirectX::XMFLOAT4& color);
+
+	// Turns radiance into the radiance a white Lambertian surface reflects (cosine convolution
+	// divided by pi), the same thing 'ConvolveIrradiance' bakes. Evaluate the result at the normal.
+	void ConvolveShIrradiance(ShL1& sh);
+	void ConvolveShIrradiance(ShL2& sh);
+
+	// Weighted sums of 'cornerCount' probes each, i.e. 8 corners of a probe grid cell for every
+	// instance. 'probeIndices' and 'weights' hold 'cornerCount' entries per result.
+	void BlendSh(const ShL2* probes, const uint32_t* probeIndices, const float* weights, uint32_t cornerCount,
+		ShL2* results, size_t count, ThreadPool* threadPool = nullptr);
+
+	// Evaluation
+
+	DirectX::XMFLOAT4 EvaluateSh(const ShL1& sh, const DirectX::XMFLOAT3& direction);
+	DirectX::XMFLOAT4 EvaluateSh(const ShL2& sh, const DirectX::XMFLOAT3& direction);
+
+	// results[i] = EvaluateSh(probes[probeIndices[i]], directions[i]), or probes[i] without indices.
+	// Basis values are computed four directions at a time.
+	void EvaluateSh(const ShL1* probes, const uint32_t* probeIndices, const DirectX::XMFLOAT3* directions,
+		DirectX::XMFLOAT4* results, size_t count, ThreadPool* threadPool = nullptr);
+	void EvaluateSh(const ShL2* probes, const uint32_t* probeIndices, const DirectX::XMFLOAT3* directions,
+		DirectX::XMFLOAT4* results, size_t count, ThreadPool* threadPool = nullptr);
+
+	// Rotation
+
+	// Rotates the function, so that the result seen along 'direction * rotation' is what the source
+	// showed along 'direction'. Built once per rotation, applied to any number of probes.
+	struct ShRotation
+	{
+		float band1[3][3]{};
+		float band2[5][5]{};
+	};
+
+	// From the upper 3x3 of a row-vector matrix (i.e. XMMatrixRotationRollPitchYaw), orthonormal.
+	ShRotation CreateShRotation(const DirectX::XMFLOAT4X4& rotation);
+
+	void RotateSh(const ShRotation& rotation, const ShL1* sources, ShL1* destinations, size_t count);
+	void RotateSh(const ShRotation& rotation, const ShL2* sources, ShL2* destinations, size_t count);
+
+	// Projection
+
+	// Projects cube maps of one face size. The basis values and texel solid angles are computed
+	// once here, so projecting a probe is one pass of 9 multiply-adds per texel.
+	class ShCubemapProjector
+	{
+	public:
+
+		explicit ShCubemapProjector(uint32_t faceSize);
+
+		// Uses the mip of 'cubemap' whose size matches the projector's.
+		ShL2 Project(const FloatCubemap& cubemap) const;
+		// One job per cube map.
+		void Project(const FloatCubemap* const* cubemaps, ShL2* results, size_t count, ThreadPool* threadPool = nullptr) const;
+
+		uint32_t GetFaceSize() const;
+
+	private:
+
+		uint32_t FindMatchingMip(const FloatCubemap& cubemap) const;
+		void ProjectFace(const float* surface, uint32_t face, ShL2& result) const;
+
+		uint32_t faceSize{ 0 };
+
+		// SH_L2_COEFFICIENT_COUNT values per texel, basis times solid angle.
+		std::vector<float> weights;
+	};
+}
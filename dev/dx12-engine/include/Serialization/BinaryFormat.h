@@ -0,0 +1,243 @@
+#pragma once
+
+#include "Core/Error.h"
+#include "Core/MappedFile.h"
+#include "Core/Utility.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace dxe
+{
+	// Flat binary files that are used in place, straight from a mapped file or a buffer.
+	//
+	// A file is a header followed by plain structs. Variable sized data lives in 'BinaryArray'
+	// and 'BinaryString' fields, which store an offset relative to the field itself, so nothing
+	// has to be fixed up after loading. 'OpenBinary' checks the header and every offset once;
+	// after that, reading is pointer arithmetic.
+	//
+	// Every root type declares SCHEMA_ID, SCHEMA_VERSION and MIN_SCHEMA_VERSION. Files outside
+	// [MIN_SCHEMA_VERSION, SCHEMA_VERSION] are rejected. New fields may only be appended to
+	// structs, and readers check 'GetSchemaVersion' before touching them. Data is little-endian.
+
+	constexpr uint32_t MakeBinarySchemaId(char c0, char c1, char c2, char c3)
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(c0)) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(c1)) << 8) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(c2)) << 16) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(c3)) << 24);
+	}
+
+	constexpr uint32_t BINARY_FILE_MAGIC = MakeBinarySchemaId('D', 'X', 'E', 'B');
+
+	struct BinaryFileHeader
+	{
+		uint32_t magic{ BINARY_FILE_MAGIC };
+		uint32_t schemaId{ 0 };
+		uint32_t schemaVersion{ 0 };
+		uint32_t headerSize{ sizeof(BinaryFileHeader) };
+
+		uint64_t fileSize{ 0 };
+
+		uint32_t rootOffset{ 0 };
+		uint32_t reserved{ 0 };
+	};
+
+	static_assert(sizeof(BinaryFileHeader) == 32, "The binary file header layout must not change!");
+
+	template <typename T>
+	struct BinaryArray
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Binary arrays only hold plain data!");
+
+		const T* Data() const
+		{
+			return reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(this) + offset);
+		}
+		uint32_t Size() const { return count; }
+		bool Empty() const { return count == 0; }
+
+		const T& operator[](uint32_t index) const { return Data()[index]; }
+
+		const T* begin() const { return Data(); }
+		const T* end() const { return Data() + count; }
+
+		// From this field to the first element, in bytes.
+		uint32_t offset{ 0 };
+		uint32_t count{ 0 };
+	};
+
+	// Stored with a null terminator, which 'length' doesn't count.
+	struct BinaryString
+	{
+		const char* CStr() const
+		{
+			return reinterpret_cast<const char*>(this) + offset;
+		}
+		std::string_view View() const
+		{
+			return std::string_view(CStr(), length);
+		}
+
+		uint32_t offset{ 0 };
+		uint32_t length{ 0 };
+	};
+
+	// Validation
+
+	class BinaryValidator
+	{
+	public:
+
+		BinaryValidator(const uint8_t* data, size_t size, uint32_t schemaVersion)
+			: data(data), size(size), schemaVersion(schemaVersion) {}
+
+		uint32_t GetSchemaVersion() const { return schemaVersion; }
+
+		template <typename T>
+		bool Check(const BinaryArray<T>& array) const
+		{
+			if (array.count == 0)
+				return true;
+			return CheckRange(array.Data(), static_cast<uint64_t>(array.count) * sizeof(T), alignof(T));
+		}
+
+		bool Check(const BinaryString& string) const
+		{
+			return CheckRange(string.CStr(), static_cast<uint64_t>(string.length) + 1, 1) &&
+				string.CStr()[string.length] == '\0';
+		}
+
+	private:
+
+		bool CheckRange(const void* address, uint64_t byteCount, size_t alignment) const
+		{
+			uintptr_t begin = reinterpret_cast<uintptr_t>(address);
+			uintptr_t dataBegin = reinterpret_cast<uintptr_t>(data);
+
+			return begin >= dataBegin && begin - dataBegin <= size && byteCount <= size - (begin - dataBegin) &&
+				begin % alignment == 0;
+		}
+
+		const uint8_t* data{ nullptr };
+		size_t size{ 0 };
+		uint32_t schemaVersion{ 0 };
+	};
+
+	// Checks magic, schema, version and that the root struct is in bounds and aligned.
+	// Returns the file's schema version, throws if any of it doesn't hold.
+	uint32_t ValidateBinaryHeader(
+		const uint8_t* data, size_t size,
+		uint32_t schemaId, uint32_t minSchemaVersion, uint32_t schemaVersion,
+		size_t rootSize, size_t rootAlignment);
+
+	// Root types provide 'bool ValidateBinary(const BinaryValidator&, const Root&)', which
+	// checks every array and string they (transitively) own, plus whatever indices they hold.
+	template <typename Root>
+	const Root* OpenBinary(const uint8_t* data, size_t size)
+	{
+		uint32_t version = ValidateBinaryHeader(data, size,
+			Root::SCHEMA_ID, Root::MIN_SCHEMA_VERSION, Root::SCHEMA_VERSION, sizeof(Root), alignof(Root));
+
+		const BinaryFileHeader* header = reinterpret_cast<const BinaryFileHeader*>(data);
+		const Root* root = reinterpret_cast<const Root*>(data + header->rootOffset);
+
+		if (!ValidateBinary(BinaryValidator{ data, size, version }, *root))
+			throw Error{ "Binary file contents are corrupted!" };
+
+		return root;
+	}
+
+	uint32_t GetBinarySchemaVersion(const uint8_t* data);
+
+	// Keeps the file mapped for as long as the root is used.
+	template <typename Root>
+	class MappedBinaryFile
+	{
+	public:
+
+		MappedBinaryFile() = default;
+
+		CLASS_NO_COPY(MappedBinaryFile);
+		CLASS_DEFAULT_MOVE(MappedBinaryFile);
+
+		void Open(const std::filesystem::path& filePath)
+		{
+			MappedFile mappedFile{};
+			mappedFile.Open(filePath);
+
+			root = OpenBinary<Root>(mappedFile.GetData(), mappedFile.GetSize());
+			file = std::move(mappedFile);
+		}
+
+		const Root& GetRoot() const { return *root; }
+		uint32_t GetSchemaVersion() const { return GetBinarySchemaVersion(file.GetData()); }
+
+	private:
+
+		MappedFile file;
+		const Root* root{ nullptr };
+	};
+
+	// Writing
+
+	// Builds a file in memory. Everything is addressed by byte positions, since references
+	// into the buffer don't survive the next append.
+	//
+	//     BinaryWriter writer{ Root::SCHEMA_ID, Root::SCHEMA_VERSION };
+	//     uint32_t root = writer.Append<Root>();
+	//     writer.WriteArray(root + offsetof(Root, values), values.data(), count);
+	//     std::vector<uint8_t> file = writer.Finish(root);
+
+	class BinaryWriter
+	{
+	public:
+
+		BinaryWriter(uint32_t schemaId, uint32_t schemaVersion, size_t capacity = 0);
+
+		// Zero-initialized room for 'count' objects, returns the position of the first one.
+		template <typename T>
+		uint32_t Append(uint32_t count = 1, size_t alignment = alignof(T))
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Binary files only hold plain data!");
+			return AppendBytes(static_cast<uint64_t>(count) * sizeof(T), alignment);
+		}
+
+		// Only valid until the next append.
+		template <typename T>
+		T& Get(uint32_t position)
+		{
+			return *reinterpret_cast<T*>(buffer.data() + position);
+		}
+
+		// Appends the elements and points the array field at 'arrayPosition' to them.
+		// With 'elements' null the room is left zeroed, to be filled through 'Get'.
+		template <typename T>
+		uint32_t WriteArray(uint32_t arrayPosition, const T* elements, uint32_t count, size_t alignment = alignof(T))
+		{
+			uint32_t position = Append<T>(count, alignment);
+			if (elements && count > 0)
+				std::memcpy(buffer.data() + position, elements, static_cast<size_t>(count) * sizeof(T));
+
+			LinkArray(arrayPosition, position, count);
+			return position;
+		}
+
+		void WriteString(uint32_t stringPosition, std::string_view string);
+
+		std::vector<uint8_t> Finish(uint32_t rootPosition);
+
+	private:
+
+		uint32_t AppendBytes(uint64_t byteCount, size_t alignment);
+		void LinkArray(uint32_t arrayPosition, uint32_t dataPosition, uint32_t count);
+
+		std::vector<uint8_t> buffer;
+	};
+}
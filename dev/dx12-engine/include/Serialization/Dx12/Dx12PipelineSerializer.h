@@ -0,0 +1,31 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12PSO.h"
+#include "Serialization/PipelineSerializer.h"
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dxe
+{
+	struct Dx12GraphicsPipelineEntry
+	{
+		std::string name;
+		const Dx12GraphicsPSO* pso{ nullptr };
+	};
+
+	void WriteDx12GraphicsPipelineState(
+		BinaryWriter& writer, uint32_t position, const std::string& name, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc);
+
+	std::vector<uint8_t> SerializeDx12PipelineLibrary(const std::vector<Dx12GraphicsPipelineEntry>& pipelines);
+
+	// Builds a desc that is ready for CreateGraphicsPipelineState. Shader bytecode and semantic
+	// names point into the serialized data and the input layout into 'inputElements', so both
+	// have to outlive the call. Nothing else is copied.
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC CreateDx12GraphicsPipelineStateDesc(
+		const SerializedGraphicsPipelineState& pipelineState, ID3D12RootSignature* rootSignature,
+		std::vector<D3D12_INPUT_ELEMENT_DESC>& inputElements);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Serialization/BinaryFormat.h"
+
+#include <cstdint>
+
+namespace dxe
+{
+	// Graphics pipeline state as stored on disk. Mirrors D3D12_GRAPHICS_PIPELINE_STATE_DESC
+	// field for field, with enums and BOOLs widened to uint32_t so the layout doesn't depend
+	// on the API headers. The root signature isn't part of it, it's bound when the PSO is created.
+
+	constexpr uint32_t SERIALIZED_RENDER_TARGET_COUNT = 8;
+
+	struct SerializedInputElement
+	{
+		BinaryString semanticName;
+		uint32_t semanticIndex{ 0 };
+		uint32_t format{ 0 };
+		uint32_t inputSlot{ 0 };
+		uint32_t alignedByteOffset{ 0 };
+		uint32_t inputSlotClass{ 0 };
+		uint32_t instanceDataStepRate{ 0 };
+	};
+
+	struct SerializedRenderTargetBlendState
+	{
+		uint32_t blendEnable{ 0 };
+		uint32_t logicOpEnable{ 0 };
+		uint32_t srcBlend{ 0 };
+		uint32_t destBlend{ 0 };
+		uint32_t blendOp{ 0 };
+		uint32_t srcBlendAlpha{ 0 };
+		uint32_t destBlendAlpha{ 0 };
+		uint32_t blendOpAlpha{ 0 };
+		uint32_t logicOp{ 0 };
+		uint32_t renderTargetWriteMask{ 0 };
+	};
+
+	struct SerializedBlendState
+	{
+		uint32_t alphaToCoverageEnable{ 0 };
+		uint32_t independentBlendEnable{ 0 };
+		SerializedRenderTargetBlendState renderTargets[SERIALIZED_RENDER_TARGET_COUNT]{};
+	};
+
+	struct SerializedRasterizerState
+	{
+		uint32_t fillMode{ 0 };
+		uint32_t cullMode{ 0 };
+		uint32_t frontCounterClockwise{ 0 };
+		int32_t depthBias{ 0 };
+		float depthBiasClamp{ 0.0f };
+		float slopeScaledDepthBias{ 0.0f };
+		uint32_t depthClipEnable{ 0 };
+		uint32_t multisampleEnable{ 0 };
+		uint32_t antialiasedLineEnable{ 0 };
+		uint32_t forcedSampleCount{ 0 };
+		uint32_t conservativeRaster{ 0 };
+	};
+
+	struct SerializedStencilOpState
+	{
+		uint32_t stencilFailOp{ 0 };
+		uint32_t stencilDepthFailOp{ 0 };
+		uint32_t stencilPassOp{ 0 };
+		uint32_t stencilFunc{ 0 };
+	};
+
+	struct SerializedDepthStencilState
+	{
+		uint32_t depthEnable{ 0 };
+		uint32_t depthWriteMask{ 0 };
+		uint32_t depthFunc{ 0 };
+		uint32_t stencilEnable{ 0 };
+		uint32_t stencilReadMask{ 0 };
+		uint32_t stencilWriteMask{ 0 };
+		SerializedStencilOpState frontFace{};
+		SerializedStencilOpState backFace{};
+	};
+
+	struct SerializedGraphicsPipelineState
+	{
+		BinaryString name;
+
+		// Compiled shader bytecode, 16-byte aligned.
+		BinaryArray<uint8_t> vertexShader;
+		BinaryArray<uint8_t> pixelShader;
+
+		BinaryArray<SerializedInputElement> inputLayout;
+
+		SerializedBlendState blendState{};
+		uint32_t sampleMask{ 0 };
+		SerializedRasterizerState rasterizerState{};
+		SerializedDepthStencilState depthStencilState{};
+
+		uint32_t primitiveTopologyType{ 0 };
+
+		uint32_t renderTargetCount{ 0 };
+		uint32_t renderTargetFormats[SERIALIZED_RENDER_TARGET_COUNT]{};
+		uint32_t depthStencilFormat{ 0 };
+
+		uint32_t sampleCount{ 0 };
+		uint32_t sampleQuality{ 0 };
+	};
+
+	struct SerializedPipelineLibrary
+	{
+		static constexpr uint32_t SCHEMA_ID = MakeBinarySchemaId('P', 'S', 'O', 'L');
+		static constexpr uint32_t SCHEMA_VERSION = 1;
+		static constexpr uint32_t MIN_SCHEMA_VERSION = 1;
+
+		BinaryArray<SerializedGraphicsPipelineState> graphicsPipelines;
+	};
+
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedGraphicsPipelineState& pipelineState);
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedPipelineLibrary& pipelineLibrary);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Renderer/Vertex.h"
+#include "Serialization/BinaryFormat.h"
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace dxe
+{
+	constexpr uint32_t SCENE_NODE_NO_PARENT = UINT32_MAX;
+	constexpr uint32_t SCENE_NODE_NO_PIPELINE = UINT32_MAX;
+
+	// In-memory scene, what gets written.
+
+	struct SceneMesh
+	{
+		std::string name;
+
+		VertexBufferInfo vertexBufferInfo{};
+		IndexBufferInfo indexBufferInfo{};
+
+		std::vector<uint8_t> vertexData;
+		std::vector<uint8_t> indexData;
+	};
+
+	struct SceneNode
+	{
+		DirectX::XMFLOAT4X4 transform{};
+
+		uint32_t meshIndex{ 0 };
+		// Index into the pipeline library the scene is rendered with.
+		uint32_t pipelineIndex{ SCENE_NODE_NO_PIPELINE };
+		// Parents come before their children.
+		uint32_t parentIndex{ SCENE_NODE_NO_PARENT };
+	};
+
+	struct Scene
+	{
+		std::vector<SceneMesh> meshes;
+		std::vector<SceneNode> nodes;
+	};
+
+	// On-disk layout, read in place.
+
+	struct SerializedVertexAttrib
+	{
+		uint32_t dimension{ 0 };
+		uint32_t offset{ 0 };
+		uint32_t type{ 0 };
+		uint32_t format{ 0 };
+	};
+
+	struct SerializedVertexBufferInfo
+	{
+		BinaryArray<SerializedVertexAttrib> vertexAttribLayout;
+
+		uint32_t vertexCount{ 0 };
+		uint32_t vertexStride{ 0 };
+	};
+
+	struct SerializedIndexBufferInfo
+	{
+		uint32_t indexCount{ 0 };
+		uint32_t indexFormat{ 0 };
+	};
+
+	struct SerializedMesh
+	{
+		BinaryString name;
+
+		SerializedVertexBufferInfo vertexBufferInfo{};
+		SerializedIndexBufferInfo indexBufferInfo{};
+
+		// 16-byte aligned, ready to be copied into an upload buffer as is.
+		BinaryArray<uint8_t> vertexData;
+		BinaryArray<uint8_t> indexData;
+	};
+
+	struct SerializedSceneNode
+	{
+		DirectX::XMFLOAT4X4 transform{};
+
+		uint32_t meshIndex{ 0 };
+		uint32_t pipelineIndex{ SCENE_NODE_NO_PIPELINE };
+		uint32_t parentIndex{ SCENE_NODE_NO_PARENT };
+		uint32_t reserved{ 0 };
+	};
+
+	struct SerializedScene
+	{
+		static constexpr uint32_t SCHEMA_ID = MakeBinarySchemaId('S', 'C', 'N', 'E');
+		static constexpr uint32_t SCHEMA_VERSION = 1;
+		static constexpr uint32_t MIN_SCHEMA_VERSION = 1;
+
+		BinaryArray<SerializedMesh> meshes;
+		BinaryArray<SerializedSceneNode> nodes;
+	};
+
+	// Embeddable pieces, for other schemas that carry buffer descriptions.
+	void WriteVertexBufferInfo(BinaryWriter& writer, uint32_t position, const VertexBufferInfo& vertexBufferInfo);
+	void WriteIndexBufferInfo(BinaryWriter& writer, uint32_t position, const IndexBufferInfo& indexBufferInfo);
+
+	VertexBufferInfo ToVertexBufferInfo(const SerializedVertexBufferInfo& serializedVertexBufferInfo);
+	IndexBufferInfo ToIndexBufferInfo(const SerializedIndexBufferInfo& serializedIndexBufferInfo);
+
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedVertexBufferInfo& vertexBufferInfo);
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedIndexBufferInfo& indexBufferInfo);
+	// Besides offsets, checks that buffer sizes match the buffer infos and that node indices are in range.
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedScene& scene);
+
+	std::vector<uint8_t> SerializeScene(const Scene& scene);
+}
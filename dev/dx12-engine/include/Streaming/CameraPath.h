@@ -0,0 +1,35 @@
+#pragma once
+
+#include <DirectXMath.h>
+
+#include <vector>
+
+namespace dxe
+{
+	// A polyline the camera follows at constant speed.
+	// Used to drive the streaming systems without a window or a GPU.
+
+	class CameraPath
+	{
+	public:
+
+		CameraPath() = default;
+		CameraPath(const std::vector<DirectX::XMFLOAT3>& waypoints, float speed);
+
+		void AddWaypoint(const DirectX::XMFLOAT3& waypoint);
+		void SetSpeed(float speed);
+
+		// Positions past the end of the path clamp to the last waypoint.
+		DirectX::XMFLOAT3 Sample(float time) const;
+
+		float GetLength() const;
+		float GetDuration() const;
+
+	private:
+
+		std::vector<DirectX::XMFLOAT3> waypoints;
+		std::vector<float> cumulativeLengths;
+
+		float speed{ 1.0f };
+	};
+}
\ No newline at end of file
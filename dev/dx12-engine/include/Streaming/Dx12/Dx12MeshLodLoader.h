@@ -0,0 +1,93 @@
+#pragma once
+
+#include "GpuApi/Dx12/Dx12GeometryBuffer.h"
+
+#include "Core/ThreadPool.h"
+#include "Core/Utility.h"
+#include "Streaming/MeshLodStreamer.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace dxe
+{
+	// What a LOD appends to its mesh.
+	struct Dx12MeshLodData
+	{
+		// 'vertexStride' bytes per vertex.
+		std::vector<uint8_t> vertices;
+		// Relative to the mesh's first vertex, so they can refer to the vertices of coarser LODs.
+		std::vector<uint32_t> indices;
+	};
+
+	// Fetches the data of a LOD (i.e. reads and decodes it), called on a worker thread. Returns false
+	// when that failed.
+	using Dx12MeshLodSource = std::function<bool(uint32_t lodIndex, Dx12MeshLodData& lodData)>;
+
+	// LOD loader of a MeshLodStreamer that streams progressive meshes into the geometry buffer: each
+	// mesh is one geometry whose ranges grow by the LOD's vertices and indices on Upload and are
+	// truncated on Evict, the freed tails being reused once the GPU is done with them. A LOD is drawn
+	// with the mesh's range cut down to the indices of the LODs up to it, see GetLodRange.
+
+	class Dx12MeshLodLoader : public MeshLodLoader
+	{
+	public:
+
+		using MeshId = StreamingMesh::MeshId;
+
+		// Both have to outlive the loader, the pool's workers must not run its loads anymore when
+		// it's destroyed.
+		Dx12MeshLodLoader(Dx12GeometryBuffer* geometryBuffer, ThreadPool* threadPool);
+		~Dx12MeshLodLoader() = default;
+
+		CLASS_NO_COPY(Dx12MeshLodLoader);
+		CLASS_NO_MOVE(Dx12MeshLodLoader);
+
+		// The streamer loads are reported to, created with this loader.
+		void SetStreamer(MeshLodStreamer* streamer);
+
+		// Call with the ID MeshLodStreamer::AddMesh returned, before its next Update.
+		void AddMesh(MeshId meshId, uint32_t vertexStride, Dx12MeshLodSource source);
+
+		// MeshLodLoader
+		void BeginLoad(const StreamingMesh& mesh, uint32_t lodIndex) override;
+		void Upload(const StreamingMesh& mesh, uint32_t lodIndex) override;
+		void Evict(const StreamingMesh& mesh, uint32_t lodIndex) override;
+
+		// The geometry range to draw a resident LOD (i.e. MeshLodStreamer::GetDrawLod) with.
+		Dx12GeometryRange GetLodRange(MeshId meshId, uint32_t lodIndex) const;
+		// DX12_INVALID_GEOMETRY_ID until LOD 0 is uploaded.
+		uint32_t GetGeometryId(MeshId meshId) const;
+
+	private:
+
+		struct LodMesh
+		{
+			uint32_t vertexStride{ 0 };
+			Dx12MeshLodSource source;
+
+			uint32_t geometryId{ DX12_INVALID_GEOMETRY_ID };
+			// Vertex and index counts of the LODs up to each resident one.
+			std::vector<uint64_t> lodVertexCounts;
+			std::vector<uint64_t> lodIndexCounts;
+
+			// Fetched, not uploaded yet. Only one LOD of a mesh is in flight.
+			std::unique_ptr<Dx12MeshLodData> loadedLod;
+		};
+
+		LodMesh& GetLodMesh(MeshId meshId);
+		const LodMesh& GetLodMesh(MeshId meshId) const;
+
+		Dx12GeometryBuffer* geometryBuffer{ nullptr };
+		ThreadPool* threadPool{ nullptr };
+		MeshLodStreamer* streamer{ nullptr };
+
+		// Only touched by the main thread, workers get a mesh's pointer and hand their data over
+		// through its 'loadedLod' under the mutex.
+		std::vector<std::unique_ptr<LodMesh>> meshes;
+		std::mutex meshesMutex;
+	};
+}
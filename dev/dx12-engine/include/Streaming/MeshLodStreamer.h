@@ -0,0 +1,230 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace dxe
+{
+	// Progressive meshes: LOD 0 is the coarsest one and every finer LOD is appended to the data
+	// of the ones before it (more vertices, more indices). So the resident LODs of a mesh are
+	// always a prefix, and the mesh can be drawn as soon as LOD 0 is in.
+
+	struct StreamingMeshLod
+	{
+		uint64_t gpuBytes{ 0 };
+
+		// Largest object space deviation from the full detail mesh, in world units.
+		float geometricError{ 0.0f };
+	};
+
+	enum class StreamingLodState
+	{
+		UNLOADED,
+		// Bytes are being fetched by the LOD loader.
+		LOADING,
+		// Fetched, waiting for its share of the per-frame upload budget.
+		LOADED,
+	};
+
+	struct StreamingMesh
+	{
+		using MeshId = uint32_t;
+
+		MeshId id{ 0 };
+
+		DirectX::XMFLOAT3 boundsCenter{};
+		float boundsRadius{ 0.0f };
+
+		// Coarsest first, geometric errors decreasing.
+		std::vector<StreamingMeshLod> lods;
+
+		// LODs [0, residentLodCount) are uploaded and can be drawn.
+		uint32_t residentLodCount{ 0 };
+
+		// State of LOD 'residentLodCount', the only one that can be in flight.
+		StreamingLodState pendingLodState{ StreamingLodState::UNLOADED };
+
+		// How many LODs the current view asks for.
+		uint32_t desiredLodCount{ 1 };
+
+		float cameraDistance{ 0.0f };
+		// Projected error of the finest resident LOD, in pixels. Infinite while nothing is resident.
+		float screenSpaceError{ 0.0f };
+	};
+
+	// Fetches, appends and drops the actual LOD data (i.e. Dx12MeshLodLoader, into the geometry buffer).
+
+	class MeshLodLoader
+	{
+	public:
+
+		virtual ~MeshLodLoader() = default;
+
+		// Starts fetching the LOD. May finish on any thread,
+		// but must report back through 'MeshLodStreamer::OnLodLoaded'.
+		virtual void BeginLoad(const StreamingMesh& mesh, uint32_t lodIndex) = 0;
+
+		// Appends the fetched LOD to the mesh's GPU data, called within the frame's upload budget.
+		virtual void Upload(const StreamingMesh& mesh, uint32_t lodIndex) = 0;
+
+		// Drops the finest resident LOD, the mesh draws 'lodIndex - 1' from now on.
+		virtual void Evict(const StreamingMesh& mesh, uint32_t lodIndex) = 0;
+	};
+
+	struct MeshLodStreamerSettings
+	{
+		float verticalFieldOfView{ DirectX::XM_PIDIV4 };
+		float viewportHeight{ 1080.0f };
+
+		// Finer LODs are requested until the projected error drops below this many pixels.
+		float maxScreenSpaceError{ 1.0f };
+
+		// Distances are clamped to this, so the camera inside a mesh's bounds doesn't divide by zero.
+		float nearDistance{ 0.1f };
+
+		// Covers resident LODs and the ones in flight. LOD 0 of every mesh is loaded
+		// even if that breaks the budget; finer LODs are evicted to get back under it.
+		uint64_t gpuBudgetBytes{ 256ull * 1024 * 1024 };
+
+		// GPU bytes uploaded per frame. At least one LOD is uploaded per frame regardless.
+		uint64_t uploadBudgetBytesPerFrame{ 8ull * 1024 * 1024 };
+
+		uint32_t maxLoadsInFlight{ 8 };
+
+		// Over budget, a finer LOD only displaces another mesh's LOD when its mesh's error is this
+		// many times the error the other mesh is left with. Keeps meshes with similar errors from
+		// trading LODs back and forth while the camera moves.
+		float evictionHysteresis{ 2.0f };
+	};
+
+	struct MeshLodStreamerFrameStats
+	{
+		uint32_t loadsIssued{ 0 };
+		uint32_t uploads{ 0 };
+		uint32_t evictions{ 0 };
+
+		uint64_t uploadedBytes{ 0 };
+		uint64_t evictedBytes{ 0 };
+
+		// Meshes without a resident LOD 0.
+		uint32_t undrawableMeshes{ 0 };
+		// Meshes drawn with more than 'maxScreenSpaceError' pixels of error.
+		uint32_t meshesAboveErrorThreshold{ 0 };
+		float maxScreenSpaceError{ 0.0f };
+
+		// Finer LODs the view asked for that didn't fit into the budget.
+		uint32_t budgetRejectedLods{ 0 };
+
+		bool gpuBudgetExceeded{ false };
+	};
+
+	struct MeshLodStreamerStats
+	{
+		uint64_t frameCount{ 0 };
+
+		// Frames with at least one mesh above the error threshold, and the sum over frames.
+		uint64_t errorFrameCount{ 0 };
+		uint64_t meshErrorFrames{ 0 };
+
+		uint64_t gpuBudgetOverrunFrames{ 0 };
+
+		uint64_t totalUploadedBytes{ 0 };
+		uint64_t totalEvictedBytes{ 0 };
+
+		uint64_t peakGpuBytes{ 0 };
+		uint64_t peakUploadBytesPerFrame{ 0 };
+	};
+
+	class MeshLodStreamer
+	{
+	public:
+
+		using MeshId = StreamingMesh::MeshId;
+
+		MeshLodStreamer(const MeshLodStreamerSettings& settings, MeshLodLoader* lodLoader);
+		~MeshLodStreamer() = default;
+
+		CLASS_NO_COPY(MeshLodStreamer);
+		CLASS_NO_MOVE(MeshLodStreamer);
+
+		// LOD 0 is requested on the next 'Update', ahead of every finer LOD.
+		MeshId AddMesh(
+			const DirectX::XMFLOAT3& boundsCenter, float boundsRadius, const std::vector<StreamingMeshLod>& lods);
+
+		// Call once per frame from the main thread.
+		void Update(const DirectX::XMFLOAT3& cameraPosition);
+
+		// Called by the loader from any of its threads once a 'BeginLoad' is done. The next
+		// 'Update' queues the LOD for upload, or releases its budget when the load failed.
+		void OnLodLoaded(MeshId meshId, uint32_t lodIndex, bool succeeded);
+
+		// Lower the budget when the OS reports memory pressure, the next 'Update' evicts down to it.
+		void SetGpuBudgetBytes(uint64_t gpuBudgetBytes);
+
+		// Finest LOD to draw this frame (never finer than the view needs),
+		// or UINT32_MAX while the mesh isn't drawable yet.
+		uint32_t GetDrawLod(MeshId meshId) const;
+
+		const StreamingMesh& GetMesh(MeshId meshId) const;
+		uint32_t GetMeshCount() const;
+
+		uint64_t GetGpuCommittedBytes() const;
+
+		const MeshLodStreamerFrameStats& GetFrameStats() const;
+		const MeshLodStreamerStats& GetStats() const;
+
+	private:
+
+		struct LodLoadCompletion
+		{
+			MeshId meshId{ 0 };
+			uint32_t lodIndex{ 0 };
+			bool succeeded{ false };
+		};
+
+		void ApplyLoadCompletions();
+
+		void UpdateScreenSpaceErrors(const DirectX::XMFLOAT3& cameraPosition);
+		float CalculateScreenSpaceError(const StreamingMesh& mesh, uint32_t lodCount) const;
+
+		void IssueLoads();
+		void UploadLoadedLods();
+		void UpdateStats();
+
+		// Evicts the least useful finest LODs, the ones whose meshes end up with the smallest
+		// error, until 'bytesToFree' are freed. A LOD is only evicted when dropping it leaves its
+		// mesh with less error than 'requesterError' (scaled down by the hysteresis). Unless
+		// 'allowPartial' is set, nothing is evicted when that can't free enough. Returns whether
+		// enough was freed.
+		bool EvictLods(uint64_t bytesToFree, float requesterError, MeshId requesterId, bool allowPartial);
+		void TrimToBudget();
+
+		void EvictFinestLod(StreamingMesh& mesh);
+
+		// Load and upload order: meshes without LOD 0 first (infinite error), then the largest error.
+		bool HasHigherPriority(const StreamingMesh& mesh1, const StreamingMesh& mesh2) const;
+
+		MeshLodStreamerSettings settings{};
+		MeshLodLoader* lodLoader{ nullptr };
+
+		// Pixels per world unit at distance 1.
+		float projectionScale{ 0.0f };
+
+		std::vector<StreamingMesh> meshes;
+
+		std::vector<LodLoadCompletion> loadCompletions;
+		std::mutex loadCompletionsMutex;
+
+		uint64_t gpuCommittedBytes{ 0 };
+
+		uint32_t loadsInFlight{ 0 };
+
+		MeshLodStreamerFrameStats frameStats{};
+		MeshLodStreamerStats stats{};
+	};
+}
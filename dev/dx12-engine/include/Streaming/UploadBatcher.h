@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <cstdint>
+
+namespace dxe
+{
+	// Staging and batching of buffer uploads, independent of the GPU API. Data is copied into staging
+	// memory right away and a copy into the destination is recorded; copies are submitted in batches
+	// so the GPU signals one fence value per batch instead of one per upload.
+
+	// Staging memory handed out by a backend.
+	struct UploadStaging
+	{
+		uint8_t* cpuAddress{ nullptr };
+		uint64_t offset{ 0 };
+	};
+
+	// Copy of 'size' bytes from 'stagingOffset' to 'destinationOffset' of 'destination', which is
+	// whatever the backend uses to identify a buffer (i.e. an ID3D12Resource).
+	struct UploadCopy
+	{
+		void* destination{ nullptr };
+		uint64_t destinationOffset{ 0 };
+		uint64_t stagingOffset{ 0 };
+		uint64_t size{ 0 };
+	};
+
+	class UploadBackend
+	{
+	public:
+
+		virtual ~UploadBackend() = default;
+
+		// May block until the GPU has freed enough staging memory.
+		virtual UploadStaging AllocateStaging(uint64_t size) = 0;
+		virtual void RecordCopy(const UploadCopy& copy) = 0;
+		// Submits the copies recorded since the last submit and returns the fence value that is
+		// signaled once they're done. Only called with copies recorded.
+		virtual uint64_t SubmitCopies() = 0;
+	};
+
+	struct UploadBatcherDesc
+	{
+		// A batch is submitted before it would grow past either limit. Has to be well below the
+		// backend's staging capacity (at most half of it), since a batch's staging memory is only
+		// reused once the batch is done.
+		uint64_t maxBatchSize{ 8ull * 1024 * 1024 };
+		uint32_t maxBatchCopies{ 256 };
+
+		// Larger uploads are split into copies of at most this size.
+		uint64_t maxCopySize{ 4ull * 1024 * 1024 };
+	};
+
+	struct UploadStatistics
+	{
+		uint64_t uploadCount{ 0 };
+		uint64_t uploadedBytes{ 0 };
+
+		uint64_t copyCount{ 0 };
+		// Uploads that extended the previous copy instead of recording one of their own.
+		uint64_t mergedCopyCount{ 0 };
+		uint64_t batchCount{ 0 };
+	};
+
+	class UploadBatcher
+	{
+	public:
+
+		explicit UploadBatcher(UploadBackend* backend, const UploadBatcherDesc& desc = UploadBatcherDesc{});
+
+		CLASS_NO_COPY(UploadBatcher);
+		CLASS_NO_MOVE(UploadBatcher);
+
+		// 'data' can be released as soon as this returns. The data is ready on the GPU once the value
+		// returned by a later Flush (or GetLastSubmittedValue after it) completes.
+		void Upload(void* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+
+		// Submits the open batch, if any, and returns the value covering every upload so far.
+		uint64_t Flush();
+
+		// 0 until the first batch is submitted.
+		uint64_t GetLastSubmittedValue() const;
+		bool HasOpenBatch() const;
+
+		UploadStatistics GetStatistics() const;
+
+	private:
+
+		UploadBackend* backend{ nullptr };
+		UploadBatcherDesc desc{};
+
+		// The open batch. The last copy stays pending so contiguous uploads can extend it.
+		uint64_t batchSize{ 0 };
+		uint32_t batchCopyCount{ 0 };
+		UploadCopy pendingCopy{};
+
+		uint64_t lastSubmittedValue{ 0 };
+
+		UploadStatistics statistics{};
+	};
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "Core/Utility.h"
+
+#include <DirectXMath.h>
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dxe
+{
+	// The world is a regular grid of square cells on the XZ plane.
+
+	struct StreamingCellCoord
+	{
+		int32_t x{ 0 };
+		int32_t z{ 0 };
+	};
+
+	inline bool operator==(const StreamingCellCoord& c1, const StreamingCellCoord& c2)
+	{
+		return c1.x == c2.x && c1.z == c2.z;
+	}
+	inline bool operator!=(const StreamingCellCoord& c1, const StreamingCellCoord& c2)
+	{
+		return !(c1 == c2);
+	}
+
+	enum class StreamingCellState
+	{
+		UNLOADED,
+		// CPU data is being produced by the cell loader.
+		LOADING,
+		// CPU data is ready, waiting for its share of the per-frame upload budget.
+		LOADED,
+		// Uploaded to the GPU and ready to render.
+		RESIDENT,
+	};
+
+	struct StreamingCell
+	{
+		using CellId = uint32_t;
+
+		CellId id{ 0 };
+		StreamingCellCoord coord{};
+
+		uint64_t cpuBytes{ 0 };
+		uint64_t gpuBytes{ 0 };
+
+		// Lower values are streamed in first.
+		uint32_t priority{ 0 };
+
+		StreamingCellState state{ StreamingCellState::UNLOADED };
+
+		// Unloads requested while the cell was still loading are applied on completion.
+		bool unloadRequested{ false };
+
+		float cameraDistance{ 0.0f };
+	};
+
+	// Produces and releases the actual cell contents.
+
+	class StreamingCellLoader
+	{
+	public:
+
+		virtual ~StreamingCellLoader() = default;
+
+		// Starts producing the CPU-side data of the cell. May finish on any thread,
+		// but must report back through 'WorldStreamer::OnCellLoaded'.
+		virtual void BeginLoad(const StreamingCell& cell) = 0;
+
+		// Called from 'WorldStreamer::Update' once the cell fits into the frame's upload budget.
+		virtual void Upload(const StreamingCell& cell) = 0;
+
+		// Releases both CPU and GPU data of the cell.
+		virtual void Unload(const StreamingCell& cell) = 0;
+	};
+
+	struct WorldStreamerSettings
+	{
+		float cellSize{ 64.0f };
+
+		// Cells closer than this are streamed in.
+		float loadRadius{ 256.0f };
+		// Cells farther than this are streamed out. Keep it above 'loadRadius' to avoid thrashing.
+		float unloadRadius{ 320.0f };
+		// Cells closer than this must be resident, otherwise the frame counts as stalled.
+		// These cells are loaded even if that breaks the memory budget.
+		float requiredRadius{ 96.0f };
+
+		uint64_t cpuBudgetBytes{ 512ull * 1024 * 1024 };
+		uint64_t gpuBudgetBytes{ 1024ull * 1024 * 1024 };
+
+		// GPU bytes uploaded per frame. At least one cell is uploaded per frame regardless.
+		uint64_t uploadBudgetBytesPerFrame{ 16ull * 1024 * 1024 };
+
+		uint32_t maxLoadsInFlight{ 8 };
+	};
+
+	struct WorldStreamerFrameStats
+	{
+		uint32_t loadsIssued{ 0 };
+		uint32_t uploads{ 0 };
+		uint32_t unloads{ 0 };
+		uint32_t evictions{ 0 };
+
+		uint64_t uploadedBytes{ 0 };
+
+		// Required cells that are not resident this frame.
+		uint32_t stalledCells{ 0 };
+		// Cells in load range that didn't fit into the memory budget.
+		uint32_t budgetRejectedCells{ 0 };
+
+		bool cpuBudgetExceeded{ false };
+		bool gpuBudgetExceeded{ false };
+	};
+
+	struct WorldStreamerStats
+	{
+		uint64_t frameCount{ 0 };
+
+		uint64_t stalledFrameCount{ 0 };
+		uint64_t stalledCellFrames{ 0 };
+
+		uint64_t cpuBudgetOverrunFrames{ 0 };
+		uint64_t gpuBudgetOverrunFrames{ 0 };
+
+		uint64_t peakCpuBytes{ 0 };
+		uint64_t peakGpuBytes{ 0 };
+		uint64_t peakUploadBytesPerFrame{ 0 };
+	};
+
+	class WorldStreamer
+	{
+	public:
+
+		using CellId = StreamingCell::CellId;
+
+		WorldStreamer(const WorldStreamerSettings& settings, StreamingCellLoader* cellLoader);
+		~WorldStreamer() = default;
+
+		CLASS_NO_COPY(WorldStreamer);
+		CLASS_NO_MOVE(WorldStreamer);
+
+		CellId AddCell(const StreamingCellCoord& coord, uint64_t cpuBytes, uint64_t gpuBytes, uint32_t priority = 0);
+
+		StreamingCellCoord WorldPositionToCellCoord(const DirectX::XMFLOAT3& position) const;
+
+		// Call once per frame from the main thread.
+		void Update(const DirectX::XMFLOAT3& cameraPosition);
+
+		// Thread-safe. Completions are applied on the next 'Update'.
+		void OnCellLoaded(CellId cellId, bool succeeded);
+
+		const StreamingCell& GetCell(CellId cellId) const;
+		uint32_t GetCellCount() const;
+
+		uint64_t GetCpuCommittedBytes() const;
+		uint64_t GetGpuCommittedBytes() const;
+
+		const WorldStreamerFrameStats& GetFrameStats() const;
+		const WorldStreamerStats& GetStats() const;
+
+	private:
+
+		struct CellLoadCompletion
+		{
+			CellId cellId{ 0 };
+			bool succeeded{ false };
+		};
+
+		static uint64_t PackCellCoord(const StreamingCellCoord& coord);
+
+		float CellDistance(const StreamingCell& cell, const DirectX::XMFLOAT3& cameraPosition) const;
+
+		void ApplyLoadCompletions();
+
+		// Uses the camera distances computed at the start of the frame.
+		void UnloadDistantCells();
+		void IssueLoads(const DirectX::XMFLOAT3& cameraPosition);
+		void UploadLoadedCells();
+		void UpdateStats(const DirectX::XMFLOAT3& cameraPosition);
+
+		bool FitsIntoBudget(const StreamingCell& cell) const;
+		bool EvictForCell(const StreamingCell& cell);
+
+		void ReleaseCell(StreamingCell& cell);
+		// Drops the cells released since the last call from 'activeCells'.
+		void RemoveUnloadedCells();
+
+		bool IsRequired(const StreamingCell& cell) const;
+
+		WorldStreamerSettings settings{};
+		StreamingCellLoader* cellLoader{ nullptr };
+
+		std::vector<StreamingCell> cells;
+		std::unordered_map<uint64_t, CellId> cellLookup;
+
+		// Every cell that isn't UNLOADED.
+		std::vector<CellId> activeCells;
+
+		std::vector<CellLoadCompletion> loadCompletions;
+		std::mutex loadCompletionsMutex;
+
+		uint64_t cpuCommittedBytes{ 0 };
+		uint64_t gpuCommittedBytes{ 0 };
+
+		uint32_t loadsInFlight{ 0 };
+
+		WorldStreamerFrameStats frameStats{};
+		WorldStreamerStats stats{};
+	};
+}
\ No newline at end of file
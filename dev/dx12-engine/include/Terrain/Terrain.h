@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Core/Utility.h"
+#include "Renderer/ProceduralGeometry.h"
+
+#include <DirectXMath.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	// Heightfield terrain drawn as quadtree chunks, CDLOD style. Every chunk, at any LOD, is the same
+	// grid of 'chunkResolution' quads per side (or a quarter of it), so two grid meshes draw the
+	// whole terrain. Each chunk has its own heights at its LOD's sample spacing, and vertices morph
+	// into the next coarser LOD with distance, so there is neither popping nor cracks between LODs.
+	//
+	// The terrain lies on the XZ plane, sample (0, 0) at the origin and sample (x, z) at
+	// (x * sampleSpacing, z * sampleSpacing). LOD 0 is the finest one.
+
+	struct TerrainSettings
+	{
+		// Quads per chunk side, a power of two of at least 4.
+		uint32_t chunkResolution{ 32 };
+
+		// A root chunk covers 'chunkResolution' << (lodCount - 1) quads per side.
+		uint32_t lodCount{ 6 };
+
+		float sampleSpacing{ 1.0f };
+
+		// LOD 0 is used up to this distance, every coarser LOD reaches 'lodDistanceRatio' times
+		// farther. The coarsest LOD covers everything beyond.
+		float finestLodDistance{ 128.0f };
+		float lodDistanceRatio{ 2.0f };
+
+		// Fraction at the far end of every LOD's range over which it morphs into the next one.
+		float morphRegion{ 0.3f };
+	};
+
+	enum class TerrainGridMesh
+	{
+		// (chunkResolution + 1)^2 vertices.
+		FULL,
+		// (chunkResolution / 2 + 1)^2 vertices, one quadrant of a chunk.
+		QUARTER,
+	};
+
+	constexpr uint32_t TERRAIN_FULL_CHUNK = UINT32_MAX;
+
+	struct TerrainChunk
+	{
+		uint32_t lod{ 0 };
+		uint32_t x{ 0 };
+		uint32_t z{ 0 };
+
+		DirectX::XMFLOAT2 origin{};
+		float size{ 0.0f };
+
+		// Over the full resolution heights beneath the chunk, not only its own samples.
+		float minHeight{ 0.0f };
+		float maxHeight{ 0.0f };
+
+		// (chunkResolution + 1)^2 heights, row by row along +Z, at 'GetChunkHeights'.
+		uint64_t heightOffset{ 0 };
+	};
+
+	struct TerrainDrawChunk
+	{
+		uint32_t chunkIndex{ 0 };
+		// TERRAIN_FULL_CHUNK, or the quadrant drawn with the quarter grid: bit 0 for +X, bit 1 for +Z.
+		uint32_t quadrant{ TERRAIN_FULL_CHUNK };
+
+		TerrainGridMesh gridMesh{ TerrainGridMesh::FULL };
+		uint32_t lod{ 0 };
+
+		DirectX::XMFLOAT2 origin{};
+		float size{ 0.0f };
+
+		float morphStart{ 0.0f };
+		float morphEnd{ 0.0f };
+	};
+
+	struct TerrainView
+	{
+		DirectX::XMFLOAT3 cameraPosition{};
+
+		// Planes point inwards (ax + by + cz + d >= 0 inside), see 'ExtractFrustumPlanes'.
+		bool frustumCulling{ false };
+		std::array<DirectX::XMFLOAT4, 6> frustumPlanes{};
+	};
+
+	struct TerrainSelection
+	{
+		std::vector<TerrainDrawChunk> drawChunks;
+
+		uint64_t vertexCount{ 0 };
+		uint64_t triangleCount{ 0 };
+
+		uint32_t visitedChunkCount{ 0 };
+		uint32_t culledChunkCount{ 0 };
+	};
+
+	// From a row-vector view-projection matrix with a [0, 1] depth range, like XMMatrixPerspectiveFovLH gives.
+	std::array<DirectX::XMFLOAT4, 6> ExtractFrustumPlanes(const DirectX::XMFLOAT4X4& viewProjection);
+
+	class Terrain
+	{
+	public:
+
+		// 'heights' holds 'sampleCountX' * 'sampleCountZ' world space heights, row by row along +Z.
+		// Both sample counts minus one have to be multiples of the root chunk size.
+		Terrain(const TerrainSettings& settings, const std::vector<float>& heights,
+			uint32_t sampleCountX, uint32_t sampleCountZ, ThreadPool* threadPool = nullptr);
+		~Terrain() = default;
+
+		CLASS_NO_COPY(Terrain);
+		CLASS_DEFAULT_MOVE(Terrain);
+
+		// Picks the chunks to draw and their LODs. Const, so several views can be selected at once.
+		// The root chunks are split into subtrees that are traversed in parallel; the result
+		// doesn't depend on the thread count.
+		void SelectChunks(const TerrainView& view, TerrainSelection& selection, ThreadPool* threadPool = nullptr) const;
+
+		// The grid mesh chunks are drawn with, a unit grid centered on the origin like 'GenerateGrid'
+		// makes them. Position XZ + 0.5 (or the UV) is the vertex's place within the draw chunk.
+		ProceduralMesh CreateGridMesh(const ProceduralVertexFormat& vertexFormat, TerrainGridMesh gridMesh) const;
+
+		// Bilinear, clamped at the edges.
+		float SampleHeight(float x, float z) const;
+
+		// Matches the vertex shader: 0 keeps the chunk's own LOD, 1 is fully morphed into the next one.
+		float CalculateMorphFactor(const TerrainDrawChunk& drawChunk, const DirectX::XMFLOAT3& vertexPosition,
+			const DirectX::XMFLOAT3& cameraPosition) const;
+		// World position of a grid vertex (in quads of the draw chunk's grid) after morphing.
+		DirectX::XMFLOAT3 GetMorphedVertexPosition(const TerrainDrawChunk& drawChunk, uint32_t gridX, uint32_t gridZ,
+			const DirectX::XMFLOAT3& cameraPosition) const;
+
+		const TerrainChunk& GetChunk(uint32_t chunkIndex) const;
+		uint32_t GetChunkCount() const;
+		const float* GetChunkHeights(uint32_t chunkIndex) const;
+		// All chunks' heights back to back, for upload.
+		const std::vector<float>& GetChunkHeightData() const;
+
+		float GetLodRange(uint32_t lod) const;
+		float GetMorphStart(uint32_t lod) const;
+
+		const TerrainSettings& GetSettings() const;
+		float GetSizeX() const;
+		float GetSizeZ() const;
+
+	private:
+
+		struct LodLevel
+		{
+			uint32_t chunkCountX{ 0 };
+			uint32_t chunkCountZ{ 0 };
+			uint32_t firstChunk{ 0 };
+		};
+
+		void BuildChunks(ThreadPool* threadPool);
+
+		uint32_t GetChunkIndex(uint32_t lod, uint32_t x, uint32_t z) const;
+		uint32_t GetChildIndex(const TerrainChunk& chunk, uint32_t quadrant) const;
+
+		bool IsInRange(const TerrainChunk& chunk, const DirectX::XMFLOAT3& cameraPosition, float range) const;
+		bool IsCulled(const TerrainChunk& chunk, const TerrainView& view) const;
+
+		// 'chunkIndex' is visible and within its LOD's range. Children that aren't within the finer
+		// range are drawn as quadrants of this chunk, the others are selected recursively, or
+		// collected into 'deferredChildren' when given.
+		void SelectChunk(uint32_t chunkIndex, const TerrainView& view, TerrainSelection& selection,
+			std::vector<uint32_t>* deferredChildren) const;
+		void AddDrawChunk(uint32_t chunkIndex, uint32_t quadrant, TerrainSelection& selection) const;
+
+		TerrainSettings settings{};
+
+		uint32_t sampleCountX{ 0 };
+		uint32_t sampleCountZ{ 0 };
+		std::vector<float> heights;
+
+		std::vector<LodLevel> lodLevels;
+		std::vector<TerrainChunk> chunks;
+		std::vector<float> chunkHeights;
+
+		std::vector<float> lodRanges;
+		std::vector<float> morphStarts;
+	};
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Core/MathUtility.h"
+#include "Renderer/Vertex.h"
+#include "Texture/Image.h"
+
+#include <DirectXMath.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	enum class AtlasPackHeuristic
+	{
+		// Bottom-left skyline, packs 10k mixed rects in about 3 ms. Leaves holes under
+		// tall entries, so it works best with similar heights (i.e. glyphs, UI icons).
+		SKYLINE,
+		// Bottom-left MaxRects, tracks every free area and fills those holes. Tighter for
+		// mixed sizes but takes 150 to 300 ms for 10k mixed rects, so it's meant for offline
+		// builds and batches of a few hundred rects.
+		MAX_RECTS,
+	};
+
+	struct AtlasPackSettings
+	{
+		AtlasPackHeuristic heuristic{ AtlasPackHeuristic::SKYLINE };
+
+		uint32_t maxWidth{ 4096 };
+		uint32_t maxHeight{ 4096 };
+
+		// Border of replicated edge texels around every entry, counted in the smallest mip.
+		// It's scaled up by 2^(mipLevels - 1) in mip 0, and entries are aligned to the same
+		// amount, so neither filtering nor mip generation bleeds neighbours into each other.
+		uint32_t gutter{ 1 };
+		uint32_t mipLevels{ 1 };
+
+		// Empty (transparent black) texels between the gutters of neighbouring entries.
+		uint32_t padding{ 0 };
+
+		// Entries start on multiples of this (a power of two), i.e. 4 to keep
+		// BC blocks from straddling two entries.
+		uint32_t alignment{ 1 };
+
+		bool powerOfTwo{ false };
+	};
+
+	// uv' = uv * scale + offset, maps a whole texture's UVs into its atlas entry.
+	struct AtlasUvTransform
+	{
+		DirectX::XMFLOAT2 scale{ 1.0f, 1.0f };
+		DirectX::XMFLOAT2 offset{ 0.0f, 0.0f };
+	};
+
+	struct AtlasEntry
+	{
+		// Texels of the original image, gutters excluded.
+		uint32_t x{ 0 };
+		uint32_t y{ 0 };
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+
+		AtlasUvTransform uvTransform{};
+	};
+
+	struct AtlasLayout
+	{
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+
+		// Same order as the packed sizes or images.
+		std::vector<AtlasEntry> entries;
+
+		// Fraction of the atlas covered by image texels, and by whole packed rectangles
+		// (gutters, padding and alignment included).
+		float occupancy{ 0.0f };
+		float packedOccupancy{ 0.0f };
+	};
+
+	struct TextureAtlas
+	{
+		AtlasLayout layout;
+		Image image;
+	};
+
+	// Finds the smallest atlas (up to maxWidth x maxHeight) holding every size,
+	// throws if they don't fit. Only computes the placement, no pixels are touched.
+	AtlasLayout PackAtlasRects(const std::vector<Dimensions2D>& sizes, const AtlasPackSettings& settings);
+
+	// Packs and copies every image into the atlas, filling the gutters. All images must
+	// share a format; the copies run on the pool when one is given.
+	TextureAtlas BuildTextureAtlas(
+		const std::vector<const Image*>& images, const AtlasPackSettings& settings, ThreadPool* threadPool = nullptr);
+
+	// Bulk UV remapping for meshes that used to sample the entry's texture on its own.
+	void RemapAtlasUvs(DirectX::XMFLOAT2* uvs, size_t count, const AtlasUvTransform& uvTransform);
+	void RemapAtlasUvs(VertexPU* vertices, size_t count, const AtlasUvTransform& uvTransform);
+	void RemapAtlasUvs(VertexPNU* vertices, size_t count, const AtlasUvTransform& uvTransform);
+}
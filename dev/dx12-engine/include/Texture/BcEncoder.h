@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Texture/Image.h"
+#include "Texture/TextureFormat.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	enum class BcEncodeQuality
+	{
+		// Import-time: bounding box endpoints and a single index pass.
+		FAST,
+		// Cook-time: principal axis endpoints with least-squares refinement,
+		// BC7 also searches the two-subset partitions for opaque blocks.
+		HIGH,
+	};
+
+	struct BcEncodeSettings
+	{
+		// BC1, BC3, BC4_UNORM, BC5_UNORM and BC7, sRGB variants included.
+		// sRGB only changes how the GPU reads the data, the pixels are encoded as they are.
+		TextureFormat format{ TextureFormat::BC1_UNORM };
+		BcEncodeQuality quality{ BcEncodeQuality::FAST };
+	};
+
+	bool IsBcEncodeFormatSupported(TextureFormat format);
+
+	// Single block entry points. 'pixels' holds 4x4 RGBA8 pixels in row-major order (64 bytes).
+	// BC1 is always encoded as opaque, BC4 takes the red channel and BC5 takes red and green.
+
+	void EncodeBc1Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality);
+	void EncodeBc3Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality);
+	void EncodeBc4Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality);
+	void EncodeBc5Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality);
+	void EncodeBc7Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality);
+
+	// Returns tightly packed rows of blocks, the same layout DDS and KTX2 use.
+	// Edge blocks of images that aren't a multiple of 4 repeat the last row/column.
+	std::vector<uint8_t> EncodeBcImage(
+		const Image& image, const BcEncodeSettings& settings, ThreadPool* threadPool = nullptr);
+
+	// Encodes every mip into one buffer, mip 0 first. Block rows of all mips are handed
+	// out to the pool together, so the tiny tail mips don't serialize the end of the job.
+	std::vector<uint8_t> EncodeBcMipChain(
+		const std::vector<Image>& mips, const BcEncodeSettings& settings, ThreadPool* threadPool = nullptr);
+}
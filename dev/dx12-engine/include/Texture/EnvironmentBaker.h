@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Texture/Image.h"
+#include "Texture/TextureLayout.h"
+
+#include <DirectXMath.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	// Cube maps for image-based lighting, baked on the CPU. Faces are in D3D12 order
+	// (+X, -X, +Y, -Y, +Z, -Z) with D3D's face orientation, so the output uploads as a TextureCube as is.
+
+	constexpr uint32_t CUBEMAP_FACE_COUNT = 6;
+
+	// Linear RGBA floats.
+	struct FloatCubemap
+	{
+		uint32_t size{ 0 };
+		uint32_t mipLevels{ 0 };
+
+		// One surface per face and mip, indexed by CalculateSubresourceIndex(mip, face, mipLevels).
+		std::vector<std::vector<float>> surfaces;
+
+		uint32_t GetMipSize(uint32_t mip) const;
+
+		float* GetSurface(uint32_t mip, uint32_t face);
+		const float* GetSurface(uint32_t mip, uint32_t face) const;
+	};
+
+	FloatCubemap CreateFloatCubemap(uint32_t size, uint32_t mipLevels = 1);
+
+	// Unit direction through the texel position (u, v in [0, 1]) of a face, and back.
+	DirectX::XMFLOAT3 GetCubemapDirection(uint32_t face, float u, float v);
+	void GetCubemapFaceUv(const DirectX::XMFLOAT3& direction, uint32_t& face, float& u, float& v);
+	// Solid angle texel (x, y) of a 'size' x 'size' face covers, the six faces sum to 4 pi.
+	float CalculateCubemapTexelSolidAngle(uint32_t x, uint32_t y, uint32_t size);
+
+	// Trilinear within a face (edges clamp to the face), 'lod' is clamped to the available mips.
+	DirectX::XMFLOAT4 SampleCubemap(const FloatCubemap& cubemap, const DirectX::XMFLOAT3& direction, float lod = 0.0f);
+
+	// Averages each mip down from the previous one, after resizing 'cubemap' to 'mipLevels' (0 for the full chain).
+	void GenerateCubemapMips(FloatCubemap& cubemap, uint32_t mipLevels = 0, ThreadPool* threadPool = nullptr);
+
+	// From a linear RGBA equirectangular (latitude-longitude) image, +Y up, U = 0 along +X.
+	FloatCubemap ConvertEquirectangularToCubemap(const float* pixels, uint32_t width, uint32_t height,
+		uint32_t faceSize, ThreadPool* threadPool = nullptr);
+
+	// Six LDR face images of one size. sRGB images are converted to linear.
+	FloatCubemap ConvertImagesToCubemap(const std::array<const Image*, CUBEMAP_FACE_COUNT>& faces);
+
+	struct SpecularPrefilterSettings
+	{
+		uint32_t size{ 256 };
+
+		// Roughness goes linearly from 0 in mip 0 to 1 in the last mip.
+		uint32_t mipLevels{ 6 };
+
+		// GGX samples per texel. Samples read the source mip that matches their footprint
+		// (filtered importance sampling), so a few hundred are enough without fireflies.
+		uint32_t sampleCount{ 256 };
+	};
+
+	// Split-sum specular prefiltering (N = V = R). Source mips are generated on a copy if missing.
+	FloatCubemap PrefilterSpecular(
+		const FloatCubemap& source, const SpecularPrefilterSettings& settings, ThreadPool* threadPool = nullptr);
+
+	float GetPrefilteredRoughness(uint32_t mip, uint32_t mipLevels);
+
+	struct IrradianceSettings
+	{
+		uint32_t size{ 32 };
+
+		// Every texel of the source mip closest to this size is integrated, no sampling noise.
+		uint32_t sourceSize{ 64 };
+	};
+
+	// Cosine convolution, divided by pi: the radiance a white Lambertian surface reflects.
+	FloatCubemap ConvolveIrradiance(
+		const FloatCubemap& source, const IrradianceSettings& settings, ThreadPool* threadPool = nullptr);
+
+	struct CubemapUploadData
+	{
+		TextureDesc desc{};
+		TextureUploadLayout layout{};
+
+		// Follows 'layout', ready to be copied into an upload buffer.
+		std::vector<uint8_t> data;
+	};
+
+	// R16G16B16A16_FLOAT or R32G32B32A32_FLOAT.
+	CubemapUploadData CreateCubemapUploadData(
+		const FloatCubemap& cubemap, TextureFormat format = TextureFormat::R16G16B16A16_FLOAT);
+}
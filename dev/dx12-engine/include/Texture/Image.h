@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Texture/TextureFormat.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	constexpr uint32_t IMAGE_BYTES_PER_PIXEL = 4;
+
+	// Uncompressed, tightly packed 8-bit RGBA pixels. This is what the CPU texture
+	// tools work on, before the result gets block-compressed or uploaded.
+	struct Image
+	{
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+
+		// R8G8B8A8_UNORM or R8G8B8A8_UNORM_SRGB.
+		TextureFormat format{ TextureFormat::R8G8B8A8_UNORM };
+
+		std::vector<uint8_t> pixels;
+
+		uint64_t GetRowPitch() const;
+		uint64_t GetSizeInBytes() const;
+
+		uint8_t* GetPixel(uint32_t x, uint32_t y);
+		const uint8_t* GetPixel(uint32_t x, uint32_t y) const;
+	};
+
+	Image CreateImage(uint32_t width, uint32_t height, TextureFormat format = TextureFormat::R8G8B8A8_UNORM);
+}
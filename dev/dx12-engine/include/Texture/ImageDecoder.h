@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Texture/Image.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	enum class ImageFileFormat
+	{
+		UNKNOWN,
+		TGA,
+		PPM,
+		QOI,
+	};
+
+	// Every decoder returns RGBA8, whatever the file stores (gray, RGB, BGR(A)), so the result
+	// goes straight into GenerateMipChain, EncodeBcImage or an upload. TGA and PPM carry no
+	// color space and are tagged sRGB; QOI tags come from its header. Malformed data throws.
+
+	Image DecodeTga(const uint8_t* data, size_t size);
+	// Binary P5 (gray) and P6 (RGB), 16-bit samples are reduced to 8 bits.
+	Image DecodePpm(const uint8_t* data, size_t size);
+	Image DecodeQoi(const uint8_t* data, size_t size);
+
+	// TGA has no magic number, so it's whatever isn't recognized as PPM or QOI
+	// and still has a supported TGA image type.
+	ImageFileFormat DetectImageFileFormat(const uint8_t* data, size_t size);
+	Image DecodeImage(const uint8_t* data, size_t size);
+
+	// Maps the file and decodes it.
+	Image LoadImageFile(const std::filesystem::path& path);
+
+	struct ImageLoadResult
+	{
+		std::filesystem::path path;
+		Image image;
+
+		bool succeeded{ false };
+		std::string errorMessage;
+	};
+
+	// Decodes every file on the pool, one file per task. Results keep the order of 'paths';
+	// a broken file fails its own result instead of the whole batch.
+	std::vector<ImageLoadResult> LoadImageFiles(
+		const std::vector<std::filesystem::path>& paths, ThreadPool* threadPool = nullptr);
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Texture/Image.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	class ThreadPool;
+
+	enum class MipFilter
+	{
+		// Averages the covered area, the cheapest option.
+		BOX,
+		// Kaiser windowed sinc (radius 3), sharp with little ringing.
+		KAISER,
+		// Lanczos3, the sharpest option, rings a bit more on hard edges.
+		LANCZOS,
+	};
+
+	struct MipGenerationSettings
+	{
+		MipFilter filter{ MipFilter::BOX };
+
+		// 0 builds the full chain down to 1x1.
+		uint32_t mipLevels{ 0 };
+
+		// Rescales alpha in every mip so that the same fraction of pixels passes the alpha test
+		// as in mip 0. Keeps alpha-tested foliage and fences from thinning out in the distance.
+		bool preserveAlphaCoverage{ false };
+		float alphaCoverageReference{ 0.5f };
+	};
+
+	// Returns every mip including mip 0 (a copy of 'image'), ready for upload or block compression.
+	// R8G8B8A8_UNORM_SRGB images are filtered in linear space; alpha is always linear.
+	// Each mip is built from the previous one kept at float precision, so errors don't pile up,
+	// and any size works, not only powers of two. Output doesn't depend on the thread count.
+	std::vector<Image> GenerateMipChain(
+		const Image& image, const MipGenerationSettings& settings, ThreadPool* threadPool = nullptr);
+}
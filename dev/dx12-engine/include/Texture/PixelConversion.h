@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dxe
+{
+	// Channel order conversions for 8-bit pixels. Counts are in pixels.
+	// The four-channel swizzles may run in place ('source' == 'destination'),
+	// the expansions read 3 (or 1) bytes per pixel and write 4, so they can't.
+
+	// RGBA <-> BGRA, the same operation both ways.
+	void SwizzleRedBlue(const uint8_t* source, uint8_t* destination, size_t pixelCount);
+
+	void ExpandRgbToRgba(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha = 255);
+	void ExpandBgrToRgba(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha = 255);
+	// Same byte shuffle as BGR -> RGBA, named for the direction it's used in.
+	void ExpandRgbToBgra(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha = 255);
+
+	void ExpandGrayToRgba(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha = 255);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+namespace dxe
+{
+	enum class TextureFormat
+	{
+		UNKNOWN = 0,
+
+		R8_UNORM,
+		R8G8_UNORM,
+		R8G8B8A8_UNORM,
+		R8G8B8A8_UNORM_SRGB,
+		B8G8R8A8_UNORM,
+		B8G8R8A8_UNORM_SRGB,
+
+		R16_FLOAT,
+		R16G16_FLOAT,
+		R16G16B16A16_FLOAT,
+		R32_FLOAT,
+		R32G32B32A32_FLOAT,
+		R11G11B10_FLOAT,
+
+		BC1_UNORM,
+		BC1_UNORM_SRGB,
+		BC2_UNORM,
+		BC2_UNORM_SRGB,
+		BC3_UNORM,
+		BC3_UNORM_SRGB,
+		BC4_UNORM,
+		BC4_SNORM,
+		BC5_UNORM,
+		BC5_SNORM,
+		BC6H_UF16,
+		BC6H_SF16,
+		BC7_UNORM,
+		BC7_UNORM_SRGB,
+	};
+
+	struct TextureFormatInfo
+	{
+		// 1 for uncompressed formats, 4 for block-compressed ones.
+		uint32_t blockWidth{ 1 };
+		uint32_t blockHeight{ 1 };
+		// Bytes per pixel for uncompressed formats, bytes per block otherwise.
+		uint32_t bytesPerBlock{ 0 };
+
+		uint32_t channelCount{ 0 };
+
+		bool blockCompressed{ false };
+		bool srgb{ false };
+	};
+
+	TextureFormatInfo GetTextureFormatInfo(TextureFormat format);
+
+	bool IsTextureFormatBlockCompressed(TextureFormat format);
+	bool IsTextureFormatSrgb(TextureFormat format);
+
+	TextureFormat GetSrgbTextureFormat(TextureFormat format);
+	TextureFormat GetLinearTextureFormat(TextureFormat format);
+
+	// Container formats store the format as a raw DXGI_FORMAT (DDS) or VkFormat (KTX2) value.
+	// Unsupported values map to UNKNOWN.
+
+	TextureFormat DxgiFormatValueToTextureFormat(uint32_t dxgiFormat);
+	uint32_t TextureFormatToDxgiFormatValue(TextureFormat format);
+
+	TextureFormat VkFormatValueToTextureFormat(uint32_t vkFormat);
+}
\ No newline at end of file
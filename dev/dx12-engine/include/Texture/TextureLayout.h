@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Texture/TextureFormat.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace dxe
+{
+	// Same values as D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT,
+	// duplicated here so that the layout math doesn't depend on the D3D12 headers.
+	constexpr uint64_t TEXTURE_DATA_PITCH_ALIGNMENT = 256;
+	constexpr uint64_t TEXTURE_DATA_PLACEMENT_ALIGNMENT = 512;
+
+	enum class TextureDimension
+	{
+		TEXTURE_1D,
+		TEXTURE_2D,
+		TEXTURE_3D,
+		TEXTURE_CUBE,
+	};
+
+	struct TextureDesc
+	{
+		TextureDimension dimension{ TextureDimension::TEXTURE_2D };
+		TextureFormat format{ TextureFormat::UNKNOWN };
+
+		uint32_t width{ 1 };
+		uint32_t height{ 1 };
+		uint32_t depth{ 1 };
+
+		// Number of array elements. For cube maps this counts whole cubes, not faces.
+		uint32_t arraySize{ 1 };
+		uint32_t mipLevels{ 1 };
+
+		// Array slices as D3D12 sees them (6 faces per cube).
+		uint32_t GetArraySliceCount() const;
+		uint32_t GetSubresourceCount() const;
+
+		uint32_t GetMipWidth(uint32_t mip) const;
+		uint32_t GetMipHeight(uint32_t mip) const;
+		uint32_t GetMipDepth(uint32_t mip) const;
+	};
+
+	// Matches D3D12CalcSubresource.
+	inline uint32_t CalculateSubresourceIndex(uint32_t mip, uint32_t arraySlice, uint32_t mipLevels)
+	{
+		return mip + arraySlice * mipLevels;
+	}
+
+	uint32_t CalculateFullMipChainLength(uint32_t width, uint32_t height, uint32_t depth = 1);
+
+	inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	// The layout of one subresource inside an upload buffer.
+	// Field meaning matches D3D12_PLACED_SUBRESOURCE_FOOTPRINT and the outputs of GetCopyableFootprints.
+
+	struct TextureSubresourceFootprint
+	{
+		uint64_t offset{ 0 };
+
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+		uint32_t depth{ 0 };
+
+		// Padded to TEXTURE_DATA_PITCH_ALIGNMENT.
+		uint32_t rowPitch{ 0 };
+		// Rows of pixels, or rows of blocks for block-compressed formats.
+		uint32_t rowCount{ 0 };
+		// Unpadded size of one row.
+		uint64_t rowSizeInBytes{ 0 };
+	};
+
+	struct TextureUploadLayout
+	{
+		std::vector<TextureSubresourceFootprint> footprints;
+
+		// Size the upload buffer has to be, as reported by GetCopyableFootprints.
+		uint64_t totalBytes{ 0 };
+	};
+
+	// CPU equivalent of ID3D12Device::GetCopyableFootprints for a whole texture.
+	TextureUploadLayout CalculateTextureUploadLayout(const TextureDesc& desc, uint64_t baseOffset = 0);
+
+	// Tightly packed size of one subresource, which is how DDS and KTX2 store it.
+	uint64_t CalculatePackedSubresourceSize(const TextureDesc& desc, uint32_t mip);
+	uint64_t CalculatePackedRowSize(TextureFormat format, uint32_t width);
+	uint32_t CalculateRowCount(TextureFormat format, uint32_t height);
+}
\ No newline at end of file
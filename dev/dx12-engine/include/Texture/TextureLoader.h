@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Texture/TextureLayout.h"
+
+#include "Core/MappedFile.h"
+#include "Core/Utility.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace dxe
+{
+	enum class TextureContainer
+	{
+		DDS,
+		KTX2,
+	};
+
+	// Points straight into the mapped file, nothing is decoded or copied.
+	struct TextureSubresourceData
+	{
+		const uint8_t* data{ nullptr };
+
+		// Tightly packed, as stored in the container.
+		uint64_t rowPitch{ 0 };
+		uint64_t slicePitch{ 0 };
+	};
+
+	// What one CopyTextureRegion call needs: where the subresource comes from,
+	// and where it has to be placed in the upload buffer.
+	struct TextureCopyDesc
+	{
+		uint32_t subresourceIndex{ 0 };
+
+		TextureSubresourceData source{};
+		TextureSubresourceFootprint destination{};
+	};
+
+	class TextureFile
+	{
+	public:
+
+		TextureFile() = default;
+
+		CLASS_NO_COPY(TextureFile);
+		CLASS_DEFAULT_MOVE(TextureFile);
+
+		const TextureDesc& GetDesc() const;
+		TextureContainer GetContainer() const;
+
+		// Indexed by D3D12 subresource index (see 'CalculateSubresourceIndex').
+		const std::vector<TextureSubresourceData>& GetSubresources() const;
+
+		// Upload buffer layout with padded row pitches, plus one copy per subresource.
+		TextureUploadLayout CalculateUploadLayout(uint64_t baseOffset = 0) const;
+		std::vector<TextureCopyDesc> CreateCopyDescs(const TextureUploadLayout& uploadLayout) const;
+
+		// Writes every subresource into a (mapped) upload buffer that follows 'uploadLayout'.
+		// 'uploadBufferData' points at the start of the buffer, not at the layout's base offset.
+		void WriteUploadData(const TextureUploadLayout& uploadLayout, uint8_t* uploadBufferData) const;
+
+	private:
+
+		friend TextureFile LoadDdsTexture(const std::filesystem::path& path);
+		friend TextureFile LoadKtx2Texture(const std::filesystem::path& path);
+
+		MappedFile mappedFile;
+
+		TextureDesc desc{};
+		TextureContainer container{ TextureContainer::DDS };
+
+		std::vector<TextureSubresourceData> subresources;
+	};
+
+	TextureFile LoadDdsTexture(const std::filesystem::path& path);
+	TextureFile LoadKtx2Texture(const std::filesystem::path& path);
+
+	// Picks the container by looking at the file's magic number.
+	TextureFile LoadTexture(const std::filesystem::path& path);
+}
\ No newline at end of file
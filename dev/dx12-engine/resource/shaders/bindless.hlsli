@@ -0,0 +1,14 @@
+// Declarations matching Dx12RootSignature::CreateBindlessRootSignature, needs shader model 5.1.
+
+struct DrawConstants
+{
+    uint drawIndex;
+    // Index of the draw's resource in the bindless table.
+    uint resourceIndex;
+};
+
+ConstantBuffer<DrawConstants> drawConstants : register(b0, space0);
+
+// Both alias the whole bindless table, a view is read through the array of its type.
+Texture2D bindlessTextures[]         : register(t0, space1);
+ByteAddressBuffer bindlessBuffers[]  : register(t0, space2);
@@ -0,0 +1,87 @@
+// CDLOD terrain, see Terrain/Terrain.h. Every draw is one TerrainDrawChunk drawn with
+// the full or the quarter grid mesh, heights come from the terrain's chunk height data.
+
+cbuffer TerrainFrameConstants : register(b0)
+{
+    float4x4 viewProjection;
+    float3   cameraPosition;
+    uint     chunkResolution;
+};
+
+cbuffer TerrainChunkConstants : register(b1)
+{
+    float2 chunkOrigin;
+    float  chunkSize;
+    uint   gridResolution;
+
+    float  morphStart;
+    float  morphEnd;
+    // First sample of the drawn quadrant within the chunk, (0, 0) for full chunks.
+    uint2  quadrantOffset;
+
+    // Offset of the chunk's heights.
+    uint   heightOffset;
+    uint3  padding;
+};
+
+StructuredBuffer<float> chunkHeights : register(t0);
+
+struct VSInput
+{
+    float3 position : POSITION;
+};
+
+struct PSInput
+{
+    float4 position : SV_POSITION;
+    float3 normal   : NORMAL;
+};
+
+// 'sample' is within the drawn grid. Clamped in chunk samples, so taps past a quadrant's +X or +Z
+// edge read the chunk's next samples, and only taps past the chunk's edge stop at it.
+float LoadHeight(uint2 sample)
+{
+    sample = min(sample + quadrantOffset, uint2(chunkResolution, chunkResolution));
+    return chunkHeights[heightOffset + sample.y * (chunkResolution + 1) + sample.x];
+}
+
+float SampleHeight(float2 gridPosition)
+{
+    uint2 sample = uint2(gridPosition);
+    float2 fraction = gridPosition - sample;
+
+    float height0 = lerp(LoadHeight(sample), LoadHeight(sample + uint2(1, 0)), fraction.x);
+    float height1 = lerp(LoadHeight(sample + uint2(0, 1)), LoadHeight(sample + uint2(1, 1)), fraction.x);
+    return lerp(height0, height1, fraction.y);
+}
+
+PSInput VSMain(VSInput input)
+{
+    float spacing = chunkSize / gridResolution;
+    float2 gridPosition = round((input.position.xz + 0.5) * gridResolution);
+
+    float3 worldPosition = float3(chunkOrigin.x + gridPosition.x * spacing, 0.0, chunkOrigin.y + gridPosition.y * spacing);
+    worldPosition.y = SampleHeight(gridPosition);
+
+    // Odd vertices slide onto their even neighbor, turning the grid into the next LOD's.
+    float morphFactor = saturate((distance(worldPosition, cameraPosition) - morphStart) / max(morphEnd - morphStart, 1e-6));
+    gridPosition -= frac(gridPosition * 0.5) * 2.0 * morphFactor;
+
+    worldPosition.xz = chunkOrigin + gridPosition * spacing;
+    worldPosition.y = SampleHeight(gridPosition);
+
+    float heightX = SampleHeight(gridPosition + float2(1.0, 0.0)) - SampleHeight(max(gridPosition - float2(1.0, 0.0), 0.0));
+    float heightZ = SampleHeight(gridPosition + float2(0.0, 1.0)) - SampleHeight(max(gridPosition - float2(0.0, 1.0), 0.0));
+
+    PSInput result;
+    result.position = mul(float4(worldPosition, 1.0), viewProjection);
+    result.normal = normalize(float3(-heightX, 2.0 * spacing, -heightZ));
+
+    return result;
+}
+
+float4 PSMain(PSInput input) : SV_TARGET
+{
+    float lighting = saturate(dot(input.normal, normalize(float3(0.4, 1.0, 0.3))));
+    return float4(lighting.xxx * 0.8 + 0.2, 1.0);
+}
@@ -0,0 +1,185 @@
+#include "Assets/AssetLoader.h"
+
+#include "Core/Logger.h"
+
+#include <exception>
+
+namespace dxe
+{
+	AssetLoader::AssetLoader(IoScheduler* ioScheduler, ThreadPool* threadPool, EventRegistry* eventRegistry)
+		: ioScheduler(ioScheduler),
+		threadPool(threadPool),
+		eventRegistry(eventRegistry)
+	{
+		assert(ioScheduler && threadPool && eventRegistry && "Asset Loader dependencies were 'nullptr'!");
+	}
+	AssetLoader::~AssetLoader()
+	{
+		WaitIdle();
+	}
+
+	void AssetLoader::Load(AssetRequest request)
+	{
+		stats.requestedCount++;
+		if (request.priority == AssetLoadPriority::CRITICAL)
+			criticalPendingCount++;
+
+		{
+			std::lock_guard<std::mutex> lock{ decodedAssetsMutex };
+			inFlightCount++;
+		}
+
+		if (request.path.empty())
+		{
+			threadPool->Execute([this, request = std::move(request)]() mutable {
+				std::vector<uint8_t> noFileData;
+				Decode(request, noFileData);
+			});
+			return;
+		}
+
+		IoReadRequest readRequest{};
+		readRequest.path = request.path;
+		readRequest.priority = request.priority == AssetLoadPriority::CRITICAL ? IoPriority::CRITICAL : IoPriority::LOW;
+
+		// Decoding is moved off the I/O threads so that they can keep the device busy.
+		readRequest.onComplete = [this, request = std::move(request)](IoReadResult& result) mutable {
+			if (!result.succeeded)
+			{
+				FailDecode(request, result.errorMessage);
+				return;
+			}
+
+			threadPool->Execute(
+				[this, request = std::move(request), fileData = std::move(result.data)]() mutable {
+					Decode(request, fileData);
+				});
+		};
+
+		ioScheduler->Read(std::move(readRequest));
+	}
+
+	void AssetLoader::Tick()
+	{
+		std::vector<DecodedAsset> readyAssets;
+		{
+			std::lock_guard<std::mutex> lock{ decodedAssetsMutex };
+			readyAssets.swap(decodedAssets);
+		}
+
+		if (readyAssets.empty())
+			return;
+
+		for (DecodedAsset& decodedAsset : readyAssets)
+		{
+			FinalizeAsset(decodedAsset);
+		}
+
+		bool criticalSetCompleted = std::any_of(readyAssets.begin(), readyAssets.end(),
+			[](const DecodedAsset& decodedAsset) {
+				return decodedAsset.request.priority == AssetLoadPriority::CRITICAL;
+			}) && criticalPendingCount == 0;
+
+		if (criticalSetCompleted)
+		{
+			CriticalAssetsLoadedCallbackData callbackData{};
+			callbackData.loadedAssetCount = criticalLoadedCount;
+			callbackData.failedAssetCount = criticalFailedCount;
+			eventRegistry->NotifyCallbackEventDelayed(callbackData);
+
+			criticalLoadedCount = 0;
+			criticalFailedCount = 0;
+		}
+	}
+
+	void AssetLoader::WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock{ decodedAssetsMutex };
+		decodedAssetsCondition.wait(lock, [this]() {
+			return inFlightCount == 0;
+		});
+	}
+
+	bool AssetLoader::CriticalAssetsPending() const
+	{
+		return criticalPendingCount > 0;
+	}
+
+	AssetLoaderStats AssetLoader::GetStats() const
+	{
+		return stats;
+	}
+
+	void AssetLoader::Decode(AssetRequest& request, std::vector<uint8_t>& fileData)
+	{
+		DecodedAsset decodedAsset{};
+
+		try
+		{
+			if (request.decode)
+				request.decode(fileData);
+			decodedAsset.succeeded = true;
+		}
+		catch (std::exception& e)
+		{
+			decodedAsset.errorMessage = e.what();
+		}
+
+		decodedAsset.request = std::move(request);
+		PushDecodedAsset(std::move(decodedAsset));
+	}
+	void AssetLoader::FailDecode(AssetRequest& request, const std::string& errorMessage)
+	{
+		DecodedAsset decodedAsset{};
+		decodedAsset.request = std::move(request);
+		decodedAsset.errorMessage = errorMessage;
+		PushDecodedAsset(std::move(decodedAsset));
+	}
+
+	void AssetLoader::PushDecodedAsset(DecodedAsset decodedAsset)
+	{
+		// Notified under the lock: once 'WaitIdle' sees the last asset, the loader may be destroyed,
+		// condition variable included.
+		std::lock_guard<std::mutex> lock{ decodedAssetsMutex };
+		decodedAssets.push_back(std::move(decodedAsset));
+		inFlightCount--;
+		decodedAssetsCondition.notify_all();
+	}
+
+	void AssetLoader::FinalizeAsset(DecodedAsset& decodedAsset)
+	{
+		AssetRequest& request = decodedAsset.request;
+
+		if (decodedAsset.succeeded && request.finalize)
+		{
+			try
+			{
+				request.finalize();
+			}
+			catch (std::exception& e)
+			{
+				decodedAsset.succeeded = false;
+				decodedAsset.errorMessage = e.what();
+			}
+		}
+
+		bool critical = request.priority == AssetLoadPriority::CRITICAL;
+		if (critical)
+			criticalPendingCount--;
+
+		if (decodedAsset.succeeded)
+		{
+			stats.loadedCount++;
+			if (critical)
+				criticalLoadedCount++;
+		}
+		else
+		{
+			stats.failedCount++;
+			if (critical)
+				criticalFailedCount++;
+
+			Logger::Error("Failed to load the '{}' asset: {}", request.name, decodedAsset.errorMessage);
+		}
+	}
+}
\ No newline at end of file
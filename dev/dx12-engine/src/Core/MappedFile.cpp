@@ -0,0 +1,164 @@
+#include "Core/MappedFile.h"
+
+#include "Core/Error.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace dxe
+{
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& move) NOEXCEPT
+	{
+		Swap(move);
+	}
+	MappedFile& MappedFile::operator=(MappedFile&& move) NOEXCEPT
+	{
+		if (this != &move)
+		{
+			Close();
+			Swap(move);
+		}
+		return *this;
+	}
+
+#if defined(_WIN32)
+
+	void MappedFile::Open(const std::filesystem::path& filePath)
+	{
+		Close();
+
+		HANDLE file = CreateFileW(
+			filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw WinAPIError(THIS_FILE, THIS_FUNCTION, THIS_LINE, "Couldn't open the file for mapping!");
+		fileHandle = file;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize))
+		{
+			Close();
+			throw WinAPIError(THIS_FILE, THIS_FUNCTION, THIS_LINE, "Couldn't query the file size!");
+		}
+		size = static_cast<size_t>(fileSize.QuadPart);
+
+		// Empty files can't be mapped, but they're still valid (empty) files.
+		if (size == 0)
+			return;
+
+		mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mappingHandle == NULL)
+		{
+			Close();
+			throw WinAPIError(THIS_FILE, THIS_FUNCTION, THIS_LINE, "Couldn't create a file mapping!");
+		}
+
+		data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr)
+		{
+			Close();
+			throw WinAPIError(THIS_FILE, THIS_FUNCTION, THIS_LINE, "Couldn't map a view of the file!");
+		}
+	}
+	void MappedFile::Close()
+	{
+		if (data)
+			UnmapViewOfFile(data);
+		if (mappingHandle)
+			CloseHandle(mappingHandle);
+		if (fileHandle)
+			CloseHandle(fileHandle);
+
+		data = nullptr;
+		size = 0;
+		mappingHandle = nullptr;
+		fileHandle = nullptr;
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+		return fileHandle != nullptr;
+	}
+
+#else
+
+	void MappedFile::Open(const std::filesystem::path& filePath)
+	{
+		Close();
+
+		fileDescriptor = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fileDescriptor < 0)
+			throw Error{ "Couldn't open the file for mapping: " + filePath.string() };
+
+		struct stat fileStat{};
+		if (fstat(fileDescriptor, &fileStat) != 0)
+		{
+			Close();
+			throw Error{ "Couldn't query the file size: " + filePath.string() };
+		}
+		size = static_cast<size_t>(fileStat.st_size);
+
+		if (size == 0)
+			return;
+
+		void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (mapping == MAP_FAILED)
+		{
+			Close();
+			throw Error{ "Couldn't map the file: " + filePath.string() };
+		}
+		data = static_cast<const uint8_t*>(mapping);
+	}
+	void MappedFile::Close()
+	{
+		if (data)
+			munmap(const_cast<uint8_t*>(data), size);
+		if (fileDescriptor >= 0)
+			close(fileDescriptor);
+
+		data = nullptr;
+		size = 0;
+		fileDescriptor = -1;
+	}
+
+	bool MappedFile::IsOpen() const
+	{
+		return fileDescriptor >= 0;
+	}
+
+#endif
+
+	const uint8_t* MappedFile::GetData() const
+	{
+		return data;
+	}
+	size_t MappedFile::GetSize() const
+	{
+		return size;
+	}
+
+	void MappedFile::Swap(MappedFile& other) NOEXCEPT
+	{
+		std::swap(data, other.data);
+		std::swap(size, other.size);
+#if defined(_WIN32)
+		std::swap(fileHandle, other.fileHandle);
+		std::swap(mappingHandle, other.mappingHandle);
+#else
+		std::swap(fileDescriptor, other.fileDescriptor);
+#endif
+	}
+}
\ No newline at end of file
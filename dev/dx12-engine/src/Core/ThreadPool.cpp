@@ -0,0 +1,138 @@
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace dxe
+{
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		if (threadCount == 0)
+		{
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		workers.reserve(threadCount);
+		for (uint32_t threadIdx = 0; threadIdx < threadCount; threadIdx++)
+		{
+			workers.emplace_back(&ThreadPool::WorkerLoop, this);
+		}
+	}
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ tasksMutex };
+			stopRequested = true;
+		}
+		tasksCondition.notify_all();
+
+		for (std::thread& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	void ThreadPool::Execute(Task task)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ tasksMutex };
+			tasks.push(std::move(task));
+		}
+		tasksCondition.notify_one();
+	}
+
+	void ThreadPool::ParallelFor(uint32_t begin, uint32_t end, uint32_t grainSize, const RangeBody& body)
+	{
+		if (begin >= end)
+			return;
+
+		grainSize = std::max(grainSize, 1u);
+		uint32_t chunkCount = (end - begin + grainSize - 1) / grainSize;
+
+		if (chunkCount == 1)
+		{
+			body(begin, end);
+			return;
+		}
+
+		// Chunks are claimed through a shared counter by whoever gets there first.
+		// Helper tasks that start after all chunks were claimed simply return.
+
+		struct ParallelForState
+		{
+			std::atomic<uint32_t> nextChunk{ 0 };
+			std::atomic<uint32_t> finishedChunks{ 0 };
+			std::mutex doneMutex;
+			std::condition_variable doneCondition;
+		};
+
+		auto state = std::make_shared<ParallelForState>();
+
+		auto runChunks = [state, begin, end, grainSize, chunkCount, &body]()
+		{
+			uint32_t chunk{ 0 };
+			while ((chunk = state->nextChunk.fetch_add(1)) < chunkCount)
+			{
+				uint32_t chunkBegin = begin + chunk * grainSize;
+				uint32_t chunkEnd = std::min(chunkBegin + grainSize, end);
+				body(chunkBegin, chunkEnd);
+
+				if (state->finishedChunks.fetch_add(1) + 1 == chunkCount)
+				{
+					std::lock_guard<std::mutex> lock{ state->doneMutex };
+					state->doneCondition.notify_all();
+				}
+			}
+		};
+
+		uint32_t helperCount = std::min(chunkCount - 1, GetThreadCount());
+		for (uint32_t helperIdx = 0; helperIdx < helperCount; helperIdx++)
+		{
+			Execute(runChunks);
+		}
+
+		runChunks();
+
+		std::unique_lock<std::mutex> lock{ state->doneMutex };
+		state->doneCondition.wait(lock, [&state, chunkCount]() {
+			return state->finishedChunks.load() == chunkCount;
+		});
+	}
+
+	void ThreadPool::ParallelForOrInline(ThreadPool* threadPool, uint32_t begin, uint32_t end, uint32_t grainSize, const RangeBody& body)
+	{
+		if (threadPool)
+			threadPool->ParallelFor(begin, end, grainSize, body);
+		else if (begin < end)
+			body(begin, end);
+	}
+
+	uint32_t ThreadPool::GetThreadCount() const
+	{
+		return static_cast<uint32_t>(workers.size());
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			Task task;
+
+			{
+				std::unique_lock<std::mutex> lock{ tasksMutex };
+				tasksCondition.wait(lock, [this]() {
+					return stopRequested || !tasks.empty();
+				});
+
+				if (stopRequested && tasks.empty())
+					return;
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			task();
+		}
+	}
+}
\ No newline at end of file
@@ -8,7 +8,9 @@
 #include "GpuApi/Dx12/Dx12GpuApi.h"
 #include "GpuApi/Dx12/Dx12Queue.h"
 #include "GpuApi/Dx12/Dx12ResourceManager.h"
+#include "GpuApi/Dx12/Dx12SwapChain.h"
 
+#include "Renderer/Color.h"
 #include "Renderer/Vertex.h"
 #include "Renderer/Dx12/Dx12Renderer.h"
 #include "Renderer/Dx12/Dx12Vertex.h"
@@ -28,9 +30,13 @@ namespace dxe
 		eventRegistry = std::make_shared<EventRegistry>();
 		eventRegistry->RegisterCallback<dxe::WindowCloseCallbackData>(
 			std::bind(&Dx12App::OnWindowClose, this, std::placeholders::_1));
+		eventRegistry->RegisterCallback<dxe::CriticalAssetsLoadedCallbackData>(
+			std::bind(&Dx12App::OnCriticalAssetsLoaded, this, std::placeholders::_1));
 
 		InitializeWindow();
 		InitializeDx12();
+		InitializeAssetLoading();
+		InitializeMeshStreaming();
 
 		LoadAssets();
 
@@ -38,6 +44,14 @@ namespace dxe
 	}
 	void Dx12App::Terminate()
 	{
+		// Workers may still hold pointers into the app, so they go first.
+		assetLoader.reset();
+		ioScheduler.reset();
+		threadPool.reset();
+
+		lodStreamer.reset();
+		lodLoader.reset();
+
 		TerminateDx12();
 		window.reset();
 		eventRegistry.reset();
@@ -50,9 +64,15 @@ namespace dxe
 		while (appIsRunning)
 		{
 			window->Tick();
+			assetLoader->Tick();
 			eventRegistry->Tick();
 
-			Render();
+			// Nothing to draw with until the critical assets are resident.
+			if (criticalAssetsLoaded)
+			{
+				lodStreamer->Update(cameraPosition);
+				Render();
+			}
 		}
 
 		// Logger::Info("Done!");
@@ -73,28 +93,127 @@ namespace dxe
 		Logger::Info("Win32 window initialization complete!");
 	}
 
-	void Dx12App::LoadAssets()
+	void Dx12App::InitializeAssetLoading()
+	{
+		threadPool = std::make_shared<ThreadPool>();
+		ioScheduler = std::make_shared<IoScheduler>();
+		assetLoader = std::make_shared<AssetLoader>(ioScheduler.get(), threadPool.get(), eventRegistry.get());
+	}
+
+	void Dx12App::InitializeMeshStreaming()
 	{
 		Dx12GpuData* gpuData = GetDx12GpuData();
 
-		// Create Vertex and Index buffers
+		lodLoader = std::make_unique<Dx12MeshLodLoader>(
+			gpuData->resourceManager->GetGeometryBuffer(), threadPool.get());
+		lodStreamer = std::make_unique<MeshLodStreamer>(MeshLodStreamerSettings{}, lodLoader.get());
+		lodLoader->SetStreamer(lodStreamer.get());
+	}
 
-		std::vector<VertexPC> vertices
-		{
-			{ { -0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
-			{ {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
-			{ {  0.0f,  0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f } }
+	void Dx12App::LoadAssets()
+	{
+		// Progressive triangle mesh: LOD 0 is the triangle, LOD 1 appends its edge midpoints and the
+		// four triangles they split it into, drawn over it.
+
+		auto lods = std::make_shared<std::vector<Dx12MeshLodData>>();
+
+		AssetRequest meshRequest{};
+		meshRequest.name = "triangle_mesh";
+		meshRequest.priority = AssetLoadPriority::CRITICAL;
+		meshRequest.decode = [lods](std::vector<uint8_t>&) {
+			std::vector<VertexPC> triangleVertices{
+				{ { -0.5f, -0.5f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+				{ {  0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } },
+				{ {  0.0f,  0.5f, 0.0f }, { 1.0f, 0.0f, 0.0f } }
+			};
+			std::vector<VertexPC> midpointVertices{
+				{ {  0.0f,  -0.5f, 0.0f }, { 1.0f, 1.0f, 1.0f } },
+				{ {  0.25f,  0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } },
+				{ { -0.25f,  0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } }
+			};
+
+			// Vertex colors are authored in sRGB. They're interpolated in linear space and the back
+			// buffer's sRGB view encodes the shaded result again.
+			auto toBytes = [](std::vector<VertexPC>& vertices) {
+				std::vector<DirectX::XMFLOAT3> colors(vertices.size());
+				for (size_t vertex = 0; vertex < vertices.size(); vertex++)
+					colors[vertex] = vertices[vertex].vertexColor;
+				ConvertVertexColorsToLinear(colors.data(), colors.size());
+				for (size_t vertex = 0; vertex < vertices.size(); vertex++)
+					vertices[vertex].vertexColor = colors[vertex];
+
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(vertices.data());
+				return std::vector<uint8_t>(bytes, bytes + vertices.size() * VertexPC::stride);
+			};
+
+			lods->resize(2);
+			(*lods)[0].vertices = toBytes(triangleVertices);
+			(*lods)[0].indices = { 0, 1, 2 };
+			(*lods)[1].vertices = toBytes(midpointVertices);
+			(*lods)[1].indices = { 0, 3, 5, 3, 1, 4, 5, 4, 2, 3, 4, 5 };
+		};
+		meshRequest.finalize = [this, lods]() {
+			std::vector<StreamingMeshLod> streamingLods(lods->size());
+			for (size_t lodIndex = 0; lodIndex < lods->size(); lodIndex++)
+			{
+				const Dx12MeshLodData& lod = (*lods)[lodIndex];
+				streamingLods[lodIndex].gpuBytes = lod.vertices.size() + lod.indices.size() * sizeof(uint32_t);
+			}
+			// The coarse triangle misses the midpoints' colors.
+			streamingLods[0].geometricError = 0.05f;
+
+			streamingMeshId = lodStreamer->AddMesh(DirectX::XMFLOAT3{ 0.0f, 0.0f, 0.0f }, 0.5f, streamingLods);
+
+			// The LODs are already in memory, the source hands them out like a file read would.
+			lodLoader->AddMesh(streamingMeshId, VertexPC::stride, [lods](uint32_t lodIndex, Dx12MeshLodData& lodData) {
+				if (lodIndex >= lods->size())
+					return false;
+				lodData = (*lods)[lodIndex];
+				return true;
+			});
 		};
 
-		std::shared_ptr<Dx12Mesh> mesh = std::make_shared<Dx12Mesh>();
-		mesh->CreateMesh(gpuData->device->GetDevice(), vertices);
+		assetLoader->Load(std::move(meshRequest));
 
-		meshId = gpuData->resourceManager->meshes.AddResource(mesh);
+		// Shaders
+
+		vertexShader.shaderPath = std::filesystem::path{ L"resource/shaders/color_shader.hlsl" };
+		vertexShader.entryPoint = std::string{ "VSMain" };
+		vertexShader.shaderType = SHADER_TYPE::VERTEX_SHADER;
+
+		AssetRequest vertexShaderRequest{};
+		vertexShaderRequest.name = "color_shader_vs";
+		vertexShaderRequest.path = vertexShader.shaderPath;
+		vertexShaderRequest.priority = AssetLoadPriority::CRITICAL;
+		vertexShaderRequest.decode = [this](std::vector<uint8_t>& fileData) {
+			Dx12ShaderFactory::CreateVertexShader(vertexShader, fileData);
+		};
+
+		assetLoader->Load(std::move(vertexShaderRequest));
+
+		pixelShader.shaderPath = std::filesystem::path{ "resource/shaders/color_shader.hlsl" };
+		pixelShader.entryPoint = std::string{ "PSMain" };
+		pixelShader.shaderType = SHADER_TYPE::FRAGMENT_SHADER;
+
+		AssetRequest pixelShaderRequest{};
+		pixelShaderRequest.name = "color_shader_ps";
+		pixelShaderRequest.path = pixelShader.shaderPath;
+		pixelShaderRequest.priority = AssetLoadPriority::CRITICAL;
+		pixelShaderRequest.decode = [this](std::vector<uint8_t>& fileData) {
+			Dx12ShaderFactory::CreatePixelShader(pixelShader, fileData);
+		};
+
+		assetLoader->Load(std::move(pixelShaderRequest));
+	}
+
+	void Dx12App::CreatePipelineState()
+	{
+		Dx12GpuData* gpuData = GetDx12GpuData();
 
 		// Create Root Signature
 
 		std::shared_ptr<Dx12RootSignature> rootSignature = std::make_shared<Dx12RootSignature>();
-		rootSignature->CreateRootSignature(gpuData->device->GetDevice());
+		rootSignature->CreateBindlessRootSignature(gpuData->device->GetDevice());
 
 		rootSignatureId = gpuData->resourceManager->rootSignatures.AddResource(rootSignature);
 
@@ -104,22 +223,6 @@ namespace dxe
 
 		graphicsPSO->SetRootSignature(rootSignature);
 
-		// Shaders
-
-		Dx12ShaderData vertexShader{};
-		vertexShader.shaderPath = std::filesystem::path{ L"resource/shaders/color_shader.hlsl" };
-		vertexShader.entryPoint = std::string{ "VSMain" };
-		vertexShader.shaderType = SHADER_TYPE::VERTEX_SHADER;
-
-		Dx12ShaderFactory::CreateVertexShader(vertexShader);
-
-		Dx12ShaderData fragmentShader;
-		fragmentShader.shaderPath = std::filesystem::path{ "resource/shaders/color_shader.hlsl" };
-		fragmentShader.entryPoint = std::string{ "PSMain" };
-		fragmentShader.shaderType = SHADER_TYPE::FRAGMENT_SHADER;
-
-		Dx12ShaderFactory::CreatePixelShader(fragmentShader);
-
 		// Input Layout
 
 		graphicsPSO->SetInputLayout(VertexAttribLayoutToDx12AttribLayout(VertexPC::attributes));
@@ -127,7 +230,7 @@ namespace dxe
 		// Fixed function states
 
 		graphicsPSO->SetVertexShader(vertexShader);
-		graphicsPSO->SetPixelShader(fragmentShader);
+		graphicsPSO->SetPixelShader(pixelShader);
 
 		graphicsPSO->SetRasterizerState(Dx12GraphicsPSO::CreateDefaultRasterizerState());
 		graphicsPSO->SetBlendState(Dx12GraphicsPSO::CreateDefaultBlendState());
@@ -135,7 +238,7 @@ namespace dxe
 		graphicsPSO->SetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE);
 
 		graphicsPSO->SetRTVCount(1);
-		graphicsPSO->SetRTVFormat(DXGI_FORMAT_R8G8B8A8_UNORM, 0);
+		graphicsPSO->SetRTVFormat(gpuData->swapChain->GetRtvFormat(), 0);
 
 		graphicsPSO->SetDepthStencilState(Dx12GraphicsPSO::CreateNoDepthNoStencilDepthStencilDesc());
 
@@ -151,14 +254,14 @@ namespace dxe
 	void Dx12App::Render()
 	{
 		RenderData renderData{};
-		renderData.meshId = meshId;
+		renderData.streamingMeshIds = { streamingMeshId };
+		renderData.lodStreamer = lodStreamer.get();
+		renderData.lodLoader = lodLoader.get();
 		renderData.rootSignatureId = rootSignatureId;
 		renderData.graphicsPSOId = graphicsPSOId;
 
 		Dx12GpuData* gpuData = GetDx12GpuData();
 		gpuData->renderer->Render(renderData);
-
-		gpuData->commandManager->GetDirectQueue()->FlushQueue();
 	}
 
 	void Dx12App::OnWindowClose(const WindowCloseCallbackData& callbackData)
@@ -166,4 +269,18 @@ namespace dxe
 		Logger::Info("Closing the application...");
 		appIsRunning = false;
 	}
+	void Dx12App::OnCriticalAssetsLoaded(const CriticalAssetsLoadedCallbackData& callbackData)
+	{
+		if (callbackData.failedAssetCount > 0)
+		{
+			Logger::Error("Failed to load {} critical asset(s), closing the application...", callbackData.failedAssetCount);
+			appIsRunning = false;
+			return;
+		}
+
+		Logger::Info("Critical assets loaded!");
+
+		CreatePipelineState();
+		criticalAssetsLoaded = true;
+	}
 }
\ No newline at end of file
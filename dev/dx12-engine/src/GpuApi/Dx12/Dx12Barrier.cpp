@@ -19,6 +19,15 @@ namespace dxe
         return resourceBarrier;
     }
 
+    D3D12_RESOURCE_BARRIER Dx12Barrier::CreateUavBarrier(ID3D12Resource* pResource)
+    {
+        D3D12_RESOURCE_BARRIER resourceBarrier{};
+        resourceBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+        resourceBarrier.UAV.pResource = pResource;
+        resourceBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        return resourceBarrier;
+    }
+
     D3D12_RESOURCE_BARRIER Dx12Barrier::CreateRenderTargetToPresentTransitionBarrier(
         ID3D12Resource* pResource,
         UINT subresource,
@@ -0,0 +1,88 @@
+#include "GpuApi/Dx12/Dx12BindlessTable.h"
+
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include "Core/Error.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	Dx12BindlessTable::Dx12BindlessTable(
+		ID3D12Device* device,
+		Dx12DescriptorHeap* heap,
+		Dx12Fence* fence,
+		uint32_t firstDescriptor,
+		uint32_t descriptorCount)
+		: device(device),
+		heap(heap),
+		fence(fence),
+		firstDescriptor(firstDescriptor),
+		indices(descriptorCount)
+	{
+		assert(device && heap && fence && "Bindless table needs a device, a heap and a fence!");
+		assert(heap->IsShaderVisible() && "Bindless table has to be in a shader visible heap!");
+		assert(heap->GetDescriptorHeapType() == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV &&
+			"Bindless table has to be in a CBV/SRV/UAV heap!");
+		assert(static_cast<size_t>(firstDescriptor) + descriptorCount <= heap->GetDescriptorCount() &&
+			"Descriptor range is out of the heap's bounds!");
+	}
+
+	uint32_t Dx12BindlessTable::CreateShaderResourceView(ID3D12Resource* resource, const D3D12_SHADER_RESOURCE_VIEW_DESC* srvDesc)
+	{
+		uint32_t index = AllocateIndex();
+		device->CreateShaderResourceView(resource, srvDesc, GetCpuHandle(index));
+		return index;
+	}
+	uint32_t Dx12BindlessTable::CopyDescriptor(D3D12_CPU_DESCRIPTOR_HANDLE sourceDescriptor)
+	{
+		uint32_t index = AllocateIndex();
+		device->CopyDescriptorsSimple(1, GetCpuHandle(index), sourceDescriptor, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		return index;
+	}
+
+	void Dx12BindlessTable::Free(uint32_t index)
+	{
+		indices.Free(index, fence->GetValue() + 1);
+	}
+	void Dx12BindlessTable::Retire()
+	{
+		indices.Retire(fence->GetCompletedValue());
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE Dx12BindlessTable::GetGpuHandle() const
+	{
+		return heap->GetGpuDescriptorHandle(firstDescriptor);
+	}
+	D3D12_CPU_DESCRIPTOR_HANDLE Dx12BindlessTable::GetCpuHandle(uint32_t index) const
+	{
+		assert(index < indices.GetCapacity() && "Invalid bindless index!");
+		return heap->GetDescriptorHandle(static_cast<size_t>(firstDescriptor) + index);
+	}
+
+	IndexStatistics Dx12BindlessTable::GetStatistics() const
+	{
+		return indices.GetStatistics();
+	}
+
+	Dx12DescriptorHeap* Dx12BindlessTable::GetHeap() const
+	{
+		return heap;
+	}
+
+	uint32_t Dx12BindlessTable::AllocateIndex()
+	{
+		// Indices the GPU is done with are reused before the table counts as full.
+		uint32_t index = indices.Allocate();
+		if (index == INDEX_INVALID)
+		{
+			Retire();
+			index = indices.Allocate();
+		}
+
+		if (index == INDEX_INVALID)
+			throw Error{ "Bindless descriptor table is full!" };
+
+		return index;
+	}
+}
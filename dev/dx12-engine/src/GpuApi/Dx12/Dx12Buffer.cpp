@@ -1,32 +1,62 @@
 #include "GpuApi/Dx12/Dx12Buffer.h"
 
+#include "GpuApi/Dx12/Dx12UploadQueue.h"
+
 #include "Core/Error.h"
 #include "Core/Logger.h"
 
 namespace dxe
 {
+	D3D12_RESOURCE_DESC CreateBufferResourceDesc(uint64_t bufferSize)
+	{
+		D3D12_RESOURCE_DESC resourceDesc{};
+		resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		resourceDesc.Alignment = 0; // Must be 64KB for Buffers; 0 is an alias for 64KB
+		resourceDesc.Width = bufferSize;
+		resourceDesc.Height = 1;
+		resourceDesc.DepthOrArraySize = 1;
+		resourceDesc.MipLevels = 1;
+		resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+		resourceDesc.SampleDesc.Count = 1;
+		resourceDesc.SampleDesc.Quality = 0;
+		resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+		resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+		return resourceDesc;
+	}
+
+	static void WriteBufferData(ID3D12Resource* buffer, const Dx12BufferDataDesc& dataDesc, Dx12UploadQueue* uploadQueue)
+	{
+		if (uploadQueue)
+		{
+			uploadQueue->UploadBuffer(buffer, 0, dataDesc.srcDataPtr, dataDesc.bufferSize);
+			return;
+		}
+
+		UINT8* bufferDataPtr{ nullptr };
+		D3D12_RANGE readRange{ 0, 0 };
+
+		DX12_THROW_IF_NOT_SUCCESS(
+			buffer->Map(
+				0, &readRange, reinterpret_cast<void**>(&bufferDataPtr)),
+			"Failed to map the Buffer!");
+
+		memcpy(bufferDataPtr, dataDesc.srcDataPtr, dataDesc.bufferSize);
+		buffer->Unmap(0, nullptr);
+	}
+
 	void Dx12VertexBuffer::CreateVertexBuffer(
 		ID3D12Device* device,
 		ID3D12Heap* heap,
-		Dx12BufferDataDesc& dataDesc)
+		Dx12BufferDataDesc& dataDesc,
+		Dx12UploadQueue* uploadQueue)
 	{
 		this->vertexCount = dataDesc.bufferSize / dataDesc.elementSize;
 
-		D3D12_RESOURCE_DESC vbResourceDesc{};
-		vbResourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		vbResourceDesc.Alignment = 0; // Must be 64KB for Buffers; 0 is an alias for 64KB
-		vbResourceDesc.Width = dataDesc.bufferSize;
-		vbResourceDesc.Height = 1;
-		vbResourceDesc.DepthOrArraySize = 1;
-		vbResourceDesc.MipLevels = 1;
-		vbResourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-		vbResourceDesc.SampleDesc.Count = 1;
-		vbResourceDesc.SampleDesc.Quality = 0;
-		vbResourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		vbResourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+		D3D12_RESOURCE_DESC vbResourceDesc = CreateBufferResourceDesc(dataDesc.bufferSize);
 
 		// D3D12_RESOURCE_STATES initialResourceState = D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER;
-		D3D12_RESOURCE_STATES initialResourceState = D3D12_RESOURCE_STATE_GENERIC_READ;
+		D3D12_RESOURCE_STATES initialResourceState =
+			uploadQueue ? D3D12_RESOURCE_STATE_COMMON : D3D12_RESOURCE_STATE_GENERIC_READ;
 
 		DX12_THROW_IF_NOT_SUCCESS(
 			device->CreatePlacedResource(
@@ -39,16 +69,7 @@ namespace dxe
 
 		// Copy the data to the vertex buffer
 
-		UINT8* vertexBufferDataPtr{ nullptr };
-		D3D12_RANGE readRange{ 0, 0 };
-
-		DX12_THROW_IF_NOT_SUCCESS(
-			vertexBuffer->Map(
-				0, &readRange, reinterpret_cast<void**>(&vertexBufferDataPtr)),
-			"Failed to map the Vertex Buffer!");
-
-		memcpy(vertexBufferDataPtr, dataDesc.srcDataPtr, dataDesc.bufferSize);
-		vertexBuffer->Unmap(0, nullptr);
+		WriteBufferData(vertexBuffer.Get(), dataDesc, uploadQueue);
 
 		// Initialize the vertex buffer view
 
@@ -74,25 +95,16 @@ namespace dxe
 	void Dx12IndexBuffer::CreateIndexBuffer(
 		ID3D12Device* device,
 		ID3D12Heap* heap,
-		Dx12BufferDataDesc& dataDesc)
+		Dx12BufferDataDesc& dataDesc,
+		Dx12UploadQueue* uploadQueue)
 	{
 		this->indexCount = dataDesc.bufferSize / dataDesc.elementSize;
 
-		D3D12_RESOURCE_DESC vbResourceDesc{};
-		vbResourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-		vbResourceDesc.Alignment = 0; // Must be 64KB for Buffers; 0 is an alias for 64KB
-		vbResourceDesc.Width = dataDesc.bufferSize;
-		vbResourceDesc.Height = 1;
-		vbResourceDesc.DepthOrArraySize = 1;
-		vbResourceDesc.MipLevels = 1;
-		vbResourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-		vbResourceDesc.SampleDesc.Count = 1;
-		vbResourceDesc.SampleDesc.Quality = 0;
-		vbResourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-		vbResourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+		D3D12_RESOURCE_DESC vbResourceDesc = CreateBufferResourceDesc(dataDesc.bufferSize);
 
 		// D3D12_RESOURCE_STATES initialResourceState = D3D12_RESOURCE_STATE_INDEX_BUFFER;
-		D3D12_RESOURCE_STATES initialResourceState = D3D12_RESOURCE_STATE_GENERIC_READ;
+		D3D12_RESOURCE_STATES initialResourceState =
+			uploadQueue ? D3D12_RESOURCE_STATE_COMMON : D3D12_RESOURCE_STATE_GENERIC_READ;
 
 		DX12_THROW_IF_NOT_SUCCESS(
 			device->CreatePlacedResource(
@@ -103,18 +115,9 @@ namespace dxe
 				IID_PPV_ARGS(indexBuffer.ReleaseAndGetAddressOf())),
 			"Failed to create a Vertex Buffer Placed Resource!");
 
-		// Copy the data to the vertex buffer
-
-		UINT8* vertexBufferDataPtr{ nullptr };
-		D3D12_RANGE readRange{ 0, 0 };
-
-		DX12_THROW_IF_NOT_SUCCESS(
-			indexBuffer->Map(
-				0, &readRange, reinterpret_cast<void**>(&vertexBufferDataPtr)),
-			"Failed to map the Vertex Buffer!");
+		// Copy the data to the index buffer
 
-		memcpy(vertexBufferDataPtr, dataDesc.srcDataPtr, dataDesc.bufferSize);
-		indexBuffer->Unmap(0, nullptr);
+		WriteBufferData(indexBuffer.Get(), dataDesc, uploadQueue);
 
 		// Initialize the vertex buffer view
 
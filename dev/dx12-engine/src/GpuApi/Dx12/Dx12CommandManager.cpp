@@ -26,9 +26,10 @@ namespace dxe
 		this->copyQueue.reset();
 	}
 
-	void Dx12CommandManager::CreateCommandContexts(ID3D12Device* device, uint32_t commandContextSlotCount)
+	void Dx12CommandManager::CreateCommandContexts(ID3D12Device* device, uint32_t frameLatency)
 	{
-		CreateGraphicsCommandContexts(device, commandContextSlotCount);
+		framePacer = FramePacer{ frameLatency };
+		CreateGraphicsCommandContexts(device, frameLatency);
 	}
 	void Dx12CommandManager::DestroyCommandContexts()
 	{
@@ -36,6 +37,38 @@ namespace dxe
 		// [TODO] Destroy Compute and Copy command contexts?
 	}
 
+	const Dx12GraphicsCommandContext* Dx12CommandManager::BeginFrame()
+	{
+		Dx12Fence* frameFence = directQueue->GetQueueFence();
+
+		uint64_t fenceValue = framePacer.BeginFrame(frameFence->GetCompletedValue());
+		if (fenceValue > 0)
+			frameFence->WaitForValue(fenceValue);
+
+		const Dx12GraphicsCommandContext* commandContext = &graphicsCommandContexts[framePacer.GetFrameSlot()];
+
+		DX12_THROW_IF_NOT_SUCCESS(
+			commandContext->commandAllocator->Reset(),
+			"Failed to reset the Command Allocator!");
+
+		commandContext->stateTracker->Reset();
+
+		return commandContext;
+	}
+	void Dx12CommandManager::EndFrame()
+	{
+		framePacer.EndFrame(directQueue->SignalFence(directQueue->GetQueueFence()));
+	}
+	void Dx12CommandManager::WaitForFrames()
+	{
+		directQueue->GetQueueFence()->WaitForValue(framePacer.GetLastFenceValue());
+	}
+
+	const FramePacer& Dx12CommandManager::GetFramePacer() const
+	{
+		return framePacer;
+	}
+
 	Dx12DirectQueue* Dx12CommandManager::GetDirectQueue() const
 	{
 		return directQueue.get();
@@ -93,6 +126,8 @@ namespace dxe
 			graphicsCommandContexts[slot].graphicsCommandList =
 				CreateGraphicsCommandList(
 					device, D3D12_COMMAND_LIST_TYPE_DIRECT, graphicsCommandContexts[slot].commandAllocator.Get());
+
+			graphicsCommandContexts[slot].stateTracker = std::make_unique<Dx12ResourceStateTracker>();
 		}
 	}
 	void Dx12CommandManager::DestroyGraphicsCommandContexts()
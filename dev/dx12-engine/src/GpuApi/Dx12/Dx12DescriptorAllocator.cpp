@@ -0,0 +1,56 @@
+#include "GpuApi/Dx12/Dx12DescriptorAllocator.h"
+
+#include "Core/Error.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	Dx12DescriptorAllocator::Dx12DescriptorAllocator(Dx12DescriptorHeap* heap, uint32_t firstDescriptor, uint32_t descriptorCount)
+		: heap(heap),
+		firstDescriptor(firstDescriptor),
+		ranges(descriptorCount)
+	{
+		assert(heap && "Descriptor allocator needs a heap!");
+		assert(static_cast<size_t>(firstDescriptor) + descriptorCount <= heap->GetDescriptorCount() &&
+			"Descriptor range is out of the heap's bounds!");
+	}
+
+	Dx12DescriptorAllocation Dx12DescriptorAllocator::Allocate(uint32_t count)
+	{
+		assert(count > 0 && "Can't allocate 0 descriptors!");
+
+		uint32_t handle = ranges.Allocate(count);
+		if (handle == RANGE_INVALID_HANDLE)
+			throw Error{ "Not enough contiguous descriptors left in the descriptor heap!" };
+
+		Dx12DescriptorAllocation allocation{};
+		allocation.index = firstDescriptor + static_cast<uint32_t>(ranges.GetOffset(handle));
+		allocation.count = count;
+		allocation.handle = handle;
+		allocation.cpuHandle = heap->GetDescriptorHandle(allocation.index);
+		if (heap->IsShaderVisible())
+			allocation.gpuHandle = heap->GetGpuDescriptorHandle(allocation.index);
+		allocation.descriptorSize = static_cast<uint32_t>(heap->GetDescriptorSize());
+		return allocation;
+	}
+
+	void Dx12DescriptorAllocator::Free(Dx12DescriptorAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+			return;
+
+		ranges.Free(allocation.handle);
+		allocation = Dx12DescriptorAllocation{};
+	}
+
+	RangeStatistics Dx12DescriptorAllocator::GetStatistics() const
+	{
+		return ranges.GetStatistics();
+	}
+
+	Dx12DescriptorHeap* Dx12DescriptorAllocator::GetHeap() const
+	{
+		return heap;
+	}
+}
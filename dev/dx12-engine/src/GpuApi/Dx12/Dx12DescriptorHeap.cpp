@@ -31,6 +31,8 @@ namespace dxe
 
 		descriptorSize = device->GetDescriptorHandleIncrementSize(descriptorHeapType);
 		heapStartHandle = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
+		if (IsShaderVisible())
+			gpuHeapStartHandle = descriptorHeap->GetGPUDescriptorHandleForHeapStart();
 	}
 
 	D3D12_CPU_DESCRIPTOR_HANDLE Dx12DescriptorHeap::GetDescriptorHandle(size_t descriptorIndex)
@@ -43,4 +45,34 @@ namespace dxe
 		heapHandle.ptr += idx * descriptorSize;
 		return heapHandle;
 	}
+	D3D12_GPU_DESCRIPTOR_HANDLE Dx12DescriptorHeap::GetGpuDescriptorHandle(size_t descriptorIndex)
+	{
+		assert(descriptorIndex < descriptorCount && "Invalid descriptor index was provided!");
+		assert(IsShaderVisible() && "Only shader visible descriptor heaps have GPU handles!");
+
+		D3D12_GPU_DESCRIPTOR_HANDLE heapHandle = gpuHeapStartHandle;
+		heapHandle.ptr += descriptorIndex * descriptorSize;
+		return heapHandle;
+	}
+
+	ID3D12DescriptorHeap* Dx12DescriptorHeap::GetDescriptorHeap() const
+	{
+		return descriptorHeap.Get();
+	}
+	size_t Dx12DescriptorHeap::GetDescriptorCount() const
+	{
+		return descriptorCount;
+	}
+	size_t Dx12DescriptorHeap::GetDescriptorSize() const
+	{
+		return descriptorSize;
+	}
+	D3D12_DESCRIPTOR_HEAP_TYPE Dx12DescriptorHeap::GetDescriptorHeapType() const
+	{
+		return descriptorHeapType;
+	}
+	bool Dx12DescriptorHeap::IsShaderVisible() const
+	{
+		return (descriptorHeapFlags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) != 0;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "GpuApi/Dx12/Dx12DescriptorRing.h"
+
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include "Core/Error.h"
+#include "Core/Logger.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	Dx12DescriptorRing::Dx12DescriptorRing(
+		ID3D12Device* device,
+		Dx12DescriptorHeap* heap,
+		Dx12Fence* fence,
+		uint32_t firstDescriptor,
+		uint32_t descriptorCount)
+		: device(device),
+		heap(heap),
+		fence(fence),
+		firstDescriptor(firstDescriptor),
+		ring(descriptorCount)
+	{
+		assert(device && heap && fence && "Descriptor ring needs a device, a heap and a fence!");
+		assert(heap->IsShaderVisible() && "Descriptor ring has to be in a shader visible heap!");
+		assert(static_cast<size_t>(firstDescriptor) + descriptorCount <= heap->GetDescriptorCount() &&
+			"Descriptor range is out of the heap's bounds!");
+	}
+
+	Dx12DescriptorAllocation Dx12DescriptorRing::Allocate(uint32_t count)
+	{
+		assert(count > 0 && "Can't allocate 0 descriptors!");
+
+		if (!ring.CanAllocate(count))
+			ring.Retire(fence->GetCompletedValue());
+
+		// Full with tables the GPU hasn't finished with: a stall.
+		while (!ring.CanAllocate(count))
+		{
+			if (!ring.HasPendingBatches())
+				throw Error{ "Descriptor ring is too small for the allocation!" };
+
+			uint64_t fenceValue = ring.GetOldestPendingFenceValue();
+			Logger::Warn("Descriptor ring is full, waiting for the GPU to reach fence value {}.", fenceValue);
+			stallCount++;
+
+			fence->WaitForValue(fenceValue);
+			ring.Retire(fence->GetCompletedValue());
+		}
+
+		uint64_t offset = ring.Allocate(count);
+
+		Dx12DescriptorAllocation allocation{};
+		allocation.index = firstDescriptor + static_cast<uint32_t>(offset);
+		allocation.count = count;
+		allocation.cpuHandle = heap->GetDescriptorHandle(allocation.index);
+		allocation.gpuHandle = heap->GetGpuDescriptorHandle(allocation.index);
+		allocation.descriptorSize = static_cast<uint32_t>(heap->GetDescriptorSize());
+		return allocation;
+	}
+
+	Dx12DescriptorAllocation Dx12DescriptorRing::AllocateTable(const std::vector<D3D12_CPU_DESCRIPTOR_HANDLE>& sourceDescriptors)
+	{
+		Dx12DescriptorAllocation table = Allocate(static_cast<uint32_t>(sourceDescriptors.size()));
+
+		for (uint32_t descriptorIndex = 0; descriptorIndex < table.count; descriptorIndex++)
+		{
+			device->CopyDescriptorsSimple(
+				1, table.GetCpuHandle(descriptorIndex),
+				sourceDescriptors[descriptorIndex],
+				heap->GetDescriptorHeapType());
+		}
+
+		return table;
+	}
+
+	void Dx12DescriptorRing::Submit(uint64_t fenceValue)
+	{
+		ring.Submit(fenceValue);
+	}
+	void Dx12DescriptorRing::Retire()
+	{
+		ring.Retire(fence->GetCompletedValue());
+	}
+
+	RingStatistics Dx12DescriptorRing::GetStatistics() const
+	{
+		RingStatistics statistics = ring.GetStatistics();
+		statistics.stallCount = stallCount;
+		return statistics;
+	}
+
+	Dx12DescriptorHeap* Dx12DescriptorRing::GetHeap() const
+	{
+		return heap;
+	}
+}
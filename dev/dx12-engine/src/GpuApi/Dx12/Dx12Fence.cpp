@@ -2,8 +2,16 @@
 
 #include "Core/Error.h"
 
+#include <cassert>
+
 namespace dxe
 {
+	Dx12Fence::~Dx12Fence()
+	{
+		if (fenceEvent)
+			CloseHandle(fenceEvent);
+	}
+
 	void Dx12Fence::Initialize(ID3D12Device* device)
 	{
 		DX12_THROW_IF_NOT_SUCCESS(
@@ -14,38 +22,122 @@ namespace dxe
 		fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 		WINAPI_THROW_IF_NULL(fenceEvent, "Failed to create a Fence Event!");
 
-		// fenceValue++;
-		// fenceValue = 1;
+		timeline.Reset();
 	}
 
-	void Dx12Fence::SignalOnGpu(ID3D12CommandQueue* commandQueue)
+	uint64_t Dx12Fence::SignalOnGpu(ID3D12CommandQueue* commandQueue)
 	{
-		fenceValue++;
+		uint64_t fenceValue = timeline.Advance();
 		DX12_THROW_IF_NOT_SUCCESS(
 			commandQueue->Signal(fence.Get(), fenceValue),
 			"Failed to signal a fence value!");
+		return fenceValue;
 	}
-	void Dx12Fence::SignalOnCpu()
+	uint64_t Dx12Fence::SignalOnCpu()
 	{
-		fenceValue++;
-		fence->Signal(fenceValue);
+		uint64_t fenceValue = timeline.Advance();
+		DX12_THROW_IF_NOT_SUCCESS(
+			fence->Signal(fenceValue),
+			"Failed to signal a fence value on the CPU!");
+		return fenceValue;
+	}
+
+	bool Dx12Fence::IsComplete(uint64_t value)
+	{
+		return timeline.IsComplete(value, [this]() { return fence->GetCompletedValue(); });
 	}
 
 	void Dx12Fence::WaitForFenceEvent()
 	{
-		if (fence->GetCompletedValue() < fenceValue)
+		WaitForValue(timeline.GetValue());
+	}
+	void Dx12Fence::WaitForValue(uint64_t value)
+	{
+		// The event may still be set by an earlier wait for any fence, so the value is checked again.
+		while (!IsComplete(value))
 		{
 			DX12_THROW_IF_NOT_SUCCESS(
-				fence->SetEventOnCompletion(fenceValue, fenceEvent),
+				fence->SetEventOnCompletion(value, fenceEvent),
 				"Couldn't set the fence event!");
 
 			WaitForSingleObject(fenceEvent, INFINITE);
 		}
 	}
+	void Dx12Fence::WaitOnGpu(ID3D12CommandQueue* commandQueue, uint64_t value) const
+	{
+		DX12_THROW_IF_NOT_SUCCESS(
+			commandQueue->Wait(fence.Get(), value),
+			"Failed to make a Command Queue wait for a fence value!");
+	}
+
+	void Dx12Fence::WaitForAll(const std::vector<Dx12FenceWait>& waits)
+	{
+		while (WaitForEvents(waits, true))
+			;
+	}
+	size_t Dx12Fence::WaitForAny(const std::vector<Dx12FenceWait>& waits)
+	{
+		assert(!waits.empty() && "Nothing to wait for!");
+
+		for (;;)
+		{
+			for (size_t waitIndex = 0; waitIndex < waits.size(); waitIndex++)
+			{
+				if (waits[waitIndex].fence->IsComplete(waits[waitIndex].value))
+					return waitIndex;
+			}
+
+			WaitForEvents(waits, false);
+		}
+	}
+
+	bool Dx12Fence::WaitForEvents(const std::vector<Dx12FenceWait>& waits, bool waitAll)
+	{
+		std::vector<Dx12FenceWait> pendingWaits = MergePendingFenceWaits(waits, waitAll,
+			[](const Dx12FenceWait& wait) { return wait.fence->IsComplete(wait.value); });
+
+		if (pendingWaits.empty())
+			return false;
+
+		if (pendingWaits.size() > MAXIMUM_WAIT_OBJECTS)
+			throw Error{ "Too many fences to wait for at once!" };
+
+		std::vector<HANDLE> events;
+		events.reserve(pendingWaits.size());
+		for (const Dx12FenceWait& pendingWait : pendingWaits)
+		{
+			DX12_THROW_IF_NOT_SUCCESS(
+				pendingWait.fence->fence->SetEventOnCompletion(pendingWait.value, pendingWait.fence->fenceEvent),
+				"Couldn't set the fence event!");
+			events.push_back(pendingWait.fence->fenceEvent);
+		}
+
+		DWORD result = WaitForMultipleObjects(
+			static_cast<DWORD>(events.size()), events.data(), waitAll ? TRUE : FALSE, INFINITE);
+		if (result == WAIT_FAILED)
+			throw WinAPIError(THIS_FILE, THIS_FUNCTION, THIS_LINE, "Failed to wait for the fence events!");
+
+		return true;
+	}
+
+	uint64_t Dx12Fence::SignalOnGpuAndWaitForFenceEvent(ID3D12CommandQueue* commandQueue)
+	{
+		uint64_t value = SignalOnGpu(commandQueue);
+		WaitForValue(value);
+		return value;
+	}
+
+	uint64_t Dx12Fence::GetValue() const
+	{
+		return timeline.GetValue();
+	}
+	uint64_t Dx12Fence::GetCompletedValue()
+	{
+		return timeline.UpdateCompletedValue(fence->GetCompletedValue());
+	}
 
-	void Dx12Fence::SignalOnGpuAndWaitForFenceEvent(ID3D12CommandQueue* commandQueue)
+	ID3D12Fence* Dx12Fence::GetFence() const
 	{
-		SignalOnGpu(commandQueue);
-		WaitForFenceEvent();
+		return fence.Get();
 	}
-}
\ No newline at end of file
+}
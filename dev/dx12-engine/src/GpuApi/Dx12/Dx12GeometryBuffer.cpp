@@ -0,0 +1,337 @@
+#include "GpuApi/Dx12/Dx12GeometryBuffer.h"
+
+#include "GpuApi/Dx12/Dx12Buffer.h"
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include "Core/Error.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	Dx12GeometryBuffer::Dx12GeometryBuffer(
+		ID3D12Device* device,
+		Dx12HeapAllocator* heapAllocator,
+		Dx12UploadQueue* uploadQueue,
+		Dx12Fence* fence,
+		uint64_t indexCapacity)
+		: device(device),
+		heapAllocator(heapAllocator),
+		uploadQueue(uploadQueue),
+		fence(fence)
+	{
+		assert(device && heapAllocator && uploadQueue && fence &&
+			"Geometry buffer needs a device, a heap allocator, an upload queue and a fence!");
+		assert(heapAllocator->GetHeapType() == D3D12_HEAP_TYPE_DEFAULT && "Geometry buffer has to be in a DEFAULT heap!");
+
+		indexPool = CreateBufferPool(sizeof(uint32_t), indexCapacity);
+	}
+
+	Dx12GeometryBuffer::~Dx12GeometryBuffer()
+	{
+		for (std::unique_ptr<BufferPool>& vertexPool : vertexPools)
+			ReleaseBufferPool(*vertexPool);
+
+		ReleaseBufferPool(*indexPool);
+	}
+
+	void Dx12GeometryBuffer::CreateVertexBuffer(uint32_t vertexStride, uint64_t vertexCapacity)
+	{
+		if (FindVertexPool(vertexStride))
+			throw Error{ "Geometry buffer already has a vertex buffer of this stride!" };
+
+		vertexPools.push_back(CreateBufferPool(vertexStride, vertexCapacity));
+	}
+
+	uint32_t Dx12GeometryBuffer::AddMesh(
+		uint32_t vertexStride,
+		const void* vertices, uint64_t vertexCount,
+		const uint32_t* indices, uint64_t indexCount)
+	{
+		assert(vertexCount > 0 && indexCount > 0 && "Geometry buffer meshes need vertices and indices!");
+
+		BufferPool* vertexPool = FindVertexPool(vertexStride);
+		if (!vertexPool)
+		{
+			CreateVertexBuffer(vertexStride, DX12_DEFAULT_GEOMETRY_VERTEX_CAPACITY);
+			vertexPool = vertexPools.back().get();
+		}
+
+		Geometry geometry{};
+		geometry.vertexStride = vertexStride;
+
+		geometry.vertexHandle = AllocateRange(*vertexPool, vertices, vertexCount);
+		if (geometry.vertexHandle == RANGE_INVALID_HANDLE)
+			throw Error{ "Geometry vertex buffer is full!" };
+
+		geometry.indexHandle = AllocateRange(*indexPool, indices, indexCount);
+		if (geometry.indexHandle == RANGE_INVALID_HANDLE)
+		{
+			FreeRange(*vertexPool, geometry.vertexHandle);
+			throw Error{ "Geometry index buffer is full!" };
+		}
+
+		uint32_t geometryId = geometryIds.GenerateUniqueId();
+		if (geometryId >= geometries.size())
+			geometries.resize(geometryId + 1);
+
+		geometries[geometryId] = geometry;
+		return geometryId;
+	}
+
+	void Dx12GeometryBuffer::RemoveMesh(uint32_t geometryId)
+	{
+		AssertIfInvalidId(geometryId);
+
+		Geometry& geometry = geometries[geometryId];
+		FreeRange(*FindVertexPool(geometry.vertexStride), geometry.vertexHandle);
+		FreeRange(*indexPool, geometry.indexHandle);
+
+		geometry = Geometry{};
+		geometryIds.FreeUniqueId(geometryId);
+	}
+
+	void Dx12GeometryBuffer::AppendToMesh(
+		uint32_t geometryId,
+		const void* vertices, uint64_t vertexCount,
+		const uint32_t* indices, uint64_t indexCount)
+	{
+		AssertIfInvalidId(geometryId);
+
+		Geometry& geometry = geometries[geometryId];
+		BufferPool& vertexPool = *FindVertexPool(geometry.vertexStride);
+
+		uint64_t previousVertexCount = vertexPool.ranges->GetSize(geometry.vertexHandle);
+		if (vertexCount > 0 && !GrowRange(vertexPool, geometry.vertexHandle, vertices, vertexCount))
+			throw Error{ "Geometry vertex buffer is full!" };
+
+		if (indexCount > 0 && !GrowRange(*indexPool, geometry.indexHandle, indices, indexCount))
+		{
+			if (vertexCount > 0)
+				ShrinkRange(vertexPool, geometry.vertexHandle, previousVertexCount);
+			throw Error{ "Geometry index buffer is full!" };
+		}
+	}
+
+	void Dx12GeometryBuffer::TruncateMesh(uint32_t geometryId, uint64_t vertexCount, uint64_t indexCount)
+	{
+		AssertIfInvalidId(geometryId);
+		assert(vertexCount > 0 && indexCount > 0 && "Geometry buffer meshes need vertices and indices!");
+
+		Geometry& geometry = geometries[geometryId];
+		ShrinkRange(*FindVertexPool(geometry.vertexStride), geometry.vertexHandle, vertexCount);
+		ShrinkRange(*indexPool, geometry.indexHandle, indexCount);
+	}
+
+	void Dx12GeometryBuffer::Retire()
+	{
+		uint64_t completedValue = fence->GetCompletedValue();
+		while (!pendingRanges.empty() && pendingRanges.front().fenceValue <= completedValue)
+		{
+			pendingRanges.front().pool->ranges->Free(pendingRanges.front().handle);
+			pendingRanges.pop_front();
+		}
+	}
+
+	Dx12GeometryRange Dx12GeometryBuffer::GetRange(uint32_t geometryId) const
+	{
+		AssertIfInvalidId(geometryId);
+
+		const Geometry& geometry = geometries[geometryId];
+		const RangeAllocator& vertexRanges = *FindVertexPool(geometry.vertexStride)->ranges;
+		const RangeAllocator& indexRanges = *indexPool->ranges;
+
+		Dx12GeometryRange range{};
+		range.vertexStride = geometry.vertexStride;
+		range.baseVertex = static_cast<int32_t>(vertexRanges.GetOffset(geometry.vertexHandle));
+		range.vertexCount = static_cast<uint32_t>(vertexRanges.GetSize(geometry.vertexHandle));
+		range.firstIndex = static_cast<uint32_t>(indexRanges.GetOffset(geometry.indexHandle));
+		range.indexCount = static_cast<uint32_t>(indexRanges.GetSize(geometry.indexHandle));
+		return range;
+	}
+
+	D3D12_VERTEX_BUFFER_VIEW Dx12GeometryBuffer::GetVertexBufferView(uint32_t vertexStride) const
+	{
+		const BufferPool* vertexPool = FindVertexPool(vertexStride);
+		assert(vertexPool && "Geometry buffer has no vertex buffer of this stride!");
+
+		D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+		vertexBufferView.BufferLocation = vertexPool->buffer->GetGPUVirtualAddress();
+		vertexBufferView.StrideInBytes = vertexStride;
+		vertexBufferView.SizeInBytes = static_cast<UINT>(vertexPool->ranges->GetCapacity() * vertexStride);
+		return vertexBufferView;
+	}
+	D3D12_INDEX_BUFFER_VIEW Dx12GeometryBuffer::GetIndexBufferView() const
+	{
+		D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+		indexBufferView.BufferLocation = indexPool->buffer->GetGPUVirtualAddress();
+		indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+		indexBufferView.SizeInBytes = static_cast<UINT>(indexPool->ranges->GetCapacity() * sizeof(uint32_t));
+		return indexBufferView;
+	}
+
+	uint64_t Dx12GeometryBuffer::Defragment(uint64_t maxMoveBytes)
+	{
+		uint64_t movedBytes = DefragmentPool(*indexPool, maxMoveBytes);
+		for (std::unique_ptr<BufferPool>& vertexPool : vertexPools)
+			movedBytes += DefragmentPool(*vertexPool, maxMoveBytes);
+
+		return movedBytes;
+	}
+
+	RangeStatistics Dx12GeometryBuffer::GetVertexStatistics(uint32_t vertexStride) const
+	{
+		const BufferPool* vertexPool = FindVertexPool(vertexStride);
+		return vertexPool ? vertexPool->ranges->GetStatistics() : RangeStatistics{};
+	}
+	RangeStatistics Dx12GeometryBuffer::GetIndexStatistics() const
+	{
+		return indexPool->ranges->GetStatistics();
+	}
+
+	std::unique_ptr<Dx12GeometryBuffer::BufferPool> Dx12GeometryBuffer::CreateBufferPool(uint32_t elementSize, uint64_t capacity)
+	{
+		assert(elementSize > 0 && "Geometry buffer elements need a size!");
+
+		// Buffer views have 32 bit sizes and base vertices are signed.
+		if (capacity == 0 || capacity > INT32_MAX || capacity * elementSize > UINT32_MAX)
+			throw Error{ "Invalid geometry buffer capacity!" };
+
+		auto pool = std::make_unique<BufferPool>();
+		pool->elementSize = elementSize;
+		pool->ranges = std::make_unique<RangeAllocator>(capacity);
+
+		D3D12_RESOURCE_DESC resourceDesc = CreateBufferResourceDesc(capacity * elementSize);
+		pool->allocation = heapAllocator->Allocate(resourceDesc);
+
+		// COMMON, so copies promote it to COPY_DEST and draws to a read state without barriers.
+		DX12_THROW_IF_NOT_SUCCESS(
+			device->CreatePlacedResource(
+				pool->allocation.heap, pool->allocation.offset,
+				&resourceDesc,
+				D3D12_RESOURCE_STATE_COMMON,
+				nullptr,
+				IID_PPV_ARGS(pool->buffer.ReleaseAndGetAddressOf())),
+			"Failed to create a Geometry Buffer Placed Resource!");
+
+		return pool;
+	}
+
+	void Dx12GeometryBuffer::ReleaseBufferPool(BufferPool& pool)
+	{
+		// The placed resource goes before the memory it lives in.
+		pool.buffer.Reset();
+
+		heapAllocator->Free(pool.allocation);
+	}
+
+	Dx12GeometryBuffer::BufferPool* Dx12GeometryBuffer::FindVertexPool(uint32_t vertexStride) const
+	{
+		for (const std::unique_ptr<BufferPool>& vertexPool : vertexPools)
+		{
+			if (vertexPool->elementSize == vertexStride)
+				return vertexPool.get();
+		}
+		return nullptr;
+	}
+
+	uint32_t Dx12GeometryBuffer::AllocateHandle(BufferPool& pool, uint64_t count)
+	{
+		// Ranges the GPU is done with are reused before the buffer counts as full.
+		uint32_t handle = pool.ranges->Allocate(count);
+		if (handle == RANGE_INVALID_HANDLE && !pendingRanges.empty())
+		{
+			Retire();
+			handle = pool.ranges->Allocate(count);
+		}
+		return handle;
+	}
+	uint32_t Dx12GeometryBuffer::AllocateRange(BufferPool& pool, const void* data, uint64_t count)
+	{
+		uint32_t handle = AllocateHandle(pool, count);
+		if (handle != RANGE_INVALID_HANDLE)
+		{
+			uploadQueue->UploadBuffer(
+				pool.buffer.Get(), pool.ranges->GetOffset(handle) * pool.elementSize,
+				data, count * pool.elementSize);
+		}
+
+		return handle;
+	}
+	bool Dx12GeometryBuffer::GrowRange(BufferPool& pool, uint32_t& handle, const void* data, uint64_t count)
+	{
+		uint64_t size = pool.ranges->GetSize(handle);
+		if (!pool.ranges->Grow(handle, count))
+		{
+			uint32_t movedHandle = AllocateHandle(pool, size + count);
+			if (movedHandle == RANGE_INVALID_HANDLE)
+				return false;
+
+			// Draws recorded so far read the old range, it's freed once those are done.
+			Dx12BufferRegionCopy copy{};
+			copy.sourceOffset = pool.ranges->GetOffset(handle) * pool.elementSize;
+			copy.destinationOffset = pool.ranges->GetOffset(movedHandle) * pool.elementSize;
+			copy.size = size * pool.elementSize;
+			uploadQueue->CopyBufferRegions(pool.buffer.Get(), { copy });
+
+			FreeRange(pool, handle);
+			handle = movedHandle;
+		}
+
+		uploadQueue->UploadBuffer(
+			pool.buffer.Get(), (pool.ranges->GetOffset(handle) + size) * pool.elementSize,
+			data, count * pool.elementSize);
+		return true;
+	}
+	void Dx12GeometryBuffer::ShrinkRange(BufferPool& pool, uint32_t handle, uint64_t count)
+	{
+		assert(count <= pool.ranges->GetSize(handle) && "Range can't shrink to a larger size!");
+
+		if (count < pool.ranges->GetSize(handle))
+			FreeRange(pool, pool.ranges->Split(handle, count));
+	}
+	void Dx12GeometryBuffer::FreeRange(BufferPool& pool, uint32_t handle)
+	{
+		pendingRanges.push_back(PendingRange{ fence->GetValue() + 1, &pool, handle });
+	}
+
+	uint64_t Dx12GeometryBuffer::DefragmentPool(BufferPool& pool, uint64_t maxMoveBytes)
+	{
+		std::vector<RangeMove> moves = pool.ranges->PlanDefragmentation(maxMoveBytes / pool.elementSize);
+		if (moves.empty())
+			return 0;
+
+		// Destinations are free ranges, so the copies don't overlap and go in one submission.
+		std::vector<Dx12BufferRegionCopy> copies;
+		copies.reserve(moves.size());
+
+		uint64_t movedBytes{ 0 };
+		for (const RangeMove& move : moves)
+		{
+			Dx12BufferRegionCopy copy{};
+			copy.sourceOffset = move.sourceOffset * pool.elementSize;
+			copy.destinationOffset = move.destinationOffset * pool.elementSize;
+			copy.size = move.size * pool.elementSize;
+			copies.push_back(copy);
+
+			movedBytes += copy.size;
+		}
+
+		uploadQueue->CopyBufferRegions(pool.buffer.Get(), copies);
+
+		// Draws recorded so far read the sources, they're freed once those are done.
+		std::vector<uint32_t> sourceHandles;
+		sourceHandles.reserve(moves.size());
+		pool.ranges->ApplyMoves(moves, &sourceHandles);
+
+		for (uint32_t sourceHandle : sourceHandles)
+			FreeRange(pool, sourceHandle);
+		return movedBytes;
+	}
+
+	void Dx12GeometryBuffer::AssertIfInvalidId(uint32_t geometryId) const
+	{
+		assert(geometryId < geometries.size() && geometries[geometryId].vertexHandle != RANGE_INVALID_HANDLE &&
+			"Invalid geometry ID provided!");
+	}
+}
@@ -22,6 +22,7 @@ namespace dxe
 	static Dx12GpuData* gpuData{ nullptr };
 
 	static uint32_t frameBufferCount{ 2 };
+	static uint32_t frameLatency{ DEFAULT_FRAME_LATENCY };
 
 	static void CreateDevice();
 	static void DestroyDevice();
@@ -43,11 +44,13 @@ namespace dxe
 		return gpuData;
 	}
 
-	void InitializeDx12()
+	void InitializeDx12(uint32_t frameLatency)
 	{
 		assert(!gpuData && "GPU API can only be initialized once!");
 		gpuData = new Dx12GpuData();
 
+		dxe::frameLatency = frameLatency;
+
 		CreateDevice();
 		CreateCommandManager();
 		CreateSwapChain();
@@ -56,6 +59,9 @@ namespace dxe
 	}
 	void TerminateDx12()
 	{
+		// Frames may still be in flight, using the resources destroyed below.
+		gpuData->commandManager->WaitForFrames();
+
 		DestroyRenderer();
 		DestroyResourceManager();
 		DestroySwapChain();
@@ -82,7 +88,7 @@ namespace dxe
 	{
 		gpuData->commandManager = new Dx12CommandManager();
 		gpuData->commandManager->CreateCommandQueues(gpuData->device->GetDevice());
-		gpuData->commandManager->CreateCommandContexts(gpuData->device->GetDevice(), frameBufferCount);
+		gpuData->commandManager->CreateCommandContexts(gpuData->device->GetDevice(), frameLatency);
 	}
 	void DestroyCommandManager()
 	{
@@ -115,7 +121,7 @@ namespace dxe
 	static void CreateResourceManager()
 	{
 		gpuData->resourceManager = new Dx12ResourceManager();
-		gpuData->resourceManager->Initialize();
+		gpuData->resourceManager->Initialize(gpuData->device->GetDevice(), gpuData->commandManager);
 	}
 	static void DestroyResourceManager()
 	{
@@ -0,0 +1,182 @@
+#include "GpuApi/Dx12/Dx12HeapAllocator.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dxe
+{
+	// Heap sizes are kept to multiples of the largest placement alignment (MSAA textures).
+	constexpr uint64_t HEAP_SIZE_ALIGNMENT = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	static bool HeapAllowsRenderTargets(D3D12_HEAP_FLAGS heapFlags)
+	{
+		return (heapFlags & D3D12_HEAP_FLAG_DENY_RT_DS_TEXTURES) == 0;
+	}
+
+	Dx12HeapAllocator::Dx12HeapAllocator(
+		ID3D12Device* device,
+		D3D12_HEAP_TYPE heapType,
+		D3D12_HEAP_FLAGS heapFlags,
+		uint64_t heapBlockSize)
+		: device(device),
+		heapType(heapType),
+		heapFlags(heapFlags),
+		heapAlignment(HeapAllowsRenderTargets(heapFlags) ?
+			D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT),
+		heapBlockSize((heapBlockSize + HEAP_SIZE_ALIGNMENT - 1) & ~(HEAP_SIZE_ALIGNMENT - 1))
+	{
+		assert(device && "Heap allocator needs a device!");
+	}
+
+	Dx12HeapAllocation Dx12HeapAllocator::Allocate(const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo)
+	{
+		if (allocationInfo.SizeInBytes == 0 || allocationInfo.SizeInBytes == UINT64_MAX)
+			throw Error{ "Invalid resource allocation info!" };
+
+		uint64_t alignment = std::max<uint64_t>(allocationInfo.Alignment, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT);
+		if (alignment > heapAlignment)
+			throw Error{ "Resource alignment is larger than the heaps of this allocator are aligned to!" };
+
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		Dx12HeapAllocation result{};
+		if (allocationInfo.SizeInBytes <= heapBlockSize)
+		{
+			for (uint32_t heapIndex = 0; heapIndex < heapBlocks.size() && !result.allocation.IsValid(); heapIndex++)
+			{
+				if (!heapBlocks[heapIndex] || heapBlocks[heapIndex]->allocator.GetCapacity() != heapBlockSize)
+					continue;
+
+				result.allocation = heapBlocks[heapIndex]->allocator.Allocate(allocationInfo.SizeInBytes, alignment);
+				result.heapIndex = heapIndex;
+			}
+		}
+
+		if (!result.allocation.IsValid())
+		{
+			// Oversized resources get a heap of their own, released as soon as they're freed.
+			uint64_t size = std::max(heapBlockSize,
+				(allocationInfo.SizeInBytes + HEAP_SIZE_ALIGNMENT - 1) & ~(HEAP_SIZE_ALIGNMENT - 1));
+
+			result.heapIndex = CreateHeapBlock(size);
+			result.allocation = heapBlocks[result.heapIndex]->allocator.Allocate(allocationInfo.SizeInBytes, alignment);
+			assert(result.allocation.IsValid() && "A new heap has to fit the allocation!");
+		}
+
+		result.heap = heapBlocks[result.heapIndex]->heap.Get();
+		result.offset = result.allocation.offset;
+		result.size = result.allocation.size;
+		return result;
+	}
+
+	Dx12HeapAllocation Dx12HeapAllocator::Allocate(const D3D12_RESOURCE_DESC& resourceDesc)
+	{
+		return Allocate(device->GetResourceAllocationInfo(0, 1, &resourceDesc));
+	}
+
+	void Dx12HeapAllocator::Free(Dx12HeapAllocation& allocation)
+	{
+		if (!allocation.IsValid())
+			return;
+
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		assert(allocation.heapIndex < heapBlocks.size() && heapBlocks[allocation.heapIndex] && "Invalid heap allocation!");
+		HeapBlock& heapBlock = *heapBlocks[allocation.heapIndex];
+		heapBlock.allocator.Free(allocation.allocation);
+
+		if (heapBlock.allocator.IsEmpty() && heapBlock.allocator.GetCapacity() != heapBlockSize)
+			heapBlocks[allocation.heapIndex].reset();
+
+		allocation = Dx12HeapAllocation{};
+	}
+
+	void Dx12HeapAllocator::ReleaseEmptyHeaps()
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		bool keptOne{ false };
+		for (std::unique_ptr<HeapBlock>& heapBlock : heapBlocks)
+		{
+			if (!heapBlock || !heapBlock->allocator.IsEmpty())
+				continue;
+
+			if (!keptOne && heapBlock->allocator.GetCapacity() == heapBlockSize)
+			{
+				keptOne = true;
+				continue;
+			}
+
+			heapBlock.reset();
+		}
+	}
+
+	Dx12HeapStatistics Dx12HeapAllocator::GetStatistics() const
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		Dx12HeapStatistics statistics{};
+		for (const std::unique_ptr<HeapBlock>& heapBlock : heapBlocks)
+		{
+			if (!heapBlock)
+				continue;
+
+			TlsfStatistics heapStatistics = heapBlock->allocator.GetStatistics();
+			statistics.heapCount++;
+			statistics.heapBytes += heapStatistics.capacity;
+			statistics.usedBytes += heapStatistics.usedBytes;
+			statistics.allocationCount += heapStatistics.allocationCount;
+			statistics.largestFreeBlock = std::max(statistics.largestFreeBlock, heapStatistics.largestFreeBlock);
+		}
+
+		uint64_t freeBytes = statistics.heapBytes - statistics.usedBytes;
+		if (freeBytes > 0)
+			statistics.fragmentation = 1.0f - static_cast<float>(static_cast<double>(statistics.largestFreeBlock) / freeBytes);
+
+		return statistics;
+	}
+
+	D3D12_HEAP_TYPE Dx12HeapAllocator::GetHeapType() const
+	{
+		return heapType;
+	}
+	D3D12_HEAP_FLAGS Dx12HeapAllocator::GetHeapFlags() const
+	{
+		return heapFlags;
+	}
+
+	uint32_t Dx12HeapAllocator::CreateHeapBlock(uint64_t size)
+	{
+		D3D12_HEAP_PROPERTIES heapProps{};
+		heapProps.Type = heapType;
+		heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+		heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+		heapProps.CreationNodeMask = 0;
+		heapProps.VisibleNodeMask = 0;
+
+		D3D12_HEAP_DESC heapDesc{};
+		heapDesc.SizeInBytes = size;
+		heapDesc.Properties = heapProps;
+		heapDesc.Alignment = heapAlignment;
+		heapDesc.Flags = heapFlags;
+
+		auto heapBlock = std::make_unique<HeapBlock>(HeapBlock{ nullptr, TlsfAllocator{ size } });
+
+		DX12_THROW_IF_NOT_SUCCESS(
+			device->CreateHeap(&heapDesc, IID_PPV_ARGS(heapBlock->heap.ReleaseAndGetAddressOf())),
+			"Failed to create a Heap for placed resources!");
+
+		// Reuses the slot of a released heap if there is one.
+		auto emptySlot = std::find(heapBlocks.begin(), heapBlocks.end(), nullptr);
+		if (emptySlot != heapBlocks.end())
+		{
+			*emptySlot = std::move(heapBlock);
+			return static_cast<uint32_t>(emptySlot - heapBlocks.begin());
+		}
+
+		heapBlocks.push_back(std::move(heapBlock));
+		return static_cast<uint32_t>(heapBlocks.size() - 1);
+	}
+}
@@ -2,14 +2,14 @@
 
 #include "Core/Error.h"
 
-#include <cmath>
+#include <cassert>
 
 namespace dxe
 {
-	// Sizes below are specified in bytes
-
-	constexpr size_t bufferAllignment = 65536;
-	constexpr size_t bufferAllignmentMask = bufferAllignment - 1;
+	Dx12Mesh::~Dx12Mesh()
+	{
+		ReleaseHeapMemory();
+	}
 
 	Dx12VertexBuffer* Dx12Mesh::GetVertexBuffer() const
 	{
@@ -20,73 +20,59 @@ namespace dxe
 		return indexBuffer.get();
 	}
 
-	void Dx12Mesh::InitializeHeap(
-		ID3D12Device* device,
-		size_t requestedVbSize,
-		size_t requestedIbSize)
+	void Dx12Mesh::AllocateHeapMemory(
+		Dx12HeapAllocator* allocator,
+		Dx12UploadQueue* uploadQueue,
+		size_t vertexBufferSize,
+		size_t indexBufferSize)
 	{
-		// Determine the sizes of the vertex and index buffers in terms of
-		// multiples of the buffer allignment requirement (64 KB).
+		assert(allocator && "Meshes need a heap allocator!");
+		assert((uploadQueue || allocator->GetHeapType() == D3D12_HEAP_TYPE_UPLOAD) &&
+			"Meshes outside of UPLOAD heaps need an upload queue!");
 
-		size_t vbAllocSizeMult = static_cast<uint32_t>(
-			std::ceil(
-				static_cast<double>(requestedVbSize) / bufferAllignment
-			)
-		);
-		size_t ibAllocSizeMult = static_cast<uint32_t>(
-			std::ceil(
-				static_cast<double>(requestedIbSize) / bufferAllignment
-			)
-		);
-		
-		this->vbOffset = 0;
-		this->ibOffset = vbAllocSizeMult * bufferAllignment;
+		ReleaseHeapMemory();
+		heapAllocator = allocator;
 
-		this->heapSize = (vbAllocSizeMult + ibAllocSizeMult) * bufferAllignment;
+		// Each buffer is its own placed resource, so each gets its own (64 KB aligned) allocation.
+		vertexAllocation = heapAllocator->Allocate(CreateBufferResourceDesc(vertexBufferSize));
+		if (indexBufferSize > 0)
+			indexAllocation = heapAllocator->Allocate(CreateBufferResourceDesc(indexBufferSize));
+	}
 
-		D3D12_HEAP_PROPERTIES heapProps{};
-		// CPU-visible UPLOAD type for now,
-		// but should be configured based on whether the mesh is dynamic or not.
-		heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-		heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-		heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-		heapProps.CreationNodeMask = 0;
-		heapProps.VisibleNodeMask = 0;
+	void Dx12Mesh::ReleaseHeapMemory()
+	{
+		// The placed resources go before the memory they live in.
+		vertexBuffer.reset();
+		indexBuffer.reset();
 
-		D3D12_HEAP_DESC heapDesc{};
-		heapDesc.Alignment = 0; // Which is an alias for 64 KB
-		// Automatically assigned for implicit heaps,
-		// but here we only care about buffers.
-		// heapDesc.Flags = D3D12_HEAP_FLAG_NONE;
-		heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
-		heapDesc.Properties = heapProps;
-		heapDesc.SizeInBytes = this->heapSize;
+		if (!heapAllocator)
+			return;
 
-		DX12_THROW_IF_NOT_SUCCESS(
-			device->CreateHeap(&heapDesc, IID_PPV_ARGS(heap.ReleaseAndGetAddressOf())),
-			"Failed to create a Heap for Mesh Data!");
+		heapAllocator->Free(vertexAllocation);
+		heapAllocator->Free(indexAllocation);
+		heapAllocator = nullptr;
 	}
 
-	void Dx12Mesh::CreateVertexBuffer(ID3D12Device* device, const void* vertSrcData, size_t vertexSize, size_t vertexBufferSize)
+	void Dx12Mesh::CreateVertexBuffer(ID3D12Device* device, Dx12UploadQueue* uploadQueue, const void* vertSrcData, size_t vertexSize, size_t vertexBufferSize)
 	{
 		Dx12BufferDataDesc dataDesc{};
-		dataDesc.heapOffset = vbOffset;
+		dataDesc.heapOffset = vertexAllocation.offset;
 		dataDesc.srcDataPtr = vertSrcData;
 		dataDesc.elementSize = vertexSize;
 		dataDesc.bufferSize = vertexBufferSize;
 
 		vertexBuffer = std::make_unique<Dx12VertexBuffer>();
-		vertexBuffer->CreateVertexBuffer(device, heap.Get(), dataDesc);
+		vertexBuffer->CreateVertexBuffer(device, vertexAllocation.heap, dataDesc, uploadQueue);
 	}
-	void Dx12Mesh::CreateIndexBuffer(ID3D12Device* device, const void* indexSrcData, size_t indexSize, size_t indexBufferSize)
+	void Dx12Mesh::CreateIndexBuffer(ID3D12Device* device, Dx12UploadQueue* uploadQueue, const void* indexSrcData, size_t indexSize, size_t indexBufferSize)
 	{
 		Dx12BufferDataDesc dataDesc{};
-		dataDesc.heapOffset = vbOffset;
+		dataDesc.heapOffset = indexAllocation.offset;
 		dataDesc.srcDataPtr = indexSrcData;
 		dataDesc.elementSize = indexSize;
 		dataDesc.bufferSize = indexBufferSize;
 
 		indexBuffer = std::make_unique<Dx12IndexBuffer>();
-		indexBuffer->CreateIndexBuffer(device, heap.Get(), dataDesc);
+		indexBuffer->CreateIndexBuffer(device, indexAllocation.heap, dataDesc, uploadQueue);
 	}
 }
\ No newline at end of file
@@ -218,4 +218,9 @@ namespace dxe
                 &psoDesc, IID_PPV_ARGS(pipelineState.ReleaseAndGetAddressOf())),
             "Failed to create a Graphics Pipeline State Object!");
 	}
+
+    const D3D12_GRAPHICS_PIPELINE_STATE_DESC& Dx12GraphicsPSO::GetDesc() const
+    {
+        return psoDesc;
+    }
 }
\ No newline at end of file
@@ -4,20 +4,27 @@
 
 namespace dxe
 {
-	void Dx12Queue::SignalFence(Dx12Fence* fence)
+	uint64_t Dx12Queue::SignalFence(Dx12Fence* fence)
 	{
-		fence->SignalOnGpu(commandQueue.Get());
+		return fence->SignalOnGpu(commandQueue.Get());
+	}
+	void Dx12Queue::WaitForFence(Dx12Fence* fence, uint64_t value)
+	{
+		fence->WaitOnGpu(commandQueue.Get(), value);
 	}
 	void Dx12Queue::FlushQueue()
 	{
-		queueFence->SignalOnGpu(commandQueue.Get());
-		queueFence->WaitForFenceEvent();
+		queueFence->SignalOnGpuAndWaitForFenceEvent(commandQueue.Get());
 	}
 
 	ID3D12CommandQueue* Dx12Queue::GetCommandQueue() const
 	{
 		return commandQueue.Get();
 	}
+	Dx12Fence* Dx12Queue::GetQueueFence() const
+	{
+		return queueFence.get();
+	}
 
 	void Dx12Queue::CreateCommandQueue(ID3D12Device* device, D3D12_COMMAND_LIST_TYPE queueType)
 	{
@@ -1,18 +1,146 @@
 #include "GpuApi/Dx12/Dx12ResourceManager.h"
 
+#include "GpuApi/Dx12/Dx12CommandManager.h"
+
 #include "Core/Error.h"
 #include "Core/Logger.h"
 #include "Core/Utility.h"
 
 namespace dxe
 {
-	void Dx12ResourceManager::Initialize()
+	// Deferred release timelines
+	constexpr uint32_t DIRECT_QUEUE_TIMELINE = 0;
+	constexpr uint32_t COMPUTE_QUEUE_TIMELINE = 1;
+	constexpr uint32_t COPY_QUEUE_TIMELINE = 2;
+	constexpr uint32_t QUEUE_TIMELINE_COUNT = 3;
+
+	constexpr uint32_t DESCRIPTOR_HEAP_SIZE = 4096;
+	// The bindless table, then the descriptor ring.
+	constexpr uint32_t SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE = DX12_DEFAULT_BINDLESS_TABLE_SIZE + DX12_DEFAULT_DESCRIPTOR_RING_SIZE;
+
+	void Dx12ResourceManager::Initialize(ID3D12Device* device, Dx12CommandManager* commandManager)
 	{
+		this->commandManager = commandManager;
+		deferredReleases = std::make_unique<DeferredReleaseQueue>(QUEUE_TIMELINE_COUNT);
+
+		descriptorHeap = std::make_unique<Dx12DescriptorHeap>(
+			DESCRIPTOR_HEAP_SIZE, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+		descriptorHeap->Initialize(device);
+		descriptorAllocator = std::make_unique<Dx12DescriptorAllocator>(
+			descriptorHeap.get(), 0, DESCRIPTOR_HEAP_SIZE);
+
+		shaderVisibleDescriptorHeap = std::make_unique<Dx12DescriptorHeap>(
+			SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE);
+		shaderVisibleDescriptorHeap->Initialize(device);
+		bindlessTable = std::make_unique<Dx12BindlessTable>(
+			device, shaderVisibleDescriptorHeap.get(), commandManager->GetDirectQueue()->GetQueueFence(),
+			0, DX12_DEFAULT_BINDLESS_TABLE_SIZE);
+		descriptorRing = std::make_unique<Dx12DescriptorRing>(
+			device, shaderVisibleDescriptorHeap.get(), commandManager->GetDirectQueue()->GetQueueFence(),
+			DX12_DEFAULT_BINDLESS_TABLE_SIZE, DX12_DEFAULT_DESCRIPTOR_RING_SIZE);
+
+		meshHeapAllocator = std::make_unique<Dx12HeapAllocator>(
+			device, D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+		staticMeshHeapAllocator = std::make_unique<Dx12HeapAllocator>(
+			device, D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+
+		uploadRing = std::make_unique<Dx12UploadRing>(
+			device, meshHeapAllocator.get(), commandManager->GetCopyQueue()->GetQueueFence());
+		uploadQueue = std::make_unique<Dx12UploadQueue>(
+			device, commandManager->GetCopyQueue(), uploadRing.get());
+		geometryBuffer = std::make_unique<Dx12GeometryBuffer>(
+			device, staticMeshHeapAllocator.get(), uploadQueue.get(), commandManager->GetDirectQueue()->GetQueueFence());
 	}
 	void Dx12ResourceManager::Terminate()
 	{
+		// Waits for the copies still in flight.
+		uploadQueue.reset();
+
+		// The queues are idle by now.
+		deferredReleases.reset();
+
+		descriptorRing.reset();
+		bindlessTable.reset();
+		shaderVisibleDescriptorHeap.reset();
+		descriptorAllocator.reset();
+		descriptorHeap.reset();
+
+		// Meshes return their memory to the heap allocators, so they go first.
 		meshes.Clear();
+		geometryBuffer.reset();
+		uploadRing.reset();
 		rootSignatures.Clear();
 		graphicsPSOs.Clear();
+
+		meshHeapAllocator.reset();
+		staticMeshHeapAllocator.reset();
+	}
+
+	void Dx12ResourceManager::RetireDeferredReleases()
+	{
+		deferredReleases->Retire(DIRECT_QUEUE_TIMELINE, commandManager->GetDirectQueue()->GetQueueFence()->GetCompletedValue());
+		deferredReleases->Retire(COMPUTE_QUEUE_TIMELINE, commandManager->GetComputeQueue()->GetQueueFence()->GetCompletedValue());
+		deferredReleases->Retire(COPY_QUEUE_TIMELINE, commandManager->GetCopyQueue()->GetQueueFence()->GetCompletedValue());
+	}
+
+	Dx12DescriptorAllocator* Dx12ResourceManager::GetDescriptorAllocator() const
+	{
+		return descriptorAllocator.get();
+	}
+	Dx12BindlessTable* Dx12ResourceManager::GetBindlessTable() const
+	{
+		return bindlessTable.get();
+	}
+	Dx12DescriptorRing* Dx12ResourceManager::GetDescriptorRing() const
+	{
+		return descriptorRing.get();
+	}
+	Dx12DescriptorHeap* Dx12ResourceManager::GetShaderVisibleDescriptorHeap() const
+	{
+		return shaderVisibleDescriptorHeap.get();
+	}
+
+	Dx12HeapAllocator* Dx12ResourceManager::GetMeshHeapAllocator() const
+	{
+		return meshHeapAllocator.get();
+	}
+	Dx12HeapAllocator* Dx12ResourceManager::GetStaticMeshHeapAllocator() const
+	{
+		return staticMeshHeapAllocator.get();
+	}
+	Dx12GeometryBuffer* Dx12ResourceManager::GetGeometryBuffer() const
+	{
+		return geometryBuffer.get();
+	}
+	Dx12UploadRing* Dx12ResourceManager::GetUploadRing() const
+	{
+		return uploadRing.get();
+	}
+	Dx12UploadQueue* Dx12ResourceManager::GetUploadQueue() const
+	{
+		return uploadQueue.get();
+	}
+
+	uint32_t Dx12ResourceManager::GetTimeline(Dx12Queue* queue) const
+	{
+		if (queue == commandManager->GetDirectQueue())
+			return DIRECT_QUEUE_TIMELINE;
+		if (queue == commandManager->GetComputeQueue())
+			return COMPUTE_QUEUE_TIMELINE;
+
+		assert(queue == commandManager->GetCopyQueue() && "Unknown queue!");
+		return COPY_QUEUE_TIMELINE;
+	}
+	uint64_t Dx12ResourceManager::GetNextFenceValue(Dx12Queue* queue) const
+	{
+		return queue->GetQueueFence()->GetValue() + 1;
+	}
+	Dx12Queue* Dx12ResourceManager::GetDirectQueue() const
+	{
+		return commandManager->GetDirectQueue();
+	}
+	Dx12Queue* Dx12ResourceManager::GetCopyQueue() const
+	{
+		return commandManager->GetCopyQueue();
 	}
 }
\ No newline at end of file
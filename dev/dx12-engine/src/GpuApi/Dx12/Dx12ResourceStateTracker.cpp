@@ -0,0 +1,341 @@
+#include "GpuApi/Dx12/Dx12ResourceStateTracker.h"
+
+#include "GpuApi/Dx12/Dx12Barrier.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dxe
+{
+	// States only read by the GPU, any combination of them is valid.
+	const D3D12_RESOURCE_STATES READ_RESOURCE_STATES =
+		D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER |
+		D3D12_RESOURCE_STATE_INDEX_BUFFER |
+		D3D12_RESOURCE_STATE_DEPTH_READ |
+		D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE |
+		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE |
+		D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT |
+		D3D12_RESOURCE_STATE_COPY_SOURCE |
+		D3D12_RESOURCE_STATE_RESOLVE_SOURCE;
+
+	void Dx12ResourceStateTracker::TrackResource(ID3D12Resource* resource, D3D12_RESOURCE_STATES state, uint32_t subresourceCount)
+	{
+		assert(resource && "Can't track a null resource!");
+		assert(subresourceCount > 0 && "Resource needs at least one subresource!");
+		assert(!IsTracked(resource) && "Resource is already tracked!");
+
+		TrackedResource& trackedResource = trackedResources[resource];
+		trackedResource.state = state;
+		trackedResource.subresourceCount = subresourceCount;
+	}
+	void Dx12ResourceStateTracker::Reset()
+	{
+		trackedResources.clear();
+		pendingBarriers.clear();
+	}
+
+	void Dx12ResourceStateTracker::Transition(ID3D12Resource* resource, D3D12_RESOURCE_STATES stateAfter, UINT subresource)
+	{
+		TrackedResource& trackedResource = GetTrackedResource(resource);
+		statistics.transitionRequestCount++;
+
+		if (trackedResource.splitPending)
+		{
+			// The request that ends a split barrier doesn't count as skipped.
+			bool endsSplit = trackedResource.splitSubresource == subresource &&
+				GetSubresourceState(trackedResource, subresource) == stateAfter;
+
+			EndSplitTransition(resource, trackedResource);
+
+			if (endsSplit)
+				return;
+		}
+
+		TransitionResource(resource, trackedResource, stateAfter, subresource);
+	}
+	void Dx12ResourceStateTracker::BeginTransition(ID3D12Resource* resource, D3D12_RESOURCE_STATES stateAfter, UINT subresource)
+	{
+		TrackedResource& trackedResource = GetTrackedResource(resource);
+		statistics.transitionRequestCount++;
+
+		if (trackedResource.splitPending)
+			EndSplitTransition(resource, trackedResource);
+
+		if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES && !trackedResource.subresourceStates.empty())
+		{
+			TransitionResource(resource, trackedResource, stateAfter, subresource);
+			return;
+		}
+
+		// A queued barrier of the subresource is merged instead, both halves would be in the same flush.
+		if (trackedResource.lastBarrier != NO_BARRIER)
+		{
+			const D3D12_RESOURCE_BARRIER& lastBarrier = pendingBarriers[trackedResource.lastBarrier].barrier;
+			if (lastBarrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION &&
+				lastBarrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE &&
+				lastBarrier.Transition.Subresource == subresource)
+			{
+				TransitionResource(resource, trackedResource, stateAfter, subresource);
+				return;
+			}
+		}
+
+		D3D12_RESOURCE_STATES stateBefore = GetSubresourceState(trackedResource, subresource);
+		if (!IsTransitionNeeded(stateBefore, stateAfter))
+		{
+			statistics.skippedTransitionCount++;
+			return;
+		}
+
+		size_t barrierIndex = QueueBarrier(
+			Dx12Barrier::CreateTransitionBarrier(
+				resource, stateBefore, stateAfter, subresource, D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY));
+
+		trackedResource.lastBarrier = barrierIndex;
+		trackedResource.splitPending = true;
+		trackedResource.splitBeginBarrier = barrierIndex;
+		trackedResource.splitStateBefore = stateBefore;
+		trackedResource.splitSubresource = subresource;
+
+		SetSubresourceState(trackedResource, subresource, stateAfter);
+	}
+	void Dx12ResourceStateTracker::UavBarrier(ID3D12Resource* resource)
+	{
+		TrackedResource& trackedResource = GetTrackedResource(resource);
+
+		// Already queued, nothing accessed the resource since.
+		if (trackedResource.lastBarrier != NO_BARRIER &&
+			pendingBarriers[trackedResource.lastBarrier].barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_UAV)
+		{
+			return;
+		}
+
+		trackedResource.lastBarrier = QueueBarrier(Dx12Barrier::CreateUavBarrier(resource));
+	}
+
+	uint32_t Dx12ResourceStateTracker::CollectBarriers()
+	{
+		barrierBatch.clear();
+
+		for (const PendingBarrier& pendingBarrier : pendingBarriers)
+		{
+			const D3D12_RESOURCE_BARRIER& barrier = pendingBarrier.barrier;
+
+			// Indices of the batch are about to be reused.
+			ID3D12Resource* resource = barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION ?
+				barrier.Transition.pResource : barrier.UAV.pResource;
+			TrackedResource& trackedResource = GetTrackedResource(resource);
+			trackedResource.lastBarrier = NO_BARRIER;
+			trackedResource.splitBeginBarrier = NO_BARRIER;
+
+			if (pendingBarrier.removed)
+				continue;
+
+			if (barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION)
+				statistics.transitionBarrierCount++;
+			else
+				statistics.uavBarrierCount++;
+
+			barrierBatch.push_back(barrier);
+		}
+
+		pendingBarriers.clear();
+
+		if (barrierBatch.empty())
+			return 0;
+
+		statistics.flushCount++;
+		return static_cast<uint32_t>(barrierBatch.size());
+	}
+	size_t Dx12ResourceStateTracker::GetPendingBarrierCount() const
+	{
+		return static_cast<size_t>(std::count_if(pendingBarriers.begin(), pendingBarriers.end(),
+			[](const PendingBarrier& pendingBarrier) { return !pendingBarrier.removed; }));
+	}
+
+	D3D12_RESOURCE_STATES Dx12ResourceStateTracker::GetState(ID3D12Resource* resource, UINT subresource) const
+	{
+		auto trackedResource = trackedResources.find(resource);
+		assert(trackedResource != trackedResources.end() && "Resource isn't tracked!");
+
+		return GetSubresourceState(trackedResource->second, subresource);
+	}
+	bool Dx12ResourceStateTracker::IsTracked(ID3D12Resource* resource) const
+	{
+		return trackedResources.find(resource) != trackedResources.end();
+	}
+
+	ResourceStateStatistics Dx12ResourceStateTracker::GetStatistics() const
+	{
+		return statistics;
+	}
+
+	Dx12ResourceStateTracker::TrackedResource& Dx12ResourceStateTracker::GetTrackedResource(ID3D12Resource* resource)
+	{
+		auto trackedResource = trackedResources.find(resource);
+		assert(trackedResource != trackedResources.end() && "Resource isn't tracked!");
+
+		return trackedResource->second;
+	}
+
+	void Dx12ResourceStateTracker::EndSplitTransition(ID3D12Resource* resource, TrackedResource& trackedResource)
+	{
+		trackedResource.splitPending = false;
+
+		if (trackedResource.splitBeginBarrier != NO_BARRIER)
+		{
+			// Not flushed yet, so a regular barrier that later transitions can merge with.
+			pendingBarriers[trackedResource.splitBeginBarrier].barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+			trackedResource.splitBeginBarrier = NO_BARRIER;
+			return;
+		}
+
+		trackedResource.lastBarrier = QueueBarrier(
+			Dx12Barrier::CreateTransitionBarrier(
+				resource,
+				trackedResource.splitStateBefore,
+				GetSubresourceState(trackedResource, trackedResource.splitSubresource),
+				trackedResource.splitSubresource,
+				D3D12_RESOURCE_BARRIER_FLAG_END_ONLY));
+	}
+
+	void Dx12ResourceStateTracker::TransitionResource(
+		ID3D12Resource* resource,
+		TrackedResource& trackedResource,
+		D3D12_RESOURCE_STATES stateAfter,
+		UINT subresource)
+	{
+		if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES && !trackedResource.subresourceStates.empty())
+		{
+			// One barrier per subresource that isn't in the state yet.
+			bool transitioned = false;
+			for (uint32_t subresourceIndex = 0; subresourceIndex < trackedResource.subresourceCount; subresourceIndex++)
+			{
+				D3D12_RESOURCE_STATES stateBefore = GetSubresourceState(trackedResource, subresourceIndex);
+				if (!IsTransitionNeeded(stateBefore, stateAfter))
+					continue;
+
+				SetSubresourceState(
+					trackedResource, subresourceIndex,
+					QueueTransition(resource, trackedResource, subresourceIndex, stateBefore, stateAfter));
+				transitioned = true;
+			}
+
+			if (!transitioned)
+				statistics.skippedTransitionCount++;
+			return;
+		}
+
+		D3D12_RESOURCE_STATES stateBefore = GetSubresourceState(trackedResource, subresource);
+		if (!IsTransitionNeeded(stateBefore, stateAfter))
+		{
+			statistics.skippedTransitionCount++;
+			return;
+		}
+
+		SetSubresourceState(
+			trackedResource, subresource,
+			QueueTransition(resource, trackedResource, subresource, stateBefore, stateAfter));
+	}
+
+	D3D12_RESOURCE_STATES Dx12ResourceStateTracker::QueueTransition(
+		ID3D12Resource* resource,
+		TrackedResource& trackedResource,
+		UINT subresource,
+		D3D12_RESOURCE_STATES stateBefore,
+		D3D12_RESOURCE_STATES stateAfter)
+	{
+		if (trackedResource.lastBarrier != NO_BARRIER)
+		{
+			PendingBarrier& lastBarrier = pendingBarriers[trackedResource.lastBarrier];
+			D3D12_RESOURCE_TRANSITION_BARRIER& transition = lastBarrier.barrier.Transition;
+
+			// Nothing recorded since has used 'stateBefore', the queued barrier can go straight to the
+			// new state.
+			if (lastBarrier.barrier.Type == D3D12_RESOURCE_BARRIER_TYPE_TRANSITION &&
+				lastBarrier.barrier.Flags == D3D12_RESOURCE_BARRIER_FLAG_NONE &&
+				transition.Subresource == subresource)
+			{
+				if (IsReadState(stateBefore) && IsReadState(stateAfter))
+					stateAfter = stateBefore | stateAfter;
+
+				if (transition.StateBefore == stateAfter)
+				{
+					lastBarrier.removed = true;
+					trackedResource.lastBarrier = NO_BARRIER;
+				}
+				else
+				{
+					transition.StateAfter = stateAfter;
+				}
+
+				statistics.mergedTransitionCount++;
+				return stateAfter;
+			}
+		}
+
+		trackedResource.lastBarrier = QueueBarrier(
+			Dx12Barrier::CreateTransitionBarrier(resource, stateBefore, stateAfter, subresource));
+
+		return stateAfter;
+	}
+	size_t Dx12ResourceStateTracker::QueueBarrier(const D3D12_RESOURCE_BARRIER& barrier)
+	{
+		pendingBarriers.push_back(PendingBarrier{ barrier, false });
+		return pendingBarriers.size() - 1;
+	}
+
+	D3D12_RESOURCE_STATES Dx12ResourceStateTracker::GetSubresourceState(const TrackedResource& trackedResource, UINT subresource)
+	{
+		if (trackedResource.subresourceStates.empty())
+			return trackedResource.state;
+
+		assert(subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES &&
+			"Subresources are in different states, ask for one of them!");
+		assert(subresource < trackedResource.subresourceCount && "Invalid subresource!");
+
+		return trackedResource.subresourceStates[subresource];
+	}
+	void Dx12ResourceStateTracker::SetSubresourceState(TrackedResource& trackedResource, UINT subresource, D3D12_RESOURCE_STATES state)
+	{
+		if (subresource == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES)
+		{
+			trackedResource.state = state;
+			trackedResource.subresourceStates.clear();
+			return;
+		}
+
+		assert(subresource < trackedResource.subresourceCount && "Invalid subresource!");
+
+		if (trackedResource.subresourceStates.empty())
+		{
+			if (state == trackedResource.state)
+				return;
+
+			trackedResource.subresourceStates.assign(trackedResource.subresourceCount, trackedResource.state);
+		}
+
+		trackedResource.subresourceStates[subresource] = state;
+
+		// Back to one state when they're all in the same.
+		if (std::all_of(trackedResource.subresourceStates.begin(), trackedResource.subresourceStates.end(),
+			[state](D3D12_RESOURCE_STATES subresourceState) { return subresourceState == state; }))
+		{
+			trackedResource.state = state;
+			trackedResource.subresourceStates.clear();
+		}
+	}
+
+	bool Dx12ResourceStateTracker::IsReadState(D3D12_RESOURCE_STATES state)
+	{
+		return state != D3D12_RESOURCE_STATE_COMMON && (state & ~READ_RESOURCE_STATES) == 0;
+	}
+	bool Dx12ResourceStateTracker::IsTransitionNeeded(D3D12_RESOURCE_STATES stateBefore, D3D12_RESOURCE_STATES stateAfter)
+	{
+		if (stateBefore == stateAfter)
+			return false;
+
+		// Reading in a state that's part of the current combination of read states.
+		return !(IsReadState(stateBefore) && IsReadState(stateAfter) && (stateBefore & stateAfter) == stateAfter);
+	}
+}
@@ -2,6 +2,8 @@
 
 #include "Core/Error.h"
 
+#include <climits>
+
 using namespace Microsoft::WRL;
 
 namespace dxe
@@ -15,6 +17,70 @@ namespace dxe
 		rootSignatureDesc.pStaticSamplers = nullptr;
 		rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 
+		SerializeRootSignature(device, rootSignatureDesc);
+		bindless = false;
+	}
+	void Dx12RootSignature::CreateBindlessRootSignature(ID3D12Device* device)
+	{
+		// Tier 1 caps a stage at 128 SRVs, unbounded tables need tier 2.
+		D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+		DX12_THROW_IF_NOT_SUCCESS(
+			device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)),
+			"Failed to query the D3D12 options!");
+		if (options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2)
+			throw Error{ "Bindless root signatures need resource binding tier 2, the device only supports tier 1!" };
+
+		// Views of any kind of resource alias the same descriptors, the shader picks the type.
+		// Descriptors are volatile in root signature 1.0, so the table can change while it's bound.
+		D3D12_DESCRIPTOR_RANGE descriptorRanges[2]{};
+
+		descriptorRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+		descriptorRanges[0].NumDescriptors = UINT_MAX;
+		descriptorRanges[0].BaseShaderRegister = 0;
+		descriptorRanges[0].RegisterSpace = 1;
+		descriptorRanges[0].OffsetInDescriptorsFromTableStart = 0;
+
+		descriptorRanges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
+		descriptorRanges[1].NumDescriptors = UINT_MAX;
+		descriptorRanges[1].BaseShaderRegister = 0;
+		descriptorRanges[1].RegisterSpace = 2;
+		descriptorRanges[1].OffsetInDescriptorsFromTableStart = 0;
+
+		D3D12_ROOT_PARAMETER rootParameters[2]{};
+
+		rootParameters[DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+		rootParameters[DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER].Constants.ShaderRegister = 0;
+		rootParameters[DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER].Constants.RegisterSpace = 0;
+		rootParameters[DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER].Constants.Num32BitValues = DX12_BINDLESS_ROOT_CONSTANT_COUNT;
+		rootParameters[DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+		rootParameters[DX12_BINDLESS_TABLE_PARAMETER].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
+		rootParameters[DX12_BINDLESS_TABLE_PARAMETER].DescriptorTable.NumDescriptorRanges = _countof(descriptorRanges);
+		rootParameters[DX12_BINDLESS_TABLE_PARAMETER].DescriptorTable.pDescriptorRanges = descriptorRanges;
+		rootParameters[DX12_BINDLESS_TABLE_PARAMETER].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+		D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{};
+		rootSignatureDesc.NumParameters = _countof(rootParameters);
+		rootSignatureDesc.pParameters = rootParameters;
+		rootSignatureDesc.NumStaticSamplers = 0;
+		rootSignatureDesc.pStaticSamplers = nullptr;
+		rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+		SerializeRootSignature(device, rootSignatureDesc);
+		bindless = true;
+	}
+
+	ID3D12RootSignature* Dx12RootSignature::GetRootSignature() const
+	{
+		return rootSignature.Get();
+	}
+	bool Dx12RootSignature::IsBindless() const
+	{
+		return bindless;
+	}
+
+	void Dx12RootSignature::SerializeRootSignature(ID3D12Device* device, const D3D12_ROOT_SIGNATURE_DESC& rootSignatureDesc)
+	{
 		ComPtr<ID3DBlob> signature;
 		ComPtr<ID3DBlob> error;
 
@@ -31,9 +97,4 @@ namespace dxe
 				IID_PPV_ARGS(rootSignature.ReleaseAndGetAddressOf())),
 			"");
 	}
-
-	ID3D12RootSignature* Dx12RootSignature::GetRootSignature() const
-	{
-		return rootSignature.Get();
-	}
 }
\ No newline at end of file
@@ -117,11 +117,51 @@ namespace dxe
 		}
 	}
 
+	void Dx12ShaderFactory::CreateVertexShader(Dx12ShaderData& shader, const std::vector<uint8_t>& shaderSource)
+	{
+		CompileShaderSource(shader, shaderSource, "vs_5_0");
+	}
+	void Dx12ShaderFactory::CreatePixelShader(Dx12ShaderData& shader, const std::vector<uint8_t>& shaderSource)
+	{
+		CompileShaderSource(shader, shaderSource, "ps_5_0");
+	}
+
 	void Dx12ShaderFactory::DestroyShader(Dx12ShaderData& shader)
 	{
 		shader.shader.Reset();
 	}
 
+	void Dx12ShaderFactory::CompileShaderSource(
+		Dx12ShaderData& shader,
+		const std::vector<uint8_t>& shaderSource,
+		const char* shaderTarget)
+	{
+#if defined(_DEBUG)
+		UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+		UINT compileFlags = 0;
+#endif
+
+		ComPtr<ID3DBlob> errorBlob;
+
+		std::string sourceName = shader.shaderPath.string();
+
+		HRESULT hr = D3DCompile(
+			shaderSource.data(), shaderSource.size(),
+			sourceName.c_str(),
+			nullptr, nullptr,
+			shader.entryPoint.c_str(), shaderTarget,
+			compileFlags, 0,
+			shader.shader.ReleaseAndGetAddressOf(),
+			errorBlob.ReleaseAndGetAddressOf());
+
+		if (!SUCCEEDED(hr) && errorBlob && errorBlob->GetBufferSize() != 0)
+		{
+			THROW_DX12_ERROR(reinterpret_cast<char*>(errorBlob->GetBufferPointer()));
+		}
+		DX12_THROW_IF_NOT_SUCCESS(hr, "Failed to compile a shader!");
+	}
+
 	std::vector<char> Dx12ShaderFactory::ReadShaderFile(const std::filesystem::path& shaderFilePath)
 	{
 		std::ifstream shaderFile(shaderFilePath, std::ifstream::ate | std::ifstream::binary);
@@ -8,12 +8,27 @@ using namespace Microsoft::WRL;
 
 namespace dxe
 {
+	static DXGI_FORMAT GetSrgbFormat(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+			case DXGI_FORMAT_R8G8B8A8_UNORM:
+				return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+			case DXGI_FORMAT_B8G8R8A8_UNORM:
+				return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+			default:
+				// Float formats are linear already.
+				return format;
+		}
+	}
+
 	Dx12SwapChain::Dx12SwapChain(
 		uint32_t frameBufferCount,
-		DXGI_FORMAT rtvFormat,
+		DXGI_FORMAT bufferFormat,
 		DXGI_SWAP_EFFECT swapChainEffect)
 		: frameBufferCount(frameBufferCount),
-		rtvFormat(rtvFormat),
+		bufferFormat(bufferFormat),
+		rtvFormat(GetSrgbFormat(bufferFormat)),
 		swapChainEffect(swapChainEffect)
 	{
 		swapChainBuffers.resize(frameBufferCount);
@@ -68,6 +83,10 @@ namespace dxe
 	{
 		return rtvHeap->GetDescriptorHandle(frameBufferIndex);;
 	}
+	DXGI_FORMAT Dx12SwapChain::GetRtvFormat() const
+	{
+		return rtvFormat;
+	}
 
 	void Dx12SwapChain::CreateRtvHeap(ID3D12Device* device)
 	{
@@ -81,7 +100,7 @@ namespace dxe
 		swapChainDesc.BufferCount = frameBufferCount;
 		swapChainDesc.Width = window->GetWindowWidth();
 		swapChainDesc.Height = window->GetWindowHeight();
-		swapChainDesc.Format = rtvFormat;
+		swapChainDesc.Format = bufferFormat;
 		swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 		swapChainDesc.SwapEffect = swapChainEffect;
 		swapChainDesc.SampleDesc.Count = 1;
@@ -111,6 +130,10 @@ namespace dxe
 
 	void Dx12SwapChain::CreateFrameResources(ID3D12Device* device)
 	{
+		D3D12_RENDER_TARGET_VIEW_DESC rtvDesc{};
+		rtvDesc.Format = rtvFormat;
+		rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D;
+
 		for (uint32_t frameIdx{ 0 }; frameIdx < frameBufferCount; frameIdx++)
 		{
 			DX12_THROW_IF_NOT_SUCCESS(
@@ -120,7 +143,7 @@ namespace dxe
 
 			device->CreateRenderTargetView(
 				swapChainBuffers[frameIdx].Get(),
-				nullptr,
+				&rtvDesc,
 				rtvHeap->GetDescriptorHandle(frameIdx));
 		}
 	}
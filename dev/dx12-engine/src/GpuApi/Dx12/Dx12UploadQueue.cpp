@@ -0,0 +1,192 @@
+#include "GpuApi/Dx12/Dx12UploadQueue.h"
+
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace Microsoft::WRL;
+
+namespace dxe
+{
+	// Buffer copies have no alignment requirements; a small one keeps consecutive uploads contiguous
+	// in the ring so the batcher can merge their copies.
+	constexpr uint64_t DX12_UPLOAD_STAGING_ALIGNMENT = 4;
+
+	Dx12UploadQueue::Dx12UploadQueue(
+		ID3D12Device* device,
+		Dx12CopyQueue* copyQueue,
+		Dx12UploadRing* uploadRing,
+		const UploadBatcherDesc& desc)
+		: device(device),
+		copyQueue(copyQueue),
+		uploadRing(uploadRing),
+		batcher(this, desc)
+	{
+		assert(device && copyQueue && uploadRing && "Upload queue needs a device, a copy queue and an upload ring!");
+
+		if (desc.maxBatchSize > uploadRing->GetStatistics().capacity / 2)
+			throw Error{ "Upload batches must not exceed half of the upload ring!" };
+	}
+
+	Dx12UploadQueue::~Dx12UploadQueue()
+	{
+		// Command allocators and staging memory must not go while the copy queue uses them.
+		uint64_t fenceValue = Flush();
+		if (fenceValue > 0)
+			copyQueue->GetQueueFence()->WaitForValue(fenceValue);
+	}
+
+	void Dx12UploadQueue::UploadBuffer(ID3D12Resource* destination, uint64_t destinationOffset, const void* data, uint64_t size)
+	{
+		assert(destination && "Invalid upload destination!");
+		assert(destinationOffset + size <= destination->GetDesc().Width && "Upload is out of the destination's bounds!");
+
+		if (size == 0)
+			return;
+
+		batcher.Upload(destination, destinationOffset, data, size);
+	}
+
+	uint64_t Dx12UploadQueue::CopyBufferRegions(ID3D12Resource* buffer, const std::vector<Dx12BufferRegionCopy>& copies)
+	{
+		assert(buffer && "Invalid buffer to copy in!");
+
+		if (copies.empty())
+			return Flush();
+
+		// The copies may read uploaded data, so the uploads go first; the queue finishes one
+		// submission before the next one starts using the buffer.
+		Flush();
+
+		CopyContext* context = OpenCopyContext();
+		for (const Dx12BufferRegionCopy& copy : copies)
+		{
+			assert(copy.sourceOffset + copy.size <= buffer->GetDesc().Width &&
+				copy.destinationOffset + copy.size <= buffer->GetDesc().Width && "Buffer copy is out of bounds!");
+
+			context->commandList->CopyBufferRegion(buffer, copy.destinationOffset, buffer, copy.sourceOffset, copy.size);
+		}
+
+		regionCopyFenceValue = SubmitCopies();
+		return regionCopyFenceValue;
+	}
+
+	uint64_t Dx12UploadQueue::Flush()
+	{
+		return std::max(batcher.Flush(), regionCopyFenceValue);
+	}
+
+	void Dx12UploadQueue::SynchronizeQueue(Dx12Queue* queue)
+	{
+		assert(queue && "Invalid queue to synchronize!");
+
+		uint64_t fenceValue = Flush();
+		if (fenceValue == 0)
+			return;
+
+		for (auto& [synchronizedQueue, synchronizedValue] : synchronizedValues)
+		{
+			if (synchronizedQueue != queue)
+				continue;
+
+			if (synchronizedValue < fenceValue)
+			{
+				queue->WaitForFence(copyQueue->GetQueueFence(), fenceValue);
+				synchronizedValue = fenceValue;
+			}
+			return;
+		}
+
+		queue->WaitForFence(copyQueue->GetQueueFence(), fenceValue);
+		synchronizedValues.emplace_back(queue, fenceValue);
+	}
+
+	UploadStatistics Dx12UploadQueue::GetStatistics() const
+	{
+		return batcher.GetStatistics();
+	}
+
+	UploadStaging Dx12UploadQueue::AllocateStaging(uint64_t size)
+	{
+		Dx12UploadAllocation allocation = uploadRing->Allocate(size, DX12_UPLOAD_STAGING_ALIGNMENT);
+		return UploadStaging{ allocation.cpuAddress, allocation.offset };
+	}
+
+	void Dx12UploadQueue::RecordCopy(const UploadCopy& copy)
+	{
+		if (openContextIndex == SIZE_MAX)
+			OpenCopyContext();
+
+		copyContexts[openContextIndex].commandList->CopyBufferRegion(
+			static_cast<ID3D12Resource*>(copy.destination), copy.destinationOffset,
+			uploadRing->GetResource(), copy.stagingOffset,
+			copy.size);
+	}
+
+	uint64_t Dx12UploadQueue::SubmitCopies()
+	{
+		assert(openContextIndex != SIZE_MAX && "No copies to submit!");
+
+		CopyContext& context = copyContexts[openContextIndex];
+		openContextIndex = SIZE_MAX;
+
+		DX12_THROW_IF_NOT_SUCCESS(
+			context.commandList->Close(),
+			"Failed to close the Copy Command List!");
+
+		ID3D12CommandList* ppCommandLists[] = { context.commandList.Get() };
+		copyQueue->GetCommandQueue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+
+		context.fenceValue = copyQueue->SignalFence(copyQueue->GetQueueFence());
+		uploadRing->Submit(context.fenceValue);
+
+		return context.fenceValue;
+	}
+
+	Dx12UploadQueue::CopyContext* Dx12UploadQueue::OpenCopyContext()
+	{
+		Dx12Fence* fence = copyQueue->GetQueueFence();
+
+		size_t index = 0;
+		while (index < copyContexts.size() && !fence->IsComplete(copyContexts[index].fenceValue))
+			index++;
+
+		if (index == copyContexts.size())
+		{
+			CopyContext context{};
+
+			DX12_THROW_IF_NOT_SUCCESS(
+				device->CreateCommandAllocator(
+					D3D12_COMMAND_LIST_TYPE_COPY,
+					IID_PPV_ARGS(context.commandAllocator.GetAddressOf())),
+				"Failed to create a Copy Command Allocator!");
+
+			// Created open, ready to record.
+			DX12_THROW_IF_NOT_SUCCESS(
+				device->CreateCommandList(
+					0, D3D12_COMMAND_LIST_TYPE_COPY,
+					context.commandAllocator.Get(), nullptr,
+					IID_PPV_ARGS(context.commandList.GetAddressOf())),
+				"Failed to create a Copy Command List!");
+
+			copyContexts.push_back(std::move(context));
+		}
+		else
+		{
+			CopyContext& context = copyContexts[index];
+
+			DX12_THROW_IF_NOT_SUCCESS(
+				context.commandAllocator->Reset(),
+				"Failed to reset the Copy Command Allocator!");
+			DX12_THROW_IF_NOT_SUCCESS(
+				context.commandList->Reset(context.commandAllocator.Get(), nullptr),
+				"Failed to reset the Copy Command List!");
+		}
+
+		openContextIndex = index;
+		return &copyContexts[index];
+	}
+}
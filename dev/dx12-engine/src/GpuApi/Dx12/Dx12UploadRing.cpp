@@ -0,0 +1,104 @@
+#include "GpuApi/Dx12/Dx12UploadRing.h"
+
+#include "GpuApi/Dx12/Dx12Buffer.h"
+#include "GpuApi/Dx12/Dx12Fence.h"
+
+#include "Core/Error.h"
+#include "Core/Logger.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	Dx12UploadRing::Dx12UploadRing(
+		ID3D12Device* device,
+		Dx12HeapAllocator* heapAllocator,
+		Dx12Fence* fence,
+		uint64_t ringSize)
+		: device(device),
+		heapAllocator(heapAllocator),
+		fence(fence),
+		ring(ringSize)
+	{
+		assert(device && heapAllocator && fence && "Upload ring needs a device, a heap allocator and a fence!");
+		assert(heapAllocator->GetHeapType() == D3D12_HEAP_TYPE_UPLOAD && "Upload ring memory has to be in an UPLOAD heap!");
+
+		D3D12_RESOURCE_DESC resourceDesc = CreateBufferResourceDesc(ringSize);
+		allocation = heapAllocator->Allocate(resourceDesc);
+
+		DX12_THROW_IF_NOT_SUCCESS(
+			device->CreatePlacedResource(
+				allocation.heap, allocation.offset,
+				&resourceDesc,
+				D3D12_RESOURCE_STATE_GENERIC_READ,
+				nullptr,
+				IID_PPV_ARGS(buffer.ReleaseAndGetAddressOf())),
+			"Failed to create the Upload Ring Placed Resource!");
+
+		// Mapped once for the lifetime of the ring.
+		D3D12_RANGE readRange{ 0, 0 };
+		DX12_THROW_IF_NOT_SUCCESS(
+			buffer->Map(0, &readRange, reinterpret_cast<void**>(&mappedData)),
+			"Failed to map the Upload Ring!");
+
+		gpuAddress = buffer->GetGPUVirtualAddress();
+	}
+
+	Dx12UploadRing::~Dx12UploadRing()
+	{
+		// The placed resource goes before the memory it lives in.
+		buffer.Reset();
+		heapAllocator->Free(allocation);
+	}
+
+	Dx12UploadAllocation Dx12UploadRing::Allocate(uint64_t size, uint64_t alignment)
+	{
+		if (!ring.CanAllocate(size, alignment))
+			ring.Retire(fence->GetCompletedValue());
+
+		// Full with work the GPU hasn't finished: a stall.
+		while (!ring.CanAllocate(size, alignment))
+		{
+			if (!ring.HasPendingBatches())
+				throw Error{ "Upload ring is too small for the allocation!" };
+
+			uint64_t fenceValue = ring.GetOldestPendingFenceValue();
+			Logger::Warn("Upload ring is full, waiting for the GPU to reach fence value {}.", fenceValue);
+			stallCount++;
+
+			fence->WaitForValue(fenceValue);
+			ring.Retire(fence->GetCompletedValue());
+		}
+
+		uint64_t offset = ring.Allocate(size, alignment);
+
+		Dx12UploadAllocation uploadAllocation{};
+		uploadAllocation.resource = buffer.Get();
+		uploadAllocation.offset = offset;
+		uploadAllocation.size = size;
+		uploadAllocation.cpuAddress = mappedData + offset;
+		uploadAllocation.gpuAddress = gpuAddress + offset;
+		return uploadAllocation;
+	}
+
+	void Dx12UploadRing::Submit(uint64_t fenceValue)
+	{
+		ring.Submit(fenceValue);
+	}
+	void Dx12UploadRing::Retire()
+	{
+		ring.Retire(fence->GetCompletedValue());
+	}
+
+	RingStatistics Dx12UploadRing::GetStatistics() const
+	{
+		RingStatistics statistics = ring.GetStatistics();
+		statistics.stallCount = stallCount;
+		return statistics;
+	}
+
+	ID3D12Resource* Dx12UploadRing::GetResource() const
+	{
+		return buffer.Get();
+	}
+}
@@ -0,0 +1,30 @@
+#include "GpuApi/FenceTimeline.h"
+
+namespace dxe
+{
+	uint64_t FenceTimeline::Advance()
+	{
+		return ++signaledValue;
+	}
+
+	uint64_t FenceTimeline::UpdateCompletedValue(uint64_t readValue)
+	{
+		completedValue = std::max(completedValue, readValue);
+		return completedValue;
+	}
+
+	void FenceTimeline::Reset()
+	{
+		signaledValue = 0;
+		completedValue = 0;
+	}
+
+	uint64_t FenceTimeline::GetValue() const
+	{
+		return signaledValue;
+	}
+	uint64_t FenceTimeline::GetCompletedValue() const
+	{
+		return completedValue;
+	}
+}
@@ -0,0 +1,147 @@
+#include "IO/IoBackend.h"
+
+#include "IO/IoUringBackend.h"
+
+#include "Core/Logger.h"
+
+#include <fstream>
+
+namespace dxe
+{
+	// IoThreadPoolBackend
+
+	IoThreadPoolBackend::IoThreadPoolBackend(uint32_t threadCount, uint32_t queueDepth)
+		: threadPool(std::make_unique<ThreadPool>(threadCount)),
+		queueDepth(queueDepth)
+	{
+	}
+
+	IoBackendType IoThreadPoolBackend::GetBackendType() const
+	{
+		return IoBackendType::THREAD_POOL;
+	}
+
+	uint32_t IoThreadPoolBackend::GetQueueDepth() const
+	{
+		return queueDepth;
+	}
+	uint32_t IoThreadPoolBackend::GetInFlightCount() const
+	{
+		std::lock_guard<std::mutex> lock{ completionMutex };
+		return inFlightCount;
+	}
+
+	void IoThreadPoolBackend::Submit(std::vector<IoReadRequest>& batch)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ completionMutex };
+			inFlightCount += static_cast<uint32_t>(batch.size());
+		}
+
+		for (IoReadRequest& request : batch)
+		{
+			threadPool->Execute(
+				[this, request = std::move(request)]() mutable {
+					ExecuteRead(request);
+				});
+		}
+		batch.clear();
+	}
+	uint32_t IoThreadPoolBackend::Reap(bool wait)
+	{
+		// Callbacks already ran on the pool threads, only the bookkeeping is left.
+
+		std::unique_lock<std::mutex> lock{ completionMutex };
+		if (wait)
+		{
+			completionCondition.wait(lock, [this]() {
+				return unreapedCount > 0 || inFlightCount == 0 || wakeRequested;
+			});
+		}
+		wakeRequested = false;
+
+		uint32_t reaped = unreapedCount;
+		unreapedCount = 0;
+		return reaped;
+	}
+	void IoThreadPoolBackend::Wake()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ completionMutex };
+			wakeRequested = true;
+		}
+		completionCondition.notify_all();
+	}
+
+	void IoThreadPoolBackend::ExecuteRead(IoReadRequest& request)
+	{
+		IoReadResult result = ReadFileBlocking(request);
+
+		if (request.onComplete)
+			request.onComplete(result);
+
+		// Notified under the lock: once the dispatcher has reaped the last read, the backend may be
+		// destroyed, condition variable included.
+		std::lock_guard<std::mutex> lock{ completionMutex };
+		inFlightCount--;
+		unreapedCount++;
+		completionCondition.notify_all();
+	}
+
+	// Free functions
+
+	IoReadResult ReadFileBlocking(const IoReadRequest& request)
+	{
+		IoReadResult result{};
+		result.path = request.path;
+		result.offset = request.offset;
+
+		std::ifstream file(request.path, std::ifstream::ate | std::ifstream::binary);
+		if (!file.is_open())
+		{
+			result.errorMessage = "Couldn't open the file: " + request.path.string();
+			return result;
+		}
+
+		uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+		if (request.offset > fileSize)
+		{
+			result.errorMessage = "Read offset is past the end of the file: " + request.path.string();
+			return result;
+		}
+
+		uint64_t readSize = request.size != 0 ? request.size : fileSize - request.offset;
+		if (request.offset + readSize > fileSize)
+		{
+			result.errorMessage = "Read range is past the end of the file: " + request.path.string();
+			return result;
+		}
+
+		result.data.resize(readSize);
+
+		file.seekg(request.offset);
+		file.read(reinterpret_cast<char*>(result.data.data()), readSize);
+
+		if (!file)
+		{
+			result.data.clear();
+			result.errorMessage = "Failed to read the file: " + request.path.string();
+			return result;
+		}
+
+		result.succeeded = true;
+		return result;
+	}
+
+	std::unique_ptr<IoBackend> CreateIoBackend(uint32_t queueDepth, uint32_t fallbackThreadCount)
+	{
+#if defined(__linux__)
+		if (IoUringBackend::IsSupported())
+		{
+			return std::make_unique<IoUringBackend>(queueDepth);
+		}
+		Logger::Warn("io_uring is not available, falling back to the thread pool I/O backend.");
+#endif
+		return std::make_unique<IoThreadPoolBackend>(fallbackThreadCount, queueDepth);
+	}
+}
\ No newline at end of file
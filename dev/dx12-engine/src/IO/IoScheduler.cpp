@@ -0,0 +1,186 @@
+#include "IO/IoScheduler.h"
+
+#include <algorithm>
+
+namespace dxe
+{
+	IoScheduler::IoScheduler(const IoSchedulerSettings& settings)
+	{
+		if (settings.forceThreadPoolBackend)
+		{
+			backend = std::make_unique<IoThreadPoolBackend>(settings.fallbackThreadCount, settings.queueDepth);
+		}
+		else
+		{
+			backend = CreateIoBackend(settings.queueDepth, settings.fallbackThreadCount);
+		}
+
+		dispatcherThread = std::thread(&IoScheduler::DispatchLoop, this);
+	}
+	IoScheduler::~IoScheduler()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ schedulerMutex };
+			stopRequested = true;
+		}
+		pendingCondition.notify_all();
+
+		dispatcherThread.join();
+	}
+
+	void IoScheduler::Read(IoReadRequest request)
+	{
+		std::vector<IoReadRequest> requests;
+		requests.push_back(std::move(request));
+		Read(requests);
+	}
+	void IoScheduler::Read(std::vector<IoReadRequest>& requests)
+	{
+		for (IoReadRequest& request : requests)
+		{
+			IoReadRequest::CompletionCallback userCallback = std::move(request.onComplete);
+			request.onComplete = [this, userCallback = std::move(userCallback)](IoReadResult& result) {
+				{
+					std::lock_guard<std::mutex> lock{ schedulerMutex };
+					stats.requestsCompleted++;
+					stats.bytesRead += result.data.size();
+				}
+				if (userCallback)
+					userCallback(result);
+			};
+		}
+
+		bool wakeBackend{ false };
+		{
+			std::lock_guard<std::mutex> lock{ schedulerMutex };
+
+			outstandingCount += requests.size();
+			pendingRequests.insert(
+				pendingRequests.end(),
+				std::make_move_iterator(requests.begin()),
+				std::make_move_iterator(requests.end()));
+			pendingSorted = false;
+
+			wakeBackend = wakeOnRead;
+			wakeOnRead = false;
+		}
+		requests.clear();
+
+		pendingCondition.notify_one();
+		if (wakeBackend)
+			backend->Wake();
+	}
+
+	std::future<IoReadResult> IoScheduler::ReadAsync(IoReadRequest request)
+	{
+		auto promise = std::make_shared<std::promise<IoReadResult>>();
+		std::future<IoReadResult> future = promise->get_future();
+
+		IoReadRequest::CompletionCallback userCallback = std::move(request.onComplete);
+		request.onComplete = [promise, userCallback = std::move(userCallback)](IoReadResult& result) {
+			if (userCallback)
+				userCallback(result);
+			promise->set_value(std::move(result));
+		};
+
+		Read(std::move(request));
+		return future;
+	}
+
+	void IoScheduler::WaitIdle()
+	{
+		std::unique_lock<std::mutex> lock{ schedulerMutex };
+		idleCondition.wait(lock, [this]() {
+			return outstandingCount == 0;
+		});
+	}
+
+	IoBackendType IoScheduler::GetBackendType() const
+	{
+		return backend->GetBackendType();
+	}
+	IoSchedulerStats IoScheduler::GetStats() const
+	{
+		std::lock_guard<std::mutex> lock{ schedulerMutex };
+		return stats;
+	}
+
+	void IoScheduler::DispatchLoop()
+	{
+		std::vector<IoReadRequest> batch;
+		batch.reserve(backend->GetQueueDepth());
+
+		while (true)
+		{
+			uint32_t inFlightCount = backend->GetInFlightCount();
+
+			{
+				std::unique_lock<std::mutex> lock{ schedulerMutex };
+
+				if (inFlightCount == 0)
+				{
+					pendingCondition.wait(lock, [this]() {
+						return stopRequested || !pendingRequests.empty();
+					});
+
+					// Everything issued before the stop request has been served by now.
+					if (pendingRequests.empty())
+						return;
+				}
+
+				TakeBatch(batch, backend->GetQueueDepth() - inFlightCount);
+				if (!batch.empty())
+					stats.batchesSubmitted++;
+			}
+
+			if (!batch.empty())
+				backend->Submit(batch);
+
+			// Only waits when there's nothing to submit: with a full queue until a read finishes, with
+			// free slots also until new requests arrive (Read wakes the backend then).
+			bool wait{ false };
+			{
+				std::lock_guard<std::mutex> lock{ schedulerMutex };
+
+				bool queueFull = backend->GetInFlightCount() == backend->GetQueueDepth();
+				wait = queueFull || pendingRequests.empty();
+				wakeOnRead = wait && !queueFull;
+			}
+
+			uint32_t completedCount = backend->Reap(wait);
+
+			{
+				std::lock_guard<std::mutex> lock{ schedulerMutex };
+				wakeOnRead = false;
+
+				outstandingCount -= completedCount;
+				if (completedCount > 0 && outstandingCount == 0)
+					idleCondition.notify_all();
+			}
+		}
+	}
+
+	void IoScheduler::TakeBatch(std::vector<IoReadRequest>& batch, uint32_t maxBatchSize)
+	{
+		if (pendingRequests.empty() || maxBatchSize == 0)
+			return;
+
+		// Sorted in descending order so the most urgent requests sit at the back
+		// and can be popped without shifting the rest of the queue.
+		if (!pendingSorted)
+		{
+			std::sort(pendingRequests.begin(), pendingRequests.end(),
+				[](const IoReadRequest& r1, const IoReadRequest& r2) {
+					return IoReadRequestOrder(r2, r1);
+				});
+			pendingSorted = true;
+		}
+
+		size_t batchSize = std::min<size_t>(maxBatchSize, pendingRequests.size());
+		for (size_t requestIdx = 0; requestIdx < batchSize; requestIdx++)
+		{
+			batch.push_back(std::move(pendingRequests.back()));
+			pendingRequests.pop_back();
+		}
+	}
+}
\ No newline at end of file
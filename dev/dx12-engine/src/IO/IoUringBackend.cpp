@@ -0,0 +1,440 @@
+#include "IO/IoUringBackend.h"
+
+#if defined(__linux__)
+
+#include "Core/Error.h"
+
+#include <linux/io_uring.h>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+namespace dxe
+{
+	// The kernel refuses single reads larger than this.
+	constexpr uint64_t maxReadChunkSize = 0x7ffff000;
+
+	static int IoUringSetup(uint32_t entries, io_uring_params* params)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+	}
+	static int IoUringEnter(int ringFd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0));
+	}
+	static int IoUringRegister(int ringFd, uint32_t opcode, void* arg, uint32_t argCount)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_register, ringFd, opcode, arg, argCount));
+	}
+
+	static uint64_t PackUserData(uint32_t slot, uint32_t operation)
+	{
+		return (static_cast<uint64_t>(operation) << 32) | slot;
+	}
+
+	IoUringBackend::IoUringBackend(uint32_t queueDepth)
+		: queueDepth(queueDepth)
+	{
+		SetupRing();
+
+		slots.resize(this->queueDepth);
+		freeSlots.reserve(this->queueDepth);
+		for (uint32_t slot = this->queueDepth; slot > 0; slot--)
+		{
+			freeSlots.push_back(slot - 1);
+		}
+	}
+	IoUringBackend::~IoUringBackend()
+	{
+		while (inFlightCount > 0)
+		{
+			Reap(true);
+		}
+		DestroyRing();
+	}
+
+	bool IoUringBackend::IsSupported()
+	{
+		static const bool supported = []() {
+			io_uring_params params{};
+			int fd = IoUringSetup(1, &params);
+			if (fd < 0)
+				return false;
+
+			// The probe came with the READ, OPENAT and STATX operations (5.6), older kernels fail it.
+			constexpr uint32_t probeOpCount = 256;
+			std::vector<uint8_t> probeStorage(sizeof(io_uring_probe) + probeOpCount * sizeof(io_uring_probe_op));
+			io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probeStorage.data());
+
+			bool probed = IoUringRegister(fd, IORING_REGISTER_PROBE, probe, probeOpCount) >= 0;
+			close(fd);
+
+			if (!probed)
+				return false;
+
+			for (uint32_t op : { IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ })
+			{
+				if (op > probe->last_op || (probe->ops[op].flags & IO_URING_OP_SUPPORTED) == 0)
+					return false;
+			}
+			return true;
+		}();
+		return supported;
+	}
+
+	IoBackendType IoUringBackend::GetBackendType() const
+	{
+		return IoBackendType::IO_URING;
+	}
+
+	uint32_t IoUringBackend::GetQueueDepth() const
+	{
+		return queueDepth;
+	}
+	uint32_t IoUringBackend::GetInFlightCount() const
+	{
+		return inFlightCount;
+	}
+
+	void IoUringBackend::Submit(std::vector<IoReadRequest>& batch)
+	{
+		assert(batch.size() <= freeSlots.size() && "I/O batch exceeds the queue depth!");
+
+		uint32_t sqeCount{ 0 };
+
+		for (IoReadRequest& request : batch)
+		{
+			uint32_t slot = freeSlots.back();
+			freeSlots.pop_back();
+			inFlightCount++;
+
+			InFlightRead& read = slots[slot];
+			read = InFlightRead{};
+			read.request = std::move(request);
+			read.result.path = read.request.path;
+			read.result.offset = read.request.offset;
+
+			// The size is needed to allocate the data and check the range, the read waits for both.
+			read.pendingSetupCount = 2;
+			PushOpenSqe(slot);
+			PushStatxSqe(slot);
+			sqeCount += 2;
+		}
+		batch.clear();
+
+		SubmitSqes(sqeCount);
+	}
+	uint32_t IoUringBackend::Reap(bool wait)
+	{
+		if (completedSinceReap > 0 || inFlightCount == 0)
+			wait = false;
+
+		// Completions posted after the check still signal the eventfd, so the read doesn't miss them.
+		// It may return for completions reaped earlier, which only costs an empty Reap.
+		if (wait && *cqHead == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+		{
+			uint64_t eventCount{ 0 };
+			while (::read(eventFd, &eventCount, sizeof(eventCount)) < 0 && errno == EINTR) {}
+		}
+
+		uint32_t sqeCount{ 0 };
+
+		uint32_t head = *cqHead;
+		uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+
+		while (head != tail)
+		{
+			const io_uring_cqe& cqe = cqes[head & *cqRingMask];
+			uint32_t slot = static_cast<uint32_t>(cqe.user_data);
+			Operation operation = static_cast<Operation>(cqe.user_data >> 32);
+			int32_t res = cqe.res;
+			head++;
+
+			InFlightRead& read = slots[slot];
+
+			if (operation == Operation::OPEN || operation == Operation::STATX)
+			{
+				if (res == -EINTR || res == -EAGAIN)
+				{
+					if (operation == Operation::OPEN)
+						PushOpenSqe(slot);
+					else
+						PushStatxSqe(slot);
+					sqeCount++;
+					continue;
+				}
+
+				if (operation == Operation::OPEN && res >= 0)
+					read.fileDescriptor = res;
+
+				// The first error wins, the read fails once both operations are done.
+				if (res < 0 && read.result.errorMessage.empty())
+				{
+					read.result.errorMessage = operation == Operation::OPEN ?
+						"Couldn't open the file: " + read.request.path.string() :
+						"Couldn't query the file size: " + read.request.path.string();
+				}
+
+				sqeCount += FinishSetupOperation(slot);
+				continue;
+			}
+
+			if (res == -EINTR || res == -EAGAIN)
+			{
+				PushReadSqe(slot);
+				sqeCount++;
+				continue;
+			}
+			if (res < 0)
+			{
+				FailRead(slot, "Failed to read the file: " + read.request.path.string() + " (" + std::strerror(-res) + ")");
+				continue;
+			}
+			if (res == 0)
+			{
+				FailRead(slot, "Unexpected end of file: " + read.request.path.string());
+				continue;
+			}
+
+			read.bytesRead += static_cast<uint64_t>(res);
+			if (read.bytesRead < read.request.size)
+			{
+				// Short read, queue the remainder.
+				PushReadSqe(slot);
+				sqeCount++;
+				continue;
+			}
+
+			CompleteRead(slot);
+		}
+
+		__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+		SubmitSqes(sqeCount);
+
+		uint32_t reaped = completedSinceReap;
+		completedSinceReap = 0;
+		return reaped;
+	}
+	void IoUringBackend::Wake()
+	{
+		uint64_t eventCount{ 1 };
+		while (::write(eventFd, &eventCount, sizeof(eventCount)) < 0 && errno == EINTR) {}
+	}
+
+	void IoUringBackend::SetupRing()
+	{
+		// Every read starts with an OPEN and a STATX in flight at the same time.
+		io_uring_params params{};
+		ringFd = IoUringSetup(queueDepth * 2, &params);
+		if (ringFd < 0)
+			throw Error{ std::string{ "Failed to create an io_uring instance: " } + std::strerror(errno) };
+
+		// The kernel rounds the entry count up to a power of two.
+		queueDepth = std::min(queueDepth, params.sq_entries / 2);
+
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (singleMmap)
+		{
+			sqRingSize = std::max(sqRingSize, cqRingSize);
+			cqRingSize = sqRingSize;
+		}
+
+		sqRingPtr = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+		if (sqRingPtr == MAP_FAILED)
+			throw Error{ "Failed to map the io_uring submission ring!" };
+
+		if (singleMmap)
+		{
+			cqRingPtr = sqRingPtr;
+		}
+		else
+		{
+			cqRingPtr = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+			if (cqRingPtr == MAP_FAILED)
+				throw Error{ "Failed to map the io_uring completion ring!" };
+		}
+
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqesPtr = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+		if (sqesPtr == MAP_FAILED)
+			throw Error{ "Failed to map the io_uring submission entries!" };
+		sqes = static_cast<io_uring_sqe*>(sqesPtr);
+
+		uint8_t* sqBase = static_cast<uint8_t*>(sqRingPtr);
+		sqHead = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.head);
+		sqTail = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.tail);
+		sqRingMask = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.ring_mask);
+		sqArray = reinterpret_cast<uint32_t*>(sqBase + params.sq_off.array);
+
+		uint8_t* cqBase = static_cast<uint8_t*>(cqRingPtr);
+		cqHead = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.head);
+		cqTail = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.tail);
+		cqRingMask = reinterpret_cast<uint32_t*>(cqBase + params.cq_off.ring_mask);
+		cqes = reinterpret_cast<io_uring_cqe*>(cqBase + params.cq_off.cqes);
+
+		eventFd = eventfd(0, EFD_CLOEXEC);
+		if (eventFd < 0)
+			throw Error{ std::string{ "Failed to create the io_uring eventfd: " } + std::strerror(errno) };
+
+		if (IoUringRegister(ringFd, IORING_REGISTER_EVENTFD, &eventFd, 1) < 0)
+			throw Error{ std::string{ "Failed to register the io_uring eventfd: " } + std::strerror(errno) };
+	}
+	void IoUringBackend::DestroyRing()
+	{
+		if (sqes)
+			munmap(sqes, sqesSize);
+		if (cqRingPtr && cqRingPtr != sqRingPtr)
+			munmap(cqRingPtr, cqRingSize);
+		if (sqRingPtr)
+			munmap(sqRingPtr, sqRingSize);
+		if (ringFd >= 0)
+			close(ringFd);
+		if (eventFd >= 0)
+			close(eventFd);
+	}
+
+	uint32_t IoUringBackend::FinishSetupOperation(uint32_t slot)
+	{
+		InFlightRead& read = slots[slot];
+		if (--read.pendingSetupCount > 0)
+			return 0;
+
+		if (!read.result.errorMessage.empty() || !StartRead(read))
+		{
+			FailRead(slot, read.result.errorMessage);
+			return 0;
+		}
+		if (read.request.size == 0)
+		{
+			CompleteRead(slot);
+			return 0;
+		}
+
+		PushReadSqe(slot);
+		return 1;
+	}
+	bool IoUringBackend::StartRead(InFlightRead& read)
+	{
+		uint64_t fileSize = read.fileStatx.stx_size;
+		if (read.request.offset > fileSize)
+		{
+			read.result.errorMessage = "Read offset is past the end of the file: " + read.request.path.string();
+			return false;
+		}
+
+		if (read.request.size == 0)
+			read.request.size = fileSize - read.request.offset;
+
+		if (read.request.offset + read.request.size > fileSize)
+		{
+			read.result.errorMessage = "Read range is past the end of the file: " + read.request.path.string();
+			return false;
+		}
+
+		read.result.data.resize(read.request.size);
+		return true;
+	}
+
+	io_uring_sqe& IoUringBackend::PushSqe(uint32_t slot, Operation operation)
+	{
+		uint32_t tail = *sqTail;
+		uint32_t index = tail & *sqRingMask;
+
+		io_uring_sqe& sqe = sqes[index];
+		std::memset(&sqe, 0, sizeof(sqe));
+		sqe.user_data = PackUserData(slot, static_cast<uint32_t>(operation));
+
+		sqArray[index] = index;
+		__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+		return sqe;
+	}
+	void IoUringBackend::PushOpenSqe(uint32_t slot)
+	{
+		InFlightRead& read = slots[slot];
+
+		// The entry is only read by the kernel once it's submitted, after this returns.
+		io_uring_sqe& sqe = PushSqe(slot, Operation::OPEN);
+		sqe.opcode = IORING_OP_OPENAT;
+		sqe.fd = AT_FDCWD;
+		sqe.addr = reinterpret_cast<uint64_t>(read.request.path.c_str());
+		sqe.open_flags = O_RDONLY | O_CLOEXEC;
+	}
+	void IoUringBackend::PushStatxSqe(uint32_t slot)
+	{
+		InFlightRead& read = slots[slot];
+
+		io_uring_sqe& sqe = PushSqe(slot, Operation::STATX);
+		sqe.opcode = IORING_OP_STATX;
+		sqe.fd = AT_FDCWD;
+		sqe.addr = reinterpret_cast<uint64_t>(read.request.path.c_str());
+		sqe.len = STATX_SIZE;
+		sqe.off = reinterpret_cast<uint64_t>(&read.fileStatx);
+	}
+	void IoUringBackend::PushReadSqe(uint32_t slot)
+	{
+		InFlightRead& read = slots[slot];
+
+		uint64_t remaining = read.request.size - read.bytesRead;
+
+		io_uring_sqe& sqe = PushSqe(slot, Operation::READ);
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = read.fileDescriptor;
+		sqe.off = read.request.offset + read.bytesRead;
+		sqe.addr = reinterpret_cast<uint64_t>(read.result.data.data() + read.bytesRead);
+		sqe.len = static_cast<uint32_t>(std::min(remaining, maxReadChunkSize));
+	}
+	void IoUringBackend::SubmitSqes(uint32_t sqeCount)
+	{
+		while (sqeCount > 0)
+		{
+			int submitted = IoUringEnter(ringFd, sqeCount, 0, 0);
+			if (submitted < 0)
+			{
+				if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+					continue;
+				throw Error{ std::string{ "Failed to submit io_uring reads: " } + std::strerror(errno) };
+			}
+			sqeCount -= static_cast<uint32_t>(submitted);
+		}
+	}
+
+	void IoUringBackend::CompleteRead(uint32_t slot)
+	{
+		InFlightRead& read = slots[slot];
+
+		if (read.fileDescriptor >= 0)
+			close(read.fileDescriptor);
+
+		read.result.succeeded = read.result.errorMessage.empty();
+
+		if (read.request.onComplete)
+			read.request.onComplete(read.result);
+
+		read = InFlightRead{};
+		freeSlots.push_back(slot);
+
+		inFlightCount--;
+		completedSinceReap++;
+	}
+	void IoUringBackend::FailRead(uint32_t slot, const std::string& errorMessage)
+	{
+		InFlightRead& read = slots[slot];
+		read.result.data.clear();
+		read.result.errorMessage = errorMessage;
+		CompleteRead(slot);
+	}
+}
+
+#endif
\ No newline at end of file
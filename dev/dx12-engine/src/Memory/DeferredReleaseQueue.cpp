@@ -0,0 +1,74 @@
+#include "Memory/DeferredReleaseQueue.h"
+
+#include "Core/Error.h"
+
+namespace dxe
+{
+	DeferredReleaseQueue::DeferredReleaseQueue(uint32_t timelineCount)
+	{
+		if (timelineCount == 0)
+			throw Error{ "Deferred release queue needs at least one timeline!" };
+
+		timelines.resize(timelineCount);
+	}
+
+	DeferredReleaseQueue::~DeferredReleaseQueue()
+	{
+		ReleaseAll();
+	}
+
+	size_t DeferredReleaseQueue::Retire(uint32_t timeline, uint64_t completedFenceValue)
+	{
+		assert(timeline < timelines.size() && "Invalid timeline!");
+
+		std::deque<PendingObject>& pendingObjects = timelines[timeline];
+
+		size_t releasedCount = 0;
+		while (!pendingObjects.empty() && pendingObjects.front().fenceValue <= completedFenceValue)
+		{
+			// Out of the queue before it's destroyed, its destructor may defer other objects.
+			std::unique_ptr<DeferredObjectBase> object = std::move(pendingObjects.front().object);
+			pendingObjects.pop_front();
+			object.reset();
+
+			releasedCount++;
+		}
+
+		statistics.releasedCount += releasedCount;
+		return releasedCount;
+	}
+
+	size_t DeferredReleaseQueue::ReleaseAll()
+	{
+		size_t releasedCount = 0;
+
+		// Destructors may defer more objects, so until nothing is left.
+		while (GetPendingCount() > 0)
+		{
+			for (uint32_t timeline = 0; timeline < timelines.size(); timeline++)
+				releasedCount += Retire(timeline, UINT64_MAX);
+		}
+
+		return releasedCount;
+	}
+
+	size_t DeferredReleaseQueue::GetPendingCount() const
+	{
+		size_t pendingCount = 0;
+		for (const std::deque<PendingObject>& pendingObjects : timelines)
+			pendingCount += pendingObjects.size();
+
+		return pendingCount;
+	}
+	uint32_t DeferredReleaseQueue::GetTimelineCount() const
+	{
+		return static_cast<uint32_t>(timelines.size());
+	}
+
+	DeferredReleaseStatistics DeferredReleaseQueue::GetStatistics() const
+	{
+		DeferredReleaseStatistics currentStatistics = statistics;
+		currentStatistics.pendingCount = GetPendingCount();
+		return currentStatistics;
+	}
+}
@@ -0,0 +1,100 @@
+#include "Memory/IndexAllocator.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dxe
+{
+	IndexAllocator::IndexAllocator(uint32_t capacity)
+		: capacity(capacity)
+	{
+		if (capacity == 0 || capacity == INDEX_INVALID)
+			throw Error{ "Index allocator capacity must be between 1 and INDEX_INVALID - 1!" };
+
+		allocated.resize(capacity, false);
+	}
+
+	uint32_t IndexAllocator::Allocate()
+	{
+		uint32_t index = INDEX_INVALID;
+
+		if (!freeIndices.empty())
+		{
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+		else if (nextIndex < capacity)
+		{
+			index = nextIndex++;
+		}
+		else
+		{
+			return INDEX_INVALID;
+		}
+
+		allocated[index] = true;
+		usedCount++;
+		peakUsedCount = std::max(peakUsedCount, usedCount);
+		allocationCount++;
+
+		return index;
+	}
+
+	void IndexAllocator::Free(uint32_t index, uint64_t fenceValue)
+	{
+		assert(IsAllocated(index) && "Invalid index provided!");
+
+		if (!pendingIndices.empty())
+			fenceValue = std::max(fenceValue, pendingIndices.back().fenceValue);
+
+		allocated[index] = false;
+		pendingIndices.push_back(PendingIndex{ fenceValue, index });
+	}
+
+	void IndexAllocator::Retire(uint64_t completedFenceValue)
+	{
+		while (!pendingIndices.empty() && pendingIndices.front().fenceValue <= completedFenceValue)
+		{
+			freeIndices.push_back(pendingIndices.front().index);
+			pendingIndices.pop_front();
+			usedCount--;
+		}
+	}
+
+	void IndexAllocator::Reset()
+	{
+		nextIndex = 0;
+		usedCount = 0;
+
+		freeIndices.clear();
+		pendingIndices.clear();
+		std::fill(allocated.begin(), allocated.end(), false);
+	}
+
+	bool IndexAllocator::IsAllocated(uint32_t index) const
+	{
+		return index < capacity && allocated[index];
+	}
+
+	IndexStatistics IndexAllocator::GetStatistics() const
+	{
+		IndexStatistics statistics{};
+		statistics.capacity = capacity;
+		statistics.usedCount = usedCount;
+		statistics.pendingFreeCount = static_cast<uint32_t>(pendingIndices.size());
+		statistics.peakUsedCount = peakUsedCount;
+		statistics.allocationCount = allocationCount;
+		return statistics;
+	}
+
+	uint32_t IndexAllocator::GetCapacity() const
+	{
+		return capacity;
+	}
+	uint32_t IndexAllocator::GetUsedCount() const
+	{
+		return usedCount;
+	}
+}
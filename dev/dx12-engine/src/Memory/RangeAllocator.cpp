@@ -0,0 +1,300 @@
+#include "Memory/RangeAllocator.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+namespace dxe
+{
+	RangeAllocator::RangeAllocator(uint64_t capacity)
+		: capacity(capacity)
+	{
+		if (capacity == 0)
+			throw Error{ "Range allocator capacity must not be 0!" };
+
+		InsertFreeRange(0, capacity);
+	}
+
+	uint32_t RangeAllocator::Allocate(uint64_t size)
+	{
+		assert(size > 0 && "Allocation size must not be 0!");
+
+		auto bestFit = freeRangesBySize.lower_bound({ size, 0 });
+		if (bestFit == freeRangesBySize.end())
+			return RANGE_INVALID_HANDLE;
+
+		uint64_t offset = bestFit->second;
+		uint64_t freeSize = bestFit->first;
+
+		// Both neighbours of the remainder are allocated, so there's nothing to merge with.
+		auto freeRange = freeRangesByOffset.find(offset);
+		if (freeSize > size)
+			MoveFreeRange(freeRange, offset + size, freeSize - size);
+		else
+			RemoveFreeRange(freeRange);
+
+		return AddAllocation(Range{ offset, size });
+	}
+
+	void RangeAllocator::Free(uint32_t handle)
+	{
+		AssertIfInvalidHandle(handle);
+
+		Range& allocation = allocations[handle];
+		InsertFreeRange(allocation.offset, allocation.size);
+
+		usedSize -= allocation.size;
+		allocationCount--;
+
+		allocation = Range{};
+		handles.FreeUniqueId(handle);
+	}
+
+	bool RangeAllocator::Grow(uint32_t handle, uint64_t extraSize)
+	{
+		AssertIfInvalidHandle(handle);
+		assert(extraSize > 0 && "Allocation has to grow by more than 0!");
+
+		Range& allocation = allocations[handle];
+		auto next = freeRangesByOffset.find(allocation.offset + allocation.size);
+		if (next == freeRangesByOffset.end() || next->second < extraSize)
+			return false;
+
+		ReserveRange(allocation.offset + allocation.size, extraSize);
+		allocation.size += extraSize;
+		usedSize += extraSize;
+		return true;
+	}
+
+	uint32_t RangeAllocator::Split(uint32_t handle, uint64_t size)
+	{
+		AssertIfInvalidHandle(handle);
+		assert(size > 0 && size < allocations[handle].size && "Split has to leave both parts non-empty!");
+
+		Range& allocation = allocations[handle];
+		Range rest{ allocation.offset + size, allocation.size - size, allocation.movable };
+
+		allocation.size = size;
+		// Added back as the rest's size.
+		usedSize -= rest.size;
+		return AddAllocation(rest);
+	}
+
+	uint64_t RangeAllocator::GetOffset(uint32_t handle) const
+	{
+		AssertIfInvalidHandle(handle);
+		return allocations[handle].offset;
+	}
+	uint64_t RangeAllocator::GetSize(uint32_t handle) const
+	{
+		AssertIfInvalidHandle(handle);
+		return allocations[handle].size;
+	}
+
+	// Defragmentation
+
+	std::vector<RangeMove> RangeAllocator::PlanDefragmentation(uint64_t maxMoveSize) const
+	{
+		std::vector<RangeMove> moves;
+		if (freeRangesByOffset.empty() || allocationCount == 0)
+			return moves;
+
+		// The free ranges as they are before the pass, in address order. Moves only shrink them.
+		std::vector<Range> freeRanges;
+		freeRanges.reserve(freeRangesByOffset.size());
+		for (const auto& [offset, size] : freeRangesByOffset)
+			freeRanges.push_back(Range{ offset, size });
+
+		// Max tree over the free range sizes: the lowest free range that fits is found in O(log n).
+		size_t leafCount{ 1 };
+		while (leafCount < freeRanges.size())
+			leafCount <<= 1;
+
+		std::vector<uint64_t> largestSizes(2 * leafCount, 0);
+		for (size_t i = 0; i < freeRanges.size(); i++)
+			largestSizes[leafCount + i] = freeRanges[i].size;
+		for (size_t node = leafCount - 1; node > 0; node--)
+			largestSizes[node] = std::max(largestSizes[2 * node], largestSizes[2 * node + 1]);
+
+		std::vector<uint32_t> order;
+		order.reserve(allocationCount);
+		for (uint32_t handle = 0; handle < allocations.size(); handle++)
+		{
+			if (allocations[handle].size > 0 && allocations[handle].movable)
+				order.push_back(handle);
+		}
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+			return allocations[a].offset > allocations[b].offset;
+		});
+
+		uint64_t remainingMoveSize = maxMoveSize;
+		for (uint32_t handle : order)
+		{
+			const Range& allocation = allocations[handle];
+			if (allocation.size > remainingMoveSize || allocation.size > largestSizes[1])
+				continue;
+
+			size_t node{ 1 };
+			while (node < leafCount)
+				node = largestSizes[2 * node] >= allocation.size ? 2 * node : 2 * node + 1;
+
+			Range& freeRange = freeRanges[node - leafCount];
+			if (freeRange.offset > allocation.offset)
+				continue;
+
+			moves.push_back(RangeMove{ handle, allocation.offset, freeRange.offset, allocation.size });
+			remainingMoveSize -= allocation.size;
+
+			freeRange.offset += allocation.size;
+			freeRange.size -= allocation.size;
+
+			largestSizes[node] = freeRange.size;
+			for (node /= 2; node > 0; node /= 2)
+				largestSizes[node] = std::max(largestSizes[2 * node], largestSizes[2 * node + 1]);
+		}
+
+		return moves;
+	}
+
+	void RangeAllocator::ApplyMoves(const std::vector<RangeMove>& moves, std::vector<uint32_t>* sourceHandles)
+	{
+		for (const RangeMove& move : moves)
+		{
+			AssertIfInvalidHandle(move.handle);
+			assert(allocations[move.handle].offset == move.sourceOffset &&
+				allocations[move.handle].size == move.size && "Range move doesn't match its allocation!");
+
+			// Sources and destinations never overlap, so the order doesn't matter.
+			ReserveRange(move.destinationOffset, move.size);
+			allocations[move.handle].offset = move.destinationOffset;
+
+			if (sourceHandles)
+				sourceHandles->push_back(AddAllocation(Range{ move.sourceOffset, move.size, false }));
+			else
+				InsertFreeRange(move.sourceOffset, move.size);
+		}
+	}
+
+	RangeStatistics RangeAllocator::GetStatistics() const
+	{
+		RangeStatistics statistics{};
+		statistics.capacity = capacity;
+		statistics.usedSize = usedSize;
+		statistics.freeSize = capacity - usedSize;
+		statistics.allocationCount = allocationCount;
+		statistics.freeRangeCount = static_cast<uint32_t>(freeRangesByOffset.size());
+
+		if (!freeRangesBySize.empty())
+			statistics.largestFreeRange = freeRangesBySize.rbegin()->first;
+
+		if (statistics.freeSize > 0)
+			statistics.fragmentation = 1.0f - static_cast<float>(static_cast<double>(statistics.largestFreeRange) / statistics.freeSize);
+
+		return statistics;
+	}
+
+	uint64_t RangeAllocator::GetCapacity() const
+	{
+		return capacity;
+	}
+	uint64_t RangeAllocator::GetUsedSize() const
+	{
+		return usedSize;
+	}
+	uint32_t RangeAllocator::GetAllocationCount() const
+	{
+		return allocationCount;
+	}
+
+	void RangeAllocator::InsertFreeRange(uint64_t offset, uint64_t size)
+	{
+		auto next = freeRangesByOffset.lower_bound(offset);
+		bool mergeNext = next != freeRangesByOffset.end() && next->first == offset + size;
+
+		auto previous = next != freeRangesByOffset.begin() ? std::prev(next) : freeRangesByOffset.end();
+		bool mergePrevious = previous != freeRangesByOffset.end() && previous->first + previous->second == offset;
+
+		if (mergePrevious && mergeNext)
+		{
+			uint64_t mergedSize = previous->second + size + next->second;
+			RemoveFreeRange(next);
+			MoveFreeRange(previous, previous->first, mergedSize);
+		}
+		else if (mergePrevious)
+		{
+			MoveFreeRange(previous, previous->first, previous->second + size);
+		}
+		else if (mergeNext)
+		{
+			MoveFreeRange(next, offset, size + next->second);
+		}
+		else
+		{
+			freeRangesByOffset.emplace(offset, size);
+			freeRangesBySize.emplace(size, offset);
+		}
+	}
+
+	void RangeAllocator::RemoveFreeRange(std::map<uint64_t, uint64_t>::iterator freeRange)
+	{
+		freeRangesBySize.erase({ freeRange->second, freeRange->first });
+		freeRangesByOffset.erase(freeRange);
+	}
+
+	void RangeAllocator::MoveFreeRange(std::map<uint64_t, uint64_t>::iterator freeRange, uint64_t offset, uint64_t size)
+	{
+		// The nodes are reused, so allocating and freeing rarely touches the heap.
+		auto sizeNode = freeRangesBySize.extract({ freeRange->second, freeRange->first });
+		auto offsetNode = freeRangesByOffset.extract(freeRange);
+
+		offsetNode.key() = offset;
+		offsetNode.mapped() = size;
+		freeRangesByOffset.insert(std::move(offsetNode));
+
+		sizeNode.value() = { size, offset };
+		freeRangesBySize.insert(std::move(sizeNode));
+	}
+
+	void RangeAllocator::ReserveRange(uint64_t offset, uint64_t size)
+	{
+		auto freeRange = freeRangesByOffset.upper_bound(offset);
+		assert(freeRange != freeRangesByOffset.begin() && "Range to reserve isn't free!");
+		freeRange = std::prev(freeRange);
+
+		uint64_t freeOffset = freeRange->first;
+		uint64_t freeSize = freeRange->second;
+		assert(offset + size <= freeOffset + freeSize && "Range to reserve isn't free!");
+
+		// The pieces left on either side border on allocations or the reserved range.
+		if (offset > freeOffset)
+			MoveFreeRange(freeRange, freeOffset, offset - freeOffset);
+		else
+			RemoveFreeRange(freeRange);
+
+		if (offset + size < freeOffset + freeSize)
+		{
+			uint64_t endSize = freeOffset + freeSize - (offset + size);
+			freeRangesByOffset.emplace(offset + size, endSize);
+			freeRangesBySize.emplace(endSize, offset + size);
+		}
+	}
+
+	uint32_t RangeAllocator::AddAllocation(const Range& range)
+	{
+		uint32_t handle = handles.GenerateUniqueId();
+		if (handle >= allocations.size())
+			allocations.resize(handle + 1);
+
+		allocations[handle] = range;
+		usedSize += range.size;
+		allocationCount++;
+		return handle;
+	}
+
+	void RangeAllocator::AssertIfInvalidHandle(uint32_t handle) const
+	{
+		assert(handle < allocations.size() && allocations[handle].size > 0 && "Invalid range handle!");
+	}
+}
@@ -0,0 +1,134 @@
+#include "Memory/RingAllocator.h"
+
+#include "Core/Error.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	RingAllocator::RingAllocator(uint64_t capacity)
+		: capacity(capacity)
+	{
+		if (capacity == 0)
+			throw Error{ "Ring allocator capacity must not be 0!" };
+	}
+
+	uint64_t RingAllocator::Allocate(uint64_t size, uint64_t alignment)
+	{
+		uint64_t offset = FindOffset(size, alignment);
+		if (offset == RING_INVALID_OFFSET)
+		{
+			stallCount++;
+			return RING_INVALID_OFFSET;
+		}
+
+		// Starting over at 0 keeps the free space in one piece.
+		if (usedSize == 0)
+			head = tail = 0;
+
+		uint64_t consumedSize = offset >= tail ? offset + size - tail : capacity - tail + size;
+		wastedSize += consumedSize - size;
+
+		tail = offset + size;
+		usedSize += consumedSize;
+		openBatchSize += consumedSize;
+		allocationCount++;
+
+		return offset;
+	}
+
+	bool RingAllocator::CanAllocate(uint64_t size, uint64_t alignment) const
+	{
+		return FindOffset(size, alignment) != RING_INVALID_OFFSET;
+	}
+
+	void RingAllocator::Submit(uint64_t fenceValue)
+	{
+		assert((batches.empty() || batches.back().fenceValue <= fenceValue) && "Fence values must not decrease!");
+
+		if (openBatchSize == 0)
+			return;
+
+		batches.push_back(Batch{ fenceValue, tail, openBatchSize });
+		openBatchSize = 0;
+	}
+
+	void RingAllocator::Retire(uint64_t completedFenceValue)
+	{
+		while (!batches.empty() && batches.front().fenceValue <= completedFenceValue)
+		{
+			head = batches.front().end;
+			usedSize -= batches.front().size;
+			batches.pop_front();
+		}
+	}
+
+	bool RingAllocator::HasPendingBatches() const
+	{
+		return !batches.empty();
+	}
+	uint64_t RingAllocator::GetOldestPendingFenceValue() const
+	{
+		assert(!batches.empty() && "Ring allocator has no pending batches!");
+		return batches.front().fenceValue;
+	}
+
+	void RingAllocator::Reset()
+	{
+		batches.clear();
+		head = tail = 0;
+		usedSize = 0;
+		openBatchSize = 0;
+	}
+
+	RingStatistics RingAllocator::GetStatistics() const
+	{
+		RingStatistics statistics{};
+		statistics.capacity = capacity;
+		statistics.usedSize = usedSize;
+		statistics.openBatchSize = openBatchSize;
+		statistics.pendingBatchCount = static_cast<uint32_t>(batches.size());
+		statistics.allocationCount = allocationCount;
+		statistics.stallCount = stallCount;
+		statistics.wastedSize = wastedSize;
+		return statistics;
+	}
+
+	uint64_t RingAllocator::FindOffset(uint64_t size, uint64_t alignment) const
+	{
+		assert(size > 0 && "Allocation size must not be 0!");
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two!");
+
+		if (size > capacity)
+			return RING_INVALID_OFFSET;
+		if (usedSize == 0)
+			return 0;
+
+		uint64_t alignedTail = (tail + alignment - 1) & ~(alignment - 1);
+		if (tail > head)
+		{
+			// Free space is [tail, capacity) and [0, head).
+			if (alignedTail <= capacity && size <= capacity - alignedTail)
+				return alignedTail;
+			if (size <= head)
+				return 0;
+		}
+		else if (tail < head)
+		{
+			// Free space is [tail, head).
+			if (alignedTail <= head && size <= head - alignedTail)
+				return alignedTail;
+		}
+
+		return RING_INVALID_OFFSET;
+	}
+
+	uint64_t RingAllocator::GetCapacity() const
+	{
+		return capacity;
+	}
+	uint64_t RingAllocator::GetUsedSize() const
+	{
+		return usedSize;
+	}
+}
@@ -0,0 +1,333 @@
+#include "Memory/TlsfAllocator.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace dxe
+{
+	static uint32_t FindLowestSetBit(uint64_t value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index{ 0 };
+		_BitScanForward64(&index, value);
+		return static_cast<uint32_t>(index);
+#else
+		return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+	}
+
+	static uint32_t FindHighestSetBit(uint64_t value)
+	{
+#if defined(_MSC_VER)
+		unsigned long index{ 0 };
+		_BitScanReverse64(&index, value);
+		return static_cast<uint32_t>(index);
+#else
+		return 63 - static_cast<uint32_t>(__builtin_clzll(value));
+#endif
+	}
+
+	TlsfAllocator::TlsfAllocator(uint64_t capacity)
+		: capacity(capacity)
+	{
+		if (capacity == 0)
+			throw Error{ "TLSF allocator capacity must not be 0!" };
+
+		Reset();
+	}
+
+	TlsfAllocation TlsfAllocator::Allocate(uint64_t size, uint64_t alignment)
+	{
+		assert(size > 0 && "Allocation size must not be 0!");
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && "Alignment must be a power of two!");
+
+		if (size > capacity)
+			return TlsfAllocation{};
+
+		// Any block of the size class fits the size, but not necessarily once aligned. Padding by
+		// the alignment always fits; that is only searched for when the good fit doesn't align.
+		uint32_t blockIndex = FindFreeBlock(size);
+		if (blockIndex != TLSF_INVALID_BLOCK)
+		{
+			const Block& block = blocks[blockIndex];
+			uint64_t alignedOffset = (block.offset + alignment - 1) & ~(alignment - 1);
+			if (alignedOffset - block.offset + size > block.size)
+				blockIndex = TLSF_INVALID_BLOCK;
+		}
+		if (blockIndex == TLSF_INVALID_BLOCK && alignment > 1 && alignment - 1 <= capacity - size)
+			blockIndex = FindFreeBlock(size + alignment - 1);
+		if (blockIndex == TLSF_INVALID_BLOCK)
+			return TlsfAllocation{};
+
+		RemoveFreeBlock(blockIndex);
+
+		uint64_t padding = ((blocks[blockIndex].offset + alignment - 1) & ~(alignment - 1)) - blocks[blockIndex].offset;
+		if (padding > 0)
+		{
+			// The physical predecessor is used (free neighbours are always merged), so the padding
+			// simply becomes a free block of its own.
+			uint32_t alignedBlock = SplitBlock(blockIndex, padding);
+			InsertFreeBlock(blockIndex);
+			blockIndex = alignedBlock;
+		}
+
+		if (blocks[blockIndex].size > size)
+			InsertFreeBlock(SplitBlock(blockIndex, size));
+
+		Block& block = blocks[blockIndex];
+		block.free = false;
+
+		usedBytes += block.size;
+		allocationCount++;
+
+		TlsfAllocation allocation{};
+		allocation.offset = block.offset;
+		allocation.size = block.size;
+		allocation.block = blockIndex;
+		return allocation;
+	}
+
+	void TlsfAllocator::Free(const TlsfAllocation& allocation)
+	{
+		assert(allocation.IsValid() && allocation.block < blocks.size() && "Invalid TLSF allocation!");
+
+		uint32_t blockIndex = allocation.block;
+		assert(!blocks[blockIndex].free && blocks[blockIndex].offset == allocation.offset && "TLSF allocation was already freed!");
+
+		usedBytes -= blocks[blockIndex].size;
+		allocationCount--;
+
+		blocks[blockIndex].free = true;
+
+		uint32_t previous = blocks[blockIndex].previousPhysical;
+		if (previous != TLSF_INVALID_BLOCK && blocks[previous].free)
+		{
+			RemoveFreeBlock(previous);
+			blockIndex = MergeWithPrevious(blockIndex);
+		}
+
+		uint32_t next = blocks[blockIndex].nextPhysical;
+		if (next != TLSF_INVALID_BLOCK && blocks[next].free)
+		{
+			RemoveFreeBlock(next);
+			MergeWithPrevious(next);
+		}
+
+		InsertFreeBlock(blockIndex);
+	}
+
+	void TlsfAllocator::Reset()
+	{
+		blocks.clear();
+		unusedBlocks.clear();
+
+		firstLevelBitmap = 0;
+		std::fill(std::begin(secondLevelBitmaps), std::end(secondLevelBitmaps), 0u);
+		for (auto& lists : freeLists)
+			std::fill(std::begin(lists), std::end(lists), TLSF_INVALID_BLOCK);
+
+		usedBytes = 0;
+		allocationCount = 0;
+
+		uint32_t blockIndex = CreateBlock(0, capacity);
+		blocks[blockIndex].free = true;
+		InsertFreeBlock(blockIndex);
+	}
+
+	TlsfStatistics TlsfAllocator::GetStatistics() const
+	{
+		TlsfStatistics statistics{};
+		statistics.capacity = capacity;
+		statistics.usedBytes = usedBytes;
+		statistics.freeBytes = capacity - usedBytes;
+		statistics.allocationCount = allocationCount;
+
+		for (const Block& block : blocks)
+		{
+			if (block.size == 0 || !block.free)
+				continue;
+
+			statistics.freeBlockCount++;
+			statistics.largestFreeBlock = std::max(statistics.largestFreeBlock, block.size);
+		}
+
+		if (statistics.freeBytes > 0)
+			statistics.fragmentation = 1.0f - static_cast<float>(static_cast<double>(statistics.largestFreeBlock) / statistics.freeBytes);
+
+		return statistics;
+	}
+
+	uint64_t TlsfAllocator::GetCapacity() const
+	{
+		return capacity;
+	}
+	uint64_t TlsfAllocator::GetUsedBytes() const
+	{
+		return usedBytes;
+	}
+	uint32_t TlsfAllocator::GetAllocationCount() const
+	{
+		return allocationCount;
+	}
+	bool TlsfAllocator::IsEmpty() const
+	{
+		return allocationCount == 0;
+	}
+
+	void TlsfAllocator::MapSize(uint64_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+	{
+		// Sizes below SECOND_LEVEL_COUNT get one list each in the first row.
+		if (size < SECOND_LEVEL_COUNT)
+		{
+			firstLevel = 0;
+			secondLevel = static_cast<uint32_t>(size);
+			return;
+		}
+
+		uint32_t highestBit = FindHighestSetBit(size);
+		firstLevel = highestBit - SECOND_LEVEL_LOG2 + 1;
+		secondLevel = static_cast<uint32_t>(size >> (highestBit - SECOND_LEVEL_LOG2)) - SECOND_LEVEL_COUNT;
+	}
+
+	uint32_t TlsfAllocator::CreateBlock(uint64_t offset, uint64_t size)
+	{
+		uint32_t blockIndex{ 0 };
+		if (!unusedBlocks.empty())
+		{
+			blockIndex = unusedBlocks.back();
+			unusedBlocks.pop_back();
+		}
+		else
+		{
+			blockIndex = static_cast<uint32_t>(blocks.size());
+			blocks.emplace_back();
+		}
+
+		Block& block = blocks[blockIndex];
+		block = Block{};
+		block.offset = offset;
+		block.size = size;
+		return blockIndex;
+	}
+
+	void TlsfAllocator::DestroyBlock(uint32_t blockIndex)
+	{
+		blocks[blockIndex] = Block{};
+		unusedBlocks.push_back(blockIndex);
+	}
+
+	void TlsfAllocator::InsertFreeBlock(uint32_t blockIndex)
+	{
+		Block& block = blocks[blockIndex];
+		block.free = true;
+
+		uint32_t firstLevel{ 0 };
+		uint32_t secondLevel{ 0 };
+		MapSize(block.size, firstLevel, secondLevel);
+
+		uint32_t head = freeLists[firstLevel][secondLevel];
+		block.previousFree = TLSF_INVALID_BLOCK;
+		block.nextFree = head;
+		if (head != TLSF_INVALID_BLOCK)
+			blocks[head].previousFree = blockIndex;
+
+		freeLists[firstLevel][secondLevel] = blockIndex;
+		firstLevelBitmap |= 1ull << firstLevel;
+		secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+	}
+
+	void TlsfAllocator::RemoveFreeBlock(uint32_t blockIndex)
+	{
+		Block& block = blocks[blockIndex];
+
+		uint32_t firstLevel{ 0 };
+		uint32_t secondLevel{ 0 };
+		MapSize(block.size, firstLevel, secondLevel);
+
+		if (block.previousFree != TLSF_INVALID_BLOCK)
+			blocks[block.previousFree].nextFree = block.nextFree;
+		else
+			freeLists[firstLevel][secondLevel] = block.nextFree;
+
+		if (block.nextFree != TLSF_INVALID_BLOCK)
+			blocks[block.nextFree].previousFree = block.previousFree;
+
+		if (freeLists[firstLevel][secondLevel] == TLSF_INVALID_BLOCK)
+		{
+			secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+			if (secondLevelBitmaps[firstLevel] == 0)
+				firstLevelBitmap &= ~(1ull << firstLevel);
+		}
+
+		block.previousFree = TLSF_INVALID_BLOCK;
+		block.nextFree = TLSF_INVALID_BLOCK;
+		block.free = false;
+	}
+
+	uint32_t TlsfAllocator::FindFreeBlock(uint64_t size) const
+	{
+		// Rounded up to the next size class, so every block in the list found is large enough.
+		if (size >= SECOND_LEVEL_COUNT)
+			size += (1ull << (FindHighestSetBit(size) - SECOND_LEVEL_LOG2)) - 1;
+
+		uint32_t firstLevel{ 0 };
+		uint32_t secondLevel{ 0 };
+		MapSize(size, firstLevel, secondLevel);
+
+		uint32_t secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+		if (secondLevelMap == 0)
+		{
+			uint64_t firstLevelMap = firstLevel + 1 < 64 ? firstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+			if (firstLevelMap == 0)
+				return TLSF_INVALID_BLOCK;
+
+			firstLevel = FindLowestSetBit(firstLevelMap);
+			secondLevelMap = secondLevelBitmaps[firstLevel];
+		}
+
+		return freeLists[firstLevel][FindLowestSetBit(secondLevelMap)];
+	}
+
+	uint32_t TlsfAllocator::SplitBlock(uint32_t blockIndex, uint64_t size)
+	{
+		uint64_t offset = blocks[blockIndex].offset + size;
+		uint64_t remainingSize = blocks[blockIndex].size - size;
+
+		// May reallocate 'blocks'.
+		uint32_t remainder = CreateBlock(offset, remainingSize);
+
+		Block& block = blocks[blockIndex];
+		Block& remainderBlock = blocks[remainder];
+
+		remainderBlock.previousPhysical = blockIndex;
+		remainderBlock.nextPhysical = block.nextPhysical;
+		if (block.nextPhysical != TLSF_INVALID_BLOCK)
+			blocks[block.nextPhysical].previousPhysical = remainder;
+
+		block.nextPhysical = remainder;
+		block.size = size;
+
+		return remainder;
+	}
+
+	uint32_t TlsfAllocator::MergeWithPrevious(uint32_t blockIndex)
+	{
+		Block& block = blocks[blockIndex];
+		uint32_t previous = block.previousPhysical;
+		Block& previousBlock = blocks[previous];
+
+		previousBlock.size += block.size;
+		previousBlock.nextPhysical = block.nextPhysical;
+		if (block.nextPhysical != TLSF_INVALID_BLOCK)
+			blocks[block.nextPhysical].previousPhysical = previous;
+
+		DestroyBlock(blockIndex);
+		return previous;
+	}
+}
@@ -0,0 +1,564 @@
+#include "Renderer/Color.h"
+
+#include "Core/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace dxe
+{
+	// sRGB curve constants
+
+	constexpr float SRGB_LINEAR_THRESHOLD = 0.04045f;
+	constexpr float LINEAR_SRGB_THRESHOLD = 0.0031308f;
+	constexpr float SRGB_LINEAR_SLOPE = 12.92f;
+	constexpr float SRGB_GAMMA = 2.4f;
+
+	// Multiplications instead of divisions for the batch kernels.
+	constexpr float INVERSE_SRGB_LINEAR_SLOPE = 1.0f / SRGB_LINEAR_SLOPE;
+	constexpr float INVERSE_SRGB_SCALE = 1.0f / 1.055f;
+
+	// Lookup tables
+
+	struct SrgbTables
+	{
+		SrgbTables()
+		{
+			for (uint32_t value = 0; value < 256; value++)
+				toLinear[value] = SrgbToLinear(static_cast<float>(value) / 255.0f);
+
+			// Linear value at which the rounded sRGB result steps from 'value' to 'value + 1'.
+			for (uint32_t value = 0; value < 255; value++)
+				roundingThresholds[value] = SrgbToLinear((static_cast<float>(value) + 0.5f) / 255.0f);
+		}
+
+		float toLinear[256];
+		float roundingThresholds[255];
+	};
+
+	static const SrgbTables& GetSrgbTables()
+	{
+		static const SrgbTables tables{};
+		return tables;
+	}
+
+	// Polynomial pow
+	//
+	// pow(x, p) = exp2(p * log2(x)), with log2 split into exponent + polynomial of the mantissa
+	// and exp2 split into integer part + polynomial of the fraction. The scalar versions mirror
+	// the SSE2 ones operation for operation, so the batch tails match the vector body.
+
+	constexpr float LOG2_COEFFICIENTS[7]{ 1.44269326f, -0.721162733f, 0.47770592f, -0.339247727f, 0.215588445f, -0.0960661725f, 0.0204903208f };
+	constexpr float EXP2_COEFFICIENTS[6]{ 0.999999896f, 0.69315462f, 0.24014077f, 0.0558632826f, 0.00894621481f, 0.00189510723f };
+
+	static float PowScalar(float x, float power)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+
+		int32_t exponent = static_cast<int32_t>(bits >> 23) - 127;
+		uint32_t mantissaBits = (bits & 0x007FFFFFu) | 0x3F800000u;
+		float mantissa;
+		std::memcpy(&mantissa, &mantissaBits, sizeof(mantissa));
+
+		float t = mantissa - 1.0f;
+		float logPolynomial = LOG2_COEFFICIENTS[6];
+		for (int32_t coefficient = 5; coefficient >= 0; coefficient--)
+			logPolynomial = logPolynomial * t + LOG2_COEFFICIENTS[coefficient];
+
+		float exponent2 = std::max((static_cast<float>(exponent) + t * logPolynomial) * power, -126.0f);
+
+		int32_t integer = static_cast<int32_t>(exponent2);
+		if (static_cast<float>(integer) > exponent2)
+			integer--;
+		float fraction = exponent2 - static_cast<float>(integer);
+
+		float expPolynomial = EXP2_COEFFICIENTS[5];
+		for (int32_t coefficient = 4; coefficient >= 0; coefficient--)
+			expPolynomial = expPolynomial * fraction + EXP2_COEFFICIENTS[coefficient];
+
+		uint32_t scaleBits = static_cast<uint32_t>(integer + 127) << 23;
+		float scale;
+		std::memcpy(&scale, &scaleBits, sizeof(scale));
+		return expPolynomial * scale;
+	}
+
+	static float SrgbToLinearApproximate(float value)
+	{
+		value = std::min(std::max(value, 0.0f), 1.0f);
+		if (value <= SRGB_LINEAR_THRESHOLD)
+			return value * INVERSE_SRGB_LINEAR_SLOPE;
+		return PowScalar((value + 0.055f) * INVERSE_SRGB_SCALE, SRGB_GAMMA);
+	}
+	static float LinearToSrgbApproximate(float value)
+	{
+		value = std::min(std::max(value, 0.0f), 1.0f);
+		if (value <= LINEAR_SRGB_THRESHOLD)
+			return value * SRGB_LINEAR_SLOPE;
+		return 1.055f * PowScalar(value, 1.0f / SRGB_GAMMA) - 0.055f;
+	}
+
+#if SIMD_SSE2
+	static __m128 PowSse(__m128 x, float power)
+	{
+		__m128i bits = _mm_castps_si128(x);
+
+		__m128i exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+		__m128 mantissa = _mm_castsi128_ps(_mm_or_si128(
+			_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+
+		__m128 t = _mm_sub_ps(mantissa, _mm_set1_ps(1.0f));
+		__m128 logPolynomial = _mm_set1_ps(LOG2_COEFFICIENTS[6]);
+		for (int32_t coefficient = 5; coefficient >= 0; coefficient--)
+			logPolynomial = _mm_add_ps(_mm_mul_ps(logPolynomial, t), _mm_set1_ps(LOG2_COEFFICIENTS[coefficient]));
+
+		__m128 exponent2 = _mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_mul_ps(t, logPolynomial)), _mm_set1_ps(power));
+		exponent2 = _mm_max_ps(exponent2, _mm_set1_ps(-126.0f));
+
+		// Floor: truncate, then step down where truncation went up (negative values).
+		__m128i integer = _mm_cvttps_epi32(exponent2);
+		__m128 truncated = _mm_cvtepi32_ps(integer);
+		integer = _mm_add_epi32(integer, _mm_castps_si128(_mm_cmpgt_ps(truncated, exponent2)));
+		__m128 fraction = _mm_sub_ps(exponent2, _mm_cvtepi32_ps(integer));
+
+		__m128 expPolynomial = _mm_set1_ps(EXP2_COEFFICIENTS[5]);
+		for (int32_t coefficient = 4; coefficient >= 0; coefficient--)
+			expPolynomial = _mm_add_ps(_mm_mul_ps(expPolynomial, fraction), _mm_set1_ps(EXP2_COEFFICIENTS[coefficient]));
+
+		__m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integer, _mm_set1_epi32(127)), 23));
+		return _mm_mul_ps(expPolynomial, scale);
+	}
+
+	static __m128 SaturateSse(__m128 value)
+	{
+		return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	}
+
+	static __m128 SelectSse(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+	}
+
+	static __m128 SrgbToLinearSse(__m128 value)
+	{
+		value = SaturateSse(value);
+
+		__m128 linearSegment = _mm_mul_ps(value, _mm_set1_ps(INVERSE_SRGB_LINEAR_SLOPE));
+		__m128 curveSegment = PowSse(
+			_mm_mul_ps(_mm_add_ps(value, _mm_set1_ps(0.055f)), _mm_set1_ps(INVERSE_SRGB_SCALE)), SRGB_GAMMA);
+
+		return SelectSse(_mm_cmple_ps(value, _mm_set1_ps(SRGB_LINEAR_THRESHOLD)), linearSegment, curveSegment);
+	}
+	static __m128 LinearToSrgbSse(__m128 value)
+	{
+		value = SaturateSse(value);
+
+		__m128 linearSegment = _mm_mul_ps(value, _mm_set1_ps(SRGB_LINEAR_SLOPE));
+		__m128 curveSegment = _mm_sub_ps(
+			_mm_mul_ps(_mm_set1_ps(1.055f), PowSse(value, 1.0f / SRGB_GAMMA)), _mm_set1_ps(0.055f));
+
+		return SelectSse(_mm_cmple_ps(value, _mm_set1_ps(LINEAR_SRGB_THRESHOLD)), linearSegment, curveSegment);
+	}
+
+	// Rounds 4 saturated floats to 8-bit and returns them packed in the low 32 bits.
+	static int32_t FloatToUnorm8Sse(__m128 value)
+	{
+		__m128i integers = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(SaturateSse(value), _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f)));
+		__m128i words = _mm_packs_epi32(integers, integers);
+		return _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+	}
+
+	// Lane 3 is alpha for RGBA data, which the curve must leave alone.
+	static __m128 GetAlphaLaneMask(uint32_t channelCount)
+	{
+		return channelCount == 4 ? _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0)) : _mm_setzero_ps();
+	}
+#endif
+
+	static bool IsAlphaValue(size_t valueIndex, uint32_t channelCount)
+	{
+		return channelCount == 4 && (valueIndex & 3) == 3;
+	}
+
+	// Single values
+
+	float SrgbToLinear(float value)
+	{
+		if (value <= SRGB_LINEAR_THRESHOLD)
+			return value / SRGB_LINEAR_SLOPE;
+		return std::pow((value + 0.055f) / 1.055f, SRGB_GAMMA);
+	}
+	float LinearToSrgb(float value)
+	{
+		if (value <= LINEAR_SRGB_THRESHOLD)
+			return value * SRGB_LINEAR_SLOPE;
+		return 1.055f * std::pow(value, 1.0f / SRGB_GAMMA) - 0.055f;
+	}
+
+	float SrgbUnorm8ToLinear(uint8_t value)
+	{
+		return GetSrgbTables().toLinear[value];
+	}
+	uint8_t LinearToSrgbUnorm8(float value)
+	{
+		const float* thresholds = GetSrgbTables().roundingThresholds;
+		return static_cast<uint8_t>(std::upper_bound(thresholds, thresholds + 255, value) - thresholds);
+	}
+
+	uint8_t FloatToUnorm8(float value)
+	{
+		return static_cast<uint8_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+	float Unorm8ToFloat(uint8_t value)
+	{
+		return static_cast<float>(value) * (1.0f / 255.0f);
+	}
+	uint16_t FloatToUnorm16(float value)
+	{
+		return static_cast<uint16_t>(std::min(std::max(value, 0.0f), 1.0f) * 65535.0f + 0.5f);
+	}
+	float Unorm16ToFloat(uint16_t value)
+	{
+		return static_cast<float>(value) * (1.0f / 65535.0f);
+	}
+
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits{ 0 };
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = bits & 0x80000000u;
+		bits ^= sign;
+
+		uint32_t half{ 0 };
+		if (bits >= 0x47800000u)
+		{
+			// 65536 and above, infinity or NaN.
+			half = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+		}
+		else if (bits < 0x38800000u)
+		{
+			// Below the smallest normal half. Adding 0.5 lines the denormal mantissa up with the
+			// low bits of the float, and the FPU does the rounding.
+			float denormal{ 0.0f };
+			std::memcpy(&denormal, &bits, sizeof(denormal));
+			denormal += 0.5f;
+			std::memcpy(&half, &denormal, sizeof(half));
+			half -= 0x3f000000u;
+		}
+		else
+		{
+			// Rebias the exponent and round the 13 dropped mantissa bits to nearest even.
+			uint32_t mantissaOdd = (bits >> 13) & 1;
+			bits += 0xc8000fffu + mantissaOdd;
+			half = bits >> 13;
+		}
+
+		return static_cast<uint16_t>(half | (sign >> 16));
+	}
+	float HalfToFloat(uint16_t value)
+	{
+		uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+		uint32_t exponent = (value >> 10) & 0x1fu;
+		uint32_t mantissa = value & 0x3ffu;
+
+		float result{ 0.0f };
+		if (exponent == 0)
+		{
+			result = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+			return sign ? -result : result;
+		}
+
+		uint32_t bits{ 0 };
+		if (exponent == 0x1f)
+			bits = sign | 0x7f800000u | (mantissa << 13);
+		else
+			bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	uint32_t PackUnorm8x4(const DirectX::XMFLOAT4& color)
+	{
+		return static_cast<uint32_t>(FloatToUnorm8(color.x)) |
+			(static_cast<uint32_t>(FloatToUnorm8(color.y)) << 8) |
+			(static_cast<uint32_t>(FloatToUnorm8(color.z)) << 16) |
+			(static_cast<uint32_t>(FloatToUnorm8(color.w)) << 24);
+	}
+	DirectX::XMFLOAT4 UnpackUnorm8x4(uint32_t packed)
+	{
+		DirectX::XMFLOAT4 color{};
+		color.x = Unorm8ToFloat(static_cast<uint8_t>(packed));
+		color.y = Unorm8ToFloat(static_cast<uint8_t>(packed >> 8));
+		color.z = Unorm8ToFloat(static_cast<uint8_t>(packed >> 16));
+		color.w = Unorm8ToFloat(static_cast<uint8_t>(packed >> 24));
+		return color;
+	}
+
+	// Batches
+
+	void ConvertSrgbUnorm8ToLinear(const uint8_t* source, float* destination, size_t pixelCount, uint32_t channelCount)
+	{
+		const float* toLinear = GetSrgbTables().toLinear;
+
+		size_t valueCount = pixelCount * channelCount;
+		for (size_t value = 0; value < valueCount; value++)
+		{
+			destination[value] = IsAlphaValue(value, channelCount) ?
+				Unorm8ToFloat(source[value]) : toLinear[source[value]];
+		}
+	}
+
+	void ConvertLinearToSrgbUnorm8(const float* source, uint8_t* destination, size_t pixelCount, uint32_t channelCount)
+	{
+		size_t valueCount = pixelCount * channelCount;
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		__m128 alphaMask = GetAlphaLaneMask(channelCount);
+		for (; value + 4 <= valueCount; value += 4)
+		{
+			__m128 input = _mm_loadu_ps(source + value);
+			__m128 converted = SelectSse(alphaMask, input, LinearToSrgbSse(input));
+
+			int32_t packed = FloatToUnorm8Sse(converted);
+			std::memcpy(destination + value, &packed, sizeof(packed));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+		{
+			destination[value] = IsAlphaValue(value, channelCount) ?
+				FloatToUnorm8(source[value]) : FloatToUnorm8(LinearToSrgbApproximate(source[value]));
+		}
+	}
+
+	void ConvertSrgbToLinear(const float* source, float* destination, size_t pixelCount, uint32_t channelCount)
+	{
+		size_t valueCount = pixelCount * channelCount;
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		__m128 alphaMask = GetAlphaLaneMask(channelCount);
+		for (; value + 4 <= valueCount; value += 4)
+		{
+			__m128 input = _mm_loadu_ps(source + value);
+			_mm_storeu_ps(destination + value, SelectSse(alphaMask, input, SrgbToLinearSse(input)));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+		{
+			destination[value] = IsAlphaValue(value, channelCount) ?
+				source[value] : SrgbToLinearApproximate(source[value]);
+		}
+	}
+
+	void ConvertLinearToSrgb(const float* source, float* destination, size_t pixelCount, uint32_t channelCount)
+	{
+		size_t valueCount = pixelCount * channelCount;
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		__m128 alphaMask = GetAlphaLaneMask(channelCount);
+		for (; value + 4 <= valueCount; value += 4)
+		{
+			__m128 input = _mm_loadu_ps(source + value);
+			_mm_storeu_ps(destination + value, SelectSse(alphaMask, input, LinearToSrgbSse(input)));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+		{
+			destination[value] = IsAlphaValue(value, channelCount) ?
+				source[value] : LinearToSrgbApproximate(source[value]);
+		}
+	}
+
+	void ConvertUnorm8ToFloat(const uint8_t* source, float* destination, size_t valueCount)
+	{
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 scale = _mm_set1_ps(1.0f / 255.0f);
+		for (; value + 16 <= valueCount; value += 16)
+		{
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + value));
+			__m128i low = _mm_unpacklo_epi8(bytes, zero);
+			__m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+			_mm_storeu_ps(destination + value + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero)), scale));
+			_mm_storeu_ps(destination + value + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero)), scale));
+			_mm_storeu_ps(destination + value + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero)), scale));
+			_mm_storeu_ps(destination + value + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero)), scale));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+			destination[value] = Unorm8ToFloat(source[value]);
+	}
+
+	void ConvertFloatToUnorm8(const float* source, uint8_t* destination, size_t valueCount)
+	{
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		for (; value + 4 <= valueCount; value += 4)
+		{
+			int32_t packed = FloatToUnorm8Sse(_mm_loadu_ps(source + value));
+			std::memcpy(destination + value, &packed, sizeof(packed));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+			destination[value] = FloatToUnorm8(source[value]);
+	}
+
+	void ConvertUnorm16ToFloat(const uint16_t* source, float* destination, size_t valueCount)
+	{
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 scale = _mm_set1_ps(1.0f / 65535.0f);
+		for (; value + 8 <= valueCount; value += 8)
+		{
+			__m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + value));
+			_mm_storeu_ps(destination + value + 0, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), scale));
+			_mm_storeu_ps(destination + value + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words, zero)), scale));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+			destination[value] = Unorm16ToFloat(source[value]);
+	}
+
+	void ConvertFloatToUnorm16(const float* source, uint16_t* destination, size_t valueCount)
+	{
+		// SSE2 has no unsigned 32 -> 16 bit pack, so this one stays scalar; compilers vectorize it fine.
+		for (size_t value = 0; value < valueCount; value++)
+			destination[value] = FloatToUnorm16(source[value]);
+	}
+
+	void ConvertFloatToHalf(const float* source, uint16_t* destination, size_t valueCount)
+	{
+		size_t value{ 0 };
+
+#if SIMD_SSE2
+		// Same three cases as FloatToHalf, all computed and then selected per lane.
+		const __m128i signMask = _mm_set1_epi32(static_cast<int32_t>(0x80000000u));
+		const __m128i overflowThreshold = _mm_set1_epi32(0x477fffff);
+		const __m128i denormalThreshold = _mm_set1_epi32(0x38800000);
+		const __m128i infinity = _mm_set1_epi32(0x7f800000);
+		const __m128i halfInfinity = _mm_set1_epi32(0x7c00);
+		const __m128i halfNanBit = _mm_set1_epi32(0x0200);
+		const __m128i rebias = _mm_set1_epi32(static_cast<int32_t>(0xc8000fffu));
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128 denormalMagic = _mm_set1_ps(0.5f);
+		const __m128i denormalMagicBits = _mm_set1_epi32(0x3f000000);
+
+		auto convert = [&](__m128 values) {
+			__m128i bits = _mm_castps_si128(values);
+			__m128i sign = _mm_and_si128(bits, signMask);
+			bits = _mm_xor_si128(bits, sign);
+
+			__m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), one);
+			__m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, rebias), mantissaOdd), 13);
+
+			__m128i denormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), denormalMagic)), denormalMagicBits);
+
+			__m128i isNan = _mm_cmpgt_epi32(bits, infinity);
+			__m128i overflow = _mm_or_si128(halfInfinity, _mm_and_si128(isNan, halfNanBit));
+
+			__m128i isOverflow = _mm_cmpgt_epi32(bits, overflowThreshold);
+			__m128i isDenormal = _mm_cmplt_epi32(bits, denormalThreshold);
+
+			__m128i half = _mm_or_si128(_mm_and_si128(isDenormal, denormal), _mm_andnot_si128(isDenormal, normal));
+			half = _mm_or_si128(_mm_and_si128(isOverflow, overflow), _mm_andnot_si128(isOverflow, half));
+			half = _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+
+			// Sign extend, so the signed saturating pack keeps the bits as they are.
+			return _mm_srai_epi32(_mm_slli_epi32(half, 16), 16);
+		};
+
+		for (; value + 8 <= valueCount; value += 8)
+		{
+			__m128i low = convert(_mm_loadu_ps(source + value));
+			__m128i high = convert(_mm_loadu_ps(source + value + 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + value), _mm_packs_epi32(low, high));
+		}
+#endif
+
+		for (; value < valueCount; value++)
+			destination[value] = FloatToHalf(source[value]);
+	}
+
+	void ConvertHalfToFloat(const uint16_t* source, float* destination, size_t valueCount)
+	{
+		for (size_t value = 0; value < valueCount; value++)
+			destination[value] = HalfToFloat(source[value]);
+	}
+
+	void PremultiplyAlpha(float* pixels, size_t pixelCount)
+	{
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			float* color = pixels + pixel * 4;
+#if SIMD_SSE2
+			__m128 value = _mm_loadu_ps(color);
+			__m128 alpha = _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3));
+			__m128 premultiplied = _mm_mul_ps(value, alpha);
+			_mm_storeu_ps(color, SelectSse(GetAlphaLaneMask(4), value, premultiplied));
+#else
+			color[0] *= color[3];
+			color[1] *= color[3];
+			color[2] *= color[3];
+#endif
+		}
+	}
+
+	void UnpremultiplyAlpha(float* pixels, size_t pixelCount)
+	{
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			float* color = pixels + pixel * 4;
+			if (color[3] <= 0.0f)
+				continue;
+
+			float inverseAlpha = 1.0f / color[3];
+			color[0] = std::min(color[0] * inverseAlpha, 1.0f);
+			color[1] = std::min(color[1] * inverseAlpha, 1.0f);
+			color[2] = std::min(color[2] * inverseAlpha, 1.0f);
+		}
+	}
+
+	void PremultiplyAlpha(uint8_t* pixels, size_t pixelCount, bool srgb)
+	{
+		const float* toLinear = GetSrgbTables().toLinear;
+
+		for (size_t pixel = 0; pixel < pixelCount; pixel++)
+		{
+			uint8_t* color = pixels + pixel * 4;
+			uint32_t alpha = color[3];
+
+			for (uint32_t channel = 0; channel < 3; channel++)
+			{
+				if (srgb)
+					color[channel] = LinearToSrgbUnorm8(toLinear[color[channel]] * Unorm8ToFloat(color[3]));
+				else
+					color[channel] = static_cast<uint8_t>((color[channel] * alpha + 127) / 255);
+			}
+		}
+	}
+
+	void ConvertVertexColorsToLinear(DirectX::XMFLOAT3* colors, size_t count)
+	{
+		static_assert(sizeof(DirectX::XMFLOAT3) == 3 * sizeof(float), "XMFLOAT3 must be three packed floats!");
+
+		float* values = reinterpret_cast<float*>(colors);
+		ConvertSrgbToLinear(values, values, count, 3);
+	}
+}
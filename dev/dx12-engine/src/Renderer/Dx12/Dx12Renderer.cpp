@@ -2,13 +2,18 @@
 
 #include "Core/Error.h"
 
-#include "GpuApi/Dx12/Dx12Barrier.h"
 #include "GpuApi/Dx12/Dx12CommandManager.h"
 #include "GpuApi/Dx12/Dx12GpuApi.h"
 #include "GpuApi/Dx12/Dx12Queue.h"
 #include "GpuApi/Dx12/Dx12ResourceManager.h"
 #include "GpuApi/Dx12/Dx12SwapChain.h"
 
+#include "Streaming/Dx12/Dx12MeshLodLoader.h"
+#include "Streaming/MeshLodStreamer.h"
+
+#include <cassert>
+#include <vector>
+
 namespace dxe
 {
 	void Dx12Renderer::Initialize()
@@ -29,28 +34,25 @@ namespace dxe
 		Dx12CommandManager* commandManager = gpuData->commandManager;
 		Dx12SwapChain* swapChain = gpuData->swapChain;
 
-		const Dx12GraphicsCommandContext* commandContext =
-			commandManager->GetGraphicsCommandContext(
-				swapChain->GetCurrentBackBufferIndex());
+		// Blocks only when the GPU is still working on the frame that used this context.
+		const Dx12GraphicsCommandContext* commandContext = commandManager->BeginFrame();
+
+		gpuData->resourceManager->RetireDeferredReleases();
+		gpuData->resourceManager->GetDescriptorRing()->Retire();
+		gpuData->resourceManager->GetBindlessTable()->Retire();
+		gpuData->resourceManager->GetGeometryBuffer()->Retire();
 
 		ID3D12CommandAllocator* commandAllocator = commandContext->commandAllocator.Get();
 		ID3D12GraphicsCommandList7* graphicsCommandList = commandContext->graphicsCommandList.Get();
 
 		// Get resources
 
-		std::shared_ptr<Dx12Mesh> mesh =
-			gpuData->resourceManager->meshes.GetResource(renderData.meshId);
-
 		std::shared_ptr<Dx12RootSignature> rootSignature =
 			gpuData->resourceManager->rootSignatures.GetResource(renderData.rootSignatureId);
 
 		std::shared_ptr<Dx12GraphicsPSO> graphicsPSO =
 			gpuData->resourceManager->graphicsPSOs.GetResource(renderData.graphicsPSOId);
 
-		DX12_THROW_IF_NOT_SUCCESS(
-			commandAllocator->Reset(),
-			"Failed to reset the Command Allocator!");
-
 		// 1.
 		// 
 		// It's allowed not to set a pipeline when resetting a command buffer
@@ -73,27 +75,106 @@ namespace dxe
 		graphicsCommandList->SetPipelineState(graphicsPSO->GetPipelineState());
 		graphicsCommandList->SetGraphicsRootSignature(graphicsPSO->GetRootSignature());
 
+		// One shader visible heap for the whole frame, tables are bound from it.
+		ID3D12DescriptorHeap* descriptorHeaps[] = {
+			gpuData->resourceManager->GetShaderVisibleDescriptorHeap()->GetDescriptorHeap() };
+		graphicsCommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+
+		// Bound once, draws only change their root constants.
+		const bool bindless = rootSignature->IsBindless();
+		if (bindless)
+		{
+			graphicsCommandList->SetGraphicsRootDescriptorTable(
+				DX12_BINDLESS_TABLE_PARAMETER, gpuData->resourceManager->GetBindlessTable()->GetGpuHandle());
+		}
+
+		auto setDrawConstants = [&](uint32_t drawIndex) {
+			Dx12BindlessDrawConstants drawConstants{};
+			drawConstants.drawIndex = drawIndex;
+			if (drawIndex < renderData.resourceIndices.size())
+				drawConstants.resourceIndex = renderData.resourceIndices[drawIndex];
+
+			graphicsCommandList->SetGraphicsRoot32BitConstants(
+				DX12_BINDLESS_ROOT_CONSTANTS_PARAMETER, DX12_BINDLESS_ROOT_CONSTANT_COUNT, &drawConstants, 0);
+		};
+
 		graphicsCommandList->RSSetViewports(1, &viewport);
 		graphicsCommandList->RSSetScissorRects(1, &scissorRect);
 
-		D3D12_RESOURCE_BARRIER renderTargetBarrier =
-			Dx12Barrier::CreatePresentToRenderTargetTransitionBarrier(
-				swapChain->GetCurrentBackBufferResource());
-		graphicsCommandList->ResourceBarrier(1, &renderTargetBarrier);
+		// Back buffers are presentable between frames.
+		Dx12ResourceStateTracker* stateTracker = commandContext->stateTracker.get();
+		ID3D12Resource* backBuffer = swapChain->GetCurrentBackBufferResource();
+		stateTracker->TrackResource(backBuffer, D3D12_RESOURCE_STATE_PRESENT);
+
+		stateTracker->Transition(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+		stateTracker->FlushBarriers(graphicsCommandList);
 
 		D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = swapChain->GetCurrentBackBufferRTV();
 		graphicsCommandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
 
-		const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
+		// sRGB (0.0, 0.2, 0.4) in linear space, the back buffer's view encodes it.
+		const float clearColor[] = { 0.0f, 0.0331f, 0.1329f, 1.0f };
 		graphicsCommandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
 
-		// Render the vertex buffer
-
-		Dx12VertexBuffer* vb = mesh->GetVertexBuffer();
-		D3D12_VERTEX_BUFFER_VIEW vbView = vb->GetVertexBufferView();
 		graphicsCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-		graphicsCommandList->IASetVertexBuffers(0, 1, &vbView);
-		graphicsCommandList->DrawInstanced(static_cast<UINT>(vb->GetVertexCount()), 1, 0, 0);
+
+		if (!renderData.geometryIds.empty() || !renderData.streamingMeshIds.empty())
+		{
+			// Render the geometry buffer ranges, vertex buffers only change with the vertex stride
+
+			Dx12GeometryBuffer* geometryBuffer = gpuData->resourceManager->GetGeometryBuffer();
+
+			std::vector<Dx12GeometryRange> ranges;
+			ranges.reserve(renderData.geometryIds.size() + renderData.streamingMeshIds.size());
+			for (uint32_t geometryId : renderData.geometryIds)
+				ranges.push_back(geometryBuffer->GetRange(geometryId));
+
+			// Progressive meshes draw the indices of the LODs up to the one picked for them.
+			assert((renderData.streamingMeshIds.empty() || (renderData.lodStreamer && renderData.lodLoader)) &&
+				"Streaming meshes need the streamer and its LOD loader!");
+			for (uint32_t meshId : renderData.streamingMeshIds)
+			{
+				uint32_t drawLod = renderData.lodStreamer->GetDrawLod(meshId);
+				if (drawLod != UINT32_MAX)
+					ranges.push_back(renderData.lodLoader->GetLodRange(meshId, drawLod));
+			}
+
+			D3D12_INDEX_BUFFER_VIEW ibView = geometryBuffer->GetIndexBufferView();
+			graphicsCommandList->IASetIndexBuffer(&ibView);
+
+			uint32_t boundVertexStride{ 0 };
+			for (uint32_t drawIndex = 0; drawIndex < ranges.size(); drawIndex++)
+			{
+				const Dx12GeometryRange& range = ranges[drawIndex];
+				if (range.vertexStride != boundVertexStride)
+				{
+					D3D12_VERTEX_BUFFER_VIEW vbView = geometryBuffer->GetVertexBufferView(range.vertexStride);
+					graphicsCommandList->IASetVertexBuffers(0, 1, &vbView);
+					boundVertexStride = range.vertexStride;
+				}
+
+				if (bindless)
+					setDrawConstants(drawIndex);
+
+				graphicsCommandList->DrawIndexedInstanced(range.indexCount, 1, range.firstIndex, range.baseVertex, 0);
+			}
+		}
+		else
+		{
+			// Render the vertex buffer
+
+			std::shared_ptr<Dx12Mesh> mesh =
+				gpuData->resourceManager->meshes.GetResource(renderData.meshId);
+
+			Dx12VertexBuffer* vb = mesh->GetVertexBuffer();
+			D3D12_VERTEX_BUFFER_VIEW vbView = vb->GetVertexBufferView();
+			graphicsCommandList->IASetVertexBuffers(0, 1, &vbView);
+
+			if (bindless)
+				setDrawConstants(0);
+
+			graphicsCommandList->DrawInstanced(static_cast<UINT>(vb->GetVertexCount()), 1, 0, 0);
+		}
 
 		/*
 		graphicsCommandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -101,10 +182,8 @@ namespace dxe
 		graphicsCommandList->DrawInstanced(3, 1, 0, 0);
 		*/
 
-		D3D12_RESOURCE_BARRIER presentBarrier =
-			Dx12Barrier::CreateRenderTargetToPresentTransitionBarrier(
-				swapChain->GetCurrentBackBufferResource());
-		graphicsCommandList->ResourceBarrier(1, &presentBarrier);
+		stateTracker->Transition(backBuffer, D3D12_RESOURCE_STATE_PRESENT);
+		stateTracker->FlushBarriers(graphicsCommandList);
 
 		DX12_THROW_IF_NOT_SUCCESS(
 			graphicsCommandList->Close(),
@@ -112,10 +191,18 @@ namespace dxe
 
 		Dx12DirectQueue* directQueue = gpuData->commandManager->GetDirectQueue();
 
+		// Meshes uploaded since the last frame have to be in place before they're drawn.
+		gpuData->resourceManager->GetUploadQueue()->SynchronizeQueue(directQueue);
+
 		ID3D12CommandList* ppCommandLists[] = { graphicsCommandList };
 		directQueue->GetCommandQueue()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
 
 		swapChain->Present();
+
+		commandManager->EndFrame();
+
+		// Tables allocated during the frame are reused once it's done.
+		gpuData->resourceManager->GetDescriptorRing()->Submit(commandManager->GetFramePacer().GetLastFenceValue());
 	}
 
 	void Dx12Renderer::SetViewport(uint32_t width, uint32_t height)
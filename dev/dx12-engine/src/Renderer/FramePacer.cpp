@@ -0,0 +1,64 @@
+#include "Renderer/FramePacer.h"
+
+#include "Core/Error.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	FramePacer::FramePacer(uint32_t frameLatency)
+		: frameLatency(frameLatency)
+	{
+		if (frameLatency < MIN_FRAME_LATENCY || frameLatency > MAX_FRAME_LATENCY)
+			throw Error{ "Frame latency has to be between 1 and 3 frames!" };
+	}
+
+	uint64_t FramePacer::BeginFrame(uint64_t completedFenceValue)
+	{
+		assert(!frameOpen && "The previous frame has to end first!");
+		frameOpen = true;
+
+		frameSlot = static_cast<uint32_t>(statistics.frameCount % frameLatency);
+		statistics.frameCount++;
+
+		uint64_t slotFenceValue = slotFenceValues[frameSlot];
+		if (slotFenceValue <= completedFenceValue)
+			return 0;
+
+		statistics.waitCount++;
+		return slotFenceValue;
+	}
+
+	void FramePacer::EndFrame(uint64_t fenceValue)
+	{
+		assert(frameOpen && "No frame to end!");
+		assert(fenceValue >= lastFenceValue && "Frame fence values must not decrease!");
+		frameOpen = false;
+
+		slotFenceValues[frameSlot] = fenceValue;
+		lastFenceValue = fenceValue;
+	}
+
+	uint32_t FramePacer::GetFrameLatency() const
+	{
+		return frameLatency;
+	}
+	uint32_t FramePacer::GetFrameSlot() const
+	{
+		return frameSlot;
+	}
+	uint64_t FramePacer::GetFrameCount() const
+	{
+		return statistics.frameCount;
+	}
+
+	uint64_t FramePacer::GetLastFenceValue() const
+	{
+		return lastFenceValue;
+	}
+
+	FramePacerStatistics FramePacer::GetStatistics() const
+	{
+		return statistics;
+	}
+}
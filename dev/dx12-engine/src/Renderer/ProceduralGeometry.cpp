@@ -0,0 +1,909 @@
+#include "Renderer/ProceduralGeometry.h"
+
+#include "Core/Error.h"
+#include "Core/MathUtility.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	// Shapes with fewer vertices are generated on the calling thread.
+	constexpr uint64_t PARALLEL_VERTEX_COUNT = 16384;
+	constexpr uint32_t VERTEX_GRAIN_SIZE = 4096;
+
+	// Grid indices are emitted in vertical stripes this many quads wide, row by row. The previous
+	// row's vertices are still in a 32 entry cache when the next row reuses them.
+	constexpr uint32_t STRIPE_COLUMN_COUNT = 12;
+
+	constexpr float PI = 3.14159265358979f;
+	constexpr float TWO_PI = 2.0f * PI;
+	constexpr float HALF_PI = 0.5f * PI;
+
+	struct SurfaceVertex
+	{
+		XMFLOAT3 position{};
+		XMFLOAT3 normal{};
+		XMFLOAT3 tangent{};
+		XMFLOAT2 uv{};
+	};
+
+	// Around the Y axis, counter-clockwise seen from above. 'angle' 0 points along +X.
+	static XMFLOAT3 GetRadialDirection(float angle)
+	{
+		return XMFLOAT3{ std::cos(angle), 0.0f, -std::sin(angle) };
+	}
+
+	static XMFLOAT3 GetRadialTangent(float angle)
+	{
+		return XMFLOAT3{ -std::sin(angle), 0.0f, -std::cos(angle) };
+	}
+
+	// Vertex writer
+
+	class VertexWriter
+	{
+	public:
+
+		explicit VertexWriter(const ProceduralVertexFormat& vertexFormat)
+			: vertexStride(vertexFormat.vertexStride)
+		{
+			for (const VertexAttribDescriptor& attrib : vertexFormat.vertexAttribLayout)
+			{
+				if (attrib.dimension == 0 || attrib.dimension > 4)
+					throw Error{ "Vertex attribute dimension must be between 1 and 4!" };
+				if (attrib.offset + attrib.GetVertexAttributeSize() > vertexStride)
+					throw Error{ "Vertex attribute doesn't fit into the vertex stride!" };
+
+				if (attrib.type == VertexAttribType::UNKNOWN)
+					continue;
+
+				attributes.push_back(attrib);
+			}
+
+			color = vertexFormat.color;
+		}
+
+		uint32_t GetVertexStride() const
+		{
+			return vertexStride;
+		}
+
+		void Write(uint8_t* vertex, const SurfaceVertex& surfaceVertex) const
+		{
+			for (const VertexAttribDescriptor& attrib : attributes)
+			{
+				// Missing components read as (0, 0, 0, 1).
+				float values[4]{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+				switch (attrib.type)
+				{
+				case VertexAttribType::POSITION:
+					CopyFloat3(values, surfaceVertex.position);
+					break;
+				case VertexAttribType::NORMAL:
+					CopyFloat3(values, surfaceVertex.normal);
+					break;
+				case VertexAttribType::TANGENT:
+					CopyFloat3(values, surfaceVertex.tangent);
+					break;
+				case VertexAttribType::COLOR:
+					CopyFloat3(values, color);
+					break;
+				case VertexAttribType::UV:
+					values[0] = surfaceVertex.uv.x;
+					values[1] = surfaceVertex.uv.y;
+					break;
+				default:
+					break;
+				}
+
+				WriteAttribute(vertex + attrib.offset, attrib, values);
+			}
+		}
+
+	private:
+
+		static void CopyFloat3(float* values, const XMFLOAT3& value)
+		{
+			values[0] = value.x;
+			values[1] = value.y;
+			values[2] = value.z;
+		}
+
+		template <typename DstType>
+		static void WriteComponents(uint8_t* destination, const float* values, uint32_t dimension)
+		{
+			for (uint32_t component = 0; component < dimension; component++)
+			{
+				DstType value{};
+				WriteSrcToDst(&values[component], &value);
+				std::memcpy(destination + component * sizeof(DstType), &value, sizeof(DstType));
+			}
+		}
+
+		static void WriteAttribute(uint8_t* destination, const VertexAttribDescriptor& attrib, const float* values)
+		{
+			switch (attrib.format)
+			{
+			case VertexAttribFormat::FLOAT32:
+				std::memcpy(destination, values, attrib.dimension * sizeof(float));
+				break;
+			case VertexAttribFormat::UINT32:
+				WriteComponents<uint32_t>(destination, values, attrib.dimension);
+				break;
+			case VertexAttribFormat::UINT16:
+				WriteComponents<uint16_t>(destination, values, attrib.dimension);
+				break;
+			case VertexAttribFormat::UINT8:
+				WriteComponents<uint8_t>(destination, values, attrib.dimension);
+				break;
+			case VertexAttribFormat::INT32:
+				WriteComponents<int32_t>(destination, values, attrib.dimension);
+				break;
+			case VertexAttribFormat::INT16:
+				WriteComponents<int16_t>(destination, values, attrib.dimension);
+				break;
+			case VertexAttribFormat::INT8:
+				WriteComponents<int8_t>(destination, values, attrib.dimension);
+				break;
+			}
+		}
+
+		std::vector<VertexAttribDescriptor> attributes;
+		uint32_t vertexStride{ 0 };
+
+		XMFLOAT3 color{};
+	};
+
+	// Mesh building
+
+	static ProceduralMesh CreateProceduralMesh(const VertexWriter& writer, const ProceduralVertexFormat& vertexFormat,
+		uint64_t vertexCount, uint64_t indexCount)
+	{
+		if (vertexCount > UINT32_MAX || indexCount > UINT32_MAX)
+			throw Error{ "Procedural mesh is too large for 32-bit indices!" };
+
+		ProceduralMesh mesh{};
+		mesh.vertexBufferInfo.vertexAttribLayout = vertexFormat.vertexAttribLayout;
+		mesh.vertexBufferInfo.vertexCount = static_cast<uint32_t>(vertexCount);
+		mesh.vertexBufferInfo.vertexStride = writer.GetVertexStride();
+
+		mesh.vertexData.resize(static_cast<size_t>(vertexCount) * writer.GetVertexStride());
+		mesh.indices.resize(static_cast<size_t>(indexCount));
+		return mesh;
+	}
+
+	// Parametric surfaces
+
+	// A grid of 'columns' x 'rows' quads, (columns + 1) x (rows + 1) vertices, row by row.
+	// Columns follow U, rows follow V, and rows x columns points out of the front face.
+	// A collapsed row has all of its vertices at one point (poles, cap centers), the triangles
+	// touching it that would be degenerate are skipped.
+	struct SurfaceGrid
+	{
+		uint32_t columns{ 0 };
+		uint32_t rows{ 0 };
+
+		bool collapsedFirstRow{ false };
+		bool collapsedLastRow{ false };
+
+		uint64_t GetVertexCount() const
+		{
+			return static_cast<uint64_t>(columns + 1) * (rows + 1);
+		}
+
+		uint32_t GetColumnIndexCount() const
+		{
+			uint32_t indexCount = rows * 6;
+			if (collapsedFirstRow)
+				indexCount -= 3;
+			if (collapsedLastRow)
+				indexCount -= 3;
+			return indexCount;
+		}
+
+		uint64_t GetIndexCount() const
+		{
+			return static_cast<uint64_t>(columns) * GetColumnIndexCount();
+		}
+	};
+
+	static void ValidateSurfaceGrid(const SurfaceGrid& grid)
+	{
+		if (grid.columns == 0 || grid.rows == 0)
+			throw Error{ "Procedural shapes need at least one segment in every direction!" };
+
+		uint32_t minRows = (grid.collapsedFirstRow ? 1 : 0) + (grid.collapsedLastRow ? 1 : 0);
+		if (grid.rows < std::max(minRows, 1u))
+			throw Error{ "Procedural shape doesn't have enough rings!" };
+	}
+
+	// 'evaluate(column, row)' returns the SurfaceVertex at that grid point.
+	template <typename Evaluate>
+	static void WriteSurface(const VertexWriter& writer, ProceduralMesh& mesh, uint32_t firstVertex, uint32_t firstIndex,
+		const SurfaceGrid& grid, const Evaluate& evaluate, ThreadPool* threadPool)
+	{
+		uint32_t rowVertexCount = grid.columns + 1;
+		bool parallel = grid.GetVertexCount() >= PARALLEL_VERTEX_COUNT;
+
+		auto writeRows = [&](uint32_t beginRow, uint32_t endRow) {
+			for (uint32_t row = beginRow; row < endRow; row++)
+			{
+				size_t vertexIndex = static_cast<size_t>(firstVertex) + static_cast<size_t>(row) * rowVertexCount;
+				uint8_t* vertex = mesh.vertexData.data() + vertexIndex * writer.GetVertexStride();
+
+				for (uint32_t column = 0; column <= grid.columns; column++)
+				{
+					writer.Write(vertex, evaluate(column, row));
+					vertex += writer.GetVertexStride();
+				}
+			}
+		};
+
+		uint32_t rowGrainSize = std::max(VERTEX_GRAIN_SIZE / rowVertexCount, 1u);
+		ThreadPool::ParallelForOrInline(parallel ? threadPool : nullptr, 0, grid.rows + 1, rowGrainSize, writeRows);
+
+		// Stripes don't share indices and every column has the same index count,
+		// so each stripe knows where its indices go.
+		uint32_t columnIndexCount = grid.GetColumnIndexCount();
+		uint32_t stripeCount = (grid.columns + STRIPE_COLUMN_COUNT - 1) / STRIPE_COLUMN_COUNT;
+
+		auto writeStripes = [&](uint32_t beginStripe, uint32_t endStripe) {
+			for (uint32_t stripe = beginStripe; stripe < endStripe; stripe++)
+			{
+				uint32_t beginColumn = stripe * STRIPE_COLUMN_COUNT;
+				uint32_t endColumn = std::min(beginColumn + STRIPE_COLUMN_COUNT, grid.columns);
+
+				uint32_t* index = mesh.indices.data() + firstIndex + static_cast<size_t>(beginColumn) * columnIndexCount;
+
+				for (uint32_t row = 0; row < grid.rows; row++)
+				{
+					bool skipUpper = row == 0 && grid.collapsedFirstRow;
+					bool skipLower = row == grid.rows - 1 && grid.collapsedLastRow;
+
+					for (uint32_t column = beginColumn; column < endColumn; column++)
+					{
+						uint32_t topLeft = firstVertex + row * rowVertexCount + column;
+						uint32_t topRight = topLeft + 1;
+						uint32_t bottomLeft = topLeft + rowVertexCount;
+						uint32_t bottomRight = bottomLeft + 1;
+
+						if (!skipLower)
+						{
+							*index++ = topLeft;
+							*index++ = bottomLeft;
+							*index++ = bottomRight;
+						}
+						if (!skipUpper)
+						{
+							*index++ = topLeft;
+							*index++ = bottomRight;
+							*index++ = topRight;
+						}
+					}
+				}
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(parallel ? threadPool : nullptr, 0, stripeCount, 1, writeStripes);
+	}
+
+	// Shapes
+
+	ProceduralMesh GenerateGrid(const ProceduralVertexFormat& vertexFormat, const GridSettings& settings, ThreadPool* threadPool)
+	{
+		SurfaceGrid grid{ settings.widthSegments, settings.depthSegments };
+		ValidateSurfaceGrid(grid);
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, grid.GetVertexCount(), grid.GetIndexCount());
+
+		float columnScale = 1.0f / grid.columns;
+		float rowScale = 1.0f / grid.rows;
+
+		auto evaluate = [&](uint32_t column, uint32_t row) {
+			float u = column * columnScale;
+			float v = row * rowScale;
+
+			SurfaceVertex vertex{};
+			vertex.position = XMFLOAT3{ (u - 0.5f) * settings.width, 0.0f, (v - 0.5f) * settings.depth };
+			vertex.normal = XMFLOAT3{ 0.0f, 1.0f, 0.0f };
+			vertex.tangent = XMFLOAT3{ 1.0f, 0.0f, 0.0f };
+			vertex.uv = XMFLOAT2{ u, v };
+			return vertex;
+		};
+
+		WriteSurface(writer, mesh, 0, 0, grid, evaluate, threadPool);
+		return mesh;
+	}
+
+	ProceduralMesh GenerateBox(const ProceduralVertexFormat& vertexFormat, const BoxSettings& settings, ThreadPool* threadPool)
+	{
+		struct BoxFace
+		{
+			XMFLOAT3 normal{};
+			// U and V directions, V x U is the normal.
+			XMFLOAT3 uAxis{};
+			XMFLOAT3 vAxis{};
+		};
+
+		static const BoxFace faces[6]
+		{
+			{ {  1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f, -1.0f }, {  0.0f, -1.0f,  0.0f } },
+			{ { -1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f,  1.0f }, {  0.0f, -1.0f,  0.0f } },
+			{ {  0.0f,  1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f,  1.0f } },
+			{ {  0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f, -1.0f } },
+			{ {  0.0f,  0.0f,  1.0f }, {  1.0f,  0.0f,  0.0f }, {  0.0f, -1.0f,  0.0f } },
+			{ {  0.0f,  0.0f, -1.0f }, { -1.0f,  0.0f,  0.0f }, {  0.0f, -1.0f,  0.0f } },
+		};
+
+		SurfaceGrid grid{ settings.segments, settings.segments };
+		ValidateSurfaceGrid(grid);
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, grid.GetVertexCount() * 6, grid.GetIndexCount() * 6);
+
+		auto getExtent = [&](const XMFLOAT3& axis) {
+			return std::abs(axis.x) * settings.size.x + std::abs(axis.y) * settings.size.y + std::abs(axis.z) * settings.size.z;
+		};
+
+		float segmentScale = 1.0f / settings.segments;
+
+		for (uint32_t faceIndex = 0; faceIndex < 6; faceIndex++)
+		{
+			const BoxFace& face = faces[faceIndex];
+
+			XMFLOAT3 center = Scale(face.normal, 0.5f * getExtent(face.normal));
+			float uExtent = getExtent(face.uAxis);
+			float vExtent = getExtent(face.vAxis);
+
+			auto evaluate = [&](uint32_t column, uint32_t row) {
+				float u = column * segmentScale;
+				float v = row * segmentScale;
+
+				SurfaceVertex vertex{};
+				vertex.position = Add(center, Add(Scale(face.uAxis, (u - 0.5f) * uExtent), Scale(face.vAxis, (v - 0.5f) * vExtent)));
+				vertex.normal = face.normal;
+				vertex.tangent = face.uAxis;
+				vertex.uv = XMFLOAT2{ u, v };
+				return vertex;
+			};
+
+			uint32_t firstVertex = static_cast<uint32_t>(grid.GetVertexCount() * faceIndex);
+			uint32_t firstIndex = static_cast<uint32_t>(grid.GetIndexCount() * faceIndex);
+			WriteSurface(writer, mesh, firstVertex, firstIndex, grid, evaluate, threadPool);
+		}
+
+		return mesh;
+	}
+
+	ProceduralMesh GenerateUvSphere(const ProceduralVertexFormat& vertexFormat, const UvSphereSettings& settings, ThreadPool* threadPool)
+	{
+		SurfaceGrid grid{ settings.segments, settings.rings, true, true };
+		ValidateSurfaceGrid(grid);
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, grid.GetVertexCount(), grid.GetIndexCount());
+
+		float columnScale = 1.0f / grid.columns;
+		float rowScale = 1.0f / grid.rows;
+
+		auto evaluate = [&](uint32_t column, uint32_t row) {
+			// The seam column repeats column 0 exactly, so there's no crack.
+			float angle = (column % grid.columns) * columnScale * TWO_PI;
+			float polarAngle = row * rowScale * PI;
+
+			SurfaceVertex vertex{};
+			vertex.tangent = GetRadialTangent(angle);
+			vertex.uv = XMFLOAT2{ column * columnScale, row * rowScale };
+
+			if (row == 0 || row == grid.rows)
+			{
+				vertex.normal = XMFLOAT3{ 0.0f, row == 0 ? 1.0f : -1.0f, 0.0f };
+				// Center the pole's UV over its triangle.
+				vertex.uv.x = (column + 0.5f) * columnScale;
+			}
+			else
+			{
+				vertex.normal = Add(Scale(GetRadialDirection(angle), std::sin(polarAngle)), XMFLOAT3{ 0.0f, std::cos(polarAngle), 0.0f });
+			}
+
+			vertex.position = Scale(vertex.normal, settings.radius);
+			return vertex;
+		};
+
+		WriteSurface(writer, mesh, 0, 0, grid, evaluate, threadPool);
+		return mesh;
+	}
+
+	ProceduralMesh GenerateCylinder(const ProceduralVertexFormat& vertexFormat, const CylinderSettings& settings, ThreadPool* threadPool)
+	{
+		SurfaceGrid sideGrid{ settings.segments, settings.heightSegments };
+		ValidateSurfaceGrid(sideGrid);
+
+		// The top cap starts at its center, the bottom one ends there, so both face outwards.
+		SurfaceGrid topCapGrid{ settings.segments, settings.capRings, true, false };
+		SurfaceGrid bottomCapGrid{ settings.segments, settings.capRings, false, true };
+		if (settings.caps)
+		{
+			ValidateSurfaceGrid(topCapGrid);
+			ValidateSurfaceGrid(bottomCapGrid);
+		}
+
+		uint64_t vertexCount = sideGrid.GetVertexCount();
+		uint64_t indexCount = sideGrid.GetIndexCount();
+		if (settings.caps)
+		{
+			vertexCount += topCapGrid.GetVertexCount() + bottomCapGrid.GetVertexCount();
+			indexCount += topCapGrid.GetIndexCount() + bottomCapGrid.GetIndexCount();
+		}
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, vertexCount, indexCount);
+
+		float columnScale = 1.0f / settings.segments;
+		float halfHeight = 0.5f * settings.height;
+
+		auto evaluateSide = [&](uint32_t column, uint32_t row) {
+			float angle = (column % settings.segments) * columnScale * TWO_PI;
+			float v = static_cast<float>(row) / settings.heightSegments;
+
+			SurfaceVertex vertex{};
+			vertex.normal = GetRadialDirection(angle);
+			vertex.position = Add(Scale(vertex.normal, settings.radius), XMFLOAT3{ 0.0f, halfHeight - v * settings.height, 0.0f });
+			vertex.tangent = GetRadialTangent(angle);
+			vertex.uv = XMFLOAT2{ column * columnScale, v };
+			return vertex;
+		};
+
+		WriteSurface(writer, mesh, 0, 0, sideGrid, evaluateSide, threadPool);
+
+		if (!settings.caps)
+			return mesh;
+
+		// Caps are mapped top down, U along +X.
+		auto evaluateCap = [&](uint32_t column, uint32_t row, bool top) {
+			float angle = (column % settings.segments) * columnScale * TWO_PI;
+			float ring = static_cast<float>(row) / settings.capRings;
+			float radius = (top ? ring : 1.0f - ring) * settings.radius;
+
+			SurfaceVertex vertex{};
+			vertex.position = Add(Scale(GetRadialDirection(angle), radius), XMFLOAT3{ 0.0f, top ? halfHeight : -halfHeight, 0.0f });
+			vertex.normal = XMFLOAT3{ 0.0f, top ? 1.0f : -1.0f, 0.0f };
+			vertex.tangent = XMFLOAT3{ 1.0f, 0.0f, 0.0f };
+			vertex.uv = XMFLOAT2{
+				0.5f + 0.5f * vertex.position.x / settings.radius,
+				0.5f + (top ? 0.5f : -0.5f) * vertex.position.z / settings.radius };
+			return vertex;
+		};
+
+		uint32_t firstVertex = static_cast<uint32_t>(sideGrid.GetVertexCount());
+		uint32_t firstIndex = static_cast<uint32_t>(sideGrid.GetIndexCount());
+		WriteSurface(writer, mesh, firstVertex, firstIndex, topCapGrid,
+			[&](uint32_t column, uint32_t row) { return evaluateCap(column, row, true); }, threadPool);
+
+		firstVertex += static_cast<uint32_t>(topCapGrid.GetVertexCount());
+		firstIndex += static_cast<uint32_t>(topCapGrid.GetIndexCount());
+		WriteSurface(writer, mesh, firstVertex, firstIndex, bottomCapGrid,
+			[&](uint32_t column, uint32_t row) { return evaluateCap(column, row, false); }, threadPool);
+
+		return mesh;
+	}
+
+	ProceduralMesh GenerateCapsule(const ProceduralVertexFormat& vertexFormat, const CapsuleSettings& settings, ThreadPool* threadPool)
+	{
+		if (settings.hemisphereRings == 0 || settings.heightSegments == 0)
+			throw Error{ "Procedural shapes need at least one segment in every direction!" };
+
+		// Top hemisphere, cylinder, bottom hemisphere, as one surface from pole to pole.
+		uint32_t hemisphereRings = settings.hemisphereRings;
+		SurfaceGrid grid{ settings.segments, 2 * hemisphereRings + settings.heightSegments, true, true };
+		ValidateSurfaceGrid(grid);
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, grid.GetVertexCount(), grid.GetIndexCount());
+
+		float columnScale = 1.0f / grid.columns;
+		float halfHeight = 0.5f * settings.height;
+
+		// V follows the arc length, so the texture isn't stretched on the cylinder.
+		float hemisphereLength = HALF_PI * settings.radius;
+		float totalLength = 2.0f * hemisphereLength + settings.height;
+
+		auto evaluate = [&](uint32_t column, uint32_t row) {
+			float angle = (column % grid.columns) * columnScale * TWO_PI;
+
+			float polarAngle{ HALF_PI };
+			float centerY{ 0.0f };
+			float length{ 0.0f };
+
+			if (row <= hemisphereRings)
+			{
+				polarAngle = static_cast<float>(row) / hemisphereRings * HALF_PI;
+				centerY = halfHeight;
+				length = polarAngle * settings.radius;
+			}
+			else if (row <= hemisphereRings + settings.heightSegments)
+			{
+				float t = static_cast<float>(row - hemisphereRings) / settings.heightSegments;
+				centerY = halfHeight - t * settings.height;
+				length = hemisphereLength + t * settings.height;
+			}
+			else
+			{
+				polarAngle = HALF_PI + static_cast<float>(row - hemisphereRings - settings.heightSegments) / hemisphereRings * HALF_PI;
+				centerY = -halfHeight;
+				length = hemisphereLength + settings.height + (polarAngle - HALF_PI) * settings.radius;
+			}
+
+			SurfaceVertex vertex{};
+			vertex.tangent = GetRadialTangent(angle);
+			vertex.uv = XMFLOAT2{ column * columnScale, length / totalLength };
+
+			if (row == 0 || row == grid.rows)
+			{
+				vertex.normal = XMFLOAT3{ 0.0f, row == 0 ? 1.0f : -1.0f, 0.0f };
+				vertex.uv.x = (column + 0.5f) * columnScale;
+			}
+			else
+			{
+				vertex.normal = Add(Scale(GetRadialDirection(angle), std::sin(polarAngle)), XMFLOAT3{ 0.0f, std::cos(polarAngle), 0.0f });
+			}
+
+			vertex.position = Add(Scale(vertex.normal, settings.radius), XMFLOAT3{ 0.0f, centerY, 0.0f });
+			return vertex;
+		};
+
+		WriteSurface(writer, mesh, 0, 0, grid, evaluate, threadPool);
+		return mesh;
+	}
+
+	ProceduralMesh GenerateTorus(const ProceduralVertexFormat& vertexFormat, const TorusSettings& settings, ThreadPool* threadPool)
+	{
+		SurfaceGrid grid{ settings.majorSegments, settings.minorSegments };
+		ValidateSurfaceGrid(grid);
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, grid.GetVertexCount(), grid.GetIndexCount());
+
+		float columnScale = 1.0f / grid.columns;
+		float rowScale = 1.0f / grid.rows;
+
+		auto evaluate = [&](uint32_t column, uint32_t row) {
+			float majorAngle = (column % grid.columns) * columnScale * TWO_PI;
+			// Rows start on the outer equator and go down first, which keeps the front faces outside.
+			float minorAngle = -static_cast<float>(row % grid.rows) * rowScale * TWO_PI;
+
+			XMFLOAT3 radialDirection = GetRadialDirection(majorAngle);
+
+			SurfaceVertex vertex{};
+			vertex.normal = Add(Scale(radialDirection, std::cos(minorAngle)), XMFLOAT3{ 0.0f, std::sin(minorAngle), 0.0f });
+			vertex.position = Add(Scale(radialDirection, settings.majorRadius), Scale(vertex.normal, settings.minorRadius));
+			vertex.tangent = GetRadialTangent(majorAngle);
+			vertex.uv = XMFLOAT2{ column * columnScale, row * rowScale };
+			return vertex;
+		};
+
+		WriteSurface(writer, mesh, 0, 0, grid, evaluate, threadPool);
+		return mesh;
+	}
+
+	// Icosphere
+
+	static uint32_t GetMidpointVertex(
+		std::vector<XMFLOAT3>& positions, std::unordered_map<uint64_t, uint32_t>& midpoints, uint32_t vertex1, uint32_t vertex2)
+	{
+		uint64_t key = (static_cast<uint64_t>(std::min(vertex1, vertex2)) << 32) | std::max(vertex1, vertex2);
+
+		auto [iterator, inserted] = midpoints.try_emplace(key, static_cast<uint32_t>(positions.size()));
+		if (inserted)
+			positions.push_back(Normalize(Scale(Add(positions[vertex1], positions[vertex2]), 0.5f)));
+
+		return iterator->second;
+	}
+
+	static float GetLongitudeU(const XMFLOAT3& direction)
+	{
+		float u = std::atan2(-direction.z, direction.x) / TWO_PI;
+		return u < 0.0f ? u + 1.0f : u;
+	}
+
+	ProceduralMesh GenerateIcosphere(const ProceduralVertexFormat& vertexFormat, const IcosphereSettings& settings, ThreadPool* threadPool)
+	{
+		if (settings.subdivisions > 10)
+			throw Error{ "Icosphere subdivision count must be 10 or less!" };
+
+		const float goldenRatio = (1.0f + std::sqrt(5.0f)) * 0.5f;
+
+		std::vector<XMFLOAT3> positions
+		{
+			{ -1.0f,  goldenRatio, 0.0f }, { 1.0f,  goldenRatio, 0.0f }, { -1.0f, -goldenRatio, 0.0f }, { 1.0f, -goldenRatio, 0.0f },
+			{ 0.0f, -1.0f,  goldenRatio }, { 0.0f, 1.0f,  goldenRatio }, { 0.0f, -1.0f, -goldenRatio }, { 0.0f, 1.0f, -goldenRatio },
+			{  goldenRatio, 0.0f, -1.0f }, {  goldenRatio, 0.0f, 1.0f }, { -goldenRatio, 0.0f, -1.0f }, { -goldenRatio, 0.0f, 1.0f },
+		};
+
+		for (XMFLOAT3& position : positions)
+			position = Normalize(position);
+
+		std::vector<uint32_t> triangles
+		{
+			0, 11, 5,   0, 5, 1,   0, 1, 7,   0, 7, 10,   0, 10, 11,
+			1, 5, 9,    5, 11, 4,  11, 10, 2, 10, 7, 6,   7, 1, 8,
+			3, 9, 4,    3, 4, 2,   3, 2, 6,   3, 6, 8,    3, 8, 9,
+			4, 9, 5,    2, 4, 11,  6, 2, 10,  8, 6, 7,    9, 8, 1,
+		};
+
+		for (uint32_t subdivision = 0; subdivision < settings.subdivisions; subdivision++)
+		{
+			std::unordered_map<uint64_t, uint32_t> midpoints;
+			midpoints.reserve(triangles.size());
+
+			std::vector<uint32_t> subdividedTriangles;
+			subdividedTriangles.reserve(triangles.size() * 4);
+
+			for (size_t triangle = 0; triangle < triangles.size(); triangle += 3)
+			{
+				uint32_t vertex1 = triangles[triangle];
+				uint32_t vertex2 = triangles[triangle + 1];
+				uint32_t vertex3 = triangles[triangle + 2];
+
+				uint32_t midpoint12 = GetMidpointVertex(positions, midpoints, vertex1, vertex2);
+				uint32_t midpoint23 = GetMidpointVertex(positions, midpoints, vertex2, vertex3);
+				uint32_t midpoint31 = GetMidpointVertex(positions, midpoints, vertex3, vertex1);
+
+				subdividedTriangles.insert(subdividedTriangles.end(), {
+					vertex1, midpoint12, midpoint31,
+					vertex2, midpoint23, midpoint12,
+					vertex3, midpoint31, midpoint23,
+					midpoint12, midpoint23, midpoint31 });
+			}
+
+			triangles.swap(subdividedTriangles);
+		}
+
+		// Spherical UVs. Triangles crossing the seam get copies of their U < 0.5 vertices at U + 1,
+		// and pole vertices get a copy per triangle, centered over it.
+
+		std::vector<SurfaceVertex> vertices(positions.size());
+		for (size_t vertexIndex = 0; vertexIndex < positions.size(); vertexIndex++)
+		{
+			const XMFLOAT3& normal = positions[vertexIndex];
+
+			SurfaceVertex& vertex = vertices[vertexIndex];
+			vertex.position = Scale(normal, settings.radius);
+			vertex.normal = normal;
+			vertex.tangent = GetRadialTangent(GetLongitudeU(normal) * TWO_PI);
+			vertex.uv = XMFLOAT2{ GetLongitudeU(normal), std::acos(std::clamp(normal.y, -1.0f, 1.0f)) / PI };
+		}
+
+		// Seam copies are past the end of 'positions', their normals are the originals'.
+		auto isPole = [&](uint32_t vertexIndex) {
+			return std::abs(vertices[vertexIndex].normal.y) > 0.99999f;
+		};
+
+		std::unordered_map<uint32_t, uint32_t> seamCopies;
+
+		for (size_t triangle = 0; triangle < triangles.size(); triangle += 3)
+		{
+			uint32_t* corners = &triangles[triangle];
+
+			float minU{ 1.0f };
+			float maxU{ 0.0f };
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				if (isPole(corners[corner]))
+					continue;
+				minU = std::min(minU, vertices[corners[corner]].uv.x);
+				maxU = std::max(maxU, vertices[corners[corner]].uv.x);
+			}
+
+			if (maxU - minU > 0.5f)
+			{
+				for (uint32_t corner = 0; corner < 3; corner++)
+				{
+					uint32_t vertexIndex = corners[corner];
+					if (isPole(vertexIndex) || vertices[vertexIndex].uv.x >= 0.5f)
+						continue;
+
+					auto [iterator, inserted] = seamCopies.try_emplace(vertexIndex, static_cast<uint32_t>(vertices.size()));
+					if (inserted)
+					{
+						SurfaceVertex seamVertex = vertices[vertexIndex];
+						seamVertex.uv.x += 1.0f;
+						vertices.push_back(seamVertex);
+					}
+					corners[corner] = iterator->second;
+				}
+			}
+
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				if (!isPole(corners[corner]))
+					continue;
+
+				const SurfaceVertex& other1 = vertices[corners[(corner + 1) % 3]];
+				const SurfaceVertex& other2 = vertices[corners[(corner + 2) % 3]];
+
+				SurfaceVertex poleVertex = vertices[corners[corner]];
+				poleVertex.uv.x = 0.5f * (other1.uv.x + other2.uv.x);
+				poleVertex.tangent = GetRadialTangent(poleVertex.uv.x * TWO_PI);
+
+				corners[corner] = static_cast<uint32_t>(vertices.size());
+				vertices.push_back(poleVertex);
+			}
+		}
+
+		uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+		OptimizeVertexCacheOrder(triangles, vertexCount);
+
+		// Vertices in the order the indices first use them, for fetch locality. Unused base
+		// pole vertices (replaced by their per-triangle copies) are dropped.
+		std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+		std::vector<uint32_t> vertexOrder;
+		vertexOrder.reserve(vertexCount);
+
+		for (uint32_t& index : triangles)
+		{
+			if (remap[index] == UINT32_MAX)
+			{
+				remap[index] = static_cast<uint32_t>(vertexOrder.size());
+				vertexOrder.push_back(index);
+			}
+			index = remap[index];
+		}
+
+		VertexWriter writer{ vertexFormat };
+		ProceduralMesh mesh = CreateProceduralMesh(writer, vertexFormat, vertexOrder.size(), triangles.size());
+		mesh.indices = std::move(triangles);
+
+		auto writeVertices = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t vertexIndex = begin; vertexIndex < end; vertexIndex++)
+				writer.Write(mesh.vertexData.data() + static_cast<size_t>(vertexIndex) * writer.GetVertexStride(), vertices[vertexOrder[vertexIndex]]);
+		};
+
+		uint32_t writtenVertexCount = static_cast<uint32_t>(vertexOrder.size());
+		ThreadPool::ParallelForOrInline(writtenVertexCount >= PARALLEL_VERTEX_COUNT ? threadPool : nullptr,
+			0, writtenVertexCount, VERTEX_GRAIN_SIZE, writeVertices);
+
+		return mesh;
+	}
+
+	// Vertex cache optimization
+
+	constexpr uint32_t VERTEX_CACHE_SIZE = 32;
+
+	static float CalculateVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+			return -1.0f;
+
+		float score{ 0.0f };
+		if (cachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score, so the next one doesn't just reuse them.
+			if (cachePosition < 3)
+				score = 0.75f;
+			else
+				score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (VERTEX_CACHE_SIZE - 3), 1.5f);
+		}
+
+		// Finishing off vertices with few triangles left frees up the cache sooner.
+		score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+		return score;
+	}
+
+	void OptimizeVertexCacheOrder(std::vector<uint32_t>& indices, uint32_t vertexCount)
+	{
+		uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3);
+		if (triangleCount == 0)
+			return;
+
+		// Triangles of every vertex. The first 'remainingTriangles[v]' ones aren't emitted yet.
+		std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+		for (uint32_t index : indices)
+			triangleOffsets[index + 1]++;
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+			triangleOffsets[vertex + 1] += triangleOffsets[vertex];
+
+		std::vector<uint32_t> vertexTriangles(indices.size());
+		std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+		for (uint32_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indices[triangle * 3 + corner];
+				vertexTriangles[triangleOffsets[vertex] + remainingTriangles[vertex]++] = triangle;
+			}
+		}
+
+		std::vector<int32_t> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t vertex = 0; vertex < vertexCount; vertex++)
+			vertexScores[vertex] = CalculateVertexScore(-1, remainingTriangles[vertex]);
+
+		std::vector<uint8_t> emitted(triangleCount, 0);
+
+		std::vector<uint32_t> optimizedIndices;
+		optimizedIndices.reserve(indices.size());
+
+		std::vector<uint32_t> cache;
+		std::vector<uint32_t> nextCache;
+		cache.reserve(VERTEX_CACHE_SIZE + 3);
+		nextCache.reserve(VERTEX_CACHE_SIZE + 3);
+
+		uint32_t nextUnemitted{ 0 };
+		uint32_t bestTriangle{ 0 };
+
+		for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+		{
+			// Nothing in the cache has triangles left, continue with the first one not emitted.
+			if (bestTriangle == UINT32_MAX)
+			{
+				while (emitted[nextUnemitted])
+					nextUnemitted++;
+				bestTriangle = nextUnemitted;
+			}
+
+			const uint32_t* corners = &indices[bestTriangle * 3];
+			emitted[bestTriangle] = 1;
+
+			nextCache.clear();
+			for (uint32_t corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = corners[corner];
+				optimizedIndices.push_back(vertex);
+				nextCache.push_back(vertex);
+
+				uint32_t* triangles = &vertexTriangles[triangleOffsets[vertex]];
+				uint32_t* last = triangles + --remainingTriangles[vertex];
+				std::iter_swap(std::find(triangles, last, bestTriangle), last);
+			}
+
+			for (uint32_t vertex : cache)
+			{
+				if (vertex != corners[0] && vertex != corners[1] && vertex != corners[2])
+					nextCache.push_back(vertex);
+			}
+			cache.swap(nextCache);
+
+			for (uint32_t position = 0; position < cache.size(); position++)
+			{
+				uint32_t vertex = cache[position];
+				cachePositions[vertex] = position < VERTEX_CACHE_SIZE ? static_cast<int32_t>(position) : -1;
+				vertexScores[vertex] = CalculateVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+			}
+
+			// Only triangles around cached vertices change score.
+			float bestScore{ -1.0f };
+			bestTriangle = UINT32_MAX;
+
+			for (uint32_t vertex : cache)
+			{
+				const uint32_t* triangles = &vertexTriangles[triangleOffsets[vertex]];
+				for (uint32_t triangleIndex = 0; triangleIndex < remainingTriangles[vertex]; triangleIndex++)
+				{
+					uint32_t triangle = triangles[triangleIndex];
+					const uint32_t* triangleCorners = &indices[triangle * 3];
+
+					float score = vertexScores[triangleCorners[0]] + vertexScores[triangleCorners[1]] + vertexScores[triangleCorners[2]];
+
+					if (score > bestScore)
+					{
+						bestScore = score;
+						bestTriangle = triangle;
+					}
+				}
+			}
+
+			if (cache.size() > VERTEX_CACHE_SIZE)
+				cache.resize(VERTEX_CACHE_SIZE);
+		}
+
+		indices.swap(optimizedIndices);
+	}
+}
@@ -0,0 +1,488 @@
+#include "Renderer/SphericalHarmonics.h"
+
+#include "Core/Error.h"
+#include "Core/Simd.h"
+#include "Core/ThreadPool.h"
+#include "Texture/EnvironmentBaker.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	// Normalization constants of the basis functions.
+	constexpr float SH_Y00 = 0.282094792f;
+	constexpr float SH_Y1 = 0.488602512f;
+	constexpr float SH_Y2 = 1.092548431f;
+	constexpr float SH_Y20 = 0.315391565f;
+	constexpr float SH_Y22 = 0.546274215f;
+
+	constexpr uint32_t EVALUATION_GRAIN_SIZE = 256;
+	constexpr uint32_t BLEND_GRAIN_SIZE = 256;
+
+	// Basis
+
+	template <uint32_t CoefficientCount>
+	static void EvaluateBasis(float x, float y, float z, float* basis)
+	{
+		basis[0] = SH_Y00;
+		basis[1] = SH_Y1 * y;
+		basis[2] = SH_Y1 * z;
+		basis[3] = SH_Y1 * x;
+
+		if constexpr (CoefficientCount == SH_L2_COEFFICIENT_COUNT)
+		{
+			basis[4] = SH_Y2 * x * y;
+			basis[5] = SH_Y2 * y * z;
+			basis[6] = SH_Y20 * (3.0f * z * z - 1.0f);
+			basis[7] = SH_Y2 * x * z;
+			basis[8] = SH_Y22 * (x * x - y * y);
+		}
+	}
+
+	void EvaluateShBasis(const XMFLOAT3& direction, std::array<float, SH_L1_COEFFICIENT_COUNT>& basis)
+	{
+		EvaluateBasis<SH_L1_COEFFICIENT_COUNT>(direction.x, direction.y, direction.z, basis.data());
+	}
+
+	void EvaluateShBasis(const XMFLOAT3& direction, std::array<float, SH_L2_COEFFICIENT_COUNT>& basis)
+	{
+		EvaluateBasis<SH_L2_COEFFICIENT_COUNT>(direction.x, direction.y, direction.z, basis.data());
+	}
+
+	// Arithmetic
+
+	ShL1 ConvertShL2ToL1(const ShL2& sh)
+	{
+		ShL1 result{};
+		std::copy(sh.coefficients.begin(), sh.coefficients.begin() + SH_L1_COEFFICIENT_COUNT, result.coefficients.begin());
+		return result;
+	}
+
+	template <uint32_t CoefficientCount>
+	static void AddShImpl(SphericalHarmonics<CoefficientCount>& sh, const SphericalHarmonics<CoefficientCount>& other, float scale)
+	{
+		for (uint32_t index = 0; index < CoefficientCount; index++)
+			StoreColor(sh.coefficients[index], MultiplyAdd(LoadColor(sh.coefficients[index]), LoadColor(other.coefficients[index]), scale));
+	}
+
+	void AddSh(ShL1& sh, const ShL1& other, float scale) { AddShImpl(sh, other, scale); }
+	void AddSh(ShL2& sh, const ShL2& other, float scale) { AddShImpl(sh, other, scale); }
+
+	template <uint32_t CoefficientCount>
+	static void ScaleShImpl(SphericalHarmonics<CoefficientCount>& sh, float scale)
+	{
+		for (uint32_t index = 0; index < CoefficientCount; index++)
+			StoreColor(sh.coefficients[index], MultiplyAdd(ZeroColor(), LoadColor(sh.coefficients[index]), scale));
+	}
+
+	void ScaleSh(ShL1& sh, float scale) { ScaleShImpl(sh, scale); }
+	void ScaleSh(ShL2& sh, float scale) { ScaleShImpl(sh, scale); }
+
+	template <uint32_t CoefficientCount>
+	static void AddShDirectionalLightImpl(SphericalHarmonics<CoefficientCount>& sh, const XMFLOAT3& direction, const XMFLOAT4& color)
+	{
+		float basis[CoefficientCount]{};
+		EvaluateBasis<CoefficientCount>(direction.x, direction.y, direction.z, basis);
+
+		Color4 lightColor = LoadColor(color);
+		for (uint32_t index = 0; index < CoefficientCount; index++)
+			StoreColor(sh.coefficients[index], MultiplyAdd(LoadColor(sh.coefficients[index]), lightColor, basis[index]));
+	}
+
+	void AddShDirectionalLight(ShL1& sh, const XMFLOAT3& direction, const XMFLOAT4& color) { AddShDirectionalLightImpl(sh, direction, color); }
+	void AddShDirectionalLight(ShL2& sh, const XMFLOAT3& direction, const XMFLOAT4& color) { AddShDirectionalLightImpl(sh, direction, color); }
+
+	template <uint32_t CoefficientCount>
+	static void ConvolveShIrradianceImpl(SphericalHarmonics<CoefficientCount>& sh)
+	{
+		// Cosine lobe band factors pi, 2pi/3 and pi/4, divided by pi.
+		for (uint32_t index = 0; index < CoefficientCount; index++)
+		{
+			float scale = index == 0 ? 1.0f : (index < SH_L1_COEFFICIENT_COUNT ? 2.0f / 3.0f : 0.25f);
+			StoreColor(sh.coefficients[index], MultiplyAdd(ZeroColor(), LoadColor(sh.coefficients[index]), scale));
+		}
+	}
+
+	void ConvolveShIrradiance(ShL1& sh) { ConvolveShIrradianceImpl(sh); }
+	void ConvolveShIrradiance(ShL2& sh) { ConvolveShIrradianceImpl(sh); }
+
+	void BlendSh(const ShL2* probes, const uint32_t* probeIndices, const float* weights, uint32_t cornerCount,
+		ShL2* results, size_t count, ThreadPool* threadPool)
+	{
+		auto blendProbes = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t resultIndex = begin; resultIndex < end; resultIndex++)
+			{
+				Color4 sums[SH_L2_COEFFICIENT_COUNT];
+				for (Color4& sum : sums)
+					sum = ZeroColor();
+
+				for (uint32_t corner = 0; corner < cornerCount; corner++)
+				{
+					size_t entry = static_cast<size_t>(resultIndex) * cornerCount + corner;
+					float weight = weights[entry];
+					if (weight == 0.0f)
+						continue;
+
+					const ShL2& probe = probes[probeIndices[entry]];
+					for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+						sums[index] = MultiplyAdd(sums[index], LoadColor(probe.coefficients[index]), weight);
+				}
+
+				for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+					StoreColor(results[resultIndex].coefficients[index], sums[index]);
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(count), BLEND_GRAIN_SIZE, blendProbes);
+	}
+
+	// Evaluation
+
+	template <uint32_t CoefficientCount>
+	static Color4 EvaluateWithBasis(const SphericalHarmonics<CoefficientCount>& sh, const float* basis, uint32_t basisStride)
+	{
+		Color4 sum = ZeroColor();
+		for (uint32_t index = 0; index < CoefficientCount; index++)
+			sum = MultiplyAdd(sum, LoadColor(sh.coefficients[index]), basis[index * basisStride]);
+		return sum;
+	}
+
+	template <uint32_t CoefficientCount>
+	static XMFLOAT4 EvaluateShImpl(const SphericalHarmonics<CoefficientCount>& sh, const XMFLOAT3& direction)
+	{
+		float basis[CoefficientCount]{};
+		EvaluateBasis<CoefficientCount>(direction.x, direction.y, direction.z, basis);
+
+		XMFLOAT4 result{};
+		StoreColor(result, EvaluateWithBasis(sh, basis, 1));
+		return result;
+	}
+
+	XMFLOAT4 EvaluateSh(const ShL1& sh, const XMFLOAT3& direction) { return EvaluateShImpl(sh, direction); }
+	XMFLOAT4 EvaluateSh(const ShL2& sh, const XMFLOAT3& direction) { return EvaluateShImpl(sh, direction); }
+
+#if SIMD_SSE2
+	// Basis values of four directions, one lane each.
+	template <uint32_t CoefficientCount>
+	static void EvaluateBasisSse(const XMFLOAT3* directions, float (*basis)[4])
+	{
+		__m128 x = _mm_setr_ps(directions[0].x, directions[1].x, directions[2].x, directions[3].x);
+		__m128 y = _mm_setr_ps(directions[0].y, directions[1].y, directions[2].y, directions[3].y);
+		__m128 z = _mm_setr_ps(directions[0].z, directions[1].z, directions[2].z, directions[3].z);
+
+		_mm_storeu_ps(basis[0], _mm_set1_ps(SH_Y00));
+
+		__m128 band1 = _mm_set1_ps(SH_Y1);
+		_mm_storeu_ps(basis[1], _mm_mul_ps(band1, y));
+		_mm_storeu_ps(basis[2], _mm_mul_ps(band1, z));
+		_mm_storeu_ps(basis[3], _mm_mul_ps(band1, x));
+
+		if constexpr (CoefficientCount == SH_L2_COEFFICIENT_COUNT)
+		{
+			__m128 band2 = _mm_set1_ps(SH_Y2);
+			__m128 zz = _mm_mul_ps(z, z);
+			_mm_storeu_ps(basis[4], _mm_mul_ps(band2, _mm_mul_ps(x, y)));
+			_mm_storeu_ps(basis[5], _mm_mul_ps(band2, _mm_mul_ps(y, z)));
+			_mm_storeu_ps(basis[6], _mm_mul_ps(_mm_set1_ps(SH_Y20), _mm_sub_ps(_mm_add_ps(zz, _mm_add_ps(zz, zz)), _mm_set1_ps(1.0f))));
+			_mm_storeu_ps(basis[7], _mm_mul_ps(band2, _mm_mul_ps(x, z)));
+			_mm_storeu_ps(basis[8], _mm_mul_ps(_mm_set1_ps(SH_Y22), _mm_sub_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y))));
+		}
+	}
+#endif
+
+	template <uint32_t CoefficientCount>
+	static void EvaluateShBatch(const SphericalHarmonics<CoefficientCount>* probes, const uint32_t* probeIndices,
+		const XMFLOAT3* directions, XMFLOAT4* results, size_t count, ThreadPool* threadPool)
+	{
+		auto evaluateRange = [&](uint32_t begin, uint32_t end) {
+			uint32_t index = begin;
+
+#if SIMD_SSE2
+			float basis[CoefficientCount][4];
+			for (; index + 4 <= end; index += 4)
+			{
+				EvaluateBasisSse<CoefficientCount>(directions + index, basis);
+
+				for (uint32_t lane = 0; lane < 4; lane++)
+				{
+					uint32_t probeIndex = probeIndices ? probeIndices[index + lane] : index + lane;
+					StoreColor(results[index + lane], EvaluateWithBasis(probes[probeIndex], &basis[0][lane], 4));
+				}
+			}
+#endif
+
+			for (; index < end; index++)
+			{
+				uint32_t probeIndex = probeIndices ? probeIndices[index] : index;
+				results[index] = EvaluateShImpl(probes[probeIndex], directions[index]);
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(count), EVALUATION_GRAIN_SIZE, evaluateRange);
+	}
+
+	void EvaluateSh(const ShL1* probes, const uint32_t* probeIndices, const XMFLOAT3* directions,
+		XMFLOAT4* results, size_t count, ThreadPool* threadPool)
+	{
+		EvaluateShBatch(probes, probeIndices, directions, results, count, threadPool);
+	}
+
+	void EvaluateSh(const ShL2* probes, const uint32_t* probeIndices, const XMFLOAT3* directions,
+		XMFLOAT4* results, size_t count, ThreadPool* threadPool)
+	{
+		EvaluateShBatch(probes, probeIndices, directions, results, count, threadPool);
+	}
+
+	// Rotation
+	//
+	// Band 1 coefficients are a vector (x, y, z) stored as (y, z, x), so they rotate with the matrix.
+	// Band 2 is rotated by evaluating the source at five directions rotated backwards and projecting
+	// the values back onto the band through the inverse of the basis matrix at those directions.
+
+	struct ShRotationTables
+	{
+		ShRotationTables()
+		{
+			const float k = 0.707106781f;
+			directions = { XMFLOAT3{ 1.0f, 0.0f, 0.0f }, XMFLOAT3{ 0.0f, 0.0f, 1.0f },
+				XMFLOAT3{ k, k, 0.0f }, XMFLOAT3{ k, 0.0f, k }, XMFLOAT3{ 0.0f, k, k } };
+
+			// Gauss-Jordan inversion of basis[direction][function].
+			double matrix[5][10]{};
+			for (uint32_t row = 0; row < 5; row++)
+			{
+				float basis[SH_L2_COEFFICIENT_COUNT]{};
+				EvaluateBasis<SH_L2_COEFFICIENT_COUNT>(directions[row].x, directions[row].y, directions[row].z, basis);
+				for (uint32_t column = 0; column < 5; column++)
+					matrix[row][column] = basis[SH_L1_COEFFICIENT_COUNT + column];
+				matrix[row][5 + row] = 1.0;
+			}
+
+			for (uint32_t pivot = 0; pivot < 5; pivot++)
+			{
+				uint32_t bestRow = pivot;
+				for (uint32_t row = pivot + 1; row < 5; row++)
+				{
+					if (std::abs(matrix[row][pivot]) > std::abs(matrix[bestRow][pivot]))
+						bestRow = row;
+				}
+				std::swap(matrix[pivot], matrix[bestRow]);
+
+				double scale = 1.0 / matrix[pivot][pivot];
+				for (double& value : matrix[pivot])
+					value *= scale;
+
+				for (uint32_t row = 0; row < 5; row++)
+				{
+					if (row == pivot)
+						continue;
+
+					double factor = matrix[row][pivot];
+					for (uint32_t column = 0; column < 10; column++)
+						matrix[row][column] -= factor * matrix[pivot][column];
+				}
+			}
+
+			for (uint32_t row = 0; row < 5; row++)
+			{
+				for (uint32_t column = 0; column < 5; column++)
+					inverseBasis[row][column] = static_cast<float>(matrix[row][5 + column]);
+			}
+		}
+
+		std::array<XMFLOAT3, 5> directions{};
+		// [function][direction]
+		float inverseBasis[5][5]{};
+	};
+
+	static const ShRotationTables& GetShRotationTables()
+	{
+		static const ShRotationTables tables{};
+		return tables;
+	}
+
+	ShRotation CreateShRotation(const XMFLOAT4X4& rotation)
+	{
+		ShRotation result{};
+
+		// Coefficient order (y, z, x) to matrix axes. A row vector maps as v' = v * M.
+		const uint32_t axes[3] = { 1, 2, 0 };
+		for (uint32_t destination = 0; destination < 3; destination++)
+		{
+			for (uint32_t source = 0; source < 3; source++)
+				result.band1[destination][source] = rotation.m[axes[source]][axes[destination]];
+		}
+
+		// The source function seen along the backwards rotated directions: d * M^T.
+		const ShRotationTables& tables = GetShRotationTables();
+		float sourceBasis[5][5]{};
+		for (uint32_t directionIndex = 0; directionIndex < 5; directionIndex++)
+		{
+			const XMFLOAT3& direction = tables.directions[directionIndex];
+			float x = direction.x * rotation.m[0][0] + direction.y * rotation.m[0][1] + direction.z * rotation.m[0][2];
+			float y = direction.x * rotation.m[1][0] + direction.y * rotation.m[1][1] + direction.z * rotation.m[1][2];
+			float z = direction.x * rotation.m[2][0] + direction.y * rotation.m[2][1] + direction.z * rotation.m[2][2];
+
+			float basis[SH_L2_COEFFICIENT_COUNT]{};
+			EvaluateBasis<SH_L2_COEFFICIENT_COUNT>(x, y, z, basis);
+			for (uint32_t function = 0; function < 5; function++)
+				sourceBasis[directionIndex][function] = basis[SH_L1_COEFFICIENT_COUNT + function];
+		}
+
+		for (uint32_t destination = 0; destination < 5; destination++)
+		{
+			for (uint32_t source = 0; source < 5; source++)
+			{
+				float sum{ 0.0f };
+				for (uint32_t directionIndex = 0; directionIndex < 5; directionIndex++)
+					sum += tables.inverseBasis[destination][directionIndex] * sourceBasis[directionIndex][source];
+				result.band2[destination][source] = sum;
+			}
+		}
+
+		return result;
+	}
+
+	template <uint32_t CoefficientCount>
+	static void RotateShImpl(const ShRotation& rotation, const SphericalHarmonics<CoefficientCount>* sources,
+		SphericalHarmonics<CoefficientCount>* destinations, size_t count)
+	{
+		for (size_t shIndex = 0; shIndex < count; shIndex++)
+		{
+			// Loaded up front, so rotating in place works.
+			Color4 source[CoefficientCount];
+			for (uint32_t index = 0; index < CoefficientCount; index++)
+				source[index] = LoadColor(sources[shIndex].coefficients[index]);
+
+			SphericalHarmonics<CoefficientCount>& destination = destinations[shIndex];
+			StoreColor(destination.coefficients[0], source[0]);
+
+			for (uint32_t row = 0; row < 3; row++)
+			{
+				Color4 sum = ZeroColor();
+				for (uint32_t column = 0; column < 3; column++)
+					sum = MultiplyAdd(sum, source[1 + column], rotation.band1[row][column]);
+				StoreColor(destination.coefficients[1 + row], sum);
+			}
+
+			if constexpr (CoefficientCount == SH_L2_COEFFICIENT_COUNT)
+			{
+				for (uint32_t row = 0; row < 5; row++)
+				{
+					Color4 sum = ZeroColor();
+					for (uint32_t column = 0; column < 5; column++)
+						sum = MultiplyAdd(sum, source[SH_L1_COEFFICIENT_COUNT + column], rotation.band2[row][column]);
+					StoreColor(destination.coefficients[SH_L1_COEFFICIENT_COUNT + row], sum);
+				}
+			}
+		}
+	}
+
+	void RotateSh(const ShRotation& rotation, const ShL1* sources, ShL1* destinations, size_t count)
+	{
+		RotateShImpl(rotation, sources, destinations, count);
+	}
+
+	void RotateSh(const ShRotation& rotation, const ShL2* sources, ShL2* destinations, size_t count)
+	{
+		RotateShImpl(rotation, sources, destinations, count);
+	}
+
+	// ShCubemapProjector
+
+	ShCubemapProjector::ShCubemapProjector(uint32_t faceSize)
+		: faceSize(faceSize)
+	{
+		if (faceSize == 0)
+			throw Error{ "SH projection face size must not be 0!" };
+
+		weights.resize(static_cast<size_t>(CUBEMAP_FACE_COUNT) * faceSize * faceSize * SH_L2_COEFFICIENT_COUNT);
+
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			for (uint32_t y = 0; y < faceSize; y++)
+			{
+				for (uint32_t x = 0; x < faceSize; x++)
+				{
+					float solidAngle = CalculateCubemapTexelSolidAngle(x, y, faceSize);
+					XMFLOAT3 direction = GetCubemapDirection(face, (x + 0.5f) / faceSize, (y + 0.5f) / faceSize);
+
+					float* texelWeights = weights.data() + ((static_cast<size_t>(face) * faceSize + y) * faceSize + x) * SH_L2_COEFFICIENT_COUNT;
+					EvaluateBasis<SH_L2_COEFFICIENT_COUNT>(direction.x, direction.y, direction.z, texelWeights);
+					for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+						texelWeights[index] *= solidAngle;
+				}
+			}
+		}
+	}
+
+	void ShCubemapProjector::ProjectFace(const float* surface, uint32_t face, ShL2& result) const
+	{
+		Color4 sums[SH_L2_COEFFICIENT_COUNT];
+		for (Color4& sum : sums)
+			sum = ZeroColor();
+
+		size_t texelCount = static_cast<size_t>(faceSize) * faceSize;
+		const float* texelWeights = weights.data() + face * texelCount * SH_L2_COEFFICIENT_COUNT;
+
+		for (size_t texel = 0; texel < texelCount; texel++)
+		{
+			Color4 color = LoadColor(surface + texel * 4);
+			for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+				sums[index] = MultiplyAdd(sums[index], color, texelWeights[index]);
+			texelWeights += SH_L2_COEFFICIENT_COUNT;
+		}
+
+		for (uint32_t index = 0; index < SH_L2_COEFFICIENT_COUNT; index++)
+			StoreColor(result.coefficients[index], MultiplyAdd(LoadColor(result.coefficients[index]), sums[index], 1.0f));
+	}
+
+	uint32_t ShCubemapProjector::FindMatchingMip(const FloatCubemap& cubemap) const
+	{
+		uint32_t mip{ 0 };
+		while (mip < cubemap.mipLevels && cubemap.GetMipSize(mip) != faceSize)
+			mip++;
+		if (mip == cubemap.mipLevels || cubemap.surfaces.size() != CUBEMAP_FACE_COUNT * cubemap.mipLevels)
+			throw Error{ "Cube map has no mip matching the SH projection face size!" };
+
+		return mip;
+	}
+
+	ShL2 ShCubemapProjector::Project(const FloatCubemap& cubemap) const
+	{
+		uint32_t mip = FindMatchingMip(cubemap);
+
+		ShL2 result{};
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+			ProjectFace(cubemap.GetSurface(mip, face), face, result);
+
+		return result;
+	}
+
+	void ShCubemapProjector::Project(const FloatCubemap* const* cubemaps, ShL2* results, size_t count, ThreadPool* threadPool) const
+	{
+		// Validated up front, jobs must not throw.
+		std::vector<uint32_t> mips(count);
+		for (size_t index = 0; index < count; index++)
+			mips[index] = FindMatchingMip(*cubemaps[index]);
+
+		auto projectCubemaps = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t index = begin; index < end; index++)
+			{
+				results[index] = ShL2{};
+				for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+					ProjectFace(cubemaps[index]->GetSurface(mips[index], face), face, results[index]);
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(count), 1, projectCubemaps);
+	}
+
+	uint32_t ShCubemapProjector::GetFaceSize() const
+	{
+		return faceSize;
+	}
+}
@@ -0,0 +1,93 @@
+#include "Serialization/BinaryFormat.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dxe
+{
+	// Heap blocks and mapped files are both at least this aligned, so larger
+	// alignments couldn't be checked against the buffer start anyway.
+	constexpr size_t MAX_BINARY_ALIGNMENT = 16;
+
+	uint32_t ValidateBinaryHeader(
+		const uint8_t* data, size_t size,
+		uint32_t schemaId, uint32_t minSchemaVersion, uint32_t schemaVersion,
+		size_t rootSize, size_t rootAlignment)
+	{
+		if (!data || size < sizeof(BinaryFileHeader) || reinterpret_cast<uintptr_t>(data) % alignof(BinaryFileHeader) != 0)
+			throw Error{ "Binary file is too small or misaligned!" };
+
+		const BinaryFileHeader* header = reinterpret_cast<const BinaryFileHeader*>(data);
+
+		if (header->magic != BINARY_FILE_MAGIC)
+			throw Error{ "Not an engine binary file!" };
+		if (header->schemaId != schemaId)
+			throw Error{ "Binary file holds a different schema!" };
+		if (header->schemaVersion < minSchemaVersion || header->schemaVersion > schemaVersion)
+			throw Error{ "Binary file schema version " + std::to_string(header->schemaVersion) + " isn't supported (expected " +
+				std::to_string(minSchemaVersion) + " to " + std::to_string(schemaVersion) + ")!" };
+		if (header->headerSize < sizeof(BinaryFileHeader) || header->fileSize != size)
+			throw Error{ "Binary file is truncated!" };
+		if (header->rootOffset < header->headerSize || header->rootOffset > size || rootSize > size - header->rootOffset ||
+			(reinterpret_cast<uintptr_t>(data) + header->rootOffset) % rootAlignment != 0)
+			throw Error{ "Binary file root is out of bounds!" };
+
+		return header->schemaVersion;
+	}
+
+	uint32_t GetBinarySchemaVersion(const uint8_t* data)
+	{
+		return reinterpret_cast<const BinaryFileHeader*>(data)->schemaVersion;
+	}
+
+	BinaryWriter::BinaryWriter(uint32_t schemaId, uint32_t schemaVersion, size_t capacity)
+	{
+		buffer.reserve(std::max(capacity, sizeof(BinaryFileHeader)));
+		Append<BinaryFileHeader>();
+
+		BinaryFileHeader& header = Get<BinaryFileHeader>(0);
+		header = BinaryFileHeader{};
+		header.schemaId = schemaId;
+		header.schemaVersion = schemaVersion;
+	}
+
+	void BinaryWriter::WriteString(uint32_t stringPosition, std::string_view string)
+	{
+		uint32_t position = AppendBytes(static_cast<uint64_t>(string.size()) + 1, 1);
+		std::memcpy(buffer.data() + position, string.data(), string.size());
+
+		BinaryString& binaryString = Get<BinaryString>(stringPosition);
+		binaryString.offset = position - stringPosition;
+		binaryString.length = static_cast<uint32_t>(string.size());
+	}
+
+	std::vector<uint8_t> BinaryWriter::Finish(uint32_t rootPosition)
+	{
+		BinaryFileHeader& header = Get<BinaryFileHeader>(0);
+		header.fileSize = buffer.size();
+		header.rootOffset = rootPosition;
+
+		return std::move(buffer);
+	}
+
+	uint32_t BinaryWriter::AppendBytes(uint64_t byteCount, size_t alignment)
+	{
+		assert(alignment > 0 && alignment <= MAX_BINARY_ALIGNMENT && (alignment & (alignment - 1)) == 0 &&
+			"Binary file alignment must be a power of two up to 16!");
+
+		uint64_t position = (buffer.size() + alignment - 1) / alignment * alignment;
+		if (position + byteCount > UINT32_MAX)
+			throw Error{ "Binary files are limited to 4 GB!" };
+
+		buffer.resize(position + byteCount);
+		return static_cast<uint32_t>(position);
+	}
+
+	void BinaryWriter::LinkArray(uint32_t arrayPosition, uint32_t dataPosition, uint32_t count)
+	{
+		// Array layout doesn't depend on the element type.
+		BinaryArray<uint8_t>& array = Get<BinaryArray<uint8_t>>(arrayPosition);
+		array.offset = count > 0 ? dataPosition - arrayPosition : 0;
+		array.count = count;
+	}
+}
@@ -0,0 +1,260 @@
+#include "Serialization/Dx12/Dx12PipelineSerializer.h"
+
+#include "Core/Error.h"
+
+#include <cstddef>
+
+namespace dxe
+{
+	constexpr size_t SHADER_BYTECODE_ALIGNMENT = 16;
+
+	// Render target blend, rasterizer and depth stencil states
+
+	static SerializedRenderTargetBlendState SerializeRenderTargetBlendState(const D3D12_RENDER_TARGET_BLEND_DESC& desc)
+	{
+		SerializedRenderTargetBlendState state{};
+		state.blendEnable = desc.BlendEnable;
+		state.logicOpEnable = desc.LogicOpEnable;
+		state.srcBlend = desc.SrcBlend;
+		state.destBlend = desc.DestBlend;
+		state.blendOp = desc.BlendOp;
+		state.srcBlendAlpha = desc.SrcBlendAlpha;
+		state.destBlendAlpha = desc.DestBlendAlpha;
+		state.blendOpAlpha = desc.BlendOpAlpha;
+		state.logicOp = desc.LogicOp;
+		state.renderTargetWriteMask = desc.RenderTargetWriteMask;
+		return state;
+	}
+	static D3D12_RENDER_TARGET_BLEND_DESC CreateRenderTargetBlendDesc(const SerializedRenderTargetBlendState& state)
+	{
+		D3D12_RENDER_TARGET_BLEND_DESC desc{};
+		desc.BlendEnable = static_cast<BOOL>(state.blendEnable);
+		desc.LogicOpEnable = static_cast<BOOL>(state.logicOpEnable);
+		desc.SrcBlend = static_cast<D3D12_BLEND>(state.srcBlend);
+		desc.DestBlend = static_cast<D3D12_BLEND>(state.destBlend);
+		desc.BlendOp = static_cast<D3D12_BLEND_OP>(state.blendOp);
+		desc.SrcBlendAlpha = static_cast<D3D12_BLEND>(state.srcBlendAlpha);
+		desc.DestBlendAlpha = static_cast<D3D12_BLEND>(state.destBlendAlpha);
+		desc.BlendOpAlpha = static_cast<D3D12_BLEND_OP>(state.blendOpAlpha);
+		desc.LogicOp = static_cast<D3D12_LOGIC_OP>(state.logicOp);
+		desc.RenderTargetWriteMask = static_cast<UINT8>(state.renderTargetWriteMask);
+		return desc;
+	}
+
+	static SerializedRasterizerState SerializeRasterizerState(const D3D12_RASTERIZER_DESC& desc)
+	{
+		SerializedRasterizerState state{};
+		state.fillMode = desc.FillMode;
+		state.cullMode = desc.CullMode;
+		state.frontCounterClockwise = desc.FrontCounterClockwise;
+		state.depthBias = desc.DepthBias;
+		state.depthBiasClamp = desc.DepthBiasClamp;
+		state.slopeScaledDepthBias = desc.SlopeScaledDepthBias;
+		state.depthClipEnable = desc.DepthClipEnable;
+		state.multisampleEnable = desc.MultisampleEnable;
+		state.antialiasedLineEnable = desc.AntialiasedLineEnable;
+		state.forcedSampleCount = desc.ForcedSampleCount;
+		state.conservativeRaster = desc.ConservativeRaster;
+		return state;
+	}
+	static D3D12_RASTERIZER_DESC CreateRasterizerDesc(const SerializedRasterizerState& state)
+	{
+		D3D12_RASTERIZER_DESC desc{};
+		desc.FillMode = static_cast<D3D12_FILL_MODE>(state.fillMode);
+		desc.CullMode = static_cast<D3D12_CULL_MODE>(state.cullMode);
+		desc.FrontCounterClockwise = static_cast<BOOL>(state.frontCounterClockwise);
+		desc.DepthBias = state.depthBias;
+		desc.DepthBiasClamp = state.depthBiasClamp;
+		desc.SlopeScaledDepthBias = state.slopeScaledDepthBias;
+		desc.DepthClipEnable = static_cast<BOOL>(state.depthClipEnable);
+		desc.MultisampleEnable = static_cast<BOOL>(state.multisampleEnable);
+		desc.AntialiasedLineEnable = static_cast<BOOL>(state.antialiasedLineEnable);
+		desc.ForcedSampleCount = state.forcedSampleCount;
+		desc.ConservativeRaster = static_cast<D3D12_CONSERVATIVE_RASTERIZATION_MODE>(state.conservativeRaster);
+		return desc;
+	}
+
+	static SerializedStencilOpState SerializeStencilOpState(const D3D12_DEPTH_STENCILOP_DESC& desc)
+	{
+		SerializedStencilOpState state{};
+		state.stencilFailOp = desc.StencilFailOp;
+		state.stencilDepthFailOp = desc.StencilDepthFailOp;
+		state.stencilPassOp = desc.StencilPassOp;
+		state.stencilFunc = desc.StencilFunc;
+		return state;
+	}
+	static D3D12_DEPTH_STENCILOP_DESC CreateStencilOpDesc(const SerializedStencilOpState& state)
+	{
+		D3D12_DEPTH_STENCILOP_DESC desc{};
+		desc.StencilFailOp = static_cast<D3D12_STENCIL_OP>(state.stencilFailOp);
+		desc.StencilDepthFailOp = static_cast<D3D12_STENCIL_OP>(state.stencilDepthFailOp);
+		desc.StencilPassOp = static_cast<D3D12_STENCIL_OP>(state.stencilPassOp);
+		desc.StencilFunc = static_cast<D3D12_COMPARISON_FUNC>(state.stencilFunc);
+		return desc;
+	}
+
+	static SerializedDepthStencilState SerializeDepthStencilState(const D3D12_DEPTH_STENCIL_DESC& desc)
+	{
+		SerializedDepthStencilState state{};
+		state.depthEnable = desc.DepthEnable;
+		state.depthWriteMask = desc.DepthWriteMask;
+		state.depthFunc = desc.DepthFunc;
+		state.stencilEnable = desc.StencilEnable;
+		state.stencilReadMask = desc.StencilReadMask;
+		state.stencilWriteMask = desc.StencilWriteMask;
+		state.frontFace = SerializeStencilOpState(desc.FrontFace);
+		state.backFace = SerializeStencilOpState(desc.BackFace);
+		return state;
+	}
+	static D3D12_DEPTH_STENCIL_DESC CreateDepthStencilDesc(const SerializedDepthStencilState& state)
+	{
+		D3D12_DEPTH_STENCIL_DESC desc{};
+		desc.DepthEnable = static_cast<BOOL>(state.depthEnable);
+		desc.DepthWriteMask = static_cast<D3D12_DEPTH_WRITE_MASK>(state.depthWriteMask);
+		desc.DepthFunc = static_cast<D3D12_COMPARISON_FUNC>(state.depthFunc);
+		desc.StencilEnable = static_cast<BOOL>(state.stencilEnable);
+		desc.StencilReadMask = static_cast<UINT8>(state.stencilReadMask);
+		desc.StencilWriteMask = static_cast<UINT8>(state.stencilWriteMask);
+		desc.FrontFace = CreateStencilOpDesc(state.frontFace);
+		desc.BackFace = CreateStencilOpDesc(state.backFace);
+		return desc;
+	}
+
+	static D3D12_SHADER_BYTECODE CreateShaderBytecode(const BinaryArray<uint8_t>& bytecode)
+	{
+		D3D12_SHADER_BYTECODE shaderBytecode{};
+		if (!bytecode.Empty())
+		{
+			shaderBytecode.pShaderBytecode = bytecode.Data();
+			shaderBytecode.BytecodeLength = bytecode.Size();
+		}
+		return shaderBytecode;
+	}
+
+	// Pipeline state
+
+	void WriteDx12GraphicsPipelineState(
+		BinaryWriter& writer, uint32_t position, const std::string& name, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& psoDesc)
+	{
+		writer.WriteString(position + offsetof(SerializedGraphicsPipelineState, name), name);
+
+		writer.WriteArray(position + offsetof(SerializedGraphicsPipelineState, vertexShader),
+			static_cast<const uint8_t*>(psoDesc.VS.pShaderBytecode),
+			static_cast<uint32_t>(psoDesc.VS.BytecodeLength), SHADER_BYTECODE_ALIGNMENT);
+		writer.WriteArray(position + offsetof(SerializedGraphicsPipelineState, pixelShader),
+			static_cast<const uint8_t*>(psoDesc.PS.pShaderBytecode),
+			static_cast<uint32_t>(psoDesc.PS.BytecodeLength), SHADER_BYTECODE_ALIGNMENT);
+
+		uint32_t inputElementCount = psoDesc.InputLayout.NumElements;
+		uint32_t inputElementsPosition = writer.WriteArray<SerializedInputElement>(
+			position + offsetof(SerializedGraphicsPipelineState, inputLayout), nullptr, inputElementCount);
+
+		for (uint32_t element = 0; element < inputElementCount; element++)
+		{
+			const D3D12_INPUT_ELEMENT_DESC& elementDesc = psoDesc.InputLayout.pInputElementDescs[element];
+			uint32_t elementPosition = inputElementsPosition + element * sizeof(SerializedInputElement);
+
+			writer.WriteString(elementPosition + offsetof(SerializedInputElement, semanticName), elementDesc.SemanticName);
+
+			SerializedInputElement& inputElement = writer.Get<SerializedInputElement>(elementPosition);
+			inputElement.semanticIndex = elementDesc.SemanticIndex;
+			inputElement.format = elementDesc.Format;
+			inputElement.inputSlot = elementDesc.InputSlot;
+			inputElement.alignedByteOffset = elementDesc.AlignedByteOffset;
+			inputElement.inputSlotClass = elementDesc.InputSlotClass;
+			inputElement.instanceDataStepRate = elementDesc.InstanceDataStepRate;
+		}
+
+		SerializedGraphicsPipelineState& pipelineState = writer.Get<SerializedGraphicsPipelineState>(position);
+
+		pipelineState.blendState.alphaToCoverageEnable = psoDesc.BlendState.AlphaToCoverageEnable;
+		pipelineState.blendState.independentBlendEnable = psoDesc.BlendState.IndependentBlendEnable;
+		for (uint32_t renderTarget = 0; renderTarget < SERIALIZED_RENDER_TARGET_COUNT; renderTarget++)
+			pipelineState.blendState.renderTargets[renderTarget] = SerializeRenderTargetBlendState(psoDesc.BlendState.RenderTarget[renderTarget]);
+
+		pipelineState.sampleMask = psoDesc.SampleMask;
+		pipelineState.rasterizerState = SerializeRasterizerState(psoDesc.RasterizerState);
+		pipelineState.depthStencilState = SerializeDepthStencilState(psoDesc.DepthStencilState);
+
+		pipelineState.primitiveTopologyType = psoDesc.PrimitiveTopologyType;
+
+		pipelineState.renderTargetCount = psoDesc.NumRenderTargets;
+		for (uint32_t renderTarget = 0; renderTarget < SERIALIZED_RENDER_TARGET_COUNT; renderTarget++)
+			pipelineState.renderTargetFormats[renderTarget] = psoDesc.RTVFormats[renderTarget];
+		pipelineState.depthStencilFormat = psoDesc.DSVFormat;
+
+		pipelineState.sampleCount = psoDesc.SampleDesc.Count;
+		pipelineState.sampleQuality = psoDesc.SampleDesc.Quality;
+	}
+
+	std::vector<uint8_t> SerializeDx12PipelineLibrary(const std::vector<Dx12GraphicsPipelineEntry>& pipelines)
+	{
+		BinaryWriter writer{ SerializedPipelineLibrary::SCHEMA_ID, SerializedPipelineLibrary::SCHEMA_VERSION };
+		uint32_t root = writer.Append<SerializedPipelineLibrary>();
+
+		uint32_t pipelinesPosition = writer.WriteArray<SerializedGraphicsPipelineState>(
+			root + offsetof(SerializedPipelineLibrary, graphicsPipelines), nullptr, static_cast<uint32_t>(pipelines.size()));
+
+		for (size_t pipeline = 0; pipeline < pipelines.size(); pipeline++)
+		{
+			if (!pipelines[pipeline].pso)
+				throw Error{ "Pipeline library entry '" + pipelines[pipeline].name + "' has no PSO!" };
+
+			uint32_t pipelinePosition = pipelinesPosition + static_cast<uint32_t>(pipeline * sizeof(SerializedGraphicsPipelineState));
+			WriteDx12GraphicsPipelineState(writer, pipelinePosition, pipelines[pipeline].name, pipelines[pipeline].pso->GetDesc());
+		}
+
+		return writer.Finish(root);
+	}
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC CreateDx12GraphicsPipelineStateDesc(
+		const SerializedGraphicsPipelineState& pipelineState, ID3D12RootSignature* rootSignature,
+		std::vector<D3D12_INPUT_ELEMENT_DESC>& inputElements)
+	{
+		inputElements.clear();
+		inputElements.reserve(pipelineState.inputLayout.Size());
+
+		for (const SerializedInputElement& inputElement : pipelineState.inputLayout)
+		{
+			D3D12_INPUT_ELEMENT_DESC elementDesc{};
+			elementDesc.SemanticName = inputElement.semanticName.CStr();
+			elementDesc.SemanticIndex = inputElement.semanticIndex;
+			elementDesc.Format = static_cast<DXGI_FORMAT>(inputElement.format);
+			elementDesc.InputSlot = inputElement.inputSlot;
+			elementDesc.AlignedByteOffset = inputElement.alignedByteOffset;
+			elementDesc.InputSlotClass = static_cast<D3D12_INPUT_CLASSIFICATION>(inputElement.inputSlotClass);
+			elementDesc.InstanceDataStepRate = inputElement.instanceDataStepRate;
+			inputElements.push_back(elementDesc);
+		}
+
+		D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc{};
+		psoDesc.pRootSignature = rootSignature;
+
+		psoDesc.VS = CreateShaderBytecode(pipelineState.vertexShader);
+		psoDesc.PS = CreateShaderBytecode(pipelineState.pixelShader);
+
+		psoDesc.InputLayout.pInputElementDescs = inputElements.data();
+		psoDesc.InputLayout.NumElements = static_cast<UINT>(inputElements.size());
+
+		psoDesc.BlendState.AlphaToCoverageEnable = static_cast<BOOL>(pipelineState.blendState.alphaToCoverageEnable);
+		psoDesc.BlendState.IndependentBlendEnable = static_cast<BOOL>(pipelineState.blendState.independentBlendEnable);
+		for (uint32_t renderTarget = 0; renderTarget < SERIALIZED_RENDER_TARGET_COUNT; renderTarget++)
+			psoDesc.BlendState.RenderTarget[renderTarget] = CreateRenderTargetBlendDesc(pipelineState.blendState.renderTargets[renderTarget]);
+
+		psoDesc.SampleMask = pipelineState.sampleMask;
+		psoDesc.RasterizerState = CreateRasterizerDesc(pipelineState.rasterizerState);
+		psoDesc.DepthStencilState = CreateDepthStencilDesc(pipelineState.depthStencilState);
+
+		psoDesc.PrimitiveTopologyType = static_cast<D3D12_PRIMITIVE_TOPOLOGY_TYPE>(pipelineState.primitiveTopologyType);
+
+		psoDesc.NumRenderTargets = pipelineState.renderTargetCount;
+		for (uint32_t renderTarget = 0; renderTarget < SERIALIZED_RENDER_TARGET_COUNT; renderTarget++)
+			psoDesc.RTVFormats[renderTarget] = static_cast<DXGI_FORMAT>(pipelineState.renderTargetFormats[renderTarget]);
+		psoDesc.DSVFormat = static_cast<DXGI_FORMAT>(pipelineState.depthStencilFormat);
+
+		psoDesc.SampleDesc.Count = pipelineState.sampleCount;
+		psoDesc.SampleDesc.Quality = pipelineState.sampleQuality;
+
+		return psoDesc;
+	}
+}
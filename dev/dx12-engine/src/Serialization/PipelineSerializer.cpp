@@ -0,0 +1,34 @@
+#include "Serialization/PipelineSerializer.h"
+
+namespace dxe
+{
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedGraphicsPipelineState& pipelineState)
+	{
+		if (!validator.Check(pipelineState.name) ||
+			!validator.Check(pipelineState.vertexShader) ||
+			!validator.Check(pipelineState.pixelShader) ||
+			!validator.Check(pipelineState.inputLayout))
+			return false;
+
+		for (const SerializedInputElement& inputElement : pipelineState.inputLayout)
+		{
+			if (!validator.Check(inputElement.semanticName))
+				return false;
+		}
+
+		return pipelineState.renderTargetCount <= SERIALIZED_RENDER_TARGET_COUNT;
+	}
+
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedPipelineLibrary& pipelineLibrary)
+	{
+		if (!validator.Check(pipelineLibrary.graphicsPipelines))
+			return false;
+
+		for (const SerializedGraphicsPipelineState& pipelineState : pipelineLibrary.graphicsPipelines)
+		{
+			if (!ValidateBinary(validator, pipelineState))
+				return false;
+		}
+		return true;
+	}
+}
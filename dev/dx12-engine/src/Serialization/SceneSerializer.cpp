@@ -0,0 +1,206 @@
+#include "Serialization/SceneSerializer.h"
+
+#include <cstddef>
+
+namespace dxe
+{
+	constexpr size_t SCENE_BUFFER_ALIGNMENT = 16;
+
+	static bool IsVertexAttribTypeValid(uint32_t type)
+	{
+		switch (static_cast<VertexAttribType>(type))
+		{
+		case VertexAttribType::POSITION:
+		case VertexAttribType::NORMAL:
+		case VertexAttribType::TANGENT:
+		case VertexAttribType::COLOR:
+		case VertexAttribType::UV:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static bool IsVertexAttribFormatValid(uint32_t format)
+	{
+		return format <= static_cast<uint32_t>(VertexAttribFormat::INT8);
+	}
+
+	static bool IsIndexFormatValid(uint32_t format)
+	{
+		return format <= static_cast<uint32_t>(IndexFormat::UINT8);
+	}
+
+	// Buffer infos
+
+	void WriteVertexBufferInfo(BinaryWriter& writer, uint32_t position, const VertexBufferInfo& vertexBufferInfo)
+	{
+		uint32_t attribCount = static_cast<uint32_t>(vertexBufferInfo.vertexAttribLayout.size());
+		uint32_t attribsPosition = writer.WriteArray<SerializedVertexAttrib>(
+			position + offsetof(SerializedVertexBufferInfo, vertexAttribLayout), nullptr, attribCount);
+
+		for (uint32_t attrib = 0; attrib < attribCount; attrib++)
+		{
+			const VertexAttribDescriptor& descriptor = vertexBufferInfo.vertexAttribLayout[attrib];
+
+			SerializedVertexAttrib& serializedAttrib =
+				writer.Get<SerializedVertexAttrib>(attribsPosition + attrib * sizeof(SerializedVertexAttrib));
+			serializedAttrib.dimension = descriptor.dimension;
+			serializedAttrib.offset = descriptor.offset;
+			serializedAttrib.type = static_cast<uint32_t>(descriptor.type);
+			serializedAttrib.format = static_cast<uint32_t>(descriptor.format);
+		}
+
+		SerializedVertexBufferInfo& serializedInfo = writer.Get<SerializedVertexBufferInfo>(position);
+		serializedInfo.vertexCount = vertexBufferInfo.vertexCount;
+		serializedInfo.vertexStride = vertexBufferInfo.vertexStride;
+	}
+
+	void WriteIndexBufferInfo(BinaryWriter& writer, uint32_t position, const IndexBufferInfo& indexBufferInfo)
+	{
+		SerializedIndexBufferInfo& serializedInfo = writer.Get<SerializedIndexBufferInfo>(position);
+		serializedInfo.indexCount = indexBufferInfo.indexCount;
+		serializedInfo.indexFormat = static_cast<uint32_t>(indexBufferInfo.indexFormat);
+	}
+
+	VertexBufferInfo ToVertexBufferInfo(const SerializedVertexBufferInfo& serializedVertexBufferInfo)
+	{
+		VertexBufferInfo vertexBufferInfo{};
+		vertexBufferInfo.vertexCount = serializedVertexBufferInfo.vertexCount;
+		vertexBufferInfo.vertexStride = serializedVertexBufferInfo.vertexStride;
+
+		vertexBufferInfo.vertexAttribLayout.reserve(serializedVertexBufferInfo.vertexAttribLayout.Size());
+		for (const SerializedVertexAttrib& serializedAttrib : serializedVertexBufferInfo.vertexAttribLayout)
+		{
+			VertexAttribDescriptor descriptor{};
+			descriptor.dimension = serializedAttrib.dimension;
+			descriptor.offset = serializedAttrib.offset;
+			descriptor.type = static_cast<VertexAttribType>(serializedAttrib.type);
+			descriptor.format = static_cast<VertexAttribFormat>(serializedAttrib.format);
+			vertexBufferInfo.vertexAttribLayout.push_back(descriptor);
+		}
+
+		return vertexBufferInfo;
+	}
+
+	IndexBufferInfo ToIndexBufferInfo(const SerializedIndexBufferInfo& serializedIndexBufferInfo)
+	{
+		IndexBufferInfo indexBufferInfo{};
+		indexBufferInfo.indexCount = serializedIndexBufferInfo.indexCount;
+		indexBufferInfo.indexFormat = static_cast<IndexFormat>(serializedIndexBufferInfo.indexFormat);
+		return indexBufferInfo;
+	}
+
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedVertexBufferInfo& vertexBufferInfo)
+	{
+		if (!validator.Check(vertexBufferInfo.vertexAttribLayout))
+			return false;
+
+		for (const SerializedVertexAttrib& attrib : vertexBufferInfo.vertexAttribLayout)
+		{
+			if (!IsVertexAttribTypeValid(attrib.type) || !IsVertexAttribFormatValid(attrib.format) ||
+				attrib.dimension == 0 || attrib.dimension > 4)
+				return false;
+
+			uint64_t attribEnd = attrib.offset + static_cast<uint64_t>(attrib.dimension) *
+				GetVertexAttributeFormatSizeInBytes(static_cast<VertexAttribFormat>(attrib.format));
+			if (attribEnd > vertexBufferInfo.vertexStride)
+				return false;
+		}
+		return true;
+	}
+
+	bool ValidateBinary(const BinaryValidator&, const SerializedIndexBufferInfo& indexBufferInfo)
+	{
+		return IsIndexFormatValid(indexBufferInfo.indexFormat);
+	}
+
+	// Scene
+
+	static bool ValidateMesh(const BinaryValidator& validator, const SerializedMesh& mesh)
+	{
+		if (!validator.Check(mesh.name) ||
+			!ValidateBinary(validator, mesh.vertexBufferInfo) ||
+			!ValidateBinary(validator, mesh.indexBufferInfo) ||
+			!validator.Check(mesh.vertexData) ||
+			!validator.Check(mesh.indexData))
+			return false;
+
+		uint64_t vertexDataSize = static_cast<uint64_t>(mesh.vertexBufferInfo.vertexCount) * mesh.vertexBufferInfo.vertexStride;
+		uint64_t indexDataSize = static_cast<uint64_t>(mesh.indexBufferInfo.indexCount) *
+			GetIndexFormatSizeInBytes(static_cast<IndexFormat>(mesh.indexBufferInfo.indexFormat));
+
+		return mesh.vertexData.Size() == vertexDataSize && mesh.indexData.Size() == indexDataSize;
+	}
+
+	bool ValidateBinary(const BinaryValidator& validator, const SerializedScene& scene)
+	{
+		if (!validator.Check(scene.meshes) || !validator.Check(scene.nodes))
+			return false;
+
+		for (const SerializedMesh& mesh : scene.meshes)
+		{
+			if (!ValidateMesh(validator, mesh))
+				return false;
+		}
+
+		for (uint32_t node = 0; node < scene.nodes.Size(); node++)
+		{
+			const SerializedSceneNode& sceneNode = scene.nodes[node];
+			if (sceneNode.meshIndex >= scene.meshes.Size())
+				return false;
+			if (sceneNode.parentIndex != SCENE_NODE_NO_PARENT && sceneNode.parentIndex >= node)
+				return false;
+		}
+		return true;
+	}
+
+	std::vector<uint8_t> SerializeScene(const Scene& scene)
+	{
+		size_t capacity = sizeof(BinaryFileHeader) + sizeof(SerializedScene) + scene.nodes.size() * sizeof(SerializedSceneNode);
+		for (const SceneMesh& mesh : scene.meshes)
+		{
+			capacity += sizeof(SerializedMesh) + mesh.name.size() + 1 + 2 * SCENE_BUFFER_ALIGNMENT +
+				mesh.vertexData.size() + mesh.indexData.size() +
+				mesh.vertexBufferInfo.vertexAttribLayout.size() * sizeof(SerializedVertexAttrib);
+		}
+
+		BinaryWriter writer{ SerializedScene::SCHEMA_ID, SerializedScene::SCHEMA_VERSION, capacity };
+		uint32_t root = writer.Append<SerializedScene>();
+
+		uint32_t meshesPosition = writer.WriteArray<SerializedMesh>(
+			root + offsetof(SerializedScene, meshes), nullptr, static_cast<uint32_t>(scene.meshes.size()));
+
+		for (size_t meshIndex = 0; meshIndex < scene.meshes.size(); meshIndex++)
+		{
+			const SceneMesh& mesh = scene.meshes[meshIndex];
+			uint32_t meshPosition = meshesPosition + static_cast<uint32_t>(meshIndex * sizeof(SerializedMesh));
+
+			writer.WriteString(meshPosition + offsetof(SerializedMesh, name), mesh.name);
+			WriteVertexBufferInfo(writer, meshPosition + offsetof(SerializedMesh, vertexBufferInfo), mesh.vertexBufferInfo);
+			WriteIndexBufferInfo(writer, meshPosition + offsetof(SerializedMesh, indexBufferInfo), mesh.indexBufferInfo);
+
+			writer.WriteArray(meshPosition + offsetof(SerializedMesh, vertexData),
+				mesh.vertexData.data(), static_cast<uint32_t>(mesh.vertexData.size()), SCENE_BUFFER_ALIGNMENT);
+			writer.WriteArray(meshPosition + offsetof(SerializedMesh, indexData),
+				mesh.indexData.data(), static_cast<uint32_t>(mesh.indexData.size()), SCENE_BUFFER_ALIGNMENT);
+		}
+
+		uint32_t nodesPosition = writer.WriteArray<SerializedSceneNode>(
+			root + offsetof(SerializedScene, nodes), nullptr, static_cast<uint32_t>(scene.nodes.size()));
+
+		for (size_t nodeIndex = 0; nodeIndex < scene.nodes.size(); nodeIndex++)
+		{
+			const SceneNode& node = scene.nodes[nodeIndex];
+
+			SerializedSceneNode& serializedNode =
+				writer.Get<SerializedSceneNode>(nodesPosition + static_cast<uint32_t>(nodeIndex * sizeof(SerializedSceneNode)));
+			serializedNode.transform = node.transform;
+			serializedNode.meshIndex = node.meshIndex;
+			serializedNode.pipelineIndex = node.pipelineIndex;
+			serializedNode.parentIndex = node.parentIndex;
+		}
+
+		return writer.Finish(root);
+	}
+}
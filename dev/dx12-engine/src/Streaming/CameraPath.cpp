@@ -0,0 +1,75 @@
+#include "Streaming/CameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	CameraPath::CameraPath(const std::vector<XMFLOAT3>& waypoints, float speed)
+		: speed(speed)
+	{
+		for (const XMFLOAT3& waypoint : waypoints)
+		{
+			AddWaypoint(waypoint);
+		}
+	}
+
+	void CameraPath::AddWaypoint(const XMFLOAT3& waypoint)
+	{
+		float segmentLength{ 0.0f };
+		if (!waypoints.empty())
+		{
+			const XMFLOAT3& last = waypoints.back();
+			float dx = waypoint.x - last.x;
+			float dy = waypoint.y - last.y;
+			float dz = waypoint.z - last.z;
+			segmentLength = std::sqrt(dx * dx + dy * dy + dz * dz);
+		}
+
+		float previousLength = cumulativeLengths.empty() ? 0.0f : cumulativeLengths.back();
+
+		waypoints.push_back(waypoint);
+		cumulativeLengths.push_back(previousLength + segmentLength);
+	}
+	void CameraPath::SetSpeed(float speed)
+	{
+		this->speed = speed;
+	}
+
+	XMFLOAT3 CameraPath::Sample(float time) const
+	{
+		if (waypoints.empty())
+			return XMFLOAT3{ 0.0f, 0.0f, 0.0f };
+
+		float distance = std::clamp(time * speed, 0.0f, GetLength());
+
+		auto segmentEnd = std::lower_bound(cumulativeLengths.begin(), cumulativeLengths.end(), distance);
+		size_t endIdx = static_cast<size_t>(segmentEnd - cumulativeLengths.begin());
+		if (endIdx == 0)
+			return waypoints.front();
+
+		size_t beginIdx = endIdx - 1;
+		float segmentLength = cumulativeLengths[endIdx] - cumulativeLengths[beginIdx];
+		float t = segmentLength > 0.0f ? (distance - cumulativeLengths[beginIdx]) / segmentLength : 0.0f;
+
+		const XMFLOAT3& p0 = waypoints[beginIdx];
+		const XMFLOAT3& p1 = waypoints[endIdx];
+
+		return XMFLOAT3{
+			p0.x + (p1.x - p0.x) * t,
+			p0.y + (p1.y - p0.y) * t,
+			p0.z + (p1.z - p0.z) * t
+		};
+	}
+
+	float CameraPath::GetLength() const
+	{
+		return cumulativeLengths.empty() ? 0.0f : cumulativeLengths.back();
+	}
+	float CameraPath::GetDuration() const
+	{
+		return speed > 0.0f ? GetLength() / speed : 0.0f;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "Streaming/Dx12/Dx12MeshLodLoader.h"
+
+#include <cassert>
+#include <exception>
+
+namespace dxe
+{
+	Dx12MeshLodLoader::Dx12MeshLodLoader(Dx12GeometryBuffer* geometryBuffer, ThreadPool* threadPool)
+		: geometryBuffer(geometryBuffer),
+		threadPool(threadPool)
+	{
+		assert(geometryBuffer && threadPool && "Mesh LOD loader needs a geometry buffer and a thread pool!");
+	}
+
+	void Dx12MeshLodLoader::SetStreamer(MeshLodStreamer* streamer)
+	{
+		this->streamer = streamer;
+	}
+
+	void Dx12MeshLodLoader::AddMesh(MeshId meshId, uint32_t vertexStride, Dx12MeshLodSource source)
+	{
+		assert(vertexStride > 0 && source && "Streaming meshes need a vertex stride and a LOD source!");
+
+		if (meshId >= meshes.size())
+			meshes.resize(meshId + 1);
+
+		assert(!meshes[meshId] && "Mesh was already added!");
+		meshes[meshId] = std::make_unique<LodMesh>();
+		meshes[meshId]->vertexStride = vertexStride;
+		meshes[meshId]->source = std::move(source);
+	}
+
+	void Dx12MeshLodLoader::BeginLoad(const StreamingMesh& mesh, uint32_t lodIndex)
+	{
+		assert(streamer && "Mesh LOD loader has no streamer to report to!");
+
+		// Meshes are never removed, so the pointer stays valid while the load runs.
+		LodMesh* lodMesh = &GetLodMesh(mesh.id);
+		MeshId meshId = mesh.id;
+
+		threadPool->Execute([this, lodMesh, meshId, lodIndex]() {
+			auto lodData = std::make_unique<Dx12MeshLodData>();
+
+			bool succeeded{ false };
+			try
+			{
+				succeeded = lodMesh->source(lodIndex, *lodData);
+			}
+			catch (const std::exception&)
+			{
+				succeeded = false;
+			}
+
+			assert((!succeeded || lodData->vertices.size() % lodMesh->vertexStride == 0) &&
+				"LOD vertex data isn't a multiple of the vertex stride!");
+
+			if (succeeded)
+			{
+				std::lock_guard<std::mutex> lock{ meshesMutex };
+				lodMesh->loadedLod = std::move(lodData);
+			}
+
+			streamer->OnLodLoaded(meshId, lodIndex, succeeded);
+		});
+	}
+
+	void Dx12MeshLodLoader::Upload(const StreamingMesh& mesh, uint32_t lodIndex)
+	{
+		LodMesh& lodMesh = GetLodMesh(mesh.id);
+
+		std::unique_ptr<Dx12MeshLodData> lodData;
+		{
+			std::lock_guard<std::mutex> lock{ meshesMutex };
+			lodData = std::move(lodMesh.loadedLod);
+		}
+		assert(lodData && "LOD to upload hasn't been loaded!");
+		assert(lodIndex == lodMesh.lodIndexCounts.size() && "LODs have to be uploaded in order!");
+
+		uint64_t vertexCount = lodData->vertices.size() / lodMesh.vertexStride;
+		uint64_t indexCount = lodData->indices.size();
+
+		if (lodIndex == 0)
+		{
+			lodMesh.geometryId = geometryBuffer->AddMesh(
+				lodMesh.vertexStride,
+				lodData->vertices.data(), vertexCount,
+				lodData->indices.data(), indexCount);
+
+			lodMesh.lodVertexCounts.push_back(vertexCount);
+			lodMesh.lodIndexCounts.push_back(indexCount);
+		}
+		else
+		{
+			geometryBuffer->AppendToMesh(
+				lodMesh.geometryId,
+				lodData->vertices.data(), vertexCount,
+				lodData->indices.data(), indexCount);
+
+			lodMesh.lodVertexCounts.push_back(lodMesh.lodVertexCounts.back() + vertexCount);
+			lodMesh.lodIndexCounts.push_back(lodMesh.lodIndexCounts.back() + indexCount);
+		}
+	}
+
+	void Dx12MeshLodLoader::Evict(const StreamingMesh& mesh, uint32_t lodIndex)
+	{
+		LodMesh& lodMesh = GetLodMesh(mesh.id);
+		assert(lodIndex > 0 && lodIndex + 1 == lodMesh.lodIndexCounts.size() &&
+			"Only the finest resident LOD can be evicted, and never LOD 0!");
+
+		lodMesh.lodVertexCounts.pop_back();
+		lodMesh.lodIndexCounts.pop_back();
+
+		// Frames in flight may still draw the tail, the geometry buffer frees it once they're done.
+		geometryBuffer->TruncateMesh(
+			lodMesh.geometryId, lodMesh.lodVertexCounts.back(), lodMesh.lodIndexCounts.back());
+	}
+
+	Dx12GeometryRange Dx12MeshLodLoader::GetLodRange(MeshId meshId, uint32_t lodIndex) const
+	{
+		const LodMesh& lodMesh = GetLodMesh(meshId);
+		assert(lodIndex < lodMesh.lodIndexCounts.size() && "LOD isn't resident!");
+
+		Dx12GeometryRange range = geometryBuffer->GetRange(lodMesh.geometryId);
+		range.vertexCount = static_cast<uint32_t>(lodMesh.lodVertexCounts[lodIndex]);
+		range.indexCount = static_cast<uint32_t>(lodMesh.lodIndexCounts[lodIndex]);
+		return range;
+	}
+	uint32_t Dx12MeshLodLoader::GetGeometryId(MeshId meshId) const
+	{
+		return GetLodMesh(meshId).geometryId;
+	}
+
+	Dx12MeshLodLoader::LodMesh& Dx12MeshLodLoader::GetLodMesh(MeshId meshId)
+	{
+		assert(meshId < meshes.size() && meshes[meshId] && "Invalid Mesh ID provided!");
+		return *meshes[meshId];
+	}
+	const Dx12MeshLodLoader::LodMesh& Dx12MeshLodLoader::GetLodMesh(MeshId meshId) const
+	{
+		assert(meshId < meshes.size() && meshes[meshId] && "Invalid Mesh ID provided!");
+		return *meshes[meshId];
+	}
+}
@@ -0,0 +1,362 @@
+#include "Streaming/MeshLodStreamer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	constexpr float INFINITE_SCREEN_SPACE_ERROR = std::numeric_limits<float>::infinity();
+	constexpr StreamingMesh::MeshId INVALID_MESH_ID = UINT32_MAX;
+
+	MeshLodStreamer::MeshLodStreamer(const MeshLodStreamerSettings& settings, MeshLodLoader* lodLoader)
+		: settings(settings),
+		lodLoader(lodLoader)
+	{
+		assert(lodLoader && "LOD loader was 'nullptr'!");
+		assert(settings.verticalFieldOfView > 0.0f && settings.viewportHeight > 0.0f && "Invalid projection settings!");
+		assert(settings.evictionHysteresis >= 1.0f && "Eviction hysteresis below 1 lets meshes evict each other's LODs!");
+
+		projectionScale = settings.viewportHeight / (2.0f * std::tan(settings.verticalFieldOfView * 0.5f));
+	}
+
+	MeshLodStreamer::MeshId MeshLodStreamer::AddMesh(
+		const XMFLOAT3& boundsCenter, float boundsRadius, const std::vector<StreamingMeshLod>& lods)
+	{
+		assert(!lods.empty() && "A streaming mesh needs at least one LOD!");
+
+		StreamingMesh mesh{};
+		mesh.id = static_cast<MeshId>(meshes.size());
+		mesh.boundsCenter = boundsCenter;
+		mesh.boundsRadius = boundsRadius;
+		mesh.lods = lods;
+		mesh.screenSpaceError = INFINITE_SCREEN_SPACE_ERROR;
+
+		meshes.push_back(mesh);
+		return mesh.id;
+	}
+
+	void MeshLodStreamer::Update(const XMFLOAT3& cameraPosition)
+	{
+		frameStats = MeshLodStreamerFrameStats{};
+
+		ApplyLoadCompletions();
+		UpdateScreenSpaceErrors(cameraPosition);
+
+		TrimToBudget();
+		IssueLoads();
+		UploadLoadedLods();
+		UpdateStats();
+	}
+
+	void MeshLodStreamer::OnLodLoaded(MeshId meshId, uint32_t lodIndex, bool succeeded)
+	{
+		std::lock_guard<std::mutex> lock{ loadCompletionsMutex };
+		loadCompletions.push_back(LodLoadCompletion{ meshId, lodIndex, succeeded });
+	}
+
+	void MeshLodStreamer::SetGpuBudgetBytes(uint64_t gpuBudgetBytes)
+	{
+		settings.gpuBudgetBytes = gpuBudgetBytes;
+	}
+
+	uint32_t MeshLodStreamer::GetDrawLod(MeshId meshId) const
+	{
+		const StreamingMesh& mesh = GetMesh(meshId);
+		if (mesh.residentLodCount == 0)
+			return UINT32_MAX;
+		return std::min(mesh.desiredLodCount, mesh.residentLodCount) - 1;
+	}
+
+	const StreamingMesh& MeshLodStreamer::GetMesh(MeshId meshId) const
+	{
+		assert(meshId < meshes.size() && "Invalid Mesh ID provided!");
+		return meshes[meshId];
+	}
+	uint32_t MeshLodStreamer::GetMeshCount() const
+	{
+		return static_cast<uint32_t>(meshes.size());
+	}
+
+	uint64_t MeshLodStreamer::GetGpuCommittedBytes() const
+	{
+		return gpuCommittedBytes;
+	}
+
+	const MeshLodStreamerFrameStats& MeshLodStreamer::GetFrameStats() const
+	{
+		return frameStats;
+	}
+	const MeshLodStreamerStats& MeshLodStreamer::GetStats() const
+	{
+		return stats;
+	}
+
+	void MeshLodStreamer::ApplyLoadCompletions()
+	{
+		std::vector<LodLoadCompletion> completions;
+		{
+			std::lock_guard<std::mutex> lock{ loadCompletionsMutex };
+			completions.swap(loadCompletions);
+		}
+
+		for (const LodLoadCompletion& completion : completions)
+		{
+			StreamingMesh& mesh = meshes[completion.meshId];
+			assert(mesh.pendingLodState == StreamingLodState::LOADING && completion.lodIndex == mesh.residentLodCount &&
+				"LOD wasn't loading!");
+
+			loadsInFlight--;
+
+			if (!completion.succeeded)
+			{
+				gpuCommittedBytes -= mesh.lods[completion.lodIndex].gpuBytes;
+				mesh.pendingLodState = StreamingLodState::UNLOADED;
+				continue;
+			}
+
+			mesh.pendingLodState = StreamingLodState::LOADED;
+		}
+	}
+
+	void MeshLodStreamer::UpdateScreenSpaceErrors(const XMFLOAT3& cameraPosition)
+	{
+		for (StreamingMesh& mesh : meshes)
+		{
+			float dx = mesh.boundsCenter.x - cameraPosition.x;
+			float dy = mesh.boundsCenter.y - cameraPosition.y;
+			float dz = mesh.boundsCenter.z - cameraPosition.z;
+			mesh.cameraDistance = std::max(std::sqrt(dx * dx + dy * dy + dz * dz) - mesh.boundsRadius, settings.nearDistance);
+
+			// Coarsest LOD count that looks right from here.
+			uint32_t lodCount = static_cast<uint32_t>(mesh.lods.size());
+			mesh.desiredLodCount = lodCount;
+			for (uint32_t count = 1; count <= lodCount; count++)
+			{
+				if (CalculateScreenSpaceError(mesh, count) <= settings.maxScreenSpaceError)
+				{
+					mesh.desiredLodCount = count;
+					break;
+				}
+			}
+
+			mesh.screenSpaceError = CalculateScreenSpaceError(mesh, mesh.residentLodCount);
+		}
+	}
+
+	float MeshLodStreamer::CalculateScreenSpaceError(const StreamingMesh& mesh, uint32_t lodCount) const
+	{
+		if (lodCount == 0)
+			return INFINITE_SCREEN_SPACE_ERROR;
+		return mesh.lods[lodCount - 1].geometricError * projectionScale / mesh.cameraDistance;
+	}
+
+	void MeshLodStreamer::IssueLoads()
+	{
+		std::vector<MeshId> candidates;
+		for (const StreamingMesh& mesh : meshes)
+		{
+			if (mesh.pendingLodState == StreamingLodState::UNLOADED && mesh.residentLodCount < mesh.desiredLodCount)
+				candidates.push_back(mesh.id);
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [this](MeshId id1, MeshId id2) {
+			return HasHigherPriority(meshes[id1], meshes[id2]);
+		});
+
+		for (MeshId meshId : candidates)
+		{
+			if (loadsInFlight >= settings.maxLoadsInFlight)
+				break;
+
+			StreamingMesh& mesh = meshes[meshId];
+			uint32_t lodIndex = mesh.residentLodCount;
+			uint64_t lodBytes = mesh.lods[lodIndex].gpuBytes;
+
+			// LOD 0 goes in no matter what, it's the difference between drawing the mesh or not.
+			uint64_t budgetBytes = settings.gpuBudgetBytes;
+			if (gpuCommittedBytes + lodBytes > budgetBytes)
+			{
+				uint64_t overBudgetBytes = gpuCommittedBytes + lodBytes - budgetBytes;
+				bool fits = EvictLods(overBudgetBytes, mesh.screenSpaceError, mesh.id, lodIndex == 0);
+				if (!fits && lodIndex > 0)
+				{
+					frameStats.budgetRejectedLods++;
+					continue;
+				}
+			}
+
+			mesh.pendingLodState = StreamingLodState::LOADING;
+			gpuCommittedBytes += lodBytes;
+
+			loadsInFlight++;
+			frameStats.loadsIssued++;
+
+			lodLoader->BeginLoad(mesh, lodIndex);
+		}
+	}
+
+	void MeshLodStreamer::UploadLoadedLods()
+	{
+		std::vector<MeshId> loadedMeshes;
+		for (const StreamingMesh& mesh : meshes)
+		{
+			if (mesh.pendingLodState == StreamingLodState::LOADED)
+				loadedMeshes.push_back(mesh.id);
+		}
+
+		std::sort(loadedMeshes.begin(), loadedMeshes.end(), [this](MeshId id1, MeshId id2) {
+			return HasHigherPriority(meshes[id1], meshes[id2]);
+		});
+
+		for (MeshId meshId : loadedMeshes)
+		{
+			StreamingMesh& mesh = meshes[meshId];
+			uint32_t lodIndex = mesh.residentLodCount;
+			uint64_t lodBytes = mesh.lods[lodIndex].gpuBytes;
+
+			bool overBudget = frameStats.uploadedBytes + lodBytes > settings.uploadBudgetBytesPerFrame;
+			if (overBudget && frameStats.uploads > 0)
+				break;
+
+			lodLoader->Upload(mesh, lodIndex);
+
+			mesh.residentLodCount++;
+			mesh.pendingLodState = StreamingLodState::UNLOADED;
+			mesh.screenSpaceError = CalculateScreenSpaceError(mesh, mesh.residentLodCount);
+
+			frameStats.uploads++;
+			frameStats.uploadedBytes += lodBytes;
+		}
+	}
+
+	void MeshLodStreamer::UpdateStats()
+	{
+		for (const StreamingMesh& mesh : meshes)
+		{
+			if (mesh.residentLodCount == 0)
+			{
+				frameStats.undrawableMeshes++;
+				continue;
+			}
+
+			float drawError = CalculateScreenSpaceError(mesh, std::min(mesh.desiredLodCount, mesh.residentLodCount));
+			if (drawError > settings.maxScreenSpaceError)
+				frameStats.meshesAboveErrorThreshold++;
+			frameStats.maxScreenSpaceError = std::max(frameStats.maxScreenSpaceError, drawError);
+		}
+
+		frameStats.gpuBudgetExceeded = gpuCommittedBytes > settings.gpuBudgetBytes;
+
+		stats.frameCount++;
+		if (frameStats.meshesAboveErrorThreshold > 0)
+			stats.errorFrameCount++;
+		stats.meshErrorFrames += frameStats.meshesAboveErrorThreshold;
+
+		if (frameStats.gpuBudgetExceeded)
+			stats.gpuBudgetOverrunFrames++;
+
+		stats.totalUploadedBytes += frameStats.uploadedBytes;
+		stats.totalEvictedBytes += frameStats.evictedBytes;
+
+		stats.peakGpuBytes = std::max(stats.peakGpuBytes, gpuCommittedBytes);
+		stats.peakUploadBytesPerFrame = std::max(stats.peakUploadBytesPerFrame, frameStats.uploadedBytes);
+	}
+
+	bool MeshLodStreamer::EvictLods(uint64_t bytesToFree, float requesterError, MeshId requesterId, bool allowPartial)
+	{
+		// Candidates are the finest resident LOD of every mesh, keyed by the error the mesh
+		// is left with once it's gone. Dropping one LOD exposes the next one of the same mesh.
+
+		struct EvictionCandidate
+		{
+			float remainingError{ 0.0f };
+			MeshId meshId{ 0 };
+			uint32_t lodCount{ 0 };
+
+			bool operator>(const EvictionCandidate& other) const
+			{
+				return remainingError > other.remainingError;
+			}
+		};
+
+		std::priority_queue<EvictionCandidate, std::vector<EvictionCandidate>, std::greater<EvictionCandidate>> candidates;
+
+		for (const StreamingMesh& mesh : meshes)
+		{
+			// LOD 0 stays, and an in-flight LOD must keep sitting on top of the resident ones.
+			if (mesh.id == requesterId || mesh.residentLodCount < 2 || mesh.pendingLodState != StreamingLodState::UNLOADED)
+				continue;
+
+			uint32_t lodCount = mesh.residentLodCount;
+			candidates.push(EvictionCandidate{ CalculateScreenSpaceError(mesh, lodCount - 1), mesh.id, lodCount });
+		}
+
+		float maxRemainingError = requesterError / settings.evictionHysteresis;
+
+		std::vector<MeshId> victims;
+		uint64_t freedBytes{ 0 };
+
+		while (freedBytes < bytesToFree && !candidates.empty())
+		{
+			EvictionCandidate candidate = candidates.top();
+			candidates.pop();
+
+			if (candidate.remainingError >= maxRemainingError)
+				break;
+
+			const StreamingMesh& mesh = meshes[candidate.meshId];
+			freedBytes += mesh.lods[candidate.lodCount - 1].gpuBytes;
+			victims.push_back(candidate.meshId);
+
+			uint32_t lodCount = candidate.lodCount - 1;
+			if (lodCount >= 2)
+				candidates.push(EvictionCandidate{ CalculateScreenSpaceError(mesh, lodCount - 1), mesh.id, lodCount });
+		}
+
+		bool enoughFreed = freedBytes >= bytesToFree;
+		if (!enoughFreed && !allowPartial)
+			return false;
+
+		// Victims of the same mesh are listed finest first, so every eviction drops the finest LOD.
+		for (MeshId victimId : victims)
+			EvictFinestLod(meshes[victimId]);
+
+		return enoughFreed;
+	}
+
+	void MeshLodStreamer::TrimToBudget()
+	{
+		if (gpuCommittedBytes > settings.gpuBudgetBytes)
+			EvictLods(gpuCommittedBytes - settings.gpuBudgetBytes, INFINITE_SCREEN_SPACE_ERROR, INVALID_MESH_ID, true);
+	}
+
+	void MeshLodStreamer::EvictFinestLod(StreamingMesh& mesh)
+	{
+		assert(mesh.residentLodCount > 1 && mesh.pendingLodState == StreamingLodState::UNLOADED &&
+			"Only finer LODs of idle meshes can be evicted!");
+
+		uint32_t lodIndex = mesh.residentLodCount - 1;
+		uint64_t lodBytes = mesh.lods[lodIndex].gpuBytes;
+
+		lodLoader->Evict(mesh, lodIndex);
+
+		mesh.residentLodCount--;
+		mesh.screenSpaceError = CalculateScreenSpaceError(mesh, mesh.residentLodCount);
+		gpuCommittedBytes -= lodBytes;
+
+		frameStats.evictions++;
+		frameStats.evictedBytes += lodBytes;
+	}
+
+	bool MeshLodStreamer::HasHigherPriority(const StreamingMesh& mesh1, const StreamingMesh& mesh2) const
+	{
+		if (mesh1.screenSpaceError != mesh2.screenSpaceError)
+			return mesh1.screenSpaceError > mesh2.screenSpaceError;
+		return mesh1.cameraDistance < mesh2.cameraDistance;
+	}
+}
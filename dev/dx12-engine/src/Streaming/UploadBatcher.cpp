@@ -0,0 +1,97 @@
+#include "Streaming/UploadBatcher.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace dxe
+{
+	UploadBatcher::UploadBatcher(UploadBackend* backend, const UploadBatcherDesc& desc)
+		: backend(backend),
+		desc(desc)
+	{
+		assert(backend && "Upload batcher needs a backend!");
+
+		if (desc.maxBatchSize == 0 || desc.maxBatchCopies == 0 || desc.maxCopySize == 0)
+			throw Error{ "Upload batch and copy limits must not be 0!" };
+	}
+
+	void UploadBatcher::Upload(void* destination, uint64_t destinationOffset, const void* data, uint64_t size)
+	{
+		assert(destination && data && "Invalid upload!");
+
+		statistics.uploadCount++;
+		statistics.uploadedBytes += size;
+
+		const uint8_t* source = static_cast<const uint8_t*>(data);
+		while (size > 0)
+		{
+			uint64_t copySize = std::min({ size, desc.maxCopySize, desc.maxBatchSize });
+
+			// A batch is closed before it grows past its limits, so the staging memory of the open
+			// batch never exceeds maxBatchSize.
+			if (batchSize + copySize > desc.maxBatchSize || batchCopyCount == desc.maxBatchCopies)
+				Flush();
+
+			UploadStaging staging = backend->AllocateStaging(copySize);
+			memcpy(staging.cpuAddress, source, copySize);
+
+			// Contiguous in the destination and in staging memory: one copy covers both.
+			if (pendingCopy.size > 0 && pendingCopy.destination == destination &&
+				pendingCopy.destinationOffset + pendingCopy.size == destinationOffset &&
+				pendingCopy.stagingOffset + pendingCopy.size == staging.offset &&
+				pendingCopy.size + copySize <= desc.maxCopySize)
+			{
+				pendingCopy.size += copySize;
+				statistics.mergedCopyCount++;
+			}
+			else
+			{
+				if (pendingCopy.size > 0)
+					backend->RecordCopy(pendingCopy);
+
+				pendingCopy = UploadCopy{ destination, destinationOffset, staging.offset, copySize };
+				batchCopyCount++;
+				statistics.copyCount++;
+			}
+
+			batchSize += copySize;
+
+			source += copySize;
+			destinationOffset += copySize;
+			size -= copySize;
+		}
+	}
+
+	uint64_t UploadBatcher::Flush()
+	{
+		if (!HasOpenBatch())
+			return lastSubmittedValue;
+
+		backend->RecordCopy(pendingCopy);
+		pendingCopy = UploadCopy{};
+
+		lastSubmittedValue = backend->SubmitCopies();
+		batchSize = 0;
+		batchCopyCount = 0;
+		statistics.batchCount++;
+
+		return lastSubmittedValue;
+	}
+
+	uint64_t UploadBatcher::GetLastSubmittedValue() const
+	{
+		return lastSubmittedValue;
+	}
+	bool UploadBatcher::HasOpenBatch() const
+	{
+		return pendingCopy.size > 0;
+	}
+
+	UploadStatistics UploadBatcher::GetStatistics() const
+	{
+		return statistics;
+	}
+}
@@ -0,0 +1,400 @@
+#include "Streaming/WorldStreamer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	WorldStreamer::WorldStreamer(const WorldStreamerSettings& settings, StreamingCellLoader* cellLoader)
+		: settings(settings),
+		cellLoader(cellLoader)
+	{
+		assert(cellLoader && "Cell loader was 'nullptr'!");
+		assert(settings.unloadRadius >= settings.loadRadius && "Unload radius must not be smaller than the load radius!");
+	}
+
+	WorldStreamer::CellId WorldStreamer::AddCell(
+		const StreamingCellCoord& coord, uint64_t cpuBytes, uint64_t gpuBytes, uint32_t priority)
+	{
+		assert(cellLookup.find(PackCellCoord(coord)) == cellLookup.end() && "The cell already exists!");
+
+		StreamingCell cell{};
+		cell.id = static_cast<CellId>(cells.size());
+		cell.coord = coord;
+		cell.cpuBytes = cpuBytes;
+		cell.gpuBytes = gpuBytes;
+		cell.priority = priority;
+
+		cells.push_back(cell);
+		cellLookup[PackCellCoord(coord)] = cell.id;
+
+		return cell.id;
+	}
+
+	StreamingCellCoord WorldStreamer::WorldPositionToCellCoord(const XMFLOAT3& position) const
+	{
+		StreamingCellCoord coord{};
+		coord.x = static_cast<int32_t>(std::floor(position.x / settings.cellSize));
+		coord.z = static_cast<int32_t>(std::floor(position.z / settings.cellSize));
+		return coord;
+	}
+
+	void WorldStreamer::Update(const XMFLOAT3& cameraPosition)
+	{
+		frameStats = WorldStreamerFrameStats{};
+
+		ApplyLoadCompletions();
+
+		for (CellId cellId : activeCells)
+		{
+			StreamingCell& cell = cells[cellId];
+			cell.cameraDistance = CellDistance(cell, cameraPosition);
+		}
+
+		UnloadDistantCells();
+		IssueLoads(cameraPosition);
+		UploadLoadedCells();
+		UpdateStats(cameraPosition);
+	}
+
+	void WorldStreamer::OnCellLoaded(CellId cellId, bool succeeded)
+	{
+		std::lock_guard<std::mutex> lock{ loadCompletionsMutex };
+		loadCompletions.push_back(CellLoadCompletion{ cellId, succeeded });
+	}
+
+	const StreamingCell& WorldStreamer::GetCell(CellId cellId) const
+	{
+		assert(cellId < cells.size() && "Invalid Cell ID provided!");
+		return cells[cellId];
+	}
+	uint32_t WorldStreamer::GetCellCount() const
+	{
+		return static_cast<uint32_t>(cells.size());
+	}
+
+	uint64_t WorldStreamer::GetCpuCommittedBytes() const
+	{
+		return cpuCommittedBytes;
+	}
+	uint64_t WorldStreamer::GetGpuCommittedBytes() const
+	{
+		return gpuCommittedBytes;
+	}
+
+	const WorldStreamerFrameStats& WorldStreamer::GetFrameStats() const
+	{
+		return frameStats;
+	}
+	const WorldStreamerStats& WorldStreamer::GetStats() const
+	{
+		return stats;
+	}
+
+	uint64_t WorldStreamer::PackCellCoord(const StreamingCellCoord& coord)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(coord.x)) << 32) |
+			static_cast<uint64_t>(static_cast<uint32_t>(coord.z));
+	}
+
+	float WorldStreamer::CellDistance(const StreamingCell& cell, const XMFLOAT3& cameraPosition) const
+	{
+		// Distance from the camera to the closest point of the cell on the XZ plane.
+
+		float minX = cell.coord.x * settings.cellSize;
+		float minZ = cell.coord.z * settings.cellSize;
+
+		float dx = std::max({ minX - cameraPosition.x, 0.0f, cameraPosition.x - (minX + settings.cellSize) });
+		float dz = std::max({ minZ - cameraPosition.z, 0.0f, cameraPosition.z - (minZ + settings.cellSize) });
+
+		return std::sqrt(dx * dx + dz * dz);
+	}
+
+	void WorldStreamer::ApplyLoadCompletions()
+	{
+		std::vector<CellLoadCompletion> completions;
+		{
+			std::lock_guard<std::mutex> lock{ loadCompletionsMutex };
+			completions.swap(loadCompletions);
+		}
+
+		for (const CellLoadCompletion& completion : completions)
+		{
+			StreamingCell& cell = cells[completion.cellId];
+			assert(cell.state == StreamingCellState::LOADING && "Cell wasn't loading!");
+
+			loadsInFlight--;
+
+			if (!completion.succeeded)
+			{
+				ReleaseCell(cell);
+				continue;
+			}
+			if (cell.unloadRequested)
+			{
+				cellLoader->Unload(cell);
+				ReleaseCell(cell);
+				frameStats.unloads++;
+				continue;
+			}
+
+			cell.state = StreamingCellState::LOADED;
+		}
+
+		// Released cells must not be unloaded again by 'UnloadDistantCells' in the same frame.
+		RemoveUnloadedCells();
+	}
+
+	void WorldStreamer::UnloadDistantCells()
+	{
+		for (CellId cellId : activeCells)
+		{
+			StreamingCell& cell = cells[cellId];
+			if (cell.cameraDistance <= settings.unloadRadius)
+				continue;
+
+			if (cell.state == StreamingCellState::LOADING)
+			{
+				cell.unloadRequested = true;
+				continue;
+			}
+
+			cellLoader->Unload(cell);
+			ReleaseCell(cell);
+			frameStats.unloads++;
+		}
+
+		RemoveUnloadedCells();
+	}
+
+	void WorldStreamer::IssueLoads(const XMFLOAT3& cameraPosition)
+	{
+		float radius = settings.loadRadius;
+
+		StreamingCellCoord minCoord = WorldPositionToCellCoord(
+			XMFLOAT3{ cameraPosition.x - radius, cameraPosition.y, cameraPosition.z - radius });
+		StreamingCellCoord maxCoord = WorldPositionToCellCoord(
+			XMFLOAT3{ cameraPosition.x + radius, cameraPosition.y, cameraPosition.z + radius });
+
+		std::vector<CellId> candidates;
+
+		for (int32_t z = minCoord.z; z <= maxCoord.z; z++)
+		{
+			for (int32_t x = minCoord.x; x <= maxCoord.x; x++)
+			{
+				auto cellIter = cellLookup.find(PackCellCoord(StreamingCellCoord{ x, z }));
+				if (cellIter == cellLookup.end())
+					continue;
+
+				StreamingCell& cell = cells[cellIter->second];
+				cell.cameraDistance = CellDistance(cell, cameraPosition);
+
+				if (cell.cameraDistance > radius)
+					continue;
+
+				// The camera came back before the load finished.
+				cell.unloadRequested = false;
+
+				if (cell.state == StreamingCellState::UNLOADED)
+					candidates.push_back(cell.id);
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [this](CellId id1, CellId id2) {
+			const StreamingCell& c1 = cells[id1];
+			const StreamingCell& c2 = cells[id2];
+			bool required1 = IsRequired(c1);
+			bool required2 = IsRequired(c2);
+			if (required1 != required2)
+				return required1;
+			if (c1.priority != c2.priority)
+				return c1.priority < c2.priority;
+			return c1.cameraDistance < c2.cameraDistance;
+		});
+
+		for (CellId cellId : candidates)
+		{
+			if (loadsInFlight >= settings.maxLoadsInFlight)
+				break;
+
+			StreamingCell& cell = cells[cellId];
+
+			if (!FitsIntoBudget(cell) && !EvictForCell(cell) && !IsRequired(cell))
+			{
+				frameStats.budgetRejectedCells++;
+				continue;
+			}
+
+			cell.state = StreamingCellState::LOADING;
+			cpuCommittedBytes += cell.cpuBytes;
+			gpuCommittedBytes += cell.gpuBytes;
+
+			loadsInFlight++;
+			activeCells.push_back(cell.id);
+			frameStats.loadsIssued++;
+
+			cellLoader->BeginLoad(cell);
+		}
+	}
+
+	void WorldStreamer::UploadLoadedCells()
+	{
+		std::vector<CellId> loadedCells;
+		for (CellId cellId : activeCells)
+		{
+			if (cells[cellId].state == StreamingCellState::LOADED)
+				loadedCells.push_back(cellId);
+		}
+
+		std::sort(loadedCells.begin(), loadedCells.end(), [this](CellId id1, CellId id2) {
+			const StreamingCell& c1 = cells[id1];
+			const StreamingCell& c2 = cells[id2];
+			if (c1.priority != c2.priority)
+				return c1.priority < c2.priority;
+			return c1.cameraDistance < c2.cameraDistance;
+		});
+
+		for (CellId cellId : loadedCells)
+		{
+			StreamingCell& cell = cells[cellId];
+
+			bool overBudget = frameStats.uploadedBytes + cell.gpuBytes > settings.uploadBudgetBytesPerFrame;
+			if (overBudget && frameStats.uploads > 0)
+				break;
+
+			cellLoader->Upload(cell);
+			cell.state = StreamingCellState::RESIDENT;
+
+			frameStats.uploads++;
+			frameStats.uploadedBytes += cell.gpuBytes;
+		}
+	}
+
+	void WorldStreamer::UpdateStats(const XMFLOAT3& cameraPosition)
+	{
+		float radius = settings.requiredRadius;
+
+		StreamingCellCoord minCoord = WorldPositionToCellCoord(
+			XMFLOAT3{ cameraPosition.x - radius, cameraPosition.y, cameraPosition.z - radius });
+		StreamingCellCoord maxCoord = WorldPositionToCellCoord(
+			XMFLOAT3{ cameraPosition.x + radius, cameraPosition.y, cameraPosition.z + radius });
+
+		for (int32_t z = minCoord.z; z <= maxCoord.z; z++)
+		{
+			for (int32_t x = minCoord.x; x <= maxCoord.x; x++)
+			{
+				auto cellIter = cellLookup.find(PackCellCoord(StreamingCellCoord{ x, z }));
+				if (cellIter == cellLookup.end())
+					continue;
+
+				const StreamingCell& cell = cells[cellIter->second];
+				if (CellDistance(cell, cameraPosition) <= radius && cell.state != StreamingCellState::RESIDENT)
+					frameStats.stalledCells++;
+			}
+		}
+
+		frameStats.cpuBudgetExceeded = cpuCommittedBytes > settings.cpuBudgetBytes;
+		frameStats.gpuBudgetExceeded = gpuCommittedBytes > settings.gpuBudgetBytes;
+
+		stats.frameCount++;
+		if (frameStats.stalledCells > 0)
+			stats.stalledFrameCount++;
+		stats.stalledCellFrames += frameStats.stalledCells;
+
+		if (frameStats.cpuBudgetExceeded)
+			stats.cpuBudgetOverrunFrames++;
+		if (frameStats.gpuBudgetExceeded)
+			stats.gpuBudgetOverrunFrames++;
+
+		stats.peakCpuBytes = std::max(stats.peakCpuBytes, cpuCommittedBytes);
+		stats.peakGpuBytes = std::max(stats.peakGpuBytes, gpuCommittedBytes);
+		stats.peakUploadBytesPerFrame = std::max(stats.peakUploadBytesPerFrame, frameStats.uploadedBytes);
+	}
+
+	bool WorldStreamer::FitsIntoBudget(const StreamingCell& cell) const
+	{
+		return cpuCommittedBytes + cell.cpuBytes <= settings.cpuBudgetBytes &&
+			gpuCommittedBytes + cell.gpuBytes <= settings.gpuBudgetBytes;
+	}
+
+	bool WorldStreamer::EvictForCell(const StreamingCell& cell)
+	{
+		// Only cells that matter less than the new one can make room for it.
+
+		std::vector<CellId> victims;
+		uint64_t victimCpuBytes{ 0 };
+		uint64_t victimGpuBytes{ 0 };
+
+		for (CellId cellId : activeCells)
+		{
+			const StreamingCell& victim = cells[cellId];
+			if (victim.state == StreamingCellState::LOADING || IsRequired(victim))
+				continue;
+
+			bool lessImportant = victim.priority > cell.priority ||
+				(victim.priority == cell.priority && victim.cameraDistance > cell.cameraDistance);
+			if (!lessImportant)
+				continue;
+
+			victims.push_back(cellId);
+			victimCpuBytes += victim.cpuBytes;
+			victimGpuBytes += victim.gpuBytes;
+		}
+
+		bool cpuFits = cpuCommittedBytes - victimCpuBytes + cell.cpuBytes <= settings.cpuBudgetBytes;
+		bool gpuFits = gpuCommittedBytes - victimGpuBytes + cell.gpuBytes <= settings.gpuBudgetBytes;
+		if (!cpuFits || !gpuFits)
+			return false;
+
+		std::sort(victims.begin(), victims.end(), [this](CellId id1, CellId id2) {
+			const StreamingCell& c1 = cells[id1];
+			const StreamingCell& c2 = cells[id2];
+			if (c1.priority != c2.priority)
+				return c1.priority > c2.priority;
+			return c1.cameraDistance > c2.cameraDistance;
+		});
+
+		for (CellId victimId : victims)
+		{
+			if (FitsIntoBudget(cell))
+				break;
+
+			StreamingCell& victim = cells[victimId];
+			cellLoader->Unload(victim);
+			ReleaseCell(victim);
+
+			frameStats.unloads++;
+			frameStats.evictions++;
+		}
+
+		RemoveUnloadedCells();
+
+		return true;
+	}
+
+	void WorldStreamer::ReleaseCell(StreamingCell& cell)
+	{
+		cpuCommittedBytes -= cell.cpuBytes;
+		gpuCommittedBytes -= cell.gpuBytes;
+
+		cell.state = StreamingCellState::UNLOADED;
+		cell.unloadRequested = false;
+	}
+
+	void WorldStreamer::RemoveUnloadedCells()
+	{
+		activeCells.erase(
+			std::remove_if(activeCells.begin(), activeCells.end(), [this](CellId cellId) {
+				return cells[cellId].state == StreamingCellState::UNLOADED;
+			}),
+			activeCells.end());
+	}
+
+	bool WorldStreamer::IsRequired(const StreamingCell& cell) const
+	{
+		return cell.cameraDistance <= settings.requiredRadius;
+	}
+}
\ No newline at end of file
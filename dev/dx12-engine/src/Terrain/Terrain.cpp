@@ -0,0 +1,487 @@
+#include "Terrain/Terrain.h"
+
+#include "Core/Error.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	constexpr uint32_t MAX_TERRAIN_LOD_COUNT = 16;
+
+	// Selection walks breadth-first from the roots until it has this many subtrees, then
+	// traverses them in parallel. Fixed, so the output doesn't depend on the thread count.
+	constexpr size_t SELECTION_SUBTREE_COUNT = 64;
+
+	constexpr uint32_t CHUNK_GRAIN_SIZE = 16;
+
+	static bool IsPowerOfTwo(uint32_t value)
+	{
+		return value != 0 && (value & (value - 1)) == 0;
+	}
+
+	std::array<XMFLOAT4, 6> ExtractFrustumPlanes(const XMFLOAT4X4& viewProjection)
+	{
+		// Clip space position is position * viewProjection, so every clip coordinate is
+		// the dot product with a column.
+		auto getColumn = [&](uint32_t column) {
+			return XMFLOAT4{ viewProjection.m[0][column], viewProjection.m[1][column],
+				viewProjection.m[2][column], viewProjection.m[3][column] };
+		};
+
+		auto add = [](const XMFLOAT4& a, const XMFLOAT4& b, float sign) {
+			return XMFLOAT4{ a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w };
+		};
+
+		XMFLOAT4 x = getColumn(0);
+		XMFLOAT4 y = getColumn(1);
+		XMFLOAT4 z = getColumn(2);
+		XMFLOAT4 w = getColumn(3);
+
+		std::array<XMFLOAT4, 6> planes
+		{
+			add(w, x, 1.0f), add(w, x, -1.0f),
+			add(w, y, 1.0f), add(w, y, -1.0f),
+			z, add(w, z, -1.0f),
+		};
+
+		for (XMFLOAT4& plane : planes)
+		{
+			float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			plane = XMFLOAT4{ plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+		}
+
+		return planes;
+	}
+
+	Terrain::Terrain(const TerrainSettings& settings, const std::vector<float>& heights,
+		uint32_t sampleCountX, uint32_t sampleCountZ, ThreadPool* threadPool)
+		: settings(settings),
+		sampleCountX(sampleCountX),
+		sampleCountZ(sampleCountZ),
+		heights(heights)
+	{
+		if (!IsPowerOfTwo(settings.chunkResolution) || settings.chunkResolution < 4)
+			throw Error{ "Terrain chunk resolution must be a power of two of at least 4!" };
+		if (settings.lodCount == 0 || settings.lodCount > MAX_TERRAIN_LOD_COUNT)
+			throw Error{ "Terrain LOD count must be between 1 and 16!" };
+		if (settings.sampleSpacing <= 0.0f || settings.finestLodDistance <= 0.0f || settings.lodDistanceRatio <= 1.0f)
+			throw Error{ "Terrain sample spacing and LOD distances must be positive, the LOD distance ratio above 1!" };
+		if (settings.morphRegion <= 0.0f || settings.morphRegion > 1.0f)
+			throw Error{ "Terrain morph region must be within (0, 1]!" };
+
+		if (static_cast<uint64_t>(sampleCountX) * sampleCountZ != heights.size())
+			throw Error{ "Terrain height count doesn't match its sample counts!" };
+
+		uint64_t rootQuadCount = static_cast<uint64_t>(settings.chunkResolution) << (settings.lodCount - 1);
+		if (sampleCountX < 2 || sampleCountZ < 2 ||
+			(sampleCountX - 1) % rootQuadCount != 0 || (sampleCountZ - 1) % rootQuadCount != 0)
+			throw Error{ "Terrain sample counts minus one must be multiples of the root chunk size!" };
+
+		float previousRange{ 0.0f };
+		float range = settings.finestLodDistance;
+
+		for (uint32_t lod = 0; lod < settings.lodCount; lod++)
+		{
+			// The coarsest LOD covers everything that's left and never morphs.
+			if (lod == settings.lodCount - 1)
+			{
+				lodRanges.push_back(FLT_MAX);
+				morphStarts.push_back(FLT_MAX);
+				break;
+			}
+
+			lodRanges.push_back(range);
+			morphStarts.push_back(range - settings.morphRegion * (range - previousRange));
+
+			previousRange = range;
+			range *= settings.lodDistanceRatio;
+		}
+
+		BuildChunks(threadPool);
+
+		// A chunk fully morphs into the next LOD by the end of its range, which only hides the
+		// seam if the coarser neighbor doesn't morph yet where they meet, and if the neighbor
+		// is never two LODs coarser. Both hold when the next LOD's unmorphed part reaches past
+		// anything within a chunk's reach.
+		for (uint32_t lod = 0; lod + 2 < settings.lodCount; lod++)
+		{
+			const LodLevel& level = lodLevels[lod];
+
+			float maxHeightRange{ 0.0f };
+			for (uint32_t chunkIndex = level.firstChunk; chunkIndex < level.firstChunk + level.chunkCountX * level.chunkCountZ; chunkIndex++)
+				maxHeightRange = std::max(maxHeightRange, chunks[chunkIndex].maxHeight - chunks[chunkIndex].minHeight);
+
+			float chunkSize = chunks[level.firstChunk].size;
+			float chunkDiagonal = std::sqrt(2.0f * chunkSize * chunkSize + maxHeightRange * maxHeightRange);
+
+			if (morphStarts[lod + 1] - lodRanges[lod] < chunkDiagonal)
+				throw Error{ "Terrain LOD distances are too short for the chunk size, raise the finest LOD distance!" };
+		}
+	}
+
+	void Terrain::SelectChunks(const TerrainView& view, TerrainSelection& selection, ThreadPool* threadPool) const
+	{
+		selection.drawChunks.clear();
+		selection.vertexCount = 0;
+		selection.triangleCount = 0;
+		selection.visitedChunkCount = 0;
+		selection.culledChunkCount = 0;
+
+		// Roots are always within range, the coarsest LOD has no limit.
+		const LodLevel& rootLevel = lodLevels.back();
+
+		std::vector<uint32_t> subtrees;
+		for (uint32_t chunkIndex = rootLevel.firstChunk; chunkIndex < chunks.size(); chunkIndex++)
+		{
+			selection.visitedChunkCount++;
+			if (IsCulled(chunks[chunkIndex], view))
+			{
+				selection.culledChunkCount++;
+				continue;
+			}
+			subtrees.push_back(chunkIndex);
+		}
+
+		std::vector<uint32_t> nextSubtrees;
+		while (!subtrees.empty() && subtrees.size() < SELECTION_SUBTREE_COUNT)
+		{
+			nextSubtrees.clear();
+			for (uint32_t chunkIndex : subtrees)
+				SelectChunk(chunkIndex, view, selection, &nextSubtrees);
+			subtrees.swap(nextSubtrees);
+		}
+
+		std::vector<TerrainSelection> subtreeSelections(subtrees.size());
+
+		auto selectSubtrees = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t subtree = begin; subtree < end; subtree++)
+				SelectChunk(subtrees[subtree], view, subtreeSelections[subtree], nullptr);
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(subtrees.size()), 1, selectSubtrees);
+
+		for (const TerrainSelection& subtreeSelection : subtreeSelections)
+		{
+			selection.drawChunks.insert(selection.drawChunks.end(),
+				subtreeSelection.drawChunks.begin(), subtreeSelection.drawChunks.end());
+
+			selection.vertexCount += subtreeSelection.vertexCount;
+			selection.triangleCount += subtreeSelection.triangleCount;
+			selection.visitedChunkCount += subtreeSelection.visitedChunkCount;
+			selection.culledChunkCount += subtreeSelection.culledChunkCount;
+		}
+	}
+
+	ProceduralMesh Terrain::CreateGridMesh(const ProceduralVertexFormat& vertexFormat, TerrainGridMesh gridMesh) const
+	{
+		uint32_t resolution = gridMesh == TerrainGridMesh::FULL ? settings.chunkResolution : settings.chunkResolution / 2;
+		return GenerateGrid(vertexFormat, GridSettings{ 1.0f, 1.0f, resolution, resolution });
+	}
+
+	float Terrain::SampleHeight(float x, float z) const
+	{
+		float sampleX = std::clamp(x / settings.sampleSpacing, 0.0f, static_cast<float>(sampleCountX - 1));
+		float sampleZ = std::clamp(z / settings.sampleSpacing, 0.0f, static_cast<float>(sampleCountZ - 1));
+
+		uint32_t x0 = std::min(static_cast<uint32_t>(sampleX), sampleCountX - 2);
+		uint32_t z0 = std::min(static_cast<uint32_t>(sampleZ), sampleCountZ - 2);
+		float fractionX = sampleX - x0;
+		float fractionZ = sampleZ - z0;
+
+		const float* row0 = heights.data() + static_cast<size_t>(z0) * sampleCountX + x0;
+		const float* row1 = row0 + sampleCountX;
+
+		float height0 = row0[0] + (row0[1] - row0[0]) * fractionX;
+		float height1 = row1[0] + (row1[1] - row1[0]) * fractionX;
+		return height0 + (height1 - height0) * fractionZ;
+	}
+
+	float Terrain::CalculateMorphFactor(const TerrainDrawChunk& drawChunk, const XMFLOAT3& vertexPosition,
+		const XMFLOAT3& cameraPosition) const
+	{
+		float dx = vertexPosition.x - cameraPosition.x;
+		float dy = vertexPosition.y - cameraPosition.y;
+		float dz = vertexPosition.z - cameraPosition.z;
+		float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+		if (distance <= drawChunk.morphStart)
+			return 0.0f;
+
+		float morphLength = std::max(drawChunk.morphEnd - drawChunk.morphStart, FLT_EPSILON);
+		return std::min((distance - drawChunk.morphStart) / morphLength, 1.0f);
+	}
+
+	XMFLOAT3 Terrain::GetMorphedVertexPosition(const TerrainDrawChunk& drawChunk, uint32_t gridX, uint32_t gridZ,
+		const XMFLOAT3& cameraPosition) const
+	{
+		uint32_t resolution = settings.chunkResolution;
+		uint32_t gridResolution = drawChunk.gridMesh == TerrainGridMesh::FULL ? resolution : resolution / 2;
+		float spacing = drawChunk.size / gridResolution;
+
+		// Quadrants read their part of the chunk's heights, clamped at the chunk's edge (not the
+		// quadrant's) like the vertex shader's LoadHeight.
+		uint32_t offsetX{ 0 };
+		uint32_t offsetZ{ 0 };
+		if (drawChunk.quadrant != TERRAIN_FULL_CHUNK)
+		{
+			offsetX = (drawChunk.quadrant & 1) * gridResolution;
+			offsetZ = (drawChunk.quadrant >> 1) * gridResolution;
+		}
+
+		const float* chunkHeights = GetChunkHeights(drawChunk.chunkIndex);
+		auto getHeight = [&](float x, float z) {
+			uint32_t x0 = static_cast<uint32_t>(x);
+			uint32_t z0 = static_cast<uint32_t>(z);
+			uint32_t x1 = std::min(x0 + 1, resolution);
+			uint32_t z1 = std::min(z0 + 1, resolution);
+			float fractionX = x - x0;
+			float fractionZ = z - z0;
+
+			const float* row0 = chunkHeights + static_cast<size_t>(z0) * (resolution + 1);
+			const float* row1 = chunkHeights + static_cast<size_t>(z1) * (resolution + 1);
+
+			float height0 = row0[x0] + (row0[x1] - row0[x0]) * fractionX;
+			float height1 = row1[x0] + (row1[x1] - row1[x0]) * fractionX;
+			return height0 + (height1 - height0) * fractionZ;
+		};
+
+		XMFLOAT3 position{
+			drawChunk.origin.x + gridX * spacing,
+			getHeight(static_cast<float>(offsetX + gridX), static_cast<float>(offsetZ + gridZ)),
+			drawChunk.origin.y + gridZ * spacing };
+
+		// Odd vertices slide onto their even neighbor, which turns the grid into the next LOD's.
+		float morphFactor = CalculateMorphFactor(drawChunk, position, cameraPosition);
+		float morphedX = gridX - static_cast<float>(gridX & 1) * morphFactor;
+		float morphedZ = gridZ - static_cast<float>(gridZ & 1) * morphFactor;
+
+		return XMFLOAT3{
+			drawChunk.origin.x + morphedX * spacing,
+			getHeight(offsetX + morphedX, offsetZ + morphedZ),
+			drawChunk.origin.y + morphedZ * spacing };
+	}
+
+	const TerrainChunk& Terrain::GetChunk(uint32_t chunkIndex) const
+	{
+		return chunks[chunkIndex];
+	}
+	uint32_t Terrain::GetChunkCount() const
+	{
+		return static_cast<uint32_t>(chunks.size());
+	}
+
+	const float* Terrain::GetChunkHeights(uint32_t chunkIndex) const
+	{
+		return chunkHeights.data() + chunks[chunkIndex].heightOffset;
+	}
+	const std::vector<float>& Terrain::GetChunkHeightData() const
+	{
+		return chunkHeights;
+	}
+
+	float Terrain::GetLodRange(uint32_t lod) const
+	{
+		return lodRanges[lod];
+	}
+	float Terrain::GetMorphStart(uint32_t lod) const
+	{
+		return morphStarts[lod];
+	}
+
+	const TerrainSettings& Terrain::GetSettings() const
+	{
+		return settings;
+	}
+	float Terrain::GetSizeX() const
+	{
+		return (sampleCountX - 1) * settings.sampleSpacing;
+	}
+	float Terrain::GetSizeZ() const
+	{
+		return (sampleCountZ - 1) * settings.sampleSpacing;
+	}
+
+	void Terrain::BuildChunks(ThreadPool* threadPool)
+	{
+		uint32_t resolution = settings.chunkResolution;
+		uint32_t chunkSampleCount = (resolution + 1) * (resolution + 1);
+
+		uint32_t chunkCount{ 0 };
+		for (uint32_t lod = 0; lod < settings.lodCount; lod++)
+		{
+			uint32_t chunkQuadCount = resolution << lod;
+
+			LodLevel level{};
+			level.chunkCountX = (sampleCountX - 1) / chunkQuadCount;
+			level.chunkCountZ = (sampleCountZ - 1) / chunkQuadCount;
+			level.firstChunk = chunkCount;
+
+			lodLevels.push_back(level);
+			chunkCount += level.chunkCountX * level.chunkCountZ;
+		}
+
+		chunks.resize(chunkCount);
+		chunkHeights.resize(static_cast<size_t>(chunkCount) * chunkSampleCount);
+
+		// Finest LOD first, coarser bounds come from the children.
+		for (uint32_t lod = 0; lod < settings.lodCount; lod++)
+		{
+			const LodLevel& level = lodLevels[lod];
+			uint32_t stride = 1u << lod;
+
+			auto buildChunks = [&](uint32_t begin, uint32_t end) {
+				for (uint32_t levelChunk = begin; levelChunk < end; levelChunk++)
+				{
+					uint32_t chunkIndex = level.firstChunk + levelChunk;
+
+					TerrainChunk& chunk = chunks[chunkIndex];
+					chunk.lod = lod;
+					chunk.x = levelChunk % level.chunkCountX;
+					chunk.z = levelChunk / level.chunkCountX;
+					chunk.size = static_cast<float>(resolution << lod) * settings.sampleSpacing;
+					chunk.origin = XMFLOAT2{ chunk.x * chunk.size, chunk.z * chunk.size };
+					chunk.heightOffset = static_cast<uint64_t>(chunkIndex) * chunkSampleCount;
+
+					// Every 'stride'th sample, no filtering: the morph interpolates between them.
+					uint32_t firstSampleX = chunk.x * (resolution << lod);
+					uint32_t firstSampleZ = chunk.z * (resolution << lod);
+
+					float* destination = chunkHeights.data() + chunk.heightOffset;
+					for (uint32_t z = 0; z <= resolution; z++)
+					{
+						const float* sourceRow = heights.data() + static_cast<size_t>(firstSampleZ + z * stride) * sampleCountX + firstSampleX;
+						for (uint32_t x = 0; x <= resolution; x++)
+							*destination++ = sourceRow[x * stride];
+					}
+
+					if (lod == 0)
+					{
+						const float* chunkSamples = chunkHeights.data() + chunk.heightOffset;
+						auto [minHeight, maxHeight] = std::minmax_element(chunkSamples, chunkSamples + chunkSampleCount);
+						chunk.minHeight = *minHeight;
+						chunk.maxHeight = *maxHeight;
+						continue;
+					}
+
+					chunk.minHeight = FLT_MAX;
+					chunk.maxHeight = -FLT_MAX;
+					for (uint32_t quadrant = 0; quadrant < 4; quadrant++)
+					{
+						const TerrainChunk& child = chunks[GetChildIndex(chunk, quadrant)];
+						chunk.minHeight = std::min(chunk.minHeight, child.minHeight);
+						chunk.maxHeight = std::max(chunk.maxHeight, child.maxHeight);
+					}
+				}
+			};
+
+			ThreadPool::ParallelForOrInline(threadPool, 0, level.chunkCountX * level.chunkCountZ, CHUNK_GRAIN_SIZE, buildChunks);
+		}
+	}
+
+	uint32_t Terrain::GetChunkIndex(uint32_t lod, uint32_t x, uint32_t z) const
+	{
+		const LodLevel& level = lodLevels[lod];
+		return level.firstChunk + z * level.chunkCountX + x;
+	}
+
+	uint32_t Terrain::GetChildIndex(const TerrainChunk& chunk, uint32_t quadrant) const
+	{
+		return GetChunkIndex(chunk.lod - 1, chunk.x * 2 + (quadrant & 1), chunk.z * 2 + (quadrant >> 1));
+	}
+
+	bool Terrain::IsInRange(const TerrainChunk& chunk, const XMFLOAT3& cameraPosition, float range) const
+	{
+		auto getAxisDistance = [](float value, float min, float max) {
+			return std::max(std::max(min - value, value - max), 0.0f);
+		};
+
+		float dx = getAxisDistance(cameraPosition.x, chunk.origin.x, chunk.origin.x + chunk.size);
+		float dy = getAxisDistance(cameraPosition.y, chunk.minHeight, chunk.maxHeight);
+		float dz = getAxisDistance(cameraPosition.z, chunk.origin.y, chunk.origin.y + chunk.size);
+
+		return dx * dx + dy * dy + dz * dz <= range * range;
+	}
+
+	bool Terrain::IsCulled(const TerrainChunk& chunk, const TerrainView& view) const
+	{
+		if (!view.frustumCulling)
+			return false;
+
+		for (const XMFLOAT4& plane : view.frustumPlanes)
+		{
+			// The box corner farthest along the plane normal.
+			float x = plane.x >= 0.0f ? chunk.origin.x + chunk.size : chunk.origin.x;
+			float y = plane.y >= 0.0f ? chunk.maxHeight : chunk.minHeight;
+			float z = plane.z >= 0.0f ? chunk.origin.y + chunk.size : chunk.origin.y;
+
+			if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+				return true;
+		}
+		return false;
+	}
+
+	void Terrain::SelectChunk(uint32_t chunkIndex, const TerrainView& view, TerrainSelection& selection,
+		std::vector<uint32_t>* deferredChildren) const
+	{
+		const TerrainChunk& chunk = chunks[chunkIndex];
+
+		if (chunk.lod == 0 || !IsInRange(chunk, view.cameraPosition, lodRanges[chunk.lod - 1]))
+		{
+			AddDrawChunk(chunkIndex, TERRAIN_FULL_CHUNK, selection);
+			return;
+		}
+
+		for (uint32_t quadrant = 0; quadrant < 4; quadrant++)
+		{
+			uint32_t childIndex = GetChildIndex(chunk, quadrant);
+			const TerrainChunk& child = chunks[childIndex];
+
+			selection.visitedChunkCount++;
+			if (IsCulled(child, view))
+			{
+				selection.culledChunkCount++;
+				continue;
+			}
+
+			if (!IsInRange(child, view.cameraPosition, lodRanges[child.lod]))
+				AddDrawChunk(chunkIndex, quadrant, selection);
+			else if (deferredChildren)
+				deferredChildren->push_back(childIndex);
+			else
+				SelectChunk(childIndex, view, selection, nullptr);
+		}
+	}
+
+	void Terrain::AddDrawChunk(uint32_t chunkIndex, uint32_t quadrant, TerrainSelection& selection) const
+	{
+		const TerrainChunk& chunk = chunks[chunkIndex];
+
+		TerrainDrawChunk drawChunk{};
+		drawChunk.chunkIndex = chunkIndex;
+		drawChunk.quadrant = quadrant;
+		drawChunk.lod = chunk.lod;
+		drawChunk.origin = chunk.origin;
+		drawChunk.size = chunk.size;
+		drawChunk.morphStart = morphStarts[chunk.lod];
+		drawChunk.morphEnd = lodRanges[chunk.lod];
+
+		uint64_t gridResolution = settings.chunkResolution;
+		if (quadrant != TERRAIN_FULL_CHUNK)
+		{
+			drawChunk.gridMesh = TerrainGridMesh::QUARTER;
+			drawChunk.size *= 0.5f;
+			drawChunk.origin.x += (quadrant & 1) * drawChunk.size;
+			drawChunk.origin.y += (quadrant >> 1) * drawChunk.size;
+			gridResolution /= 2;
+		}
+
+		selection.drawChunks.push_back(drawChunk);
+		selection.vertexCount += (gridResolution + 1) * (gridResolution + 1);
+		selection.triangleCount += 2 * gridResolution * gridResolution;
+	}
+}
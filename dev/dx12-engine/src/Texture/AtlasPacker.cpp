@@ -0,0 +1,530 @@
+#include "Texture/AtlasPacker.h"
+
+#include "Core/Error.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace dxe
+{
+	constexpr uint32_t IMAGE_GRAIN_SIZE = 16;
+
+	struct PackRect
+	{
+		uint32_t x{ 0 };
+		uint32_t y{ 0 };
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+	};
+
+	static uint32_t AlignUp(uint32_t value, uint32_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	static uint32_t NextPowerOfTwo(uint32_t value)
+	{
+		uint32_t result{ 1 };
+		while (result < value)
+			result <<= 1;
+		return result;
+	}
+
+	// Skyline
+
+	// The top edge of everything packed so far, as horizontal segments sorted by x.
+	class SkylinePacker
+	{
+	public:
+
+		void Reset(uint32_t width, uint32_t height)
+		{
+			binWidth = width;
+			binHeight = height;
+
+			nodes.clear();
+			nodes.push_back(SkylineNode{ 0, 0, width });
+		}
+
+		bool Insert(uint32_t width, uint32_t height, PackRect& rect)
+		{
+			size_t bestNode{ SIZE_MAX };
+			uint32_t bestTop{ UINT32_MAX };
+			uint32_t bestWidth{ UINT32_MAX };
+			uint32_t bestY{ 0 };
+
+			for (size_t node = 0; node < nodes.size(); node++)
+			{
+				uint32_t y;
+				if (!Fits(node, width, height, y))
+					continue;
+
+				// Lowest resulting skyline first, then the narrowest segment to keep wide ones for wide rects.
+				uint32_t top = y + height;
+				if (top < bestTop || (top == bestTop && nodes[node].width < bestWidth))
+				{
+					bestNode = node;
+					bestTop = top;
+					bestWidth = nodes[node].width;
+					bestY = y;
+				}
+			}
+
+			if (bestNode == SIZE_MAX)
+				return false;
+
+			rect = PackRect{ nodes[bestNode].x, bestY, width, height };
+			AddLevel(bestNode, rect);
+			return true;
+		}
+
+	private:
+
+		struct SkylineNode
+		{
+			uint32_t x{ 0 };
+			uint32_t y{ 0 };
+			uint32_t width{ 0 };
+		};
+
+		// The rect rests on the highest segment it spans.
+		bool Fits(size_t node, uint32_t width, uint32_t height, uint32_t& y) const
+		{
+			if (nodes[node].x + width > binWidth)
+				return false;
+
+			y = nodes[node].y;
+			uint32_t remainingWidth = width;
+
+			for (size_t spanned = node; remainingWidth > 0; spanned++)
+			{
+				y = std::max(y, nodes[spanned].y);
+				if (y + height > binHeight)
+					return false;
+
+				remainingWidth -= std::min(remainingWidth, nodes[spanned].width);
+			}
+			return true;
+		}
+
+		void AddLevel(size_t node, const PackRect& rect)
+		{
+			nodes.insert(nodes.begin() + node, SkylineNode{ rect.x, rect.y + rect.height, rect.width });
+
+			// Cut away the segments now hidden under the new one.
+			uint32_t levelEnd = rect.x + rect.width;
+			for (size_t next = node + 1; next < nodes.size();)
+			{
+				if (nodes[next].x >= levelEnd)
+					break;
+
+				uint32_t hidden = levelEnd - nodes[next].x;
+				if (nodes[next].width <= hidden)
+				{
+					nodes.erase(nodes.begin() + next);
+					continue;
+				}
+
+				nodes[next].x += hidden;
+				nodes[next].width -= hidden;
+				break;
+			}
+
+			// Merge neighbours at the same height.
+			for (size_t current = 0; current + 1 < nodes.size();)
+			{
+				if (nodes[current].y == nodes[current + 1].y)
+				{
+					nodes[current].width += nodes[current + 1].width;
+					nodes.erase(nodes.begin() + current + 1);
+				}
+				else
+				{
+					current++;
+				}
+			}
+		}
+
+		std::vector<SkylineNode> nodes;
+		uint32_t binWidth{ 0 };
+		uint32_t binHeight{ 0 };
+	};
+
+	// MaxRects
+
+	// Keeps every maximal free rectangle. A placement splits the free rects it overlaps,
+	// and only the pieces it creates need checking for containment, which keeps inserts
+	// linear in the free rect count. Pieces too small for any rect are dropped right away,
+	// otherwise thousands of slivers pile up between small entries.
+	class MaxRectsPacker
+	{
+	public:
+
+		void Reset(uint32_t width, uint32_t height, uint32_t smallestWidth, uint32_t smallestHeight)
+		{
+			minWidth = smallestWidth;
+			minHeight = smallestHeight;
+
+			freeRects.clear();
+			freeRects.push_back(PackRect{ 0, 0, width, height });
+		}
+
+		bool Insert(uint32_t width, uint32_t height, PackRect& rect)
+		{
+			size_t bestFree{ SIZE_MAX };
+			uint32_t bestBottom{ UINT32_MAX };
+			uint32_t bestX{ UINT32_MAX };
+
+			for (size_t free = 0; free < freeRects.size(); free++)
+			{
+				const PackRect& freeRect = freeRects[free];
+				if (freeRect.width < width || freeRect.height < height)
+					continue;
+
+				// Bottom-left rule (with y growing down): smallest bottom edge, then leftmost.
+				uint32_t bottom = freeRect.y + height;
+				if (bottom < bestBottom || (bottom == bestBottom && freeRect.x < bestX))
+				{
+					bestFree = free;
+					bestBottom = bottom;
+					bestX = freeRect.x;
+				}
+			}
+
+			if (bestFree == SIZE_MAX)
+				return false;
+
+			rect = PackRect{ freeRects[bestFree].x, freeRects[bestFree].y, width, height };
+			Place(rect);
+			return true;
+		}
+
+	private:
+
+		static bool Intersects(const PackRect& a, const PackRect& b)
+		{
+			return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+		}
+
+		static bool Contains(const PackRect& outer, const PackRect& inner)
+		{
+			return inner.x >= outer.x && inner.y >= outer.y &&
+				inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+		}
+
+		void Place(const PackRect& used)
+		{
+			newRects.clear();
+
+			for (size_t free = 0; free < freeRects.size();)
+			{
+				if (!Intersects(freeRects[free], used))
+				{
+					free++;
+					continue;
+				}
+
+				Split(freeRects[free], used);
+				freeRects[free] = freeRects.back();
+				freeRects.pop_back();
+			}
+
+			// Free rects that survived were already maximal among themselves, and none of
+			// them can sit inside a piece of a rect it wasn't inside before. So only the new
+			// pieces get dropped: when another new piece or an old free rect contains them.
+			size_t oldCount = freeRects.size();
+			for (size_t piece = 0; piece < newRects.size(); piece++)
+			{
+				bool contained{ false };
+
+				for (size_t other = 0; other < newRects.size() && !contained; other++)
+				{
+					// Of two identical pieces, the first one survives.
+					if (other != piece && Contains(newRects[other], newRects[piece]))
+						contained = !Contains(newRects[piece], newRects[other]) || other < piece;
+				}
+				for (size_t free = 0; free < oldCount && !contained; free++)
+					contained = Contains(freeRects[free], newRects[piece]);
+
+				if (!contained)
+					freeRects.push_back(newRects[piece]);
+			}
+		}
+
+		void Split(const PackRect& free, const PackRect& used)
+		{
+			if (used.x > free.x)
+				AddPiece(PackRect{ free.x, free.y, used.x - free.x, free.height });
+			if (used.x + used.width < free.x + free.width)
+				AddPiece(PackRect{ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+			if (used.y > free.y)
+				AddPiece(PackRect{ free.x, free.y, free.width, used.y - free.y });
+			if (used.y + used.height < free.y + free.height)
+				AddPiece(PackRect{ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+		}
+
+		void AddPiece(const PackRect& piece)
+		{
+			if (piece.width >= minWidth && piece.height >= minHeight)
+				newRects.push_back(piece);
+		}
+
+		std::vector<PackRect> freeRects;
+		std::vector<PackRect> newRects;
+
+		uint32_t minWidth{ 0 };
+		uint32_t minHeight{ 0 };
+	};
+
+	// Packing
+
+	static bool PackAll(
+		SkylinePacker& packer, uint32_t width, uint32_t height,
+		const std::vector<Dimensions2D>& packedSizes, const std::vector<uint32_t>& order, std::vector<PackRect>& rects)
+	{
+		packer.Reset(width, height);
+
+		for (uint32_t index : order)
+		{
+			if (!packer.Insert(packedSizes[index].width, packedSizes[index].height, rects[index]))
+				return false;
+		}
+		return true;
+	}
+
+	static bool PackAll(
+		MaxRectsPacker& packer, uint32_t width, uint32_t height,
+		const std::vector<Dimensions2D>& packedSizes, const std::vector<uint32_t>& order, std::vector<PackRect>& rects)
+	{
+		uint32_t smallestWidth{ UINT32_MAX };
+		uint32_t smallestHeight{ UINT32_MAX };
+		for (const Dimensions2D& size : packedSizes)
+		{
+			smallestWidth = std::min(smallestWidth, size.width);
+			smallestHeight = std::min(smallestHeight, size.height);
+		}
+
+		packer.Reset(width, height, smallestWidth, smallestHeight);
+
+		for (uint32_t index : order)
+		{
+			if (!packer.Insert(packedSizes[index].width, packedSizes[index].height, rects[index]))
+				return false;
+		}
+		return true;
+	}
+
+	AtlasLayout PackAtlasRects(const std::vector<Dimensions2D>& sizes, const AtlasPackSettings& settings)
+	{
+		if (settings.mipLevels == 0 || settings.mipLevels > 16)
+			throw Error{ "Atlas mip level count must be between 1 and 16!" };
+		if (settings.alignment == 0 || (settings.alignment & (settings.alignment - 1)) != 0)
+			throw Error{ "Atlas alignment must be a power of two!" };
+
+		uint32_t mipScale = 1u << (settings.mipLevels - 1);
+		uint32_t gutter = settings.gutter * mipScale;
+		uint32_t alignment = std::max(settings.alignment, mipScale);
+
+		uint32_t maxWidth = settings.maxWidth / alignment * alignment;
+		uint32_t maxHeight = settings.maxHeight / alignment * alignment;
+
+		// Sizes of the whole rects that get packed: image, gutters on both sides, padding after.
+		std::vector<Dimensions2D> packedSizes(sizes.size());
+		uint64_t packedArea{ 0 };
+		uint32_t widestRect{ alignment };
+
+		for (size_t index = 0; index < sizes.size(); index++)
+		{
+			if (sizes[index].width == 0 || sizes[index].height == 0)
+				throw Error{ "Atlas entries can't have a zero size!" };
+
+			uint64_t packedWidth = AlignUp(sizes[index].width + 2 * gutter + settings.padding, alignment);
+			uint64_t packedHeight = AlignUp(sizes[index].height + 2 * gutter + settings.padding, alignment);
+			if (packedWidth > maxWidth || packedHeight > maxHeight)
+				throw Error{ "Atlas entry is larger than the maximum atlas size!" };
+
+			packedSizes[index] = Dimensions2D{ static_cast<uint32_t>(packedWidth), static_cast<uint32_t>(packedHeight) };
+			packedArea += packedWidth * packedHeight;
+			widestRect = std::max(widestRect, packedSizes[index].width);
+		}
+
+		// Big rects first, tall ones for the skyline since it stacks rows, long sides for MaxRects.
+		std::vector<uint32_t> order(sizes.size());
+		std::iota(order.begin(), order.end(), 0);
+
+		bool skyline = settings.heuristic == AtlasPackHeuristic::SKYLINE;
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+		{
+			const Dimensions2D& sizeA = packedSizes[a];
+			const Dimensions2D& sizeB = packedSizes[b];
+
+			uint32_t primaryA = skyline ? sizeA.height : std::max(sizeA.width, sizeA.height);
+			uint32_t primaryB = skyline ? sizeB.height : std::max(sizeB.width, sizeB.height);
+			if (primaryA != primaryB)
+				return primaryA > primaryB;
+
+			uint32_t secondaryA = skyline ? sizeA.width : std::min(sizeA.width, sizeA.height);
+			uint32_t secondaryB = skyline ? sizeB.width : std::min(sizeB.width, sizeB.height);
+			return secondaryA > secondaryB;
+		});
+
+		// Pack into a bin as tall as allowed and as wide as a square of the packed area, then trim
+		// the unused rows. Both heuristics fill from the top row down, so one pass usually does it; the bin
+		// only gets wider when a pass runs out of height.
+		uint32_t areaSide = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(packedArea))));
+		uint32_t binWidth = std::min(maxWidth, AlignUp(std::max(areaSide, widestRect), alignment));
+		if (settings.powerOfTwo)
+			binWidth = std::min(maxWidth, NextPowerOfTwo(binWidth));
+
+		SkylinePacker skylinePacker{};
+		MaxRectsPacker maxRectsPacker{};
+		std::vector<PackRect> rects(sizes.size());
+
+		while (true)
+		{
+			bool packed = skyline ?
+				PackAll(skylinePacker, binWidth, maxHeight, packedSizes, order, rects) :
+				PackAll(maxRectsPacker, binWidth, maxHeight, packedSizes, order, rects);
+			if (packed)
+				break;
+
+			if (binWidth == maxWidth)
+				throw Error{ "Atlas entries don't fit into the maximum atlas size!" };
+
+			binWidth = settings.powerOfTwo ?
+				std::min(maxWidth, binWidth * 2) :
+				std::min(maxWidth, AlignUp(binWidth + std::max(binWidth / 8, 1u), alignment));
+		}
+
+		// Trim the atlas down to what's actually used.
+		AtlasLayout layout{};
+		for (const PackRect& rect : rects)
+		{
+			layout.width = std::max(layout.width, rect.x + rect.width);
+			layout.height = std::max(layout.height, rect.y + rect.height);
+		}
+		if (settings.powerOfTwo)
+		{
+			layout.width = NextPowerOfTwo(layout.width);
+			layout.height = NextPowerOfTwo(layout.height);
+		}
+
+		float inverseWidth = layout.width > 0 ? 1.0f / layout.width : 0.0f;
+		float inverseHeight = layout.height > 0 ? 1.0f / layout.height : 0.0f;
+		uint64_t imageArea{ 0 };
+
+		layout.entries.resize(sizes.size());
+		for (size_t index = 0; index < sizes.size(); index++)
+		{
+			AtlasEntry& entry = layout.entries[index];
+			entry.x = rects[index].x + gutter;
+			entry.y = rects[index].y + gutter;
+			entry.width = sizes[index].width;
+			entry.height = sizes[index].height;
+
+			entry.uvTransform.scale = DirectX::XMFLOAT2{ entry.width * inverseWidth, entry.height * inverseHeight };
+			entry.uvTransform.offset = DirectX::XMFLOAT2{ entry.x * inverseWidth, entry.y * inverseHeight };
+
+			imageArea += static_cast<uint64_t>(entry.width) * entry.height;
+		}
+
+		double atlasArea = static_cast<double>(layout.width) * layout.height;
+		if (atlasArea > 0.0)
+		{
+			layout.occupancy = static_cast<float>(imageArea / atlasArea);
+			layout.packedOccupancy = static_cast<float>(packedArea / atlasArea);
+		}
+
+		return layout;
+	}
+
+	// Pixels
+
+	// Copies the image and replicates its edge texels into the gutter around it.
+	static void CopyIntoAtlas(const Image& source, const AtlasEntry& entry, uint32_t gutter, Image& atlas)
+	{
+		size_t rowSize = static_cast<size_t>(source.width) * IMAGE_BYTES_PER_PIXEL;
+
+		for (uint32_t row = 0; row < source.height + 2 * gutter; row++)
+		{
+			uint32_t sourceY = std::min(row > gutter ? row - gutter : 0, source.height - 1);
+			const uint8_t* sourceRow = source.GetPixel(0, sourceY);
+			uint8_t* destinationRow = atlas.GetPixel(entry.x - gutter, entry.y - gutter + row);
+
+			for (uint32_t x = 0; x < gutter; x++)
+				std::memcpy(destinationRow + x * IMAGE_BYTES_PER_PIXEL, sourceRow, IMAGE_BYTES_PER_PIXEL);
+
+			std::memcpy(destinationRow + gutter * IMAGE_BYTES_PER_PIXEL, sourceRow, rowSize);
+
+			const uint8_t* lastPixel = sourceRow + rowSize - IMAGE_BYTES_PER_PIXEL;
+			uint8_t* rightGutter = destinationRow + (gutter + source.width) * IMAGE_BYTES_PER_PIXEL;
+			for (uint32_t x = 0; x < gutter; x++)
+				std::memcpy(rightGutter + x * IMAGE_BYTES_PER_PIXEL, lastPixel, IMAGE_BYTES_PER_PIXEL);
+		}
+	}
+
+	TextureAtlas BuildTextureAtlas(
+		const std::vector<const Image*>& images, const AtlasPackSettings& settings, ThreadPool* threadPool)
+	{
+		if (images.empty())
+			throw Error{ "Can't build an atlas without images!" };
+
+		std::vector<Dimensions2D> sizes(images.size());
+		for (size_t index = 0; index < images.size(); index++)
+		{
+			if (images[index]->format != images[0]->format)
+				throw Error{ "Atlas images must all have the same format!" };
+			sizes[index] = Dimensions2D{ images[index]->width, images[index]->height };
+		}
+
+		TextureAtlas atlas{};
+		atlas.layout = PackAtlasRects(sizes, settings);
+		atlas.image = CreateImage(atlas.layout.width, atlas.layout.height, images[0]->format);
+
+		uint32_t gutter = settings.gutter << (settings.mipLevels - 1);
+
+		// Entries never overlap, so the copies can run side by side.
+		auto copyImages = [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t index = begin; index < end; index++)
+				CopyIntoAtlas(*images[index], atlas.layout.entries[index], gutter, atlas.image);
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(images.size()), IMAGE_GRAIN_SIZE, copyImages);
+
+		return atlas;
+	}
+
+	// UV remapping
+
+	template <typename Vertex>
+	static void RemapVertexUvs(Vertex* vertices, size_t count, const AtlasUvTransform& uvTransform)
+	{
+		for (size_t vertex = 0; vertex < count; vertex++)
+		{
+			DirectX::XMFLOAT2& uv = vertices[vertex].vertexUv;
+			uv.x = uv.x * uvTransform.scale.x + uvTransform.offset.x;
+			uv.y = uv.y * uvTransform.scale.y + uvTransform.offset.y;
+		}
+	}
+
+	void RemapAtlasUvs(DirectX::XMFLOAT2* uvs, size_t count, const AtlasUvTransform& uvTransform)
+	{
+		for (size_t index = 0; index < count; index++)
+		{
+			uvs[index].x = uvs[index].x * uvTransform.scale.x + uvTransform.offset.x;
+			uvs[index].y = uvs[index].y * uvTransform.scale.y + uvTransform.offset.y;
+		}
+	}
+	void RemapAtlasUvs(VertexPU* vertices, size_t count, const AtlasUvTransform& uvTransform)
+	{
+		RemapVertexUvs(vertices, count, uvTransform);
+	}
+	void RemapAtlasUvs(VertexPNU* vertices, size_t count, const AtlasUvTransform& uvTransform)
+	{
+		RemapVertexUvs(vertices, count, uvTransform);
+	}
+}
@@ -0,0 +1,1282 @@
+#include "Texture/BcEncoder.h"
+
+#include "Core/Error.h"
+#include "Core/Simd.h"
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+namespace dxe
+{
+	constexpr uint32_t BLOCK_PIXEL_COUNT = 16;
+	constexpr uint16_t ALL_PIXELS_MASK = 0xFFFF;
+
+	// Block data
+
+	// Structure of arrays, so that four pixels fit in one SSE register per channel.
+	struct alignas(16) BlockPixels
+	{
+		float channels[4][BLOCK_PIXEL_COUNT];
+	};
+
+	struct BlockColor
+	{
+		float values[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+	};
+
+	struct BlockPalette
+	{
+		float colors[16][4];
+		uint32_t size{ 0 };
+	};
+
+	static void LoadBlockPixels(const uint8_t* pixels, BlockPixels& block)
+	{
+#if SIMD_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		for (uint32_t group = 0; group < 4; group++)
+		{
+			__m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + group * 16));
+			__m128i low = _mm_unpacklo_epi8(bytes, zero);
+			__m128i high = _mm_unpackhi_epi8(bytes, zero);
+
+			__m128 pixel0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(low, zero));
+			__m128 pixel1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(low, zero));
+			__m128 pixel2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(high, zero));
+			__m128 pixel3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(high, zero));
+			_MM_TRANSPOSE4_PS(pixel0, pixel1, pixel2, pixel3);
+
+			_mm_store_ps(&block.channels[0][group * 4], pixel0);
+			_mm_store_ps(&block.channels[1][group * 4], pixel1);
+			_mm_store_ps(&block.channels[2][group * 4], pixel2);
+			_mm_store_ps(&block.channels[3][group * 4], pixel3);
+		}
+#else
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+				block.channels[channel][pixel] = pixels[pixel * 4 + channel];
+		}
+#endif
+	}
+
+	// Finds the closest palette entry for every pixel. This is the inner loop of every
+	// endpoint search below, so it is the part that runs four pixels at a time.
+	static void SelectIndices(
+		const BlockPixels& block, const BlockPalette& palette, const float weights[4],
+		uint8_t indices[BLOCK_PIXEL_COUNT], float errors[BLOCK_PIXEL_COUNT])
+	{
+#if SIMD_SSE2
+		const __m128 weightR = _mm_set1_ps(weights[0]);
+		const __m128 weightG = _mm_set1_ps(weights[1]);
+		const __m128 weightB = _mm_set1_ps(weights[2]);
+		const __m128 weightA = _mm_set1_ps(weights[3]);
+
+		for (uint32_t group = 0; group < 4; group++)
+		{
+			__m128 r = _mm_load_ps(&block.channels[0][group * 4]);
+			__m128 g = _mm_load_ps(&block.channels[1][group * 4]);
+			__m128 b = _mm_load_ps(&block.channels[2][group * 4]);
+			__m128 a = _mm_load_ps(&block.channels[3][group * 4]);
+
+			__m128 bestError = _mm_set1_ps(FLT_MAX);
+			__m128i bestIndex = _mm_setzero_si128();
+
+			for (uint32_t entry = 0; entry < palette.size; entry++)
+			{
+				__m128 dr = _mm_sub_ps(r, _mm_set1_ps(palette.colors[entry][0]));
+				__m128 dg = _mm_sub_ps(g, _mm_set1_ps(palette.colors[entry][1]));
+				__m128 db = _mm_sub_ps(b, _mm_set1_ps(palette.colors[entry][2]));
+				__m128 da = _mm_sub_ps(a, _mm_set1_ps(palette.colors[entry][3]));
+
+				__m128 error = _mm_mul_ps(_mm_mul_ps(dr, dr), weightR);
+				error = _mm_add_ps(error, _mm_mul_ps(_mm_mul_ps(dg, dg), weightG));
+				error = _mm_add_ps(error, _mm_mul_ps(_mm_mul_ps(db, db), weightB));
+				error = _mm_add_ps(error, _mm_mul_ps(_mm_mul_ps(da, da), weightA));
+
+				__m128i better = _mm_castps_si128(_mm_cmplt_ps(error, bestError));
+				bestError = _mm_min_ps(error, bestError);
+				bestIndex = _mm_or_si128(
+					_mm_and_si128(better, _mm_set1_epi32(static_cast<int>(entry))),
+					_mm_andnot_si128(better, bestIndex));
+			}
+
+			alignas(16) int32_t groupIndices[4];
+			_mm_store_si128(reinterpret_cast<__m128i*>(groupIndices), bestIndex);
+			_mm_storeu_ps(&errors[group * 4], bestError);
+
+			for (uint32_t lane = 0; lane < 4; lane++)
+				indices[group * 4 + lane] = static_cast<uint8_t>(groupIndices[lane]);
+		}
+#else
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			float bestError = FLT_MAX;
+			uint8_t bestIndex = 0;
+
+			for (uint32_t entry = 0; entry < palette.size; entry++)
+			{
+				float error = 0.0f;
+				for (uint32_t channel = 0; channel < 4; channel++)
+				{
+					float difference = block.channels[channel][pixel] - palette.colors[entry][channel];
+					error += difference * difference * weights[channel];
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					bestIndex = static_cast<uint8_t>(entry);
+				}
+			}
+
+			indices[pixel] = bestIndex;
+			errors[pixel] = bestError;
+		}
+#endif
+	}
+
+	static float SumErrors(const float errors[BLOCK_PIXEL_COUNT], uint16_t mask)
+	{
+		float total = 0.0f;
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			if (mask & (1u << pixel))
+				total += errors[pixel];
+		}
+		return total;
+	}
+
+	// Endpoint fitting
+
+	static void ClampColor(BlockColor& color)
+	{
+		for (float& value : color.values)
+			value = std::clamp(value, 0.0f, 255.0f);
+	}
+
+	// Min/max per channel, with the channels that go against the dominant one flipped,
+	// so that the endpoints span the block's diagonal in the right direction.
+	static void FitEndpointsBoundingBox(
+		const BlockPixels& block, uint16_t mask, uint32_t channelCount, BlockColor& endpoint0, BlockColor& endpoint1)
+	{
+		float minimum[4]{ 255.0f, 255.0f, 255.0f, 255.0f };
+		float maximum[4]{ 0.0f, 0.0f, 0.0f, 0.0f };
+		float mean[4]{};
+		uint32_t pixelCount{ 0 };
+
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			if (!(mask & (1u << pixel)))
+				continue;
+
+			for (uint32_t channel = 0; channel < channelCount; channel++)
+			{
+				float value = block.channels[channel][pixel];
+				minimum[channel] = std::min(minimum[channel], value);
+				maximum[channel] = std::max(maximum[channel], value);
+				mean[channel] += value;
+			}
+			pixelCount++;
+		}
+
+		uint32_t dominantChannel{ 0 };
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+		{
+			mean[channel] /= static_cast<float>(std::max(pixelCount, 1u));
+			if (maximum[channel] - minimum[channel] > maximum[dominantChannel] - minimum[dominantChannel])
+				dominantChannel = channel;
+		}
+
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+		{
+			float covariance = 0.0f;
+			for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			{
+				if (mask & (1u << pixel))
+				{
+					covariance += (block.channels[channel][pixel] - mean[channel]) *
+						(block.channels[dominantChannel][pixel] - mean[dominantChannel]);
+				}
+			}
+
+			if (covariance < 0.0f)
+				std::swap(minimum[channel], maximum[channel]);
+
+			endpoint0.values[channel] = minimum[channel];
+			endpoint1.values[channel] = maximum[channel];
+		}
+	}
+
+	// Endpoints along the principal axis of the pixels (power iteration on the covariance matrix).
+	static void FitEndpointsPrincipalAxis(
+		const BlockPixels& block, uint16_t mask, uint32_t channelCount, BlockColor& endpoint0, BlockColor& endpoint1)
+	{
+		float mean[4]{};
+		uint32_t pixelCount{ 0 };
+
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			if (!(mask & (1u << pixel)))
+				continue;
+
+			for (uint32_t channel = 0; channel < channelCount; channel++)
+				mean[channel] += block.channels[channel][pixel];
+			pixelCount++;
+		}
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+			mean[channel] /= static_cast<float>(std::max(pixelCount, 1u));
+
+		float covariance[4][4]{};
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			if (!(mask & (1u << pixel)))
+				continue;
+
+			for (uint32_t row = 0; row < channelCount; row++)
+			{
+				float rowValue = block.channels[row][pixel] - mean[row];
+				for (uint32_t column = row; column < channelCount; column++)
+					covariance[row][column] += rowValue * (block.channels[column][pixel] - mean[column]);
+			}
+		}
+		for (uint32_t row = 0; row < channelCount; row++)
+		{
+			for (uint32_t column = 0; column < row; column++)
+				covariance[row][column] = covariance[column][row];
+		}
+
+		// Start from the covariance column with the largest variance, it's rarely orthogonal to the answer.
+		uint32_t startColumn{ 0 };
+		for (uint32_t channel = 1; channel < channelCount; channel++)
+		{
+			if (covariance[channel][channel] > covariance[startColumn][startColumn])
+				startColumn = channel;
+		}
+
+		float axis[4]{};
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+			axis[channel] = covariance[channel][startColumn];
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4]{};
+			float largest = 0.0f;
+
+			for (uint32_t row = 0; row < channelCount; row++)
+			{
+				for (uint32_t column = 0; column < channelCount; column++)
+					next[row] += covariance[row][column] * axis[column];
+				largest = std::max(largest, std::fabs(next[row]));
+			}
+
+			if (largest < 1e-6f)
+				break;
+
+			for (uint32_t channel = 0; channel < channelCount; channel++)
+				axis[channel] = next[channel] / largest;
+		}
+
+		float axisLengthSquared = 0.0f;
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+			axisLengthSquared += axis[channel] * axis[channel];
+
+		// Flat block, both endpoints sit on the mean.
+		if (axisLengthSquared < 1e-12f)
+		{
+			for (uint32_t channel = 0; channel < channelCount; channel++)
+			{
+				endpoint0.values[channel] = mean[channel];
+				endpoint1.values[channel] = mean[channel];
+			}
+			return;
+		}
+
+		float minimumProjection = FLT_MAX;
+		float maximumProjection = -FLT_MAX;
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			if (!(mask & (1u << pixel)))
+				continue;
+
+			float projection = 0.0f;
+			for (uint32_t channel = 0; channel < channelCount; channel++)
+				projection += (block.channels[channel][pixel] - mean[channel]) * axis[channel];
+
+			minimumProjection = std::min(minimumProjection, projection);
+			maximumProjection = std::max(maximumProjection, projection);
+		}
+
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+		{
+			endpoint0.values[channel] = mean[channel] + axis[channel] * minimumProjection / axisLengthSquared;
+			endpoint1.values[channel] = mean[channel] + axis[channel] * maximumProjection / axisLengthSquared;
+		}
+
+		ClampColor(endpoint0);
+		ClampColor(endpoint1);
+	}
+
+	// Solves for the endpoints that minimize the error for the given indices.
+	// 'indexWeights' is how far along from endpoint 0 to endpoint 1 each index is,
+	// negative weights mark indices that don't interpolate (BC4's constant 0 and 255).
+	static bool RefineEndpointsLeastSquares(
+		const BlockPixels& block, uint16_t mask, uint32_t channelCount,
+		const uint8_t indices[BLOCK_PIXEL_COUNT], const float* indexWeights,
+		BlockColor& endpoint0, BlockColor& endpoint1)
+	{
+		float alpha2 = 0.0f;
+		float alphaBeta = 0.0f;
+		float beta2 = 0.0f;
+		float alphaX[4]{};
+		float betaX[4]{};
+
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+		{
+			if (!(mask & (1u << pixel)))
+				continue;
+
+			float beta = indexWeights[indices[pixel]];
+			if (beta < 0.0f)
+				continue;
+
+			float alpha = 1.0f - beta;
+			alpha2 += alpha * alpha;
+			alphaBeta += alpha * beta;
+			beta2 += beta * beta;
+
+			for (uint32_t channel = 0; channel < channelCount; channel++)
+			{
+				alphaX[channel] += alpha * block.channels[channel][pixel];
+				betaX[channel] += beta * block.channels[channel][pixel];
+			}
+		}
+
+		float determinant = alpha2 * beta2 - alphaBeta * alphaBeta;
+		if (std::fabs(determinant) < 1e-6f)
+			return false;
+
+		float inverseDeterminant = 1.0f / determinant;
+		for (uint32_t channel = 0; channel < channelCount; channel++)
+		{
+			endpoint0.values[channel] = (beta2 * alphaX[channel] - alphaBeta * betaX[channel]) * inverseDeterminant;
+			endpoint1.values[channel] = (alpha2 * betaX[channel] - alphaBeta * alphaX[channel]) * inverseDeterminant;
+		}
+
+		ClampColor(endpoint0);
+		ClampColor(endpoint1);
+		return true;
+	}
+
+	static void FitEndpoints(
+		const BlockPixels& block, uint16_t mask, uint32_t channelCount, BcEncodeQuality quality,
+		BlockColor& endpoint0, BlockColor& endpoint1)
+	{
+		if (quality == BcEncodeQuality::FAST)
+			FitEndpointsBoundingBox(block, mask, channelCount, endpoint0, endpoint1);
+		else
+			FitEndpointsPrincipalAxis(block, mask, channelCount, endpoint0, endpoint1);
+	}
+
+	// BC1
+
+	constexpr float BC1_COLOR_WEIGHTS[4]{ 1.0f, 1.0f, 1.0f, 0.0f };
+	constexpr float BC1_INDEX_WEIGHTS[4]{ 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	static uint16_t QuantizeColor565(const BlockColor& color)
+	{
+		uint32_t r = static_cast<uint32_t>(color.values[0] * (31.0f / 255.0f) + 0.5f);
+		uint32_t g = static_cast<uint32_t>(color.values[1] * (63.0f / 255.0f) + 0.5f);
+		uint32_t b = static_cast<uint32_t>(color.values[2] * (31.0f / 255.0f) + 0.5f);
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+	static BlockColor DecodeColor565(uint16_t color)
+	{
+		uint32_t r = (color >> 11) & 31;
+		uint32_t g = (color >> 5) & 63;
+		uint32_t b = color & 31;
+
+		BlockColor decoded{};
+		decoded.values[0] = static_cast<float>((r << 3) | (r >> 2));
+		decoded.values[1] = static_cast<float>((g << 2) | (g >> 4));
+		decoded.values[2] = static_cast<float>((b << 3) | (b >> 2));
+		decoded.values[3] = 255.0f;
+		return decoded;
+	}
+
+	struct Bc1Candidate
+	{
+		uint16_t color0{ 0 };
+		uint16_t color1{ 0 };
+		uint8_t indices[BLOCK_PIXEL_COUNT]{};
+		float error{ FLT_MAX };
+	};
+
+	static Bc1Candidate EvaluateBc1Endpoints(const BlockPixels& block, const BlockColor& endpoint0, const BlockColor& endpoint1)
+	{
+		Bc1Candidate candidate{};
+		candidate.color0 = QuantizeColor565(endpoint0);
+		candidate.color1 = QuantizeColor565(endpoint1);
+
+		// color0 > color1 selects the four color mode, which is the only one we emit.
+		if (candidate.color0 < candidate.color1)
+			std::swap(candidate.color0, candidate.color1);
+
+		BlockColor color0 = DecodeColor565(candidate.color0);
+		BlockColor color1 = DecodeColor565(candidate.color1);
+
+		BlockPalette palette{};
+		palette.size = candidate.color0 == candidate.color1 ? 1 : 4;
+		for (uint32_t entry = 0; entry < palette.size; entry++)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+			{
+				palette.colors[entry][channel] = color0.values[channel] +
+					(color1.values[channel] - color0.values[channel]) * BC1_INDEX_WEIGHTS[entry];
+			}
+		}
+
+		float errors[BLOCK_PIXEL_COUNT];
+		SelectIndices(block, palette, BC1_COLOR_WEIGHTS, candidate.indices, errors);
+		candidate.error = SumErrors(errors, ALL_PIXELS_MASK);
+		return candidate;
+	}
+
+	static void WriteBc1ColorBlock(const Bc1Candidate& candidate, uint8_t* block)
+	{
+		uint32_t indexBits{ 0 };
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			indexBits |= static_cast<uint32_t>(candidate.indices[pixel]) << (pixel * 2);
+
+		block[0] = static_cast<uint8_t>(candidate.color0);
+		block[1] = static_cast<uint8_t>(candidate.color0 >> 8);
+		block[2] = static_cast<uint8_t>(candidate.color1);
+		block[3] = static_cast<uint8_t>(candidate.color1 >> 8);
+		std::memcpy(block + 4, &indexBits, sizeof(indexBits));
+	}
+
+	static void EncodeBc1Color(const BlockPixels& block, uint8_t* output, BcEncodeQuality quality)
+	{
+		BlockColor endpoint0{};
+		BlockColor endpoint1{};
+		FitEndpoints(block, ALL_PIXELS_MASK, 3, quality, endpoint0, endpoint1);
+
+		if (quality == BcEncodeQuality::FAST)
+		{
+			// Insetting the box a little pulls the endpoints off the outliers, same as most realtime encoders do.
+			for (uint32_t channel = 0; channel < 3; channel++)
+			{
+				float inset = (endpoint1.values[channel] - endpoint0.values[channel]) / 16.0f;
+				endpoint0.values[channel] += inset;
+				endpoint1.values[channel] -= inset;
+			}
+		}
+
+		Bc1Candidate best = EvaluateBc1Endpoints(block, endpoint0, endpoint1);
+
+		if (quality == BcEncodeQuality::HIGH)
+		{
+			for (uint32_t iteration = 0; iteration < 2 && best.error > 0.0f; iteration++)
+			{
+				// The palette order after quantization decides which endpoint is which.
+				if (!RefineEndpointsLeastSquares(block, ALL_PIXELS_MASK, 3, best.indices, BC1_INDEX_WEIGHTS, endpoint0, endpoint1))
+					break;
+
+				Bc1Candidate refined = EvaluateBc1Endpoints(block, endpoint0, endpoint1);
+				if (refined.error >= best.error)
+					break;
+				best = refined;
+			}
+		}
+
+		WriteBc1ColorBlock(best, output);
+	}
+
+	// BC4
+
+	struct Bc4Candidate
+	{
+		uint8_t endpoint0{ 0 };
+		uint8_t endpoint1{ 0 };
+		uint8_t indices[BLOCK_PIXEL_COUNT]{};
+		float error{ FLT_MAX };
+	};
+
+	// Index 0 and 1 are the endpoints, the rest interpolate between them. With endpoint0 <= endpoint1
+	// only four values interpolate, and the last two indices are constant 0 and 255.
+	static void BuildBc4Palette(uint8_t endpoint0, uint8_t endpoint1, uint32_t channel, BlockPalette& palette, float* indexWeights)
+	{
+		palette = {};
+		palette.size = 8;
+
+		bool eightValues = endpoint0 > endpoint1;
+		float interpolationSteps = eightValues ? 7.0f : 5.0f;
+
+		for (uint32_t entry = 0; entry < 8; entry++)
+		{
+			float weight;
+			if (entry == 0)
+				weight = 0.0f;
+			else if (entry == 1)
+				weight = 1.0f;
+			else if (eightValues || entry < 6)
+				weight = static_cast<float>(entry - 1) / interpolationSteps;
+			else
+				weight = -1.0f;
+
+			float value;
+			if (weight >= 0.0f)
+			{
+				// Integer rounding the way decoders do it.
+				uint32_t steps = static_cast<uint32_t>(interpolationSteps);
+				uint32_t step = entry == 0 ? 0 : (entry == 1 ? steps : entry - 1);
+				value = static_cast<float>(((steps - step) * endpoint0 + step * endpoint1) / steps);
+			}
+			else
+			{
+				value = entry == 6 ? 0.0f : 255.0f;
+			}
+
+			palette.colors[entry][channel] = value;
+			indexWeights[entry] = weight;
+		}
+	}
+
+	static Bc4Candidate EvaluateBc4Endpoints(const BlockPixels& block, uint32_t channel, uint8_t endpoint0, uint8_t endpoint1)
+	{
+		float weights[4]{};
+		weights[channel] = 1.0f;
+
+		BlockPalette palette{};
+		float indexWeights[8];
+		BuildBc4Palette(endpoint0, endpoint1, channel, palette, indexWeights);
+
+		// Other channels are zero in the palette, and their weight is zero as well.
+		Bc4Candidate candidate{};
+		candidate.endpoint0 = endpoint0;
+		candidate.endpoint1 = endpoint1;
+
+		float errors[BLOCK_PIXEL_COUNT];
+		SelectIndices(block, palette, weights, candidate.indices, errors);
+		candidate.error = SumErrors(errors, ALL_PIXELS_MASK);
+		return candidate;
+	}
+
+	static uint8_t RoundToByte(float value)
+	{
+		return static_cast<uint8_t>(std::clamp(value + 0.5f, 0.0f, 255.0f));
+	}
+
+	static void EncodeBc4Channel(const BlockPixels& block, uint32_t channel, uint8_t* output, BcEncodeQuality quality)
+	{
+		const float* values = block.channels[channel];
+
+		float minimum = *std::min_element(values, values + BLOCK_PIXEL_COUNT);
+		float maximum = *std::max_element(values, values + BLOCK_PIXEL_COUNT);
+
+		uint8_t high = RoundToByte(maximum);
+		uint8_t low = RoundToByte(minimum);
+
+		Bc4Candidate best{};
+		if (high == low)
+		{
+			// Flat block: equal endpoints, every index points at endpoint 0.
+			best.endpoint0 = high;
+			best.endpoint1 = low;
+			best.error = 0.0f;
+		}
+		else
+		{
+			best = EvaluateBc4Endpoints(block, channel, high, low);
+		}
+
+		if (quality == BcEncodeQuality::HIGH && best.error > 0.0f)
+		{
+			// Eight value mode, refined.
+			float indexWeights[8];
+			BlockPalette palette{};
+			for (uint32_t iteration = 0; iteration < 2; iteration++)
+			{
+				BuildBc4Palette(best.endpoint0, best.endpoint1, channel, palette, indexWeights);
+
+				BlockColor endpoint0{};
+				BlockColor endpoint1{};
+				if (!RefineEndpointsLeastSquares(block, ALL_PIXELS_MASK, 4, best.indices, indexWeights, endpoint0, endpoint1))
+					break;
+
+				uint8_t refined0 = RoundToByte(endpoint0.values[channel]);
+				uint8_t refined1 = RoundToByte(endpoint1.values[channel]);
+				if (refined0 == refined1)
+					break;
+				if (refined0 < refined1)
+					std::swap(refined0, refined1);
+
+				Bc4Candidate refined = EvaluateBc4Endpoints(block, channel, refined0, refined1);
+				if (refined.error >= best.error)
+					break;
+				best = refined;
+			}
+
+			// Six value mode, which spends its interpolants between the values that aren't already 0 or 255.
+			float innerMinimum = 255.0f;
+			float innerMaximum = 0.0f;
+			for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			{
+				if (values[pixel] > 0.0f && values[pixel] < 255.0f)
+				{
+					innerMinimum = std::min(innerMinimum, values[pixel]);
+					innerMaximum = std::max(innerMaximum, values[pixel]);
+				}
+			}
+
+			if (innerMinimum <= innerMaximum)
+			{
+				Bc4Candidate sixValues = EvaluateBc4Endpoints(block, channel, RoundToByte(innerMinimum), RoundToByte(innerMaximum));
+				if (sixValues.error < best.error)
+					best = sixValues;
+			}
+		}
+
+		uint64_t indexBits{ 0 };
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			indexBits |= static_cast<uint64_t>(best.indices[pixel]) << (pixel * 3);
+
+		output[0] = best.endpoint0;
+		output[1] = best.endpoint1;
+		for (uint32_t byte = 0; byte < 6; byte++)
+			output[2 + byte] = static_cast<uint8_t>(indexBits >> (byte * 8));
+	}
+
+	// BC7
+
+	class Bc7BlockWriter
+	{
+	public:
+
+		explicit Bc7BlockWriter(uint8_t* block)
+			: block(block)
+		{
+			std::memset(block, 0, 16);
+		}
+
+		void Write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t bit = 0; bit < bitCount; bit++, bitOffset++)
+			{
+				if (value & (1u << bit))
+					block[bitOffset >> 3] |= static_cast<uint8_t>(1u << (bitOffset & 7));
+			}
+		}
+
+	private:
+
+		uint8_t* block{ nullptr };
+		uint32_t bitOffset{ 0 };
+	};
+
+	constexpr uint32_t BC7_WEIGHTS_2[4]{ 0, 21, 43, 64 };
+	constexpr uint32_t BC7_WEIGHTS_3[8]{ 0, 9, 18, 27, 37, 46, 55, 64 };
+	constexpr uint32_t BC7_WEIGHTS_4[16]{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	constexpr uint32_t BC7_PARTITION_COUNT = 64;
+
+	// Two subset partitions, bit i set means pixel i belongs to subset 1.
+	constexpr uint16_t BC7_PARTITIONS_2[BC7_PARTITION_COUNT]
+	{
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+	};
+
+	// Anchor (fixed MSB = 0) pixel of subset 1, subset 0 always anchors at pixel 0.
+	constexpr uint8_t BC7_ANCHORS_2[BC7_PARTITION_COUNT]
+	{
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,
+		 2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,
+		 2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2,
+		15, 15, 15, 15, 15,  2,  2, 15,
+	};
+
+	// How many two subset partitions get the full (refined) treatment in the high quality mode.
+	constexpr uint32_t BC7_REFINED_PARTITION_COUNT = 4;
+
+	static uint32_t InterpolateBc7(uint32_t value0, uint32_t value1, uint32_t weight)
+	{
+		return ((64 - weight) * value0 + weight * value1 + 32) >> 6;
+	}
+
+	static void BuildBc7Palette(const uint32_t endpoint0[4], const uint32_t endpoint1[4], const uint32_t* weights, uint32_t weightCount, BlockPalette& palette)
+	{
+		palette.size = weightCount;
+		for (uint32_t entry = 0; entry < weightCount; entry++)
+		{
+			for (uint32_t channel = 0; channel < 4; channel++)
+				palette.colors[entry][channel] = static_cast<float>(InterpolateBc7(endpoint0[channel], endpoint1[channel], weights[entry]));
+		}
+	}
+
+	// Mode 6: one subset, RGBA 7.7.7.7 endpoints with a P-bit each, 4-bit indices.
+
+	struct Bc7Mode6Candidate
+	{
+		uint32_t endpoints[2][4]{};
+		uint32_t pBits[2]{};
+		uint8_t indices[BLOCK_PIXEL_COUNT]{};
+		float error{ FLT_MAX };
+	};
+
+	static void QuantizeBc7Mode6Endpoint(const BlockColor& endpoint, uint32_t pBit, uint32_t quantized[4])
+	{
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			int32_t value = static_cast<int32_t>((endpoint.values[channel] - static_cast<float>(pBit)) * 0.5f + 0.5f);
+			quantized[channel] = static_cast<uint32_t>(std::clamp(value, 0, 127));
+		}
+	}
+
+	static float QuantizationError(const BlockColor& endpoint, const uint32_t quantized[4], uint32_t pBit, const float weights[4])
+	{
+		float error = 0.0f;
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			float difference = endpoint.values[channel] - static_cast<float>((quantized[channel] << 1) | pBit);
+			error += difference * difference * weights[channel];
+		}
+		return error;
+	}
+
+	static Bc7Mode6Candidate EvaluateBc7Mode6(
+		const BlockPixels& block, const BlockColor& endpoint0, const BlockColor& endpoint1,
+		const float weights[4], BcEncodeQuality quality)
+	{
+		const BlockColor* endpoints[2]{ &endpoint0, &endpoint1 };
+
+		// Fast mode picks each P-bit by itself, high quality tries all four combinations.
+		uint32_t pBitCombinations[4][2]{ { 0, 0 }, { 0, 1 }, { 1, 0 }, { 1, 1 } };
+		uint32_t combinationCount{ 4 };
+
+		if (quality == BcEncodeQuality::FAST)
+		{
+			for (uint32_t endpoint = 0; endpoint < 2; endpoint++)
+			{
+				uint32_t quantized0[4];
+				uint32_t quantized1[4];
+				QuantizeBc7Mode6Endpoint(*endpoints[endpoint], 0, quantized0);
+				QuantizeBc7Mode6Endpoint(*endpoints[endpoint], 1, quantized1);
+
+				pBitCombinations[0][endpoint] =
+					QuantizationError(*endpoints[endpoint], quantized1, 1, weights) <
+					QuantizationError(*endpoints[endpoint], quantized0, 0, weights) ? 1 : 0;
+			}
+			combinationCount = 1;
+		}
+
+		Bc7Mode6Candidate best{};
+		for (uint32_t combination = 0; combination < combinationCount; combination++)
+		{
+			Bc7Mode6Candidate candidate{};
+			uint32_t decoded[2][4];
+
+			for (uint32_t endpoint = 0; endpoint < 2; endpoint++)
+			{
+				candidate.pBits[endpoint] = pBitCombinations[combination][endpoint];
+				QuantizeBc7Mode6Endpoint(*endpoints[endpoint], candidate.pBits[endpoint], candidate.endpoints[endpoint]);
+
+				for (uint32_t channel = 0; channel < 4; channel++)
+					decoded[endpoint][channel] = (candidate.endpoints[endpoint][channel] << 1) | candidate.pBits[endpoint];
+			}
+
+			BlockPalette palette{};
+			BuildBc7Palette(decoded[0], decoded[1], BC7_WEIGHTS_4, 16, palette);
+
+			float errors[BLOCK_PIXEL_COUNT];
+			SelectIndices(block, palette, weights, candidate.indices, errors);
+			candidate.error = SumErrors(errors, ALL_PIXELS_MASK);
+
+			if (candidate.error < best.error)
+				best = candidate;
+		}
+		return best;
+	}
+
+	static void WriteBc7Mode6(Bc7Mode6Candidate candidate, uint8_t* block)
+	{
+		// The anchor index is stored without its MSB, so it must be in the lower half of the range.
+		if (candidate.indices[0] & 8)
+		{
+			std::swap(candidate.endpoints[0], candidate.endpoints[1]);
+			std::swap(candidate.pBits[0], candidate.pBits[1]);
+			for (uint8_t& index : candidate.indices)
+				index = static_cast<uint8_t>(15 - index);
+		}
+
+		Bc7BlockWriter writer{ block };
+		writer.Write(1u << 6, 7);
+
+		for (uint32_t channel = 0; channel < 4; channel++)
+		{
+			writer.Write(candidate.endpoints[0][channel], 7);
+			writer.Write(candidate.endpoints[1][channel], 7);
+		}
+
+		writer.Write(candidate.pBits[0], 1);
+		writer.Write(candidate.pBits[1], 1);
+
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			writer.Write(candidate.indices[pixel], pixel == 0 ? 3 : 4);
+	}
+
+	static Bc7Mode6Candidate EncodeBc7Mode6(const BlockPixels& block, const float weights[4], uint32_t channelCount, BcEncodeQuality quality)
+	{
+		BlockColor endpoint0{};
+		BlockColor endpoint1{};
+		FitEndpoints(block, ALL_PIXELS_MASK, channelCount, quality, endpoint0, endpoint1);
+
+		// Opaque blocks leave the alpha channel out of the fit, it still has to end up as 255.
+		if (channelCount == 3)
+		{
+			endpoint0.values[3] = 255.0f;
+			endpoint1.values[3] = 255.0f;
+		}
+
+		Bc7Mode6Candidate best = EvaluateBc7Mode6(block, endpoint0, endpoint1, weights, quality);
+
+		if (quality == BcEncodeQuality::HIGH)
+		{
+			float indexWeights[16];
+			for (uint32_t index = 0; index < 16; index++)
+				indexWeights[index] = static_cast<float>(BC7_WEIGHTS_4[index]) / 64.0f;
+
+			for (uint32_t iteration = 0; iteration < 2 && best.error > 0.0f; iteration++)
+			{
+				if (!RefineEndpointsLeastSquares(block, ALL_PIXELS_MASK, channelCount, best.indices, indexWeights, endpoint0, endpoint1))
+					break;
+
+				Bc7Mode6Candidate refined = EvaluateBc7Mode6(block, endpoint0, endpoint1, weights, quality);
+				if (refined.error >= best.error)
+					break;
+				best = refined;
+			}
+		}
+
+		return best;
+	}
+
+	// Mode 1: two subsets, RGB 6.6.6 endpoints with one shared P-bit per subset, 3-bit indices.
+
+	struct Bc7Mode1Candidate
+	{
+		uint32_t partition{ 0 };
+		uint32_t endpoints[2][2][3]{};
+		uint32_t pBits[2]{};
+		uint8_t indices[BLOCK_PIXEL_COUNT]{};
+		float error{ FLT_MAX };
+	};
+
+	static uint32_t DecodeBc7Mode1Value(uint32_t quantized, uint32_t pBit)
+	{
+		uint32_t value7 = (quantized << 1) | pBit;
+		return (value7 << 1) | (value7 >> 6);
+	}
+
+	static uint32_t QuantizeBc7Mode1Value(float value, uint32_t pBit)
+	{
+		// 8-bit -> 7-bit is not a plain shift here, so check the neighbours of the estimate.
+		int32_t estimate = static_cast<int32_t>((value * (127.0f / 255.0f) - static_cast<float>(pBit)) * 0.5f + 0.5f);
+
+		uint32_t best{ 0 };
+		float bestError = FLT_MAX;
+		for (int32_t candidate = estimate - 1; candidate <= estimate + 1; candidate++)
+		{
+			if (candidate < 0 || candidate > 63)
+				continue;
+
+			float error = std::fabs(static_cast<float>(DecodeBc7Mode1Value(static_cast<uint32_t>(candidate), pBit)) - value);
+			if (error < bestError)
+			{
+				bestError = error;
+				best = static_cast<uint32_t>(candidate);
+			}
+		}
+		return best;
+	}
+
+	static float EvaluateBc7Mode1Subset(
+		const BlockPixels& block, uint16_t mask, const BlockColor& endpoint0, const BlockColor& endpoint1,
+		const float weights[4], uint32_t quantized[2][3], uint32_t& pBit, uint8_t indices[BLOCK_PIXEL_COUNT])
+	{
+		float bestError = FLT_MAX;
+
+		for (uint32_t pBitCandidate = 0; pBitCandidate < 2; pBitCandidate++)
+		{
+			uint32_t candidateQuantized[2][3];
+			uint32_t decoded[2][4];
+			const BlockColor* endpoints[2]{ &endpoint0, &endpoint1 };
+
+			for (uint32_t endpoint = 0; endpoint < 2; endpoint++)
+			{
+				for (uint32_t channel = 0; channel < 3; channel++)
+				{
+					candidateQuantized[endpoint][channel] = QuantizeBc7Mode1Value(endpoints[endpoint]->values[channel], pBitCandidate);
+					decoded[endpoint][channel] = DecodeBc7Mode1Value(candidateQuantized[endpoint][channel], pBitCandidate);
+				}
+				decoded[endpoint][3] = 255;
+			}
+
+			BlockPalette palette{};
+			BuildBc7Palette(decoded[0], decoded[1], BC7_WEIGHTS_3, 8, palette);
+
+			uint8_t candidateIndices[BLOCK_PIXEL_COUNT];
+			float errors[BLOCK_PIXEL_COUNT];
+			SelectIndices(block, palette, weights, candidateIndices, errors);
+
+			float error = SumErrors(errors, mask);
+			if (error < bestError)
+			{
+				bestError = error;
+				pBit = pBitCandidate;
+				std::memcpy(quantized, candidateQuantized, sizeof(candidateQuantized));
+				for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+				{
+					if (mask & (1u << pixel))
+						indices[pixel] = candidateIndices[pixel];
+				}
+			}
+		}
+
+		return bestError;
+	}
+
+	static Bc7Mode1Candidate EncodeBc7Mode1Partition(const BlockPixels& block, uint32_t partition, const float weights[4])
+	{
+		Bc7Mode1Candidate candidate{};
+		candidate.partition = partition;
+		candidate.error = 0.0f;
+
+		float indexWeights[8];
+		for (uint32_t index = 0; index < 8; index++)
+			indexWeights[index] = static_cast<float>(BC7_WEIGHTS_3[index]) / 64.0f;
+
+		for (uint32_t subset = 0; subset < 2; subset++)
+		{
+			uint16_t mask = subset == 0 ? static_cast<uint16_t>(~BC7_PARTITIONS_2[partition]) : BC7_PARTITIONS_2[partition];
+
+			BlockColor endpoint0{};
+			BlockColor endpoint1{};
+			FitEndpointsPrincipalAxis(block, mask, 3, endpoint0, endpoint1);
+
+			float error = EvaluateBc7Mode1Subset(
+				block, mask, endpoint0, endpoint1, weights,
+				candidate.endpoints[subset], candidate.pBits[subset], candidate.indices);
+
+			for (uint32_t iteration = 0; iteration < 2 && error > 0.0f; iteration++)
+			{
+				if (!RefineEndpointsLeastSquares(block, mask, 3, candidate.indices, indexWeights, endpoint0, endpoint1))
+					break;
+
+				uint32_t quantized[2][3];
+				uint32_t pBit{ 0 };
+				uint8_t indices[BLOCK_PIXEL_COUNT];
+				std::memcpy(indices, candidate.indices, sizeof(indices));
+
+				float refinedError = EvaluateBc7Mode1Subset(block, mask, endpoint0, endpoint1, weights, quantized, pBit, indices);
+				if (refinedError >= error)
+					break;
+
+				error = refinedError;
+				std::memcpy(candidate.endpoints[subset], quantized, sizeof(quantized));
+				candidate.pBits[subset] = pBit;
+				std::memcpy(candidate.indices, indices, sizeof(indices));
+			}
+
+			candidate.error += error;
+		}
+
+		return candidate;
+	}
+
+	// Cheap estimate used to rank the partitions: unquantized principal axis endpoints.
+	static float EstimateBc7Mode1PartitionError(const BlockPixels& block, uint32_t partition, const float weights[4])
+	{
+		float totalError = 0.0f;
+
+		for (uint32_t subset = 0; subset < 2; subset++)
+		{
+			uint16_t mask = subset == 0 ? static_cast<uint16_t>(~BC7_PARTITIONS_2[partition]) : BC7_PARTITIONS_2[partition];
+
+			BlockColor endpoint0{};
+			BlockColor endpoint1{};
+			FitEndpointsPrincipalAxis(block, mask, 3, endpoint0, endpoint1);
+
+			BlockPalette palette{};
+			palette.size = 8;
+			for (uint32_t entry = 0; entry < 8; entry++)
+			{
+				float weight = static_cast<float>(BC7_WEIGHTS_3[entry]) / 64.0f;
+				for (uint32_t channel = 0; channel < 3; channel++)
+				{
+					palette.colors[entry][channel] = endpoint0.values[channel] +
+						(endpoint1.values[channel] - endpoint0.values[channel]) * weight;
+				}
+				palette.colors[entry][3] = 255.0f;
+			}
+
+			uint8_t indices[BLOCK_PIXEL_COUNT];
+			float errors[BLOCK_PIXEL_COUNT];
+			SelectIndices(block, palette, weights, indices, errors);
+			totalError += SumErrors(errors, mask);
+		}
+
+		return totalError;
+	}
+
+	static void WriteBc7Mode1(Bc7Mode1Candidate candidate, uint8_t* block)
+	{
+		uint16_t partitionMask = BC7_PARTITIONS_2[candidate.partition];
+		uint32_t anchors[2]{ 0, BC7_ANCHORS_2[candidate.partition] };
+
+		for (uint32_t subset = 0; subset < 2; subset++)
+		{
+			if (!(candidate.indices[anchors[subset]] & 4))
+				continue;
+
+			std::swap(candidate.endpoints[subset][0], candidate.endpoints[subset][1]);
+			for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			{
+				uint32_t pixelSubset = (partitionMask >> pixel) & 1;
+				if (pixelSubset == subset)
+					candidate.indices[pixel] = static_cast<uint8_t>(7 - candidate.indices[pixel]);
+			}
+		}
+
+		Bc7BlockWriter writer{ block };
+		writer.Write(1u << 1, 2);
+		writer.Write(candidate.partition, 6);
+
+		for (uint32_t channel = 0; channel < 3; channel++)
+		{
+			for (uint32_t subset = 0; subset < 2; subset++)
+			{
+				writer.Write(candidate.endpoints[subset][0][channel], 6);
+				writer.Write(candidate.endpoints[subset][1][channel], 6);
+			}
+		}
+
+		writer.Write(candidate.pBits[0], 1);
+		writer.Write(candidate.pBits[1], 1);
+
+		for (uint32_t pixel = 0; pixel < BLOCK_PIXEL_COUNT; pixel++)
+			writer.Write(candidate.indices[pixel], pixel == anchors[0] || pixel == anchors[1] ? 2 : 3);
+	}
+
+	// Block entry points
+
+	void EncodeBc1Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality)
+	{
+		BlockPixels blockPixels;
+		LoadBlockPixels(pixels, blockPixels);
+		EncodeBc1Color(blockPixels, block, quality);
+	}
+
+	void EncodeBc3Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality)
+	{
+		BlockPixels blockPixels;
+		LoadBlockPixels(pixels, blockPixels);
+		EncodeBc4Channel(blockPixels, 3, block, quality);
+		EncodeBc1Color(blockPixels, block + 8, quality);
+	}
+
+	void EncodeBc4Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality)
+	{
+		BlockPixels blockPixels;
+		LoadBlockPixels(pixels, blockPixels);
+		EncodeBc4Channel(blockPixels, 0, block, quality);
+	}
+
+	void EncodeBc5Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality)
+	{
+		BlockPixels blockPixels;
+		LoadBlockPixels(pixels, blockPixels);
+		EncodeBc4Channel(blockPixels, 0, block, quality);
+		EncodeBc4Channel(blockPixels, 1, block + 8, quality);
+	}
+
+	void EncodeBc7Block(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality)
+	{
+		BlockPixels blockPixels;
+		LoadBlockPixels(pixels, blockPixels);
+
+		bool opaque = std::all_of(blockPixels.channels[3], blockPixels.channels[3] + BLOCK_PIXEL_COUNT,
+			[](float alpha) { return alpha == 255.0f; });
+
+		// Alpha keeps its weight for opaque blocks too, a mode 6 P-bit of 0 can't reach 255.
+		const float weights[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+		Bc7Mode6Candidate mode6 = EncodeBc7Mode6(blockPixels, weights, opaque ? 3 : 4, quality);
+
+		// Mode 1 has no alpha, so only opaque blocks can use it.
+		if (quality == BcEncodeQuality::FAST || !opaque || mode6.error == 0.0f)
+		{
+			WriteBc7Mode6(mode6, block);
+			return;
+		}
+
+		std::pair<float, uint32_t> partitionErrors[BC7_PARTITION_COUNT];
+		for (uint32_t partition = 0; partition < BC7_PARTITION_COUNT; partition++)
+			partitionErrors[partition] = { EstimateBc7Mode1PartitionError(blockPixels, partition, weights), partition };
+
+		std::partial_sort(
+			partitionErrors, partitionErrors + BC7_REFINED_PARTITION_COUNT, partitionErrors + BC7_PARTITION_COUNT);
+
+		Bc7Mode1Candidate bestMode1{};
+		for (uint32_t candidate = 0; candidate < BC7_REFINED_PARTITION_COUNT; candidate++)
+		{
+			Bc7Mode1Candidate mode1 = EncodeBc7Mode1Partition(blockPixels, partitionErrors[candidate].second, weights);
+			if (mode1.error < bestMode1.error)
+				bestMode1 = mode1;
+		}
+
+		if (bestMode1.error < mode6.error)
+			WriteBc7Mode1(bestMode1, block);
+		else
+			WriteBc7Mode6(mode6, block);
+	}
+
+	// Images
+
+	bool IsBcEncodeFormatSupported(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::BC1_UNORM:
+		case TextureFormat::BC1_UNORM_SRGB:
+		case TextureFormat::BC3_UNORM:
+		case TextureFormat::BC3_UNORM_SRGB:
+		case TextureFormat::BC4_UNORM:
+		case TextureFormat::BC5_UNORM:
+		case TextureFormat::BC7_UNORM:
+		case TextureFormat::BC7_UNORM_SRGB:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	using EncodeBlockFunction = void(*)(const uint8_t* pixels, uint8_t* block, BcEncodeQuality quality);
+
+	static EncodeBlockFunction GetEncodeBlockFunction(TextureFormat format)
+	{
+		switch (GetLinearTextureFormat(format))
+		{
+		case TextureFormat::BC1_UNORM: return EncodeBc1Block;
+		case TextureFormat::BC3_UNORM: return EncodeBc3Block;
+		case TextureFormat::BC4_UNORM: return EncodeBc4Block;
+		case TextureFormat::BC5_UNORM: return EncodeBc5Block;
+		case TextureFormat::BC7_UNORM: return EncodeBc7Block;
+		default:                       return nullptr;
+		}
+	}
+
+	static void EncodeBlockRow(
+		const Image& image, uint32_t blockRow, EncodeBlockFunction encodeBlock,
+		uint32_t bytesPerBlock, BcEncodeQuality quality, uint8_t* output)
+	{
+		uint32_t blocksWide = (image.width + 3) / 4;
+		uint8_t pixels[BLOCK_PIXEL_COUNT * IMAGE_BYTES_PER_PIXEL];
+
+		for (uint32_t blockColumn = 0; blockColumn < blocksWide; blockColumn++)
+		{
+			for (uint32_t y = 0; y < 4; y++)
+			{
+				uint32_t sourceY = std::min(blockRow * 4 + y, image.height - 1);
+				for (uint32_t x = 0; x < 4; x++)
+				{
+					uint32_t sourceX = std::min(blockColumn * 4 + x, image.width - 1);
+					std::memcpy(&pixels[(y * 4 + x) * IMAGE_BYTES_PER_PIXEL], image.GetPixel(sourceX, sourceY), IMAGE_BYTES_PER_PIXEL);
+				}
+			}
+
+			encodeBlock(pixels, output + static_cast<uint64_t>(blockColumn) * bytesPerBlock, quality);
+		}
+	}
+
+	static std::vector<uint8_t> EncodeBcImages(const std::vector<const Image*>& images, const BcEncodeSettings& settings, ThreadPool* threadPool)
+	{
+		if (!IsBcEncodeFormatSupported(settings.format))
+			throw Error{ "Texture format can't be block-compressed by the engine!" };
+
+		EncodeBlockFunction encodeBlock = GetEncodeBlockFunction(settings.format);
+		uint32_t bytesPerBlock = GetTextureFormatInfo(settings.format).bytesPerBlock;
+
+		// Flatten the block rows of every image, so that one ParallelFor covers all of them.
+		struct BlockRowJob
+		{
+			const Image* image;
+			uint32_t blockRow;
+			uint64_t outputOffset;
+		};
+
+		std::vector<BlockRowJob> jobs;
+		uint64_t outputSize{ 0 };
+
+		for (const Image* image : images)
+		{
+			if (image->width == 0 || image->height == 0 || image->pixels.size() < image->GetSizeInBytes())
+				throw Error{ "Image passed to the block compressor is empty or too small!" };
+
+			uint64_t rowSize = static_cast<uint64_t>((image->width + 3) / 4) * bytesPerBlock;
+			uint32_t blocksHigh = (image->height + 3) / 4;
+
+			for (uint32_t blockRow = 0; blockRow < blocksHigh; blockRow++)
+			{
+				jobs.push_back({ image, blockRow, outputSize });
+				outputSize += rowSize;
+			}
+		}
+
+		std::vector<uint8_t> output(outputSize);
+
+		auto encodeRows = [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t job = begin; job < end; job++)
+			{
+				EncodeBlockRow(
+					*jobs[job].image, jobs[job].blockRow, encodeBlock, bytesPerBlock,
+					settings.quality, output.data() + jobs[job].outputOffset);
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(jobs.size()), 1, encodeRows);
+
+		return output;
+	}
+
+	std::vector<uint8_t> EncodeBcImage(const Image& image, const BcEncodeSettings& settings, ThreadPool* threadPool)
+	{
+		return EncodeBcImages({ &image }, settings, threadPool);
+	}
+
+	std::vector<uint8_t> EncodeBcMipChain(const std::vector<Image>& mips, const BcEncodeSettings& settings, ThreadPool* threadPool)
+	{
+		std::vector<const Image*> images;
+		images.reserve(mips.size());
+		for (const Image& mip : mips)
+			images.push_back(&mip);
+
+		return EncodeBcImages(images, settings, threadPool);
+	}
+}
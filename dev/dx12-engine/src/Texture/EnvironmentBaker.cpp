@@ -0,0 +1,651 @@
+#include "Texture/EnvironmentBaker.h"
+
+#include "Core/Error.h"
+#include "Core/MathUtility.h"
+#include "Core/Simd.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/Color.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+namespace dxe
+{
+	constexpr float PI = 3.14159265358979f;
+
+	constexpr uint32_t ROW_GRAIN_SIZE = 4;
+
+	// FloatCubemap
+
+	uint32_t FloatCubemap::GetMipSize(uint32_t mip) const
+	{
+		return std::max(size >> mip, 1u);
+	}
+
+	float* FloatCubemap::GetSurface(uint32_t mip, uint32_t face)
+	{
+		return surfaces[CalculateSubresourceIndex(mip, face, mipLevels)].data();
+	}
+	const float* FloatCubemap::GetSurface(uint32_t mip, uint32_t face) const
+	{
+		return surfaces[CalculateSubresourceIndex(mip, face, mipLevels)].data();
+	}
+
+	FloatCubemap CreateFloatCubemap(uint32_t size, uint32_t mipLevels)
+	{
+		if (size == 0 || mipLevels == 0 || mipLevels > CalculateFullMipChainLength(size, size))
+			throw Error{ "Invalid cube map size or mip level count!" };
+
+		FloatCubemap cubemap{};
+		cubemap.size = size;
+		cubemap.mipLevels = mipLevels;
+		cubemap.surfaces.resize(CUBEMAP_FACE_COUNT * mipLevels);
+
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			for (uint32_t mip = 0; mip < mipLevels; mip++)
+			{
+				uint32_t mipSize = cubemap.GetMipSize(mip);
+				cubemap.surfaces[CalculateSubresourceIndex(mip, face, mipLevels)].resize(static_cast<size_t>(mipSize) * mipSize * 4);
+			}
+		}
+
+		return cubemap;
+	}
+
+	static void ValidateCubemap(const FloatCubemap& cubemap)
+	{
+		if (cubemap.size == 0 || cubemap.mipLevels == 0 || cubemap.surfaces.size() != CUBEMAP_FACE_COUNT * cubemap.mipLevels)
+			throw Error{ "Cube map doesn't have a surface for every face and mip!" };
+	}
+
+	// Directions
+
+	XMFLOAT3 GetCubemapDirection(uint32_t face, float u, float v)
+	{
+		float s = 2.0f * u - 1.0f;
+		float t = 2.0f * v - 1.0f;
+
+		switch (face)
+		{
+		case 0: return Normalize(XMFLOAT3{ 1.0f, -t, -s });
+		case 1: return Normalize(XMFLOAT3{ -1.0f, -t, s });
+		case 2: return Normalize(XMFLOAT3{ s, 1.0f, t });
+		case 3: return Normalize(XMFLOAT3{ s, -1.0f, -t });
+		case 4: return Normalize(XMFLOAT3{ s, -t, 1.0f });
+		default: return Normalize(XMFLOAT3{ -s, -t, -1.0f });
+		}
+	}
+
+	void GetCubemapFaceUv(const XMFLOAT3& direction, uint32_t& face, float& u, float& v)
+	{
+		float absX = std::abs(direction.x);
+		float absY = std::abs(direction.y);
+		float absZ = std::abs(direction.z);
+
+		float majorAxis{ 0.0f };
+		float s{ 0.0f };
+		float t{ 0.0f };
+
+		if (absX >= absY && absX >= absZ)
+		{
+			face = direction.x > 0.0f ? 0 : 1;
+			majorAxis = absX;
+			s = direction.x > 0.0f ? -direction.z : direction.z;
+			t = -direction.y;
+		}
+		else if (absY >= absZ)
+		{
+			face = direction.y > 0.0f ? 2 : 3;
+			majorAxis = absY;
+			s = direction.x;
+			t = direction.y > 0.0f ? direction.z : -direction.z;
+		}
+		else
+		{
+			face = direction.z > 0.0f ? 4 : 5;
+			majorAxis = absZ;
+			s = direction.z > 0.0f ? direction.x : -direction.x;
+			t = -direction.y;
+		}
+
+		u = 0.5f * (s / majorAxis + 1.0f);
+		v = 0.5f * (t / majorAxis + 1.0f);
+	}
+
+	// Solid angle of the face area from the face center to (x, y), in [-1, 1] face coordinates.
+	static double CalculateAreaElement(double x, double y)
+	{
+		return std::atan2(x * y, std::sqrt(x * x + y * y + 1.0));
+	}
+
+	float CalculateCubemapTexelSolidAngle(uint32_t x, uint32_t y, uint32_t size)
+	{
+		// In double, small texels' solid angles are differences of nearly equal area elements.
+		double x0 = 2.0 * x / size - 1.0;
+		double y0 = 2.0 * y / size - 1.0;
+		double x1 = 2.0 * (x + 1) / size - 1.0;
+		double y1 = 2.0 * (y + 1) / size - 1.0;
+
+		return static_cast<float>(CalculateAreaElement(x0, y0) - CalculateAreaElement(x0, y1) -
+			CalculateAreaElement(x1, y0) + CalculateAreaElement(x1, y1));
+	}
+
+	// Sampling
+
+	static Color4 SampleSurface(const float* surface, uint32_t size, float u, float v)
+	{
+		float maxCoordinate = static_cast<float>(size - 1);
+		float x = std::clamp(u * size - 0.5f, 0.0f, maxCoordinate);
+		float y = std::clamp(v * size - 0.5f, 0.0f, maxCoordinate);
+
+		uint32_t x0 = static_cast<uint32_t>(x);
+		uint32_t y0 = static_cast<uint32_t>(y);
+		uint32_t x1 = std::min(x0 + 1, size - 1);
+		uint32_t y1 = std::min(y0 + 1, size - 1);
+
+		const float* row0 = surface + static_cast<size_t>(y0) * size * 4;
+		const float* row1 = surface + static_cast<size_t>(y1) * size * 4;
+
+		Color4 top = LerpColors(LoadColor(row0 + x0 * 4), LoadColor(row0 + x1 * 4), x - x0);
+		Color4 bottom = LerpColors(LoadColor(row1 + x0 * 4), LoadColor(row1 + x1 * 4), x - x0);
+		return LerpColors(top, bottom, y - y0);
+	}
+
+	static Color4 SampleCubemapColor(const FloatCubemap& cubemap, const XMFLOAT3& direction, float lod)
+	{
+		uint32_t face{ 0 };
+		float u{ 0.0f };
+		float v{ 0.0f };
+		GetCubemapFaceUv(direction, face, u, v);
+
+		lod = std::clamp(lod, 0.0f, static_cast<float>(cubemap.mipLevels - 1));
+		uint32_t mip0 = static_cast<uint32_t>(lod);
+		uint32_t mip1 = std::min(mip0 + 1, cubemap.mipLevels - 1);
+
+		Color4 color0 = SampleSurface(cubemap.GetSurface(mip0, face), cubemap.GetMipSize(mip0), u, v);
+		if (mip1 == mip0 || lod == static_cast<float>(mip0))
+			return color0;
+
+		Color4 color1 = SampleSurface(cubemap.GetSurface(mip1, face), cubemap.GetMipSize(mip1), u, v);
+		return LerpColors(color0, color1, lod - mip0);
+	}
+
+	XMFLOAT4 SampleCubemap(const FloatCubemap& cubemap, const XMFLOAT3& direction, float lod)
+	{
+		ValidateCubemap(cubemap);
+
+		XMFLOAT4 color{};
+		StoreColor(&color.x, SampleCubemapColor(cubemap, Normalize(direction), lod));
+		return color;
+	}
+
+	// Mips
+
+	void GenerateCubemapMips(FloatCubemap& cubemap, uint32_t mipLevels, ThreadPool* threadPool)
+	{
+		ValidateCubemap(cubemap);
+
+		uint32_t fullMipLevels = CalculateFullMipChainLength(cubemap.size, cubemap.size);
+		if (mipLevels == 0)
+			mipLevels = fullMipLevels;
+		if (mipLevels > fullMipLevels)
+			throw Error{ "Cube map mip level count is larger than its full mip chain!" };
+
+		// Surfaces are face-major, so changing the mip count moves them around.
+		FloatCubemap mipped = CreateFloatCubemap(cubemap.size, mipLevels);
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			for (uint32_t mip = 0; mip < std::min(mipLevels, cubemap.mipLevels); mip++)
+				mipped.surfaces[CalculateSubresourceIndex(mip, face, mipLevels)].swap(cubemap.surfaces[CalculateSubresourceIndex(mip, face, cubemap.mipLevels)]);
+		}
+
+		for (uint32_t mip = cubemap.mipLevels; mip < mipLevels; mip++)
+		{
+			uint32_t sourceSize = mipped.GetMipSize(mip - 1);
+			uint32_t mipSize = mipped.GetMipSize(mip);
+
+			auto downsampleRows = [&](uint32_t begin, uint32_t end) {
+				for (uint32_t job = begin; job < end; job++)
+				{
+					uint32_t face = job / mipSize;
+					uint32_t y = job % mipSize;
+
+					const float* source = mipped.GetSurface(mip - 1, face);
+					float* destination = mipped.GetSurface(mip, face) + static_cast<size_t>(y) * mipSize * 4;
+
+					uint32_t sourceY0 = std::min(y * 2, sourceSize - 1);
+					uint32_t sourceY1 = std::min(y * 2 + 1, sourceSize - 1);
+
+					for (uint32_t x = 0; x < mipSize; x++)
+					{
+						uint32_t sourceX0 = std::min(x * 2, sourceSize - 1);
+						uint32_t sourceX1 = std::min(x * 2 + 1, sourceSize - 1);
+
+						Color4 sum = AddColors(
+							AddColors(LoadColor(source + (static_cast<size_t>(sourceY0) * sourceSize + sourceX0) * 4),
+								LoadColor(source + (static_cast<size_t>(sourceY0) * sourceSize + sourceX1) * 4)),
+							AddColors(LoadColor(source + (static_cast<size_t>(sourceY1) * sourceSize + sourceX0) * 4),
+								LoadColor(source + (static_cast<size_t>(sourceY1) * sourceSize + sourceX1) * 4)));
+
+						StoreColor(destination + x * 4, ScaleColor(sum, 0.25f));
+					}
+				}
+			};
+
+			ThreadPool::ParallelForOrInline(threadPool, 0, CUBEMAP_FACE_COUNT * mipSize, ROW_GRAIN_SIZE, downsampleRows);
+		}
+
+		cubemap = std::move(mipped);
+	}
+
+	// Sources
+
+	FloatCubemap ConvertEquirectangularToCubemap(const float* pixels, uint32_t width, uint32_t height,
+		uint32_t faceSize, ThreadPool* threadPool)
+	{
+		if (!pixels || width == 0 || height == 0)
+			throw Error{ "Equirectangular image is empty!" };
+
+		FloatCubemap cubemap = CreateFloatCubemap(faceSize);
+
+		auto convertRows = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t job = begin; job < end; job++)
+			{
+				uint32_t face = job / faceSize;
+				uint32_t y = job % faceSize;
+
+				float* destination = cubemap.GetSurface(0, face) + static_cast<size_t>(y) * faceSize * 4;
+
+				for (uint32_t x = 0; x < faceSize; x++)
+				{
+					XMFLOAT3 direction = GetCubemapDirection(face, (x + 0.5f) / faceSize, (y + 0.5f) / faceSize);
+
+					float longitude = std::atan2(-direction.z, direction.x) / (2.0f * PI);
+					float u = (longitude < 0.0f ? longitude + 1.0f : longitude) * width - 0.5f;
+					float v = std::acos(std::clamp(direction.y, -1.0f, 1.0f)) / PI * height - 0.5f;
+
+					// Wraps around horizontally, clamps at the poles.
+					float floorU = std::floor(u);
+					uint32_t x0 = static_cast<uint32_t>(static_cast<int64_t>(floorU) + width) % width;
+					uint32_t x1 = (x0 + 1) % width;
+					float y = std::clamp(v, 0.0f, static_cast<float>(height - 1));
+					uint32_t y0 = static_cast<uint32_t>(y);
+					uint32_t y1 = std::min(y0 + 1, height - 1);
+
+					const float* row0 = pixels + static_cast<size_t>(y0) * width * 4;
+					const float* row1 = pixels + static_cast<size_t>(y1) * width * 4;
+
+					Color4 top = LerpColors(LoadColor(row0 + x0 * 4), LoadColor(row0 + x1 * 4), u - floorU);
+					Color4 bottom = LerpColors(LoadColor(row1 + x0 * 4), LoadColor(row1 + x1 * 4), u - floorU);
+					StoreColor(destination + x * 4, LerpColors(top, bottom, y - y0));
+				}
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, CUBEMAP_FACE_COUNT * faceSize, ROW_GRAIN_SIZE, convertRows);
+		return cubemap;
+	}
+
+	FloatCubemap ConvertImagesToCubemap(const std::array<const Image*, CUBEMAP_FACE_COUNT>& faces)
+	{
+		if (!faces[0] || faces[0]->width != faces[0]->height)
+			throw Error{ "Cube map faces must be square!" };
+
+		FloatCubemap cubemap = CreateFloatCubemap(faces[0]->width);
+
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			const Image* image = faces[face];
+			if (!image || image->width != cubemap.size || image->height != cubemap.size)
+				throw Error{ "Cube map faces must all have the same size!" };
+
+			size_t pixelCount = static_cast<size_t>(image->width) * image->height;
+			if (IsTextureFormatSrgb(image->format))
+				ConvertSrgbUnorm8ToLinear(image->pixels.data(), cubemap.GetSurface(0, face), pixelCount);
+			else
+				ConvertUnorm8ToFloat(image->pixels.data(), cubemap.GetSurface(0, face), pixelCount * 4);
+		}
+
+		return cubemap;
+	}
+
+	// Specular prefiltering
+
+	struct PrefilterSample
+	{
+		// Tangent space, Z along the normal.
+		XMFLOAT3 direction{};
+		float lod{ 0.0f };
+		// Normalized over the sample set.
+		float weight{ 0.0f };
+	};
+
+	static float RadicalInverse(uint32_t bits)
+	{
+		bits = (bits << 16) | (bits >> 16);
+		bits = ((bits & 0x55555555u) << 1) | ((bits & 0xaaaaaaaau) >> 1);
+		bits = ((bits & 0x33333333u) << 2) | ((bits & 0xccccccccu) >> 2);
+		bits = ((bits & 0x0f0f0f0fu) << 4) | ((bits & 0xf0f0f0f0u) >> 4);
+		bits = ((bits & 0x00ff00ffu) << 8) | ((bits & 0xff00ff00u) >> 8);
+		return static_cast<float>(bits) * 2.3283064365386963e-10f;
+	}
+
+	static std::vector<PrefilterSample> CreatePrefilterSamples(float roughness, uint32_t sampleCount, float sourceTexelSolidAngle)
+	{
+		std::vector<PrefilterSample> samples;
+
+		float alpha = roughness * roughness;
+		float alphaSquared = alpha * alpha;
+		float weightSum{ 0.0f };
+
+		for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; sampleIndex++)
+		{
+			// Hammersley point, mapped to a GGX distributed half vector.
+			float phi = 2.0f * PI * (sampleIndex + 0.5f) / sampleCount;
+			float xi = RadicalInverse(sampleIndex);
+
+			float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (alphaSquared - 1.0f) * xi));
+			float sinTheta = std::sqrt(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+			XMFLOAT3 halfVector{ sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta };
+
+			// Reflect the view vector (the normal) around it.
+			XMFLOAT3 light{
+				2.0f * cosTheta * halfVector.x,
+				2.0f * cosTheta * halfVector.y,
+				2.0f * cosTheta * cosTheta - 1.0f };
+
+			if (light.z <= 0.0f)
+				continue;
+
+			// pdf(L) = D(H) * NdotH / (4 * VdotH), and NdotH == VdotH here.
+			float denominator = cosTheta * cosTheta * (alphaSquared - 1.0f) + 1.0f;
+			float distribution = alphaSquared / (PI * denominator * denominator);
+			float pdf = distribution * 0.25f;
+
+			// Read the mip whose texels cover about as much as this sample stands for.
+			float sampleSolidAngle = 1.0f / (sampleCount * pdf);
+			float lod = std::max(0.5f * std::log2(sampleSolidAngle / sourceTexelSolidAngle) + 1.0f, 0.0f);
+
+			samples.push_back(PrefilterSample{ light, lod, light.z });
+			weightSum += light.z;
+		}
+
+		for (PrefilterSample& sample : samples)
+			sample.weight /= weightSum;
+
+		return samples;
+	}
+
+	float GetPrefilteredRoughness(uint32_t mip, uint32_t mipLevels)
+	{
+		return mipLevels > 1 ? static_cast<float>(mip) / (mipLevels - 1) : 0.0f;
+	}
+
+	FloatCubemap PrefilterSpecular(const FloatCubemap& source, const SpecularPrefilterSettings& settings, ThreadPool* threadPool)
+	{
+		ValidateCubemap(source);
+		if (settings.sampleCount == 0)
+			throw Error{ "Specular prefiltering needs at least one sample!" };
+
+		FloatCubemap output = CreateFloatCubemap(settings.size, settings.mipLevels);
+
+		const FloatCubemap* mippedSource = &source;
+		FloatCubemap sourceCopy{};
+		if (source.mipLevels < CalculateFullMipChainLength(source.size, source.size))
+		{
+			sourceCopy = source;
+			GenerateCubemapMips(sourceCopy, 0, threadPool);
+			mippedSource = &sourceCopy;
+		}
+
+		float sourceTexelSolidAngle = 4.0f * PI / (CUBEMAP_FACE_COUNT * static_cast<float>(source.size) * source.size);
+
+		// Mip 0 is a mirror, one sample from the source mip matching the output size.
+		std::vector<std::vector<PrefilterSample>> mipSamples(settings.mipLevels);
+		for (uint32_t mip = 0; mip < settings.mipLevels; mip++)
+		{
+			float roughness = GetPrefilteredRoughness(mip, settings.mipLevels);
+			if (mip == 0 || roughness == 0.0f)
+			{
+				float lod = std::max(std::log2(static_cast<float>(source.size) / output.GetMipSize(mip)), 0.0f);
+				mipSamples[mip].push_back(PrefilterSample{ XMFLOAT3{ 0.0f, 0.0f, 1.0f }, lod, 1.0f });
+				continue;
+			}
+
+			mipSamples[mip] = CreatePrefilterSamples(roughness, settings.sampleCount, sourceTexelSolidAngle);
+		}
+
+		// One job per output row of every face and mip.
+		struct RowJob
+		{
+			uint32_t mip{ 0 };
+			uint32_t face{ 0 };
+			uint32_t y{ 0 };
+		};
+
+		std::vector<RowJob> jobs;
+		for (uint32_t mip = 0; mip < settings.mipLevels; mip++)
+		{
+			for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+			{
+				for (uint32_t y = 0; y < output.GetMipSize(mip); y++)
+					jobs.push_back(RowJob{ mip, face, y });
+			}
+		}
+
+		auto prefilterRows = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t jobIndex = begin; jobIndex < end; jobIndex++)
+			{
+				const RowJob& job = jobs[jobIndex];
+				const std::vector<PrefilterSample>& samples = mipSamples[job.mip];
+
+				uint32_t mipSize = output.GetMipSize(job.mip);
+				float* destination = output.GetSurface(job.mip, job.face) + static_cast<size_t>(job.y) * mipSize * 4;
+
+				for (uint32_t x = 0; x < mipSize; x++)
+				{
+					XMFLOAT3 normal = GetCubemapDirection(job.face, (x + 0.5f) / mipSize, (job.y + 0.5f) / mipSize);
+
+					XMFLOAT3 up = std::abs(normal.z) < 0.999f ? XMFLOAT3{ 0.0f, 0.0f, 1.0f } : XMFLOAT3{ 1.0f, 0.0f, 0.0f };
+					XMFLOAT3 tangent = Normalize(Cross(up, normal));
+					XMFLOAT3 bitangent = Cross(normal, tangent);
+
+					Color4 sum = ZeroColor();
+					for (const PrefilterSample& sample : samples)
+					{
+						XMFLOAT3 direction{
+							tangent.x * sample.direction.x + bitangent.x * sample.direction.y + normal.x * sample.direction.z,
+							tangent.y * sample.direction.x + bitangent.y * sample.direction.y + normal.y * sample.direction.z,
+							tangent.z * sample.direction.x + bitangent.z * sample.direction.y + normal.z * sample.direction.z };
+
+						sum = AddColors(sum, ScaleColor(SampleCubemapColor(*mippedSource, direction, sample.lod), sample.weight));
+					}
+
+					StoreColor(destination + x * 4, sum);
+				}
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(jobs.size()), 1, prefilterRows);
+		return output;
+	}
+
+	// Irradiance
+
+	FloatCubemap ConvolveIrradiance(const FloatCubemap& source, const IrradianceSettings& settings, ThreadPool* threadPool)
+	{
+		ValidateCubemap(source);
+
+		FloatCubemap output = CreateFloatCubemap(settings.size);
+
+		const FloatCubemap* mippedSource = &source;
+		FloatCubemap sourceCopy{};
+		if (source.mipLevels < CalculateFullMipChainLength(source.size, source.size))
+		{
+			sourceCopy = source;
+			GenerateCubemapMips(sourceCopy, 0, threadPool);
+			mippedSource = &sourceCopy;
+		}
+
+		uint32_t sourceMip{ 0 };
+		for (uint32_t mip = 1; mip < mippedSource->mipLevels; mip++)
+		{
+			int64_t distance = std::abs(static_cast<int64_t>(mippedSource->GetMipSize(mip)) - settings.sourceSize);
+			int64_t bestDistance = std::abs(static_cast<int64_t>(mippedSource->GetMipSize(sourceMip)) - settings.sourceSize);
+			if (distance < bestDistance)
+				sourceMip = mip;
+		}
+
+		// Every source texel as structure of arrays, colors premultiplied by the texel's solid angle.
+		// Padded to a multiple of 4 with zero texels.
+		uint32_t sourceSize = mippedSource->GetMipSize(sourceMip);
+		uint32_t texelCount = CUBEMAP_FACE_COUNT * sourceSize * sourceSize;
+		uint32_t paddedTexelCount = (texelCount + 3) & ~3u;
+
+		std::vector<float> texels(static_cast<size_t>(paddedTexelCount) * 6, 0.0f);
+		float* directionsX = texels.data();
+		float* directionsY = directionsX + paddedTexelCount;
+		float* directionsZ = directionsY + paddedTexelCount;
+		float* radianceR = directionsZ + paddedTexelCount;
+		float* radianceG = radianceR + paddedTexelCount;
+		float* radianceB = radianceG + paddedTexelCount;
+
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			const float* surface = mippedSource->GetSurface(sourceMip, face);
+			for (uint32_t y = 0; y < sourceSize; y++)
+			{
+				for (uint32_t x = 0; x < sourceSize; x++)
+				{
+					uint32_t texel = (face * sourceSize + y) * sourceSize + x;
+					XMFLOAT3 direction = GetCubemapDirection(face, (x + 0.5f) / sourceSize, (y + 0.5f) / sourceSize);
+					float solidAngle = CalculateCubemapTexelSolidAngle(x, y, sourceSize);
+					const float* color = surface + (static_cast<size_t>(y) * sourceSize + x) * 4;
+
+					directionsX[texel] = direction.x;
+					directionsY[texel] = direction.y;
+					directionsZ[texel] = direction.z;
+					radianceR[texel] = color[0] * solidAngle;
+					radianceG[texel] = color[1] * solidAngle;
+					radianceB[texel] = color[2] * solidAngle;
+				}
+			}
+		}
+
+		uint32_t size = settings.size;
+
+		auto convolveRows = [&](uint32_t begin, uint32_t end) {
+			for (uint32_t job = begin; job < end; job++)
+			{
+				uint32_t face = job / size;
+				uint32_t y = job % size;
+
+				float* destination = output.GetSurface(0, face) + static_cast<size_t>(y) * size * 4;
+
+				for (uint32_t x = 0; x < size; x++)
+				{
+					XMFLOAT3 normal = GetCubemapDirection(face, (x + 0.5f) / size, (y + 0.5f) / size);
+
+					float sums[3]{};
+					uint32_t texel{ 0 };
+
+#if SIMD_SSE2
+					__m128 normalX = _mm_set1_ps(normal.x);
+					__m128 normalY = _mm_set1_ps(normal.y);
+					__m128 normalZ = _mm_set1_ps(normal.z);
+					__m128 zero = _mm_setzero_ps();
+					__m128 sumR = zero;
+					__m128 sumG = zero;
+					__m128 sumB = zero;
+
+					for (; texel < paddedTexelCount; texel += 4)
+					{
+						__m128 cosine = _mm_add_ps(_mm_add_ps(
+							_mm_mul_ps(normalX, _mm_loadu_ps(directionsX + texel)),
+							_mm_mul_ps(normalY, _mm_loadu_ps(directionsY + texel))),
+							_mm_mul_ps(normalZ, _mm_loadu_ps(directionsZ + texel)));
+						cosine = _mm_max_ps(cosine, zero);
+
+						sumR = _mm_add_ps(sumR, _mm_mul_ps(cosine, _mm_loadu_ps(radianceR + texel)));
+						sumG = _mm_add_ps(sumG, _mm_mul_ps(cosine, _mm_loadu_ps(radianceG + texel)));
+						sumB = _mm_add_ps(sumB, _mm_mul_ps(cosine, _mm_loadu_ps(radianceB + texel)));
+					}
+
+					float lanes[4]{};
+					_mm_storeu_ps(lanes, sumR);
+					sums[0] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+					_mm_storeu_ps(lanes, sumG);
+					sums[1] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+					_mm_storeu_ps(lanes, sumB);
+					sums[2] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+					for (; texel < paddedTexelCount; texel++)
+					{
+						float cosine = std::max(normal.x * directionsX[texel] + normal.y * directionsY[texel] + normal.z * directionsZ[texel], 0.0f);
+						sums[0] += cosine * radianceR[texel];
+						sums[1] += cosine * radianceG[texel];
+						sums[2] += cosine * radianceB[texel];
+					}
+
+					float* pixel = destination + x * 4;
+					pixel[0] = sums[0] / PI;
+					pixel[1] = sums[1] / PI;
+					pixel[2] = sums[2] / PI;
+					pixel[3] = 1.0f;
+				}
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, CUBEMAP_FACE_COUNT * size, 1, convolveRows);
+		return output;
+	}
+
+	// Upload
+
+	CubemapUploadData CreateCubemapUploadData(const FloatCubemap& cubemap, TextureFormat format)
+	{
+		ValidateCubemap(cubemap);
+		if (format != TextureFormat::R16G16B16A16_FLOAT && format != TextureFormat::R32G32B32A32_FLOAT)
+			throw Error{ "Cube maps can only be uploaded as R16G16B16A16_FLOAT or R32G32B32A32_FLOAT!" };
+
+		CubemapUploadData uploadData{};
+		uploadData.desc.dimension = TextureDimension::TEXTURE_CUBE;
+		uploadData.desc.format = format;
+		uploadData.desc.width = cubemap.size;
+		uploadData.desc.height = cubemap.size;
+		uploadData.desc.mipLevels = cubemap.mipLevels;
+
+		uploadData.layout = CalculateTextureUploadLayout(uploadData.desc);
+		uploadData.data.resize(uploadData.layout.totalBytes);
+
+		for (uint32_t face = 0; face < CUBEMAP_FACE_COUNT; face++)
+		{
+			for (uint32_t mip = 0; mip < cubemap.mipLevels; mip++)
+			{
+				const TextureSubresourceFootprint& footprint =
+					uploadData.layout.footprints[CalculateSubresourceIndex(mip, face, cubemap.mipLevels)];
+
+				const float* surface = cubemap.GetSurface(mip, face);
+				size_t rowValueCount = static_cast<size_t>(footprint.width) * 4;
+
+				for (uint32_t row = 0; row < footprint.rowCount; row++)
+				{
+					uint8_t* destination = uploadData.data.data() + footprint.offset + static_cast<uint64_t>(row) * footprint.rowPitch;
+					const float* sourceRow = surface + row * rowValueCount;
+
+					if (format == TextureFormat::R16G16B16A16_FLOAT)
+						ConvertFloatToHalf(sourceRow, reinterpret_cast<uint16_t*>(destination), rowValueCount);
+					else
+						std::memcpy(destination, sourceRow, rowValueCount * sizeof(float));
+				}
+			}
+		}
+
+		return uploadData;
+	}
+}
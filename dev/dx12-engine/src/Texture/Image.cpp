@@ -0,0 +1,39 @@
+#include "Texture/Image.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	uint64_t Image::GetRowPitch() const
+	{
+		return static_cast<uint64_t>(width) * IMAGE_BYTES_PER_PIXEL;
+	}
+	uint64_t Image::GetSizeInBytes() const
+	{
+		return GetRowPitch() * height;
+	}
+
+	uint8_t* Image::GetPixel(uint32_t x, uint32_t y)
+	{
+		assert(x < width && y < height && "Pixel is out of the image bounds!");
+		return pixels.data() + y * GetRowPitch() + static_cast<uint64_t>(x) * IMAGE_BYTES_PER_PIXEL;
+	}
+	const uint8_t* Image::GetPixel(uint32_t x, uint32_t y) const
+	{
+		assert(x < width && y < height && "Pixel is out of the image bounds!");
+		return pixels.data() + y * GetRowPitch() + static_cast<uint64_t>(x) * IMAGE_BYTES_PER_PIXEL;
+	}
+
+	Image CreateImage(uint32_t width, uint32_t height, TextureFormat format)
+	{
+		assert((format == TextureFormat::R8G8B8A8_UNORM || format == TextureFormat::R8G8B8A8_UNORM_SRGB) &&
+			"Images only hold RGBA8 pixels!");
+
+		Image image{};
+		image.width = width;
+		image.height = height;
+		image.format = format;
+		image.pixels.resize(image.GetSizeInBytes());
+		return image;
+	}
+}
@@ -0,0 +1,467 @@
+#include "Texture/ImageDecoder.h"
+
+#include "Core/Error.h"
+#include "Core/MappedFile.h"
+#include "Core/ThreadPool.h"
+#include "Texture/PixelConversion.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+namespace dxe
+{
+	// Same limit the QOI reference decoder uses, it keeps corrupted headers from asking for gigabytes.
+	constexpr uint64_t MAX_IMAGE_PIXEL_COUNT = 400000000;
+
+	static uint16_t ReadUint16LittleEndian(const uint8_t* data)
+	{
+		return static_cast<uint16_t>(data[0] | (data[1] << 8));
+	}
+	static uint32_t ReadUint32BigEndian(const uint8_t* data)
+	{
+		return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+			(static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+	}
+
+	static void ValidateImageSize(uint32_t width, uint32_t height, const char* formatName)
+	{
+		if (width == 0 || height == 0)
+			throw Error{ std::string(formatName) + " image has a zero size!" };
+		if (static_cast<uint64_t>(width) * height > MAX_IMAGE_PIXEL_COUNT)
+			throw Error{ std::string(formatName) + " image is too large!" };
+	}
+
+	// TGA
+
+	constexpr size_t TGA_HEADER_SIZE = 18;
+
+	constexpr uint8_t TGA_TYPE_TRUECOLOR = 2;
+	constexpr uint8_t TGA_TYPE_GRAY = 3;
+	constexpr uint8_t TGA_TYPE_TRUECOLOR_RLE = 10;
+	constexpr uint8_t TGA_TYPE_GRAY_RLE = 11;
+
+	constexpr uint8_t TGA_DESCRIPTOR_ALPHA_BITS = 0x0F;
+	constexpr uint8_t TGA_DESCRIPTOR_TOP_LEFT = 0x20;
+
+	static bool IsTgaHeaderSupported(const uint8_t* data, size_t size)
+	{
+		if (size < TGA_HEADER_SIZE)
+			return false;
+
+		uint8_t imageType = data[2];
+		uint8_t bitsPerPixel = data[16];
+
+		bool gray = imageType == TGA_TYPE_GRAY || imageType == TGA_TYPE_GRAY_RLE;
+		bool truecolor = imageType == TGA_TYPE_TRUECOLOR || imageType == TGA_TYPE_TRUECOLOR_RLE;
+
+		return (gray && bitsPerPixel == 8) || (truecolor && (bitsPerPixel == 24 || bitsPerPixel == 32));
+	}
+
+	Image DecodeTga(const uint8_t* data, size_t size)
+	{
+		if (!IsTgaHeaderSupported(data, size))
+			throw Error{ "Unsupported or corrupted TGA header (only 8-bit gray and 24/32-bit truecolor are supported)!" };
+
+		uint8_t idLength = data[0];
+		uint8_t colorMapType = data[1];
+		uint8_t imageType = data[2];
+		uint16_t colorMapLength = ReadUint16LittleEndian(data + 5);
+		uint8_t colorMapEntrySize = data[7];
+		uint32_t width = ReadUint16LittleEndian(data + 12);
+		uint32_t height = ReadUint16LittleEndian(data + 14);
+		uint32_t bytesPerPixel = data[16] / 8;
+		uint8_t descriptor = data[17];
+
+		ValidateImageSize(width, height, "TGA");
+
+		// Truecolor images may still carry a (unused) color map, skip over it.
+		size_t offset = TGA_HEADER_SIZE + idLength;
+		if (colorMapType != 0)
+			offset += static_cast<size_t>(colorMapLength) * ((colorMapEntrySize + 7) / 8);
+
+		size_t pixelCount = static_cast<size_t>(width) * height;
+		size_t pixelDataSize = pixelCount * bytesPerPixel;
+
+		const uint8_t* pixelData{ nullptr };
+		std::vector<uint8_t> decompressed;
+
+		if (imageType == TGA_TYPE_TRUECOLOR_RLE || imageType == TGA_TYPE_GRAY_RLE)
+		{
+			decompressed.resize(pixelDataSize);
+
+			size_t written{ 0 };
+			while (written < pixelDataSize)
+			{
+				if (offset >= size)
+					throw Error{ "TGA run-length data is truncated!" };
+
+				uint8_t packetHeader = data[offset++];
+				size_t packetBytes = static_cast<size_t>((packetHeader & 0x7F) + 1) * bytesPerPixel;
+
+				if (written + packetBytes > pixelDataSize)
+					throw Error{ "TGA run-length packet overflows the image!" };
+
+				if (packetHeader & 0x80)
+				{
+					if (offset + bytesPerPixel > size)
+						throw Error{ "TGA run-length data is truncated!" };
+
+					for (size_t byte = 0; byte < packetBytes; byte += bytesPerPixel)
+						std::memcpy(&decompressed[written + byte], data + offset, bytesPerPixel);
+					offset += bytesPerPixel;
+				}
+				else
+				{
+					if (offset + packetBytes > size)
+						throw Error{ "TGA run-length data is truncated!" };
+
+					std::memcpy(&decompressed[written], data + offset, packetBytes);
+					offset += packetBytes;
+				}
+
+				written += packetBytes;
+			}
+
+			pixelData = decompressed.data();
+		}
+		else
+		{
+			if (offset + pixelDataSize > size)
+				throw Error{ "TGA pixel data is truncated!" };
+			pixelData = data + offset;
+		}
+
+		Image image = CreateImage(width, height, TextureFormat::R8G8B8A8_UNORM_SRGB);
+
+		// Rows are stored bottom-up unless the descriptor says otherwise.
+		bool topDown = (descriptor & TGA_DESCRIPTOR_TOP_LEFT) != 0;
+		bool hasAlpha = bytesPerPixel == 4 && (descriptor & TGA_DESCRIPTOR_ALPHA_BITS) != 0;
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			uint32_t sourceY = topDown ? y : height - 1 - y;
+			const uint8_t* sourceRow = pixelData + static_cast<size_t>(sourceY) * width * bytesPerPixel;
+			uint8_t* destinationRow = image.GetPixel(0, y);
+
+			switch (bytesPerPixel)
+			{
+			case 4: SwizzleRedBlue(sourceRow, destinationRow, width); break;
+			case 3: ExpandBgrToRgba(sourceRow, destinationRow, width); break;
+			default: ExpandGrayToRgba(sourceRow, destinationRow, width); break;
+			}
+
+			// 32-bit files without alpha bits store padding in the fourth byte.
+			if (bytesPerPixel == 4 && !hasAlpha)
+			{
+				for (uint32_t x = 0; x < width; x++)
+					destinationRow[x * 4 + 3] = 255;
+			}
+		}
+
+		return image;
+	}
+
+	// PPM
+
+	class PpmHeaderReader
+	{
+	public:
+
+		PpmHeaderReader(const uint8_t* data, size_t size)
+			: data(data), size(size), offset(2) {}
+
+		uint32_t ReadValue()
+		{
+			SkipWhitespaceAndComments();
+
+			if (offset >= size || data[offset] < '0' || data[offset] > '9')
+				throw Error{ "PPM header is corrupted!" };
+
+			uint64_t value{ 0 };
+			while (offset < size && data[offset] >= '0' && data[offset] <= '9')
+			{
+				value = value * 10 + (data[offset++] - '0');
+				if (value > UINT32_MAX)
+					throw Error{ "PPM header value is out of range!" };
+			}
+			return static_cast<uint32_t>(value);
+		}
+
+		// Exactly one whitespace character separates the header from the samples.
+		size_t GetDataOffset() const
+		{
+			if (offset >= size || !IsWhitespace(data[offset]))
+				throw Error{ "PPM header is corrupted!" };
+			return offset + 1;
+		}
+
+	private:
+
+		static bool IsWhitespace(uint8_t character)
+		{
+			return character == ' ' || character == '\t' || character == '\r' || character == '\n';
+		}
+
+		void SkipWhitespaceAndComments()
+		{
+			while (offset < size)
+			{
+				if (IsWhitespace(data[offset]))
+				{
+					offset++;
+				}
+				else if (data[offset] == '#')
+				{
+					while (offset < size && data[offset] != '\n')
+						offset++;
+				}
+				else
+				{
+					break;
+				}
+			}
+		}
+
+		const uint8_t* data{ nullptr };
+		size_t size{ 0 };
+		size_t offset{ 0 };
+	};
+
+	Image DecodePpm(const uint8_t* data, size_t size)
+	{
+		if (size < 2 || data[0] != 'P' || (data[1] != '5' && data[1] != '6'))
+			throw Error{ "Not a binary PPM/PGM file!" };
+
+		uint32_t channels = data[1] == '6' ? 3 : 1;
+
+		PpmHeaderReader header{ data, size };
+		uint32_t width = header.ReadValue();
+		uint32_t height = header.ReadValue();
+		uint32_t maxValue = header.ReadValue();
+		size_t offset = header.GetDataOffset();
+
+		ValidateImageSize(width, height, "PPM");
+		if (maxValue == 0 || maxValue > 65535)
+			throw Error{ "PPM maximum sample value is out of range!" };
+
+		uint32_t bytesPerSample = maxValue < 256 ? 1 : 2;
+		size_t rowSize = static_cast<size_t>(width) * channels * bytesPerSample;
+
+		if (offset + rowSize * height > size)
+			throw Error{ "PPM pixel data is truncated!" };
+
+		Image image = CreateImage(width, height, TextureFormat::R8G8B8A8_UNORM_SRGB);
+
+		// Anything but 8-bit samples with a 255 maximum gets rescaled into a temporary row first.
+		bool needsRescale = maxValue != 255;
+		std::vector<uint8_t> rescaledRow(needsRescale ? static_cast<size_t>(width) * channels : 0);
+
+		for (uint32_t y = 0; y < height; y++)
+		{
+			const uint8_t* sourceRow = data + offset + rowSize * y;
+
+			if (needsRescale)
+			{
+				for (size_t sample = 0; sample < rescaledRow.size(); sample++)
+				{
+					// Samples are big-endian when they take two bytes.
+					uint32_t value = bytesPerSample == 2 ?
+						(static_cast<uint32_t>(sourceRow[sample * 2]) << 8) | sourceRow[sample * 2 + 1] :
+						sourceRow[sample];
+
+					value = std::min(value, maxValue);
+					rescaledRow[sample] = static_cast<uint8_t>((value * 255 + maxValue / 2) / maxValue);
+				}
+				sourceRow = rescaledRow.data();
+			}
+
+			if (channels == 3)
+				ExpandRgbToRgba(sourceRow, image.GetPixel(0, y), width);
+			else
+				ExpandGrayToRgba(sourceRow, image.GetPixel(0, y), width);
+		}
+
+		return image;
+	}
+
+	// QOI
+
+	constexpr size_t QOI_HEADER_SIZE = 14;
+	constexpr size_t QOI_PADDING_SIZE = 8;
+
+	constexpr uint8_t QOI_OP_INDEX = 0x00;
+	constexpr uint8_t QOI_OP_DIFF = 0x40;
+	constexpr uint8_t QOI_OP_LUMA = 0x80;
+	constexpr uint8_t QOI_OP_RUN = 0xC0;
+	constexpr uint8_t QOI_OP_RGB = 0xFE;
+	constexpr uint8_t QOI_OP_RGBA = 0xFF;
+	constexpr uint8_t QOI_OP_MASK = 0xC0;
+
+	constexpr uint8_t QOI_COLORSPACE_LINEAR = 1;
+
+	static bool HasQoiMagic(const uint8_t* data, size_t size)
+	{
+		return size >= 4 && std::memcmp(data, "qoif", 4) == 0;
+	}
+
+	Image DecodeQoi(const uint8_t* data, size_t size)
+	{
+		if (size < QOI_HEADER_SIZE + QOI_PADDING_SIZE || !HasQoiMagic(data, size))
+			throw Error{ "Not a QOI file!" };
+
+		uint32_t width = ReadUint32BigEndian(data + 4);
+		uint32_t height = ReadUint32BigEndian(data + 8);
+		uint8_t channels = data[12];
+		uint8_t colorspace = data[13];
+
+		ValidateImageSize(width, height, "QOI");
+		if (channels != 3 && channels != 4)
+			throw Error{ "QOI channel count must be 3 or 4!" };
+
+		// sRGB QOI files still have linear alpha, which is exactly what the sRGB format means.
+		Image image = CreateImage(width, height,
+			colorspace == QOI_COLORSPACE_LINEAR ? TextureFormat::R8G8B8A8_UNORM : TextureFormat::R8G8B8A8_UNORM_SRGB);
+
+		uint8_t index[64][4]{};
+		uint8_t pixel[4]{ 0, 0, 0, 255 };
+		uint32_t run{ 0 };
+
+		size_t offset = QOI_HEADER_SIZE;
+		size_t chunksEnd = size - QOI_PADDING_SIZE;
+
+		auto requireBytes = [&](size_t byteCount)
+		{
+			if (offset + byteCount > chunksEnd)
+				throw Error{ "QOI data is truncated!" };
+		};
+
+		uint8_t* destination = image.pixels.data();
+		size_t pixelCount = static_cast<size_t>(width) * height;
+
+		for (size_t pixelIndex = 0; pixelIndex < pixelCount; pixelIndex++)
+		{
+			if (run > 0)
+			{
+				run--;
+			}
+			else
+			{
+				requireBytes(1);
+				uint8_t tag = data[offset++];
+
+				if (tag == QOI_OP_RGB)
+				{
+					requireBytes(3);
+					std::memcpy(pixel, data + offset, 3);
+					offset += 3;
+				}
+				else if (tag == QOI_OP_RGBA)
+				{
+					requireBytes(4);
+					std::memcpy(pixel, data + offset, 4);
+					offset += 4;
+				}
+				else if ((tag & QOI_OP_MASK) == QOI_OP_INDEX)
+				{
+					std::memcpy(pixel, index[tag], 4);
+				}
+				else if ((tag & QOI_OP_MASK) == QOI_OP_DIFF)
+				{
+					pixel[0] = static_cast<uint8_t>(pixel[0] + ((tag >> 4) & 0x03) - 2);
+					pixel[1] = static_cast<uint8_t>(pixel[1] + ((tag >> 2) & 0x03) - 2);
+					pixel[2] = static_cast<uint8_t>(pixel[2] + (tag & 0x03) - 2);
+				}
+				else if ((tag & QOI_OP_MASK) == QOI_OP_LUMA)
+				{
+					requireBytes(1);
+					uint8_t next = data[offset++];
+					int32_t greenDifference = (tag & 0x3F) - 32;
+
+					pixel[0] = static_cast<uint8_t>(pixel[0] + greenDifference - 8 + ((next >> 4) & 0x0F));
+					pixel[1] = static_cast<uint8_t>(pixel[1] + greenDifference);
+					pixel[2] = static_cast<uint8_t>(pixel[2] + greenDifference - 8 + (next & 0x0F));
+				}
+				else
+				{
+					run = tag & 0x3F;
+				}
+
+				uint32_t hash = (pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11) % 64;
+				std::memcpy(index[hash], pixel, 4);
+			}
+
+			std::memcpy(destination + pixelIndex * 4, pixel, 4);
+		}
+
+		return image;
+	}
+
+	// Dispatch
+
+	ImageFileFormat DetectImageFileFormat(const uint8_t* data, size_t size)
+	{
+		if (HasQoiMagic(data, size))
+			return ImageFileFormat::QOI;
+		if (size >= 2 && data[0] == 'P' && (data[1] == '5' || data[1] == '6'))
+			return ImageFileFormat::PPM;
+		if (IsTgaHeaderSupported(data, size))
+			return ImageFileFormat::TGA;
+		return ImageFileFormat::UNKNOWN;
+	}
+
+	Image DecodeImage(const uint8_t* data, size_t size)
+	{
+		switch (DetectImageFileFormat(data, size))
+		{
+		case ImageFileFormat::TGA: return DecodeTga(data, size);
+		case ImageFileFormat::PPM: return DecodePpm(data, size);
+		case ImageFileFormat::QOI: return DecodeQoi(data, size);
+		default:
+			throw Error{ "Unknown image file format!" };
+		}
+	}
+
+	Image LoadImageFile(const std::filesystem::path& path)
+	{
+		MappedFile file{};
+		file.Open(path);
+
+		try
+		{
+			return DecodeImage(file.GetData(), file.GetSize());
+		}
+		catch (const Error& error)
+		{
+			throw Error{ std::string(error.what()) + " (" + path.string() + ")" };
+		}
+	}
+
+	std::vector<ImageLoadResult> LoadImageFiles(const std::vector<std::filesystem::path>& paths, ThreadPool* threadPool)
+	{
+		std::vector<ImageLoadResult> results(paths.size());
+
+		auto loadFiles = [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t file = begin; file < end; file++)
+			{
+				ImageLoadResult& result = results[file];
+				result.path = paths[file];
+
+				try
+				{
+					result.image = LoadImageFile(paths[file]);
+					result.succeeded = true;
+				}
+				catch (const std::exception& exception)
+				{
+					result.errorMessage = exception.what();
+				}
+			}
+		};
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, static_cast<uint32_t>(paths.size()), 1, loadFiles);
+
+		return results;
+	}
+}
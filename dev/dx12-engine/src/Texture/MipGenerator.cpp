@@ -0,0 +1,356 @@
+#include "Texture/MipGenerator.h"
+
+#include "Core/Error.h"
+#include "Core/Simd.h"
+#include "Core/ThreadPool.h"
+#include "Renderer/Color.h"
+#include "Texture/TextureLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace dxe
+{
+	constexpr float PI = 3.14159265358979f;
+	constexpr uint32_t ROW_GRAIN_SIZE = 16;
+
+	// Filters
+
+	constexpr float KAISER_RADIUS = 3.0f;
+	constexpr float KAISER_ALPHA = 4.0f;
+	constexpr float LANCZOS_RADIUS = 3.0f;
+
+	static float Sinc(float x)
+	{
+		if (std::fabs(x) < 1e-5f)
+			return 1.0f;
+		x *= PI;
+		return std::sin(x) / x;
+	}
+
+	static float BesselI0(float x)
+	{
+		float sum = 1.0f;
+		float term = 1.0f;
+		float halfX = x * 0.5f;
+
+		for (uint32_t k = 1; k < 32; k++)
+		{
+			term *= (halfX / static_cast<float>(k)) * (halfX / static_cast<float>(k));
+			sum += term;
+			if (term < sum * 1e-8f)
+				break;
+		}
+		return sum;
+	}
+
+	static float GetFilterRadius(MipFilter filter)
+	{
+		switch (filter)
+		{
+		case MipFilter::KAISER:  return KAISER_RADIUS;
+		case MipFilter::LANCZOS: return LANCZOS_RADIUS;
+		default:                 return 0.5f;
+		}
+	}
+
+	static float EvaluateFilter(MipFilter filter, float x)
+	{
+		x = std::fabs(x);
+
+		switch (filter)
+		{
+		case MipFilter::KAISER:
+		{
+			if (x >= KAISER_RADIUS)
+				return 0.0f;
+			float ratio = x / KAISER_RADIUS;
+			return Sinc(x) * BesselI0(KAISER_ALPHA * std::sqrt(1.0f - ratio * ratio)) / BesselI0(KAISER_ALPHA);
+		}
+		case MipFilter::LANCZOS:
+		{
+			if (x >= LANCZOS_RADIUS)
+				return 0.0f;
+			return Sinc(x) * Sinc(x / LANCZOS_RADIUS);
+		}
+		default:
+			return 0.0f;
+		}
+	}
+
+	// Every output pixel of one axis reads 'tapCount' source pixels; edges clamp.
+	struct FilterTaps
+	{
+		uint32_t tapCount{ 0 };
+		std::vector<uint32_t> indices;
+		std::vector<float> weights;
+	};
+
+	static FilterTaps BuildFilterTaps(MipFilter filter, uint32_t sourceSize, uint32_t destinationSize)
+	{
+		float scale = static_cast<float>(sourceSize) / static_cast<float>(destinationSize);
+		float support = GetFilterRadius(filter) * scale;
+
+		FilterTaps taps{};
+		taps.tapCount = static_cast<uint32_t>(std::ceil(support * 2.0f)) + 1;
+		taps.indices.resize(static_cast<size_t>(taps.tapCount) * destinationSize);
+		taps.weights.resize(static_cast<size_t>(taps.tapCount) * destinationSize);
+
+		for (uint32_t destination = 0; destination < destinationSize; destination++)
+		{
+			float center = (static_cast<float>(destination) + 0.5f) * scale;
+			int32_t first = static_cast<int32_t>(std::floor(center - support));
+
+			uint32_t* indices = &taps.indices[static_cast<size_t>(destination) * taps.tapCount];
+			float* weights = &taps.weights[static_cast<size_t>(destination) * taps.tapCount];
+
+			float weightSum = 0.0f;
+			for (uint32_t tap = 0; tap < taps.tapCount; tap++)
+			{
+				int32_t source = first + static_cast<int32_t>(tap);
+
+				float weight;
+				if (filter == MipFilter::BOX)
+				{
+					// Box weights are the overlap of the source pixel with the footprint, which is
+					// what keeps odd sizes (5 -> 2) from favouring some pixels over others.
+					float left = std::max(static_cast<float>(source), center - scale * 0.5f);
+					float right = std::min(static_cast<float>(source + 1), center + scale * 0.5f);
+					weight = std::max(right - left, 0.0f);
+				}
+				else
+				{
+					weight = EvaluateFilter(filter, (static_cast<float>(source) + 0.5f - center) / scale);
+				}
+
+				indices[tap] = static_cast<uint32_t>(std::clamp(source, 0, static_cast<int32_t>(sourceSize) - 1));
+				weights[tap] = weight;
+				weightSum += weight;
+			}
+
+			for (uint32_t tap = 0; tap < taps.tapCount; tap++)
+				weights[tap] /= weightSum;
+		}
+
+		return taps;
+	}
+
+	// Float mips
+
+	// Linear RGBA floats, four per pixel.
+	struct FloatImage
+	{
+		uint32_t width{ 0 };
+		uint32_t height{ 0 };
+		std::vector<float> pixels;
+
+		float* GetRow(uint32_t y) { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+		const float* GetRow(uint32_t y) const { return pixels.data() + static_cast<size_t>(y) * width * 4; }
+	};
+
+	// Adds 'weight' * 'source' to 'destination', for 'count' pixels.
+	static void AccumulateWeighted(float* destination, const float* source, float weight, uint32_t count)
+	{
+#if SIMD_SSE2
+		__m128 weights = _mm_set1_ps(weight);
+		for (uint32_t pixel = 0; pixel < count; pixel++)
+		{
+			__m128 accumulated = _mm_loadu_ps(destination + pixel * 4);
+			accumulated = _mm_add_ps(accumulated, _mm_mul_ps(_mm_loadu_ps(source + pixel * 4), weights));
+			_mm_storeu_ps(destination + pixel * 4, accumulated);
+		}
+#else
+		for (uint32_t value = 0; value < count * 4; value++)
+			destination[value] += source[value] * weight;
+#endif
+	}
+
+	static void ClampPixels(float* pixels, uint32_t count)
+	{
+#if SIMD_SSE2
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		for (uint32_t pixel = 0; pixel < count; pixel++)
+			_mm_storeu_ps(pixels + pixel * 4, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pixels + pixel * 4), zero), one));
+#else
+		for (uint32_t value = 0; value < count * 4; value++)
+			pixels[value] = std::clamp(pixels[value], 0.0f, 1.0f);
+#endif
+	}
+
+	static FloatImage Downsample(const FloatImage& source, uint32_t width, uint32_t height, MipFilter filter, ThreadPool* threadPool)
+	{
+		FilterTaps horizontalTaps = BuildFilterTaps(filter, source.width, width);
+		FilterTaps verticalTaps = BuildFilterTaps(filter, source.height, height);
+
+		// Horizontal pass, source height rows.
+		FloatImage horizontal{ width, source.height, std::vector<float>(static_cast<size_t>(width) * source.height * 4, 0.0f) };
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, source.height, ROW_GRAIN_SIZE, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t y = begin; y < end; y++)
+			{
+				const float* sourceRow = source.GetRow(y);
+				float* destinationRow = horizontal.GetRow(y);
+
+				for (uint32_t x = 0; x < width; x++)
+				{
+					const uint32_t* indices = &horizontalTaps.indices[static_cast<size_t>(x) * horizontalTaps.tapCount];
+					const float* weights = &horizontalTaps.weights[static_cast<size_t>(x) * horizontalTaps.tapCount];
+
+					for (uint32_t tap = 0; tap < horizontalTaps.tapCount; tap++)
+					{
+						if (weights[tap] != 0.0f)
+							AccumulateWeighted(destinationRow + x * 4, sourceRow + indices[tap] * 4, weights[tap], 1);
+					}
+				}
+			}
+		});
+
+		// Vertical pass, whole rows at a time.
+		FloatImage result{ width, height, std::vector<float>(static_cast<size_t>(width) * height * 4, 0.0f) };
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, height, ROW_GRAIN_SIZE, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t y = begin; y < end; y++)
+			{
+				const uint32_t* indices = &verticalTaps.indices[static_cast<size_t>(y) * verticalTaps.tapCount];
+				const float* weights = &verticalTaps.weights[static_cast<size_t>(y) * verticalTaps.tapCount];
+
+				float* destinationRow = result.GetRow(y);
+				for (uint32_t tap = 0; tap < verticalTaps.tapCount; tap++)
+				{
+					if (weights[tap] != 0.0f)
+						AccumulateWeighted(destinationRow, horizontal.GetRow(indices[tap]), weights[tap], width);
+				}
+
+				// Kaiser and Lanczos have negative lobes, don't let the overshoot feed the next mip.
+				ClampPixels(destinationRow, width);
+			}
+		});
+
+		return result;
+	}
+
+	// Alpha coverage
+
+	static float CalculateAlphaCoverage(const Image& image, float reference, float alphaScale)
+	{
+		uint64_t coveredPixels{ 0 };
+		for (size_t alpha = 3; alpha < image.pixels.size(); alpha += 4)
+		{
+			if (static_cast<float>(image.pixels[alpha]) / 255.0f * alphaScale > reference)
+				coveredPixels++;
+		}
+		return static_cast<float>(coveredPixels) / static_cast<float>(static_cast<uint64_t>(image.width) * image.height);
+	}
+
+	static void PreserveAlphaCoverage(Image& mip, float targetCoverage, float reference)
+	{
+		// Coverage grows with the scale, so a binary search finds the scale that matches mip 0.
+		float minimumScale = 0.0f;
+		float maximumScale = 4.0f;
+		float bestScale = 1.0f;
+		float bestDifference = std::fabs(CalculateAlphaCoverage(mip, reference, 1.0f) - targetCoverage);
+
+		for (uint32_t iteration = 0; iteration < 10; iteration++)
+		{
+			float scale = (minimumScale + maximumScale) * 0.5f;
+			float coverage = CalculateAlphaCoverage(mip, reference, scale);
+
+			float difference = std::fabs(coverage - targetCoverage);
+			if (difference < bestDifference)
+			{
+				bestDifference = difference;
+				bestScale = scale;
+			}
+
+			if (coverage < targetCoverage)
+				minimumScale = scale;
+			else if (coverage > targetCoverage)
+				maximumScale = scale;
+			else
+				break;
+		}
+
+		for (size_t alpha = 3; alpha < mip.pixels.size(); alpha += 4)
+			mip.pixels[alpha] = FloatToUnorm8(static_cast<float>(mip.pixels[alpha]) / 255.0f * bestScale);
+	}
+
+	// Conversion
+
+	static FloatImage ConvertToFloat(const Image& image, bool srgb, ThreadPool* threadPool)
+	{
+		FloatImage result{ image.width, image.height, std::vector<float>(static_cast<size_t>(image.width) * image.height * 4) };
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, image.height, ROW_GRAIN_SIZE, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t y = begin; y < end; y++)
+			{
+				if (srgb)
+					ConvertSrgbUnorm8ToLinear(image.GetPixel(0, y), result.GetRow(y), image.width);
+				else
+					ConvertUnorm8ToFloat(image.GetPixel(0, y), result.GetRow(y), static_cast<size_t>(image.width) * 4);
+			}
+		});
+
+		return result;
+	}
+
+	static Image ConvertToImage(const FloatImage& image, TextureFormat format, bool srgb, ThreadPool* threadPool)
+	{
+		Image result = CreateImage(image.width, image.height, format);
+
+		ThreadPool::ParallelForOrInline(threadPool, 0, image.height, ROW_GRAIN_SIZE, [&](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t y = begin; y < end; y++)
+			{
+				if (srgb)
+					ConvertLinearToSrgbUnorm8(image.GetRow(y), result.GetPixel(0, y), image.width);
+				else
+					ConvertFloatToUnorm8(image.GetRow(y), result.GetPixel(0, y), static_cast<size_t>(image.width) * 4);
+			}
+		});
+
+		return result;
+	}
+
+	// GenerateMipChain
+
+	std::vector<Image> GenerateMipChain(const Image& image, const MipGenerationSettings& settings, ThreadPool* threadPool)
+	{
+		if (image.width == 0 || image.height == 0 || image.pixels.size() < image.GetSizeInBytes())
+			throw Error{ "Image passed to the mip generator is empty or too small!" };
+
+		bool srgb = image.format == TextureFormat::R8G8B8A8_UNORM_SRGB;
+
+		uint32_t fullChainLength = CalculateFullMipChainLength(image.width, image.height);
+		uint32_t mipLevels = settings.mipLevels == 0 ? fullChainLength : std::min(settings.mipLevels, fullChainLength);
+
+		std::vector<Image> mips;
+		mips.reserve(mipLevels);
+		mips.push_back(image);
+
+		float targetCoverage = settings.preserveAlphaCoverage ?
+			CalculateAlphaCoverage(image, settings.alphaCoverageReference, 1.0f) : 0.0f;
+
+		FloatImage previous = ConvertToFloat(image, srgb, threadPool);
+
+		for (uint32_t mip = 1; mip < mipLevels; mip++)
+		{
+			uint32_t width = std::max(previous.width >> 1, 1u);
+			uint32_t height = std::max(previous.height >> 1, 1u);
+
+			FloatImage current = Downsample(previous, width, height, settings.filter, threadPool);
+
+			Image& output = mips.emplace_back(ConvertToImage(current, image.format, srgb, threadPool));
+			if (settings.preserveAlphaCoverage)
+				PreserveAlphaCoverage(output, targetCoverage, settings.alphaCoverageReference);
+
+			previous = std::move(current);
+		}
+
+		return mips;
+	}
+}
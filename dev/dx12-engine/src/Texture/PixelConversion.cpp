@@ -0,0 +1,162 @@
+#include "Texture/PixelConversion.h"
+
+#include "Core/Simd.h"
+
+#include <cstring>
+
+namespace dxe
+{
+	// SSE2 has no byte shuffle, so the kernels below work on whole 32-bit pixels with
+	// shifts and masks, and gather three-byte pixels with overlapping 32-bit loads.
+
+	static uint32_t LoadPixel24(const uint8_t* source)
+	{
+		return static_cast<uint32_t>(source[0]) |
+			(static_cast<uint32_t>(source[1]) << 8) |
+			(static_cast<uint32_t>(source[2]) << 16);
+	}
+
+	// Reads 4 bytes for a 3-byte pixel, only valid when at least one more byte follows.
+	static uint32_t LoadPixel24Overlapping(const uint8_t* source)
+	{
+		uint32_t value;
+		std::memcpy(&value, source, sizeof(value));
+		return value & 0x00FFFFFFu;
+	}
+
+	static uint32_t SwapRedBlue(uint32_t pixel)
+	{
+		return (pixel & 0xFF00FF00u) | ((pixel & 0x000000FFu) << 16) | ((pixel >> 16) & 0x000000FFu);
+	}
+
+	void SwizzleRedBlue(const uint8_t* source, uint8_t* destination, size_t pixelCount)
+	{
+		size_t pixel{ 0 };
+
+#if SIMD_SSE2
+		const __m128i greenAlphaMask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+		const __m128i lowByteMask = _mm_set1_epi32(0x000000FF);
+
+		for (; pixel + 4 <= pixelCount; pixel += 4)
+		{
+			__m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel * 4));
+
+			__m128i greenAlpha = _mm_and_si128(pixels, greenAlphaMask);
+			__m128i red = _mm_slli_epi32(_mm_and_si128(pixels, lowByteMask), 16);
+			__m128i blue = _mm_and_si128(_mm_srli_epi32(pixels, 16), lowByteMask);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4),
+				_mm_or_si128(greenAlpha, _mm_or_si128(red, blue)));
+		}
+#endif
+
+		for (; pixel < pixelCount; pixel++)
+		{
+			uint32_t value;
+			std::memcpy(&value, source + pixel * 4, sizeof(value));
+			value = SwapRedBlue(value);
+			std::memcpy(destination + pixel * 4, &value, sizeof(value));
+		}
+	}
+
+	template <bool swapRedBlue>
+	static void ExpandThreeChannels(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha)
+	{
+		const uint32_t alphaBits = static_cast<uint32_t>(alpha) << 24;
+		size_t pixel{ 0 };
+
+		// The overlapping loads read one byte past each pixel, so the last pixel goes through the tail.
+		size_t overlappingPixels = pixelCount > 0 ? pixelCount - 1 : 0;
+
+#if SIMD_SSE2
+		const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(alphaBits));
+		const __m128i greenMask = _mm_set1_epi32(0x0000FF00);
+		const __m128i lowByteMask = _mm_set1_epi32(0x000000FF);
+
+		for (; pixel + 4 <= overlappingPixels; pixel += 4)
+		{
+			const uint8_t* pixelSource = source + pixel * 3;
+			__m128i pixels = _mm_set_epi32(
+				static_cast<int>(LoadPixel24Overlapping(pixelSource + 9)),
+				static_cast<int>(LoadPixel24Overlapping(pixelSource + 6)),
+				static_cast<int>(LoadPixel24Overlapping(pixelSource + 3)),
+				static_cast<int>(LoadPixel24Overlapping(pixelSource)));
+
+			if (swapRedBlue)
+			{
+				__m128i green = _mm_and_si128(pixels, greenMask);
+				__m128i red = _mm_slli_epi32(_mm_and_si128(pixels, lowByteMask), 16);
+				__m128i blue = _mm_and_si128(_mm_srli_epi32(pixels, 16), lowByteMask);
+				pixels = _mm_or_si128(green, _mm_or_si128(red, blue));
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(destination + pixel * 4), _mm_or_si128(pixels, alphaMask));
+		}
+#endif
+
+		for (; pixel < overlappingPixels; pixel++)
+		{
+			uint32_t value = LoadPixel24Overlapping(source + pixel * 3);
+			if (swapRedBlue)
+				value = SwapRedBlue(value);
+			value |= alphaBits;
+			std::memcpy(destination + pixel * 4, &value, sizeof(value));
+		}
+
+		for (; pixel < pixelCount; pixel++)
+		{
+			uint32_t value = LoadPixel24(source + pixel * 3);
+			if (swapRedBlue)
+				value = SwapRedBlue(value);
+			value |= alphaBits;
+			std::memcpy(destination + pixel * 4, &value, sizeof(value));
+		}
+	}
+
+	void ExpandRgbToRgba(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha)
+	{
+		ExpandThreeChannels<false>(source, destination, pixelCount, alpha);
+	}
+	void ExpandBgrToRgba(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha)
+	{
+		ExpandThreeChannels<true>(source, destination, pixelCount, alpha);
+	}
+	void ExpandRgbToBgra(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha)
+	{
+		ExpandThreeChannels<true>(source, destination, pixelCount, alpha);
+	}
+
+	void ExpandGrayToRgba(const uint8_t* source, uint8_t* destination, size_t pixelCount, uint8_t alpha)
+	{
+		size_t pixel{ 0 };
+
+#if SIMD_SSE2
+		const __m128i alphaBytes = _mm_set1_epi8(static_cast<char>(alpha));
+
+		for (; pixel + 16 <= pixelCount; pixel += 16)
+		{
+			__m128i gray = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + pixel));
+
+			// gray, gray pairs, then gray, alpha pairs, interleaved into g g g a.
+			__m128i grayGrayLow = _mm_unpacklo_epi8(gray, gray);
+			__m128i grayGrayHigh = _mm_unpackhi_epi8(gray, gray);
+			__m128i grayAlphaLow = _mm_unpacklo_epi8(gray, alphaBytes);
+			__m128i grayAlphaHigh = _mm_unpackhi_epi8(gray, alphaBytes);
+
+			__m128i* pixelDestination = reinterpret_cast<__m128i*>(destination + pixel * 4);
+			_mm_storeu_si128(pixelDestination + 0, _mm_unpacklo_epi16(grayGrayLow, grayAlphaLow));
+			_mm_storeu_si128(pixelDestination + 1, _mm_unpackhi_epi16(grayGrayLow, grayAlphaLow));
+			_mm_storeu_si128(pixelDestination + 2, _mm_unpacklo_epi16(grayGrayHigh, grayAlphaHigh));
+			_mm_storeu_si128(pixelDestination + 3, _mm_unpackhi_epi16(grayGrayHigh, grayAlphaHigh));
+		}
+#endif
+
+		for (; pixel < pixelCount; pixel++)
+		{
+			destination[pixel * 4 + 0] = source[pixel];
+			destination[pixel * 4 + 1] = source[pixel];
+			destination[pixel * 4 + 2] = source[pixel];
+			destination[pixel * 4 + 3] = alpha;
+		}
+	}
+}
@@ -0,0 +1,187 @@
+#include "Texture/TextureFormat.h"
+
+#include <cassert>
+
+namespace dxe
+{
+	// Pairs of the engine format and its DXGI_FORMAT value.
+
+	struct DxgiFormatMapping
+	{
+		TextureFormat format;
+		uint32_t dxgiFormat;
+	};
+
+	static constexpr DxgiFormatMapping dxgiFormatMappings[]
+	{
+		{ TextureFormat::R32G32B32A32_FLOAT,   2 },
+		{ TextureFormat::R16G16B16A16_FLOAT,  10 },
+		{ TextureFormat::R11G11B10_FLOAT,     26 },
+		{ TextureFormat::R8G8B8A8_UNORM,      28 },
+		{ TextureFormat::R8G8B8A8_UNORM_SRGB, 29 },
+		{ TextureFormat::R16G16_FLOAT,        34 },
+		{ TextureFormat::R32_FLOAT,           41 },
+		{ TextureFormat::R8G8_UNORM,          49 },
+		{ TextureFormat::R16_FLOAT,           54 },
+		{ TextureFormat::R8_UNORM,            61 },
+		{ TextureFormat::BC1_UNORM,           71 },
+		{ TextureFormat::BC1_UNORM_SRGB,      72 },
+		{ TextureFormat::BC2_UNORM,           74 },
+		{ TextureFormat::BC2_UNORM_SRGB,      75 },
+		{ TextureFormat::BC3_UNORM,           77 },
+		{ TextureFormat::BC3_UNORM_SRGB,      78 },
+		{ TextureFormat::BC4_UNORM,           80 },
+		{ TextureFormat::BC4_SNORM,           81 },
+		{ TextureFormat::BC5_UNORM,           83 },
+		{ TextureFormat::BC5_SNORM,           84 },
+		{ TextureFormat::B8G8R8A8_UNORM,      87 },
+		{ TextureFormat::B8G8R8A8_UNORM_SRGB, 91 },
+		{ TextureFormat::BC6H_UF16,           95 },
+		{ TextureFormat::BC6H_SF16,           96 },
+		{ TextureFormat::BC7_UNORM,           98 },
+		{ TextureFormat::BC7_UNORM_SRGB,      99 },
+	};
+
+	TextureFormatInfo GetTextureFormatInfo(TextureFormat format)
+	{
+		TextureFormatInfo info{};
+
+		switch (format)
+		{
+		case TextureFormat::R8_UNORM:            info.bytesPerBlock = 1;  info.channelCount = 1; break;
+		case TextureFormat::R8G8_UNORM:          info.bytesPerBlock = 2;  info.channelCount = 2; break;
+		case TextureFormat::R8G8B8A8_UNORM:      info.bytesPerBlock = 4;  info.channelCount = 4; break;
+		case TextureFormat::R8G8B8A8_UNORM_SRGB: info.bytesPerBlock = 4;  info.channelCount = 4; info.srgb = true; break;
+		case TextureFormat::B8G8R8A8_UNORM:      info.bytesPerBlock = 4;  info.channelCount = 4; break;
+		case TextureFormat::B8G8R8A8_UNORM_SRGB: info.bytesPerBlock = 4;  info.channelCount = 4; info.srgb = true; break;
+
+		case TextureFormat::R16_FLOAT:           info.bytesPerBlock = 2;  info.channelCount = 1; break;
+		case TextureFormat::R16G16_FLOAT:        info.bytesPerBlock = 4;  info.channelCount = 2; break;
+		case TextureFormat::R16G16B16A16_FLOAT:  info.bytesPerBlock = 8;  info.channelCount = 4; break;
+		case TextureFormat::R32_FLOAT:           info.bytesPerBlock = 4;  info.channelCount = 1; break;
+		case TextureFormat::R32G32B32A32_FLOAT:  info.bytesPerBlock = 16; info.channelCount = 4; break;
+		case TextureFormat::R11G11B10_FLOAT:     info.bytesPerBlock = 4;  info.channelCount = 3; break;
+
+		case TextureFormat::BC1_UNORM:           info.bytesPerBlock = 8;  info.channelCount = 4; break;
+		case TextureFormat::BC1_UNORM_SRGB:      info.bytesPerBlock = 8;  info.channelCount = 4; info.srgb = true; break;
+		case TextureFormat::BC2_UNORM:           info.bytesPerBlock = 16; info.channelCount = 4; break;
+		case TextureFormat::BC2_UNORM_SRGB:      info.bytesPerBlock = 16; info.channelCount = 4; info.srgb = true; break;
+		case TextureFormat::BC3_UNORM:           info.bytesPerBlock = 16; info.channelCount = 4; break;
+		case TextureFormat::BC3_UNORM_SRGB:      info.bytesPerBlock = 16; info.channelCount = 4; info.srgb = true; break;
+		case TextureFormat::BC4_UNORM:
+		case TextureFormat::BC4_SNORM:           info.bytesPerBlock = 8;  info.channelCount = 1; break;
+		case TextureFormat::BC5_UNORM:
+		case TextureFormat::BC5_SNORM:           info.bytesPerBlock = 16; info.channelCount = 2; break;
+		case TextureFormat::BC6H_UF16:
+		case TextureFormat::BC6H_SF16:           info.bytesPerBlock = 16; info.channelCount = 3; break;
+		case TextureFormat::BC7_UNORM:           info.bytesPerBlock = 16; info.channelCount = 4; break;
+		case TextureFormat::BC7_UNORM_SRGB:      info.bytesPerBlock = 16; info.channelCount = 4; info.srgb = true; break;
+
+		default:
+		{
+			assert(false && "Unknown texture format provided!");
+		}
+		break;
+		}
+
+		if (format >= TextureFormat::BC1_UNORM)
+		{
+			info.blockWidth = 4;
+			info.blockHeight = 4;
+			info.blockCompressed = true;
+		}
+
+		return info;
+	}
+
+	bool IsTextureFormatBlockCompressed(TextureFormat format)
+	{
+		return format >= TextureFormat::BC1_UNORM;
+	}
+	bool IsTextureFormatSrgb(TextureFormat format)
+	{
+		return format != TextureFormat::UNKNOWN && GetTextureFormatInfo(format).srgb;
+	}
+
+	TextureFormat GetSrgbTextureFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::R8G8B8A8_UNORM: return TextureFormat::R8G8B8A8_UNORM_SRGB;
+		case TextureFormat::B8G8R8A8_UNORM: return TextureFormat::B8G8R8A8_UNORM_SRGB;
+		case TextureFormat::BC1_UNORM:      return TextureFormat::BC1_UNORM_SRGB;
+		case TextureFormat::BC2_UNORM:      return TextureFormat::BC2_UNORM_SRGB;
+		case TextureFormat::BC3_UNORM:      return TextureFormat::BC3_UNORM_SRGB;
+		case TextureFormat::BC7_UNORM:      return TextureFormat::BC7_UNORM_SRGB;
+		default:                            return format;
+		}
+	}
+	TextureFormat GetLinearTextureFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::R8G8B8A8_UNORM_SRGB: return TextureFormat::R8G8B8A8_UNORM;
+		case TextureFormat::B8G8R8A8_UNORM_SRGB: return TextureFormat::B8G8R8A8_UNORM;
+		case TextureFormat::BC1_UNORM_SRGB:      return TextureFormat::BC1_UNORM;
+		case TextureFormat::BC2_UNORM_SRGB:      return TextureFormat::BC2_UNORM;
+		case TextureFormat::BC3_UNORM_SRGB:      return TextureFormat::BC3_UNORM;
+		case TextureFormat::BC7_UNORM_SRGB:      return TextureFormat::BC7_UNORM;
+		default:                                 return format;
+		}
+	}
+
+	TextureFormat DxgiFormatValueToTextureFormat(uint32_t dxgiFormat)
+	{
+		for (const DxgiFormatMapping& mapping : dxgiFormatMappings)
+		{
+			if (mapping.dxgiFormat == dxgiFormat)
+				return mapping.format;
+		}
+		return TextureFormat::UNKNOWN;
+	}
+	uint32_t TextureFormatToDxgiFormatValue(TextureFormat format)
+	{
+		for (const DxgiFormatMapping& mapping : dxgiFormatMappings)
+		{
+			if (mapping.format == format)
+				return mapping.dxgiFormat;
+		}
+		return 0; // DXGI_FORMAT_UNKNOWN
+	}
+
+	TextureFormat VkFormatValueToTextureFormat(uint32_t vkFormat)
+	{
+		switch (vkFormat)
+		{
+		case 9:   return TextureFormat::R8_UNORM;
+		case 16:  return TextureFormat::R8G8_UNORM;
+		case 37:  return TextureFormat::R8G8B8A8_UNORM;
+		case 43:  return TextureFormat::R8G8B8A8_UNORM_SRGB;
+		case 44:  return TextureFormat::B8G8R8A8_UNORM;
+		case 50:  return TextureFormat::B8G8R8A8_UNORM_SRGB;
+		case 76:  return TextureFormat::R16_FLOAT;
+		case 83:  return TextureFormat::R16G16_FLOAT;
+		case 97:  return TextureFormat::R16G16B16A16_FLOAT;
+		case 100: return TextureFormat::R32_FLOAT;
+		case 109: return TextureFormat::R32G32B32A32_FLOAT;
+		case 122: return TextureFormat::R11G11B10_FLOAT;
+		case 131:
+		case 133: return TextureFormat::BC1_UNORM;
+		case 132:
+		case 134: return TextureFormat::BC1_UNORM_SRGB;
+		case 135: return TextureFormat::BC2_UNORM;
+		case 136: return TextureFormat::BC2_UNORM_SRGB;
+		case 137: return TextureFormat::BC3_UNORM;
+		case 138: return TextureFormat::BC3_UNORM_SRGB;
+		case 139: return TextureFormat::BC4_UNORM;
+		case 140: return TextureFormat::BC4_SNORM;
+		case 141: return TextureFormat::BC5_UNORM;
+		case 142: return TextureFormat::BC5_SNORM;
+		case 143: return TextureFormat::BC6H_UF16;
+		case 144: return TextureFormat::BC6H_SF16;
+		case 145: return TextureFormat::BC7_UNORM;
+		case 146: return TextureFormat::BC7_UNORM_SRGB;
+		default:  return TextureFormat::UNKNOWN;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "Texture/TextureLayout.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dxe
+{
+	// TextureDesc
+
+	uint32_t TextureDesc::GetArraySliceCount() const
+	{
+		return dimension == TextureDimension::TEXTURE_CUBE ? arraySize * 6 : arraySize;
+	}
+	uint32_t TextureDesc::GetSubresourceCount() const
+	{
+		// 3D textures can't be arrays, their slices live inside each subresource.
+		uint32_t arraySlices = dimension == TextureDimension::TEXTURE_3D ? 1 : GetArraySliceCount();
+		return arraySlices * mipLevels;
+	}
+
+	uint32_t TextureDesc::GetMipWidth(uint32_t mip) const
+	{
+		return std::max(width >> mip, 1u);
+	}
+	uint32_t TextureDesc::GetMipHeight(uint32_t mip) const
+	{
+		return std::max(height >> mip, 1u);
+	}
+	uint32_t TextureDesc::GetMipDepth(uint32_t mip) const
+	{
+		if (dimension != TextureDimension::TEXTURE_3D)
+			return 1;
+		return std::max(depth >> mip, 1u);
+	}
+
+	// Free functions
+
+	uint32_t CalculateFullMipChainLength(uint32_t width, uint32_t height, uint32_t depth)
+	{
+		uint32_t largestDimension = std::max({ width, height, depth });
+
+		uint32_t mipLevels{ 1 };
+		while (largestDimension > 1)
+		{
+			largestDimension >>= 1;
+			mipLevels++;
+		}
+		return mipLevels;
+	}
+
+	TextureUploadLayout CalculateTextureUploadLayout(const TextureDesc& desc, uint64_t baseOffset)
+	{
+		assert(desc.format != TextureFormat::UNKNOWN && "Texture format must be known!");
+
+		TextureUploadLayout layout{};
+
+		uint32_t subresourceCount = desc.GetSubresourceCount();
+		layout.footprints.resize(subresourceCount);
+
+		uint64_t offset = AlignUp(baseOffset, TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		uint64_t requiredBytes{ 0 };
+
+		for (uint32_t subresource = 0; subresource < subresourceCount; subresource++)
+		{
+			uint32_t mip = subresource % desc.mipLevels;
+
+			TextureSubresourceFootprint& footprint = layout.footprints[subresource];
+
+			footprint.offset = offset;
+			footprint.width = desc.GetMipWidth(mip);
+			footprint.height = desc.GetMipHeight(mip);
+			footprint.depth = desc.GetMipDepth(mip);
+
+			// Block-compressed footprints are reported in whole blocks, like D3D12 does.
+			TextureFormatInfo formatInfo = GetTextureFormatInfo(desc.format);
+			if (formatInfo.blockCompressed)
+			{
+				footprint.width = static_cast<uint32_t>(AlignUp(footprint.width, formatInfo.blockWidth));
+				footprint.height = static_cast<uint32_t>(AlignUp(footprint.height, formatInfo.blockHeight));
+			}
+
+			footprint.rowSizeInBytes = CalculatePackedRowSize(desc.format, footprint.width);
+			footprint.rowCount = CalculateRowCount(desc.format, footprint.height);
+			footprint.rowPitch = static_cast<uint32_t>(AlignUp(footprint.rowSizeInBytes, TEXTURE_DATA_PITCH_ALIGNMENT));
+
+			uint64_t totalRows = static_cast<uint64_t>(footprint.rowCount) * footprint.depth;
+
+			// The last row doesn't need padding.
+			requiredBytes = footprint.offset - baseOffset +
+				footprint.rowPitch * (totalRows - 1) + footprint.rowSizeInBytes;
+
+			offset = AlignUp(footprint.offset + footprint.rowPitch * totalRows, TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+		}
+
+		layout.totalBytes = requiredBytes;
+		return layout;
+	}
+
+	uint64_t CalculatePackedSubresourceSize(const TextureDesc& desc, uint32_t mip)
+	{
+		uint64_t rowSize = CalculatePackedRowSize(desc.format, desc.GetMipWidth(mip));
+		uint64_t rowCount = CalculateRowCount(desc.format, desc.GetMipHeight(mip));
+		return rowSize * rowCount * desc.GetMipDepth(mip);
+	}
+	uint64_t CalculatePackedRowSize(TextureFormat format, uint32_t width)
+	{
+		TextureFormatInfo formatInfo = GetTextureFormatInfo(format);
+		uint64_t blocksWide = (width + formatInfo.blockWidth - 1) / formatInfo.blockWidth;
+		return blocksWide * formatInfo.bytesPerBlock;
+	}
+	uint32_t CalculateRowCount(TextureFormat format, uint32_t height)
+	{
+		TextureFormatInfo formatInfo = GetTextureFormatInfo(format);
+		return (height + formatInfo.blockHeight - 1) / formatInfo.blockHeight;
+	}
+}
\ No newline at end of file
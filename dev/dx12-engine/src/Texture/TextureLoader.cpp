@@ -0,0 +1,424 @@
+#include "Texture/TextureLoader.h"
+
+#include "Core/Error.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+namespace dxe
+{
+	// DDS
+
+	constexpr uint32_t DDS_MAGIC = 0x20534444; // "DDS "
+
+	constexpr uint32_t DDS_PF_FOURCC = 0x4;
+	constexpr uint32_t DDS_PF_RGB = 0x40;
+
+	constexpr uint32_t DDS_CAPS2_CUBEMAP = 0x200;
+	constexpr uint32_t DDS_CAPS2_VOLUME = 0x200000;
+
+	constexpr uint32_t DDS_RESOURCE_DIMENSION_TEXTURE1D = 2;
+	constexpr uint32_t DDS_RESOURCE_DIMENSION_TEXTURE2D = 3;
+	constexpr uint32_t DDS_RESOURCE_DIMENSION_TEXTURE3D = 4;
+	constexpr uint32_t DDS_RESOURCE_MISC_TEXTURECUBE = 0x4;
+
+	struct DdsPixelFormat
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t fourCC;
+		uint32_t rgbBitCount;
+		uint32_t rBitMask;
+		uint32_t gBitMask;
+		uint32_t bBitMask;
+		uint32_t aBitMask;
+	};
+
+	struct DdsHeader
+	{
+		uint32_t size;
+		uint32_t flags;
+		uint32_t height;
+		uint32_t width;
+		uint32_t pitchOrLinearSize;
+		uint32_t depth;
+		uint32_t mipMapCount;
+		uint32_t reserved1[11];
+		DdsPixelFormat pixelFormat;
+		uint32_t caps;
+		uint32_t caps2;
+		uint32_t caps3;
+		uint32_t caps4;
+		uint32_t reserved2;
+	};
+
+	struct DdsHeaderDx10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
+	static_assert(sizeof(DdsHeader) == 124, "DDS header must be 124 bytes!");
+	static_assert(sizeof(DdsHeaderDx10) == 20, "DDS DX10 header must be 20 bytes!");
+
+	constexpr uint32_t MakeFourCC(char c0, char c1, char c2, char c3)
+	{
+		return static_cast<uint32_t>(static_cast<uint8_t>(c0)) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(c1)) << 8) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(c2)) << 16) |
+			(static_cast<uint32_t>(static_cast<uint8_t>(c3)) << 24);
+	}
+
+	static TextureFormat DdsPixelFormatToTextureFormat(const DdsPixelFormat& pixelFormat)
+	{
+		if (pixelFormat.flags & DDS_PF_FOURCC)
+		{
+			switch (pixelFormat.fourCC)
+			{
+			case MakeFourCC('D', 'X', 'T', '1'): return TextureFormat::BC1_UNORM;
+			case MakeFourCC('D', 'X', 'T', '2'):
+			case MakeFourCC('D', 'X', 'T', '3'): return TextureFormat::BC2_UNORM;
+			case MakeFourCC('D', 'X', 'T', '4'):
+			case MakeFourCC('D', 'X', 'T', '5'): return TextureFormat::BC3_UNORM;
+			case MakeFourCC('A', 'T', 'I', '1'):
+			case MakeFourCC('B', 'C', '4', 'U'): return TextureFormat::BC4_UNORM;
+			case MakeFourCC('B', 'C', '4', 'S'): return TextureFormat::BC4_SNORM;
+			case MakeFourCC('A', 'T', 'I', '2'):
+			case MakeFourCC('B', 'C', '5', 'U'): return TextureFormat::BC5_UNORM;
+			case MakeFourCC('B', 'C', '5', 'S'): return TextureFormat::BC5_SNORM;
+			// Legacy D3DFORMAT values stored in the FourCC field.
+			case 111: return TextureFormat::R16_FLOAT;
+			case 112: return TextureFormat::R16G16_FLOAT;
+			case 113: return TextureFormat::R16G16B16A16_FLOAT;
+			case 114: return TextureFormat::R32_FLOAT;
+			case 116: return TextureFormat::R32G32B32A32_FLOAT;
+			default:  return TextureFormat::UNKNOWN;
+			}
+		}
+
+		if ((pixelFormat.flags & DDS_PF_RGB) && pixelFormat.rgbBitCount == 32)
+		{
+			if (pixelFormat.rBitMask == 0x000000ff && pixelFormat.gBitMask == 0x0000ff00 && pixelFormat.bBitMask == 0x00ff0000)
+				return TextureFormat::R8G8B8A8_UNORM;
+			if (pixelFormat.rBitMask == 0x00ff0000 && pixelFormat.gBitMask == 0x0000ff00 && pixelFormat.bBitMask == 0x000000ff)
+				return TextureFormat::B8G8R8A8_UNORM;
+		}
+
+		return TextureFormat::UNKNOWN;
+	}
+
+	// KTX2
+
+	constexpr uint8_t KTX2_IDENTIFIER[12]{ 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+	struct Ktx2Header
+	{
+		uint8_t identifier[12];
+		uint32_t vkFormat;
+		uint32_t typeSize;
+		uint32_t pixelWidth;
+		uint32_t pixelHeight;
+		uint32_t pixelDepth;
+		uint32_t layerCount;
+		uint32_t faceCount;
+		uint32_t levelCount;
+		uint32_t supercompressionScheme;
+
+		uint32_t dfdByteOffset;
+		uint32_t dfdByteLength;
+		uint32_t kvdByteOffset;
+		uint32_t kvdByteLength;
+		uint64_t sgdByteOffset;
+		uint64_t sgdByteLength;
+	};
+
+	struct Ktx2LevelIndex
+	{
+		uint64_t byteOffset;
+		uint64_t byteLength;
+		uint64_t uncompressedByteLength;
+	};
+
+	static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must be 80 bytes!");
+	static_assert(sizeof(Ktx2LevelIndex) == 24, "KTX2 level index entry must be 24 bytes!");
+
+	// Helpers
+
+	template <typename T>
+	static T ReadStruct(const MappedFile& file, uint64_t offset, const std::filesystem::path& path)
+	{
+		if (offset + sizeof(T) > file.GetSize())
+			throw Error{ "Texture file is truncated: " + path.string() };
+
+		T value{};
+		std::memcpy(&value, file.GetData() + offset, sizeof(T));
+		return value;
+	}
+
+	static void ValidateTextureDesc(const TextureDesc& desc, const std::filesystem::path& path)
+	{
+		if (desc.format == TextureFormat::UNKNOWN)
+			throw Error{ "Unsupported texture format: " + path.string() };
+		if (desc.width == 0 || desc.height == 0 || desc.depth == 0 || desc.arraySize == 0)
+			throw Error{ "Texture has a zero-sized dimension: " + path.string() };
+		if (desc.mipLevels == 0 || desc.mipLevels > CalculateFullMipChainLength(desc.width, desc.height, desc.depth))
+			throw Error{ "Texture has an invalid mip count: " + path.string() };
+	}
+
+	// TextureFile
+
+	const TextureDesc& TextureFile::GetDesc() const
+	{
+		return desc;
+	}
+	TextureContainer TextureFile::GetContainer() const
+	{
+		return container;
+	}
+
+	const std::vector<TextureSubresourceData>& TextureFile::GetSubresources() const
+	{
+		return subresources;
+	}
+
+	TextureUploadLayout TextureFile::CalculateUploadLayout(uint64_t baseOffset) const
+	{
+		return CalculateTextureUploadLayout(desc, baseOffset);
+	}
+	std::vector<TextureCopyDesc> TextureFile::CreateCopyDescs(const TextureUploadLayout& uploadLayout) const
+	{
+		assert(uploadLayout.footprints.size() == subresources.size() && "Upload layout doesn't match the texture!");
+
+		std::vector<TextureCopyDesc> copyDescs(subresources.size());
+		for (uint32_t subresource = 0; subresource < subresources.size(); subresource++)
+		{
+			copyDescs[subresource].subresourceIndex = subresource;
+			copyDescs[subresource].source = subresources[subresource];
+			copyDescs[subresource].destination = uploadLayout.footprints[subresource];
+		}
+		return copyDescs;
+	}
+
+	void TextureFile::WriteUploadData(const TextureUploadLayout& uploadLayout, uint8_t* uploadBufferData) const
+	{
+		assert(uploadLayout.footprints.size() == subresources.size() && "Upload layout doesn't match the texture!");
+
+		for (uint32_t subresource = 0; subresource < subresources.size(); subresource++)
+		{
+			const TextureSubresourceData& source = subresources[subresource];
+			const TextureSubresourceFootprint& footprint = uploadLayout.footprints[subresource];
+
+			for (uint32_t slice = 0; slice < footprint.depth; slice++)
+			{
+				const uint8_t* srcSlice = source.data + slice * source.slicePitch;
+				uint8_t* dstSlice = uploadBufferData + footprint.offset +
+					static_cast<uint64_t>(slice) * footprint.rowPitch * footprint.rowCount;
+
+				// Rows can be copied in one go when the source happens to be aligned already.
+				if (source.rowPitch == footprint.rowPitch)
+				{
+					std::memcpy(dstSlice, srcSlice, source.rowPitch * footprint.rowCount);
+					continue;
+				}
+
+				for (uint32_t row = 0; row < footprint.rowCount; row++)
+				{
+					std::memcpy(
+						dstSlice + static_cast<uint64_t>(row) * footprint.rowPitch,
+						srcSlice + row * source.rowPitch,
+						footprint.rowSizeInBytes);
+				}
+			}
+		}
+	}
+
+	// Loading
+
+	TextureFile LoadDdsTexture(const std::filesystem::path& path)
+	{
+		TextureFile texture{};
+		texture.container = TextureContainer::DDS;
+		texture.mappedFile.Open(path);
+
+		const MappedFile& file = texture.mappedFile;
+
+		if (ReadStruct<uint32_t>(file, 0, path) != DDS_MAGIC)
+			throw Error{ "Not a DDS file: " + path.string() };
+
+		DdsHeader header = ReadStruct<DdsHeader>(file, sizeof(uint32_t), path);
+		if (header.size != sizeof(DdsHeader) || header.pixelFormat.size != sizeof(DdsPixelFormat))
+			throw Error{ "Corrupted DDS header: " + path.string() };
+
+		uint64_t dataOffset = sizeof(uint32_t) + sizeof(DdsHeader);
+
+		TextureDesc& desc = texture.desc;
+		desc.width = header.width;
+		desc.height = std::max(header.height, 1u);
+		desc.mipLevels = std::max(header.mipMapCount, 1u);
+
+		bool hasDx10Header = (header.pixelFormat.flags & DDS_PF_FOURCC) &&
+			header.pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0');
+
+		if (hasDx10Header)
+		{
+			DdsHeaderDx10 dx10Header = ReadStruct<DdsHeaderDx10>(file, dataOffset, path);
+			dataOffset += sizeof(DdsHeaderDx10);
+
+			desc.format = DxgiFormatValueToTextureFormat(dx10Header.dxgiFormat);
+			desc.arraySize = dx10Header.arraySize;
+
+			switch (dx10Header.resourceDimension)
+			{
+			case DDS_RESOURCE_DIMENSION_TEXTURE1D:
+				desc.dimension = TextureDimension::TEXTURE_1D;
+				break;
+			case DDS_RESOURCE_DIMENSION_TEXTURE2D:
+				desc.dimension = (dx10Header.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) ?
+					TextureDimension::TEXTURE_CUBE : TextureDimension::TEXTURE_2D;
+				break;
+			case DDS_RESOURCE_DIMENSION_TEXTURE3D:
+				desc.dimension = TextureDimension::TEXTURE_3D;
+				desc.depth = std::max(header.depth, 1u);
+				break;
+			default:
+				throw Error{ "Unknown DDS resource dimension: " + path.string() };
+			}
+		}
+		else
+		{
+			desc.format = DdsPixelFormatToTextureFormat(header.pixelFormat);
+			desc.arraySize = 1;
+
+			if (header.caps2 & DDS_CAPS2_CUBEMAP)
+			{
+				desc.dimension = TextureDimension::TEXTURE_CUBE;
+			}
+			else if (header.caps2 & DDS_CAPS2_VOLUME)
+			{
+				desc.dimension = TextureDimension::TEXTURE_3D;
+				desc.depth = std::max(header.depth, 1u);
+			}
+		}
+
+		ValidateTextureDesc(desc, path);
+
+		// DDS stores every mip of array slice 0, then every mip of slice 1 and so on,
+		// which is the D3D12 subresource order.
+
+		texture.subresources.resize(desc.GetSubresourceCount());
+
+		uint64_t offset = dataOffset;
+		for (uint32_t subresource = 0; subresource < texture.subresources.size(); subresource++)
+		{
+			uint32_t mip = subresource % desc.mipLevels;
+
+			uint64_t subresourceSize = CalculatePackedSubresourceSize(desc, mip);
+			if (offset + subresourceSize > file.GetSize())
+				throw Error{ "DDS file is truncated: " + path.string() };
+
+			TextureSubresourceData& data = texture.subresources[subresource];
+			data.data = file.GetData() + offset;
+			data.rowPitch = CalculatePackedRowSize(desc.format, desc.GetMipWidth(mip));
+			data.slicePitch = data.rowPitch * CalculateRowCount(desc.format, desc.GetMipHeight(mip));
+
+			offset += subresourceSize;
+		}
+
+		return texture;
+	}
+
+	TextureFile LoadKtx2Texture(const std::filesystem::path& path)
+	{
+		TextureFile texture{};
+		texture.container = TextureContainer::KTX2;
+		texture.mappedFile.Open(path);
+
+		const MappedFile& file = texture.mappedFile;
+
+		Ktx2Header header = ReadStruct<Ktx2Header>(file, 0, path);
+		if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+			throw Error{ "Not a KTX2 file: " + path.string() };
+
+		// Supercompressed payloads (Basis, Zstd) would need a decode step before upload.
+		if (header.supercompressionScheme != 0)
+			throw Error{ "Supercompressed KTX2 files are not supported: " + path.string() };
+
+		if (header.faceCount != 1 && header.faceCount != 6)
+			throw Error{ "KTX2 file has an invalid face count: " + path.string() };
+
+		TextureDesc& desc = texture.desc;
+		desc.format = VkFormatValueToTextureFormat(header.vkFormat);
+		desc.width = header.pixelWidth;
+		desc.height = std::max(header.pixelHeight, 1u);
+		desc.depth = std::max(header.pixelDepth, 1u);
+		desc.arraySize = std::max(header.layerCount, 1u);
+		desc.mipLevels = std::max(header.levelCount, 1u);
+
+		if (header.faceCount == 6)
+			desc.dimension = TextureDimension::TEXTURE_CUBE;
+		else if (header.pixelDepth > 0)
+			desc.dimension = TextureDimension::TEXTURE_3D;
+		else if (header.pixelHeight == 0)
+			desc.dimension = TextureDimension::TEXTURE_1D;
+
+		ValidateTextureDesc(desc, path);
+
+		// KTX2 keeps a byte range per mip, inside of which the data goes layer by layer, face by face.
+
+		uint32_t facesPerLayer = header.faceCount;
+		uint32_t arraySlices = desc.dimension == TextureDimension::TEXTURE_3D ? 1 : desc.GetArraySliceCount();
+
+		texture.subresources.resize(desc.GetSubresourceCount());
+
+		for (uint32_t mip = 0; mip < desc.mipLevels; mip++)
+		{
+			Ktx2LevelIndex levelIndex = ReadStruct<Ktx2LevelIndex>(
+				file, sizeof(Ktx2Header) + mip * sizeof(Ktx2LevelIndex), path);
+
+			uint64_t subresourceSize = CalculatePackedSubresourceSize(desc, mip);
+
+			if (levelIndex.byteLength < subresourceSize * arraySlices ||
+				levelIndex.byteOffset + levelIndex.byteLength > file.GetSize())
+				throw Error{ "KTX2 file is truncated: " + path.string() };
+
+			for (uint32_t arraySlice = 0; arraySlice < arraySlices; arraySlice++)
+			{
+				uint32_t layer = arraySlice / facesPerLayer;
+				uint32_t face = arraySlice % facesPerLayer;
+				uint64_t sliceOffset = levelIndex.byteOffset + (layer * facesPerLayer + face) * subresourceSize;
+
+				TextureSubresourceData& data =
+					texture.subresources[CalculateSubresourceIndex(mip, arraySlice, desc.mipLevels)];
+				data.data = file.GetData() + sliceOffset;
+				data.rowPitch = CalculatePackedRowSize(desc.format, desc.GetMipWidth(mip));
+				data.slicePitch = data.rowPitch * CalculateRowCount(desc.format, desc.GetMipHeight(mip));
+			}
+		}
+
+		return texture;
+	}
+
+	TextureFile LoadTexture(const std::filesystem::path& path)
+	{
+		MappedFile probe{};
+		probe.Open(path);
+
+		bool isDds = probe.GetSize() >= sizeof(uint32_t) && ReadStruct<uint32_t>(probe, 0, path) == DDS_MAGIC;
+		bool isKtx2 = probe.GetSize() >= sizeof(KTX2_IDENTIFIER) &&
+			std::memcmp(probe.GetData(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+
+		probe.Close();
+
+		if (isDds)
+			return LoadDdsTexture(path);
+		if (isKtx2)
+			return LoadKtx2Texture(path);
+
+		throw Error{ "Unknown texture container: " + path.string() };
+	}
+}
\ No newline at end of file
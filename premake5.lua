@@ -6,6 +6,10 @@ local dependencies_path = "dependencies"
 local dx12_project_include_path = dev_path .. "/dx12-engine/include"
 local dx12_project_src_path = dev_path .. "/dx12-engine/src"
 
+--Project: dx12-engine-tests
+local tests_project_include_path = dev_path .. "/dx12-engine-tests/include"
+local tests_project_src_path = dev_path .. "/dx12-engine-tests/src"
+
 workspace ( "dx12-engine" )
    configurations ( { "Debug", "Release" } )
    platforms ( { "x64" } )
@@ -62,5 +66,65 @@ project ( "dx12-engine" )
          -- os.execute("copy-shaders.bat")
       -- }
 
+   filter ( "system:linux" )
+      defines( { "WINDOW_XCB" } )
+
+-- Tests and benchmarks of the engine's subsystems, built with the engine sources minus its entry
+-- point. Runs the tests, or the benchmarks with --bench.
+project ( "dx12-engine-tests" )
+   kind ( "ConsoleApp" )
+   language ( "C++" )
+   cppdialect ( "C++17" )
+   location ( build_path .. "/dx12-engine-tests" )
+
+   targetdir ( build_path .. "/bin/%{cfg.platform}-%{cfg.buildcfg}" )
+   objdir ( build_path .. "/bin-int/%{cfg.platform}-%{cfg.buildcfg}/tests" )
+
+   includedirs {
+      dependencies_path .. "/include",
+      dev_path .. "/dx12-engine/include",
+      dev_path .. "/dx12-engine-tests/include"
+   }
+   libdirs {
+      dependencies_path .. "/lib"
+   }
+
+   links {
+      "spdlog",
+      "d3d12.lib",
+      "dxgi.lib",
+      "d3dcompiler.lib"
+   }
+
+   files {
+      dx12_project_include_path .. "/**.h",
+      dx12_project_src_path .. "/**.cpp",
+      tests_project_include_path .. "/**.h",
+      tests_project_src_path .. "/**.cpp"
+   }
+   removefiles {
+      dx12_project_src_path .. "/main.cpp"
+   }
+
+   filter ( "configurations:Debug" )
+      defines ( { "DEBUG", "_DEBUG" } )
+      symbols ( "On" )
+
+   filter ( "configurations:Release" )
+      defines ( { "NDEBUG", "_NDEBUG" } )
+      optimize ( "On" )
+
+   filter ( "system:windows" )
+      defines( { "WINDOW_WIN32" } )
+
+   filter ( { "system:windows", "action:vs*" } )
+      buildoptions ( { "/utf-8" } )
+      vpaths {
+         ["Include/*"] = { dx12_project_include_path .. "/**.h" },
+         ["Sources/*"] = { dx12_project_src_path .. "/**.cpp" },
+         ["Tests/Include/*"] = { tests_project_include_path .. "/**.h" },
+         ["Tests/Sources/*"] = { tests_project_src_path .. "/**.cpp" },
+      }
+
    filter ( "system:linux" )
       defines( { "WINDOW_XCB" } )
\ No newline at end of file